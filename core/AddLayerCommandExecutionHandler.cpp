@@ -36,6 +36,8 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "suri/Command.h"
 #include "suri/VectorElement.h"
 #include "suri/GenericTool.h"
+#include "suri/Configuration.h"
+#include "suri/BuildOverviewsProcess.h"
 #include "XmlMetadataHandler.h"
 
 namespace suri {
@@ -86,6 +88,21 @@ AddLayerCommandExecutionHandler::LayerGroup GetLayerGroup(DatasourceInterface* p
    return group;
 }
 
+/**
+ * Genera los overviews de la imagen de la fuente de datos si no existen o
+ * estan desactualizados, para que la visualizacion decimada lea del nivel
+ * adecuado. Se puede deshabilitar con lib_build_overviews_on_load.
+ * @param[in] pDatasource fuente de datos raster agregada
+ */
+void BuildOverviews(DatasourceInterface* pDatasource) {
+   if (!Configuration::GetParameter("lib_build_overviews_on_load", true))
+      return;
+   std::string url = pDatasource->GetElement()->GetUrl().c_str();
+   BuildOverviewsProcess process(url);
+   if (!process.RunProcess())
+      REPORT_DEBUG("D:No se pudieron generar los overviews de %s", url.c_str());
+}
+
 void AddLayerCommandExecutionHandler::AddLayer(const std::string& Filter) {
 	suri::DatasourceManagerInterface* dm = pDataView_->GetDatasourceManager();
    wxFileDialog filedialog(NULL, _(caption_SELECT_ELEMENT), wxT(""), wxT(""), Filter,
@@ -117,6 +134,9 @@ void AddLayerCommandExecutionHandler::AddLayer(const std::string& Filter) {
          std::map<LayerGroup, DatasourceInterface*>::iterator it = layergroup.begin();
          for (; it != layergroup.end(); ++it){
             DatasourceInterface* pDatasource = it->second;
+            // los overviews se generan antes de que se renderice la capa
+            if (it->first == RasterGroup)
+               BuildOverviews(pDatasource);
             ok = ok && dm->AddDatasource(pDatasource);
          }
          if (!ok)
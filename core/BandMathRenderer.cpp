@@ -28,6 +28,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 // Includes standard
 #include <sstream>
 #include <utility>
+#include <algorithm>
 #include <map>
 #include <string>
 #include <vector>
@@ -38,7 +39,9 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "logmacros.h"
 #include "suri/Element.h"
 #include "MemoryCanvas.h"
+#include "CanvasBandBuffers.h"
 #include "EquationParser.h"
+#include "BlockEquationEvaluator.h"
 // Includes Wx
 #include "wx/xml/xml.h"
 // Includes App
@@ -51,6 +54,9 @@ AUTO_REGISTER_RENDERER(suri::BandMathRenderer);
 namespace suri {
 
 /**
+ * La ecuacion se compila con BlockEquationEvaluator y se evalua por bloques
+ * de BLOCK_EQUATION_SIZE pixeles. Si la ecuacion no compila se evalua pixel
+ * a pixel con EquationParser (BlockEquationEvaluatorTest compara ambos).
  * param[in] pBands: bandas en imagen de entrada
  * param[in] Size: cantidad de pixeles en imagenes de entrada
  * param[in] Equation: ecuacion que quiero realizar sobre bandas
@@ -61,32 +67,48 @@ template<typename T>
 void bandmathoperation(std::vector<void*> pBands, size_t Size, std::string Equation,
                                  std::map<std::string, int> EquationVariables,
                                  BAND_MATH_OUTPUT_DATA_TYPE* pDest) {
-
-   // Inicializo vector 'inputvalues' con bandas de entrada de tipo correcto
-   T** inputvalues = new T* [pBands.size()];
-   for (size_t i = 0; i < pBands.size(); i++)
-      inputvalues[i] = static_cast<T*>(pBands[i]);
-
    // Inicializo EquationParser con la ecuacion
    EquationParser eqparser;
-   eqparser.SetEquation(Equation);
+   bool validequation = eqparser.SetEquation(Equation);
    std::vector<std::string> variablenames;
    eqparser.GetVariableNames(variablenames);
-   int variablecount = variablenames.size();
+   size_t variablecount = variablenames.size();
 
-   // Configura vectores con variables que usa parser para realizar calculos.
-   double** pvariables = new double*[variablenames.size()];
-   std::vector<int> passociatedband(variablenames.size());
-   for (size_t i = 0; i < variablenames.size(); i++) {
+   // Configura vectores con variables que usa parser para realizar calculos
+   // y las bandas de entrada asociadas.
+   std::vector<double*> pvariables(variablecount);
+   std::vector<T*> inputvalues(variablecount);
+   for (size_t i = 0; i < variablecount; i++) {
       eqparser.GetVariableValuePointer(variablenames[i], pvariables[i]);
-      passociatedband[i] = EquationVariables[variablenames[i]];
+      inputvalues[i] = static_cast<T*>(pBands[EquationVariables[variablenames[i]]]);
    }
 
+   // Compila la ecuacion para evaluarla por bloques
+   BlockEquationEvaluator evaluator;
+   bool blockevaluation = validequation && evaluator.Compile(Equation, variablenames);
+   std::vector<double> blockvalues(variablecount * BLOCK_EQUATION_SIZE);
+   std::vector<const double*> pblockvariables(variablecount);
+   for (size_t j = 0; j < variablecount; j++)
+      pblockvariables[j] = &blockvalues[j * BLOCK_EQUATION_SIZE];
+   std::vector<double> result(BLOCK_EQUATION_SIZE);
+
    // Calcula banda de salida
-   for (size_t i = 0; i < Size; i++) {
-      for (int j = 0; j < variablecount; j++)
-         *(pvariables[j]) = inputvalues[passociatedband[j]][i];
-      pDest[i] = eqparser.EvaluateEquation();
+   for (size_t offset = 0; offset < Size; offset += BLOCK_EQUATION_SIZE) {
+      size_t count = std::min(Size - offset, static_cast<size_t>(BLOCK_EQUATION_SIZE));
+      if (blockevaluation) {
+         for (size_t j = 0; j < variablecount; j++)
+            for (size_t i = 0; i < count; i++)
+               blockvalues[j * BLOCK_EQUATION_SIZE + i] = inputvalues[j][offset + i];
+         evaluator.Evaluate(pblockvariables, count, &result[0]);
+         for (size_t i = 0; i < count; i++)
+            pDest[offset + i] = result[i];
+      } else {
+         for (size_t i = offset; i < offset + count; i++) {
+            for (size_t j = 0; j < variablecount; j++)
+               *(pvariables[j]) = inputvalues[j][i];
+            pDest[i] = eqparser.EvaluateEquation();
+         }
+      }
    }
 }
 /** Inicializa mapa de tipos de datos. */
@@ -289,51 +311,42 @@ bool BandMathRenderer::Render(const World *pWorldWindow, Canvas* pCanvas,
       REPORT_AND_FAIL_VALUE("D:Tamano de canvas erroneo", false);
    }
 
-   // leo el canvas retornado
+   // leo el canvas retornado (los buffers del canvas si los presta)
    std::vector<int> bands(originalbandcount);
-   std::vector<void*> data(originalbandcount);
-   for (int b = 0; b < originalbandcount; b++) {
+   for (int b = 0; b < originalbandcount; b++)
       bands[b] = b;
-      data[b] = new unsigned char[canvassizex * canvassizey * pCanvas->GetDataSize()];
-   }
-   pCanvas->Read(bands, data);
-
-   // Si el canvas es el original cambio el tipo de dato al de la salida y el numero de bandas
-   if (ptempcanvas == pCanvas) {
-      pCanvas->SetDataType(DataInfo<BAND_MATH_OUTPUT_DATA_TYPE>::Name);
-   }
-   outputbandcount = parameters_.equations_.size();
-   pCanvas->SetBandCount(outputbandcount);
-   pCanvas->SetSize(canvassizex, canvassizey);
+   CanvasBandBuffers input(pCanvas, bands);
    int size = canvassizex * canvassizey;
+   outputbandcount = parameters_.equations_.size();
 
    // Creo vector donde se guardan datos de salida temporales
+   std::vector<int> outbands(outputbandcount);
    std::vector<void*> outdata(outputbandcount);
-   for (int b = 0; b < outputbandcount; b++)
-      outdata[b] =
-            new unsigned char[canvassizex * canvassizey * pCanvas->GetDataSize()];
-
-   // Agrego todas las bandas a un std::vector
-   std::vector<void*> originalbands;
-   for (int b = 0; b < originalbandcount; b++)
-      originalbands.push_back(data[b]);
+   for (int b = 0; b < outputbandcount; b++) {
+      outbands[b] = b;
+      outdata[b] = new unsigned char[size * sizeof(BAND_MATH_OUTPUT_DATA_TYPE)];
+   }
 
    // Aplico las operaciones a las bandas
    for (size_t i = 0; i < parameters_.equations_.size(); i++) {
-      bandmathoperationTypeMap[datatype](originalbands, size,
+      bandmathoperationTypeMap[datatype](input.GetData(), size,
                                   parameters_.equations_[i].equation_,
                                   parameters_.equations_[i].bandNames_,
                                   (BAND_MATH_OUTPUT_DATA_TYPE*)outdata[i]);
    }
+   input.Release();
+
+   // Si el canvas es el original cambio el tipo de dato al de la salida y el numero de bandas
+   if (ptempcanvas == pCanvas) {
+      pCanvas->SetDataType(DataInfo<BAND_MATH_OUTPUT_DATA_TYPE>::Name);
+   }
+   pCanvas->SetBandCount(outputbandcount);
+   pCanvas->SetSize(canvassizex, canvassizey);
 
    // Guardo cambios
-   pCanvas->Write(bands, outdata);
+   pCanvas->Write(outbands, outdata);
 
-   // Limpio el vector con bandas originales
-   originalbands.clear();
    // libero el temporario
-   for (int b = 0; b < originalbandcount; b++)
-      delete[] static_cast<unsigned char*>(data[b]);
    for (int b = 0; b < outputbandcount; b++)
       delete[] static_cast<unsigned char*>(outdata[b]);
 
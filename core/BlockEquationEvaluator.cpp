@@ -0,0 +1,690 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#include "BlockEquationEvaluator.h"
+
+// Includes estandar
+#include <cmath>
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <algorithm>
+#include <set>
+
+// Includes Suri
+#include "suri/AuxiliaryFunctions.h"
+
+// Includes Wx
+
+// Includes App
+
+// Defines
+/** Precedencia de los operadores unarios (-, + y !) */
+#define INFIX_OPERATOR_PRECEDENCE 7
+
+/** namespace suri */
+namespace suri {
+
+/** Operaciones que ejecutan las instrucciones. Replican las de muParser */
+struct AddOperation {
+   static double Apply(double A, double B) { return A + B; }
+};
+struct SubtractOperation {
+   static double Apply(double A, double B) { return A - B; }
+};
+struct MultiplyOperation {
+   static double Apply(double A, double B) { return A * B; }
+};
+struct DivideOperation {
+   static double Apply(double A, double B) { return A / B; }
+};
+struct PowerOperation {
+   static double Apply(double A, double B) { return pow(A, B); }
+};
+struct LessOperation {
+   static double Apply(double A, double B) { return A < B; }
+};
+struct GreaterOperation {
+   static double Apply(double A, double B) { return A > B; }
+};
+struct LessEqualOperation {
+   static double Apply(double A, double B) { return A <= B; }
+};
+struct GreaterEqualOperation {
+   static double Apply(double A, double B) { return A >= B; }
+};
+/** Igual que MuEqual de EquationParser */
+struct EqualOperation {
+   static double Apply(double A, double B) { return FLOAT_COMPARE(A, B); }
+};
+/** Igual que MuNotEqual de EquationParser */
+struct NotEqualOperation {
+   static double Apply(double A, double B) { return !FLOAT_COMPARE(A, B); }
+};
+struct AndOperation {
+   static double Apply(double A, double B) { return A && B; }
+};
+struct OrOperation {
+   static double Apply(double A, double B) { return A || B; }
+};
+struct XorOperation {
+   static double Apply(double A, double B) { return (A || B) && !(A && B); }
+};
+/** Igual que MuMod de EquationParser (NaN si el divisor es cero) */
+struct ModuloOperation {
+   static double Apply(double A, double B) {
+      int val1 = SURI_ROUND(int, A);
+      int val2 = SURI_ROUND(int, B);
+      if (val2 == 0)
+         return std::numeric_limits<double>::quiet_NaN();
+      return val1 % val2;
+   }
+};
+/** Igual que std::min, usado por muParser */
+struct MinOperation {
+   static double Apply(double A, double B) { return (B < A) ? B : A; }
+};
+/** Igual que std::max, usado por muParser */
+struct MaxOperation {
+   static double Apply(double A, double B) { return (A < B) ? B : A; }
+};
+struct NegateOperation {
+   static double Apply(double A) { return -A; }
+};
+struct NotOperation {
+   static double Apply(double A) { return !A; }
+};
+struct SinOperation {
+   static double Apply(double A) { return sin(A); }
+};
+struct CosOperation {
+   static double Apply(double A) { return cos(A); }
+};
+struct TanOperation {
+   static double Apply(double A) { return tan(A); }
+};
+struct ASinOperation {
+   static double Apply(double A) { return asin(A); }
+};
+struct ACosOperation {
+   static double Apply(double A) { return acos(A); }
+};
+struct ATanOperation {
+   static double Apply(double A) { return atan(A); }
+};
+struct SinhOperation {
+   static double Apply(double A) { return sinh(A); }
+};
+struct CoshOperation {
+   static double Apply(double A) { return cosh(A); }
+};
+struct TanhOperation {
+   static double Apply(double A) { return tanh(A); }
+};
+struct ASinhOperation {
+   static double Apply(double A) { return log(A + sqrt(A * A + 1)); }
+};
+struct ACoshOperation {
+   static double Apply(double A) { return log(A + sqrt(A * A - 1)); }
+};
+struct ATanhOperation {
+   static double Apply(double A) { return ((double)0.5 * log((1 + A) / (1 - A))); }
+};
+struct Log2Operation {
+   static double Apply(double A) { return log(A) / log(2.0); }
+};
+struct Log10Operation {
+   static double Apply(double A) { return log10(A); }
+};
+struct LnOperation {
+   static double Apply(double A) { return log(A); }
+};
+struct ExpOperation {
+   static double Apply(double A) { return exp(A); }
+};
+struct SqrtOperation {
+   static double Apply(double A) { return sqrt(A); }
+};
+struct SignOperation {
+   static double Apply(double A) { return (A < 0) ? -1 : (A > 0) ? 1 : A; }
+};
+struct RintOperation {
+   static double Apply(double A) { return floor(A + 0.5); }
+};
+struct AbsOperation {
+   static double Apply(double A) { return fabs(A); }
+};
+
+/** Aplica una operacion unaria sobre un bloque */
+template<class Operation>
+void unaryoperation(const double* const* pOperands, size_t Count, double* pDest) {
+   const double* pa = pOperands[0];
+   for (size_t i = 0; i < Count; ++i)
+      pDest[i] = Operation::Apply(pa[i]);
+}
+
+/** Aplica una operacion binaria sobre un bloque */
+template<class Operation>
+void binaryoperation(const double* const* pOperands, size_t Count, double* pDest) {
+   const double* pa = pOperands[0];
+   const double* pb = pOperands[1];
+   for (size_t i = 0; i < Count; ++i)
+      pDest[i] = Operation::Apply(pa[i], pb[i]);
+}
+
+/** Resuelve el condicional ?: sobre un bloque (como muParser, NaN es verdadero) */
+void conditionaloperation(const double* const* pOperands, size_t Count,
+                          double* pDest) {
+   const double* pcondition = pOperands[0];
+   const double* pa = pOperands[1];
+   const double* pb = pOperands[2];
+   for (size_t i = 0; i < Count; ++i)
+      pDest[i] = (pcondition[i] != 0) ? pa[i] : pb[i];
+}
+
+/** Operador binario soportado */
+struct BinaryOperatorInfo {
+   const char* pName_; /*! nombre del operador */
+   int precedence_; /*! precedencia */
+   bool rightAssociative_; /*! asociatividad */
+   BlockEquationEvaluator::OperationFunctionType pFunction_; /*! operacion */
+};
+
+/**
+ * Operadores binarios. Las precedencias son las de muParser y las que
+ * EquationParser::ConfigMuParser asigna a los operadores propios.
+ */
+const BinaryOperatorInfo BinaryOperators[] = {
+   { "and", 1, false, binaryoperation<AndOperation> },
+   { "||", 1, false, binaryoperation<OrOperation> },
+   { "or", 2, false, binaryoperation<OrOperation> },
+   { "&&", 2, false, binaryoperation<AndOperation> },
+   { "xor", 3, false, binaryoperation<XorOperation> },
+   { "==", 5, false, binaryoperation<EqualOperation> },
+   { "!=", 5, false, binaryoperation<NotEqualOperation> },
+   { "<=", 5, false, binaryoperation<LessEqualOperation> },
+   { ">=", 5, false, binaryoperation<GreaterEqualOperation> },
+   { "<", 5, false, binaryoperation<LessOperation> },
+   { ">", 5, false, binaryoperation<GreaterOperation> },
+   { "+", 6, false, binaryoperation<AddOperation> },
+   { "-", 6, false, binaryoperation<SubtractOperation> },
+   { "*", 7, false, binaryoperation<MultiplyOperation> },
+   { "/", 7, false, binaryoperation<DivideOperation> },
+   { "%", 7, false, binaryoperation<ModuloOperation> },
+   { "^", 8, true, binaryoperation<PowerOperation> }
+};
+
+/** Funcion soportada. Las de ArgumentCount negativo aceptan n argumentos */
+struct FunctionInfo {
+   const char* pName_; /*! nombre de la funcion */
+   int argumentCount_; /*! cantidad de argumentos */
+   BlockEquationEvaluator::OperationFunctionType pFunction_; /*! operacion */
+};
+
+/** Funciones de muParser */
+const FunctionInfo Functions[] = {
+   { "sin", 1, unaryoperation<SinOperation> },
+   { "cos", 1, unaryoperation<CosOperation> },
+   { "tan", 1, unaryoperation<TanOperation> },
+   { "asin", 1, unaryoperation<ASinOperation> },
+   { "acos", 1, unaryoperation<ACosOperation> },
+   { "atan", 1, unaryoperation<ATanOperation> },
+   { "sinh", 1, unaryoperation<SinhOperation> },
+   { "cosh", 1, unaryoperation<CoshOperation> },
+   { "tanh", 1, unaryoperation<TanhOperation> },
+   { "asinh", 1, unaryoperation<ASinhOperation> },
+   { "acosh", 1, unaryoperation<ACoshOperation> },
+   { "atanh", 1, unaryoperation<ATanhOperation> },
+   { "log2", 1, unaryoperation<Log2Operation> },
+   { "log10", 1, unaryoperation<Log10Operation> },
+   { "log", 1, unaryoperation<LnOperation> },
+   { "ln", 1, unaryoperation<LnOperation> },
+   { "exp", 1, unaryoperation<ExpOperation> },
+   { "sqrt", 1, unaryoperation<SqrtOperation> },
+   { "sign", 1, unaryoperation<SignOperation> },
+   { "rint", 1, unaryoperation<RintOperation> },
+   { "abs", 1, unaryoperation<AbsOperation> },
+   { "min", -1, binaryoperation<MinOperation> },
+   { "max", -1, binaryoperation<MaxOperation> },
+   { "sum", -1, binaryoperation<AddOperation> },
+   { "avg", -1, binaryoperation<AddOperation> }
+};
+
+/** Traduce una ecuacion a instrucciones de BlockEquationEvaluator */
+/**
+ *  Parser descendente recursivo con precedencia de operadores que emite las
+ * instrucciones a medida que reconoce cada subexpresion. Los registros
+ * temporales se liberan al ser consumidos, asi la cantidad de registros
+ * queda acotada por la profundidad de la ecuacion.
+ */
+class BlockEquationCompiler {
+public:
+   typedef BlockEquationEvaluator::Operand Operand;
+   typedef BlockEquationEvaluator::OperationFunctionType OperationFunctionType;
+
+   /** Ctor */
+   BlockEquationCompiler(const std::vector<std::string> &VariableNames,
+                         BlockEquationEvaluator &Evaluator) :
+         variableNames_(VariableNames), evaluator_(Evaluator), position_(0) {
+   }
+
+   /** Compila la ecuacion en el evaluador */
+   bool Compile(const std::string &Equation) {
+      if (!Tokenize(Equation) || tokens_.empty())
+         return false;
+      Operand result;
+      if (!ParseConditional(result) || position_ != tokens_.size())
+         return false;
+      evaluator_.result_ = result;
+      return true;
+   }
+
+private:
+   /** Elemento lexico de la ecuacion */
+   struct Token {
+      bool number_; /*! indica si es un numero */
+      std::string text_; /*! texto del elemento */
+      double value_; /*! valor si es numero */
+   };
+
+   /** Separa la ecuacion en numeros, nombres y operadores */
+   bool Tokenize(const std::string &Equation) {
+      // Operadores de mas de un caracter primero
+      static const char* poperators[] = { "==", "!=", "<=", ">=", "&&", "||", "<",
+                                          ">", "+", "-", "*", "/", "^", "%", "!",
+                                          "?", ":", "(", ")", "," };
+      size_t operatorcount = sizeof(poperators) / sizeof(poperators[0]);
+      size_t i = 0;
+      while (i < Equation.size()) {
+         char current = Equation[i];
+         if (isspace(current)) {
+            ++i;
+            continue;
+         }
+         Token token;
+         token.number_ = false;
+         token.value_ = 0;
+         size_t begin = i;
+         if (isdigit(current) || (current == '.' && i + 1 < Equation.size()
+               && isdigit(Equation[i + 1]))) {
+            while (i < Equation.size() && (isdigit(Equation[i]) || Equation[i] == '.'))
+               ++i;
+            if (i < Equation.size() && (Equation[i] == 'e' || Equation[i] == 'E')) {
+               size_t exponent = i + 1;
+               if (exponent < Equation.size()
+                     && (Equation[exponent] == '+' || Equation[exponent] == '-'))
+                  ++exponent;
+               if (exponent < Equation.size() && isdigit(Equation[exponent])) {
+                  i = exponent;
+                  while (i < Equation.size() && isdigit(Equation[i]))
+                     ++i;
+               }
+            }
+            std::istringstream stream(Equation.substr(begin, i - begin));
+            stream.imbue(std::locale::classic());
+            stream >> token.value_;
+            if (stream.fail() || !stream.eof())
+               return false;
+            token.number_ = true;
+         } else if (isalpha(current) || current == '_') {
+            while (i < Equation.size() && (isalnum(Equation[i]) || Equation[i] == '_'))
+               ++i;
+         } else {
+            size_t op = 0;
+            for (; op < operatorcount; ++op)
+               if (Equation.compare(i, strlen(poperators[op]), poperators[op]) == 0)
+                  break;
+            if (op == operatorcount)
+               return false;
+            i += strlen(poperators[op]);
+         }
+         token.text_ = Equation.substr(begin, i - begin);
+         tokens_.push_back(token);
+      }
+      return true;
+   }
+
+   /** Indica si el proximo elemento es Text (sin consumirlo) */
+   bool Peek(const char* pText) const {
+      return position_ < tokens_.size() && !tokens_[position_].number_
+            && tokens_[position_].text_ == pText;
+   }
+
+   /** Consume el proximo elemento si es Text */
+   bool Accept(const char* pText) {
+      if (!Peek(pText))
+         return false;
+      ++position_;
+      return true;
+   }
+
+   /** condicional := binario [ '?' condicional ':' condicional ] */
+   bool ParseConditional(Operand &Result) {
+      if (!ParseBinary(0, Result))
+         return false;
+      if (!Accept("?"))
+         return true;
+      Operand operands[3];
+      operands[0] = Result;
+      if (!ParseConditional(operands[1]) || !Accept(":")
+            || !ParseConditional(operands[2]))
+         return false;
+      Result = Emit(conditionaloperation, 3, operands);
+      return true;
+   }
+
+   /** Expresion con operadores binarios de precedencia >= MinPrecedence */
+   bool ParseBinary(int MinPrecedence, Operand &Result) {
+      if (!ParseUnary(Result))
+         return false;
+      while (position_ < tokens_.size() && !tokens_[position_].number_) {
+         const BinaryOperatorInfo* poperator = NULL;
+         for (size_t i = 0; i < sizeof(BinaryOperators) / sizeof(BinaryOperators[0]);
+               ++i)
+            if (tokens_[position_].text_ == BinaryOperators[i].pName_)
+               poperator = &BinaryOperators[i];
+         if (!poperator || poperator->precedence_ < MinPrecedence)
+            return true;
+         ++position_;
+         Operand operands[2];
+         operands[0] = Result;
+         int nextprecedence = poperator->rightAssociative_ ? poperator->precedence_ :
+                                                             poperator->precedence_ + 1;
+         if (!ParseBinary(nextprecedence, operands[1]))
+            return false;
+         Result = Emit(poperator->pFunction_, 2, operands);
+      }
+      return true;
+   }
+
+   /**
+    * Operadores unarios. Como en muParser solo ligan mas fuerte que ellos
+    * los operadores de mayor precedencia (-a^2 == -(a^2)).
+    */
+   bool ParseUnary(Operand &Result) {
+      if (Accept("+"))
+         return ParseBinary(INFIX_OPERATOR_PRECEDENCE + 1, Result);
+      OperationFunctionType pfunction = NULL;
+      if (Accept("-"))
+         pfunction = unaryoperation<NegateOperation>;
+      else if (Accept("!"))
+         pfunction = unaryoperation<NotOperation>;
+      else
+         return ParsePrimary(Result);
+      Operand operand;
+      if (!ParseBinary(INFIX_OPERATOR_PRECEDENCE + 1, operand))
+         return false;
+      Result = Emit(pfunction, 1, &operand);
+      return true;
+   }
+
+   /** Numeros, constantes, variables, funciones y parentesis */
+   bool ParsePrimary(Operand &Result) {
+      if (position_ >= tokens_.size())
+         return false;
+      const Token &token = tokens_[position_++];
+      if (token.number_) {
+         Result = MakeConstant(token.value_);
+         return true;
+      }
+      if (token.text_ == "(")
+         return ParseConditional(Result) && Accept(")");
+      if (!isalpha(token.text_[0]) && token.text_[0] != '_')
+         return false;
+      if (Peek("("))
+         return ParseFunction(token.text_, Result);
+      if (token.text_ == "_pi") {
+         Result = MakeConstant(3.141592653589793238462643);
+         return true;
+      }
+      if (token.text_ == "_e") {
+         Result = MakeConstant(2.718281828459045235360287);
+         return true;
+      }
+      std::vector<std::string>::const_iterator it = std::find(variableNames_.begin(),
+                                                              variableNames_.end(),
+                                                              token.text_);
+      if (it == variableNames_.end())
+         return false;
+      Result.type_ = Operand::Variable;
+      Result.index_ = it - variableNames_.begin();
+      Result.value_ = 0;
+      return true;
+   }
+
+   /** Llamada a funcion. Las de n argumentos se encadenan de izquierda a derecha */
+   bool ParseFunction(const std::string &Name, Operand &Result) {
+      const FunctionInfo* pfunction = NULL;
+      for (size_t i = 0; i < sizeof(Functions) / sizeof(Functions[0]); ++i)
+         if (Name == Functions[i].pName_)
+            pfunction = &Functions[i];
+      if (!pfunction || !Accept("("))
+         return false;
+      std::vector<Operand> arguments;
+      do {
+         Operand argument;
+         if (!ParseConditional(argument))
+            return false;
+         arguments.push_back(argument);
+      } while (Accept(","));
+      if (!Accept(")"))
+         return false;
+      if (pfunction->argumentCount_ > 0) {
+         if (arguments.size() != static_cast<size_t>(pfunction->argumentCount_))
+            return false;
+         Result = Emit(pfunction->pFunction_, arguments.size(), &arguments[0]);
+         return true;
+      }
+      Result = arguments[0];
+      for (size_t i = 1; i < arguments.size(); ++i) {
+         Operand operands[2] = { Result, arguments[i] };
+         Result = Emit(pfunction->pFunction_, 2, operands);
+      }
+      if (Name == "avg") {
+         Operand operands[2] = { Result, MakeConstant(arguments.size()) };
+         Result = Emit(binaryoperation<DivideOperation>, 2, operands);
+      }
+      return true;
+   }
+
+   /** Crea un operando constante */
+   static Operand MakeConstant(double Value) {
+      Operand operand;
+      operand.type_ = Operand::Constant;
+      operand.index_ = -1;
+      operand.value_ = Value;
+      return operand;
+   }
+
+   /** Obtiene un registro libre */
+   int AllocateRegister(bool Temporary) {
+      int index = 0;
+      if (Temporary && !freeRegisters_.empty()) {
+         index = freeRegisters_.back();
+         freeRegisters_.pop_back();
+      } else {
+         index = evaluator_.registerCount_++;
+      }
+      if (Temporary)
+         temporaryRegisters_.insert(index);
+      return index;
+   }
+
+   /**
+    * Agrega la instruccion al programa. Si todos los operandos son
+    * constantes la evalua y retorna la constante resultante.
+    */
+   Operand Emit(OperationFunctionType pFunction, int OperandCount,
+                const Operand* pOperands) {
+      bool constant = true;
+      for (int i = 0; i < OperandCount; ++i)
+         constant = constant && pOperands[i].type_ == Operand::Constant;
+      if (constant) {
+         double values[3];
+         const double* pvalues[3];
+         for (int i = 0; i < OperandCount; ++i) {
+            values[i] = pOperands[i].value_;
+            pvalues[i] = &values[i];
+         }
+         double result = 0;
+         pFunction(pvalues, 1, &result);
+         return MakeConstant(result);
+      }
+
+      BlockEquationEvaluator::Instruction instruction;
+      instruction.pFunction_ = pFunction;
+      instruction.operandCount_ = OperandCount;
+      for (int i = 0; i < OperandCount; ++i) {
+         instruction.operands_[i] = pOperands[i];
+         if (pOperands[i].type_ == Operand::Constant) {
+            instruction.operands_[i].type_ = Operand::Register;
+            instruction.operands_[i].index_ = AllocateRegister(false);
+            evaluator_.constants_.push_back(
+                  std::make_pair(instruction.operands_[i].index_, pOperands[i].value_));
+         }
+      }
+      // Las operaciones son elemento a elemento, el destino puede ser un operando
+      for (int i = 0; i < OperandCount; ++i) {
+         if (pOperands[i].type_ == Operand::Register
+               && temporaryRegisters_.erase(pOperands[i].index_) > 0)
+            freeRegisters_.push_back(pOperands[i].index_);
+      }
+      instruction.destination_ = AllocateRegister(true);
+      evaluator_.program_.push_back(instruction);
+
+      Operand result;
+      result.type_ = Operand::Register;
+      result.index_ = instruction.destination_;
+      result.value_ = 0;
+      return result;
+   }
+
+   const std::vector<std::string> &variableNames_; /*! variables de la ecuacion */
+   BlockEquationEvaluator &evaluator_; /*! evaluador donde se emite el programa */
+   std::vector<Token> tokens_; /*! elementos lexicos de la ecuacion */
+   size_t position_; /*! proximo elemento a analizar */
+   std::vector<int> freeRegisters_; /*! registros temporales libres */
+   std::set<int> temporaryRegisters_; /*! registros temporales en uso */
+};
+
+/** Ctor */
+BlockEquationEvaluator::BlockEquationEvaluator() :
+      registerCount_(0), compiled_(false) {
+   result_.type_ = Operand::Constant;
+   result_.index_ = -1;
+   result_.value_ = 0;
+}
+
+/** Dtor */
+BlockEquationEvaluator::~BlockEquationEvaluator() {
+}
+
+/**
+ * Compila la ecuacion a un programa sobre bloques.
+ * @param[in] Equation ecuacion con la sintaxis de EquationParser
+ * @param[in] VariableNames nombres de las variables. El indice de cada
+ * nombre es el indice del vector de variables que recibe Evaluate.
+ * @return true si la ecuacion se pudo compilar
+ * @return false si la ecuacion es invalida o usa algo no soportado
+ */
+bool BlockEquationEvaluator::Compile(const std::string &Equation,
+                                     const std::vector<std::string> &VariableNames) {
+   program_.clear();
+   constants_.clear();
+   registerCount_ = 0;
+   compiled_ = false;
+
+   BlockEquationCompiler compiler(VariableNames, *this);
+   if (!compiler.Compile(Equation)) {
+      program_.clear();
+      constants_.clear();
+      registerCount_ = 0;
+      return false;
+   }
+
+   registers_.assign(registerCount_ * BLOCK_EQUATION_SIZE, 0);
+   for (size_t i = 0; i < constants_.size(); ++i)
+      std::fill(registers_.begin() + constants_[i].first * BLOCK_EQUATION_SIZE,
+                registers_.begin() + (constants_[i].first + 1) * BLOCK_EQUATION_SIZE,
+                constants_[i].second);
+   compiled_ = true;
+   return true;
+}
+
+/**
+ * Evalua la ecuacion compilada.
+ * @param[in] Variables valores de cada variable (en el orden de Compile)
+ * @param[in] Count cantidad de pixeles
+ * @param[out] pResult resultado de la ecuacion para cada pixel
+ */
+void BlockEquationEvaluator::Evaluate(const std::vector<const double*> &Variables,
+                                      size_t Count, double* pResult) {
+   if (!compiled_)
+      return;
+   for (size_t offset = 0; offset < Count; offset += BLOCK_EQUATION_SIZE)
+      EvaluateBlock(Variables, offset,
+                    std::min(Count - offset, static_cast<size_t>(BLOCK_EQUATION_SIZE)),
+                    pResult + offset);
+}
+
+/**
+ * Ejecuta las instrucciones sobre un bloque.
+ * @param[in] Variables valores de cada variable
+ * @param[in] Offset primer pixel del bloque
+ * @param[in] Count cantidad de pixeles (<= BLOCK_EQUATION_SIZE)
+ * @param[out] pResult resultado del bloque
+ */
+void BlockEquationEvaluator::EvaluateBlock(
+      const std::vector<const double*> &Variables, size_t Offset, size_t Count,
+      double* pResult) {
+   double* pregisters = registers_.empty() ? NULL : &registers_[0];
+   const double* poperands[3];
+   for (size_t i = 0; i < program_.size(); ++i) {
+      const Instruction &instruction = program_[i];
+      for (int j = 0; j < instruction.operandCount_; ++j) {
+         const Operand &operand = instruction.operands_[j];
+         poperands[j] = (operand.type_ == Operand::Variable) ?
+               Variables[operand.index_] + Offset :
+               pregisters + operand.index_ * BLOCK_EQUATION_SIZE;
+      }
+      instruction.pFunction_(poperands, Count,
+                             pregisters + instruction.destination_ * BLOCK_EQUATION_SIZE);
+   }
+
+   if (result_.type_ == Operand::Constant) {
+      std::fill(pResult, pResult + Count, result_.value_);
+   } else {
+      const double* presult = (result_.type_ == Operand::Variable) ?
+            Variables[result_.index_] + Offset :
+            pregisters + result_.index_ * BLOCK_EQUATION_SIZE;
+      std::copy(presult, presult + Count, pResult);
+   }
+}
+
+}  // namespace suri
@@ -0,0 +1,116 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef BLOCKEQUATIONEVALUATOR_H_
+#define BLOCKEQUATIONEVALUATOR_H_
+
+// Includes estandar
+#include <vector>
+#include <string>
+#include <cstddef>
+
+// Includes Suri
+
+// Includes Wx
+
+// Includes App
+
+// Defines
+/** Cantidad de pixeles que evalua cada operacion del programa */
+#define BLOCK_EQUATION_SIZE 2048
+
+/** namespace suri */
+namespace suri {
+
+/** Evalua una ecuacion de algebra de bandas sobre bloques de pixeles */
+/**
+ *  Compila la ecuacion (con la misma sintaxis que acepta EquationParser:
+ * operadores de muParser, and/or/xor/!/%, == y !=, condicional ?: y las
+ * funciones de muParser) a un programa de instrucciones sobre registros de
+ * BLOCK_EQUATION_SIZE doubles. Cada instruccion recorre el bloque completo
+ * con un lazo contiguo, en lugar de interpretar la ecuacion pixel a pixel.
+ * Las subexpresiones constantes se resuelven al compilar.
+ *  Si la ecuacion usa algo que el compilador no soporta Compile falla y el
+ * llamador debe usar EquationParser.
+ */
+class BlockEquationEvaluator {
+   /** Ctor. de Copia. */
+   BlockEquationEvaluator(const BlockEquationEvaluator &BlockEquationEvaluator);
+
+public:
+   /** Ctor */
+   BlockEquationEvaluator();
+   /** Dtor */
+   ~BlockEquationEvaluator();
+
+   /** Compila la ecuacion. Las variables se indexan segun VariableNames */
+   bool Compile(const std::string &Equation,
+                const std::vector<std::string> &VariableNames);
+   /** Evalua la ecuacion compilada sobre Count pixeles */
+   void Evaluate(const std::vector<const double*> &Variables, size_t Count,
+                 double* pResult);
+
+   /** Funcion que ejecuta una instruccion sobre un bloque */
+   typedef void (*OperationFunctionType)(const double* const*, size_t, double*);
+
+   /** Operando de una instruccion */
+   struct Operand {
+      /** Tipos de operando */
+      enum OperandType {
+         Constant, Variable, Register
+      };
+      OperandType type_; /*! tipo de operando */
+      int index_; /*! indice de la variable o del registro */
+      double value_; /*! valor si es constante */
+   };
+
+private:
+   /** Instruccion del programa */
+   struct Instruction {
+      OperationFunctionType pFunction_; /*! operacion */
+      int destination_; /*! registro destino */
+      int operandCount_; /*! cantidad de operandos */
+      Operand operands_[3]; /*! operandos (variables o registros) */
+   };
+
+   friend class BlockEquationCompiler;
+
+   /** Ejecuta el programa sobre un bloque a partir del pixel Offset */
+   void EvaluateBlock(const std::vector<const double*> &Variables, size_t Offset,
+                      size_t Count, double* pResult);
+
+   std::vector<Instruction> program_; /*! instrucciones en orden de ejecucion */
+   std::vector<std::pair<int, double> > constants_; /*! registros constantes */
+   Operand result_; /*! operando con el resultado */
+   int registerCount_; /*! cantidad de registros */
+   std::vector<double> registers_; /*! memoria de los registros */
+   bool compiled_; /*! indica si hay un programa valido */
+};
+
+}  // namespace suri
+
+#endif /* BLOCKEQUATIONEVALUATOR_H_ */
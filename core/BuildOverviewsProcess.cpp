@@ -0,0 +1,107 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+// Includes Estandar
+#include <string>
+#include <vector>
+// Includes Suri
+#include "suri/BuildOverviewsProcess.h"
+#include "suri/OverviewBuilder.h"
+#include "suri/Image.h"
+// Includes Wx
+#include "wx/xml/xml.h"
+#include "wx/sstream.h"
+// Defines
+// forwards
+
+namespace suri {
+
+const std::string BuildOverviewsProcess::kProcessName = "BuildOverviewsProcess";
+
+/**
+ * @param[in] Filename imagen de la que se generan los overviews
+ * @param[in] Factors factores de reduccion. Si esta vacio se usan los
+ * sugeridos por OverviewBuilder::GetDefaultFactors
+ */
+BuildOverviewsProcess::BuildOverviewsProcess(const std::string &Filename,
+                                             const std::vector<int> &Factors) :
+      filename_(Filename), factors_(Factors) {
+   SetProcessName(kProcessName);
+}
+
+/** Destructor */
+BuildOverviewsProcess::~BuildOverviewsProcess() {
+}
+
+bool BuildOverviewsProcess::ConfigureProcess() {
+   return true;
+}
+
+bool BuildOverviewsProcess::ConfigureOutput() {
+   return true;
+}
+
+/**
+ * Abre la imagen en modo lectura y genera sus overviews si no existen o estan
+ * desactualizados respecto de la imagen.
+ * @return true si pudo generar todos los niveles o ya estaban actualizados
+ */
+bool BuildOverviewsProcess::RunProcess() {
+   Image *pimage = Image::Open(filename_);
+   if (!pimage)
+      return false;
+   std::vector<int> factors = factors_;
+   if (factors.empty())
+      factors = OverviewBuilder::GetDefaultFactors(pimage->GetSizeX(),
+                                                   pimage->GetSizeY());
+   OverviewBuilder builder(pimage);
+   bool success = builder.IsUpToDate(factors) || builder.Build(factors);
+   Image::Close(pimage);
+   return success;
+}
+
+/**
+ * Metodo que a partir de un xml que contiene los parametros del proceso configura el mismo.
+ * @param[in] XmStr string en formato xml que contiene los parametros necesarios para la
+ * correcta ejecucion del proceso
+ * @return true en caso de poder configurar correctamente el proceso en funcion de los parametros
+ * @return false en caso contrario
+ **/
+bool BuildOverviewsProcess::ConfigureProcessFromXmlString(const std::string& XmlStr) {
+   wxStringInputStream ss(XmlStr);
+   wxXmlDocument doc(ss);
+   wxXmlNode* pRoot = doc.GetRoot();
+   this->pAdaptLayer_ = ProcessAdaptLayer::DeserializeXml(pRoot->GetChildren());
+   return (pAdaptLayer_ != NULL);
+}
+
+/** Metodo que obtiene los parametros asociados al proceso en formato XML. **/
+std::string BuildOverviewsProcess::GetParametersAsXmlString() const {
+   return this->pAdaptLayer_->GetAttributesAsXmlString();
+}
+
+} /** namespace suri */
@@ -28,25 +28,136 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 // Includes standard
 #include <utility>
 #include <string>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
 
 // Includes Suri
 #include "CacheRenderer.h"
 #include "suri/xmlnames.h"
 #include "suri/DataTypes.h"
 #include "suri/World.h"
+#include "suri/Configuration.h"
 #include "MemoryCanvas.h"
 #include "Mask.h"
 
 // Includes Wx
+#include "wx/thread.h"
 
 // Defines
+/** Tamanio (en pixeles) del lado de un tile */
+#define CACHE_TILE_SIZE 256
+/**
+ * Pixeles que se renderizan alrededor de cada region y se descartan, para que
+ * los bordes de la region no dependan de su recorte (decimacion, filtros)
+ */
+#define CACHE_TILE_MARGIN 8
+/** Presupuesto de memoria por defecto de los tiles de todos los elementos (MB) */
+#define DEFAULT_TILE_CACHE_SIZE_MB 64
+/** Cantidad maxima de niveles de zoom con tiles */
+#define MAX_TILE_LEVELS 8
+/** Tolerancia relativa para considerar iguales dos tamanios de pixel */
+#define PIXEL_SIZE_TOLERANCE 1e-9
+/** Tolerancia (en pixeles) para considerar alineadas dos grillas */
+#define TILE_PHASE_TOLERANCE 1e-3
+/** Coordenada de pixel maxima para usar tiles (evita desbordes de int) */
+#define MAX_TILE_COORDINATE 1e9
 
 /** Macro para registrar el renderer */
 AUTO_REGISTER_RENDERER(suri::CacheRenderer);
 
 namespace suri {
+
+namespace {
+/** Division entera que redondea hacia -infinito */
+int FloorDiv(int Value, int Divisor) {
+   return Value >= 0 ? Value / Divisor : -((-Value + Divisor - 1) / Divisor);
+}
+
+/** Indica si dos tamanios de pixel son iguales */
+bool SamePixelSize(double Lhs, double Rhs) {
+   return std::fabs(Lhs - Rhs) <= PIXEL_SIZE_TOLERANCE * std::fabs(Lhs);
+}
+
+/**
+ * Copia una region entre dos buffers de una banda. Las coordenadas son de la
+ * grilla global de pixeles del nivel de zoom.
+ * @param[in] pSource buffer origen
+ * @param[in] SourceCol columna global del pixel 0 del origen
+ * @param[in] SourceRow fila global del pixel 0 del origen
+ * @param[in] SourceWidth ancho del origen
+ * @param[out] pDest buffer destino
+ * @param[in] DestCol columna global del pixel 0 del destino
+ * @param[in] DestRow fila global del pixel 0 del destino
+ * @param[in] DestWidth ancho del destino
+ * @param[in] Col0 primer columna a copiar
+ * @param[in] Row0 primer fila a copiar
+ * @param[in] Col1 columna siguiente a la ultima a copiar
+ * @param[in] Row1 fila siguiente a la ultima a copiar
+ * @param[in] DataSize tamanio del pixel en bytes
+ */
+void CopyRegion(const unsigned char *pSource, int SourceCol, int SourceRow,
+                int SourceWidth, unsigned char *pDest, int DestCol, int DestRow,
+                int DestWidth, int Col0, int Row0, int Col1, int Row1, int DataSize) {
+   size_t linesize = static_cast<size_t>(Col1 - Col0) * DataSize;
+   for (int row = Row0; row < Row1; ++row) {
+      const unsigned char *psrc = pSource
+            + (static_cast<size_t>(row - SourceRow) * SourceWidth + (Col0 - SourceCol))
+                  * DataSize;
+      unsigned char *pdst = pDest
+            + (static_cast<size_t>(row - DestRow) * DestWidth + (Col0 - DestCol))
+                  * DataSize;
+      memcpy(pdst, psrc, linesize);
+   }
+}
+
+/**
+ * Lee todas las bandas de un canvas.
+ * @param[in] pCanvas canvas a leer
+ * @param[out] Buffers datos de cada banda
+ */
+void ReadCanvas(const Canvas *pCanvas, std::vector<std::vector<unsigned char> > &Buffers) {
+   int bandcount = pCanvas->GetBandCount();
+   size_t size = static_cast<size_t>(pCanvas->GetSizeX()) * pCanvas->GetSizeY()
+         * pCanvas->GetDataSize();
+   std::vector<int> bands(bandcount);
+   std::vector<void*> data(bandcount);
+   Buffers.assign(bandcount, std::vector<unsigned char>(size));
+   for (int b = 0; b < bandcount; ++b) {
+      bands[b] = b;
+      data[b] = Buffers[b].empty() ? NULL : &Buffers[b][0];
+   }
+   if (size > 0) {
+      pCanvas->Read(bands, data);
+   }
+}
+
+/**
+ * Escribe todas las bandas de un canvas.
+ * @param[in] Buffers datos de cada banda
+ * @param[out] pCanvas canvas a escribir
+ */
+void WriteCanvas(std::vector<std::vector<unsigned char> > &Buffers, Canvas *pCanvas) {
+   std::vector<int> bands(Buffers.size());
+   std::vector<void*> data(Buffers.size());
+   for (size_t b = 0; b < Buffers.size(); ++b) {
+      bands[b] = b;
+      data[b] = Buffers[b].empty() ? NULL : &Buffers[b][0];
+   }
+   if (!Buffers.empty() && !Buffers[0].empty()) {
+      pCanvas->Write(bands, data);
+   }
+}
+}  // namespace
+
 /** Inicializacion de la variable estatica */
 CacheRenderer::CachedElementsMap CacheRenderer::cachedElements_;
+/** Inicializacion de las variables estaticas de los tiles */
+std::list<CacheRenderer*> CacheRenderer::tileRenderers_;
+size_t CacheRenderer::totalTileBytes_ = 0;
+size_t CacheRenderer::tileBudget_ = 0;
+unsigned long CacheRenderer::tileClock_ = 0;
+wxMutex CacheRenderer::tileMutex_;
 
 // ------------------------- METODOS DE BUSQUEDA ----------------------------
 /** Obtiene los caches asociados a un elemento */
@@ -66,12 +177,25 @@ CacheRenderer::CanvasCache::~CanvasCache() {
    delete pMask_;
 }
 
-CacheRenderer::CacheRenderer() {
+/**
+ *  Registra el renderizador entre los que comparten el presupuesto de
+ * memoria de los tiles (lib_render_tile_cache_size, en MB).
+ */
+CacheRenderer::CacheRenderer() :
+      tileBytes_(0), tileBandCount_(0) {
+   long budgetmb = Configuration::GetParameter("lib_render_tile_cache_size",
+                                               static_cast<long>(DEFAULT_TILE_CACHE_SIZE_MB));
+   wxMutexLocker lock(tileMutex_);
+   tileBudget_ = static_cast<size_t>(budgetmb > 0 ? budgetmb : 0) * 1024 * 1024;
+   tileRenderers_.push_back(this);
 }
 
 CacheRenderer::~CacheRenderer() {
    // TODO: eliminar del mapa
 // cachedElements_.erase(std::make_pair(pElement,prenderer->cache_.pCanvas_));
+   ClearTiles();
+   wxMutexLocker lock(tileMutex_);
+   tileRenderers_.remove(this);
 }
 
 // -------------------------- METODO DE CREACION ----------------------------
@@ -105,10 +229,68 @@ std::string CacheRenderer::CreatedNode() const {
 
 // ----------------------- METODOS DE RENDERIZACION -------------------------
 /** Renderiza el elemento dado un World en un Canvas */
+/**
+ *  Los datos renderizados se guardan en tiles de CACHE_TILE_SIZE pixeles
+ * alineados a una grilla global de pixeles por nivel de zoom (tamanio de
+ * pixel y fase de la grilla). Al desplazar la ventana (o volver a un zoom
+ * anterior) solo se renderizan a traves del anterior las franjas del
+ * viewport que no estan en los tiles; el resto se copia de los tiles.
+ *  Los tiles de todos los elementos comparten un presupuesto de memoria
+ * (lib_render_tile_cache_size, en MB); al excederlo se eliminan los usados
+ * hace mas tiempo, sin importar a que renderizador pertenecen.
+ *  Los tiles se renderizan sobre un canvas limpio, por lo que solo se usan
+ * si hay mascara: la salida se compone sobre el canvas de entrada aplicando
+ * la mascara, y el fondo se conserva donde el elemento no tiene datos (igual
+ * que al renderizar la ventana completa). Sin mascara el fondo forma parte
+ * de lo renderizado y se renderiza la ventana completa.
+ *  cache_.pCanvas_ siempre queda con los datos del viewport completo, ya que
+ * es el canvas que obtienen PixelInfoTool y RasterDnInfo con
+ * GetCacheForElement.
+ *  Si no se pueden usar tiles (sin mascara o presupuesto, coordenadas fuera
+ * de rango o el anterior no respeta el tamanio pedido) se renderiza la
+ * ventana completa como antes.
+ */
 bool CacheRenderer::Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pMask) {
    if (!pPreviousRenderer_) {
       return false;
    }
+   if (!pMask || tileBudget_ == 0 || pPreviousRenderer_->IsDirty()) {
+      ClearTiles();
+   }
+   if (!pMask || tileBudget_ == 0) {
+      return RenderWindow(pWorldWindow, pCanvas, pMask);
+   }
+   Subset window;
+   pWorldWindow->GetWindow(window);
+   // Si los tiles estan vigentes y la ventana es la misma, utiliza el cache
+   if (HasTiles() && window == cache_.renderedWindow_) {
+      WriteCache(pCanvas, pMask);
+      return true;
+   }
+   TileRange range;
+   if (!GetTileRange(pWorldWindow, range)
+         || !RenderMissingTiles(pWorldWindow, range, pCanvas, pMask)
+         || !AssembleViewport(range, pCanvas, pMask)) {
+      ClearTiles();
+      return RenderWindow(pWorldWindow, pCanvas, pMask);
+   }
+   WriteCache(pCanvas, pMask);
+   cache_.renderedWindow_ = window;
+   wxMutexLocker lock(tileMutex_);
+   EvictTiles();
+   return true;
+}
+
+/**
+ *  Renderiza sin tiles: si el anterior no cambio y la ventana es la misma
+ * utiliza el cache, sino renderiza la ventana completa a traves del
+ * anterior.
+ * @param[in] pWorldWindow mundo con la ventana a renderizar
+ * @param[out] pCanvas canvas de salida
+ * @param[out] pMask mascara de salida
+ * @return resultado de la renderizacion
+ */
+bool CacheRenderer::RenderWindow(const World *pWorldWindow, Canvas* pCanvas, Mask* pMask) {
    Subset window;
    pWorldWindow->GetWindow(window);
    bool retval = true;
@@ -168,6 +350,425 @@ bool CacheRenderer::Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pMa
    return retval;
 }
 
+/**
+ * Copia el canvas y la mascara cacheados a la salida.
+ * @param[out] pCanvas canvas de salida
+ * @param[out] pMask mascara de salida
+ */
+void CacheRenderer::WriteCache(Canvas* pCanvas, Mask* pMask) {
+   pCanvas->InitializeAs(cache_.pCanvas_);
+   if (cache_.pMask_ && pMask) {
+      pMask->InitializeAs(cache_.pMask_);
+      dynamic_cast<Canvas*>(pMask)->Write(cache_.pMask_, NULL);
+      pMask->ApplyMask(cache_.pCanvas_, pCanvas);
+   } else {
+      pCanvas->Write(cache_.pCanvas_, pMask);
+   }
+}
+
+/**
+ *  Obtiene el nivel de zoom de la ventana (lo crea si no existe) y la
+ * posicion del viewport en la grilla global de pixeles del nivel. Dos
+ * ventanas comparten nivel si tienen el mismo tamanio de pixel y sus
+ * grillas estan alineadas (desplazamientos de pixeles enteros).
+ * @param[in] pWorldWindow mundo con la ventana a renderizar
+ * @param[out] Range region de la grilla que ocupa el viewport
+ * @return false si no se pueden usar tiles para la ventana
+ */
+bool CacheRenderer::GetTileRange(const World *pWorldWindow, TileRange &Range) {
+   Subset window;
+   pWorldWindow->GetWindow(window);
+   int vpwidth = 0, vpheight = 0;
+   pWorldWindow->GetViewport(vpwidth, vpheight);
+   if (vpwidth <= 0 || vpheight <= 0) {
+      return false;
+   }
+   double pixelsizex = (window.lr_.x_ - window.ul_.x_) / vpwidth;
+   double pixelsizey = (window.lr_.y_ - window.ul_.y_) / vpheight;
+   if (pixelsizex == 0 || pixelsizey == 0) {
+      return false;
+   }
+   double col = window.ul_.x_ / pixelsizex, row = window.ul_.y_ / pixelsizey;
+   if (std::fabs(col) + vpwidth > MAX_TILE_COORDINATE
+         || std::fabs(row) + vpheight > MAX_TILE_COORDINATE) {
+      return false;
+   }
+   Range.width_ = vpwidth;
+   Range.height_ = vpheight;
+   for (size_t i = 0; i < tileLevels_.size(); ++i) {
+      const TileLevel &level = tileLevels_[i];
+      if (!SamePixelSize(level.pixelSizeX_, pixelsizex)
+            || !SamePixelSize(level.pixelSizeY_, pixelsizey)) {
+         continue;
+      }
+      double dcol = col - level.phaseX_, drow = row - level.phaseY_;
+      double rcol = std::floor(dcol + 0.5), rrow = std::floor(drow + 0.5);
+      if (std::fabs(dcol - rcol) < TILE_PHASE_TOLERANCE
+            && std::fabs(drow - rrow) < TILE_PHASE_TOLERANCE) {
+         Range.level_ = i;
+         Range.col_ = static_cast<int>(rcol);
+         Range.row_ = static_cast<int>(rrow);
+         return true;
+      }
+   }
+   if (tileLevels_.size() >= MAX_TILE_LEVELS) {
+      ClearTiles();
+   }
+   TileLevel level;
+   level.pixelSizeX_ = pixelsizex;
+   level.pixelSizeY_ = pixelsizey;
+   level.phaseX_ = col - std::floor(col);
+   level.phaseY_ = row - std::floor(row);
+   tileLevels_.push_back(level);
+   Range.level_ = tileLevels_.size() - 1;
+   Range.col_ = static_cast<int>(std::floor(col));
+   Range.row_ = static_cast<int>(std::floor(row));
+   return true;
+}
+
+/**
+ *  Busca los tiles del viewport que no existen o cuya region valida no
+ * cubre la parte del viewport que les corresponde. Los agrupa en
+ * rectangulos (tramos de tiles contiguos en filas consecutivas), de manera
+ * que al desplazar la ventana solo se renderizan las franjas expuestas, y
+ * renderiza cada uno recortado al viewport.
+ * @param[in] pWorldWindow mundo con la ventana a renderizar
+ * @param[in] Range region de la grilla que ocupa el viewport
+ * @param[in] pCanvas canvas de salida (se copia su configuracion)
+ * @param[in] pMask mascara de salida (se copia su configuracion)
+ * @return false si fallo la renderizacion de alguna region
+ */
+bool CacheRenderer::RenderMissingTiles(const World *pWorldWindow, const TileRange &Range,
+                                       const Canvas *pCanvas, const Mask *pMask) {
+   int col1 = Range.col_ + Range.width_, row1 = Range.row_ + Range.height_;
+   int tilex0 = FloorDiv(Range.col_, CACHE_TILE_SIZE);
+   int tiley0 = FloorDiv(Range.row_, CACHE_TILE_SIZE);
+   int tilecountx = FloorDiv(col1 - 1, CACHE_TILE_SIZE) - tilex0 + 1;
+   int tilecounty = FloorDiv(row1 - 1, CACHE_TILE_SIZE) - tiley0 + 1;
+   std::vector<bool> missing(tilecountx * tilecounty, false);
+   wxMutexLocker lock(tileMutex_);
+   for (int ty = 0; ty < tilecounty; ++ty) {
+      for (int tx = 0; tx < tilecountx; ++tx) {
+         Tile *ptile = FindTile(TileKey(Range.level_, tilex0 + tx, tiley0 + ty));
+         int tcol0 = (tilex0 + tx) * CACHE_TILE_SIZE, trow0 = (tiley0 + ty) * CACHE_TILE_SIZE;
+         int ncol0 = std::max(tcol0, Range.col_), nrow0 = std::max(trow0, Range.row_);
+         int ncol1 = std::min(tcol0 + CACHE_TILE_SIZE, col1);
+         int nrow1 = std::min(trow0 + CACHE_TILE_SIZE, row1);
+         missing[ty * tilecountx + tx] = !ptile || ptile->validCol0_ > ncol0
+               || ptile->validRow0_ > nrow0 || ptile->validCol1_ < ncol1
+               || ptile->validRow1_ < nrow1;
+      }
+   }
+   for (int ty = 0; ty < tilecounty; ++ty) {
+      for (int tx = 0; tx < tilecountx; ++tx) {
+         if (!missing[ty * tilecountx + tx]) {
+            continue;
+         }
+         // tramo de tiles faltantes en la fila
+         int width = 1;
+         while (tx + width < tilecountx && missing[ty * tilecountx + tx + width]) {
+            ++width;
+         }
+         // filas siguientes con el mismo tramo faltante
+         int height = 1;
+         bool extend = true;
+         while (extend && ty + height < tilecounty) {
+            for (int i = 0; i < width && extend; ++i) {
+               extend = missing[(ty + height) * tilecountx + tx + i];
+            }
+            if (extend) {
+               ++height;
+            }
+         }
+         for (int j = 0; j < height; ++j) {
+            for (int i = 0; i < width; ++i) {
+               missing[(ty + j) * tilecountx + tx + i] = false;
+            }
+         }
+         int rcol0 = std::max((tilex0 + tx) * CACHE_TILE_SIZE, Range.col_);
+         int rrow0 = std::max((tiley0 + ty) * CACHE_TILE_SIZE, Range.row_);
+         int rcol1 = std::min((tilex0 + tx + width) * CACHE_TILE_SIZE, col1);
+         int rrow1 = std::min((tiley0 + ty + height) * CACHE_TILE_SIZE, row1);
+         // la renderizacion no bloquea los tiles de los demas renderizadores
+         tileMutex_.Unlock();
+         bool rendered = RenderRegion(pWorldWindow, Range, rcol0, rrow0, rcol1, rrow1,
+                                      pCanvas, pMask);
+         tileMutex_.Lock();
+         if (!rendered) {
+            return false;
+         }
+      }
+   }
+   return true;
+}
+
+/**
+ *  Renderiza a traves del anterior una region de la grilla con un mundo
+ * cuya ventana y viewport corresponden a la region ampliada en
+ * CACHE_TILE_MARGIN pixeles por lado, y copia el interior del resultado a los
+ * tiles que la contienen. El margen descartado absorbe las diferencias que
+ * el recorte produce en los bordes (decimacion, filtros), de modo que los
+ * pixeles de la region son los de una renderizacion de la ventana completa.
+ * @param[in] pWorldWindow mundo del que se copia la configuracion
+ * @param[in] Range region de la grilla que ocupa el viewport
+ * @param[in] Col0 primer columna global de la region
+ * @param[in] Row0 primer fila global de la region
+ * @param[in] Col1 columna global siguiente a la ultima de la region
+ * @param[in] Row1 fila global siguiente a la ultima de la region
+ * @param[in] pCanvas canvas de salida (se copia su configuracion)
+ * @param[in] pMask mascara de salida (se copia su configuracion)
+ * @return false si fallo la renderizacion o el resultado no es compatible
+ *         con los tiles
+ */
+bool CacheRenderer::RenderRegion(const World *pWorldWindow, const TileRange &Range,
+                                 int Col0, int Row0, int Col1, int Row1,
+                                 const Canvas *pCanvas, const Mask *pMask) {
+   const TileLevel &level = tileLevels_[Range.level_];
+   // region renderizada, con el margen que luego se descarta
+   int mcol0 = Col0 - CACHE_TILE_MARGIN, mrow0 = Row0 - CACHE_TILE_MARGIN;
+   int mcol1 = Col1 + CACHE_TILE_MARGIN, mrow1 = Row1 + CACHE_TILE_MARGIN;
+   int width = mcol1 - mcol0, height = mrow1 - mrow0;
+   World world(*pWorldWindow);
+   world.SetViewport(width, height);
+   world.SetWindow(Subset((mcol0 + level.phaseX_) * level.pixelSizeX_,
+                          (mrow0 + level.phaseY_) * level.pixelSizeY_,
+                          (mcol1 + level.phaseX_) * level.pixelSizeX_,
+                          (mrow1 + level.phaseY_) * level.pixelSizeY_));
+   MemoryCanvas canvas;
+   canvas.InitializeAs(pCanvas);
+   canvas.SetSize(width, height);
+   canvas.Clear();
+   Mask *pmask = NULL;
+   if (pMask) {
+      pmask = new Mask;
+      pmask->InitializeAs(pMask);
+      pmask->SetSize(width, height);
+      pmask->Clear();
+   }
+   bool retval = pPreviousRenderer_->Render(&world, &canvas, pmask);
+   TileBuffers data, maskdata;
+   if (retval && canvas.GetSizeX() == width && canvas.GetSizeY() == height
+         && (!pmask || (pmask->GetSizeX() == width && pmask->GetSizeY() == height))) {
+      ReadCanvas(&canvas, data);
+      if (pmask) {
+         ReadCanvas(pmask, maskdata);
+      }
+   } else {
+      retval = false;
+   }
+   int maskdatasize = pmask ? pmask->GetDataSize() : 0;
+   delete pmask;
+   if (!retval) {
+      return false;
+   }
+   int datasize = canvas.GetDataSize();
+   wxMutexLocker lock(tileMutex_);
+   if (tiles_.empty()) {
+      tileDataType_ = canvas.GetDataType();
+      tileBandCount_ = canvas.GetBandCount();
+   } else if (tileDataType_ != canvas.GetDataType()
+         || tileBandCount_ != canvas.GetBandCount()) {
+      return false;
+   }
+
+   int tilex0 = FloorDiv(Col0, CACHE_TILE_SIZE), tilex1 = FloorDiv(Col1 - 1, CACHE_TILE_SIZE);
+   int tiley0 = FloorDiv(Row0, CACHE_TILE_SIZE), tiley1 = FloorDiv(Row1 - 1, CACHE_TILE_SIZE);
+   for (int ty = tiley0; ty <= tiley1; ++ty) {
+      for (int tx = tilex0; tx <= tilex1; ++tx) {
+         TileKey key(Range.level_, tx, ty);
+         Tile *ptile = FindTile(key);
+         if (!ptile) {
+            Tile tile(key);
+            size_t tilesize = CACHE_TILE_SIZE * CACHE_TILE_SIZE;
+            tile.bands_.assign(data.size(), std::vector<unsigned char>(tilesize * datasize));
+            tile.mask_.assign(maskdata.size(),
+                              std::vector<unsigned char>(tilesize * maskdatasize));
+            tile.lastUse_ = ++tileClock_;
+            tiles_.push_front(tile);
+            tileIndex_[key] = tiles_.begin();
+            tileBytes_ += GetTileBytes(tiles_.front());
+            totalTileBytes_ += GetTileBytes(tiles_.front());
+            ptile = &tiles_.front();
+         }
+         int tcol0 = tx * CACHE_TILE_SIZE, trow0 = ty * CACHE_TILE_SIZE;
+         int ccol0 = std::max(tcol0, Col0), crow0 = std::max(trow0, Row0);
+         int ccol1 = std::min(tcol0 + CACHE_TILE_SIZE, Col1);
+         int crow1 = std::min(trow0 + CACHE_TILE_SIZE, Row1);
+         for (size_t b = 0; b < data.size(); ++b) {
+            CopyRegion(&data[b][0], mcol0, mrow0, width, &ptile->bands_[b][0], tcol0,
+                       trow0, CACHE_TILE_SIZE, ccol0, crow0, ccol1, crow1, datasize);
+         }
+         for (size_t b = 0; b < maskdata.size() && b < ptile->mask_.size(); ++b) {
+            CopyRegion(&maskdata[b][0], mcol0, mrow0, width, &ptile->mask_[b][0], tcol0,
+                       trow0, CACHE_TILE_SIZE, ccol0, crow0, ccol1, crow1, maskdatasize);
+         }
+         // la region valida debe ser un rectangulo: se une con la anterior
+         // solo si la union es un rectangulo
+         bool empty = ptile->validCol1_ <= ptile->validCol0_
+               || ptile->validRow1_ <= ptile->validRow0_;
+         bool samecols = ptile->validCol0_ == ccol0 && ptile->validCol1_ == ccol1;
+         bool samerows = ptile->validRow0_ == crow0 && ptile->validRow1_ == crow1;
+         bool touchrows = ptile->validRow0_ <= crow1 && crow0 <= ptile->validRow1_;
+         bool touchcols = ptile->validCol0_ <= ccol1 && ccol0 <= ptile->validCol1_;
+         if (!empty && ((samecols && touchrows) || (samerows && touchcols))) {
+            ptile->validCol0_ = std::min(ptile->validCol0_, ccol0);
+            ptile->validRow0_ = std::min(ptile->validRow0_, crow0);
+            ptile->validCol1_ = std::max(ptile->validCol1_, ccol1);
+            ptile->validRow1_ = std::max(ptile->validRow1_, crow1);
+         } else if (empty || ccol0 > ptile->validCol0_ || crow0 > ptile->validRow0_
+               || ccol1 < ptile->validCol1_ || crow1 < ptile->validRow1_) {
+            // si la region nueva no contiene a la anterior se queda con la nueva
+            ptile->validCol0_ = ccol0;
+            ptile->validRow0_ = crow0;
+            ptile->validCol1_ = ccol1;
+            ptile->validRow1_ = crow1;
+         }
+      }
+   }
+   return true;
+}
+
+/**
+ *  Copia de los tiles al canvas cacheado (y su mascara) la region que ocupa
+ * el viewport.
+ * @param[in] Range region de la grilla que ocupa el viewport
+ * @param[in] pCanvas canvas de salida (se copia su configuracion)
+ * @param[in] pMask mascara de salida (se copia su configuracion)
+ * @return false si falta algun tile
+ */
+bool CacheRenderer::AssembleViewport(const TileRange &Range, const Canvas *pCanvas,
+                                     const Mask *pMask) {
+   wxMutexLocker lock(tileMutex_);
+   if (tiles_.empty()) {
+      return false;
+   }
+   int col1 = Range.col_ + Range.width_, row1 = Range.row_ + Range.height_;
+   cache_.pCanvas_->InitializeAs(pCanvas);
+   cache_.pCanvas_->SetDataType(tileDataType_);
+   cache_.pCanvas_->SetBandCount(tileBandCount_);
+   cache_.pCanvas_->SetSize(Range.width_, Range.height_);
+   int datasize = cache_.pCanvas_->GetDataSize();
+   size_t viewsize = static_cast<size_t>(Range.width_) * Range.height_;
+   TileBuffers data(tileBandCount_, std::vector<unsigned char>(viewsize * datasize));
+   TileBuffers maskdata;
+   int maskdatasize = 0;
+   if (pMask) {
+      if (!cache_.pMask_) {
+         cache_.pMask_ = new Mask;
+      }
+      cache_.pMask_->InitializeAs(pMask);
+      cache_.pMask_->SetSize(Range.width_, Range.height_);
+      maskdatasize = cache_.pMask_->GetDataSize();
+      maskdata.assign(cache_.pMask_->GetBandCount(),
+                      std::vector<unsigned char>(viewsize * maskdatasize));
+   }
+   int tilex0 = FloorDiv(Range.col_, CACHE_TILE_SIZE), tilex1 = FloorDiv(col1 - 1,
+                                                                          CACHE_TILE_SIZE);
+   int tiley0 = FloorDiv(Range.row_, CACHE_TILE_SIZE), tiley1 = FloorDiv(row1 - 1,
+                                                                         CACHE_TILE_SIZE);
+   for (int ty = tiley0; ty <= tiley1; ++ty) {
+      for (int tx = tilex0; tx <= tilex1; ++tx) {
+         Tile *ptile = FindTile(TileKey(Range.level_, tx, ty));
+         if (!ptile) {
+            return false;
+         }
+         int tcol0 = tx * CACHE_TILE_SIZE, trow0 = ty * CACHE_TILE_SIZE;
+         int ccol0 = std::max(tcol0, Range.col_), crow0 = std::max(trow0, Range.row_);
+         int ccol1 = std::min(tcol0 + CACHE_TILE_SIZE, col1);
+         int crow1 = std::min(trow0 + CACHE_TILE_SIZE, row1);
+         for (size_t b = 0; b < data.size() && b < ptile->bands_.size(); ++b) {
+            CopyRegion(&ptile->bands_[b][0], tcol0, trow0, CACHE_TILE_SIZE, &data[b][0],
+                       Range.col_, Range.row_, Range.width_, ccol0, crow0, ccol1, crow1,
+                       datasize);
+         }
+         for (size_t b = 0; b < maskdata.size() && b < ptile->mask_.size(); ++b) {
+            CopyRegion(&ptile->mask_[b][0], tcol0, trow0, CACHE_TILE_SIZE,
+                       &maskdata[b][0], Range.col_, Range.row_, Range.width_, ccol0, crow0,
+                       ccol1, crow1, maskdatasize);
+         }
+      }
+   }
+   WriteCanvas(data, cache_.pCanvas_);
+   if (!maskdata.empty()) {
+      WriteCanvas(maskdata, cache_.pMask_);
+   }
+   return true;
+}
+
+/**
+ * \pre Se debe tener tomado tileMutex_.
+ * @param[in] Key clave del tile
+ * @return tile o NULL si no esta en el cache
+ */
+CacheRenderer::Tile *CacheRenderer::FindTile(const TileKey &Key) {
+   TileMapType::iterator it = tileIndex_.find(Key);
+   if (it == tileIndex_.end()) {
+      return NULL;
+   }
+   // lo pasa al principio de la lista (usado mas recientemente)
+   tiles_.splice(tiles_.begin(), tiles_, it->second);
+   tiles_.front().lastUse_ = ++tileClock_;
+   return &tiles_.front();
+}
+
+/**
+ * @return true si el renderizador tiene tiles (otros renderizadores pueden
+ *         haberlos eliminado)
+ */
+bool CacheRenderer::HasTiles() const {
+   wxMutexLocker lock(tileMutex_);
+   return !tiles_.empty();
+}
+
+/**
+ *  Elimina el tile usado hace mas tiempo entre todos los renderizadores hasta
+ * que la memoria total respete el presupuesto.
+ * \pre Se debe tener tomado tileMutex_.
+ */
+void CacheRenderer::EvictTiles() {
+   while (totalTileBytes_ > tileBudget_) {
+      CacheRenderer *poldest = NULL;
+      std::list<CacheRenderer*>::iterator it = tileRenderers_.begin();
+      for (; it != tileRenderers_.end(); ++it) {
+         if (!(*it)->tiles_.empty() && (!poldest
+               || (*it)->tiles_.back().lastUse_ < poldest->tiles_.back().lastUse_)) {
+            poldest = *it;
+         }
+      }
+      if (!poldest) {
+         return;
+      }
+      size_t bytes = poldest->GetTileBytes(poldest->tiles_.back());
+      poldest->tileBytes_ -= bytes;
+      totalTileBytes_ -= bytes;
+      poldest->tileIndex_.erase(poldest->tiles_.back().key_);
+      poldest->tiles_.pop_back();
+   }
+}
+
+/** Elimina todos los tiles y niveles de zoom */
+void CacheRenderer::ClearTiles() {
+   wxMutexLocker lock(tileMutex_);
+   tiles_.clear();
+   tileIndex_.clear();
+   tileLevels_.clear();
+   totalTileBytes_ -= tileBytes_;
+   tileBytes_ = 0;
+}
+
+/**
+ * @param[in] TileData tile
+ * @return memoria que ocupan los datos del tile en bytes
+ */
+size_t CacheRenderer::GetTileBytes(const Tile &TileData) const {
+   size_t bytes = 0;
+   for (size_t b = 0; b < TileData.bands_.size(); ++b)
+      bytes += TileData.bands_[b].size();
+   for (size_t b = 0; b < TileData.mask_.size(); ++b)
+      bytes += TileData.mask_[b].size();
+   return bytes;
+}
+
 /** Obtiene el "bounding box" del elemento renderizado */
 /**
  * \pre el subset debe ser seteado antes de llamar a esta funcion con un
@@ -30,11 +30,16 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes standard
 #include <map>
+#include <list>
+#include <vector>
+#include <string>
 // Includes Suri
 #include "suri/Renderer.h"
 #include "suri/Subset.h"
 // Includes Wx
 // Defines
+// forwards
+class wxMutex;
 
 namespace suri {
 // forwards
@@ -58,6 +63,61 @@ class CacheRenderer : public Renderer {
       Mask *pMask_; /*! Mascara de la renderizacion */
       Subset renderedWindow_; /*! Ultima ventana donde se renderizo el canvas */
    };
+   /** Datos de un tile (bandas y mascara) */
+   typedef std::vector<std::vector<unsigned char> > TileBuffers;
+   /** Clave de un tile: nivel de zoom e indice en la grilla de tiles */
+   struct TileKey {
+      /** Ctor */
+      TileKey(int Level, int TileX, int TileY) :
+            level_(Level), tileX_(TileX), tileY_(TileY) {
+      }
+      /** Orden para el mapa */
+      bool operator<(const TileKey &Other) const {
+         if (level_ != Other.level_)
+            return level_ < Other.level_;
+         if (tileY_ != Other.tileY_)
+            return tileY_ < Other.tileY_;
+         return tileX_ < Other.tileX_;
+      }
+      int level_; /*! nivel de zoom */
+      int tileX_; /*! columna del tile */
+      int tileY_; /*! fila del tile */
+   };
+   /** Tile renderizado. Solo la region valida tiene datos renderizados. */
+   struct Tile {
+      /** Ctor */
+      explicit Tile(const TileKey &Key) :
+            key_(Key), validCol0_(0), validRow0_(0), validCol1_(0), validRow1_(0),
+            lastUse_(0) {
+      }
+      TileKey key_; /*! clave del tile */
+      int validCol0_; /*! primer columna global valida */
+      int validRow0_; /*! primer fila global valida */
+      int validCol1_; /*! columna global siguiente a la ultima valida */
+      int validRow1_; /*! fila global siguiente a la ultima valida */
+      unsigned long lastUse_; /*! momento del ultimo uso (entre todos los tiles) */
+      TileBuffers bands_; /*! datos de las bandas */
+      TileBuffers mask_; /*! datos de la mascara (vacio si no hay) */
+   };
+   /** Nivel de zoom: tamanio de pixel y fase de la grilla de pixeles */
+   struct TileLevel {
+      double pixelSizeX_; /*! tamanio del pixel en x (unidades de mundo) */
+      double pixelSizeY_; /*! tamanio del pixel en y (unidades de mundo) */
+      double phaseX_; /*! desplazamiento de la grilla en x (en pixeles) */
+      double phaseY_; /*! desplazamiento de la grilla en y (en pixeles) */
+   };
+   /** Region de la grilla global que ocupa el viewport */
+   struct TileRange {
+      int level_; /*! nivel de zoom */
+      int col_; /*! columna global del pixel 0 del viewport */
+      int row_; /*! fila global del pixel 0 del viewport */
+      int width_; /*! ancho del viewport */
+      int height_; /*! alto del viewport */
+   };
+   /** Lista de tiles ordenada por uso (el primero es el mas reciente) */
+   typedef std::list<Tile> TileListType;
+   /** Indice de tiles */
+   typedef std::map<TileKey, TileListType::iterator> TileMapType;
 public:
    /** tipo donde guardo los caches de los elementos */
    typedef std::multimap<Element*, MemoryCanvas*> CachedElementsMap;
@@ -98,8 +158,46 @@ public:
    virtual bool IsDirty();
 protected:
 private:
+   /** Renderiza la ventana completa a traves del anterior (sin tiles) */
+   bool RenderWindow(const World *pWorldWindow, Canvas* pCanvas, Mask* pMask);
+   /** Copia el cache (canvas y mascara) a la salida */
+   void WriteCache(Canvas* pCanvas, Mask* pMask);
+   /** Calcula el nivel de zoom y la region de la grilla del viewport */
+   bool GetTileRange(const World *pWorldWindow, TileRange &Range);
+   /** Renderiza las regiones del viewport que no estan en los tiles */
+   bool RenderMissingTiles(const World *pWorldWindow, const TileRange &Range,
+                           const Canvas *pCanvas, const Mask *pMask);
+   /** Renderiza una region de la grilla y la guarda en los tiles */
+   bool RenderRegion(const World *pWorldWindow, const TileRange &Range, int Col0,
+                     int Row0, int Col1, int Row1, const Canvas *pCanvas,
+                     const Mask *pMask);
+   /** Arma el canvas (y mascara) cacheado del viewport a partir de los tiles */
+   bool AssembleViewport(const TileRange &Range, const Canvas *pCanvas,
+                         const Mask *pMask);
+   /** Busca un tile y lo marca como usado */
+   Tile *FindTile(const TileKey &Key);
+   /** Indica si el renderizador tiene tiles */
+   bool HasTiles() const;
+   /** Elimina tiles de todos los renderizadores hasta respetar el presupuesto */
+   static void EvictTiles();
+   /** Elimina todos los tiles y niveles */
+   void ClearTiles();
+   /** Tamanio en bytes de un tile */
+   size_t GetTileBytes(const Tile &TileData) const;
+
    CanvasCache cache_; /*! Elemento cacheado */
+   std::vector<TileLevel> tileLevels_; /*! niveles de zoom con tiles */
+   TileListType tiles_; /*! tiles ordenados por uso */
+   TileMapType tileIndex_; /*! indice de tiles */
+   size_t tileBytes_; /*! memoria ocupada por los tiles */
+   std::string tileDataType_; /*! tipo de dato de los tiles */
+   int tileBandCount_; /*! cantidad de bandas de los tiles */
    static CachedElementsMap cachedElements_; /*! Mapeo el elemento con sus caches */
+   static std::list<CacheRenderer*> tileRenderers_; /*! renderizadores con tiles */
+   static size_t totalTileBytes_; /*! memoria de los tiles de todos los renderizadores */
+   static size_t tileBudget_; /*! presupuesto de memoria compartido por los tiles */
+   static unsigned long tileClock_; /*! contador de usos de tiles */
+   static wxMutex tileMutex_; /*! protege los tiles (se eliminan desde otros renderizadores) */
 };
 }  // namespace suri
 
@@ -227,6 +227,26 @@ void Canvas::Write(const Canvas *pSource, const Mask *pMask) {
    }
 }
 
+/** Presta los buffers internos de las bandas para leer/escribir in-place */
+/**
+ *  Por defecto el canvas no presta sus buffers.
+ * @param[in] BandIndex indice de bandas solicitadas
+ * @param[out] Buffers punteros a los buffers de cada banda (vacio)
+ * @return false
+ */
+bool Canvas::GetBandBuffers(std::vector<int> &BandIndex, std::vector<void*> &Buffers) {
+   Buffers.clear();
+   return false;
+}
+
+/** Devuelve los buffers prestados por GetBandBuffers */
+/**
+ * @param[in] BandIndex indice de bandas prestadas
+ * @param[in] Modified indica si se escribio en los buffers
+ */
+void Canvas::ReleaseBandBuffers(std::vector<int> &BandIndex, bool Modified) {
+}
+
 // ----------------------------- VECTORIAL -----------------------------
 /** Canvas vectorial */
 /**
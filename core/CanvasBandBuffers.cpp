@@ -0,0 +1,114 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#include "CanvasBandBuffers.h"
+
+// Includes estandar
+
+// Includes Suri
+#include "suri/Canvas.h"
+
+// Includes Wx
+
+// Includes App
+
+// Defines
+
+/** namespace suri */
+namespace suri {
+
+/**
+ * @param[in] pCanvas canvas del que se obtienen los datos
+ * @param[in] BandIndex indice de bandas
+ * @param[in] LoadData indica si los buffers temporales (si el canvas no
+ *            presta los suyos) se deben cargar con los datos del canvas
+ */
+CanvasBandBuffers::CanvasBandBuffers(Canvas *pCanvas, const std::vector<int> &BandIndex,
+                                     bool LoadData) :
+      pCanvas_(pCanvas), bandIndex_(BandIndex), inPlace_(false), modified_(false) {
+   inPlace_ = pCanvas_->GetBandBuffers(bandIndex_, data_);
+   if (!inPlace_) {
+      size_t size = static_cast<size_t>(pCanvas_->GetSizeX()) * pCanvas_->GetSizeY()
+            * pCanvas_->GetDataSize();
+      data_.resize(bandIndex_.size());
+      for (size_t i = 0; i < data_.size(); i++)
+         data_[i] = new unsigned char[size];
+      if (LoadData) {
+         pCanvas_->Read(bandIndex_, data_);
+      }
+   }
+}
+
+/** Dtor */
+CanvasBandBuffers::~CanvasBandBuffers() {
+   Release();
+}
+
+/**
+ * @return buffers de cada banda (SizeX*SizeY*DataSize bytes cada uno)
+ */
+std::vector<void*> &CanvasBandBuffers::GetData() {
+   return data_;
+}
+
+/**
+ * @return true si los buffers son los del canvas
+ */
+bool CanvasBandBuffers::IsInPlace() const {
+   return inPlace_;
+}
+
+/**
+ *  Si los buffers son los del canvas solo registra que se modificaron, para
+ * que Release los devuelva marcados como escritos.
+ */
+void CanvasBandBuffers::Commit() {
+   if (data_.empty()) {
+      return;
+   }
+   if (inPlace_) {
+      modified_ = true;
+   } else {
+      pCanvas_->Write(bandIndex_, data_);
+   }
+}
+
+/** Devuelve los buffers al canvas o libera la copia */
+void CanvasBandBuffers::Release() {
+   if (data_.empty()) {
+      return;
+   }
+   if (inPlace_) {
+      pCanvas_->ReleaseBandBuffers(bandIndex_, modified_);
+   } else {
+      for (size_t i = 0; i < data_.size(); i++)
+         delete[] static_cast<unsigned char*>(data_[i]);
+   }
+   data_.clear();
+}
+
+}  // namespace suri
@@ -0,0 +1,86 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef CANVASBANDBUFFERS_H_
+#define CANVASBANDBUFFERS_H_
+
+// Includes estandar
+#include <vector>
+
+// Includes Suri
+
+// Includes Wx
+
+// Includes App
+
+// Defines
+
+/** namespace suri */
+namespace suri {
+
+class Canvas;
+
+/** Acceso a los datos de bandas de un canvas sin copias si es posible */
+/**
+ *  Si el canvas presta sus buffers internos (Canvas::GetBandBuffers) se
+ * trabaja directamente sobre ellos; sino se reservan buffers temporales, se
+ * cargan con Read y Commit los escribe con Write. En ambos casos se debe
+ * llamar a Commit si se modificaron los datos.
+ *  Los buffers se devuelven (o liberan) en Release o en el destructor.
+ * \attention Se debe llamar a Release antes de modificar el tamanio, tipo de
+ *            dato o cantidad de bandas del canvas.
+ */
+class CanvasBandBuffers {
+   /** Ctor. de Copia. */
+   CanvasBandBuffers(const CanvasBandBuffers &CanvasBandBuffers);
+
+public:
+   /** Ctor */
+   CanvasBandBuffers(Canvas *pCanvas, const std::vector<int> &BandIndex,
+                     bool LoadData = true);
+   /** Dtor */
+   ~CanvasBandBuffers();
+   /** Retorna los buffers de cada banda */
+   std::vector<void*> &GetData();
+   /** Indica si los buffers son los del canvas */
+   bool IsInPlace() const;
+   /** Escribe los datos en el canvas (o los marca escritos si son los suyos) */
+   void Commit();
+   /** Devuelve los buffers al canvas o libera la copia */
+   void Release();
+
+private:
+   Canvas *pCanvas_; /*! Canvas de los datos */
+   std::vector<int> bandIndex_; /*! Indice de bandas */
+   std::vector<void*> data_; /*! Buffers de cada banda */
+   bool inPlace_; /*! Indica si los buffers son los del canvas */
+   bool modified_; /*! Indica si se escribio en los buffers del canvas */
+};
+
+}  // namespace suri
+
+#endif /* CANVASBANDBUFFERS_H_ */
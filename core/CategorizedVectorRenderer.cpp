@@ -138,6 +138,7 @@ void CategorizedVectorRenderer::Update(Element *pElement) {
    CategorizedParameters::LayerStyleMap::iterator it = params_.categorizedlayerstyle_.begin();
    for (int i = 0; it != params_.categorizedlayerstyle_.end(); ++it, ++i)
       parameters_.layerstyle_.insert(std::pair<int, std::string>(i, (*it)[i].second));
+   ClearProjectedCaches();
 }
 
 /** creador + inicializador */
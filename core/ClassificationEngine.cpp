@@ -0,0 +1,228 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#include "ClassificationEngine.h"
+
+// Includes estandar
+#include <algorithm>
+#include <map>
+
+// Includes Suri
+#include "ClassificationAlgorithmInterface.h"
+#include "suri/DataTypes.h"
+#include "suri/Configuration.h"
+
+// Includes Wx
+#include "wx/thread.h"
+
+// Includes App
+
+// Defines
+/** Cantidad de pixeles de un tile */
+#define CLASSIFICATION_TILE_PIXELS 1024
+/** Cantidad minima de pixeles para repartir un bloque entre hilos */
+#define MIN_PIXELS_PER_THREAD 16384
+
+/** namespace suri */
+namespace suri {
+
+/**
+ * Convierte una porcion de una banda a double
+ * @param[in] pSource datos de la banda
+ * @param[in] Begin primer pixel
+ * @param[in] Count cantidad de pixeles
+ * @param[out] pDest valores convertidos
+ */
+template<typename T>
+void classificationtileloader(const void* pSource, size_t Begin, size_t Count,
+                              double* pDest) {
+   const T* psrc = static_cast<const T*>(pSource) + Begin;
+   for (size_t p = 0; p < Count; ++p)
+      pDest[p] = static_cast<double>(psrc[p]);
+}
+/** Inicializa mapa de tipos de datos. */
+INITIALIZE_DATATYPE_MAP(ClassificationEngine::TileLoaderFunctionType,
+                        classificationtileloader);
+
+/** Hilo que clasifica un rango de pixeles para ClassificationEngine */
+class ClassificationWorker : public wxThread {
+public:
+   /** Ctor */
+   ClassificationWorker(const ClassificationKernel &Kernel, int* pDest,
+                        const std::vector<void*> &Source, size_t Begin, size_t End,
+                        ClassificationEngine::TileLoaderFunctionType Loader,
+                        bool NdvAvailable, int NdvPixelValue) :
+         wxThread(wxTHREAD_JOINABLE), kernel_(Kernel), pDest_(pDest), source_(Source),
+         begin_(Begin), end_(End), loader_(Loader), ndvAvailable_(NdvAvailable),
+         ndvPixelValue_(NdvPixelValue) {
+   }
+
+   /** Procesa el rango */
+   void Process() {
+      ClassificationEngine::ClassifyRange(kernel_, pDest_, source_, begin_, end_, loader_,
+                                          ndvAvailable_, ndvPixelValue_);
+   }
+
+protected:
+   /** Punto de entrada del hilo */
+   virtual ExitCode Entry() {
+      Process();
+      return 0;
+   }
+
+private:
+   const ClassificationKernel &kernel_; /*! nucleo del algoritmo */
+   int* pDest_; /*! destino de la clasificacion */
+   const std::vector<void*> &source_; /*! bandas de entrada */
+   size_t begin_; /*! primer pixel del rango */
+   size_t end_; /*! fin del rango */
+   ClassificationEngine::TileLoaderFunctionType loader_; /*! conversor del tipo de dato */
+   bool ndvAvailable_; /*! indica si se descartan los pixeles no validos */
+   int ndvPixelValue_; /*! valor de salida de los pixeles no validos */
+};
+
+/**
+ * @param[in] ThreadCount cantidad de hilos. Si es 0 se usa
+ * lib_classification_thread_count o, si no esta configurado, la cantidad de CPUs.
+ */
+ClassificationEngine::ClassificationEngine(int ThreadCount) : threadCount_(ThreadCount) {
+   if (threadCount_ <= 0)
+      threadCount_ = Configuration::GetParameter("lib_classification_thread_count",
+                                                 static_cast<long>(threadCount_));
+   if (threadCount_ <= 0)
+      threadCount_ = std::max(1, wxThread::GetCPUCount());
+}
+
+/** Dtor */
+ClassificationEngine::~ClassificationEngine() {
+}
+
+/**
+ * Clasifica un bloque repartiendo rangos de tiles entre los hilos.
+ * @param[in] Kernel nucleo del algoritmo
+ * @param[out] pDest clase asignada a cada pixel
+ * @param[in] Source bandas de entrada
+ * @param[in] Size cantidad de pixeles del bloque
+ * @param[in] DataType tipo de dato de las bandas
+ * @param[in] NdvAvailable indica si se descartan los pixeles no validos
+ * @param[in] NdvPixelValue valor de salida de los pixeles no validos
+ * @return false si el tipo de dato no es soportado, faltan bandas o el nucleo
+ * no usa bandas (ej. sin clases)
+ */
+bool ClassificationEngine::Classify(const ClassificationKernel &Kernel, int* pDest,
+                                    const std::vector<void*> &Source, size_t Size,
+                                    const std::string &DataType, bool NdvAvailable,
+                                    int NdvPixelValue) const {
+   std::map<std::string, TileLoaderFunctionType>::const_iterator it =
+         classificationtileloaderTypeMap.find(DataType);
+   if (it == classificationtileloaderTypeMap.end() || Kernel.GetBandCount() < 1
+         || static_cast<size_t>(Kernel.GetBandCount()) > Source.size())
+      return false;
+
+   // Los rangos son multiplos del tile para que la division no dependa de los hilos
+   size_t tiles = (Size + CLASSIFICATION_TILE_PIXELS - 1) / CLASSIFICATION_TILE_PIXELS;
+   size_t threads = std::max<size_t>(1, std::min<size_t>(
+         threadCount_, Size / MIN_PIXELS_PER_THREAD));
+   size_t chunk = ((tiles + threads - 1) / threads) * CLASSIFICATION_TILE_PIXELS;
+
+   std::vector<ClassificationWorker*> workers;
+   for (size_t i = 0; i < threads; ++i) {
+      size_t begin = std::min(Size, i * chunk);
+      size_t end = std::min(Size, begin + chunk);
+      ClassificationWorker *pworker = new ClassificationWorker(
+            Kernel, pDest, Source, begin, end, it->second, NdvAvailable, NdvPixelValue);
+      if (i + 1 < threads && pworker->Create() == wxTHREAD_NO_ERROR
+            && pworker->Run() == wxTHREAD_NO_ERROR) {
+         workers.push_back(pworker);
+      } else {
+         pworker->Process();
+         delete pworker;
+      }
+   }
+   for (size_t i = 0; i < workers.size(); ++i) {
+      workers[i]->Wait();
+      delete workers[i];
+   }
+   return true;
+}
+
+/**
+ * Convierte cada tile del rango, detecta los pixeles no validos y aplica el
+ * nucleo. Los tiles sin pixeles validos no se clasifican.
+ * @param[in] Kernel nucleo del algoritmo
+ * @param[out] pDest clase asignada a cada pixel
+ * @param[in] Source bandas de entrada
+ * @param[in] Begin primer pixel del rango
+ * @param[in] End fin del rango
+ * @param[in] Loader conversor del tipo de dato
+ * @param[in] NdvAvailable indica si se descartan los pixeles no validos
+ * @param[in] NdvPixelValue valor de salida de los pixeles no validos
+ */
+void ClassificationEngine::ClassifyRange(const ClassificationKernel &Kernel, int* pDest,
+                                         const std::vector<void*> &Source, size_t Begin,
+                                         size_t End, TileLoaderFunctionType Loader,
+                                         bool NdvAvailable, int NdvPixelValue) {
+   int bandcount = Kernel.GetBandCount();
+   if (bandcount < 1)
+      return;
+   std::vector<double> tile(bandcount * CLASSIFICATION_TILE_PIXELS);
+   std::vector<double> workspace(
+         std::max(1, Kernel.GetWorkspaceSize()) * CLASSIFICATION_TILE_PIXELS);
+   std::vector<unsigned char> valid(CLASSIFICATION_TILE_PIXELS);
+
+   for (size_t start = Begin; start < End; start += CLASSIFICATION_TILE_PIXELS) {
+      size_t count = std::min<size_t>(CLASSIFICATION_TILE_PIXELS, End - start);
+      for (int b = 0; b < bandcount; ++b)
+         Loader(Source[b], start, count, &tile[b * count]);
+
+      // Un pixel es no valido si vale CLASSIFICATION_NDV en todas las bandas.
+      // Ver TCK #7325
+      bool anyvalid = !NdvAvailable;
+      if (NdvAvailable) {
+         for (size_t p = 0; p < count; ++p)
+            valid[p] = 0;
+         for (int b = 0; b < bandcount; ++b) {
+            const double* pband = &tile[b * count];
+            for (size_t p = 0; p < count; ++p)
+               valid[p] |= (pband[p] != CLASSIFICATION_NDV);
+         }
+         for (size_t p = 0; p < count && !anyvalid; ++p)
+            anyvalid = valid[p] != 0;
+      }
+
+      int* pdest = pDest + start;
+      if (anyvalid)
+         Kernel.ClassifyTile(&tile[0], count, &workspace[0], pdest);
+      if (NdvAvailable) {
+         for (size_t p = 0; p < count; ++p)
+            if (!valid[p])
+               pdest[p] = NdvPixelValue;
+      }
+   }
+}
+
+}  // namespace suri
@@ -0,0 +1,110 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef CLASSIFICATIONENGINE_H_
+#define CLASSIFICATIONENGINE_H_
+
+// Includes estandar
+#include <vector>
+#include <string>
+#include <cstddef>
+
+// Includes Suri
+
+// Includes Wx
+
+// Includes App
+
+// Defines
+
+/** namespace suri */
+namespace suri {
+
+/** Nucleo de un algoritmo de clasificacion que procesa tiles de pixeles */
+/**
+ *  Los algoritmos precalculan sus parametros por clase (factores LU, limites,
+ * normas de las firmas) al crear el nucleo y ClassifyTile solo evalua
+ * distancias. El tile esta intercalado por linea: los valores de la banda b
+ * estan en pTile[b * Count + p], asi los lazos sobre pixeles son contiguos y
+ * vectorizables.
+ */
+class ClassificationKernel {
+public:
+   /** Dtor */
+   virtual ~ClassificationKernel() {}
+   /** Cantidad de bandas de la fuente que usa el nucleo */
+   virtual int GetBandCount() const=0;
+   /** Cantidad de doubles auxiliares por pixel que necesita ClassifyTile */
+   virtual int GetWorkspaceSize() const=0;
+   /**
+    * Clasifica todos los pixeles del tile.
+    * @param[in] pTile valores del tile (pTile[b * Count + p])
+    * @param[in] Count cantidad de pixeles del tile
+    * @param[in] pWorkspace GetWorkspaceSize() * Count doubles auxiliares
+    * @param[out] pDest clase asignada a cada pixel
+    */
+   virtual void ClassifyTile(const double* pTile, size_t Count, double* pWorkspace,
+                             int* pDest) const=0;
+};
+
+/** Motor que ejecuta un ClassificationKernel sobre un bloque de datos */
+/**
+ *  Divide el bloque en tiles, convierte cada tile a double (sin perdida para
+ * los tipos soportados) y marca como no validos los pixeles que valen
+ * CLASSIFICATION_NDV en todas las bandas. Los tiles se reparten entre hilos.
+ */
+class ClassificationEngine {
+   /** Ctor. de Copia. */
+   ClassificationEngine(const ClassificationEngine &ClassificationEngine);
+
+public:
+   /** Ctor */
+   explicit ClassificationEngine(int ThreadCount = 0);
+   /** Dtor */
+   ~ClassificationEngine();
+   /** Clasifica un bloque con el nucleo */
+   bool Classify(const ClassificationKernel &Kernel, int* pDest,
+                 const std::vector<void*> &Source, size_t Size,
+                 const std::string &DataType, bool NdvAvailable, int NdvPixelValue) const;
+
+   /** Funcion que convierte una porcion de banda a double */
+   typedef void (*TileLoaderFunctionType)(const void*, size_t, size_t, double*);
+
+private:
+   friend class ClassificationWorker;
+   /** Clasifica los tiles del rango [Begin, End) */
+   static void ClassifyRange(const ClassificationKernel &Kernel, int* pDest,
+                             const std::vector<void*> &Source, size_t Begin, size_t End,
+                             TileLoaderFunctionType Loader, bool NdvAvailable,
+                             int NdvPixelValue);
+
+   int threadCount_; /*! cantidad de hilos */
+};
+
+}  // namespace suri
+
+#endif /* CLASSIFICATIONENGINE_H_ */
@@ -50,18 +50,244 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 /** Macro para registrar Renderers en forma automatica */
 AUTO_REGISTER_RENDERER(suri::ConvolutionFilterRenderer);
 
+/** Tolerancia relativa para considerar que un filtro es separable */
+#define SEPARABLE_FILTER_TOLERANCE 0.000000001
+
 /** namespace suri */
 namespace suri {
 
+/** Forma del filtro, determina el algoritmo con que se aplica */
+enum FilterShapeType {
+   GeneralFilter, /*! filtro sin estructura, se aplica fila a fila */
+   SeparableFilter, /*! filtro de rango 1, se aplica con dos pasadas 1D */
+   BoxFilter /*! todos los coeficientes iguales (filtro de media) */
+};
+
+/**
+ * Determina la forma del filtro. Un filtro es separable si es de rango 1, es
+ * decir si Filter[k][m] == Column[k] * Row[m] con tolerancia relativa
+ * SEPARABLE_FILTER_TOLERANCE respecto del mayor coeficiente.
+ * @param[in] Filter matriz del filtro
+ * @param[in] FilterWidth ancho del filtro
+ * @param[in] FilterHeight alto del filtro
+ * @param[out] Row filtro horizontal si el filtro es separable
+ * @param[out] Column filtro vertical si el filtro es separable
+ * @return forma del filtro
+ */
+FilterShapeType GetFilterShape(const std::vector<std::vector<double> > &Filter,
+                               int FilterWidth, int FilterHeight, std::vector<double> &Row,
+                               std::vector<double> &Column) {
+   // Busco el coeficiente de mayor modulo y verifico si son todos iguales
+   bool box = true;
+   int pivotrow = 0, pivotcolumn = 0;
+   for (int k = 0; k < FilterHeight; ++k)
+      for (int m = 0; m < FilterWidth; ++m) {
+         box = box && Filter[k][m] == Filter[0][0];
+         if (std::abs(Filter[k][m]) > std::abs(Filter[pivotrow][pivotcolumn])) {
+            pivotrow = k;
+            pivotcolumn = m;
+         }
+      }
+
+   double pivot = Filter[pivotrow][pivotcolumn];
+   Row.assign(Filter[pivotrow].begin(), Filter[pivotrow].begin() + FilterWidth);
+   Column.assign(FilterHeight, 0);
+   if (pivot == 0)
+      return box ? BoxFilter : SeparableFilter;
+   for (int k = 0; k < FilterHeight; ++k)
+      Column[k] = Filter[k][pivotcolumn] / pivot;
+   if (box)
+      return BoxFilter;
+
+   double tolerance = std::abs(pivot) * SEPARABLE_FILTER_TOLERANCE;
+   for (int k = 0; k < FilterHeight; ++k)
+      for (int m = 0; m < FilterWidth; ++m)
+         if (std::abs(Filter[k][m] - Column[k] * Row[m]) > tolerance)
+            return GeneralFilter;
+   return SeparableFilter;
+}
+
+/**
+ * Acumula en pDest la correlacion de una fila con un filtro 1D de ancho fijo.
+ * Con el ancho conocido en compilacion el lazo del filtro se desenrolla y el
+ * lazo sobre pixeles se vectoriza.
+ * @param[in] pSrc fila de entrada (Count + Width - 1 valores)
+ * @param[in] pFilter coeficientes del filtro
+ * @param[in] Count cantidad de pixeles de salida
+ * @param[out] pDest acumuladores de salida
+ */
+template<int Width>
+void correlatefixedrow(const double* pSrc, const double* pFilter, int Count,
+                       double* pDest) {
+   double filter[Width];
+   for (int m = 0; m < Width; ++m)
+      filter[m] = pFilter[m];
+   for (int j = 0; j < Count; ++j) {
+      double output = 0;
+      for (int m = 0; m < Width; ++m)
+         output += pSrc[j + m] * filter[m];
+      pDest[j] += output;
+   }
+}
+
+/**
+ * Acumula en pDest la correlacion de una fila con un filtro 1D. Los anchos
+ * 3, 5 y 7 usan versiones de ancho fijo; el resto recorre el filtro por fuera
+ * para que el lazo interno sea contiguo.
+ * @param[in] pSrc fila de entrada (Count + Width - 1 valores)
+ * @param[in] pFilter coeficientes del filtro
+ * @param[in] Width ancho del filtro
+ * @param[in] Count cantidad de pixeles de salida
+ * @param[out] pDest acumuladores de salida
+ */
+void CorrelateRow(const double* pSrc, const double* pFilter, int Width, int Count,
+                  double* pDest) {
+   switch (Width) {
+      case 3:
+         correlatefixedrow<3>(pSrc, pFilter, Count, pDest);
+         return;
+      case 5:
+         correlatefixedrow<5>(pSrc, pFilter, Count, pDest);
+         return;
+      case 7:
+         correlatefixedrow<7>(pSrc, pFilter, Count, pDest);
+         return;
+      default:
+         break;
+   }
+   for (int m = 0; m < Width; ++m) {
+      double coefficient = pFilter[m];
+      if (coefficient == 0)
+         continue;
+      const double* psrc = pSrc + m;
+      for (int j = 0; j < Count; ++j)
+         pDest[j] += psrc[j] * coefficient;
+   }
+}
+
+/**
+ * Aplica un filtro de coeficientes iguales usando una imagen integral: cada
+ * pixel de salida se obtiene con cuatro accesos sin importar el tamanio del
+ * filtro. Solo es exacto si las sumas entran en la mantisa de un double.
+ * @param[out] pDest imagen filtrada (sin bordes)
+ * @param[in] pImage imagen de entrada
+ * @param[in] Value valor de los coeficientes
+ * @param[in] ImageWidth ancho de la imagen
+ * @param[in] ImageHeight alto de la imagen
+ * @param[in] FilterWidth ancho del filtro
+ * @param[in] FilterHeight alto del filtro
+ */
+void ApplyBoxFilter(FILTER_OUTPUT_DATA_TYPE* pDest, const double* pImage, double Value,
+                    int ImageWidth, int ImageHeight, int FilterWidth,
+                    int FilterHeight) {
+   int integralwidth = ImageWidth + 1;
+   std::vector<double> integral(integralwidth * (ImageHeight + 1), 0);
+   for (int i = 0; i < ImageHeight; ++i) {
+      double rowsum = 0;
+      const double* prow = pImage + i * ImageWidth;
+      const double* pprevious = &integral[i * integralwidth];
+      double* pcurrent = &integral[(i + 1) * integralwidth];
+      for (int j = 0; j < ImageWidth; ++j) {
+         rowsum += prow[j];
+         pcurrent[j + 1] = pprevious[j + 1] + rowsum;
+      }
+   }
+
+   int imageendy = ImageHeight - FilterHeight + 1;
+   int imageendx = ImageWidth - FilterWidth + 1;
+   for (int i = 0; i < imageendy; ++i) {
+      const double* ptop = &integral[i * integralwidth];
+      const double* pbottom = &integral[(i + FilterHeight) * integralwidth];
+      FILTER_OUTPUT_DATA_TYPE* pdest = pDest + i * imageendx;
+      for (int j = 0; j < imageendx; ++j)
+         pdest[j] = static_cast<FILTER_OUTPUT_DATA_TYPE>(
+               Value * (pbottom[j + FilterWidth] - pbottom[j] - ptop[j + FilterWidth]
+                     + ptop[j]));
+   }
+}
+
+/**
+ * Aplica un filtro separable con una pasada horizontal y una vertical. El
+ * costo por pixel es FilterWidth + FilterHeight en lugar de su producto.
+ * @param[out] pDest imagen filtrada (sin bordes)
+ * @param[in] pImage imagen de entrada
+ * @param[in] Row filtro horizontal
+ * @param[in] Column filtro vertical
+ * @param[in] ImageWidth ancho de la imagen
+ * @param[in] ImageHeight alto de la imagen
+ */
+void ApplySeparableFilter(FILTER_OUTPUT_DATA_TYPE* pDest, const double* pImage,
+                          const std::vector<double> &Row,
+                          const std::vector<double> &Column, int ImageWidth,
+                          int ImageHeight) {
+   int filterwidth = Row.size();
+   int filterheight = Column.size();
+   int imageendy = ImageHeight - filterheight + 1;
+   int imageendx = ImageWidth - filterwidth + 1;
+
+   // Pasada horizontal sobre todas las filas
+   std::vector<double> horizontal(ImageHeight * imageendx, 0);
+   for (int i = 0; i < ImageHeight; ++i)
+      CorrelateRow(pImage + i * ImageWidth, &Row[0], filterwidth, imageendx,
+                   &horizontal[i * imageendx]);
+
+   // Pasada vertical
+   std::vector<double> output(imageendx);
+   for (int i = 0; i < imageendy; ++i) {
+      std::fill(output.begin(), output.end(), 0.0);
+      for (int k = 0; k < filterheight; ++k) {
+         double coefficient = Column[k];
+         const double* prow = &horizontal[(i + k) * imageendx];
+         for (int j = 0; j < imageendx; ++j)
+            output[j] += prow[j] * coefficient;
+      }
+      FILTER_OUTPUT_DATA_TYPE* pdest = pDest + i * imageendx;
+      for (int j = 0; j < imageendx; ++j)
+         pdest[j] = static_cast<FILTER_OUTPUT_DATA_TYPE>(output[j]);
+   }
+}
+
+/**
+ * Aplica un filtro sin estructura acumulando, para cada fila de salida, la
+ * correlacion de cada fila del filtro con la fila de entrada correspondiente.
+ * @param[out] pDest imagen filtrada (sin bordes)
+ * @param[in] pImage imagen de entrada
+ * @param[in] Filter matriz del filtro
+ * @param[in] ImageWidth ancho de la imagen
+ * @param[in] ImageHeight alto de la imagen
+ * @param[in] FilterWidth ancho del filtro
+ * @param[in] FilterHeight alto del filtro
+ */
+void ApplyGeneralFilter(FILTER_OUTPUT_DATA_TYPE* pDest, const double* pImage,
+                        const std::vector<std::vector<double> > &Filter,
+                        int ImageWidth, int ImageHeight, int FilterWidth,
+                        int FilterHeight) {
+   int imageendy = ImageHeight - FilterHeight + 1;
+   int imageendx = ImageWidth - FilterWidth + 1;
+   std::vector<double> output(imageendx);
+   for (int i = 0; i < imageendy; ++i) {
+      std::fill(output.begin(), output.end(), 0.0);
+      for (int k = 0; k < FilterHeight; ++k)
+         CorrelateRow(pImage + (i + k) * ImageWidth, &Filter[k][0], FilterWidth,
+                      imageendx, &output[0]);
+      FILTER_OUTPUT_DATA_TYPE* pdest = pDest + i * imageendx;
+      for (int j = 0; j < imageendx; ++j)
+         pdest[j] = static_cast<FILTER_OUTPUT_DATA_TYPE>(output[j]);
+   }
+}
+
 /**
  * Este template se utiliza para aplicar filtro a la imagen.
  * Aplica matriz a cada pixel en pSrc y guarda resultado pDest.
+ * Convierte la imagen a double y elige el algoritmo segun la forma del
+ * filtro: imagen integral para filtros de media sobre enteros de hasta 16
+ * bits, dos pasadas 1D para filtros separables o correlacion fila a fila.
  * \pre pDest debe tener tamanio imagen con pixeles en formato double.
  * \pre pSrc debe tener tamanio Size.
  * \post pDest tiene los datos luego de aplicar filtro.
  * @param[out] pDest puntero a los datos luego de aplicar el filtro.
  * @param[in] pSrc puntero a los datos a filtrar.
- * @param[in] pFilter matriz con doubles del filtro.
+ * @param[in] Filter matriz con doubles del filtro.
  * @param[in] ImageHeight altura de la imagen.
  * @param[in] ImageWidth ancho de la imagen.
  * @param[in] FilterHeight altura del filtro.
@@ -69,18 +295,8 @@ namespace suri {
  */
 template<typename T>
 void kernelfilter(void* pDest, void* pSrc,
-            std::vector<std::vector<double> > pFilter, int ImageWidth, int ImageHeight,
-            int FilterWidth, int FilterHeight) {
-   // Por alguna razon la matriz se estaba rotando. Ahora se aplica tal cual como
-   // fue cargada.
-   double** pmirroredfilter = new double*[FilterHeight];
-   for (int i = 0; i < FilterHeight; ++i) {
-      pmirroredfilter[i] = new double[FilterWidth];
-      for (int j = 0; j < FilterWidth; ++j)
-         pmirroredfilter[i][j] = pFilter[i][j];
-   }
-
-   // Aplico la matriz
+            const std::vector<std::vector<double> > &Filter, int ImageWidth,
+            int ImageHeight, int FilterWidth, int FilterHeight) {
    T* psrc = static_cast<T*>(pSrc);
    FILTER_OUTPUT_DATA_TYPE* pdest = static_cast<FILTER_OUTPUT_DATA_TYPE*>(pDest);
 
@@ -96,141 +312,373 @@ void kernelfilter(void* pDest, void* pSrc,
    */
    int imageendy = ImageHeight - FilterHeight + 1;
    int imageendx = ImageWidth - FilterWidth + 1;
-   int n = 0;
-   for (int i = 0; i < imageendy; i++) {
-      for (int j = 0; j < imageendx; j++) {
-         FILTER_OUTPUT_DATA_TYPE output = 0;
-         for (int k = 0; k < FilterHeight; k++)
-            for (int m = 0; m < FilterWidth; m++)
-               output += psrc[(i + k) * ImageWidth + j + m] *
-                                                   pmirroredfilter[k][m];
-         pdest[n] = output;
-         n++;
-      }
+   if (imageendy <= 0 || imageendx <= 0)
+      return;
+   if (static_cast<int>(Filter.size()) < FilterHeight) {
+      std::fill(pdest, pdest + imageendx * imageendy, 0);
+      return;
    }
 
-   // Elimino matriz temporal
-   for (int i = 0; i < FilterWidth; i++)
-      delete[] pmirroredfilter[i];
-   delete[] pmirroredfilter;
+   // Por alguna razon la matriz se estaba rotando. Ahora se aplica tal cual como
+   // fue cargada.
+   std::vector<double> row, column;
+   FilterShapeType shape = GetFilterShape(Filter, FilterWidth, FilterHeight, row, column);
+   std::vector<double> image(psrc, psrc + ImageWidth * ImageHeight);
+   if (shape == BoxFilter && std::numeric_limits<T>::is_integer && sizeof(T) <= 2)
+      ApplyBoxFilter(pdest, &image[0], Filter[0][0], ImageWidth, ImageHeight,
+                     FilterWidth, FilterHeight);
+   else if (shape != GeneralFilter)
+      ApplySeparableFilter(pdest, &image[0], row, column, ImageWidth, ImageHeight);
+   else
+      ApplyGeneralFilter(pdest, &image[0], Filter, ImageWidth, ImageHeight, FilterWidth,
+                         FilterHeight);
 }
 /** Inicializa mapa de tipos de datos. */
 INITIALIZE_DATATYPE_MAP(ConvolutionFilterRenderer::Parameters::FilterFunctionType,
                                                                      kernelfilter);
 
+/** Estadistico de la ventana que calculan los filtros de histograma */
+enum WindowStatisticType {
+   MajorityStatistic, /*! valor mas frecuente, empates al menor valor */
+   MinorityStatistic, /*! valor menos frecuente, empates al menor valor */
+   MedianStatistic, /*! mediana (inferior si la ventana es par) */
+   ModeStatistic /*! valor mas frecuente, empates al pixel central */
+};
+
+/** Histograma de una ventana con un contador por valor (tipos de 8 y 16 bits) */
 /**
- * Este template se utiliza para aplicar un filtro a la imagen.
- * Busca el maximo dentro del bloque que corresponde a cada pixel
- * \pre pDest debe tener tamanio imagen con pixeles en formato double.
- * \pre pSrc debe tener tamanio Size.
- * \post pDest tiene los datos luego de aplicar filtro.
+ * Ademas de los contadores guarda la lista de valores presentes para que las
+ * consultas recorran solo los valores de la ventana, y la posicion de la
+ * mediana con la cantidad de valores menores para actualizarla en forma
+ * incremental.
+ */
+template<typename T>
+class DenseWindowHistogram {
+public:
+   /** Ctor */
+   DenseWindowHistogram() :
+         counts_(1 << (8 * sizeof(T)), 0), positions_(counts_.size(), 0), total_(0),
+         median_(0), below_(0) {
+   }
+   /** Agrega un valor a la ventana */
+   void Add(T Value) {
+      int bin = GetBin(Value);
+      if (counts_[bin]++ == 0) {
+         positions_[bin] = values_.size();
+         values_.push_back(bin);
+      }
+      ++total_;
+      if (bin < median_)
+         ++below_;
+   }
+   /** Quita un valor de la ventana */
+   void Remove(T Value) {
+      int bin = GetBin(Value);
+      if (--counts_[bin] == 0) {
+         int last = values_.back();
+         values_[positions_[bin]] = last;
+         positions_[last] = positions_[bin];
+         values_.pop_back();
+      }
+      --total_;
+      if (bin < median_)
+         --below_;
+   }
+   /** Vacia la ventana */
+   void Clear() {
+      for (size_t i = 0; i < values_.size(); ++i)
+         counts_[values_[i]] = 0;
+      values_.clear();
+      total_ = median_ = below_ = 0;
+   }
+   /** Cantidad de apariciones de un valor */
+   int GetCount(T Value) const {
+      return counts_[GetBin(Value)];
+   }
+   /** Valor mas (Majority = true) o menos frecuente, los empates van al menor */
+   T GetExtreme(bool Majority) const {
+      int bestbin = values_.front();
+      for (size_t i = 1; i < values_.size(); ++i) {
+         int bin = values_[i];
+         int count = counts_[bin], bestcount = counts_[bestbin];
+         if ((Majority ? count > bestcount : count < bestcount)
+               || (count == bestcount && bin < bestbin))
+            bestbin = bin;
+      }
+      return GetValue(bestbin);
+   }
+   /** Mediana, se desplaza desde la mediana de la ventana anterior */
+   T GetMedian() {
+      int target = (total_ - 1) / 2;
+      while (below_ > target) {
+         --median_;
+         below_ -= counts_[median_];
+      }
+      while (below_ + counts_[median_] <= target) {
+         below_ += counts_[median_];
+         ++median_;
+      }
+      return GetValue(median_);
+   }
+
+private:
+   /** Posicion del valor en el histograma */
+   static int GetBin(T Value) {
+      return static_cast<int>(Value) - static_cast<int>(std::numeric_limits<T>::min());
+   }
+   /** Valor de una posicion del histograma */
+   static T GetValue(int Bin) {
+      return static_cast<T>(Bin + static_cast<int>(std::numeric_limits<T>::min()));
+   }
+
+   std::vector<int> counts_; /*! apariciones de cada valor */
+   std::vector<int> positions_; /*! posicion de cada valor en values_ */
+   std::vector<int> values_; /*! valores presentes en la ventana */
+   int total_; /*! cantidad de pixeles en la ventana */
+   int median_; /*! posicion de la ultima mediana */
+   int below_; /*! cantidad de pixeles menores a median_ */
+};
+
+/** Histograma de una ventana para tipos sin histograma denso (32 bits y reales) */
+template<typename T>
+class MapWindowHistogram {
+public:
+   /** Ctor */
+   MapWindowHistogram() : total_(0) {
+   }
+   /** Agrega un valor a la ventana */
+   void Add(T Value) {
+      ++counts_[Value];
+      ++total_;
+   }
+   /** Quita un valor de la ventana */
+   void Remove(T Value) {
+      typename std::map<T, int>::iterator it = counts_.find(Value);
+      if (--(it->second) == 0)
+         counts_.erase(it);
+      --total_;
+   }
+   /** Vacia la ventana */
+   void Clear() {
+      counts_.clear();
+      total_ = 0;
+   }
+   /** Cantidad de apariciones de un valor */
+   int GetCount(T Value) const {
+      typename std::map<T, int>::const_iterator it = counts_.find(Value);
+      return it != counts_.end() ? it->second : 0;
+   }
+   /** Valor mas (Majority = true) o menos frecuente, los empates van al menor */
+   T GetExtreme(bool Majority) const {
+      typename std::map<T, int>::const_iterator it = counts_.begin();
+      typename std::map<T, int>::const_iterator best = it;
+      for (++it; it != counts_.end(); ++it)
+         if (Majority ? it->second > best->second : it->second < best->second)
+            best = it;
+      return best->first;
+   }
+   /** Mediana */
+   T GetMedian() {
+      int target = (total_ - 1) / 2;
+      int below = 0;
+      typename std::map<T, int>::const_iterator it = counts_.begin();
+      while (below + it->second <= target) {
+         below += it->second;
+         ++it;
+      }
+      return it->first;
+   }
+
+private:
+   std::map<T, int> counts_; /*! apariciones de cada valor */
+   int total_; /*! cantidad de pixeles en la ventana */
+};
+
+/** Elige el histograma de ventana segun el tipo de dato */
+template<typename T>
+struct WindowHistogram {
+   typedef MapWindowHistogram<T> Type; /*! histograma para el tipo */
+};
+/** Histograma denso para unsigned char */
+template<>
+struct WindowHistogram<unsigned char> {
+   typedef DenseWindowHistogram<unsigned char> Type; /*! histograma para el tipo */
+};
+/** Histograma denso para char */
+template<>
+struct WindowHistogram<char> {
+   typedef DenseWindowHistogram<char> Type; /*! histograma para el tipo */
+};
+/** Histograma denso para short */
+template<>
+struct WindowHistogram<short> {
+   typedef DenseWindowHistogram<short> Type; /*! histograma para el tipo */
+};
+/** Histograma denso para unsigned short */
+template<>
+struct WindowHistogram<unsigned short> {
+   typedef DenseWindowHistogram<unsigned short> Type; /*! histograma para el tipo */
+};
+
+/**
+ * Aplica un filtro de histograma de ventana. Para cada fila arma el histograma
+ * de la primera ventana y luego lo desplaza agregando la columna que entra y
+ * quitando la que sale, por lo que cada pixel cuesta O(FilterHeight) en lugar
+ * de O(FilterWidth * FilterHeight).
+ * \pre pDest debe tener tamanio de la imagen sin bordes y tipo T.
  * @param[out] pDest puntero a los datos luego de aplicar el filtro.
  * @param[in] pSrc puntero a los datos a filtrar.
- * @param[in] pFilter matriz con doubles del filtro.
- * @param[in] ImageHeight altura de la imagen.
  * @param[in] ImageWidth ancho de la imagen.
- * @param[in] FilterHeight altura del filtro.
+ * @param[in] ImageHeight altura de la imagen.
  * @param[in] FilterWidth ancho del filtro.
+ * @param[in] FilterHeight altura del filtro.
+ * @param[in] Statistic estadistico que se asigna a cada pixel.
  */
 template<typename T>
-void mayorityfilter(void* pDest, void* pSrc,
-            std::vector<std::vector<double> > pFilter, int ImageWidth, int ImageHeight,
-            int FilterWidth, int FilterHeight) {
+void windowhistogramfilter(void* pDest, void* pSrc, int ImageWidth, int ImageHeight,
+                           int FilterWidth, int FilterHeight,
+                           WindowStatisticType Statistic) {
    T* psrc = static_cast<T*>(pSrc);
    T* pdest = static_cast<T*>(pDest);
+   typename WindowHistogram<T>::Type histogram;
 
-   std::pair<typename std::map<T, int>::iterator, bool> ret;
-   typename std::map<T, int>::iterator it;
-
-   // Calculo minimo y maximo dependiendo del tipo
    int imageendy = ImageHeight - FilterHeight + 1;
    int imageendx = ImageWidth - FilterWidth + 1;
    int n = 0;
    for (int i = 0; i < imageendy; i++) {
+      histogram.Clear();
+      for (int k = 0; k < FilterHeight; k++)
+         for (int m = 0; m < FilterWidth; m++)
+            histogram.Add(psrc[(i + k) * ImageWidth + m]);
+
+      const T* pcenter = psrc + (i + FilterHeight / 2) * ImageWidth + FilterWidth / 2;
       for (int j = 0; j < imageendx; j++) {
-         std::map<T, int> valuecount;
-         for (int k = 0; k < FilterHeight; k++) {
-            for (int m = 0; m < FilterWidth; m++) {
-               ret = valuecount.insert(std::pair<T, int>(
-                                    psrc[(i + k) * ImageWidth + j + m], 1));
-               if (!ret.second)
-                  (ret.first)->second = (ret.first)->second + 1;
-            }
+         T value;
+         switch (Statistic) {
+            case MinorityStatistic:
+               value = histogram.GetExtreme(false);
+               break;
+            case MedianStatistic:
+               value = histogram.GetMedian();
+               break;
+            case ModeStatistic:
+               value = histogram.GetExtreme(true);
+               if (histogram.GetCount(pcenter[j]) == histogram.GetCount(value))
+                  value = pcenter[j];
+               break;
+            default:
+               value = histogram.GetExtreme(true);
+               break;
          }
-         int maxcount = 0;
-         T maxvalue = 0;
-         it = valuecount.begin();
-         for (; it != valuecount.end(); it++)
-            if (it->second > maxcount) {
-               maxcount = it->second;
-               maxvalue = it->first;
-            }
-
-         pdest[n] = maxvalue;
+         pdest[n] = value;
          n++;
+
+         // Desplazo la ventana una columna
+         if (j + 1 < imageendx)
+            for (int k = 0; k < FilterHeight; k++) {
+               const T* prow = psrc + (i + k) * ImageWidth + j;
+               histogram.Remove(prow[0]);
+               histogram.Add(prow[FilterWidth]);
+            }
       }
    }
 }
+
+/**
+ * Este template se utiliza para aplicar un filtro a la imagen.
+ * Asigna a cada pixel el valor mas frecuente dentro del bloque que le
+ * corresponde (los empates se resuelven a favor del menor valor).
+ * \pre pDest debe tener tamanio imagen sin bordes y tipo T.
+ * @param[out] pDest puntero a los datos luego de aplicar el filtro.
+ * @param[in] pSrc puntero a los datos a filtrar.
+ * @param[in] Filter matriz del filtro (no se usa).
+ * @param[in] ImageWidth ancho de la imagen.
+ * @param[in] ImageHeight altura de la imagen.
+ * @param[in] FilterWidth ancho del filtro.
+ * @param[in] FilterHeight altura del filtro.
+ */
+template<typename T>
+void mayorityfilter(void* pDest, void* pSrc,
+            const std::vector<std::vector<double> > &Filter, int ImageWidth, int ImageHeight,
+            int FilterWidth, int FilterHeight) {
+   windowhistogramfilter<T>(pDest, pSrc, ImageWidth, ImageHeight, FilterWidth,
+                            FilterHeight, MajorityStatistic);
+}
 /** Inicializa mapa de tipos de datos. */
 INITIALIZE_DATATYPE_MAP(ConvolutionFilterRenderer::Parameters::FilterFunctionType,
                                                                     mayorityfilter);
 
 /**
  * Este template se utiliza para aplicar un filtro a la imagen.
- * Busca el maximo dentro del bloque que corresponde a cada pixel
- * \pre pDest debe tener tamanio imagen con pixeles en formato double.
- * \pre pSrc debe tener tamanio Size.
- * \post pDest tiene los datos luego de aplicar filtro.
+ * Asigna a cada pixel el valor menos frecuente dentro del bloque que le
+ * corresponde (los empates se resuelven a favor del menor valor).
+ * \pre pDest debe tener tamanio imagen sin bordes y tipo T.
  * @param[out] pDest puntero a los datos luego de aplicar el filtro.
  * @param[in] pSrc puntero a los datos a filtrar.
- * @param[in] pFilter matriz con doubles del filtro.
- * @param[in] ImageHeight altura de la imagen.
+ * @param[in] Filter matriz del filtro (no se usa).
  * @param[in] ImageWidth ancho de la imagen.
- * @param[in] FilterHeight altura del filtro.
+ * @param[in] ImageHeight altura de la imagen.
  * @param[in] FilterWidth ancho del filtro.
+ * @param[in] FilterHeight altura del filtro.
  */
 template<typename T>
 void minorityfilter(void* pDest, void* pSrc,
-            std::vector<std::vector<double> > pFilter, int ImageWidth, int ImageHeight,
+            const std::vector<std::vector<double> > &Filter, int ImageWidth, int ImageHeight,
             int FilterWidth, int FilterHeight) {
-   T* psrc = static_cast<T*>(pSrc);
-   T* pdest = static_cast<T*>(pDest);
-
-   std::pair<typename std::map<T, int>::iterator, bool> ret;
-   typename std::map<T, int>::iterator it;
+   windowhistogramfilter<T>(pDest, pSrc, ImageWidth, ImageHeight, FilterWidth,
+                            FilterHeight, MinorityStatistic);
+}
+/** Inicializa mapa de tipos de datos. */
+INITIALIZE_DATATYPE_MAP(ConvolutionFilterRenderer::Parameters::FilterFunctionType,
+                                                                    minorityfilter);
 
-   // Calculo minimo y maximo dependiendo del tipo
-   int imageendy = ImageHeight - FilterHeight + 1;
-   int imageendx = ImageWidth - FilterWidth + 1;
-   int n = 0;
-   for (int i = 0; i < imageendy; i++) {
-      for (int j = 0; j < imageendx; j++) {
-         std::map<T, int> valuecount;
-         for (int k = 0; k < FilterHeight; k++) {
-            for (int m = 0; m < FilterWidth; m++) {
-               ret = valuecount.insert(std::pair<T, int>(
-                                    psrc[(i + k) * ImageWidth + j + m], 1));
-               if (!ret.second)
-                  (ret.first)->second = (ret.first)->second + 1;
-            }
-         }
-         int mincount = FilterWidth * FilterHeight + 1;
-         T minvalue = 0;
-         it = valuecount.begin();
-         for (; it != valuecount.end(); it++)
-            if (it->second < mincount) {
-               mincount = it->second;
-               minvalue = it->first;
-            }
+/**
+ * Este template se utiliza para aplicar un filtro a la imagen.
+ * Asigna a cada pixel la mediana del bloque que le corresponde.
+ * \pre pDest debe tener tamanio imagen sin bordes y tipo T.
+ * @param[out] pDest puntero a los datos luego de aplicar el filtro.
+ * @param[in] pSrc puntero a los datos a filtrar.
+ * @param[in] Filter matriz del filtro (no se usa).
+ * @param[in] ImageWidth ancho de la imagen.
+ * @param[in] ImageHeight altura de la imagen.
+ * @param[in] FilterWidth ancho del filtro.
+ * @param[in] FilterHeight altura del filtro.
+ */
+template<typename T>
+void medianfilter(void* pDest, void* pSrc,
+            const std::vector<std::vector<double> > &Filter, int ImageWidth, int ImageHeight,
+            int FilterWidth, int FilterHeight) {
+   windowhistogramfilter<T>(pDest, pSrc, ImageWidth, ImageHeight, FilterWidth,
+                            FilterHeight, MedianStatistic);
+}
+/** Inicializa mapa de tipos de datos. */
+INITIALIZE_DATATYPE_MAP(ConvolutionFilterRenderer::Parameters::FilterFunctionType,
+                                                                    medianfilter);
 
-         pdest[n] = minvalue;
-         n++;
-      }
-   }
+/**
+ * Este template se utiliza para aplicar un filtro a la imagen.
+ * Asigna a cada pixel la moda del bloque que le corresponde. A diferencia del
+ * filtro de mayoria, si el pixel central empata con el valor mas frecuente
+ * conserva su valor.
+ * \pre pDest debe tener tamanio imagen sin bordes y tipo T.
+ * @param[out] pDest puntero a los datos luego de aplicar el filtro.
+ * @param[in] pSrc puntero a los datos a filtrar.
+ * @param[in] Filter matriz del filtro (no se usa).
+ * @param[in] ImageWidth ancho de la imagen.
+ * @param[in] ImageHeight altura de la imagen.
+ * @param[in] FilterWidth ancho del filtro.
+ * @param[in] FilterHeight altura del filtro.
+ */
+template<typename T>
+void modefilter(void* pDest, void* pSrc,
+            const std::vector<std::vector<double> > &Filter, int ImageWidth, int ImageHeight,
+            int FilterWidth, int FilterHeight) {
+   windowhistogramfilter<T>(pDest, pSrc, ImageWidth, ImageHeight, FilterWidth,
+                            FilterHeight, ModeStatistic);
 }
 /** Inicializa mapa de tipos de datos. */
 INITIALIZE_DATATYPE_MAP(ConvolutionFilterRenderer::Parameters::FilterFunctionType,
-                                                                    minorityfilter);
+                                                                    modefilter);
 
 /** Ctor */
 ConvolutionFilterRenderer::ConvolutionFilterRenderer() {
@@ -405,6 +853,10 @@ Renderer *ConvolutionFilterRenderer::Create(Element *pElement,
       params.pFunction_ = minorityfilterTypeMap[datatype];
    if (params.filterName_ == ALGORITHM_VALUE_MAYORITYFILTER)
       params.pFunction_ = mayorityfilterTypeMap[datatype];
+   if (params.filterName_ == ALGORITHM_VALUE_MEDIANFILTER)
+      params.pFunction_ = medianfilterTypeMap[datatype];
+   if (params.filterName_ == ALGORITHM_VALUE_MODEFILTER)
+      params.pFunction_ = modefilterTypeMap[datatype];
 
    if (!params.pFunction_) {
       REPORT_ERROR("D:Tipo de filtro o tipo de dato (%s) no manejado",
@@ -592,7 +1044,8 @@ void ConvolutionFilterRenderer::GetOutputParameters(int &SizeX, int &SizeY,
       pPreviousRenderer_->GetOutputParameters(SizeX, SizeY, BandCount, DataType);
    }
 
-   // Los filtros de mayoria y minoria no modifican el tipo de dato de salida
+   // Los filtros de histograma (mayoria, minoria, mediana y moda) no modifican
+   // el tipo de dato de salida
    if (parameters_.filterName_ == ALGORITHM_VALUE_KERNELFILTER)
       DataType = DataInfo<FILTER_OUTPUT_DATA_TYPE>::Name;
 }
@@ -70,7 +70,7 @@ public:
       /** Tipo de dato de la funcion */
       typedef void (*FilterFunctionType)(
             void* pDest, void* pSrc,
-            std::vector<std::vector<double> > pFilterpFilter, int ImageHeight,
+            const std::vector<std::vector<double> > &Filter, int ImageHeight,
             int ImageWidth, int FilterHeight, int FilterWidth);
       std::list<std::vector<std::vector<double> > > filters_; /*! filtros que */
                                                     /* se aplican a la imagen */
@@ -27,6 +27,9 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 #include "DataCastRenderer.h"
 
+// Includes estandar
+#include <cstring>
+
 // Includes suri
 #include "suri/messages.h"
 #include "suri/xmlnames.h"
@@ -39,6 +42,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "suri/Canvas.h"
 #include "suri/Dimension.h"
 #include "MemoryCanvas.h"
+#include "CanvasBandBuffers.h"
 
 /** Macro para registrar Renderers en forma automatica */
 AUTO_REGISTER_RENDERER(suri::DataCastRenderer);
@@ -76,7 +80,8 @@ INITIALIZE_DUAL_DATATYPE_MAP(DataCastRenderer::Parameters::CastFunctionType, dat
 /**
  * Ctor.
  */
-DataCastRenderer::DataCastRenderer() {
+DataCastRenderer::DataCastRenderer() :
+      pPixelFunction_(NULL), pixelDataSize_(0) {
 }
 
 /**
@@ -216,32 +221,7 @@ bool DataCastRenderer::Render(const World *pWorldWindow, Canvas* pCanvas,
       int x, y, b;
       std::string datatype;
       pPreviousRenderer_->GetOutputParameters(x, y, b, datatype);
-      std::vector<int> bands;
-      std::vector<void*> originalData;
-      std::vector<void*> castedData;
-      for (int x = 0; x < pCanvas->GetBandCount(); x++) {
-         bands.push_back(x);
-         unsigned char* data = new unsigned char [pCanvas->GetSizeX() * pCanvas->GetSizeY() *
-                                                  pCanvas->GetDataSize()];
-         originalData.push_back(data);
-      }
-      pCanvas->Read(bands, originalData);
-      pCanvas->SetDataType(datatype);
-      // TODO matiaslafroce: usar un vector y referencias
-      //                     así se borra el delete de abajo
-      for (int x = 0; x < pCanvas->GetBandCount(); x++) {
-         unsigned char* data = new unsigned char [pCanvas->GetSizeX() * pCanvas->GetSizeY() *
-                                                           pCanvas->GetDataSize()];
-         /* datacast<unsigned short, unsigned char>*/
-         parametersToChar_.function_(data, originalData[x], pCanvas->GetSizeX() *
-                                                                            pCanvas->GetSizeY());
-         castedData.push_back(data);
-      }
-      pCanvas->Write(bands, castedData);
-      for (int x = 0; x < pCanvas->GetBandCount(); x++) {
-         delete[] static_cast<unsigned char*>(originalData[x]);
-         delete[] static_cast<unsigned char*>(castedData[x]);
-      }
+      CastToPreviousDataType(pCanvas);
       // no puede cambiar el tipo de canvas
       if (pCanvas->GetDataType() != datatype) {
          ptempcanvas = new MemoryCanvas;
@@ -257,58 +237,167 @@ bool DataCastRenderer::Render(const World *pWorldWindow, Canvas* pCanvas,
          pCanvas->SetSize(x, y);
       }
    }
-   if (!ptempcanvas) {
+   if (!ProcessCanvas(ptempcanvas)) {
+      return false;
+   }
+   if (pCanvas != ptempcanvas) {
+      pCanvas->Write(ptempcanvas, pMask);
+      delete ptempcanvas;
+   }
+   return true && prevrenderizationstatus;
+}
+
+/**
+ *  Pasa el canvas al tipo de dato de salida del anterior (para conservar el
+ * fondo) y renderiza el anterior sobre el.
+ * @param[in] pWorldWindow World con la parte del mundo a renderizar
+ * @param[in] pCanvas Canvas donde se renderiza el anterior
+ * @param[in] pMask mascara de la renderizacion
+ * \pre pCanvas debe poder cambiar su tipo de dato (ver Render)
+ * @return resultado de la renderizacion del anterior
+ */
+bool DataCastRenderer::RenderInput(const World *pWorldWindow, Canvas *pCanvas,
+                                   Mask *pMask) {
+   if (!pPreviousRenderer_ || !pCanvas) {
+      return true;
+   }
+   CastToPreviousDataType(pCanvas);
+   return pPreviousRenderer_->Render(pWorldWindow, pCanvas, pMask);
+}
+
+/**
+ * Transforma todas las bandas del canvas al tipo de dato de salida.
+ * @param[in] pCanvas Canvas con la salida del anterior
+ * @param[out] pCanvas Canvas con los datos en el tipo de dato de salida
+ * @return false si el canvas o su tipo de dato son invalidos
+ */
+bool DataCastRenderer::ProcessCanvas(Canvas *pCanvas) {
+   if (!pCanvas) {
       REPORT_AND_FAIL_VALUE("D:Canvas no puede ser nulo al realizar data cast.", false);
    }
 
    // Si el tipo de dato que obtengo del canvas es void informo error
-   if (ptempcanvas->GetDataType() == DataInfo<void>::Name) {
+   if (pCanvas->GetDataType() == DataInfo<void>::Name) {
       REPORT_AND_FAIL_VALUE("D:Tipos de datos invalidos.", false);
    }
 
-   if (ptempcanvas->GetDataType() != parameters_.destinationDataType_) {
+   if (pCanvas->GetDataType() != parameters_.destinationDataType_) {
       REPORT_DEBUG("D:Aplicando transformacion de tipo de dato");
       // tamano del canvas
       int csizex, csizey;
-      ptempcanvas->GetSize(csizex, csizey);
+      pCanvas->GetSize(csizex, csizey);
       if (csizex < 1 || csizey < 1) {
          REPORT_AND_FAIL_VALUE("D:Tamano de canvas erroneo", false);
       }
       // indice de bandas
-      std::vector<int> bands(ptempcanvas->GetBandCount());
-      // datos originales
-      std::vector<void*> data(ptempcanvas->GetBandCount());
-      for (int b = 0; b < ptempcanvas->GetBandCount(); b++) {
+      std::vector<int> bands(pCanvas->GetBandCount());
+      for (int b = 0; b < pCanvas->GetBandCount(); b++)
          bands[b] = b;
-         data[b] = new unsigned char[csizex * csizey * ptempcanvas->GetDataSize()];
-      }
-      int bandcount = ptempcanvas->GetBandCount();
-      // me traigo los datos
-      ptempcanvas->Read(bands, data);
-      // Cambio tipo de dato
-      ptempcanvas->SetDataType(parameters_.destinationDataType_);
+      int bandcount = pCanvas->GetBandCount();
+      // datos originales (los buffers del canvas si los presta)
+      CanvasBandBuffers input(pCanvas, bands);
+      std::vector<void*> &data = input.GetData();
       // Transformo datos
+      int newdatasize = SizeOf(parameters_.destinationDataType_);
       std::vector<void*> newdata(bandcount);
       for (int b = 0; b < bandcount; b++) {
-         newdata[b] = new unsigned char[csizex * csizey * ptempcanvas->GetDataSize()];
-         memset(newdata[b], 0, csizex * csizey * ptempcanvas->GetDataSize());
+         newdata[b] = new unsigned char[csizex * csizey * newdatasize];
+         memset(newdata[b], 0, csizex * csizey * newdatasize);
          parameters_.function_(newdata[b], data[b], csizex * csizey);
       }
-      ptempcanvas->SetBandCount(bandcount);
-      ptempcanvas->SetSize(csizex, csizey);
+      // Cambio tipo de dato
+      input.Release();
+      pCanvas->SetDataType(parameters_.destinationDataType_);
+      pCanvas->SetBandCount(bandcount);
+      pCanvas->SetSize(csizex, csizey);
 
       // Guardo Bandas
-      ptempcanvas->Write(bands, newdata);
-      for (int b = 0; b < bandcount; b++) {
-         delete[] static_cast<unsigned char*>(data[b]);
+      pCanvas->Write(bands, newdata);
+      for (int b = 0; b < bandcount; b++)
          delete[] static_cast<unsigned char*>(newdata[b]);
+   }
+   return true;
+}
+
+/**
+ *  La funcion de cast se toma de la matriz de tipos para el tipo de entrada
+ * real (el de Create corresponde a la salida del anterior).
+ * @param[in] InputBandCount cantidad de bandas de entrada
+ * @param[in] InputDataType tipo de dato de entrada
+ * @param[out] OutputBandCount igual a la de entrada
+ * @param[out] OutputDataType tipo de dato destino
+ * @return false si no hay cast para el tipo de dato de entrada
+ */
+bool DataCastRenderer::PreparePixels(int InputBandCount, const std::string &InputDataType,
+                                     int &OutputBandCount, std::string &OutputDataType) {
+   pPixelFunction_ = NULL;
+   pixelDataSize_ = 0;
+   if (InputDataType == DataInfo<void>::Name) {
+      return false;
+   }
+   OutputBandCount = InputBandCount;
+   OutputDataType = parameters_.destinationDataType_;
+   if (InputDataType == parameters_.destinationDataType_) {
+      pixelDataSize_ = SizeOf(InputDataType);
+      return pixelDataSize_ > 0;
+   }
+   TRY
+   {
+      pPixelFunction_ = datacastTypeMatrix[parameters_.destinationDataType_][InputDataType];
+   }
+   CATCH {
+      pPixelFunction_ = NULL;
+   }
+   return pPixelFunction_ != NULL;
+}
+
+/**
+ * @param[in] InputData datos de cada banda en el tipo de entrada
+ * @param[out] OutputData datos de cada banda en el tipo destino
+ * @param[in] PixelCount cantidad de pixeles
+ */
+void DataCastRenderer::ApplyPixels(std::vector<void*> &InputData,
+                                   std::vector<void*> &OutputData, size_t PixelCount) {
+   for (size_t b = 0; b < InputData.size(); b++) {
+      if (pPixelFunction_) {
+         pPixelFunction_(OutputData[b], InputData[b], PixelCount);
+      } else {
+         memcpy(OutputData[b], InputData[b], PixelCount * pixelDataSize_);
       }
    }
-   if (pCanvas != ptempcanvas) {
-      pCanvas->Write(ptempcanvas, pMask);
-      delete ptempcanvas;
+}
+
+/**
+ *  Los renderizadores raster leen el canvas existente como fondo, por eso
+ * antes de renderizar el anterior se vuelven los datos a su tipo de salida
+ * con parametersToChar_.
+ * @param[in] pCanvas canvas a transformar
+ */
+void DataCastRenderer::CastToPreviousDataType(Canvas *pCanvas) {
+   int x, y, b;
+   std::string datatype;
+   pPreviousRenderer_->GetOutputParameters(x, y, b, datatype);
+   std::vector<int> bands;
+   for (int x = 0; x < pCanvas->GetBandCount(); x++)
+      bands.push_back(x);
+   // los datos originales se toman de los buffers del canvas si los presta
+   CanvasBandBuffers originaldata(pCanvas, bands);
+   std::vector<void*> &originalData = originaldata.GetData();
+   int outputdatasize = SizeOf(datatype);
+   std::vector<void*> castedData;
+   for (size_t x = 0; x < originalData.size(); x++) {
+      unsigned char* data = new unsigned char [pCanvas->GetSizeX() * pCanvas->GetSizeY() *
+                                                        outputdatasize];
+      /* datacast<unsigned short, unsigned char>*/
+      parametersToChar_.function_(data, originalData[x], pCanvas->GetSizeX() *
+                                                                         pCanvas->GetSizeY());
+      castedData.push_back(data);
    }
-   return true && prevrenderizationstatus;
+   originaldata.Release();
+   pCanvas->SetDataType(datatype);
+   pCanvas->Write(bands, castedData);
+   for (size_t x = 0; x < castedData.size(); x++)
+      delete[] static_cast<unsigned char*>(castedData[x]);
 }
 
 /**
@@ -30,6 +30,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes suri
 #include "suri/Renderer.h"
+#include "PixelRenderer.h"
 
 /** Forwards */
 class wxXmlNode;
@@ -42,8 +43,9 @@ namespace suri {
  * por el nodo xml. Los tipos de dato posibles son los indicados en la clase
  * DataTypes.h.
  * \note hereda de renderer para formar parte del pipeline de renderizacion
+ * \note hereda de PixelRenderer para fusionarse con otras etapas por pixel
  */
-class DataCastRenderer : public Renderer {
+class DataCastRenderer : public Renderer, public PixelRenderer {
    /** Ctor. de Copia. */
    DataCastRenderer(const DataCastRenderer &DataCastRenderer);
 
@@ -75,6 +77,16 @@ public:
 // ----------------------- METODOS DE RENDERIZACION -------------------------
    /** Cambia el tipo de dato */
    virtual bool Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pMask);
+   /** Renderiza el anterior con el canvas en el tipo de dato que este genera */
+   virtual bool RenderInput(const World *pWorldWindow, Canvas *pCanvas, Mask *pMask);
+   /** Cambia el tipo de dato de todo el canvas */
+   virtual bool ProcessCanvas(Canvas *pCanvas);
+   /** Selecciona la funcion de cast para el tipo de dato de entrada */
+   virtual bool PreparePixels(int InputBandCount, const std::string &InputDataType,
+                              int &OutputBandCount, std::string &OutputDataType);
+   /** Cambia el tipo de dato de un tramo de pixeles */
+   virtual void ApplyPixels(std::vector<void*> &InputData,
+                            std::vector<void*> &OutputData, size_t PixelCount);
    /** Obtiene el "bounding box" del elemento renderizado */
    virtual void GetBoundingBox(const World *pWorld, double &Ulx, double &Uly,
                                double &Lrx, double &Lry);
@@ -89,8 +101,13 @@ public:
    virtual void Update(Element *pElement);
 protected:
 private:
+   /** Pasa los datos del canvas al tipo de dato de salida del anterior */
+   void CastToPreviousDataType(Canvas *pCanvas);
+
    Parameters parametersToChar_;
    Parameters parameters_; /*! Parametros de la instancia */
+   Parameters::CastFunctionType pPixelFunction_; /*! Cast de ApplyPixels */
+   size_t pixelDataSize_; /*! Tamanio del dato si ApplyPixels solo copia */
 };
 }
 
@@ -0,0 +1,154 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#include "DenseLut.h"
+
+// Includes estandar
+#include <limits>
+#include <map>
+
+// Includes Suri
+#include "suri/DataTypes.h"
+
+// Includes Wx
+
+// Includes App
+
+// Defines
+/** Tamanio maximo (en bytes) del tipo de dato para tabular */
+#define DENSE_LUT_MAX_DATA_SIZE 2
+
+/** namespace suri */
+namespace suri {
+
+/** Template builddenselut */
+/**
+ *  Evalua la funcion para cada valor posible de T. La entrada del valor V
+ * esta en la posicion V - min(T).
+ * @param[out] Table tabla con un T por cada valor de entrada
+ * @param[in] TableFunction funcion a tabular
+ * @return false si T no es un entero de hasta DENSE_LUT_MAX_DATA_SIZE bytes
+ */
+template<typename T>
+bool builddenselut(std::vector<unsigned char> &Table,
+                   const DenseLut::Function &TableFunction) {
+   if (!std::numeric_limits<T>::is_integer || sizeof(T) > DENSE_LUT_MAX_DATA_SIZE) {
+      return false;
+   }
+   long minvalue = static_cast<long>(std::numeric_limits<T>::min());
+   long maxvalue = static_cast<long>(std::numeric_limits<T>::max());
+   Table.resize(static_cast<size_t>(maxvalue - minvalue + 1) * sizeof(T));
+   T* ptable = reinterpret_cast<T*>(&Table[0]);
+   for (long value = minvalue; value <= maxvalue; value++)
+      ptable[value - minvalue] = static_cast<T>(
+            TableFunction.Evaluate(static_cast<double>(value)));
+   return true;
+}
+/** Inicializa mapa de tipos de datos. */
+INITIALIZE_DATATYPE_MAP(DenseLut::BuildFunctionType, builddenselut);
+
+/** Template applydenselut */
+/**
+ *  Un acceso a la tabla por pixel, sin saltos, que el compilador puede
+ * vectorizar.
+ * @param[in] pTable tabla generada por builddenselut<T>
+ * @param[out] pDest datos de salida
+ * @param[in] pSrc datos de entrada
+ * @param[in] Size cantidad de datos
+ */
+template<typename T>
+void applydenselut(const unsigned char *pTable, void *pDest, const void *pSrc,
+                   size_t Size) {
+   const T* ptable = reinterpret_cast<const T*>(pTable);
+   const T* psrc = static_cast<const T*>(pSrc);
+   T* pdest = static_cast<T*>(pDest);
+   long minvalue = static_cast<long>(std::numeric_limits<T>::min());
+   for (size_t i = 0; i < Size; i++)
+      pdest[i] = ptable[static_cast<long>(psrc[i]) - minvalue];
+}
+/** Inicializa mapa de tipos de datos. */
+INITIALIZE_DATATYPE_MAP(DenseLut::ApplyFunctionType, applydenselut);
+
+/** Ctor */
+DenseLut::DenseLut() :
+      pApply_(NULL) {
+}
+
+/**
+ * @param[in] DataType tipo de dato
+ * @return true si el tipo de dato es un entero de 8 o 16 bits
+ */
+bool DenseLut::IsSupported(const std::string &DataType) {
+   return (DataType == DataInfo<unsigned char>::Name || DataType == DataInfo<char>::Name
+         || DataType == DataInfo<short>::Name
+         || DataType == DataInfo<unsigned short>::Name);
+}
+
+/**
+ * @param[in] DataType tipo de dato de entrada y salida
+ * @param[in] TableFunction funcion a tabular
+ * @return false si el tipo de dato no se puede tabular (la tabla queda vacia)
+ */
+bool DenseLut::Build(const std::string &DataType, const Function &TableFunction) {
+   Clear();
+   if (!IsSupported(DataType) || !builddenselutTypeMap[DataType](table_, TableFunction)) {
+      Clear();
+      return false;
+   }
+   dataType_ = DataType;
+   pApply_ = applydenselutTypeMap[DataType];
+   return true;
+}
+
+/** Elimina la tabla */
+void DenseLut::Clear() {
+   std::vector<unsigned char>().swap(table_);
+   dataType_.clear();
+   pApply_ = NULL;
+}
+
+/** @return true si tiene una tabla cargada */
+bool DenseLut::IsValid() const {
+   return pApply_ != NULL;
+}
+
+/** @return tipo de dato de la tabla, vacio si no tiene tabla */
+std::string DenseLut::GetDataType() const {
+   return dataType_;
+}
+
+/**
+ * @param[out] pDest datos de salida (puede ser igual a pSrc)
+ * @param[in] pSrc datos de entrada
+ * @param[in] Size cantidad de datos
+ * \pre IsValid()
+ */
+void DenseLut::Apply(void *pDest, const void *pSrc, size_t Size) const {
+   pApply_(&table_[0], pDest, pSrc, Size);
+}
+
+}  // namespace suri
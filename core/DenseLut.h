@@ -0,0 +1,95 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef DENSELUT_H_
+#define DENSELUT_H_
+
+// Includes estandar
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Includes Suri
+
+// Includes Wx
+
+// Includes App
+
+// Defines
+
+/** namespace suri */
+namespace suri {
+
+/** Tabla de busqueda con una entrada por cada valor posible del tipo de dato */
+/**
+ *  Para tipos de dato enteros de 8 y 16 bits se tabula una funcion para todos
+ * los valores posibles de entrada (256 o 65536 entradas) y se aplica con un
+ * acceso directo por pixel, sin comparaciones ni busquedas. Lo usan
+ * LutRenderer y EnhancementRenderer; para el resto de los tipos de dato
+ * mantienen su implementacion original.
+ */
+class DenseLut {
+public:
+   /** Funcion que se tabula */
+   class Function {
+   public:
+      /** Dtor */
+      virtual ~Function() {
+      }
+      /** Valor de salida para un valor de entrada */
+      virtual double Evaluate(double Value) const=0;
+   };
+
+   /** Ctor */
+   DenseLut();
+   /** Indica si el tipo de dato se puede tabular */
+   static bool IsSupported(const std::string &DataType);
+   /** Tabula la funcion para todos los valores del tipo de dato */
+   bool Build(const std::string &DataType, const Function &TableFunction);
+   /** Elimina la tabla */
+   void Clear();
+   /** Indica si tiene una tabla cargada */
+   bool IsValid() const;
+   /** Tipo de dato de la tabla */
+   std::string GetDataType() const;
+   /** Aplica la tabla */
+   void Apply(void *pDest, const void *pSrc, size_t Size) const;
+
+   /** Tipo de la funcion que tabula */
+   typedef bool (*BuildFunctionType)(std::vector<unsigned char>&, const Function&);
+   /** Tipo de la funcion que aplica la tabla */
+   typedef void (*ApplyFunctionType)(const unsigned char*, void*, const void*, size_t);
+
+private:
+   std::vector<unsigned char> table_; /*! Valores de salida (del tipo de dato) */
+   std::string dataType_; /*! Tipo de dato de la tabla */
+   ApplyFunctionType pApply_; /*! Funcion que aplica la tabla */
+};
+
+}  // namespace suri
+
+#endif /* DENSELUT_H_ */
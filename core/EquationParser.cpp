@@ -29,6 +29,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include <string>
 #include <vector>
 #include <map>
+#include <limits>
 
 // Includes suri
 #include "EquationParser.h"
@@ -93,10 +94,13 @@ muDataType MuXor(muDataType Val1, muDataType Val2) {
  * @param[in] Val1 valor de la primer variable
  * @param[in] Val2 valor de la segunda variable
  * @return resultado de modulos.
+ * @return NaN si el divisor redondeado es cero.
  */
 muDataType MuMod(muDataType Val1, muDataType Val2) {
    int val1 = SURI_ROUND(int, Val1);
    int val2 = SURI_ROUND(int, Val2);
+   if (val2 == 0)
+      return std::numeric_limits<muDataType>::quiet_NaN();
    return val1 % val2;
 }
 
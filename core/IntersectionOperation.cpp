@@ -29,7 +29,10 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 // Includes Suri
 #include "IntersectionOperation.h"
 #include "suri/Vector.h"
+#include "suri/Progress.h"
+#include "suri/messages.h"
 #include "VectorDatasource.h"
+#include "SpatialIndex.h"
 // Includes Wx
 // Defines
 // forwards
@@ -48,7 +51,8 @@ IntersectionOperation::~IntersectionOperation() {
 }
 
 /** Procesa las fuentes de datos de entrada generando la interseccion de ambas en una nueva
- * fuente de datos
+ * fuente de datos. Cada feature de la primer capa solo se compara con los
+ * features de la segunda cuyas envolventes intersectan la suya.
  * @param[in] Operation tipo de operacion a realizar
  * @param[in] Datasources fuentes de datos sobre las que se quiere operar
  * @param[out] Fuente de datos vectorial con resultado de la operacion o NULL en caso de que
@@ -83,19 +87,32 @@ VectorDatasource* IntersectionOperation::DoProcessDatasource(
 
    pfirstlayer->ResetReading();
 
-   int firstlayercount = pfirstlayer->GetFeatureCount();
-   int secondlayercount = psecondlayer->GetFeatureCount();
+   // Indice espacial de la segunda capa
+   std::vector<OGRFeature*> secondfeatures;
+   SpatialIndex secondindex;
+   LoadFeatures(psecondlayer, secondfeatures, secondindex);
 
-   for (int i = 0; i < firstlayercount; i++) {
+   int firstlayercount = pfirstlayer->GetFeatureCount();
+   Progress progress(firstlayercount, _(message_PROCESSING_VECTOR_OPERATION));
+   bool abort = false;
+   std::vector<int> candidates;
+   for (int i = 0; !abort && i < firstlayercount; i++) {
       OGRFeature *pfeature = pfirstlayer->GetNextFeature();
-      OGRGeometry* pgeom = pfeature->GetGeometryRef()->clone();
-      int j = 0;
-      for (j = 0; j < secondlayercount; j++) {
-         OGRFeature *psecondfeature = psecondlayer->GetNextFeature();
-         OGRFeature* pnewfeature = new OGRFeature(pdestlayerfeaturedef);
-         OGRGeometry* psecondgeom = psecondfeature->GetGeometryRef()->clone();
-         if (pgeom->Intersects(psecondgeom)) {
-            OGRGeometry* poperation = pgeom->Intersection(psecondgeom);
+      if (!pfeature)
+         break;
+      OGRGeometry* pgeom = pfeature->GetGeometryRef();
+      candidates.clear();
+      if (pgeom != NULL) {
+         OGREnvelope envelope;
+         pgeom->getEnvelope(&envelope);
+         secondindex.Query(envelope, candidates);
+      }
+      PreparedGeometry prepared(pgeom);
+      for (size_t j = 0; j < candidates.size(); j++) {
+         OGRFeature *psecondfeature = secondfeatures[candidates[j]];
+         OGRGeometry* psecondgeom = psecondfeature->GetGeometryRef();
+         if (prepared.Intersects(psecondgeom)) {
+            OGRFeature* pnewfeature = new OGRFeature(pdestlayerfeaturedef);
             // Lleno el contenido del feature con los campos de las geometrias de origen
             // copio los datos de la geometria 1.
             CopyFieldsFromOrigin(pfeature, pnewfeature, pfirstlayerfeaturedef->GetFieldCount());
@@ -103,15 +120,19 @@ VectorDatasource* IntersectionOperation::DoProcessDatasource(
             CopyFieldsFromOrigin(psecondfeature, pnewfeature,
                                  pdestlayerfeaturedef->GetFieldCount(),
                                  pfirstlayerfeaturedef->GetFieldCount());
-            pnewfeature->SetGeometry(poperation);
+            pnewfeature->SetGeometryDirectly(pgeom->Intersection(psecondgeom));
             pdestlayer->CreateFeature(pnewfeature);
+            OGRFeature::DestroyFeature(pnewfeature);
          }
-         OGRFeature::DestroyFeature(pnewfeature);
       }
-      psecondlayer->ResetReading();
+      OGRFeature::DestroyFeature(pfeature);
+      abort = progress.Update();
    }
+   DestroyFeatures(secondfeatures);
 
    Vector::Close(pdesttarget);
+   if (abort)
+      return NULL;
 
    return VectorDatasource::Create(tmpFilename);
 }
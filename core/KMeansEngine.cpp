@@ -0,0 +1,415 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#include "KMeansEngine.h"
+
+// Includes estandar
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Includes Suri
+#include "suri/Configuration.h"
+
+// Includes Wx
+#include "wx/thread.h"
+
+// Includes App
+
+// Defines
+/** Cantidad minima de pixeles para repartir una tarea entre hilos */
+#define MIN_PIXELS_PER_THREAD 16384
+/** Tarea de asignacion de pixeles cargados */
+#define ASSIGN_TASK 0
+/** Tarea de clasificacion de un bloque */
+#define CLASSIFY_TASK 1
+/** Tolerancia para comparar con el valor no valido */
+#define NO_DATA_PRECISION 0.00000001
+
+/** namespace suri */
+namespace suri {
+
+/** Hilo que procesa un rango de pixeles para KMeansEngine */
+class KMeansWorker : public wxThread {
+public:
+   /** Ctor */
+   KMeansWorker(KMeansEngine *pEngine, int Task, size_t Begin, size_t End,
+                const std::vector<float*> *pData, bool NoDataAvailable, double NoDataValue,
+                float InvalidValue, float *pOutput, KMeansEngine::PartialSums *pPartial) :
+         wxThread(wxTHREAD_JOINABLE), pEngine_(pEngine), task_(Task), begin_(Begin),
+         end_(End), pData_(pData), noDataAvailable_(NoDataAvailable),
+         noDataValue_(NoDataValue), invalidValue_(InvalidValue), pOutput_(pOutput),
+         pPartial_(pPartial) {
+   }
+
+   /** Procesa el rango */
+   void Process() {
+      if (task_ == ASSIGN_TASK)
+         pEngine_->AssignRange(begin_, end_, *pPartial_);
+      else
+         pEngine_->ClassifyRange(*pData_, begin_, end_, noDataAvailable_, noDataValue_,
+                                 invalidValue_, pOutput_);
+   }
+
+protected:
+   /** Punto de entrada del hilo */
+   virtual ExitCode Entry() {
+      Process();
+      return 0;
+   }
+
+private:
+   KMeansEngine *pEngine_; /*! motor que se procesa */
+   int task_; /*! tarea a ejecutar */
+   size_t begin_; /*! primer pixel del rango */
+   size_t end_; /*! fin del rango */
+   const std::vector<float*> *pData_; /*! bloque a clasificar */
+   bool noDataAvailable_; /*! indica si hay valor no valido */
+   double noDataValue_; /*! valor no valido */
+   float invalidValue_; /*! valor de salida de los pixeles no validos */
+   float *pOutput_; /*! salida de la clasificacion */
+   KMeansEngine::PartialSums *pPartial_; /*! sumas parciales del rango */
+};
+
+/**
+ * @param[in] BandCount cantidad de bandas
+ * @param[in] ThreadCount cantidad de hilos. Si es 0 se usa
+ * lib_kmeans_thread_count o, si no esta configurado, la cantidad de CPUs.
+ */
+KMeansEngine::KMeansEngine(int BandCount, int ThreadCount) :
+      bandCount_(BandCount), threadCount_(ThreadCount), classCount_(0), maxDrift_(0),
+      secondDrift_(0), maxDriftClass_(-1) {
+   if (threadCount_ <= 0)
+      threadCount_ = Configuration::GetParameter("lib_kmeans_thread_count",
+                                                 static_cast<long>(threadCount_));
+   if (threadCount_ <= 0)
+      threadCount_ = std::max(1, wxThread::GetCPUCount());
+   IterationInfo empty = { 0, 0, 0, 0 };
+   lastIteration_ = empty;
+}
+
+/** Dtor */
+KMeansEngine::~KMeansEngine() {
+}
+
+/**
+ * Los pixeles que tienen el valor no valido en todas las bandas no se cargan.
+ * @param[in] Data buffers de cada banda
+ * @param[in] PixelCount cantidad de pixeles de cada buffer
+ * @param[in] NoDataAvailable indica si hay valor no valido
+ * @param[in] NoDataValue valor no valido
+ * @param[in] Step se carga uno de cada Step pixeles (muestreo)
+ */
+void KMeansEngine::AddPixels(const std::vector<float*> &Data, int PixelCount,
+                             bool NoDataAvailable, double NoDataValue, int Step) {
+   Step = std::max(1, Step);
+   pixels_.reserve(pixels_.size() + (PixelCount / Step + 1) * bandCount_);
+   for (int p = 0; p < PixelCount; p += Step) {
+      bool invalid = NoDataAvailable;
+      for (int b = 0; invalid && b < bandCount_; ++b)
+         invalid = fabs(Data[b][p] - NoDataValue) < NO_DATA_PRECISION;
+      if (invalid)
+         continue;
+      for (int b = 0; b < bandCount_; ++b)
+         pixels_.push_back(Data[b][p]);
+   }
+}
+
+/** @return cantidad de pixeles cargados */
+size_t KMeansEngine::GetPixelCount() const {
+   return bandCount_ > 0 ? pixels_.size() / bandCount_ : 0;
+}
+
+/**
+ * Reinicia la asignacion de los pixeles.
+ * @param[in] Means medias iniciales (una por clase, con BandCount valores)
+ */
+void KMeansEngine::SetMeans(const std::vector<std::vector<double> > &Means) {
+   classCount_ = static_cast<int>(Means.size());
+   means_.assign(classCount_ * bandCount_, 0.0);
+   for (int c = 0; c < classCount_; ++c)
+      for (int b = 0; b < bandCount_ && b < static_cast<int>(Means[c].size()); ++b)
+         means_[c * bandCount_ + b] = Means[c][b];
+   size_t pixelcount = GetPixelCount();
+   assignment_.assign(pixelcount, -1);
+   upper_.assign(pixelcount, std::numeric_limits<double>::max());
+   lower_.assign(pixelcount, 0.0);
+   drift_.assign(classCount_, 0.0);
+   maxDrift_ = 0;
+   secondDrift_ = 0;
+   maxDriftClass_ = -1;
+   IterationInfo empty = { 0, 0, 0, 0 };
+   lastIteration_ = empty;
+}
+
+/**
+ * Asigna cada pixel a la media mas cercana y calcula las nuevas medias. Las
+ * clases sin pixeles conservan su media.
+ * @param[out] NewMeans nuevas medias
+ * @return false si no hay pixeles o medias
+ */
+bool KMeansEngine::Iterate(std::vector<std::vector<double> > &NewMeans) {
+   size_t pixelcount = GetPixelCount();
+   if (classCount_ == 0 || pixelcount == 0)
+      return false;
+
+   // Mitad de la distancia de cada media a la mas cercana
+   halfNearest_.assign(classCount_, std::numeric_limits<double>::max());
+   for (int c = 0; c < classCount_; ++c) {
+      for (int o = c + 1; o < classCount_; ++o) {
+         double distance = 0;
+         for (int b = 0; b < bandCount_; ++b) {
+            double diff = means_[c * bandCount_ + b] - means_[o * bandCount_ + b];
+            distance += diff * diff;
+         }
+         distance = sqrt(distance) / 2;
+         halfNearest_[c] = std::min(halfNearest_[c], distance);
+         halfNearest_[o] = std::min(halfNearest_[o], distance);
+      }
+   }
+
+   std::vector<PartialSums> partials;
+   RunParallel(pixelcount, ASSIGN_TASK, NULL, false, 0, 0, NULL, &partials);
+
+   // Uno las sumas parciales
+   std::vector<double> sums(classCount_ * bandCount_, 0.0);
+   std::vector<size_t> counts(classCount_, 0);
+   IterationInfo info = { lastIteration_.iteration_ + 1, 0, 0, 0 };
+   for (size_t i = 0; i < partials.size(); ++i) {
+      for (size_t j = 0; j < sums.size(); ++j)
+         sums[j] += partials[i].sums_[j];
+      for (int c = 0; c < classCount_; ++c)
+         counts[c] += partials[i].counts_[c];
+      info.changedPixels_ += partials[i].changedPixels_;
+      info.distanceCount_ += partials[i].distanceCount_;
+      info.skippedPixels_ += partials[i].skippedPixels_;
+   }
+   lastIteration_ = info;
+
+   // Nuevas medias y desplazamiento de cada una (para las cotas)
+   maxDrift_ = 0;
+   secondDrift_ = 0;
+   maxDriftClass_ = -1;
+   NewMeans.assign(classCount_, std::vector<double>(bandCount_, 0.0));
+   for (int c = 0; c < classCount_; ++c) {
+      double drift = 0;
+      for (int b = 0; b < bandCount_; ++b) {
+         double mean = means_[c * bandCount_ + b];
+         if (counts[c] > 0)
+            mean = sums[c * bandCount_ + b] / static_cast<double>(counts[c]);
+         double diff = mean - means_[c * bandCount_ + b];
+         drift += diff * diff;
+         means_[c * bandCount_ + b] = mean;
+         NewMeans[c][b] = mean;
+      }
+      drift_[c] = sqrt(drift);
+      if (drift_[c] > maxDrift_) {
+         secondDrift_ = maxDrift_;
+         maxDrift_ = drift_[c];
+         maxDriftClass_ = c;
+      } else if (drift_[c] > secondDrift_) {
+         secondDrift_ = drift_[c];
+      }
+   }
+   return true;
+}
+
+/** @return resumen de la ultima iteracion */
+const KMeansEngine::IterationInfo &KMeansEngine::GetLastIteration() const {
+   return lastIteration_;
+}
+
+/**
+ * @param[in] Data buffers de cada banda
+ * @param[in] PixelCount cantidad de pixeles de cada buffer
+ * @param[in] NoDataAvailable indica si hay valor no valido
+ * @param[in] NoDataValue valor no valido
+ * @param[in] InvalidValue valor de salida de los pixeles no validos
+ * @param[out] pOutput clase de cada pixel (desde 1) o InvalidValue
+ */
+void KMeansEngine::Classify(const std::vector<float*> &Data, int PixelCount,
+                            bool NoDataAvailable, double NoDataValue, float InvalidValue,
+                            float *pOutput) {
+   RunParallel(PixelCount, CLASSIFY_TASK, &Data, NoDataAvailable, NoDataValue,
+               InvalidValue, pOutput, NULL);
+}
+
+/**
+ * Primero aplica a las cotas del pixel el desplazamiento de las medias en la
+ * iteracion anterior y solo si no alcanzan busca la media mas cercana.
+ * @param[in] Begin primer pixel
+ * @param[in] End fin del rango
+ * @param[out] Partial sumas parciales del rango
+ */
+void KMeansEngine::AssignRange(size_t Begin, size_t End, PartialSums &Partial) {
+   Partial.sums_.assign(classCount_ * bandCount_, 0.0);
+   Partial.counts_.assign(classCount_, 0);
+   Partial.changedPixels_ = 0;
+   Partial.distanceCount_ = 0;
+   Partial.skippedPixels_ = 0;
+   for (size_t p = Begin; p < End; ++p) {
+      const float *ppixel = &pixels_[p * bandCount_];
+      int current = assignment_[p];
+      bool search = true;
+      if (current >= 0) {
+         upper_[p] += drift_[current];
+         lower_[p] -= current == maxDriftClass_ ? secondDrift_ : maxDrift_;
+         double bound = std::max(halfNearest_[current], lower_[p]);
+         if (upper_[p] > bound) {
+            upper_[p] = Distance(ppixel, current);
+            ++Partial.distanceCount_;
+         }
+         search = upper_[p] > bound;
+      }
+      if (search) {
+         double nearest = std::numeric_limits<double>::max();
+         double second = std::numeric_limits<double>::max();
+         int winner = 0;
+         for (int c = 0; c < classCount_; ++c) {
+            double distance = Distance(ppixel, c);
+            if (distance < nearest) {
+               second = nearest;
+               nearest = distance;
+               winner = c;
+            } else if (distance < second) {
+               second = distance;
+            }
+         }
+         Partial.distanceCount_ += classCount_;
+         if (winner != current)
+            ++Partial.changedPixels_;
+         assignment_[p] = winner;
+         upper_[p] = nearest;
+         lower_[p] = second;
+      } else {
+         ++Partial.skippedPixels_;
+      }
+      double *psum = &Partial.sums_[assignment_[p] * bandCount_];
+      for (int b = 0; b < bandCount_; ++b)
+         psum[b] += ppixel[b];
+      ++Partial.counts_[assignment_[p]];
+   }
+}
+
+/**
+ * @param[in] Data buffers de cada banda
+ * @param[in] Begin primer pixel
+ * @param[in] End fin del rango
+ * @param[in] NoDataAvailable indica si hay valor no valido
+ * @param[in] NoDataValue valor no valido
+ * @param[in] InvalidValue valor de salida de los pixeles no validos
+ * @param[out] pOutput clase de cada pixel (desde 1) o InvalidValue
+ */
+void KMeansEngine::ClassifyRange(const std::vector<float*> &Data, size_t Begin, size_t End,
+                                 bool NoDataAvailable, double NoDataValue,
+                                 float InvalidValue, float *pOutput) const {
+   for (size_t p = Begin; p < End; ++p) {
+      bool invalid = NoDataAvailable;
+      for (int b = 0; invalid && b < bandCount_; ++b)
+         invalid = fabs(Data[b][p] - NoDataValue) < NO_DATA_PRECISION;
+      if (invalid || classCount_ == 0) {
+         pOutput[p] = InvalidValue;
+         continue;
+      }
+      double nearest = std::numeric_limits<double>::max();
+      int winner = 0;
+      for (int c = 0; c < classCount_; ++c) {
+         const double *pmean = &means_[c * bandCount_];
+         double distance = 0;
+         for (int b = 0; b < bandCount_ && distance < nearest; ++b) {
+            double diff = Data[b][p] - pmean[b];
+            distance += diff * diff;
+         }
+         if (distance < nearest) {
+            nearest = distance;
+            winner = c;
+         }
+      }
+      // el valor de la clase comienza a partir del no valido (0)
+      pOutput[p] = static_cast<float>(winner + 1);
+   }
+}
+
+/**
+ * @param[in] pPixel valores del pixel
+ * @param[in] Class clase
+ * @return distancia euclidea a la media de la clase
+ */
+double KMeansEngine::Distance(const float *pPixel, int Class) const {
+   const double *pmean = &means_[Class * bandCount_];
+   double distance = 0;
+   for (int b = 0; b < bandCount_; ++b) {
+      double diff = pPixel[b] - pmean[b];
+      distance += diff * diff;
+   }
+   return sqrt(distance);
+}
+
+/**
+ * El ultimo rango se procesa en el hilo que llama. Si no se puede crear un
+ * hilo su rango tambien se procesa en el hilo que llama.
+ * @param[in] Count cantidad de pixeles
+ * @param[in] Task tarea a ejecutar (ASSIGN_TASK o CLASSIFY_TASK)
+ * @param[in] pData bloque a clasificar (CLASSIFY_TASK)
+ * @param[in] NoDataAvailable indica si hay valor no valido (CLASSIFY_TASK)
+ * @param[in] NoDataValue valor no valido (CLASSIFY_TASK)
+ * @param[in] InvalidValue valor de salida de los pixeles no validos (CLASSIFY_TASK)
+ * @param[out] pOutput salida de la clasificacion (CLASSIFY_TASK)
+ * @param[out] pPartials sumas parciales de cada rango (ASSIGN_TASK)
+ */
+void KMeansEngine::RunParallel(size_t Count, int Task, const std::vector<float*> *pData,
+                               bool NoDataAvailable, double NoDataValue,
+                               float InvalidValue, float *pOutput,
+                               std::vector<PartialSums> *pPartials) {
+   size_t threads = std::max<size_t>(1, std::min<size_t>(
+         threadCount_, Count / MIN_PIXELS_PER_THREAD));
+   if (pPartials)
+      pPartials->resize(threads);
+   size_t chunk = (Count + threads - 1) / threads;
+
+   std::vector<KMeansWorker*> workers;
+   for (size_t i = 0; i < threads; ++i) {
+      size_t begin = std::min(Count, i * chunk);
+      size_t end = std::min(Count, begin + chunk);
+      KMeansWorker *pworker = new KMeansWorker(this, Task, begin, end, pData,
+                                               NoDataAvailable, NoDataValue, InvalidValue,
+                                               pOutput, pPartials ? &(*pPartials)[i] : NULL);
+      if (i + 1 < threads && pworker->Create() == wxTHREAD_NO_ERROR
+            && pworker->Run() == wxTHREAD_NO_ERROR) {
+         workers.push_back(pworker);
+      } else {
+         pworker->Process();
+         delete pworker;
+      }
+   }
+   for (size_t i = 0; i < workers.size(); ++i) {
+      workers[i]->Wait();
+      delete workers[i];
+   }
+}
+
+}  // namespace suri
@@ -0,0 +1,133 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef KMEANSENGINE_H_
+#define KMEANSENGINE_H_
+
+// Includes estandar
+#include <vector>
+#include <cstddef>
+
+// Includes Suri
+
+// Includes Wx
+
+// Includes App
+
+// Defines
+
+/** namespace suri */
+namespace suri {
+
+class KMeansWorker;
+
+/** Motor de iteraciones de K-Means sobre datos en memoria */
+/**
+ *  Los pixeles validos (o una muestra de ellos) se cargan una sola vez en un
+ * buffer de floats intercalado por pixel (BIP). Cada iteracion asigna los
+ * pixeles a la media mas cercana en paralelo: cada hilo procesa un rango de
+ * pixeles y acumula sumas parciales por clase que luego se unen.
+ *  Para evitar calcular distancias se usan las cotas de Hamerly: por pixel se
+ * guarda una cota superior de la distancia a su media y una inferior de la
+ * distancia a la segunda media mas cercana. Si la cota superior no supera la
+ * inferior (ni la mitad de la distancia de la media a la mas cercana) el
+ * pixel no cambia de clase y no se calcula ninguna distancia.
+ */
+class KMeansEngine {
+   /** Ctor. de Copia. */
+   KMeansEngine(const KMeansEngine &KMeansEngine);
+
+public:
+   /** Resumen de una iteracion */
+   struct IterationInfo {
+      int iteration_; /*! numero de iteracion (desde 1) */
+      size_t changedPixels_; /*! pixeles que cambiaron de clase */
+      size_t distanceCount_; /*! distancias calculadas */
+      size_t skippedPixels_; /*! pixeles descartados por las cotas */
+   };
+
+   /** Ctor */
+   KMeansEngine(int BandCount, int ThreadCount = 0);
+   /** Dtor */
+   ~KMeansEngine();
+   /** Agrega los pixeles validos de un bloque (una banda por buffer) */
+   void AddPixels(const std::vector<float*> &Data, int PixelCount, bool NoDataAvailable,
+                  double NoDataValue, int Step = 1);
+   /** Devuelve la cantidad de pixeles cargados */
+   size_t GetPixelCount() const;
+   /** Configura las medias iniciales */
+   void SetMeans(const std::vector<std::vector<double> > &Means);
+   /** Ejecuta una iteracion y devuelve las nuevas medias */
+   bool Iterate(std::vector<std::vector<double> > &NewMeans);
+   /** Devuelve el resumen de la ultima iteracion */
+   const IterationInfo &GetLastIteration() const;
+   /** Clasifica un bloque con las medias actuales */
+   void Classify(const std::vector<float*> &Data, int PixelCount, bool NoDataAvailable,
+                 double NoDataValue, float InvalidValue, float *pOutput);
+
+private:
+   friend class KMeansWorker;
+   /** Sumas parciales de un rango de pixeles */
+   struct PartialSums {
+      std::vector<double> sums_; /*! suma por clase y banda */
+      std::vector<size_t> counts_; /*! pixeles por clase */
+      size_t changedPixels_; /*! pixeles que cambiaron de clase */
+      size_t distanceCount_; /*! distancias calculadas */
+      size_t skippedPixels_; /*! pixeles descartados por las cotas */
+   };
+   /** Asigna los pixeles del rango a su media mas cercana */
+   void AssignRange(size_t Begin, size_t End, PartialSums &Partial);
+   /** Clasifica los pixeles del rango de un bloque */
+   void ClassifyRange(const std::vector<float*> &Data, size_t Begin, size_t End,
+                      bool NoDataAvailable, double NoDataValue, float InvalidValue,
+                      float *pOutput) const;
+   /** Distancia euclidea de un pixel a una media */
+   double Distance(const float *pPixel, int Class) const;
+   /** Divide [0, Count) entre los hilos y ejecuta la tarea */
+   void RunParallel(size_t Count, int Task, const std::vector<float*> *pData,
+                    bool NoDataAvailable, double NoDataValue, float InvalidValue,
+                    float *pOutput, std::vector<PartialSums> *pPartials);
+
+   int bandCount_; /*! cantidad de bandas */
+   int threadCount_; /*! cantidad de hilos */
+   int classCount_; /*! cantidad de clases */
+   std::vector<float> pixels_; /*! pixeles intercalados (BIP) */
+   std::vector<double> means_; /*! medias por clase y banda */
+   std::vector<double> halfNearest_; /*! mitad de la distancia a la media mas cercana */
+   std::vector<int> assignment_; /*! clase de cada pixel */
+   std::vector<double> upper_; /*! cota superior de distancia a su media */
+   std::vector<double> lower_; /*! cota inferior de distancia a la segunda media */
+   std::vector<double> drift_; /*! desplazamiento de cada media en la ultima iteracion */
+   double maxDrift_; /*! mayor desplazamiento */
+   double secondDrift_; /*! segundo mayor desplazamiento */
+   int maxDriftClass_; /*! clase con el mayor desplazamiento */
+   IterationInfo lastIteration_; /*! resumen de la ultima iteracion */
+};
+
+}  // namespace suri
+
+#endif /* KMEANSENGINE_H_ */
@@ -29,6 +29,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include <string>
 #include <limits>
 #include <sstream>
+#include <cstring>
 
 // Includes Suri
 #include "LutRenderer.h"
@@ -38,6 +39,8 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "suri/AuxiliaryFunctions.h"
 #include "suri/Canvas.h"
 #include "suri/XmlFunctions.h"
+#include "CanvasBandBuffers.h"
+#include "DenseLut.h"
 
 // Includes Wx
 #include "wx/xml/xml.h"
@@ -61,8 +64,10 @@ namespace suri {
 /**
  * Este template se utiliza para aplicar mapa a imagen.
  * Aplica mapa a cada pixel en pSrc y guarda resultado pDest.
+ * Se usa para los tipos de dato que no admiten DenseLut.
  * \pre pDest debe tener tamanio imagen con pixeles en formato int
  * \pre pSrc debe tener tamanio Size
+ * \pre LutTable termina en numeric_limits<double>::max() (ver PrepareTable)
  * \post pDest tiene los datos con LUT
  * @param[out] pDest puntero a los datos "mapeados"
  * @param[in] pSrc puntero a los datos a "mapear"
@@ -70,24 +75,52 @@ namespace suri {
  * @param[in] LutTable mapa que determina valores uchar a partir de doubles
  */
 template<typename T>
-void lut(void* pDest, void* pSrc, size_t Size, std::map<double, double> LutTable) {
-   // le agrego el ultimo repetido al final para que la tabla corte repitiendolo
-   std::map<double, double> luttable = LutTable;
-   luttable.insert(std::make_pair(std::numeric_limits<double>::max(), luttable.rbegin()->second));
+void lut(void* pDest, void* pSrc, size_t Size, const std::map<double, double> &LutTable) {
    T* psrc = static_cast<T*>(pSrc);
    T* pdest = static_cast<T*>(pDest);
    for (size_t i = 0; i < Size; i++) {
-      std::map<double, double>::iterator it = luttable.lower_bound(static_cast<double>(psrc[i]));
+      std::map<double, double>::const_iterator it =
+            LutTable.lower_bound(static_cast<double>(psrc[i]));
       pdest[i] = static_cast<T>(it->second);
    }
 }
-/** Inicializa mapa de tipos de datos. */
 INITIALIZE_DATATYPE_MAP(LutRenderer::Parameters::LutFunctionType, lut);
 
+namespace {
+
+/** Evalua una tabla de LutRenderer para generar un DenseLut */
+class LutTableFunction : public DenseLut::Function {
+public:
+   /** Ctor */
+   explicit LutTableFunction(const std::map<double, double> &Table) :
+         table_(Table) {
+   }
+   /** Valor de la tabla para Value (ver lut) */
+   virtual double Evaluate(double Value) const {
+      return table_.lower_bound(Value)->second;
+   }
+private:
+   const std::map<double, double> &table_; /*! Tabla preparada */
+};
+
+/**
+ *  Agrega el ultimo valor repetido al final para que la tabla corte
+ * repitiendolo.
+ * @param[in] Table tabla de la LUT
+ * @param[out] Table tabla que cubre todos los valores de entrada
+ */
+void PrepareTable(std::map<double, double> &Table) {
+   double last = Table.empty() ? 0.0 : Table.rbegin()->second;
+   Table.insert(std::make_pair(std::numeric_limits<double>::max(), last));
+}
+
+}  // namespace
+
 /**
  * Constructor
  */
-LutRenderer::LutRenderer() {
+LutRenderer::LutRenderer() :
+      pixelDataSize_(0) {
 }
 
 /**
@@ -150,18 +183,39 @@ std::string LutRenderer::CreatedNode() const {
  * @param[in] pMask mascara para los valores a ignorar de la imagen
  */
 bool LutRenderer::Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pMask) {
-   bool prevrenderizationstatus = true;
+   bool prevrenderizationstatus = RenderInput(pWorldWindow, pCanvas, pMask);
+   return ProcessCanvas(pCanvas) && prevrenderizationstatus;
+}
 
-   // Verifico que datos de entrada sean correctos
-   if (pPreviousRenderer_) {
-      prevrenderizationstatus = pPreviousRenderer_->Render(pWorldWindow, pCanvas, pMask);
+/**
+ * @param[in] pWorldWindow ventana del mundo a renderizar
+ * @param[in] pCanvas canvas donde se renderiza el anterior
+ * @param[in] pMask mascara de la renderizacion
+ * @return resultado de la renderizacion del anterior (true si no hay)
+ */
+bool LutRenderer::RenderInput(const World *pWorldWindow, Canvas *pCanvas, Mask *pMask) {
+   if (!pPreviousRenderer_) {
+      return true;
    }
+   return pPreviousRenderer_->Render(pWorldWindow, pCanvas, pMask);
+}
+
+/**
+ * Aplica la tabla de cada banda de salida sobre todo el canvas.
+ * @param[in] pCanvas canvas con la salida del renderizador anterior
+ * @param[out] pCanvas canvas con una banda por tabla
+ * @return false si el canvas es invalido o no coincide con la entrada
+ */
+bool LutRenderer::ProcessCanvas(Canvas *pCanvas) {
    if (!pCanvas) {
       REPORT_AND_FAIL_VALUE("D:Canvas no puede ser nulo al aplicar LUT.", false);
    }
    if (!parameters_.lut_.active_) {
       REPORT_DEBUG("D:No se aplica LUT porque esta inhabilitada");
-      return true && prevrenderizationstatus;
+      return true;
+   }
+   if (static_cast<int>(parameters_.tables_.size()) != parameters_.lut_.GetCount()) {
+      REPORT_AND_FAIL_VALUE("D:Tablas de la LUT no preparadas.", false);
    }
 
    int sizex, sizey, bandcount = 0;
@@ -176,18 +230,27 @@ bool LutRenderer::Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pMask
    }
    int size = sizex * sizey;
 
-   // Leo los datos en el canvas
+   // Leo los datos en el canvas (los buffers del canvas si los presta)
    std::vector<int> bands(bandcount);
-   std::vector<void*> data(bandcount);
-   for (int b = 0; b < bandcount; b++) {
+   for (int b = 0; b < bandcount; b++)
       bands[b] = b;
-      data[b] = new unsigned char[sizex * sizey * pCanvas->GetDataSize()];
-   }
-   pCanvas->Read(bands, data);
+   CanvasBandBuffers input(pCanvas, bands);
+   std::vector<void*> &data = input.GetData();
 
-   // Inicializo el canvas con la nueva dimension
-   pCanvas->SetBandCount(parameters_.lut_.GetCount());
-   pCanvas->SetSize(sizex, sizey);
+   // Si cada LUT se aplica sobre la banda de su mismo indice se puede
+   // aplicar sobre los datos de entrada (la LUT no cambia el tipo de dato)
+   bool inplace = parameters_.lut_.GetCount() == bandcount;
+   int inputband = 0;
+   for (int i = 0; inplace && i < parameters_.lut_.GetCount(); i++) {
+      parameters_.lut_.GetLookUpTable(i, inputband);
+      inplace = inputband == i;
+   }
+   if (inplace) {
+      for (int i = 0; i < parameters_.lut_.GetCount(); i++)
+         ApplyTable(i, data[i], data[i], size);
+      input.Commit();
+      return true;
+   }
 
    // Creo vector donde se guardan datos de salida temporales
    std::vector<void*> outdata(parameters_.lut_.GetCount());
@@ -196,28 +259,100 @@ bool LutRenderer::Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pMask
 
    // Aplico LUTs a las bandas
    std::vector<int> newbands(parameters_.lut_.GetCount());
-   int inputband = 0;
-   LookUpTable::LutType table;
    for (int i = 0; i < parameters_.lut_.GetCount(); i++) {
-      parameters_.lut_.GetLookUpTable(i, inputband).GetTable(table);
-      if (inputband > bandcount) {
+      parameters_.lut_.GetLookUpTable(i, inputband);
+      if (inputband >= bandcount) {
          REPORT_DEBUG("D:Nodo con numero de bandas incorrectas");
+         for (int b = 0; b < parameters_.lut_.GetCount(); b++)
+            delete[] static_cast<unsigned char*>(outdata[b]);
          return false;
       }
-      parameters_.pFunction_(outdata[i], data[inputband], size, table);
+      ApplyTable(i, outdata[i], data[inputband], size);
       newbands[i] = i;
    }
+   // Inicializo el canvas con la nueva dimension
+   input.Release();
+   pCanvas->SetBandCount(parameters_.lut_.GetCount());
+   pCanvas->SetSize(sizex, sizey);
    pCanvas->Write(newbands, outdata);
 
-   // Elimino datos de entrada temporales
-   for (int b = 0; b < bandcount; b++)
-      delete[] static_cast<unsigned char*>(data[b]);
-
    // Elimino datos de salida temporales
    for (int i = 0; i < parameters_.lut_.GetCount(); i++)
       delete[] static_cast<unsigned char*>(outdata[i]);
 
-   return true && prevrenderizationstatus;
+   return true;
+}
+
+/**
+ *  Copia las tablas (y la banda de entrada de cada una) para no obtenerlas
+ * en cada tramo de ApplyPixels.
+ * @param[in] InputBandCount cantidad de bandas de entrada
+ * @param[in] InputDataType tipo de dato de entrada
+ * @param[out] OutputBandCount una banda por tabla (o las de entrada si la
+ *             LUT esta inhabilitada)
+ * @param[out] OutputDataType igual al de entrada
+ * @return false si el formato no coincide con la salida del anterior
+ */
+bool LutRenderer::PreparePixels(int InputBandCount, const std::string &InputDataType,
+                                int &OutputBandCount, std::string &OutputDataType) {
+   pixelInputBands_.clear();
+   pixelDataSize_ = SizeOf(InputDataType);
+   OutputBandCount = InputBandCount;
+   OutputDataType = InputDataType;
+   if (!parameters_.lut_.active_) {
+      return pixelDataSize_ > 0;
+   }
+   int sizex, sizey, bandcount = 0;
+   std::string dt;
+   GetInputParameters(sizex, sizey, bandcount, dt);
+   if (InputDataType != dt || !parameters_.pFunction_
+         || static_cast<int>(parameters_.tables_.size()) != parameters_.lut_.GetCount()) {
+      return false;
+   }
+   int inputband = 0;
+   pixelInputBands_.resize(parameters_.lut_.GetCount());
+   for (int i = 0; i < parameters_.lut_.GetCount(); i++) {
+      parameters_.lut_.GetLookUpTable(i, inputband);
+      if (inputband < 0 || inputband >= InputBandCount) {
+         return false;
+      }
+      pixelInputBands_[i] = inputband;
+   }
+   OutputBandCount = parameters_.lut_.GetCount();
+   return true;
+}
+
+/**
+ * @param[in] InputData datos de cada banda de entrada
+ * @param[out] OutputData datos de cada tabla
+ * @param[in] PixelCount cantidad de pixeles
+ */
+void LutRenderer::ApplyPixels(std::vector<void*> &InputData,
+                              std::vector<void*> &OutputData, size_t PixelCount) {
+   if (pixelInputBands_.empty()) {
+      for (size_t b = 0; b < InputData.size(); b++)
+         memcpy(OutputData[b], InputData[b], PixelCount * pixelDataSize_);
+      return;
+   }
+   for (size_t i = 0; i < pixelInputBands_.size(); i++)
+      ApplyTable(static_cast<int>(i), OutputData[i], InputData[pixelInputBands_[i]],
+                 PixelCount);
+}
+
+/**
+ *  Usa la tabla densa si el tipo de dato la admite y sino busca cada pixel
+ * en la tabla.
+ * @param[in] Index indice de la LUT
+ * @param[out] pDest datos de salida (puede ser igual a pSrc)
+ * @param[in] pSrc datos de entrada
+ * @param[in] Size cantidad de pixeles
+ */
+void LutRenderer::ApplyTable(int Index, void *pDest, void *pSrc, size_t Size) const {
+   if (parameters_.denseLuts_[Index].IsValid()) {
+      parameters_.denseLuts_[Index].Apply(pDest, pSrc, Size);
+   } else {
+      parameters_.pFunction_(pDest, pSrc, Size, parameters_.tables_[Index]);
+   }
 }
 
 /**
@@ -324,7 +459,8 @@ LutRenderer::Parameters LutRenderer::GetParameters(const wxXmlNode *pNode) {
 
 /**
  * Verifica que exista nodo LUT en nodo de elemento y carga en params funcion
- * del tipo correcto
+ * del tipo correcto. Ademas prepara las tablas (y las tablas densas para
+ * tipos de 8 y 16 bits) para no hacerlo en cada renderizacion.
  * @param[out] Params carga la funcion de mapeo del tipo correcto
  * @param[in] pElement elemento en el que busca el nodo LUT
  * @param[in] pPreviousRenderer renderer anterior
@@ -339,6 +475,19 @@ bool LutRenderer::LoadFunction(Parameters &Params, Element* pElement, Renderer *
       REPORT_ERROR("D:Tipo de dato (%s) no manejado", NULL, datatype.c_str());
       return false;
    }
+   // Preparo las tablas una vez (y las densas si el tipo de dato lo permite)
+   int inputband = 0;
+   Params.tables_.resize(Params.lut_.GetCount());
+   Params.denseLuts_.resize(Params.lut_.GetCount());
+   for (int i = 0; i < Params.lut_.GetCount(); i++) {
+      Params.lut_.GetLookUpTable(i, inputband).GetTable(Params.tables_[i]);
+      PrepareTable(Params.tables_[i]);
+      if (DenseLut::IsSupported(datatype)) {
+         Params.denseLuts_[i].Build(datatype, LutTableFunction(Params.tables_[i]));
+      } else {
+         Params.denseLuts_[i].Clear();
+      }
+   }
    return true;
 }
 
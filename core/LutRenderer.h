@@ -34,8 +34,10 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes suri
 #include "suri/Renderer.h"
+#include "PixelRenderer.h"
 #include "RgbColor.h"
 #include "suri/LutArray.h"
+#include "DenseLut.h"
 
 // defines
 
@@ -48,8 +50,9 @@ class Element;
  * Genera una imagen aplicandole una tabla a las bandas de la entrada.
  * La imagen resultante puede tener menos bandas que la original pero
  * no pueden haber bandas sin tabla asignada.
+ * \note hereda de PixelRenderer para fusionarse con otras etapas por pixel
  */
-class LutRenderer : public Renderer {
+class LutRenderer : public Renderer, public PixelRenderer {
    /** Ctor. de Copia. */
    LutRenderer(const LutRenderer &LutRenderer);
 
@@ -66,9 +69,12 @@ public:
       Parameters() {
       }
       /** tipo de dato para la funcion de la lut */
-      typedef void (*LutFunctionType)(void*, void*, size_t, std::map<double, double>);
+      typedef void (*LutFunctionType)(void*, void*, size_t,
+                                      const std::map<double, double>&);
       LutArray lut_; /*! Tabla con lut que uso para renderizar */
       LutFunctionType pFunction_; /*! tipo de funcion */
+      std::vector<LookUpTable::LutType> tables_; /*! Tablas preparadas (LoadFunction) */
+      std::vector<DenseLut> denseLuts_; /*! Tablas densas (8 y 16 bits) */
    };
 
 // ------------------- METODOS ESTATICOS DE CONVERSION ----------------------
@@ -84,6 +90,16 @@ public:
 // ----------------------- METODOS DE RENDERIZACION -------------------------
    /** Renderiza el elemento dado un World en un Canvas */
    virtual bool Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pMask);
+   /** Renderiza el renderizador anterior */
+   virtual bool RenderInput(const World *pWorldWindow, Canvas *pCanvas, Mask *pMask);
+   /** Aplica las tablas a todo el canvas */
+   virtual bool ProcessCanvas(Canvas *pCanvas);
+   /** Obtiene las tablas para aplicarlas por pixel */
+   virtual bool PreparePixels(int InputBandCount, const std::string &InputDataType,
+                              int &OutputBandCount, std::string &OutputDataType);
+   /** Aplica las tablas a un tramo de pixeles */
+   virtual void ApplyPixels(std::vector<void*> &InputData,
+                            std::vector<void*> &OutputData, size_t PixelCount);
    /** Obtiene el "bounding box" del elemento renderizado */
    virtual void GetBoundingBox(const World *pWorld, double &Ulx, double &Uly,
                                double &Lrx, double &Lry);
@@ -106,11 +122,18 @@ protected:
    static bool LoadFunction(Parameters &params, Element* pElement,
                             Renderer *pPreviousRenderer);
 
+   /** Aplica una de las tablas a un buffer */
+   void ApplyTable(int Index, void *pDest, void *pSrc, size_t Size) const;
+
    /** Cambia el contenido de parametres y verifica su contenido */
    static bool ValidateTable(const Parameters &Params, Renderer *pPreviousRenderer);
 
    LutRenderer::Parameters parameters_; /*! Guarda informacion necesaria */
    /* para aplicar Render */
+
+private:
+   std::vector<int> pixelInputBands_; /*! Banda de entrada de cada tabla */
+   size_t pixelDataSize_; /*! Tamanio del dato si ApplyPixels solo copia */
 };
 
 bool SetNewLutNode(Element* pElement, wxXmlNode *pRenderizationNode,
@@ -33,6 +33,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes suri
 #include "MahalanobisAlgorithm.h"
+#include "ClassificationEngine.h"
 #include "suri/DataTypes.h"
 #include "suri/xmlnames.h"
 #include "MathFunctions.h"
@@ -44,159 +45,135 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 namespace suri {
 AUTO_REGISTER_CLASS(ClassificationAlgorithmInterface, MahalanobisAlgorithm, 0)
 
-/** Funcion clasificacion */
-typedef void (*ClassMappingFunctionType)(int*, std::vector<void*>&, size_t,
-                                         int NoClassPixelValue, int NDVPixelValue,
-                                         double Ndv, bool NdvAvailable,
-                                         double Threshold, Clusters* pClusters);
-
-
+/** Nucleo de clasificacion por distancia de Mahalanobis */
 /**
- * Clasifica las bandas de entrada usando metodo de distancia minima
- * @param[out] pDest banda donde se guardan las clases asignadas(ints)
- * @param[in] pSource bandas de entrada que se usan para clasificar
- * @param[in] Size cantidad de valores (pixeles) de la banda
- * @param[in] NoClassPixelValue valor asignado a los pixels no clasificados
- * @param[in] Threshold umbral a partir del cual un pixel no se asigna a una
- * clase. Valores entre 0 y 1.
- * @param[in] pClusters Estadisticas de las clases que se usan para clasificar
- * los pixels.
+ * Precalcula la matriz LU de la covarianza comun a todas las clases y para
+ * cada clase evalua la distancia de todos los pixeles del tile (ver
+ * CalculateLuQuadraticForm).
  */
-template<typename T>
-void mahalanobis(int* pDest, std::vector<void*> &pSource, size_t Size,
-                 int NoClassPixelValue, int NDVPixelValue, double Ndv,
-                 bool NdvAvailable, double Threshold, Clusters* pClusters) {
-   int sourcesize = pSource.size();
-   std::vector<T*> psrc;
-   for (int i = 0; i < sourcesize; i++)
-      psrc.push_back(static_cast<T*>(pSource[i]));
-
-   const std::vector<Clusters::ClusterData>& clusters = pClusters->GetClusterVector();
-   int classcount = clusters.size();
-//   int matrixsize = clusters[0].statistics_.mean_.size();
-   int matrixsize = clusters[0].pStatistics_->GetBandCount();
-   // Calculo cantidad de pixels en todas las clases.
-   int classpixelssum = 0;
-   for (int classpos = 0; classpos < classcount; classpos++)
-      classpixelssum += clusters[classpos].pStatistics_->pPointCount_[0];
-
-   // Inicializo matriz de covarianza
-   std::vector<std::vector<double> > covariancematrix;
-   for (int i = 0; i < matrixsize; i++) {
-      covariancematrix.push_back(std::vector<double>(matrixsize));
-      for (int j = 0; j < matrixsize; j++)
-         covariancematrix[i][j] = 0;
-   }
+class MahalanobisKernel : public ClassificationKernel {
+public:
+   /**
+    * @param[in] NoClassPixelValue valor asignado a los pixels no clasificados
+    * @param[in] Threshold distancia maxima para asignar un pixel a una clase
+    * @param[in] pClusters Estadisticas de las clases que se usan para clasificar
+    * los pixels.
+    */
+   MahalanobisKernel(int NoClassPixelValue, double Threshold, Clusters* pClusters) :
+         noClassPixelValue_(NoClassPixelValue), threshold_(Threshold * Threshold),
+         matrixsize_(0) {
+      const std::vector<Clusters::ClusterData>& clusters = pClusters->GetClusterVector();
+      int classcount = clusters.size();
+      if (classcount == 0)
+         return;
+      int matrixsize = clusters[0].pStatistics_->GetBandCount();
+      matrixsize_ = matrixsize;
+      for (int classpos = 0; classpos < classcount; classpos++) {
+         classIds_.push_back(clusters[classpos].classId_);
+         means_.push_back(std::vector<double>(
+               clusters[classpos].pStatistics_->pMean_,
+               clusters[classpos].pStatistics_->pMean_ + matrixsize));
+      }
 
-   // Calculo la matriz de covarianza comun a todas las clases
-   for (int classpos = 0; classpos < classcount; classpos++) {
-      // Se calcula la pooled variance de las matrices. Ver TCK #873
-      double factor = (static_cast<double>(clusters[classpos].pStatistics_->pPointCount_[0]) - 1)
-            / (classpixelssum - classcount);
-      std::vector < std::vector<double> > classcovmatrix =
-            clusters[classpos].pStatistics_->GetCovarianceMatrix();
-      for (int i = 0; i < matrixsize; i++)
+      // Calculo cantidad de pixels en todas las clases.
+      int classpixelssum = 0;
+      for (int classpos = 0; classpos < classcount; classpos++)
+         classpixelssum += clusters[classpos].pStatistics_->pPointCount_[0];
+
+      // Inicializo matriz de covarianza
+      std::vector<std::vector<double> > covariancematrix;
+      for (int i = 0; i < matrixsize; i++) {
+         covariancematrix.push_back(std::vector<double>(matrixsize));
          for (int j = 0; j < matrixsize; j++)
-            covariancematrix[i][j] = covariancematrix[i][j]
-                  + factor * classcovmatrix[i][j];
-   }
+            covariancematrix[i][j] = 0;
+      }
 
-   // Calculo la matriz lu
-   std::vector<std::vector<double> > lumatrix;
-   CalculateLu(covariancematrix, lumatrix);
+      // Calculo la matriz de covarianza comun a todas las clases
+      for (int classpos = 0; classpos < classcount; classpos++) {
+         // Se calcula la pooled variance de las matrices. Ver TCK #873
+         double factor = (static_cast<double>(clusters[classpos].pStatistics_->pPointCount_[0]) - 1)
+               / (classpixelssum - classcount);
+         std::vector < std::vector<double> > classcovmatrix =
+               clusters[classpos].pStatistics_->GetCovarianceMatrix();
+         for (int i = 0; i < matrixsize; i++)
+            for (int j = 0; j < matrixsize; j++)
+               covariancematrix[i][j] = covariancematrix[i][j]
+                     + factor * classcovmatrix[i][j];
+      }
 
-#ifdef __OLD_DEBUG__
-   // Msgs con informacion de matriz de covarianza.
-   for (int i = 0; i < matrixsize; i++)
-      for (int j = 0; j < matrixsize; j++)
-         REPORT_DEBUG("cov_mat_first_trainning_area[%d, %d]: %f", i, j,
-                      clusters[0].statistics_.covarianceMatrix_[i][j]);
-
-   REPORT_DEBUG("PIXEL COUNT first trainning area: %d", clusters[0].statistics_.count_);
-
-   for (int i = 0; i < matrixsize; i++)
-      for (int j = 0; j < matrixsize; j++)
-         REPORT_DEBUG("mahalanobis_cov_mat[%d, %d]: %f", i, j, covariancematrix[i][j]);
-
-   for (int i = 0; i < matrixsize; i++)
-      for (int j = 0; j < matrixsize; j++)
-         REPORT_DEBUG("descomposicion lu de mahalanobis_cov_mat[%d, %d]: %f", i, j,
-                      lumatrix[i][j]);
-#endif
+      // Calculo la matriz lu
+      CalculateLu(covariancematrix, lumatrix_);
 
-   double threshold = Threshold;
-   threshold = threshold * threshold;
+#ifdef __OLD_DEBUG__
+      // Msgs con informacion de matriz de covarianza.
+      for (int i = 0; i < matrixsize; i++)
+         for (int j = 0; j < matrixsize; j++)
+            REPORT_DEBUG("cov_mat_first_trainning_area[%d, %d]: %f", i, j,
+                         clusters[0].statistics_.covarianceMatrix_[i][j]);
 
-   std::vector<double> pixelvalues(matrixsize);
-   std::vector<double> partialinverse(matrixsize);
-   std::vector<double> inverse(matrixsize);
+      REPORT_DEBUG("PIXEL COUNT first trainning area: %d", clusters[0].statistics_.count_);
 
-   // Para cada pixel en la imagen
-   for (size_t pixelposition = 0; pixelposition < Size; pixelposition++) {
-      // La clase default es sin clase
-      int pixelclass = NoClassPixelValue;
+      for (int i = 0; i < matrixsize; i++)
+         for (int j = 0; j < matrixsize; j++)
+            REPORT_DEBUG("mahalanobis_cov_mat[%d, %d]: %f", i, j, covariancematrix[i][j]);
 
-      bool invalidpixel = true;
+      for (int i = 0; i < matrixsize; i++)
+         for (int j = 0; j < matrixsize; j++)
+            REPORT_DEBUG("descomposicion lu de mahalanobis_cov_mat[%d, %d]: %f", i, j,
+                         lumatrix_[i][j]);
+#endif
+   }
 
-      // Salida para pixel no valido.
-      // (valor no valido en todas las bandas involucradas)
-      // Ver TCK #7325
-      if (NdvAvailable) {
-         for (int i = 0; i < matrixsize && invalidpixel; ++i) {
-            if (static_cast<double>(psrc[i][pixelposition]) != CLASSIFICATION_NDV)
-               invalidpixel = false;
-         }
-      } else {
-         invalidpixel = false;
-      }
+   /** Cantidad de bandas que usan las estadisticas */
+   virtual int GetBandCount() const {
+      return matrixsize_;
+   }
 
-      // Si el pixel es valido hago el proc normal.
-      if (invalidpixel == false) {
-         double pixelclassdistance = std::numeric_limits<double>::max();
-
-         // Para cada clase
-         for (int classpos = 0; classpos < classcount; classpos++) {
-            // Le resto a cada pixel la media
-            for (int i = 0; i < matrixsize; i++)
-               pixelvalues[i] = static_cast<double>(psrc[i][pixelposition])
-                     - clusters[classpos].pStatistics_->pMean_[i];
-
-            // Calculo v en y=Lv
-            for (int i = 0; i < matrixsize; i++) {
-               partialinverse[i] = pixelvalues[i];
-               for (int j = 0; j < i; j++)
-                  partialinverse[i] -= partialinverse[j] * lumatrix[i][j];
-            }
-            // Calculo x en v=Ux
-            for (int i = matrixsize - 1; i >= 0; i--) {
-               inverse[i] = partialinverse[i];
-               for (int j = matrixsize - 1; j > i; j--)
-                  inverse[i] -= inverse[j] * lumatrix[i][j];
-               inverse[i] = inverse[i] / lumatrix[i][i];
-            }
+   /** Espacio para CalculateLuQuadraticForm, la distancia y la mejor distancia */
+   virtual int GetWorkspaceSize() const {
+      return 2 * matrixsize_ + 2;
+   }
 
-            // Calculo la probabilidad que el pixel sea de la clase classpos
-            double classdistance = 0;
-            for (int i = 0; i < matrixsize; i++)
-               classdistance += inverse[i] * pixelvalues[i];
+   /**
+    * Asigna a cada pixel la clase mas cercana que este dentro del umbral.
+    * @param[in] pTile valores del tile (pTile[b * Count + p])
+    * @param[in] Count cantidad de pixeles del tile
+    * @param[in] pWorkspace doubles auxiliares
+    * @param[out] pDest clase asignada a cada pixel
+    */
+   virtual void ClassifyTile(const double* pTile, size_t Count, double* pWorkspace,
+                             int* pDest) const {
+      double* pdistance = pWorkspace + 2 * matrixsize_ * Count;
+      double* pclassdistance = pdistance + Count;
+      for (size_t p = 0; p < Count; p++) {
+         pDest[p] = noClassPixelValue_;
+         pclassdistance[p] = std::numeric_limits<double>::max();
+      }
 
+      // Para cada clase
+      int classcount = classIds_.size();
+      for (int classpos = 0; classpos < classcount; classpos++) {
+         CalculateLuQuadraticForm(pTile, Count, &means_[classpos][0], lumatrix_,
+                                  pWorkspace, pdistance);
+         int classid = classIds_[classpos];
+         for (size_t p = 0; p < Count; p++) {
             // Comparo la ultima clase asignada y el threashold
-            if (classdistance < threshold && classdistance < pixelclassdistance) {
-               pixelclass = clusters[classpos].classId_;
-               pixelclassdistance = classdistance;
+            if (pdistance[p] < threshold_ && pdistance[p] < pclassdistance[p]) {
+               pDest[p] = classid;
+               pclassdistance[p] = pdistance[p];
             }
          }
-      } else {
-         // Sino le pongo un valor para la parte de la imagen que no
-         // es valida.
-         pixelclass = NDVPixelValue;
       }
-      pDest[pixelposition] = pixelclass;
    }
-}
-/** Inicializa mapa de tipos de datos. */
-INITIALIZE_DATATYPE_MAP(ClassMappingFunctionType, mahalanobis);
 
+private:
+   int noClassPixelValue_; /*! valor de los pixels no clasificados */
+   double threshold_; /*! cuadrado del umbral */
+   int matrixsize_; /*! cantidad de bandas */
+   std::vector<int> classIds_; /*! id de cada clase */
+   std::vector<std::vector<double> > means_; /*! media de cada clase */
+   std::vector<std::vector<double> > lumatrix_; /*! LU de la covarianza comun */
+};
 
 /** Ctor */
 MahalanobisAlgorithm::MahalanobisAlgorithm() :
@@ -208,7 +185,7 @@ MahalanobisAlgorithm::~MahalanobisAlgorithm() {
 }
 
 /**
- * Llama algoritmo de clasificacion de tipo de dato correcto
+ * Precalcula los parametros de las clases y clasifica con ClassificationEngine
  * @param[out] pDest datos clasificados
  * @param[in] pSource fuente de datos a clasificar
  * @param[in] Size cantidad de datos a clasificar
@@ -216,10 +193,10 @@ MahalanobisAlgorithm::~MahalanobisAlgorithm() {
  */
 bool MahalanobisAlgorithm::Classify(int* pDest, std::vector<void*> pSource,
                                     size_t Size, const std::string &DataType) {
-   ClassMappingFunctionType function = mahalanobisTypeMap[DataType];
-   function(pDest, pSource, Size, GetNoClassPixelValue(), GetNDVPixelValue(),
-            GetNoDataValue(), IsNoDataValueAvailable(), GetThreshold(), GetClusters());
-   return true;
+   MahalanobisKernel kernel(GetNoClassPixelValue(), GetThreshold(), GetClusters());
+   ClassificationEngine engine;
+   return engine.Classify(kernel, pDest, pSource, Size, DataType,
+                          IsNoDataValueAvailable(), GetNDVPixelValue());
 }
 
 /**
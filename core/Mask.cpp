@@ -32,6 +32,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes suri
 #include "Mask.h"
+#include "CanvasBandBuffers.h"
 #include "suri/messages.h"
 #include "suri/DataTypes.h"
 
@@ -138,7 +139,6 @@ void Mask::SetDataType(const std::string& DataType) {
  *
  * \pre Los canvas deben ser iguales.
  * \post El contenido de pTarget se modifica solo en los pixeles cuyo valor
- * \todo Realizar enmascaramiento in-place (sin copiar datos)
  *       en la mascara es distinto de 0, el resto resultan inalterados.
  * @param[in] pSource canvas de lectura de datos.
  * @param[out] pTarget canvas destino de los datos enmascarados.
@@ -155,7 +155,7 @@ void Mask::ApplyMask(Canvas *pSource, Canvas *pTarget) const {
       REPORT_AND_RETURN(
             "D:La operacion de mascara requiere dos canvas del mismo tipo.");
    }
-   int x, y, s = pSource->GetDataSize();
+   int x, y;
    pSource->GetSize(x, y);
    int u, v;
    GetSize(u, v);
@@ -164,18 +164,12 @@ void Mask::ApplyMask(Canvas *pSource, Canvas *pTarget) const {
                         x, y, u, v);
    }
    int count = pSource->GetBandCount();
-   int size = x * y;
-   std::vector<void*> source;
    std::vector<int> idx(count);
-   for (int i = 0; i < count; i++) {
-      source.push_back(new unsigned char[size * s]);
-      idx[i] = i;
-   }
-   pSource->Read(idx, source);
-
-   ApplyMask(idx, source, pTarget);
    for (int i = 0; i < count; i++)
-      delete[] static_cast<unsigned char*>(source[i]);
+      idx[i] = i;
+   // si el origen presta sus buffers se evita la copia
+   CanvasBandBuffers source(pSource, idx);
+   ApplyMask(idx, source.GetData(), pTarget);
 }
 
 /** Escribe los datos al canvas usando la mascara */
@@ -194,12 +188,11 @@ void Mask::ApplyMask(std::vector<int> &BandIndex, std::vector<void*> &SourceData
    if (BandIndex.size() != SourceData.size()) {
       REPORT_AND_FAIL("D: Inconsistencia entre los datos");
    }
-   std::vector<void*> targetdata(BandIndex.size(), NULL);
    int x = 0, y = 0;
    pTarget->GetSize(x, y);
-   for (int b = 0; b < pTarget->GetBandCount(); b++)
-      targetdata[b] = new unsigned char[x * y * pTarget->GetDataSize()];
-   pTarget->Read(BandIndex, targetdata);
+   // si el destino presta sus buffers se escribe directamente sobre ellos
+   CanvasBandBuffers target(pTarget, BandIndex);
+   std::vector<void*> &targetdata = target.GetData();
    // Deberia funcionar pero siempre deja todo negro.
 #ifdef __UNUSED_CODE__
    std::vector<void*> mask;
@@ -213,16 +206,15 @@ void Mask::ApplyMask(std::vector<int> &BandIndex, std::vector<void*> &SourceData
    }
 #else  // __UNUSED_CODE__
    // \todo remover el uso de la primera banda de la mascara
-   for (int i = 0; i < pTarget->GetBandCount(); i++) {
+   for (size_t i = 0; i < BandIndex.size(); i++) {
       unsigned char *pmaskbuffer = static_cast<unsigned char*>(GetBand(0)->GetBlock(0,
                                                                                     0));
       memmaskcpyTypeMap[pTarget->GetDataType()](SourceData[i], targetdata[i],
                                                 pmaskbuffer, x * y, IsNoDataValueAvailable(),
                                                 GetNoDataValue());
+      GetBand(0)->ReleaseBlock(0, 0);
    }
 #endif  // __UNUSED_CODE__
-   pTarget->Write(BandIndex, targetdata, NULL);
-   for (int b = 0; b < pTarget->GetBandCount(); b++)
-      delete[] static_cast<unsigned char*>(targetdata[b]);
+   target.Commit();
 }
 }
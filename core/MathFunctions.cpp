@@ -79,4 +79,67 @@ void CalculateLu(const std::vector<std::vector<double> > Matrix,
    }
 }
 
+/**
+ * Calcula (x - m)^t A^-1 (x - m) para un tile de pixeles resolviendo con la
+ * matriz LU de A (ver CalculateLu). Primero resuelve v en (x - m) = Lv y
+ * luego y en v = Uy, banda por banda y para todos los pixeles del tile.
+ * @param[in] pValues valores del tile, pValues[b * Count + p]
+ * @param[in] Count cantidad de pixeles del tile
+ * @param[in] pMean media (m)
+ * @param[in] Lu matriz LU de A
+ * @param[out] pWorkspace 2 * Lu.size() * Count doubles auxiliares
+ * @param[out] pResult forma cuadratica de cada pixel
+ */
+void CalculateLuQuadraticForm(const double* pValues, size_t Count, const double* pMean,
+                              const std::vector<std::vector<double> > &Lu,
+                              double* pWorkspace, double* pResult) {
+   int matrixsize = Lu.size();
+   double* pdifference = pWorkspace;
+   double* pinverse = pWorkspace + matrixsize * Count;
+
+   // Le resto a cada pixel la media
+   for (int i = 0; i < matrixsize; i++) {
+      const double* pvalue = pValues + i * Count;
+      double* pdiff = pdifference + i * Count;
+      double mean = pMean[i];
+      for (size_t p = 0; p < Count; p++)
+         pdiff[p] = pvalue[p] - mean;
+   }
+   // Calculo v en y=Lv
+   for (int i = 0; i < matrixsize; i++) {
+      double* pinv = pinverse + i * Count;
+      const double* pdiff = pdifference + i * Count;
+      for (size_t p = 0; p < Count; p++)
+         pinv[p] = pdiff[p];
+      for (int j = 0; j < i; j++) {
+         const double* pprevious = pinverse + j * Count;
+         double factor = Lu[i][j];
+         for (size_t p = 0; p < Count; p++)
+            pinv[p] -= pprevious[p] * factor;
+      }
+   }
+   // Calculo x en v=Ux
+   for (int i = matrixsize - 1; i >= 0; i--) {
+      double* pinv = pinverse + i * Count;
+      for (int j = matrixsize - 1; j > i; j--) {
+         const double* pnext = pinverse + j * Count;
+         double factor = Lu[i][j];
+         for (size_t p = 0; p < Count; p++)
+            pinv[p] -= pnext[p] * factor;
+      }
+      double diagonal = Lu[i][i];
+      for (size_t p = 0; p < Count; p++)
+         pinv[p] = pinv[p] / diagonal;
+   }
+   // Acumulo el producto escalar en el orden de las bandas
+   for (size_t p = 0; p < Count; p++)
+      pResult[p] = 0;
+   for (int i = 0; i < matrixsize; i++) {
+      const double* pinv = pinverse + i * Count;
+      const double* pdiff = pdifference + i * Count;
+      for (size_t p = 0; p < Count; p++)
+         pResult[p] += pinv[p] * pdiff[p];
+   }
+}
+
 }  // namespace suri
@@ -30,6 +30,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes standard
 #include <vector>
+#include <cstddef>
 
 namespace suri {
 
@@ -42,6 +43,23 @@ namespace suri {
 void CalculateLu(const std::vector<std::vector<double> > Matrix,
                                     std::vector<std::vector<double> > &Lu);
 
+/**
+ * Calcula (x - m)^t A^-1 (x - m) para un tile de pixeles resolviendo con la
+ * matriz LU de A. Los valores de cada banda son contiguos (pValues[b * Count + p])
+ * y las operaciones se aplican a todo el tile a la vez para que el compilador
+ * pueda vectorizarlas; para cada pixel el orden de las operaciones es el mismo
+ * que al resolver pixel por pixel.
+ * @param[in] pValues valores del tile
+ * @param[in] Count cantidad de pixeles del tile
+ * @param[in] pMean media (m)
+ * @param[in] Lu matriz LU de A
+ * @param[out] pWorkspace 2 * Lu.size() * Count doubles auxiliares
+ * @param[out] pResult forma cuadratica de cada pixel
+ */
+void CalculateLuQuadraticForm(const double* pValues, size_t Count, const double* pMean,
+                              const std::vector<std::vector<double> > &Lu,
+                              double* pWorkspace, double* pResult);
+
 }  // namespace suri
 
 
@@ -31,6 +31,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include <vector>
 
 #include "MaxLikelihoodAlgorithm.h"
+#include "ClassificationEngine.h"
 #include "MathFunctions.h"
 #include "suri/DataTypes.h"
 #include "suri/StatisticsFunctions.h"
@@ -44,133 +45,109 @@ namespace suri {
 /** Macro para registrar el tipo de algoritmo de clasificacion de forma automatica */
 AUTO_REGISTER_CLASS(ClassificationAlgorithmInterface, MaxLikelihoodAlgorithm, 0)
 
-/** Funcion clasificacion */
-typedef void (*ClassMappingFunctionType)(int*, std::vector<void*>&, size_t,
-                                         int NoClassPixelValue, int NDVPixelValue,
-                                         double Ndv, bool NdvAvailable,
-                                         double Threshold, Clusters* pClusters);
-
-/** Template MaxLikelihood */
+/** Nucleo de clasificacion por maxima verosimilitud */
 /**
- * Clasifica las bandas de entrada usando metodo de maxima verosimilitud
- * @param[out] pDest banda donde se guardan las clases asignadas(ints)
- * @param[in] pSource bandas de entrada que se usan para clasificar
- * @param[in] Size cantidad de valores (pixeles) de la banda
- * @param[in] NoClassPixelValue valor asignado a los pixels no clasificados
- * @param[in] Threshold umbral a partir del cual un pixel no se asigna a una
- * clase. Valores entre 0 y 1.
- * @param[in] pClusters Estadisticas de las clases que se usan para clasificar
- * los pixels.
+ * Precalcula la matriz LU de la covarianza y la constante de cada clase.
+ * Para cada clase evalua la distancia de Mahalanobis de todos los pixeles del
+ * tile (ver CalculateLuQuadraticForm) y asigna la clase de mayor probabilidad.
  */
-template<typename T>
-void maxlikelihood(int* pDest, std::vector<void*> &pSource, size_t Size,
-                   int NoClassPixelValue, int NDVPixelValue, double Ndv,
-                   bool NdvAvailable, double Threshold, Clusters* pClusters) {
-   int sourcesize = pSource.size();
-   std::vector<T*> psrc;
-   for (int i = 0; i < sourcesize; i++)
-      psrc.push_back(static_cast<T*>(pSource[i]));
-
-   const std::vector<Clusters::ClusterData>& clusters = pClusters->GetClusterVector();
-   int classcount = clusters.size();
-
-   double threshold = log(Threshold / 100);
-
-   // Calculo matrix LU usando las estadisticas.
-   std::vector < std::vector<std::vector<double> > > lumatrices(classcount);
-   for (int i = 0; i < classcount; i++) {
-      CalculateLu(clusters[i].pStatistics_->GetCovarianceMatrix(),
-                  lumatrices[i]);
-   }
-   // Genero vectores que se usan en algoritmo
-   int matrixsize = clusters[0].pStatistics_->GetBandCount();
-   std::vector<double> pixelvalues(matrixsize);
-   std::vector<double> partialinverse(matrixsize);
-   std::vector<double> inverse(matrixsize);
-
-   // Calculo las constantes de las clases
-   std::vector<double> constants(classcount);
-   for (int classpos = 0; classpos < classcount; classpos++) {
-      // Calculo el determinante de la matriz lu
-      double determinant = lumatrices[classpos][0][0];
-      for (int j = 1; j < matrixsize; j++)
-         determinant *= lumatrices[classpos][j][j];
-
-      // Calculo la constante de la clase
-      constants[classpos] = -log(classcount) - log(determinant) / 2 -
-                                          classcount / 2 * log(2 * PI);
+class MaxLikelihoodKernel : public ClassificationKernel {
+public:
+   /**
+    * @param[in] NoClassPixelValue valor asignado a los pixels no clasificados
+    * @param[in] Threshold umbral a partir del cual un pixel no se asigna a una
+    * clase. Valores entre 0 y 100.
+    * @param[in] pClusters Estadisticas de las clases que se usan para clasificar
+    * los pixels.
+    */
+   MaxLikelihoodKernel(int NoClassPixelValue, double Threshold, Clusters* pClusters) :
+         noClassPixelValue_(NoClassPixelValue), threshold_(log(Threshold / 100)),
+         matrixsize_(0) {
+      const std::vector<Clusters::ClusterData>& clusters = pClusters->GetClusterVector();
+      int classcount = clusters.size();
+      if (classcount == 0)
+         return;
+      matrixsize_ = clusters[0].pStatistics_->GetBandCount();
+
+      // Calculo matrix LU usando las estadisticas.
+      lumatrices_.resize(classcount);
+      means_.resize(classcount);
+      constants_.resize(classcount);
+      for (int classpos = 0; classpos < classcount; classpos++) {
+         classIds_.push_back(clusters[classpos].classId_);
+         means_[classpos].assign(clusters[classpos].pStatistics_->pMean_,
+                                 clusters[classpos].pStatistics_->pMean_ + matrixsize_);
+         CalculateLu(clusters[classpos].pStatistics_->GetCovarianceMatrix(),
+                     lumatrices_[classpos]);
+
+         // Calculo el determinante de la matriz lu
+         double determinant = lumatrices_[classpos][0][0];
+         for (int j = 1; j < matrixsize_; j++)
+            determinant *= lumatrices_[classpos][j][j];
+
+         // Calculo la constante de la clase
+         constants_[classpos] = -log(classcount) - log(determinant) / 2 -
+                                             classcount / 2 * log(2 * PI);
+      }
    }
 
-   // Para cada pixel en la imagen
-   for (int pixelposition = 0; pixelposition < (int) Size; pixelposition++) {
-      // La clase default es sin clase
-      int pixelclass = NoClassPixelValue;
+   /** Cantidad de bandas que usan las estadisticas */
+   virtual int GetBandCount() const {
+      return matrixsize_;
+   }
 
-      bool invalidpixel = true;
+   /** Espacio para CalculateLuQuadraticForm, la distancia y la mejor probabilidad */
+   virtual int GetWorkspaceSize() const {
+      return 2 * matrixsize_ + 2;
+   }
 
-      // Salida para pixel no valido.
-      // (valor no valido en todas las bandas involucradas)
-      // Ver TCK #7325
-      if (NdvAvailable) {
-         for (int i = 0; i < matrixsize && invalidpixel; ++i) {
-            if (static_cast<double>(psrc[i][pixelposition]) != CLASSIFICATION_NDV)
-               invalidpixel = false;
-         }
-      }  else {
-         invalidpixel = false;
+   /**
+    * Asigna a cada pixel la clase con mayor probabilidad que supere el umbral.
+    * @param[in] pTile valores del tile (pTile[b * Count + p])
+    * @param[in] Count cantidad de pixeles del tile
+    * @param[in] pWorkspace doubles auxiliares
+    * @param[out] pDest clase asignada a cada pixel
+    */
+   virtual void ClassifyTile(const double* pTile, size_t Count, double* pWorkspace,
+                             int* pDest) const {
+      double* pdistance = pWorkspace + 2 * matrixsize_ * Count;
+      double* pprobability = pdistance + Count;
+      for (size_t p = 0; p < Count; p++) {
+         pDest[p] = noClassPixelValue_;
+         pprobability[p] = -std::numeric_limits<double>::max();
       }
 
-      // Si el pixel es valido hago el proc normal.
-      if (invalidpixel == false) {
-         double pixelclassprobability = -std::numeric_limits<double>::max();
-
-         // Para cada clase
-         for (int classpos = 0; classpos < classcount; classpos++) {
-            // Le resto a cada pixel la media
-            for (int i = 0; i < matrixsize; i++) {
-               pixelvalues[i] = static_cast<double>(psrc[i][pixelposition])
-                                      - clusters[classpos].pStatistics_->pMean_[i];
-            }
-            // Calculo v en y=Lv
-            for (int i = 0; i < matrixsize; i++) {
-               partialinverse[i] = pixelvalues[i];
-               for (int j = 0; j < i; j++)
-                  partialinverse[i] -= partialinverse[j]
-                                      * lumatrices[classpos][i][j];
-            }
-            // Calculo x en v=Ux
-            for (int i = matrixsize - 1; i >= 0; i--) {
-               inverse[i] = partialinverse[i];
-               for (int j = matrixsize - 1; j > i; j--)
-                  inverse[i] -= inverse[j] * lumatrices[classpos][i][j];
-               inverse[i] = inverse[i] / lumatrices[classpos][i][i];
-            }
-
+      // Para cada clase
+      int classcount = classIds_.size();
+      for (int classpos = 0; classpos < classcount; classpos++) {
+         CalculateLuQuadraticForm(pTile, Count, &means_[classpos][0],
+                                  lumatrices_[classpos], pWorkspace, pdistance);
+         double constant = constants_[classpos];
+         int classid = classIds_[classpos];
+         for (size_t p = 0; p < Count; p++) {
             // Calculo la probabilidad que el pixel sea de la clase classpos
-            double tempclassprobability = 0;
-            for (int i = 0; i < matrixsize; i++)
-               tempclassprobability += inverse[i] * pixelvalues[i];
-            tempclassprobability = -tempclassprobability / 2;
-            double finalclassprobability = constants[classpos]
-                                           + tempclassprobability;
+            double tempclassprobability = -pdistance[p] / 2;
+            double finalclassprobability = constant + tempclassprobability;
 
             // Comparo la ultima clase asignada y el threashold
-            if (tempclassprobability > threshold
-                  && finalclassprobability > pixelclassprobability) {
-               pixelclass = clusters[classpos].classId_;
-               pixelclassprobability = finalclassprobability;
+            if (tempclassprobability > threshold_
+                  && finalclassprobability > pprobability[p]) {
+               pDest[p] = classid;
+               pprobability[p] = finalclassprobability;
             }
          }
-      } else {
-         // Sino le pongo un valor para la parte de la imagen que no
-         // es valida.
-         pixelclass = NDVPixelValue;
       }
-      pDest[pixelposition] = pixelclass;
    }
-}
-/** Inicializa mapa de tipos de datos. */
-INITIALIZE_DATATYPE_MAP(ClassMappingFunctionType, maxlikelihood);
+
+private:
+   int noClassPixelValue_; /*! valor de los pixels no clasificados */
+   double threshold_; /*! logaritmo del umbral */
+   int matrixsize_; /*! cantidad de bandas */
+   std::vector<int> classIds_; /*! id de cada clase */
+   std::vector<std::vector<double> > means_; /*! media de cada clase */
+   std::vector<std::vector<std::vector<double> > > lumatrices_; /*! LU de cada clase */
+   std::vector<double> constants_; /*! constante de cada clase */
+};
 
 /** Ctor */
 MaxLikelihoodAlgorithm::MaxLikelihoodAlgorithm() :
@@ -183,17 +160,18 @@ MaxLikelihoodAlgorithm::~MaxLikelihoodAlgorithm() {
 
 
 /**
- * Determina el tipo de dato a la entrada del algoritmo
+ * Precalcula los parametros de las clases y clasifica con ClassificationEngine
  * @param[out] pDest datos clasificados
  * @param[in] pSource fuente de datos a clasificar
  * @param[in] Size cantidad de datos a clasificar
+ * @param[in] DataType tipo de dato en imagen a clasificar
  */
 bool MaxLikelihoodAlgorithm::Classify(int* pDest, std::vector<void*> pSource,
                                     size_t Size, const std::string &DataType) {
-   ClassMappingFunctionType function = maxlikelihoodTypeMap[DataType];
-   function(pDest, pSource, Size, GetNoClassPixelValue(), GetNDVPixelValue(),
-            GetNoDataValue(), IsNoDataValueAvailable(), GetThreshold(), GetClusters());
-   return true;
+   MaxLikelihoodKernel kernel(GetNoClassPixelValue(), GetThreshold(), GetClusters());
+   ClassificationEngine engine;
+   return engine.Classify(kernel, pDest, pSource, Size, DataType,
+                          IsNoDataValueAvailable(), GetNDVPixelValue());
 }
 
 /**
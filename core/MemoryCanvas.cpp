@@ -28,6 +28,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 // Includes estandar
 #include <string>
 #include <vector>
+#include <algorithm>
 
 // Includes suri
 #include "MemoryCanvas.h"
@@ -186,6 +187,60 @@ void MemoryCanvas::Write(std::vector<int> &BandIndex, std::vector<void*> &Data,
    }
 }
 
+/** Presta los buffers internos de las bandas para leer/escribir in-place */
+/**
+ *  Cada banda guarda sus datos en un unico bloque del tamanio del canvas, se
+ * prestan esos bloques marcados en uso (el cache de bloques no los elimina).
+ * Se marcan modificados recien al devolverlos con Modified en true, asi los
+ * prestamos de solo lectura no ocupan el presupuesto del cache.
+ * @param[in] BandIndex indice de bandas solicitadas
+ * @param[out] Buffers punteros a los bloques de cada banda
+ * @return false si alguna banda no tiene sus datos en un unico bloque
+ */
+bool MemoryCanvas::GetBandBuffers(std::vector<int> &BandIndex,
+                                  std::vector<void*> &Buffers) {
+   Buffers.clear();
+   int x, y;
+   GetSize(x, y);
+   if (x < 1 || y < 1) {
+      return false;
+   }
+   for (size_t i = 0; i < BandIndex.size(); i++) {
+      if (BandIndex[i] < 0 || BandIndex[i] >= static_cast<int>(bandVector_.size())) {
+         break;
+      }
+      RasterBand *pband = bandVector_[BandIndex[i]];
+      int blockx = 0, blocky = 0;
+      pband->GetBlockSize(blockx, blocky);
+      void *pdata = (blockx == x && blocky == y) ? pband->LockBlock(0, 0) : NULL;
+      if (!pdata) {
+         break;
+      }
+      Buffers.push_back(pdata);
+   }
+   if (Buffers.size() != BandIndex.size()) {
+      // devuelvo los que se llegaron a prestar
+      std::vector<int> locked(BandIndex.begin(), BandIndex.begin() + Buffers.size());
+      ReleaseBandBuffers(locked);
+      Buffers.clear();
+      return false;
+   }
+   return true;
+}
+
+/** Devuelve los buffers prestados por GetBandBuffers */
+/**
+ * @param[in] BandIndex indice de bandas prestadas
+ * @param[in] Modified indica si se escribio en los buffers
+ */
+void MemoryCanvas::ReleaseBandBuffers(std::vector<int> &BandIndex, bool Modified) {
+   for (size_t i = 0; i < BandIndex.size(); i++) {
+      if (BandIndex[i] >= 0 && BandIndex[i] < static_cast<int>(bandVector_.size())) {
+         bandVector_[BandIndex[i]]->UnlockBlock(0, 0, Modified);
+      }
+   }
+}
+
 // ----------------------------- VECTORIAL -----------------------------
 /** Canvas vectorial */
 /**
@@ -340,6 +395,28 @@ void MemoryCanvas::SetBand(RasterBand* pBand, int BandIndex) {
    bandVector_[BandIndex] = pBand;
 }
 
+/**
+ *  Intercambia bandas, tipo de dato y cantidad de bandas sin copiar los
+ * datos. El DC no se intercambia (ambos tienen el mismo tamanio).
+ * @param[in] pOther canvas con el que se intercambian las bandas
+ * @return false si los canvas no tienen el mismo tamanio
+ */
+bool MemoryCanvas::SwapBands(MemoryCanvas *pOther) {
+   if (!pOther) {
+      return false;
+   }
+   int x = 0, y = 0, otherx = 0, othery = 0;
+   GetSize(x, y);
+   pOther->GetSize(otherx, othery);
+   if (x != otherx || y != othery) {
+      return false;
+   }
+   bandVector_.swap(pOther->bandVector_);
+   dataType_.swap(pOther->dataType_);
+   std::swap(bandCount_, pOther->bandCount_);
+   return true;
+}
+
 
 void MemoryCanvas::SetBandCount(int BandCount, bool SaveBands) {
    std::vector<RasterBand*> aux;
@@ -461,6 +538,8 @@ void MemoryCanvas::DeleteBands() {
  * datos.
  * \attention : Los datos apuntados por los punteros pueden cambiar, por lo
  *              que deben ser copiados o utilizados lo antes posible.
+ *  Los bloques quedan marcados en uso en el cache de bloques, por lo que los
+ * punteros son validos hasta que se redimensione o destruya el canvas.
  * @param[in] BandIndex Indices de los datos solicitados
  * @param[out] OutputData Array con punteros a los datos internos
  */
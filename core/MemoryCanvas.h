@@ -73,6 +73,10 @@ public:
    /** Escritura al canvas */
    virtual void Write(std::vector<int> &BandIndex, std::vector<void*> &Data,
                       const Mask *pMask = NULL);
+   /** Presta los buffers internos de las bandas para leer/escribir in-place */
+   virtual bool GetBandBuffers(std::vector<int> &BandIndex, std::vector<void*> &Buffers);
+   /** Devuelve los buffers prestados por GetBandBuffers */
+   virtual void ReleaseBandBuffers(std::vector<int> &BandIndex, bool Modified = false);
 // ----------------------------- VECTORIAL -----------------------------
    /** Canvas vectorial */
    /**
@@ -119,6 +123,8 @@ public:
    virtual RasterBand *GetBand(int BandIndex) const;
    /** Setea una banda deleteando la que habia */
    virtual void SetBand(RasterBand* pBand, int BandIndex);
+   /** Intercambia las bandas con otro canvas del mismo tamanio */
+   bool SwapBands(MemoryCanvas *pOther);
    /** Retorna buffers internos con los datos */
    virtual void GetInternalData(std::vector<int> &BandIndex,
                                 std::vector<void*> &OutputData);
@@ -32,6 +32,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes suri
 #include "MinimumDistanceAlgorithm.h"
+#include "ClassificationEngine.h"
 #include "suri/DataTypes.h"
 #include "suri/xmlnames.h"
 
@@ -39,92 +40,94 @@ namespace suri {
 /** Macro para registrar el tipo de algoritmo de clasificacion de forma automatica */
 AUTO_REGISTER_CLASS(ClassificationAlgorithmInterface, MinimumDistanceAlgorithm, 0)
 
-/** Funcion clasificacion */
-typedef void (*ClassMappingFunctionType)(int*, std::vector<void*>&, size_t,
-                                         int NoClassPixelValue, int NDVPixelValue,
-                                         double Ndv, bool NdvAvailable,
-                                         double Threshold, Clusters* pClusters);
-
-
+/** Nucleo de clasificacion por distancia minima */
 /**
- * Clasifica las bandas de entrada usando metodo de distancia minima
- * @param[out] pDest banda donde se guardan las clases asignadas(ints)
- * @param[in] pSource bandas de entrada que se usan para clasificar
- * @param[in] Size cantidad de valores (pixeles) de la banda
- * @param[in] NoClassPixelValue valor asignado a los pixels no clasificados
- * @param[in] Threshold umbral a partir del cual un pixel no se asigna a una
- * clase. Valores entre 0 y 1.
- * @param[in] pClusters Estadisticas de las clases que se usan para clasificar
- * los pixels.
+ * Precalcula las medias de las clases y para cada clase acumula, banda por
+ * banda, la distancia euclidea al cuadrado de todos los pixeles del tile.
  */
-template<typename T>
-void mindistance(int* pDest, std::vector<void*> &pSource, size_t Size,
-                 int NoClassPixelValue, int NDVPixelValue, double Ndv,
-                 bool NdvAvailable, double Threshold, Clusters* pClusters) {
-   int sourcesize = pSource.size();
-   std::vector<T*> psrc;
-   for (int i = 0; i < sourcesize; i++)
-      psrc.push_back(static_cast<T*>(pSource[i]));
-
-   const std::vector<Clusters::ClusterData>& clusters =
-                                          pClusters->GetClusterVector();
-   int classcount = clusters.size();
-//   int matrixsize = clusters[0].statistics_.mean_.size();
-   int matrixsize = clusters[0].pStatistics_->GetBandCount();
-   double threshold = Threshold * Threshold;
+class MinimumDistanceKernel : public ClassificationKernel {
+public:
+   /**
+    * @param[in] NoClassPixelValue valor asignado a los pixels no clasificados
+    * @param[in] Threshold distancia maxima para asignar un pixel a una clase
+    * @param[in] pClusters Estadisticas de las clases que se usan para clasificar
+    * los pixels.
+    */
+   MinimumDistanceKernel(int NoClassPixelValue, double Threshold, Clusters* pClusters) :
+         noClassPixelValue_(NoClassPixelValue), threshold_(Threshold * Threshold),
+         matrixsize_(0) {
+      const std::vector<Clusters::ClusterData>& clusters =
+                                             pClusters->GetClusterVector();
+      int classcount = clusters.size();
+      if (classcount == 0)
+         return;
+      matrixsize_ = clusters[0].pStatistics_->GetBandCount();
+      for (int classpos = 0; classpos < classcount; classpos++) {
+         classIds_.push_back(clusters[classpos].classId_);
+         means_.insert(means_.end(), clusters[classpos].pStatistics_->pMean_,
+                       clusters[classpos].pStatistics_->pMean_ + matrixsize_);
+      }
+   }
 
-   // Para cada pixel en la imagen
-   for (size_t pixelposition = 0; pixelposition < Size; pixelposition++) {
-      // La clase default es sin clase
-      int pixelclass = NoClassPixelValue;
+   /** Cantidad de bandas que usan las estadisticas */
+   virtual int GetBandCount() const {
+      return matrixsize_;
+   }
 
-      bool invalidpixel = true;
+   /** Espacio para la distancia y la mejor distancia */
+   virtual int GetWorkspaceSize() const {
+      return 2;
+   }
 
-      // Salida para pixel no valido.
-      // (valor no valido en todas las bandas involucradas)
-      // Ver TCK #7325
-      if (NdvAvailable) {
-         for (int i = 0; i < matrixsize && invalidpixel; ++i) {
-            if (static_cast<double>(psrc[i][pixelposition]) != CLASSIFICATION_NDV)
-               invalidpixel = false;
-         }
-      } else {
-         invalidpixel = false;
+   /**
+    * Asigna a cada pixel la clase mas cercana que este dentro del umbral.
+    * @param[in] pTile valores del tile (pTile[b * Count + p])
+    * @param[in] Count cantidad de pixeles del tile
+    * @param[in] pWorkspace doubles auxiliares
+    * @param[out] pDest clase asignada a cada pixel
+    */
+   virtual void ClassifyTile(const double* pTile, size_t Count, double* pWorkspace,
+                             int* pDest) const {
+      double* pdistance = pWorkspace;
+      double* pclassdistance = pWorkspace + Count;
+      for (size_t p = 0; p < Count; p++) {
+         pDest[p] = noClassPixelValue_;
+         pclassdistance[p] = std::numeric_limits<double>::max();
       }
 
-      // Si el pixel es valido hago el proc normal.
-      if (invalidpixel == false) {
-         double pixelclassdistance = std::numeric_limits<double>::max();
-         // Para cada clase
-         for (int classpos = 0; classpos < classcount; classpos++) {
-            // Le resto a cada pixel la media
-            double diftomean, distance = 0;
-            for (int i = 0; i < matrixsize; i++) {
-#ifdef __OLD_STATS_CALC__
-               diftomean = static_cast<double>(psrc[i][pixelposition])
-                     - clusters[classpos].statistics_.mean_[i];
-#endif
-               diftomean = static_cast<double>(psrc[i][pixelposition])
-                     - clusters[classpos].pStatistics_->pMean_[i];
-               distance += diftomean * diftomean;
+      // Para cada clase
+      int classcount = classIds_.size();
+      for (int classpos = 0; classpos < classcount; classpos++) {
+         const double* pmean = &means_[classpos * matrixsize_];
+         for (size_t p = 0; p < Count; p++)
+            pdistance[p] = 0;
+         for (int i = 0; i < matrixsize_; i++) {
+            const double* pband = pTile + i * Count;
+            double mean = pmean[i];
+            for (size_t p = 0; p < Count; p++) {
+               double diftomean = pband[p] - mean;
+               pdistance[p] += diftomean * diftomean;
             }
+         }
 
+         int classid = classIds_[classpos];
+         for (size_t p = 0; p < Count; p++) {
             // Comparo la ultima clase asignada y el threashold
-            if (distance < threshold && distance < pixelclassdistance) {
-               pixelclass = clusters[classpos].classId_;
-               pixelclassdistance = distance;
+            if (pdistance[p] < threshold_ && pdistance[p] < pclassdistance[p]) {
+               pDest[p] = classid;
+               pclassdistance[p] = pdistance[p];
             }
          }
-      } else {
-         // Sino le pongo un valor para la parte de la imagen que no
-         // es valida.
-         pixelclass = NDVPixelValue;
       }
-      pDest[pixelposition] = pixelclass;
    }
-}
-/** Inicializa mapa de tipos de datos. */
-INITIALIZE_DATATYPE_MAP(ClassMappingFunctionType, mindistance);
+
+private:
+   int noClassPixelValue_; /*! valor de los pixels no clasificados */
+   double threshold_; /*! cuadrado del umbral */
+   int matrixsize_; /*! cantidad de bandas */
+   std::vector<int> classIds_; /*! id de cada clase */
+   std::vector<double> means_; /*! media de cada clase y banda */
+};
 
 /** Ctor */
 MinimumDistanceAlgorithm::MinimumDistanceAlgorithm()  :
@@ -136,17 +139,18 @@ MinimumDistanceAlgorithm::~MinimumDistanceAlgorithm() {
 }
 
 /**
- * Determina el tipo de dato a la entrada del algoritmo
+ * Precalcula los parametros de las clases y clasifica con ClassificationEngine
  * @param[out] pDest datos clasificados
  * @param[in] pSource fuente de datos a clasificar
  * @param[in] Size cantidad de datos a clasificar
+ * @param[in] DataType tipo de dato en imagen a clasificar
  */
 bool MinimumDistanceAlgorithm::Classify(int* pDest, std::vector<void*> pSource,
                                     size_t Size, const std::string &DataType) {
-   ClassMappingFunctionType function = mindistanceTypeMap[DataType];
-   function(pDest, pSource, Size, GetNoClassPixelValue(), GetNDVPixelValue(),
-            GetNoDataValue(), IsNoDataValueAvailable(), GetThreshold(), GetClusters());
-   return true;
+   MinimumDistanceKernel kernel(GetNoClassPixelValue(), GetThreshold(), GetClusters());
+   ClassificationEngine engine;
+   return engine.Classify(kernel, pDest, pSource, Size, DataType,
+                          IsNoDataValueAvailable(), GetNDVPixelValue());
 }
 
 /**
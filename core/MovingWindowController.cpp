@@ -26,15 +26,22 @@ For more information about SpaceSUR, visit <https://www.spacesur.com>.
 For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes estandar
+#include <algorithm>
+#include <vector>
 
 // Includes Suri
 #include "MovingWindowController.h"
+#include "MemoryCanvas.h"
+#include "Mask.h"
 #include "suri/AuxiliaryFunctions.h"
 #include "suri/World.h"
 #include "suri/Dimension.h"
 #include "suri/Progress.h"
+#include "suri/Configuration.h"
+#include "suri/RasterElement.h"
 
 // Includes Wx
+#include "wx/thread.h"
 
 // Includes App
 
@@ -44,6 +51,8 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #define MAX_BUFFER_LINES_SIZE 500
 /** Cantidad de columnas de la imagen que utiliza como buffer de lectura-escritura. */
 #define MAX_BUFFER_PIXELS_SIZE 10000000
+/** Cantidad de hilos de renderizacion por defecto (1 = renderizacion secuencial) */
+#define DEFAULT_RENDER_THREAD_COUNT 1
 
 /** namespace suri */
 namespace suri {
@@ -52,7 +61,9 @@ namespace suri {
  * Constructor
  */
 MovingWindowController::MovingWindowController() :
-      viewportWidth_(0), viewportHeight_(0), initialWindow_(Subset()) {
+      viewportWidth_(0), viewportHeight_(0), initialWindow_(Subset()),
+      threadCount_(Configuration::GetParameter("lib_render_thread_count",
+                                               static_cast<long>(DEFAULT_RENDER_THREAD_COUNT))) {
 }
 
 /**
@@ -206,6 +217,23 @@ void MovingWindowController::SetBestBufferSize() {
    SetBufferSize(MAX_BUFFER_PIXELS_SIZE, MAX_BUFFER_LINES_SIZE);
 }
 
+/**
+ * Con 1 hilo (valor por defecto) las ventanas se renderizan secuencialmente
+ * como siempre. Con mas de uno cada hilo renderiza ventanas con sus propios
+ * pipelines y el resultado se entrega al canvas de salida en orden.
+ * @param[in] ThreadCount cantidad de hilos. 0 usa la cantidad de procesadores.
+ */
+void MovingWindowController::SetThreadCount(int ThreadCount) {
+   threadCount_ = std::max(0, ThreadCount);
+}
+
+/**
+ * @return cantidad de hilos configurada (0 = cantidad de procesadores)
+ */
+int MovingWindowController::GetThreadCount() const {
+   return threadCount_;
+}
+
 /**
  * Setea el mundo que utilizara para la renderizacion
  *
@@ -242,16 +270,142 @@ void MovingWindowController::DoSetWorld() {
  *  GetNext funciona de manera tal que se recorre el extent completo.
  */
 bool MovingWindowController::DoRender() {
+   int threads = threadCount_ > 0 ? threadCount_ : wxThread::GetCPUCount();
+   if (threads > 1 && CanRenderParallel()) {
+      return RenderParallel(threads);
+   }
+   return RenderSerial();
+}
+
+/**
+ *  Recorre el extent con GetNext con las actualizaciones del mundo
+ * bloqueadas (por lo que no se renderiza) para obtener todas las ventanas
+ * y sus viewports.
+ * \post El mundo queda con la ventana y el viewport iniciales.
+ * @param[out] Windows ventanas en el orden en que se renderizan
+ */
+void MovingWindowController::GetWindows(
+      std::vector<ParallelWindowRenderer::RenderWindow> &Windows) {
+   ParallelWindowRenderer::RenderWindow renderwindow;
    Subset next;
-   Progress progression(-1, wxT(message_RENDERING_PROGRESS));
+   pWorld_->BlockViewerUpdate();
+   while (GetNext(next)) {
+      pWorld_->SetWindow(next);
+      renderwindow.window_ = next;
+      pWorld_->GetViewport(renderwindow.viewportWidth_, renderwindow.viewportHeight_);
+      Windows.push_back(renderwindow);
+   }
+   pWorld_->UnblockViewerUpdate();
+}
+
+/**
+ *  Modifica el mundo con cada ventana, lo que dispara la renderizacion
+ * de la misma sobre el canvas de salida.
+ *  Antes de renderizar cada ventana pide a los renderizadores que lean por
+ * adelantado la siguiente (Prefetch), de manera que la lectura de la
+ * siguiente ventana se superpone con el procesamiento de la actual.
+ * @return false si se cancelo o fallo la renderizacion
+ */
+bool MovingWindowController::RenderSerial() {
+   std::vector<ParallelWindowRenderer::RenderWindow> windows;
+   GetWindows(windows);
+   Progress progression(windows.size(), wxT(message_RENDERING_PROGRESS));
+   // mundo sin viewers con el que se pide la lectura anticipada
+   World nextworld(*pWorld_);
    // itera sobre el extent del mundo
    // genera Updates del sistema de progreso, permite cancelarlo
    bool terminate = false; /*! determina si se debe abortar la renderizacion */
-   while (GetNext(next) && !terminate) {
-      pWorld_->SetWindow(next);
+   for (size_t i = 0; i < windows.size() && !terminate; ++i) {
+      if (i + 1 < windows.size()) {
+         nextworld.SetViewport(windows[i + 1].viewportWidth_,
+                               windows[i + 1].viewportHeight_);
+         nextworld.SetWindow(windows[i + 1].window_);
+         Prefetch(&nextworld);
+      }
+      pWorld_->BlockViewerUpdate();
+      pWorld_->SetViewport(windows[i].viewportWidth_, windows[i].viewportHeight_);
+      pWorld_->UnblockViewerUpdate();
+      pWorld_->SetWindow(windows[i].window_);
       terminate = progression.Update() || !GetRenderizationStatus();
    }
+   // reseteo la ventana y el viewport
+   pWorld_->BlockViewerUpdate();
+   pWorld_->SetViewport(viewportWidth_, viewportHeight_);
+   pWorld_->SetWindow(initialWindow_);
+   pWorld_->UnblockViewerUpdate();
    // Retorna el estado de la renderizacion
    return !terminate;
 }
+
+/**
+ *  Solo los elementos raster se renderizan sin wx; los vectores, anotaciones
+ * y demas elementos dibujan sobre un wxDC, que no puede usarse fuera del hilo
+ * principal. Tambien se revisa la lista de la mascara.
+ * @return true si todos los elementos activos de las listas son raster
+ */
+bool MovingWindowController::CanRenderParallel() const {
+   LayerList *lists[] = { pRenderizationList_, pMaskList_ };
+   for (size_t l = 0; l < sizeof(lists) / sizeof(lists[0]); ++l) {
+      if (!lists[l]) {
+         continue;
+      }
+      std::vector<Element*> elements = lists[l]->GetRenderizationOrderList();
+      std::vector<Element*>::const_iterator it = elements.begin();
+      for (; it != elements.end(); ++it) {
+         Element *pelement = (*it)->HasAssociatedElement() ?
+               (*it)->GetAssociatedElement() : *it;
+         if (pelement->IsActive() && !dynamic_cast<RasterElement*>(pelement)) {
+            REPORT_DEBUG("D: El elemento %s no es raster, se renderiza en serie",
+                         pelement->GetName().c_str());
+            return false;
+         }
+      }
+   }
+   return true;
+}
+
+/**
+ *  Obtiene las ventanas con GetWindows, las renderiza con
+ * ParallelWindowRenderer y entrega
+ * cada resultado al canvas de salida en el mismo orden y con la misma
+ * secuencia InitializeAs/Clear/Write/Flush que RenderizationManager::Render,
+ * por lo que los canvas que escriben a archivo o acumulan resultados reciben
+ * los mismos datos que en la renderizacion secuencial.
+ * @param[in] ThreadCount cantidad de hilos
+ * @return false si se cancelo o fallo la renderizacion
+ */
+bool MovingWindowController::RenderParallel(int ThreadCount) {
+   std::vector<ParallelWindowRenderer::RenderWindow> windows;
+   GetWindows(windows);
+
+   ParallelWindowRenderer renderer(pRenderizationList_, pMaskList_, pWorld_,
+                                   pOutputCanvas_, ThreadCount);
+   if (!renderer.Start(windows)) {
+      REPORT_DEBUG("D: No se pudieron crear los hilos de renderizacion");
+      return RenderSerial();
+   }
+   Progress progression(windows.size(), wxT(message_RENDERING_PROGRESS));
+   bool terminate = false; /*! determina si se debe abortar la renderizacion */
+   for (size_t i = 0; i < windows.size() && !terminate; ++i) {
+      MemoryCanvas *pcanvas = NULL;
+      Mask *pmask = NULL;
+      bool status = false;
+      if (!renderer.WaitResult(i, pcanvas, pmask, status)) {
+         terminate = true;
+         break;
+      }
+      if (status && pcanvas) {
+         // el canvas del hilo ya tiene aplicada la mascara
+         pOutputCanvas_->InitializeAs(pcanvas);
+         pOutputCanvas_->Clear();
+         pOutputCanvas_->Write(pcanvas, NULL);
+         pOutputCanvas_->Flush(pmask);
+      }
+      delete pcanvas;
+      delete pmask;
+      terminate = progression.Update() || !status;
+   }
+   renderer.Stop();
+   return !terminate;
+}
 }
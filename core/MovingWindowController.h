@@ -29,9 +29,11 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #define MOVINGWINDOWCONTROLLER_H_
 
 // Includes estandar
+#include <vector>
 
 // Includes Suri
 #include "suri/RenderizationController.h"
+#include "ParallelWindowRenderer.h"
 
 // Includes Wx
 
@@ -60,15 +62,28 @@ public:
    virtual void SetBufferSize(int Pixels, int Lines);
    /** Configura la ventana del mundo con el mejor buffer */
    virtual void SetBestBufferSize();
+   /** Configura la cantidad de hilos con los que se renderizan las ventanas */
+   void SetThreadCount(int ThreadCount);
+   /** Retorna la cantidad de hilos con los que se renderizan las ventanas */
+   int GetThreadCount() const;
 protected:
    /** Configura el mundo */
    virtual void DoSetWorld();
    /** modifica el mundo de manera de recorrer el extent completo y asi renderizar */
    virtual bool DoRender();
 private:
+   /** Obtiene las ventanas que recorren el extent */
+   void GetWindows(std::vector<ParallelWindowRenderer::RenderWindow> &Windows);
+   /** Renderiza las ventanas de a una, modificando el mundo */
+   bool RenderSerial();
+   /** Renderiza las ventanas en paralelo y las entrega en orden al canvas */
+   bool RenderParallel(int ThreadCount);
+   /** Indica si los elementos de las listas se pueden renderizar en paralelo */
+   bool CanRenderParallel() const;
    int viewportWidth_; /*! Ancho del viewport inicial */
    int viewportHeight_; /*! Alto del viewport inicial */
    Subset initialWindow_; /*! Ventana inicial */
+   int threadCount_; /*! Cantidad de hilos (0 = cantidad de procesadores) */
 };
 }
 
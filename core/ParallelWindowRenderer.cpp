@@ -0,0 +1,346 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#include "ParallelWindowRenderer.h"
+
+// Includes estandar
+#include <algorithm>
+#include <map>
+#include <string>
+
+// Includes Suri
+#include "suri/World.h"
+#include "suri/LayerList.h"
+#include "RenderizationManager.h"
+#include "MemoryCanvas.h"
+#include "Mask.h"
+
+// Includes Wx
+#include "wx/thread.h"
+
+// Includes App
+
+// Defines
+/** Cantidad de ventanas renderizadas sin entregar por cada hilo */
+#define PENDING_WINDOWS_PER_THREAD 2
+
+/** namespace suri */
+namespace suri {
+
+/** Hilo que renderiza ventanas para ParallelWindowRenderer */
+/**
+ *  Tiene su propio mundo y sus propios administradores de renderizacion (de
+ * la lista y de la mascara). Se crea y destruye en el hilo principal; en el
+ * hilo de trabajo solo se modifica el mundo propio y se renderiza con
+ * administradores aislados, que no modifican el estado global ni el de los
+ * elementos compartidos.
+ */
+class RenderWorker : public wxThread {
+public:
+   /** Ctor */
+   RenderWorker(ParallelWindowRenderer *pOwner, LayerList *pList, LayerList *pMaskList,
+                const World *pWorld, const Canvas *pOutputCanvas);
+   /** Dtor */
+   virtual ~RenderWorker();
+   /** Renderiza ventanas hasta que no queden pendientes */
+   virtual ExitCode Entry();
+
+private:
+   /** Crea un canvas con la configuracion del canvas de salida */
+   MemoryCanvas *CreateCanvas() const;
+   /** Crea una mascara con la configuracion de la lista de mascara */
+   Mask *CreateMask() const;
+
+   ParallelWindowRenderer *pOwner_; /*! renderizador que reparte las ventanas */
+   World *pWorld_; /*! mundo propio del hilo */
+   RenderizationManager *pManager_; /*! renderiza la lista */
+   RenderizationManager *pMaskManager_; /*! renderiza la mascara */
+   Mask *pMask_; /*! mascara en la que renderiza pMaskManager_ */
+   std::string dataType_; /*! tipo de dato del canvas de salida */
+   int bandCount_; /*! cantidad de bandas del canvas de salida */
+   double noDataValue_; /*! valor no valido del canvas de salida */
+   bool noDataValueAvailable_; /*! indica si el canvas de salida tiene valor no valido */
+   std::map<int, double> bandsNdv_; /*! valores no validos por banda */
+   double maskNoDataValue_; /*! valor no valido de la mascara */
+   bool maskNoDataValueAvailable_; /*! indica si la mascara tiene valor no valido */
+   std::map<int, double> maskBandsNdv_; /*! valores no validos de la mascara */
+};
+
+/**
+ * Crea el mundo y los administradores de renderizacion del hilo con la
+ * misma configuracion que utiliza RenderizationController::Initialize.
+ * \attention Debe llamarse desde el hilo principal.
+ * @param[in] pOwner renderizador que reparte las ventanas
+ * @param[in] pList lista de elementos a renderizar
+ * @param[in] pMaskList lista de elementos que generan la mascara (puede ser NULL)
+ * @param[in] pWorld mundo del que se copia la configuracion
+ * @param[in] pOutputCanvas canvas del que se copia la configuracion
+ */
+RenderWorker::RenderWorker(ParallelWindowRenderer *pOwner, LayerList *pList,
+                           LayerList *pMaskList, const World *pWorld,
+                           const Canvas *pOutputCanvas) :
+      wxThread(wxTHREAD_JOINABLE), pOwner_(pOwner), pWorld_(new World(*pWorld)),
+      pManager_(NULL), pMaskManager_(NULL), pMask_(NULL),
+      dataType_(pOutputCanvas->GetDataType()), bandCount_(pOutputCanvas->GetBandCount()),
+      noDataValue_(pOutputCanvas->GetNoDataValue()),
+      noDataValueAvailable_(pOutputCanvas->IsNoDataValueAvailable()),
+      bandsNdv_(pOutputCanvas->GetAllBandsNdv()), maskNoDataValue_(0),
+      maskNoDataValueAvailable_(false) {
+   // Las renderizaciones se disparan explicitamente, no por cambios del mundo
+   pWorld_->BlockViewerUpdate();
+   if (pMaskList) {
+      maskNoDataValue_ = pMaskList->GetNoDataValue();
+      maskNoDataValueAvailable_ = pMaskList->IsNoDataValueAvailable();
+      maskBandsNdv_ = pMaskList->GetAllBandsNdv();
+      pMaskManager_ = new RenderizationManager(pMaskList, pWorld_);
+      pMaskManager_->SetWorldExtentManager(NULL);
+      pMaskManager_->SetIsolated(true);
+      pMask_ = CreateMask();
+      pMaskManager_->SetCanvas(pMask_);
+      pMaskManager_->CreatePipelines();
+   }
+   pManager_ = new RenderizationManager(pList, pWorld_);
+   pManager_->SetWorldExtentManager(NULL);
+   pManager_->SetIsolated(true);
+   pManager_->SetCanvas(CreateCanvas());
+   pManager_->SetMask(pMask_);
+   pManager_->CreatePipelines();
+}
+
+/**
+ * Elimina los administradores de renderizacion y el mundo.
+ * \attention Debe llamarse desde el hilo principal con el hilo finalizado.
+ */
+RenderWorker::~RenderWorker() {
+   pManager_->SetMask(NULL);
+   delete pManager_->SetCanvas(NULL);
+   delete pManager_;
+   if (pMaskManager_) {
+      pMaskManager_->SetCanvas(NULL);
+      delete pMaskManager_;
+   }
+   delete pMask_;
+   pWorld_->UnblockViewerUpdate();
+   delete pWorld_;
+}
+
+/**
+ * Toma ventanas del renderizador, las renderiza y le entrega el canvas y la
+ * mascara resultantes, reemplazandolos por otros nuevos.
+ * @return 0
+ */
+wxThread::ExitCode RenderWorker::Entry() {
+   size_t index = 0;
+   ParallelWindowRenderer::RenderWindow window;
+   while (pOwner_->GetNextWindow(index, window)) {
+      pWorld_->SetViewport(window.viewportWidth_, window.viewportHeight_);
+      pWorld_->SetWindow(window.window_);
+      if (pMaskManager_) {
+         pMaskManager_->Render(true);
+      }
+      pManager_->Render(true);
+      bool status = pManager_->GetRenderizationStatus()
+            && (!pMaskManager_ || pMaskManager_->GetRenderizationStatus());
+      MemoryCanvas *pcanvas = dynamic_cast<MemoryCanvas*>(
+            pManager_->SetCanvas(CreateCanvas()));
+      // la mascara de la ventana pasa al resultado, se usa una nueva
+      Mask *pmask = pMask_;
+      if (pMaskManager_) {
+         pMask_ = CreateMask();
+         pMaskManager_->SetCanvas(pMask_);
+         pManager_->SetMask(pMask_);
+      }
+      pOwner_->SetResult(index, pcanvas, pmask, status);
+   }
+   return 0;
+}
+
+/** Crea un canvas con la configuracion del canvas de salida */
+MemoryCanvas *RenderWorker::CreateCanvas() const {
+   MemoryCanvas *pcanvas = new MemoryCanvas;
+   pcanvas->SetDataType(dataType_);
+   pcanvas->SetBandCount(bandCount_);
+   pcanvas->SetNoDataValue(noDataValue_);
+   pcanvas->SetNoDataValueAvailable(noDataValueAvailable_);
+   pcanvas->SetAllBandsNdv(bandsNdv_);
+   return pcanvas;
+}
+
+/** Crea una mascara con la configuracion de la lista de mascara */
+Mask *RenderWorker::CreateMask() const {
+   Mask *pmask = new Mask;
+   pmask->SetNoDataValue(maskNoDataValue_);
+   pmask->SetNoDataValueAvailable(maskNoDataValueAvailable_);
+   pmask->SetAllBandsNdv(maskBandsNdv_);
+   return pmask;
+}
+
+/**
+ * @param[in] pList lista de elementos a renderizar
+ * @param[in] pMaskList lista de elementos que generan la mascara (puede ser NULL)
+ * @param[in] pWorld mundo configurado para la renderizacion
+ * @param[in] pOutputCanvas canvas de salida (solo se copia su configuracion)
+ * @param[in] ThreadCount cantidad de hilos de trabajo
+ */
+ParallelWindowRenderer::ParallelWindowRenderer(LayerList *pList, LayerList *pMaskList,
+                                               const World *pWorld,
+                                               const Canvas *pOutputCanvas,
+                                               int ThreadCount) :
+      pList_(pList), pMaskList_(pMaskList), pWorld_(pWorld),
+      pOutputCanvas_(pOutputCanvas), threadCount_(std::max(1, ThreadCount)),
+      maxPending_(threadCount_ * PENDING_WINDOWS_PER_THREAD), nextWindow_(0),
+      nextResult_(0), abort_(false), pMutex_(new wxMutex),
+      pCondition_(new wxCondition(*pMutex_)) {
+}
+
+/** Dtor */
+ParallelWindowRenderer::~ParallelWindowRenderer() {
+   Stop();
+   delete pCondition_;
+   delete pMutex_;
+}
+
+/**
+ * Crea los hilos de trabajo (en el hilo principal) y los pone a renderizar
+ * las ventanas en orden.
+ * @param[in] Windows ventanas a renderizar
+ * @return true si pudo iniciar al menos un hilo
+ */
+bool ParallelWindowRenderer::Start(const std::vector<RenderWindow> &Windows) {
+   Stop();
+   windows_ = Windows;
+   WindowResult empty = { NULL, NULL, false, false };
+   results_.assign(windows_.size(), empty);
+   nextWindow_ = 0;
+   nextResult_ = 0;
+   abort_ = false;
+   int threads = std::min(threadCount_, static_cast<int>(windows_.size()));
+   for (int i = 0; i < threads; ++i) {
+      RenderWorker *pworker = new RenderWorker(this, pList_, pMaskList_, pWorld_,
+                                               pOutputCanvas_);
+      if (pworker->Create() != wxTHREAD_NO_ERROR || pworker->Run() != wxTHREAD_NO_ERROR) {
+         delete pworker;
+         break;
+      }
+      workers_.push_back(pworker);
+   }
+   return !workers_.empty();
+}
+
+/**
+ * Espera a que la ventana este renderizada y transfiere el resultado. Las
+ * ventanas deben pedirse en orden.
+ * @param[in] Index indice de la ventana
+ * @param[out] pCanvas datos renderizados (debe eliminarlos quien llama)
+ * @param[out] pMask mascara de la ventana o NULL (debe eliminarla quien llama)
+ * @param[out] Status resultado de la renderizacion de la ventana
+ * @return false si se cancelo la renderizacion o el indice es invalido
+ */
+bool ParallelWindowRenderer::WaitResult(size_t Index, MemoryCanvas* &pCanvas, Mask* &pMask,
+                                        bool &Status) {
+   wxMutexLocker lock(*pMutex_);
+   if (Index >= results_.size()) {
+      return false;
+   }
+   while (!results_[Index].rendered_ && !abort_) {
+      pCondition_->Wait();
+   }
+   if (!results_[Index].rendered_) {
+      return false;
+   }
+   pCanvas = results_[Index].pCanvas_;
+   pMask = results_[Index].pMask_;
+   Status = results_[Index].status_;
+   results_[Index].pCanvas_ = NULL;
+   results_[Index].pMask_ = NULL;
+   nextResult_ = Index + 1;
+   // libera lugar para que los hilos sigan renderizando
+   pCondition_->Broadcast();
+   return true;
+}
+
+/**
+ * Cancela las ventanas que no comenzaron a renderizarse, espera que los hilos
+ * terminen y elimina los resultados no entregados.
+ */
+void ParallelWindowRenderer::Stop() {
+   {
+      wxMutexLocker lock(*pMutex_);
+      abort_ = true;
+      pCondition_->Broadcast();
+   }
+   for (size_t i = 0; i < workers_.size(); ++i) {
+      workers_[i]->Wait();
+      delete workers_[i];
+   }
+   workers_.clear();
+   for (size_t i = 0; i < results_.size(); ++i) {
+      delete results_[i].pCanvas_;
+      delete results_[i].pMask_;
+   }
+   results_.clear();
+}
+
+/**
+ * Asigna al hilo que llama la siguiente ventana. Si hay demasiadas ventanas
+ * renderizadas sin entregar espera a que el hilo principal las consuma.
+ * @param[out] Index indice de la ventana asignada
+ * @param[out] Window ventana asignada
+ * @return false si no quedan ventanas o se cancelo la renderizacion
+ */
+bool ParallelWindowRenderer::GetNextWindow(size_t &Index, RenderWindow &Window) {
+   wxMutexLocker lock(*pMutex_);
+   while (!abort_ && nextWindow_ < windows_.size()
+         && nextWindow_ >= nextResult_ + maxPending_) {
+      pCondition_->Wait();
+   }
+   if (abort_ || nextWindow_ >= windows_.size()) {
+      return false;
+   }
+   Index = nextWindow_++;
+   Window = windows_[Index];
+   return true;
+}
+
+/**
+ * Guarda el resultado de una ventana y avisa al hilo principal.
+ * @param[in] Index indice de la ventana
+ * @param[in] pCanvas datos renderizados (pasa a ser propiedad de esta clase)
+ * @param[in] pMask mascara de la ventana (pasa a ser propiedad de esta clase)
+ * @param[in] Status resultado de la renderizacion
+ */
+void ParallelWindowRenderer::SetResult(size_t Index, MemoryCanvas *pCanvas, Mask *pMask,
+                                       bool Status) {
+   wxMutexLocker lock(*pMutex_);
+   results_[Index].pCanvas_ = pCanvas;
+   results_[Index].pMask_ = pMask;
+   results_[Index].status_ = Status;
+   results_[Index].rendered_ = true;
+   pCondition_->Broadcast();
+}
+
+}  // namespace suri
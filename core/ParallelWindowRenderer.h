@@ -0,0 +1,130 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef PARALLELWINDOWRENDERER_H_
+#define PARALLELWINDOWRENDERER_H_
+
+// Includes estandar
+#include <vector>
+
+// Includes Suri
+#include "suri/Subset.h"
+
+// Includes Wx
+
+// Includes App
+
+// Defines
+
+// forwards
+class wxMutex;
+class wxCondition;
+
+/** namespace suri */
+namespace suri {
+
+class LayerList;
+class World;
+class Canvas;
+class MemoryCanvas;
+class Mask;
+class RenderWorker;
+
+/** Renderiza en paralelo las ventanas de un MovingWindowController */
+/**
+ *  Cada hilo de trabajo tiene su propio World, RenderizationManager (y por lo
+ * tanto sus propios RenderPipeline) y canvas, todos creados en el hilo
+ * principal. Los administradores se aislan (RenderizationManager::SetIsolated)
+ * para no modificar estado compartido entre hilos. Los hilos toman las
+ * ventanas en orden y dejan el resultado (canvas y mascara) para que el hilo
+ * principal lo obtenga con WaitResult y lo entregue al canvas de salida en
+ * el mismo orden que la renderizacion secuencial. De esta forma los canvas de
+ * salida que escriben a archivo o que acumulan resultados (estadisticas,
+ * histogramas, k-means) reciben los datos igual que antes.
+ *  Para acotar la memoria, ningun hilo renderiza una ventana que se encuentre
+ * a mas de PENDING_WINDOWS_PER_THREAD ventanas por hilo de la ultima entregada.
+ * \attention Solo se deben renderizar listas de elementos raster: los demas
+ *            elementos dibujan con wx, que solo puede usarse en el hilo
+ *            principal.
+ */
+class ParallelWindowRenderer {
+   /** Ctor. de Copia. */
+   ParallelWindowRenderer(const ParallelWindowRenderer &ParallelWindowRenderer);
+
+public:
+   /** Ventana del recorrido junto con el tamanio de viewport que le corresponde */
+   struct RenderWindow {
+      Subset window_; /*! ventana en coordenadas de mundo */
+      int viewportWidth_; /*! ancho del viewport para la ventana */
+      int viewportHeight_; /*! alto del viewport para la ventana */
+   };
+
+   /** Ctor */
+   ParallelWindowRenderer(LayerList *pList, LayerList *pMaskList, const World *pWorld,
+                          const Canvas *pOutputCanvas, int ThreadCount);
+   /** Dtor */
+   ~ParallelWindowRenderer();
+   /** Comienza a renderizar las ventanas */
+   bool Start(const std::vector<RenderWindow> &Windows);
+   /** Espera el resultado de la ventana indicada */
+   bool WaitResult(size_t Index, MemoryCanvas* &pCanvas, Mask* &pMask, bool &Status);
+   /** Cancela las ventanas pendientes y finaliza los hilos */
+   void Stop();
+
+private:
+   friend class RenderWorker;
+   /** Resultado de renderizar una ventana */
+   struct WindowResult {
+      MemoryCanvas *pCanvas_; /*! datos renderizados */
+      Mask *pMask_; /*! mascara de la ventana (puede ser NULL) */
+      bool rendered_; /*! indica si la ventana ya fue renderizada */
+      bool status_; /*! resultado de la renderizacion */
+   };
+   /** Obtiene la siguiente ventana a renderizar (llamado por los hilos) */
+   bool GetNextWindow(size_t &Index, RenderWindow &Window);
+   /** Guarda el resultado de una ventana (llamado por los hilos) */
+   void SetResult(size_t Index, MemoryCanvas *pCanvas, Mask *pMask, bool Status);
+
+   LayerList *pList_; /*! lista de elementos a renderizar */
+   LayerList *pMaskList_; /*! lista de elementos que generan la mascara */
+   const World *pWorld_; /*! mundo del que se copia la configuracion */
+   const Canvas *pOutputCanvas_; /*! canvas del que se copia la configuracion */
+   int threadCount_; /*! cantidad de hilos */
+   size_t maxPending_; /*! cantidad maxima de ventanas renderizadas sin entregar */
+   std::vector<RenderWorker*> workers_; /*! hilos de trabajo */
+   std::vector<RenderWindow> windows_; /*! ventanas a renderizar */
+   std::vector<WindowResult> results_; /*! resultados por ventana */
+   size_t nextWindow_; /*! proxima ventana a renderizar */
+   size_t nextResult_; /*! proxima ventana a entregar */
+   bool abort_; /*! indica que se cancelo la renderizacion */
+   wxMutex *pMutex_; /*! protege el estado compartido con los hilos */
+   wxCondition *pCondition_; /*! avisa cambios en el estado compartido */
+};
+
+}  // namespace suri
+
+#endif /* PARALLELWINDOWRENDERER_H_ */
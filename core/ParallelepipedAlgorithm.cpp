@@ -33,6 +33,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes Suri
 #include "ParallelepipedAlgorithm.h"
+#include "ClassificationEngine.h"
 #include "suri/StatisticsFunctions.h"
 #include "suri/DataTypes.h"
 #include "MathFunctions.h"
@@ -50,98 +51,97 @@ namespace suri {
 /** Macro para registrar el tipo de algoritmo de clasificacion de forma automatica */
 AUTO_REGISTER_CLASS(ClassificationAlgorithmInterface, ParallelepipedAlgorithm, 0)
 
-/** Funcion clasificacion */
-typedef void (*ClassMappingFunctionType)(int*, std::vector<void*>&, size_t,
-                                         int NoClassPixelValue, int NDVPixelValue,
-                                         double Ndv, bool NdvAvailable,
-                                         double Threshold, Clusters* pClusters);
-
+/** Nucleo de clasificacion por el metodo del paralelepipedo */
 /**
- * Clasifica las bandas de entrada usando metodo del paralelepipedo
- * @param[out] pDest banda donde se guardan las clases asignadas(ints)
- * @param[in] pSource bandas de entrada que se usan para clasificar
- * @param[in] Size cantidad de valores (pixeles) de la banda
- * @param[in] NoClassPixelValue valor asignado a los pixels no clasificados
- * @param[in] Threshold umbral a partir del cual un pixel no se asigna a una
- * clase. Valores entre 0 y 1.
- * @param[in] pClusters Estadisticas de las clases que se usan para clasificar
- * los pixels.
+ * Precalcula el rango de cada clase en cada banda y para cada clase marca los
+ * pixeles del tile que caen dentro del rango en todas las bandas. Si un pixel
+ * cae en varias clases se queda con la ultima.
  */
-template<typename T>
-void parallelepiped(int* pDest, std::vector<void*> &pSource, size_t Size,
-                    int NoClassPixelValue, int NDVPixelValue, double Ndv,
-                    bool NdvAvailable, double Threshold, Clusters* pClusters) {
-   int bandcount = pSource.size();
-   std::vector<T*> psrc;
-   for (int i = 0; i < bandcount; i++)
-      psrc.push_back(static_cast<T*>(pSource[i]));
-
-   const std::vector<Clusters::ClusterData>& clusters = pClusters->GetClusterVector();
-   int classcount = clusters.size();
-
-   // Calculo el rango de cada clase en cada banda
-   double *plowerlimits = new double[classcount*bandcount];
-   double *pupperlimits = new double[classcount*bandcount];
-   for (int classpos = 0; classpos < classcount; classpos++) {
-      for (int bandpos = 0; bandpos < bandcount; bandpos++) {
-         plowerlimits[classpos * bandcount + bandpos] =
+class ParallelepipedKernel : public ClassificationKernel {
+public:
+   /**
+    * @param[in] BandCount cantidad de bandas a clasificar
+    * @param[in] NoClassPixelValue valor asignado a los pixels no clasificados
+    * @param[in] Threshold cantidad de desvios que definen el rango de la clase
+    * @param[in] pClusters Estadisticas de las clases que se usan para clasificar
+    * los pixels.
+    */
+   ParallelepipedKernel(int BandCount, int NoClassPixelValue, double Threshold,
+                        Clusters* pClusters) :
+         bandCount_(BandCount), noClassPixelValue_(NoClassPixelValue) {
+      const std::vector<Clusters::ClusterData>& clusters = pClusters->GetClusterVector();
+      int classcount = clusters.size();
+
+      // Calculo el rango de cada clase en cada banda
+      lowerLimits_.resize(classcount * bandCount_);
+      upperLimits_.resize(classcount * bandCount_);
+      for (int classpos = 0; classpos < classcount; classpos++) {
+         classIds_.push_back(clusters[classpos].classId_);
+         for (int bandpos = 0; bandpos < bandCount_; bandpos++) {
+            lowerLimits_[classpos * bandCount_ + bandpos] =
                               clusters[classpos].pStatistics_->pMean_[bandpos] -
                               sqrt(clusters[classpos].pStatistics_->pAccumVariance_[bandpos]) *
                               Threshold;
-         pupperlimits[classpos * bandcount + bandpos] =
+            upperLimits_[classpos * bandCount_ + bandpos] =
                               clusters[classpos].pStatistics_->pMean_[bandpos] +
                               sqrt(clusters[classpos].pStatistics_->pAccumVariance_[bandpos]) *
                               Threshold;
+         }
       }
    }
 
-   // Para cada pixel veo si cae en el rango de todas las bandas.
-   // Para cada pixel en la imagen
-   for (size_t pixelposition = 0; pixelposition < Size; pixelposition++) {
-      int pixelclass = NoClassPixelValue;
-
-      bool invalidpixel = true;
+   /** Cantidad de bandas a clasificar */
+   virtual int GetBandCount() const {
+      return bandCount_;
+   }
 
-      // Salida para pixel no valido.
-      // (valor no valido en todas las bandas involucradas)
-      // Ver TCK #7325
-      if (NdvAvailable) {
-         for (int i = 0; i < bandcount && invalidpixel; ++i) {
-            if (static_cast<double>(psrc[i][pixelposition]) != CLASSIFICATION_NDV)
-               invalidpixel = false;
-         }
-      } else {
-         invalidpixel = false;
-      }
+   /** Espacio para la marca de pertenencia */
+   virtual int GetWorkspaceSize() const {
+      return 1;
+   }
 
-      // Si el pixel es valido hago el proc normal.
-      if (invalidpixel == false) {
-         for (int classpos = 0; classpos < classcount; classpos++) {
-            int testedclass = clusters[classpos].classId_;
-            for (int bandpos = 0; bandpos < bandcount; bandpos++) {
-               if (psrc[bandpos][pixelposition]
-                     < plowerlimits[classpos * bandcount + bandpos]
-                     || psrc[bandpos][pixelposition]
-                           > pupperlimits[classpos * bandcount + bandpos]) {
-                  testedclass = NoClassPixelValue;
-                  break;
-               }
-            }
-            if (testedclass != NoClassPixelValue) pixelclass = testedclass;
+   /**
+    * Asigna a cada pixel la ultima clase en cuyo rango cae.
+    * @param[in] pTile valores del tile (pTile[b * Count + p])
+    * @param[in] Count cantidad de pixeles del tile
+    * @param[in] pWorkspace doubles auxiliares
+    * @param[out] pDest clase asignada a cada pixel
+    */
+   virtual void ClassifyTile(const double* pTile, size_t Count, double* pWorkspace,
+                             int* pDest) const {
+      double* pinside = pWorkspace;
+      for (size_t p = 0; p < Count; p++)
+         pDest[p] = noClassPixelValue_;
+
+      int classcount = classIds_.size();
+      for (int classpos = 0; classpos < classcount; classpos++) {
+         int testedclass = classIds_[classpos];
+         if (testedclass == noClassPixelValue_)
+            continue;
+         for (size_t p = 0; p < Count; p++)
+            pinside[p] = 1;
+         // Para cada pixel veo si cae en el rango de todas las bandas.
+         for (int bandpos = 0; bandpos < bandCount_; bandpos++) {
+            const double* pband = pTile + bandpos * Count;
+            double lower = lowerLimits_[classpos * bandCount_ + bandpos];
+            double upper = upperLimits_[classpos * bandCount_ + bandpos];
+            for (size_t p = 0; p < Count; p++)
+               if (pband[p] < lower || pband[p] > upper)
+                  pinside[p] = 0;
          }
-      } else {
-         // Sino le pongo un valor para la parte de la imagen que no
-         // es valida.
-         pixelclass = NDVPixelValue;
+         for (size_t p = 0; p < Count; p++)
+            if (pinside[p] != 0)
+               pDest[p] = testedclass;
       }
-      pDest[pixelposition] = pixelclass;
    }
 
-   delete[] plowerlimits;
-   delete[] pupperlimits;
-}
-/** Inicializa mapa de tipos de datos. */
-INITIALIZE_DATATYPE_MAP(ClassMappingFunctionType, parallelepiped);
+private:
+   int bandCount_; /*! cantidad de bandas */
+   int noClassPixelValue_; /*! valor de los pixels no clasificados */
+   std::vector<int> classIds_; /*! id de cada clase */
+   std::vector<double> lowerLimits_; /*! limite inferior por clase y banda */
+   std::vector<double> upperLimits_; /*! limite superior por clase y banda */
+};
 
 /** Ctor */
 ParallelepipedAlgorithm::ParallelepipedAlgorithm() :
@@ -154,17 +154,19 @@ ParallelepipedAlgorithm::~ParallelepipedAlgorithm() {
 
 
 /**
- * Determina el tipo de dato a la entrada del algoritmo
+ * Precalcula los parametros de las clases y clasifica con ClassificationEngine
  * @param[out] pDest datos clasificados
  * @param[in] pSource fuente de datos a clasificar
  * @param[in] Size cantidad de datos a clasificar
+ * @param[in] DataType tipo de dato en imagen a clasificar
  */
 bool ParallelepipedAlgorithm::Classify(int* pDest, std::vector<void*> pSource,
                                     size_t Size, const std::string &DataType) {
-   ClassMappingFunctionType function = parallelepipedTypeMap[DataType];
-   function(pDest, pSource, Size, GetNoClassPixelValue(), GetNDVPixelValue(),
-            GetNoDataValue(), IsNoDataValueAvailable(), GetThreshold(), GetClusters());
-   return true;
+   ParallelepipedKernel kernel(pSource.size(), GetNoClassPixelValue(), GetThreshold(),
+                               GetClusters());
+   ClassificationEngine engine;
+   return engine.Classify(kernel, pDest, pSource, Size, DataType,
+                          IsNoDataValueAvailable(), GetNDVPixelValue());
 }
 
 /**
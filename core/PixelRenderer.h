@@ -0,0 +1,107 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef PIXELRENDERER_H_
+#define PIXELRENDERER_H_
+
+// Includes estandar
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Includes Suri
+
+// Includes Wx
+
+// Includes App
+
+// Defines
+
+/** namespace suri */
+namespace suri {
+
+class World;
+class Canvas;
+class Mask;
+
+/** Interfaz de los renderizadores que procesan cada pixel en forma independiente */
+/**
+ *  Los renderizadores que implementan esta interfaz (ademas de Renderer)
+ * calculan cada pixel de salida solo a partir del mismo pixel de entrada,
+ * sin vecinos ni referencias al mundo. Esto permite que RenderPipeline
+ * encadene varios de ellos (PixelRendererChain) y los aplique en una unica
+ * pasada sobre los datos, por tiles que entran en cache.
+ *  Render se separa en RenderInput (renderizacion del anterior) y
+ * ProcessCanvas (procesamiento de todo el canvas). ApplyPixels procesa un
+ * tramo de pixeles con el formato fijado en PreparePixels.
+ */
+class PixelRenderer {
+public:
+   /** Dtor */
+   virtual ~PixelRenderer() {
+   }
+   /** Renderiza la entrada del renderizador (el renderizador anterior) */
+   /**
+    * @param[in] pWorldWindow mundo a renderizar
+    * @param[in] pCanvas canvas donde se renderiza la entrada
+    * @param[in] pMask mascara de la renderizacion
+    * \pre pCanvas debe aceptar cambios de tipo de dato
+    * @return true si la renderizacion del anterior tuvo exito
+    */
+   virtual bool RenderInput(const World *pWorldWindow, Canvas *pCanvas, Mask *pMask)=0;
+   /** Procesa todo el canvas (renderizacion etapa por etapa) */
+   /**
+    * @param[in] pCanvas canvas con la salida del renderizador anterior
+    * @param[out] pCanvas canvas con la salida del renderizador
+    * @return true si pudo procesar el canvas
+    */
+   virtual bool ProcessCanvas(Canvas *pCanvas)=0;
+   /** Prepara el procesamiento por pixel para el formato de entrada */
+   /**
+    * @param[in] InputBandCount cantidad de bandas de entrada
+    * @param[in] InputDataType tipo de dato de entrada
+    * @param[out] OutputBandCount cantidad de bandas de salida
+    * @param[out] OutputDataType tipo de dato de salida
+    * @return false si no puede procesar ese formato por pixel
+    */
+   virtual bool PreparePixels(int InputBandCount, const std::string &InputDataType,
+                              int &OutputBandCount, std::string &OutputDataType)=0;
+   /** Procesa un tramo de pixeles */
+   /**
+    * @param[in] InputData un buffer por banda de entrada
+    * @param[out] OutputData un buffer por banda de salida (no se superpone
+    *             con la entrada)
+    * @param[in] PixelCount cantidad de pixeles de cada buffer
+    * \pre se llamo a PreparePixels con el formato de InputData
+    */
+   virtual void ApplyPixels(std::vector<void*> &InputData,
+                            std::vector<void*> &OutputData, size_t PixelCount)=0;
+};
+
+}  // namespace suri
+
+#endif /* PIXELRENDERER_H_ */
@@ -0,0 +1,229 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#include "PixelRendererChain.h"
+
+// Includes estandar
+#include <algorithm>
+#include <cstring>
+
+// Includes Suri
+#include "suri/Renderer.h"
+#include "suri/DataTypes.h"
+#include "suri/Configuration.h"
+#include "PixelRenderer.h"
+#include "MemoryCanvas.h"
+#include "CanvasBandBuffers.h"
+#include "logmacros.h"
+
+// Includes Wx
+
+// Includes App
+
+// Defines
+/** Tamanio (en bytes) de los datos de un tile en la etapa mas ancha */
+#define FUSED_TILE_BYTES (64 * 1024)
+/** Cantidad minima de etapas para fusionar */
+#define MIN_FUSED_STAGES 2
+
+/** namespace suri */
+namespace suri {
+
+/**
+ * @param[in] Stages etapas de la cadena
+ * @param[in] pLastRenderer ultimo renderizador del pipeline
+ */
+PixelRendererChain::PixelRendererChain(const std::vector<PixelRenderer*> &Stages,
+                                       Renderer *pLastRenderer) :
+      stages_(Stages), pLastRenderer_(pLastRenderer), pOutput_(new MemoryCanvas) {
+}
+
+/** Dtor */
+PixelRendererChain::~PixelRendererChain() {
+   delete pOutput_;
+}
+
+/**
+ *  Busca desde el final del pipeline el tramo de renderizadores que
+ * implementan PixelRenderer. Si es de al menos MIN_FUSED_STAGES etapas crea
+ * la cadena. Se puede deshabilitar con lib_render_fused_pixel_chain en 0.
+ * @param[in] Renderers renderizadores del pipeline (en orden)
+ * @return cadena creada (responsabilidad del que la pide)
+ * @return NULL si el pipeline no termina en una cadena de renderizadores por
+ *         pixel
+ */
+PixelRendererChain *PixelRendererChain::Create(const std::vector<Renderer*> &Renderers) {
+   if (Configuration::GetParameter("lib_render_fused_pixel_chain",
+                                   static_cast<long>(1)) == 0) {
+      return NULL;
+   }
+   std::vector<PixelRenderer*> stages;
+   std::vector<Renderer*>::const_reverse_iterator it = Renderers.rbegin();
+   for (; it != Renderers.rend(); ++it) {
+      PixelRenderer *pstage = dynamic_cast<PixelRenderer*>(*it);
+      if (!pstage) {
+         break;
+      }
+      stages.push_back(pstage);
+   }
+   if (stages.size() < MIN_FUSED_STAGES) {
+      return NULL;
+   }
+   std::reverse(stages.begin(), stages.end());
+   REPORT_DEBUG("D:Se fusionan %d renderizadores por pixel", static_cast<int>(stages.size()));
+   return new PixelRendererChain(stages, Renderers.back());
+}
+
+/**
+ *  Renderiza la entrada de la cadena sobre el canvas y luego aplica las
+ * etapas (si falla la entrada no las aplica). Si no puede fusionarlas las
+ * aplica de a una sobre todo el canvas y si el canvas no es un MemoryCanvas
+ * delega en el ultimo renderizador.
+ * @param[in] pWorldWindow mundo a renderizar
+ * @param[in] pCanvas canvas donde se renderiza
+ * @param[in] pMask mascara de la renderizacion
+ * @return true si la renderizacion tuvo exito
+ */
+bool PixelRendererChain::Render(const World *pWorldWindow, Canvas *pCanvas,
+                                Mask *pMask) {
+   MemoryCanvas *pcanvas = dynamic_cast<MemoryCanvas*>(pCanvas);
+   if (!pcanvas) {
+      return pLastRenderer_->Render(pWorldWindow, pCanvas, pMask);
+   }
+   if (!stages_.front()->RenderInput(pWorldWindow, pCanvas, pMask)) {
+      return false;
+   }
+   if (RenderFused(pcanvas)) {
+      return true;
+   }
+   REPORT_DEBUG("D:No se pueden fusionar las etapas, se aplican de a una");
+   bool status = true;
+   for (size_t i = 0; i < stages_.size(); i++)
+      status = stages_[i]->ProcessCanvas(pCanvas) && status;
+   return status;
+}
+
+/**
+ *  Fija el formato de cada etapa a partir del canvas y recorre los datos por
+ * tiles. Las etapas intermedias escriben en dos buffers de tile que se
+ * alternan y la ultima escribe en pOutput_, que al terminar intercambia sus
+ * bandas con las del canvas.
+ * @param[in] pCanvas canvas con la entrada de la cadena
+ * @param[out] pCanvas canvas con la salida de la cadena
+ * @return false si alguna etapa no soporta el formato (no modifica el canvas)
+ */
+bool PixelRendererChain::RenderFused(MemoryCanvas *pCanvas) {
+   int sizex = 0, sizey = 0;
+   pCanvas->GetSize(sizex, sizey);
+   size_t stagecount = stages_.size();
+   std::vector<int> bandcount(stagecount + 1, 0);
+   std::vector<std::string> datatype(stagecount + 1);
+   std::vector<size_t> datasize(stagecount + 1, 0);
+   bandcount[0] = pCanvas->GetBandCount();
+   datatype[0] = pCanvas->GetDataType();
+   if (sizex < 1 || sizey < 1 || bandcount[0] < 1) {
+      return false;
+   }
+   size_t pixelbytes = 0;
+   for (size_t i = 0; i <= stagecount; i++) {
+      if (i > 0 && !stages_[i - 1]->PreparePixels(bandcount[i - 1], datatype[i - 1],
+                                                  bandcount[i], datatype[i])) {
+         return false;
+      }
+      datasize[i] = SizeOf(datatype[i]);
+      if (bandcount[i] < 1 || datasize[i] == 0) {
+         return false;
+      }
+      pixelbytes = std::max(pixelbytes, bandcount[i] * datasize[i]);
+   }
+   ConfigureOutput(sizex, sizey, bandcount[stagecount], datatype[stagecount]);
+
+   std::vector<int> inputbands(bandcount[0]);
+   for (int b = 0; b < bandcount[0]; b++)
+      inputbands[b] = b;
+   std::vector<int> outputbands(bandcount[stagecount]);
+   for (int b = 0; b < bandcount[stagecount]; b++)
+      outputbands[b] = b;
+   CanvasBandBuffers input(pCanvas, inputbands);
+   CanvasBandBuffers output(pOutput_, outputbands, false);
+
+   // Buffers de tile para las etapas intermedias
+   size_t tilepixels = std::max(FUSED_TILE_BYTES / pixelbytes, static_cast<size_t>(1));
+   std::vector<unsigned char> tilebuffer[2];
+   tilebuffer[0].resize(tilepixels * pixelbytes);
+   tilebuffer[1].resize(tilepixels * pixelbytes);
+
+   size_t pixelcount = static_cast<size_t>(sizex) * sizey;
+   std::vector<void*> tilein, tileout;
+   for (size_t offset = 0; offset < pixelcount; offset += tilepixels) {
+      size_t count = std::min(tilepixels, pixelcount - offset);
+      tilein.resize(bandcount[0]);
+      for (int b = 0; b < bandcount[0]; b++)
+         tilein[b] = static_cast<unsigned char*>(input.GetData()[b]) + offset * datasize[0];
+      for (size_t i = 0; i < stagecount; i++) {
+         tileout.resize(bandcount[i + 1]);
+         for (int b = 0; b < bandcount[i + 1]; b++) {
+            if (i + 1 == stagecount) {
+               tileout[b] = static_cast<unsigned char*>(output.GetData()[b])
+                     + offset * datasize[i + 1];
+            } else {
+               tileout[b] = &tilebuffer[i % 2][0] + b * tilepixels * datasize[i + 1];
+            }
+         }
+         stages_[i]->ApplyPixels(tilein, tileout, count);
+         tilein.swap(tileout);
+      }
+   }
+   output.Commit();
+   output.Release();
+   input.Release();
+   // la salida pasa al canvas sin copiarla; pOutput_ se queda con la entrada
+   return pCanvas->SwapBands(pOutput_);
+}
+
+/**
+ *  Cambiar el formato de un MemoryCanvas recrea sus bandas, por eso solo se
+ * hace si difiere del actual.
+ * @param[in] SizeX ancho de la salida
+ * @param[in] SizeY alto de la salida
+ * @param[in] BandCount cantidad de bandas de la salida
+ * @param[in] DataType tipo de dato de la salida
+ */
+void PixelRendererChain::ConfigureOutput(int SizeX, int SizeY, int BandCount,
+                                         const std::string &DataType) {
+   int sizex = 0, sizey = 0;
+   pOutput_->GetSize(sizex, sizey);
+   if (sizex == SizeX && sizey == SizeY && pOutput_->GetBandCount() == BandCount
+         && pOutput_->GetDataType() == DataType) {
+      return;
+   }
+   pOutput_->SetDataType(DataType);
+   pOutput_->SetBandCount(BandCount);
+   pOutput_->SetSize(SizeX, SizeY);
+}
+
+}  // namespace suri
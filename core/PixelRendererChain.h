@@ -0,0 +1,91 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef PIXELRENDERERCHAIN_H_
+#define PIXELRENDERERCHAIN_H_
+
+// Includes estandar
+#include <string>
+#include <vector>
+
+// Includes Suri
+
+// Includes Wx
+
+// Includes App
+
+// Defines
+
+/** namespace suri */
+namespace suri {
+
+class World;
+class Canvas;
+class Mask;
+class MemoryCanvas;
+class Renderer;
+class PixelRenderer;
+
+/** Cadena de PixelRenderer que se aplica en una unica pasada */
+/**
+ *  Agrupa el tramo final de un pipeline formado por renderizadores por
+ * pixel (ver PixelRenderer). Al renderizar obtiene la entrada del primero y
+ * en lugar de que cada uno lea, procese y escriba todo el canvas, recorre
+ * los datos una vez por tiles de FUSED_TILE_BYTES aplicando todas las etapas
+ * sobre cada tile mientras esta en cache.
+ *  El tipo de dato y las bandas de cada etapa se fijan una vez por
+ * renderizacion (PreparePixels); si alguna etapa no soporta el formato, o el
+ * canvas no es un MemoryCanvas, se renderiza etapa por etapa como antes.
+ */
+class PixelRendererChain {
+   /** Ctor */
+   PixelRendererChain(const std::vector<PixelRenderer*> &Stages, Renderer *pLastRenderer);
+   /** Ctor. de Copia. */
+   PixelRendererChain(const PixelRendererChain &PixelRendererChain);
+
+public:
+   /** Dtor */
+   ~PixelRendererChain();
+   /** Crea la cadena con el tramo final de renderizadores por pixel */
+   static PixelRendererChain *Create(const std::vector<Renderer*> &Renderers);
+   /** Renderiza el pipeline aplicando las etapas por pixel en una pasada */
+   bool Render(const World *pWorldWindow, Canvas *pCanvas, Mask *pMask);
+
+private:
+   /** Aplica las etapas sobre todo el canvas en una unica pasada */
+   bool RenderFused(MemoryCanvas *pCanvas);
+   /** Configura el canvas de salida si no tiene el formato pedido */
+   void ConfigureOutput(int SizeX, int SizeY, int BandCount, const std::string &DataType);
+
+   std::vector<PixelRenderer*> stages_; /*! Etapas de la cadena (en orden) */
+   Renderer *pLastRenderer_; /*! Ultimo renderizador (salida del pipeline) */
+   MemoryCanvas *pOutput_; /*! Canvas donde se escribe la salida */
+};
+
+}  // namespace suri
+
+#endif /* PIXELRENDERERCHAIN_H_ */
@@ -0,0 +1,436 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#include "ProjectedVectorCache.h"
+
+// Includes estandar
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+// Includes Suri
+#include "suri/FileManagementFunctions.h"
+
+// Includes Wx
+#include "wx/wx.h"
+#include "wx/filename.h"
+
+// Includes App
+#include "ogr_geometry.h"
+
+// Defines
+/** Fraccion de la extension de la capa que se usa como tolerancia del nivel 1 */
+#define LEVEL_BASE_TOLERANCE_FRACTION (1.0 / 65536.0)
+/** Factor entre las tolerancias de niveles consecutivos */
+#define LEVEL_TOLERANCE_FACTOR 4.0
+
+namespace suri {
+
+namespace {
+
+/** Distancia al cuadrado entre el vertice i y el segmento begin-end */
+double segmentdistance2(const double* pX, const double* pY, int Begin, int End, int Index) {
+   double sx = pX[End] - pX[Begin], sy = pY[End] - pY[Begin];
+   double px = pX[Index] - pX[Begin], py = pY[Index] - pY[Begin];
+   double length2 = sx * sx + sy * sy;
+   // Distancia al segmento (no a la recta) para no perder picos
+   double t = length2 > 0 ? (px * sx + py * sy) / length2 : 0;
+   t = t < 0 ? 0 : (t > 1 ? 1 : t);
+   double dx = px - t * sx, dy = py - t * sy;
+   return dx * dx + dy * dy;
+}
+
+/** Cuenta los vertices de una geometria */
+size_t countvertices(const OGRGeometry* pGeometry) {
+   switch (wkbFlatten(pGeometry->getGeometryType())) {
+      case wkbPoint:
+         return 1;
+      case wkbLineString:
+      case wkbLinearRing:
+         return static_cast<const OGRLineString*>(pGeometry)->getNumPoints();
+      case wkbPolygon: {
+         const OGRPolygon* ppolygon = static_cast<const OGRPolygon*>(pGeometry);
+         size_t count = 0;
+         if (ppolygon->getExteriorRing() != NULL)
+            count += ppolygon->getExteriorRing()->getNumPoints();
+         for (int i = 0; i < ppolygon->getNumInteriorRings(); ++i)
+            count += ppolygon->getInteriorRing(i)->getNumPoints();
+         return count;
+      }
+      case wkbMultiPoint:
+      case wkbMultiLineString:
+      case wkbMultiPolygon:
+      case wkbGeometryCollection: {
+         const OGRGeometryCollection* pcollection =
+               static_cast<const OGRGeometryCollection*>(pGeometry);
+         size_t count = 0;
+         for (int i = 0; i < pcollection->getNumGeometries(); ++i)
+            count += countvertices(pcollection->getGeometryRef(i));
+         return count;
+      }
+      default:
+         return 0;
+   }
+}
+
+/**
+ * Simplifica los vertices de una linea o anillo sobre la geometria destino.
+ * @param[in] pSource linea original
+ * @param[out] pDestination linea donde se guardan los vertices simplificados
+ * @param[in] Tolerance distancia maxima entre la linea original y la simplificada
+ */
+void simplifylinestring(const OGRLineString* pSource, OGRLineString* pDestination,
+                        double Tolerance) {
+   int pointcount = pSource->getNumPoints();
+   if (pointcount == 0)
+      return;
+   std::vector<double> x(pointcount), y(pointcount);
+   for (int i = 0; i < pointcount; ++i) {
+      x[i] = pSource->getX(i);
+      y[i] = pSource->getY(i);
+   }
+   std::vector<int> kept;
+   ProjectedVectorCache::Simplify(&x[0], &y[0], pointcount, Tolerance, kept);
+   int keptcount = static_cast<int>(kept.size());
+   for (int i = 0; i < keptcount; ++i) {
+      x[i] = x[kept[i]];
+      y[i] = y[kept[i]];
+   }
+   pDestination->setPoints(keptcount, &x[0], &y[0]);
+}
+
+}  // namespace
+
+/**
+ * @param[in] Url ruta del vector
+ * @param[in] MaxVertices cantidad maxima de vertices que puede guardar la cache
+ */
+ProjectedVectorCache::ProjectedVectorCache(const std::string &Url, size_t MaxVertices) :
+      url_(Url), signature_(GetSignature(Url)), maxVertices_(MaxVertices),
+      vertexCount_(0), loaded_(false) {
+   for (int i = 0; i < PROJECTED_VECTOR_CACHE_LEVELS; ++i)
+      levels_[i] = (i == 0);
+}
+
+/** Dtor */
+ProjectedVectorCache::~ProjectedVectorCache() {
+   Clear();
+}
+
+/**
+ * @return true si el vector es un archivo local y no cambio su tamanio ni
+ * su fecha de modificacion desde que se creo la cache
+ */
+bool ProjectedVectorCache::IsCurrent() const {
+   return !signature_.empty() && signature_ == GetSignature(url_);
+}
+
+/**
+ * Si al agregar la geometria se supera la cantidad maxima de vertices se
+ * vacia la cache.
+ * @param[in] FeatureId id del feature en la capa
+ * @param[in] pGeometry geometria en coordenadas de mundo (pasa a ser
+ * responsabilidad de la cache)
+ * @return false si se supero la cantidad maxima de vertices
+ */
+bool ProjectedVectorCache::AddFeature(long FeatureId, OGRGeometry* pGeometry) {
+   size_t vertexcount = countvertices(pGeometry);
+   if (vertexCount_ + vertexcount > maxVertices_) {
+      OGRGeometryFactory::destroyGeometry(pGeometry);
+      Clear();
+      return false;
+   }
+   vertexCount_ += vertexcount;
+   Entry entry;
+   entry.featureId_ = FeatureId;
+   pGeometry->getEnvelope(&entry.envelope_);
+   entry.levels_[0] = pGeometry;
+   for (int i = 1; i < PROJECTED_VECTOR_CACHE_LEVELS; ++i)
+      entry.levels_[i] = NULL;
+   if (entries_.empty())
+      extent_ = entry.envelope_;
+   else
+      extent_.Merge(entry.envelope_);
+   entries_.push_back(entry);
+   return true;
+}
+
+/** Indica que se cargaron todos los features de la capa y arma el indice */
+void ProjectedVectorCache::SetLoaded() {
+   index_.Clear();
+   for (size_t i = 0; i < entries_.size(); ++i)
+      index_.Insert(static_cast<int>(i), entries_[i].envelope_);
+   index_.Build();
+   loaded_ = true;
+}
+
+/** @return true si la cache tiene todos los features de la capa */
+bool ProjectedVectorCache::IsLoaded() const {
+   return loaded_;
+}
+
+/**
+ * Genera el nivel (y los anteriores) si todavia no existe.
+ * @param[in] Tolerance error admitido en unidades de mundo (normalmente una
+ * fraccion del tamanio de pixel)
+ * @return nivel de mayor simplificacion cuya tolerancia no supera Tolerance
+ */
+int ProjectedVectorCache::GetLevel(double Tolerance) {
+   double basetolerance = std::max(extent_.MaxX - extent_.MinX, extent_.MaxY - extent_.MinY)
+         * LEVEL_BASE_TOLERANCE_FRACTION;
+   int level = 0;
+   double leveltolerance = basetolerance;
+   while (basetolerance > 0 && level + 1 < PROJECTED_VECTOR_CACHE_LEVELS
+         && leveltolerance <= Tolerance) {
+      ++level;
+      leveltolerance *= LEVEL_TOLERANCE_FACTOR;
+   }
+   for (int i = 1; i <= level; ++i)
+      if (!levels_[i])
+         BuildLevel(i);
+   return level;
+}
+
+/**
+ * @param[in] Window ventana en coordenadas de mundo
+ * @param[out] Features indices (crecientes) de los features que intersectan
+ * la ventana
+ */
+void ProjectedVectorCache::GetFeatures(const OGREnvelope &Window,
+                                       std::vector<size_t> &Features) const {
+   std::vector<int> ids;
+   index_.Query(Window, ids);
+   Features.assign(ids.begin(), ids.end());
+}
+
+/**
+ * @param[in] Index indice del feature en la cache
+ * @return id del feature en la capa
+ */
+long ProjectedVectorCache::GetFeatureId(size_t Index) const {
+   return entries_[Index].featureId_;
+}
+
+/**
+ * @param[in] Index indice del feature en la cache
+ * @param[in] Level nivel de detalle obtenido con GetLevel
+ * @return geometria en coordenadas de mundo (responsabilidad de la cache)
+ */
+OGRGeometry* ProjectedVectorCache::GetGeometry(size_t Index, int Level) const {
+   return entries_[Index].levels_[Level];
+}
+
+/** @return cantidad de vertices de las geometrias originales */
+size_t ProjectedVectorCache::GetVertexCount() const {
+   return vertexCount_;
+}
+
+/**
+ * Douglas-Peucker iterativo (las lineas pueden tener millones de vertices).
+ * Si la linea es cerrada se divide en el vertice mas lejano al inicial y se
+ * conserva al menos un vertice mas (el mas lejano a esa diagonal) para que el
+ * anillo simplificado no se degenere.
+ * @param[in] pX coordenadas x de la linea
+ * @param[in] pY coordenadas y de la linea
+ * @param[in] Count cantidad de vertices
+ * @param[in] Tolerance distancia maxima entre la linea original y la simplificada
+ * @param[out] Kept indices (crecientes) de los vertices que se conservan
+ */
+void ProjectedVectorCache::Simplify(const double* pX, const double* pY, int Count,
+                                    double Tolerance, std::vector<int> &Kept) {
+   Kept.clear();
+   if (Count <= 2) {
+      for (int i = 0; i < Count; ++i)
+         Kept.push_back(i);
+      return;
+   }
+   int last = Count - 1;
+   std::vector<char> keep(Count, 0);
+   keep[0] = 1;
+   keep[last] = 1;
+   std::vector<std::pair<int, int> > segments;
+   bool closed = pX[0] == pX[last] && pY[0] == pY[last];
+   int diagonal = 0;
+   if (closed) {
+      int farthest = 0;
+      double maxdistance = 0;
+      for (int i = 1; i < last; ++i) {
+         double dx = pX[i] - pX[0], dy = pY[i] - pY[0];
+         double distance = dx * dx + dy * dy;
+         if (distance > maxdistance) {
+            maxdistance = distance;
+            farthest = i;
+         }
+      }
+      if (farthest > 0) {
+         keep[farthest] = 1;
+         diagonal = farthest;
+         segments.push_back(std::make_pair(0, farthest));
+         segments.push_back(std::make_pair(farthest, last));
+      }
+   } else {
+      segments.push_back(std::make_pair(0, last));
+   }
+   double tolerance2 = Tolerance * Tolerance;
+   while (!segments.empty()) {
+      int begin = segments.back().first;
+      int end = segments.back().second;
+      segments.pop_back();
+      if (end - begin < 2)
+         continue;
+      int farthest = -1;
+      double maxdistance = tolerance2;
+      for (int i = begin + 1; i < end; ++i) {
+         double distance = segmentdistance2(pX, pY, begin, end, i);
+         if (distance > maxdistance) {
+            maxdistance = distance;
+            farthest = i;
+         }
+      }
+      if (farthest >= 0) {
+         keep[farthest] = 1;
+         segments.push_back(std::make_pair(begin, farthest));
+         segments.push_back(std::make_pair(farthest, end));
+      }
+   }
+   // Un anillo con solo la diagonal no tiene area: se agrega el vertice mas
+   // lejano a la diagonal (si no es colineal).
+   if (closed && diagonal > 0 && std::count(keep.begin(), keep.end(), 1) < 4) {
+      int farthest = -1;
+      double maxdistance = 0;
+      for (int i = 1; i < last; ++i) {
+         double distance = segmentdistance2(pX, pY, 0, diagonal, i);
+         if (i != diagonal && distance > maxdistance) {
+            maxdistance = distance;
+            farthest = i;
+         }
+      }
+      if (farthest > 0)
+         keep[farthest] = 1;
+   }
+   for (int i = 0; i < Count; ++i)
+      if (keep[i])
+         Kept.push_back(i);
+}
+
+/**
+ * @param[in] Url ruta del vector
+ * @return tamanio y fecha de modificacion del archivo, vacio si no es un
+ * archivo local
+ */
+std::string ProjectedVectorCache::GetSignature(const std::string &Url) {
+   wxFileName filename(wxString(Url.c_str(), wxConvUTF8));
+   if (!filename.FileExists())
+      return std::string();
+   std::ostringstream signature;
+   signature << GetFileSize(Url) << ":" << filename.GetModificationTime().GetTicks();
+   return signature.str();
+}
+
+/** Elimina todas las geometrias */
+void ProjectedVectorCache::Clear() {
+   for (size_t i = 0; i < entries_.size(); ++i)
+      for (int level = 0; level < PROJECTED_VECTOR_CACHE_LEVELS; ++level)
+         if (entries_[i].levels_[level] != NULL)
+            OGRGeometryFactory::destroyGeometry(entries_[i].levels_[level]);
+   entries_.clear();
+   index_.Clear();
+   vertexCount_ = 0;
+   loaded_ = false;
+   for (int i = 1; i < PROJECTED_VECTOR_CACHE_LEVELS; ++i)
+      levels_[i] = false;
+}
+
+/**
+ * Cada nivel se simplifica a partir del anterior, que ya tiene menos vertices.
+ * @param[in] Level nivel a generar (el anterior debe existir)
+ */
+void ProjectedVectorCache::BuildLevel(int Level) {
+   double tolerance = std::max(extent_.MaxX - extent_.MinX, extent_.MaxY - extent_.MinY)
+         * LEVEL_BASE_TOLERANCE_FRACTION;
+   for (int i = 1; i < Level; ++i)
+      tolerance *= LEVEL_TOLERANCE_FACTOR;
+   for (size_t i = 0; i < entries_.size(); ++i)
+      entries_[i].levels_[Level] = Simplify(entries_[i].levels_[Level - 1], tolerance);
+   levels_[Level] = true;
+}
+
+/**
+ * Los anillos interiores que quedan con menos de 4 vertices se descartan.
+ * @param[in] pGeometry geometria a simplificar
+ * @param[in] Tolerance distancia maxima entre la geometria original y la
+ * simplificada
+ * @return geometria simplificada (responsabilidad del invocante)
+ */
+OGRGeometry* ProjectedVectorCache::Simplify(const OGRGeometry* pGeometry,
+                                            double Tolerance) {
+   switch (wkbFlatten(pGeometry->getGeometryType())) {
+      case wkbLineString: {
+         OGRLineString* pline = new OGRLineString;
+         simplifylinestring(static_cast<const OGRLineString*>(pGeometry), pline, Tolerance);
+         return pline;
+      }
+      case wkbLinearRing: {
+         OGRLinearRing* pring = new OGRLinearRing;
+         simplifylinestring(static_cast<const OGRLineString*>(pGeometry), pring, Tolerance);
+         return pring;
+      }
+      case wkbPolygon: {
+         const OGRPolygon* psource = static_cast<const OGRPolygon*>(pGeometry);
+         OGRPolygon* ppolygon = new OGRPolygon;
+         if (psource->getExteriorRing() != NULL) {
+            OGRLinearRing* pring = new OGRLinearRing;
+            simplifylinestring(psource->getExteriorRing(), pring, Tolerance);
+            ppolygon->addRingDirectly(pring);
+         }
+         for (int i = 0; i < psource->getNumInteriorRings(); ++i) {
+            OGRLinearRing* pring = new OGRLinearRing;
+            simplifylinestring(psource->getInteriorRing(i), pring, Tolerance);
+            if (pring->getNumPoints() < 4)
+               delete pring;
+            else
+               ppolygon->addRingDirectly(pring);
+         }
+         return ppolygon;
+      }
+      case wkbMultiLineString:
+      case wkbMultiPolygon:
+      case wkbGeometryCollection: {
+         const OGRGeometryCollection* psource =
+               static_cast<const OGRGeometryCollection*>(pGeometry);
+         OGRGeometryCollection* pcollection = static_cast<OGRGeometryCollection*>(
+               OGRGeometryFactory::createGeometry(wkbFlatten(pGeometry->getGeometryType())));
+         for (int i = 0; i < psource->getNumGeometries(); ++i)
+            pcollection->addGeometryDirectly(Simplify(psource->getGeometryRef(i), Tolerance));
+         return pcollection;
+      }
+      default:
+         return pGeometry->clone();
+   }
+}
+
+}  // namespace suri
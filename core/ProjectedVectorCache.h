@@ -0,0 +1,127 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef PROJECTEDVECTORCACHE_H_
+#define PROJECTEDVECTORCACHE_H_
+
+// Includes estandar
+#include <string>
+#include <vector>
+
+// Includes Suri
+#include "SpatialIndex.h"
+
+// Includes Wx
+
+// Includes App
+#include "ogr_core.h"
+
+// Defines
+/** Cantidad de niveles de detalle (el nivel 0 es la geometria original) */
+#define PROJECTED_VECTOR_CACHE_LEVELS 9
+
+// forwards
+class OGRGeometry;
+
+namespace suri {
+
+/** Cache de geometrias de una capa ya reproyectadas al sistema del mundo */
+/**
+ *  Guarda las geometrias de todos los features de una capa en coordenadas de
+ * mundo junto con su envolvente, de forma que al desplazar o cambiar la
+ * escala no sea necesario volver a leer ni a reproyectar la capa.
+ *  Para cada geometria mantiene niveles de detalle simplificados con
+ * Douglas-Peucker. La tolerancia del nivel 1 es una fraccion de la extension
+ * de la capa y cada nivel siguiente la multiplica por 4; los niveles se
+ * generan la primera vez que se piden.
+ *  La cache se invalida si cambia el tamanio o la fecha de modificacion del
+ * archivo del vector (solo se usa con archivos locales).
+ */
+class ProjectedVectorCache {
+   /** Ctor. de Copia. */
+   ProjectedVectorCache(const ProjectedVectorCache &ProjectedVectorCache);
+
+public:
+   /** Ctor */
+   ProjectedVectorCache(const std::string &Url, size_t MaxVertices);
+   /** Dtor */
+   ~ProjectedVectorCache();
+   /** Indica si el vector es un archivo local que no cambio desde que se creo la cache */
+   bool IsCurrent() const;
+   /** Agrega la geometria (en coordenadas de mundo) de un feature */
+   bool AddFeature(long FeatureId, OGRGeometry* pGeometry);
+   /** Indica que se cargaron todos los features de la capa */
+   void SetLoaded();
+   /** Indica si la cache tiene la capa completa */
+   bool IsLoaded() const;
+   /** Devuelve el nivel de detalle adecuado para una tolerancia en unidades de mundo */
+   int GetLevel(double Tolerance);
+   /** Busca los features cuya envolvente intersecta la ventana (luego de SetLoaded) */
+   void GetFeatures(const OGREnvelope &Window, std::vector<size_t> &Features) const;
+   /** Devuelve el id de un feature de la cache */
+   long GetFeatureId(size_t Index) const;
+   /** Devuelve la geometria de un feature en un nivel de detalle */
+   OGRGeometry* GetGeometry(size_t Index, int Level) const;
+   /** Devuelve la cantidad de vertices de la geometria original */
+   size_t GetVertexCount() const;
+
+   /** Simplifica una polilinea con Douglas-Peucker */
+   static void Simplify(const double* pX, const double* pY, int Count, double Tolerance,
+                        std::vector<int> &Kept);
+   /** Devuelve la firma (tamanio y fecha de modificacion) de un archivo local */
+   static std::string GetSignature(const std::string &Url);
+
+private:
+   /** Datos de un feature */
+   class Entry {
+   public:
+      long featureId_; /*! Id del feature en la capa */
+      OGREnvelope envelope_; /*! Envolvente en coordenadas de mundo */
+      OGRGeometry* levels_[PROJECTED_VECTOR_CACHE_LEVELS]; /*! Niveles de detalle */
+   };
+
+   /** Elimina todas las geometrias */
+   void Clear();
+   /** Genera un nivel de detalle a partir del nivel anterior */
+   void BuildLevel(int Level);
+   /** Devuelve una copia simplificada de una geometria */
+   static OGRGeometry* Simplify(const OGRGeometry* pGeometry, double Tolerance);
+
+   std::string url_; /*! Ruta del vector */
+   std::string signature_; /*! Firma del vector al crear la cache */
+   size_t maxVertices_; /*! Cantidad maxima de vertices a guardar */
+   size_t vertexCount_; /*! Cantidad de vertices de las geometrias originales */
+   bool loaded_; /*! Se cargaron todos los features */
+   OGREnvelope extent_; /*! Extension de la capa en coordenadas de mundo */
+   bool levels_[PROJECTED_VECTOR_CACHE_LEVELS]; /*! Niveles generados */
+   std::vector<Entry> entries_; /*! Features de la capa */
+   SpatialIndex index_; /*! Indice de las envolventes (se arma en SetLoaded) */
+};
+
+}  // namespace suri
+
+#endif  // PROJECTEDVECTORCACHE_H_
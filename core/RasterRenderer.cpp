@@ -28,6 +28,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 // Include standard
 #include <sstream>
 #include <algorithm>
+#include <cstdlib>
 #include <map>
 #include <string>
 
@@ -49,6 +50,10 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "suri/ParameterCollection.h"
 #include "suri/TransformationFactory.h"
 #include "suri/TransformationFactoryBuilder.h"
+
+// Includes Wx
+#include "wx/thread.h"
+
 // Define
 #define URI_FORMAT_KEY "format"
 #define URI_DATASET_KEY "dataset"
@@ -57,22 +62,166 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #  define __CUSTOM_CANVAS_OFFSET_FIX__
 #endif
 #define NOT_VALID_DATA_VALUE "valor_no_valido"
+/** Cantidad maxima de ventanas leidas por adelantado (doble buffer) */
+#define MAX_READ_AHEAD_WINDOWS 2
 /** Macro para registrar el renderer */
 AUTO_REGISTER_RENDERER(suri::RasterRenderer);
 
 /** namespace suri */
 namespace suri {
+
+/** Hilo que lee por adelantado un subset de imagen para RasterRenderer */
+/**
+ *  Lee con su propia imagen (abierta por el renderizador sobre el mismo
+ * archivo) de manera de no compartir la cadena de fuentes con la imagen que
+ * se usa para renderizar. Los datos leidos quedan en el hilo hasta que el
+ * renderizador los toma con TakeData.
+ */
+class RasterReadAhead : public wxThread {
+public:
+   /** Ctor */
+   RasterReadAhead(Image *pImage, const std::vector<int> &Bands,
+                   const RasterRenderer::ReadWindow &Window, int SizeX, int SizeY);
+   /** Dtor */
+   virtual ~RasterReadAhead();
+   /** Lanza el hilo */
+   bool Start();
+   /** Espera a que termine la lectura */
+   bool Finish();
+   /** Indica si la lectura corresponde al subset indicado */
+   bool Matches(const std::vector<int> &Bands, int Ulx, int Uly, int Lrx, int Lry,
+                int SizeX, int SizeY) const;
+   /** Reemplaza los buffers de Data por los datos leidos */
+   void TakeData(std::vector<void*> &Data);
+   /** Lee el subset */
+   virtual ExitCode Entry();
+
+private:
+   Image *pImage_; /*! imagen de lectura anticipada */
+   std::vector<int> bands_; /*! bandas a leer */
+   RasterRenderer::ReadWindow window_; /*! subset a leer */
+   int sizeX_; /*! ancho de la imagen (decimada) al leer */
+   int sizeY_; /*! alto de la imagen (decimada) al leer */
+   std::vector<void*> data_; /*! datos leidos */
+   bool status_; /*! resultado de la lectura */
+   bool started_; /*! indica si se lanzo el hilo */
+   bool joined_; /*! indica si ya se espero al hilo */
+};
+
+/**
+ * @param[in] pImage imagen con la que se lee (no debe usarse en otro hilo
+ *            hasta que termine la lectura)
+ * @param[in] Bands bandas a leer
+ * @param[in] Window subset a leer calculado con CalculateReadWindow
+ * @param[in] SizeX ancho de la imagen (decimada) esperado
+ * @param[in] SizeY alto de la imagen (decimada) esperado
+ */
+RasterReadAhead::RasterReadAhead(Image *pImage, const std::vector<int> &Bands,
+                                 const RasterRenderer::ReadWindow &Window, int SizeX,
+                                 int SizeY) :
+      wxThread(wxTHREAD_JOINABLE), pImage_(pImage), bands_(Bands), window_(Window),
+      sizeX_(SizeX), sizeY_(SizeY), data_(Bands.size(), NULL), status_(false),
+      started_(false), joined_(false) {
+}
+
+/** Dtor. Espera a que termine la lectura y libera los datos no tomados. */
+RasterReadAhead::~RasterReadAhead() {
+   Finish();
+   for (size_t i = 0; i < data_.size(); ++i)
+      delete[] static_cast<unsigned char*>(data_[i]);
+}
+
+/**
+ * @return true si se pudo lanzar el hilo
+ */
+bool RasterReadAhead::Start() {
+   started_ = Create() == wxTHREAD_NO_ERROR && Run() == wxTHREAD_NO_ERROR;
+   return started_;
+}
+
+/**
+ * Espera (una sola vez) a que el hilo termine.
+ * @return true si la lectura fue exitosa
+ */
+bool RasterReadAhead::Finish() {
+   if (started_ && !joined_) {
+      Wait();
+      joined_ = true;
+   }
+   return joined_ && status_;
+}
+
+/**
+ * @param[in] Bands bandas a leer
+ * @param[in] Ulx UL x del subset
+ * @param[in] Uly UL y del subset
+ * @param[in] Lrx LR x del subset
+ * @param[in] Lry LR y del subset
+ * @param[in] SizeX ancho de la imagen (decimada)
+ * @param[in] SizeY alto de la imagen (decimada)
+ * @return true si los datos leidos corresponden a los parametros
+ */
+bool RasterReadAhead::Matches(const std::vector<int> &Bands, int Ulx, int Uly, int Lrx,
+                              int Lry, int SizeX, int SizeY) const {
+   return bands_ == Bands && window_.ulx_ == Ulx && window_.uly_ == Uly
+         && window_.lrx_ == Lrx && window_.lry_ == Lry && sizeX_ == SizeX
+         && sizeY_ == SizeY;
+}
+
+/**
+ * \pre Finish debe haber retornado true
+ * @param[in] Data buffers a reemplazar (se eliminan)
+ * @param[out] Data buffers con los datos leidos
+ */
+void RasterReadAhead::TakeData(std::vector<void*> &Data) {
+   for (size_t i = 0; i < Data.size() && i < data_.size(); ++i) {
+      delete[] static_cast<unsigned char*>(Data[i]);
+      Data[i] = data_[i];
+      data_[i] = NULL;
+   }
+}
+
+/**
+ * Agrega el decimador si corresponde y lee el subset en buffers propios.
+ * @return 0
+ */
+wxThread::ExitCode RasterReadAhead::Entry() {
+   Decimate decimate(window_.decimatedX_, window_.decimatedY_);
+   decimate.SetResampling(window_.resampling_);
+   decimate.SetNoDataValue(window_.noDataValueAvailable_, window_.noDataValue_);
+   if (window_.isDecimating_) {
+      pImage_->PushSource(&decimate);
+   }
+   int sizex = 0, sizey = 0;
+   pImage_->GetSize(sizex, sizey);
+   // si la imagen no coincide con la del renderizador no se lee
+   if (sizex == sizeX_ && sizey == sizeY_) {
+      int buffersize = std::abs((window_.lrx_ - window_.ulx_) * (window_.lry_ - window_.uly_)
+            * pImage_->GetDataSize());
+      for (size_t i = 0; i < data_.size(); ++i)
+         data_[i] = new unsigned char[buffersize];
+      status_ = pImage_->Read(bands_, data_, window_.ulx_, window_.uly_, window_.lrx_,
+                              window_.lry_);
+   }
+   if (window_.isDecimating_) {
+      pImage_->PopSource();
+   }
+   return 0;
+}
+
 /**
  * Constructor
  */
 RasterRenderer::RasterRenderer() :
-      pImage_(NULL), pMask_(NULL), changed_(true) {
+      pImage_(NULL), pMask_(NULL), changed_(true), pReadAheadImage_(NULL) {
 }
 
 /**
  * Destructor
  */
 RasterRenderer::~RasterRenderer() {
+   CancelReadAhead();
+   Image::Close(pReadAheadImage_);
    Image::Close(pImage_);
 }
 
@@ -161,7 +310,12 @@ RasterRenderer::Parameters RasterRenderer::GetParameters(const wxXmlNode *pNode)
          while (pcnode != NULL) {
             if (pcnode->GetName() == BAND_COMBINATION_NODE) {
                bandcombination = pcnode->GetNodeContent().c_str();
-               break;
+            } else if (pcnode->GetName() == INTERPOLATION_NODE) {
+               wxString interpolation;
+               if (pcnode->GetPropVal(wxT(INTERPOLATION_PROPERTY_ZOOM_OUT),
+                                      &interpolation)) {
+                  Resampler::GetType(interpolation.c_str(), params.zoomOutResampling_);
+               }
             }
             pcnode = pcnode->GetNext();
          }
@@ -179,7 +333,8 @@ RasterRenderer::Parameters RasterRenderer::GetParameters(const wxXmlNode *pNode)
       pnode = pnode->GetNext();
    }
    params.bandCombination_ = split<int>(bandcombination);
-   // Siempre usa decimacion (NN) para la lectura
+   // Siempre usa decimacion para la lectura (NN salvo que se indique otro
+   // remuestreo en el nodo interpolacion)
    params.readFunction_ = RasterRenderer::Parameters::Decimate;
    return params;
 }
@@ -302,127 +457,10 @@ bool RasterRenderer::Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pM
    RasterSpatialModel::Destroy(prastermodel);
 
    // windowsubset debe estar en PixelLinea
-   // ancho y alto en pixeles de imagen de la ventana (puede ser mayor o menor)
-   double wwidth = windowsubset.lr_.x_ - windowsubset.ul_.x_;
-   double wheigth = windowsubset.lr_.y_ - windowsubset.ul_.y_;
-
-   int imgx, imgy;
-   pImage_->GetSize(imgx, imgy);
-
-   double ulx = std::max(static_cast<double>(0), windowsubset.ul_.x_),
-           uly = std::max(static_cast<double>(0), windowsubset.ul_.y_),
-           lrx = std::min(static_cast<double>(imgx), windowsubset.lr_.x_),
-           lry = std::min(static_cast<double>(imgy), windowsubset.lr_.y_);
-
-   double offsetx = -std::min(static_cast<double>(0), windowsubset.ul_.x_),
-           offsety = -std::min(static_cast<double>(0), windowsubset.ul_.y_);
-
-   // me aseguro un subset UL-LR correcto
-   ulx = std::min(ulx, lrx);
-   uly = std::min(uly, lry);
-   lrx = std::max(lrx, ulx);
-   lry = std::max(lry, uly);
-   // coordenadas de subset
-   int imgulx = SURI_TRUNC(int, ulx), imguly = SURI_TRUNC(int, uly), imglrx =
-         SURI_TRUNC(int, SURI_CEIL(lrx)), imglry = SURI_TRUNC(int, SURI_CEIL(lry));
-   int imgoffsetx = SURI_TRUNC(int, SURI_CEIL(offsetx)), imgoffsety =
-         SURI_TRUNC(int, SURI_CEIL(offsety));
-   // tamanio del subset de imagen leido
-   int subsetw = (imglrx - imgulx), subseth = (imglry - imguly);
-   bool isdecimating = false;
-   // Calculo la dimension de la imagen (considerando la posibilidad de
-   // window > world, en coordenadas de PL de la imagen)
-   // Se hace el min antes de la conversion para que no se exeda el limite
-   // de int cuando hay mucho zoom
-   int destx = SURI_TRUNC(int, std::min(static_cast<double>(imgx),
-               SURI_CEIL(imgx/wwidth*vpwidth)));
-   int desty = SURI_TRUNC(int, std::min(static_cast<double>(imgy),
-               SURI_CEIL(imgy/wheigth*vpheight)));
-   REPORT_DEBUG("D:Dimension de la imagen destino = (%d;%d)", destx, desty);
    // decimador al tamano decimado segun la relacion entre window y viewport
-   Decimate decimate(destx, desty);
-   // diferencia (en px) entre el subset a leer y el subset de la imagen (real)
-   Dimension dim(windowsubset);
-   // Correccion esta para que el calculo del plusx(y) considere el offset que se
-   // elimina al hacer trunc del offsetx(y).
-   double correccionx = windowsubset.ul_.x_ - SURI_TRUNC(int, windowsubset.ul_.x_),
-         correcciony = windowsubset.ul_.y_ - SURI_TRUNC(int, windowsubset.ul_.y_);
-   correccionx = correccionx < 0 ? 1 + correccionx : correccionx;
-   correcciony = correcciony < 0 ? 1 + correcciony : correcciony;
-   int plusx = static_cast<int>(
-              dim.GetWidth() + correccionx - subsetw - imgoffsetx < 0 ? 0 :
-                 SURI_CEIL(dim.GetWidth()+correccionx-subsetw-imgoffsetx)),
-         plusy = static_cast<int>(
-              dim.GetHeight() + correcciony - subseth - imgoffsety < 0 ? 0 :
-                 SURI_CEIL(dim.GetHeight()+correcciony-subseth-imgoffsety));
-
-   // veo si tengo que decimar en alguna dimension
-   // if (subsetw>vpwidth||subseth>vpheight) esto falla si la imagen es chica
-   // Las condicion 3 y 4 estan por problemas de redondeo cuando el tamano del
-   // canvas es similar al de la imagen contenida en el mundo.
-   if (destx < imgx || desty < imgy || (imgx + 1 >= SURI_CEIL(imgx/wwidth*vpwidth))
-         || (imgy + 1 >= SURI_CEIL(imgy/wheigth*vpheight))) {         // esto anda si la
-                                                                      // imagen es chica o
-                                                                      // grande
-      REPORT_DEBUG("D:Decimando la imagen");
-      isdecimating = true;
-      pImage_->PushSource(&decimate);
-      // El offset se redondea para reducir el error en el comienzo de la imagen
-      imgoffsetx = SURI_ROUND(int, offsetx/wwidth*vpwidth);
-      imgoffsety = SURI_ROUND(int, offsety/wheigth*vpheight);
-#ifdef __UNUSED_CODE__
-      // Calcula el offset como la posicion del UL de la ventana o el Raster
-      // en coordenadas del viewport.
-      // Elimina la dependencia para este calculo del factor de decimado de la
-      // imagen y previene el error numerico
-      Subset window;
-      pWorldWindow->GetWindow(window);
-      Dimension dim(window);
-      {
-         double ulx = 0, uly = 0, lrx = 0, lry = 0;
-         GetBoundingBox(pWorldWindow, ulx, uly, lrx, lry);
-         Subset win(ulx, uly, lrx, lry);
-         Subset intersection = Intersect(window, win);
-         pWorldWindow->W2VTransform(intersection.ul_.x_, intersection.ul_.y_,
-               imgoffsetx, imgoffsety);
-      }
-#endif
-      // calculo el subset de imagen que debo leer
-      // busco el UL y LR de la imagen, en coordenadas de VP-Img(decimada)
-      decimate.Real2Resized(ulx, uly, ulx, uly);
-      decimate.Real2Resized(lrx, lry, lrx, lry);
-      // El comienzo de la imagen se redondea para disminuir el error al comienzo de la imagen
-      imgulx = SURI_ROUND(int, ulx);
-      imguly = SURI_ROUND(int, uly);
-      // El final de la imagen se redondea al limite superior para que no quede linea negra al final
-      imglrx = SURI_ROUND(int, SURI_CEIL(lrx) );
-      imglry = SURI_ROUND(int, SURI_CEIL(lry) );
-      // me aseguro que no haya plus negativos (subset>canvas) al decimar
-      subsetw = std::min(imglrx - imgulx, vpwidth);
-      subseth = std::min(imglry - imguly, vpheight);
-      // evita que plus<0 cuando imagen aumenta uno o dos pixeles al hacer round de imagen u offset
-      // hacia arriva
-      if (vpwidth - subsetw - imgoffsetx < 0) {
-         subsetw = vpwidth - imgoffsetx;
-      }
-      if (vpheight - subseth - imgoffsety < 0) {
-         subseth = vpheight - imgoffsety;
-      }
-
-      // fijo el subset a leer con el ancho/alto modificado
-      imglrx = imgulx + subsetw;
-      imglry = imguly + subseth;
-
-      plusx = vpwidth - subsetw - imgoffsetx;
-      plusy = vpheight - subseth - imgoffsety;
-   }REPORT_DEBUG("D:Pluses %d;%d", plusx, plusy);
-   assert(plusx >= 0 && plusy >= 0);
-
-   REPORT_DEBUG("D:Subset a leer (%d;%d , %d;%d) %dx%d",
-                imgulx, imguly, imglrx, imglry, subsetw, subseth);
-   REPORT_DEBUG("D:Subset real (%.2f; %.2f , %.2f; %.2f) %.2fx%.2f",
-                ulx, uly, lrx, lry, wwidth, wheigth);
-   REPORT_DEBUG("D:Offset en el canvas %d;%d", imgoffsetx, imgoffsety);
+   Decimate decimate(0, 0);
+   ReadWindow read;
+   CalculateReadWindow(pWorldWindow, windowsubset, pImage_, decimate, read);
 
    // -------------------------------------------------------------------------
    // a partir de aca pImage_ se encuentra en coordenadas del sistema del ViewPort
@@ -433,19 +471,20 @@ bool RasterRenderer::Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pM
       if (pCanvas->GetDataType() != pImage_->GetDataType() ||
             static_cast<size_t>(pCanvas->GetBandCount()) !=
                            parameters_.bandCombination_.size() ||
-            pCanvas->GetSizeX() != subsetw + imgoffsetx + plusx ||
-            pCanvas->GetSizeY() != subseth + imgoffsety + plusy) {
+            pCanvas->GetSizeX() != read.subsetWidth_ + read.offsetX_ + read.plusX_ ||
+            pCanvas->GetSizeY() != read.subsetHeight_ + read.offsetY_ + read.plusY_) {
          pCanvas->SetDataType(pImage_->GetDataType());
          pCanvas->SetBandCount(parameters_.bandCombination_.size());
-         pCanvas->SetSize(subsetw + imgoffsetx + plusx, subseth + imgoffsety + plusy);
+         pCanvas->SetSize(read.subsetWidth_ + read.offsetX_ + read.plusX_,
+                          read.subsetHeight_ + read.offsetY_ + read.plusY_);
       }
    } CATCH {
       REPORT_DEBUG("D:No se pudo inicializar el canvas en forma correcta");
       return false;
    }
 
-   if (!ReadImageData(pImage_, pCanvas, pMask, imgulx, imguly, imglrx, imglry, subsetw, subseth,
-                 imgoffsetx, imgoffsety))
+   if (!ReadImageData(pImage_, pCanvas, pMask, read.ulx_, read.uly_, read.lrx_, read.lry_,
+                      read.subsetWidth_, read.subsetHeight_, read.offsetX_, read.offsetY_))
       return false;
    // Controla que el canvas sea compatible en lugar de modificarlo
 #ifdef __UNUSED_CODE__
@@ -457,15 +496,15 @@ bool RasterRenderer::Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pM
    }
    int cx, cy;
    pCanvas->GetSize(cx, cy);
-   int wantedx = subsetw + imgoffsetx + plusx,
-         wantedy = subseth + imgoffsety + plusy;
+   int wantedx = read.subsetWidth_ + read.offsetX_ + read.plusX_,
+         wantedy = read.subsetHeight_ + read.offsetY_ + read.plusY_;
    if (cx != wantedx || cy != wantedy) {
       REPORT_DEBUG("D: Canvas configurado en forma incorrecta");
       return false;
    }
 #endif
    // si tiene el decimador
-   if (isdecimating) {
+   if (read.isDecimating_) {
       pImage_->PopSource();
    }
 
@@ -668,6 +707,277 @@ bool RasterRenderer::IsDirty() {
    return changed_;
 }
 
+/**
+ *  Calcula el subset de imagen que se debe leer para renderizar la ventana
+ * del mundo y la posicion que ocupa en el canvas. Si la relacion entre la
+ * ventana y el viewport lo requiere agrega el decimador a la imagen.
+ * \post Si Window.isDecimating_ es true Decimator queda agregado a pImage y
+ *       se debe sacar con PopSource luego de leer.
+ * @param[in] pWorldWindow mundo con la ventana a renderizar
+ * @param[in] WindowSubset ventana en coordenadas P,L de la imagen
+ * @param[in] pImage imagen a leer
+ * @param[in] Decimator decimador que se agrega a la imagen si es necesario
+ * @param[out] Window subset a leer y posicion en el canvas
+ */
+void RasterRenderer::CalculateReadWindow(const World *pWorldWindow,
+                                         const Subset &WindowSubset, Image *pImage,
+                                         Decimate &Decimator, ReadWindow &Window) const {
+   int vpwidth, vpheight;
+   pWorldWindow->GetViewport(vpwidth, vpheight);
+   // ancho y alto en pixeles de imagen de la ventana (puede ser mayor o menor)
+   double wwidth = WindowSubset.lr_.x_ - WindowSubset.ul_.x_;
+   double wheigth = WindowSubset.lr_.y_ - WindowSubset.ul_.y_;
+
+   int imgx, imgy;
+   pImage->GetSize(imgx, imgy);
+
+   double ulx = std::max(static_cast<double>(0), WindowSubset.ul_.x_),
+           uly = std::max(static_cast<double>(0), WindowSubset.ul_.y_),
+           lrx = std::min(static_cast<double>(imgx), WindowSubset.lr_.x_),
+           lry = std::min(static_cast<double>(imgy), WindowSubset.lr_.y_);
+
+   double offsetx = -std::min(static_cast<double>(0), WindowSubset.ul_.x_),
+           offsety = -std::min(static_cast<double>(0), WindowSubset.ul_.y_);
+
+   // me aseguro un subset UL-LR correcto
+   ulx = std::min(ulx, lrx);
+   uly = std::min(uly, lry);
+   lrx = std::max(lrx, ulx);
+   lry = std::max(lry, uly);
+   // coordenadas de subset
+   int imgulx = SURI_TRUNC(int, ulx), imguly = SURI_TRUNC(int, uly), imglrx =
+         SURI_TRUNC(int, SURI_CEIL(lrx)), imglry = SURI_TRUNC(int, SURI_CEIL(lry));
+   int imgoffsetx = SURI_TRUNC(int, SURI_CEIL(offsetx)), imgoffsety =
+         SURI_TRUNC(int, SURI_CEIL(offsety));
+   // tamanio del subset de imagen leido
+   int subsetw = (imglrx - imgulx), subseth = (imglry - imguly);
+   bool isdecimating = false;
+   // Calculo la dimension de la imagen (considerando la posibilidad de
+   // window > world, en coordenadas de PL de la imagen)
+   // Se hace el min antes de la conversion para que no se exeda el limite
+   // de int cuando hay mucho zoom
+   int destx = SURI_TRUNC(int, std::min(static_cast<double>(imgx),
+               SURI_CEIL(imgx/wwidth*vpwidth)));
+   int desty = SURI_TRUNC(int, std::min(static_cast<double>(imgy),
+               SURI_CEIL(imgy/wheigth*vpheight)));
+   REPORT_DEBUG("D:Dimension de la imagen destino = (%d;%d)", destx, desty);
+   // decimador al tamano decimado segun la relacion entre window y viewport
+   Decimator.SetSize(destx, desty);
+   Decimator.SetResampling(parameters_.zoomOutResampling_);
+   Decimator.SetNoDataValue(parameters_.generateMask_, parameters_.noDataValue_);
+   Window.resampling_ = parameters_.zoomOutResampling_;
+   Window.noDataValueAvailable_ = parameters_.generateMask_;
+   Window.noDataValue_ = parameters_.noDataValue_;
+   // diferencia (en px) entre el subset a leer y el subset de la imagen (real)
+   Dimension dim(WindowSubset);
+   // Correccion esta para que el calculo del plusx(y) considere el offset que se
+   // elimina al hacer trunc del offsetx(y).
+   double correccionx = WindowSubset.ul_.x_ - SURI_TRUNC(int, WindowSubset.ul_.x_),
+         correcciony = WindowSubset.ul_.y_ - SURI_TRUNC(int, WindowSubset.ul_.y_);
+   correccionx = correccionx < 0 ? 1 + correccionx : correccionx;
+   correcciony = correcciony < 0 ? 1 + correcciony : correcciony;
+   int plusx = static_cast<int>(
+              dim.GetWidth() + correccionx - subsetw - imgoffsetx < 0 ? 0 :
+                 SURI_CEIL(dim.GetWidth()+correccionx-subsetw-imgoffsetx)),
+         plusy = static_cast<int>(
+              dim.GetHeight() + correcciony - subseth - imgoffsety < 0 ? 0 :
+                 SURI_CEIL(dim.GetHeight()+correcciony-subseth-imgoffsety));
+
+   // veo si tengo que decimar en alguna dimension
+   // if (subsetw>vpwidth||subseth>vpheight) esto falla si la imagen es chica
+   // Las condicion 3 y 4 estan por problemas de redondeo cuando el tamano del
+   // canvas es similar al de la imagen contenida en el mundo.
+   if (destx < imgx || desty < imgy || (imgx + 1 >= SURI_CEIL(imgx/wwidth*vpwidth))
+         || (imgy + 1 >= SURI_CEIL(imgy/wheigth*vpheight))) {         // esto anda si la
+                                                                      // imagen es chica o
+                                                                      // grande
+      REPORT_DEBUG("D:Decimando la imagen");
+      isdecimating = true;
+      pImage->PushSource(&Decimator);
+      // El offset se redondea para reducir el error en el comienzo de la imagen
+      imgoffsetx = SURI_ROUND(int, offsetx/wwidth*vpwidth);
+      imgoffsety = SURI_ROUND(int, offsety/wheigth*vpheight);
+#ifdef __UNUSED_CODE__
+      // Calcula el offset como la posicion del UL de la ventana o el Raster
+      // en coordenadas del viewport.
+      // Elimina la dependencia para este calculo del factor de decimado de la
+      // imagen y previene el error numerico
+      Subset window;
+      pWorldWindow->GetWindow(window);
+      Dimension dim(window);
+      {
+         double ulx = 0, uly = 0, lrx = 0, lry = 0;
+         GetBoundingBox(pWorldWindow, ulx, uly, lrx, lry);
+         Subset win(ulx, uly, lrx, lry);
+         Subset intersection = Intersect(window, win);
+         pWorldWindow->W2VTransform(intersection.ul_.x_, intersection.ul_.y_,
+               imgoffsetx, imgoffsety);
+      }
+#endif
+      // calculo el subset de imagen que debo leer
+      // busco el UL y LR de la imagen, en coordenadas de VP-Img(decimada)
+      Decimator.Real2Resized(ulx, uly, ulx, uly);
+      Decimator.Real2Resized(lrx, lry, lrx, lry);
+      // El comienzo de la imagen se redondea para disminuir el error al comienzo de la imagen
+      imgulx = SURI_ROUND(int, ulx);
+      imguly = SURI_ROUND(int, uly);
+      // El final de la imagen se redondea al limite superior para que no quede linea negra al final
+      imglrx = SURI_ROUND(int, SURI_CEIL(lrx) );
+      imglry = SURI_ROUND(int, SURI_CEIL(lry) );
+      // me aseguro que no haya plus negativos (subset>canvas) al decimar
+      subsetw = std::min(imglrx - imgulx, vpwidth);
+      subseth = std::min(imglry - imguly, vpheight);
+      // evita que plus<0 cuando imagen aumenta uno o dos pixeles al hacer round de imagen u offset
+      // hacia arriva
+      if (vpwidth - subsetw - imgoffsetx < 0) {
+         subsetw = vpwidth - imgoffsetx;
+      }
+      if (vpheight - subseth - imgoffsety < 0) {
+         subseth = vpheight - imgoffsety;
+      }
+
+      // fijo el subset a leer con el ancho/alto modificado
+      imglrx = imgulx + subsetw;
+      imglry = imguly + subseth;
+
+      plusx = vpwidth - subsetw - imgoffsetx;
+      plusy = vpheight - subseth - imgoffsety;
+   }REPORT_DEBUG("D:Pluses %d;%d", plusx, plusy);
+   assert(plusx >= 0 && plusy >= 0);
+
+   REPORT_DEBUG("D:Subset a leer (%d;%d , %d;%d) %dx%d",
+                imgulx, imguly, imglrx, imglry, subsetw, subseth);
+   REPORT_DEBUG("D:Subset real (%.2f; %.2f , %.2f; %.2f) %.2fx%.2f",
+                ulx, uly, lrx, lry, wwidth, wheigth);
+   REPORT_DEBUG("D:Offset en el canvas %d;%d", imgoffsetx, imgoffsety);
+
+   Window.ulx_ = imgulx;
+   Window.uly_ = imguly;
+   Window.lrx_ = imglrx;
+   Window.lry_ = imglry;
+   Window.subsetWidth_ = subsetw;
+   Window.subsetHeight_ = subseth;
+   Window.offsetX_ = imgoffsetx;
+   Window.offsetY_ = imgoffsety;
+   Window.plusX_ = plusx;
+   Window.plusY_ = plusy;
+   Window.isDecimating_ = isdecimating;
+   Window.decimatedX_ = destx;
+   Window.decimatedY_ = desty;
+}
+
+/**
+ *  Calcula el subset que se leera al renderizar la ventana de pWorldWindow
+ * y lanza un hilo que lo lee con una segunda imagen abierta sobre el mismo
+ * archivo. Cuando Render llega a esa ventana toma los datos leidos en lugar
+ * de leerlos, con lo que la lectura de una ventana se superpone con el
+ * procesamiento de la anterior.
+ *  Se mantienen a lo sumo MAX_READ_AHEAD_WINDOWS lecturas (la de la ventana
+ * que se esta por renderizar y la de la siguiente). Las lecturas se hacen de
+ * a una ya que comparten la imagen de lectura anticipada.
+ * @param[in] pWorldWindow mundo con la ventana que se renderizara luego
+ */
+void RasterRenderer::Prefetch(const World *pWorldWindow) {
+   if (!pWorldWindow || !UpdateImage(pWorldWindow) || !pImage_) {
+      return;
+   }
+   RasterSpatialModel *prastermodel = RasterSpatialModel::Create(
+         parameters_.rasterModel_);
+   if (!prastermodel) {
+      return;
+   }
+   Subset windowsubset;
+   pWorldWindow->GetWindow(windowsubset);
+   prastermodel->InverseTransform(windowsubset.ul_);
+   prastermodel->InverseTransform(windowsubset.lr_);
+   RasterSpatialModel::Destroy(prastermodel);
+
+   // mismo calculo que Render, sobre la imagen de renderizacion
+   Decimate decimate(0, 0);
+   ReadWindow read;
+   CalculateReadWindow(pWorldWindow, windowsubset, pImage_, decimate, read);
+   int sizex = 0, sizey = 0;
+   pImage_->GetSize(sizex, sizey);
+   if (read.isDecimating_) {
+      pImage_->PopSource();
+   }
+   if (read.subsetWidth_ <= 0 || read.subsetHeight_ <= 0) {
+      return;
+   }
+
+   // la lectura anterior debe terminar antes de reutilizar la imagen
+   if (!readAhead_.empty()) {
+      readAhead_.back()->Finish();
+   }
+   while (readAhead_.size() >= MAX_READ_AHEAD_WINDOWS) {
+      delete readAhead_.front();
+      readAhead_.pop_front();
+   }
+   if (!pReadAheadImage_) {
+      pReadAheadImage_ = OpenImage();
+      if (!pReadAheadImage_) {
+         return;
+      }
+   }
+   RasterReadAhead *preadahead = new RasterReadAhead(pReadAheadImage_,
+                                                     parameters_.bandCombination_, read,
+                                                     sizex, sizey);
+   if (!preadahead->Start()) {
+      REPORT_DEBUG("D:No se pudo lanzar la lectura anticipada");
+      delete preadahead;
+      return;
+   }
+   readAhead_.push_back(preadahead);
+}
+
+/**
+ *  Busca una lectura anticipada del subset pedido. Si la encuentra espera a
+ * que termine y reemplaza los buffers de Data por los leidos. Las lecturas
+ * anteriores a la encontrada ya no se usaran y se descartan.
+ * @param[in] pImage imagen que se va a leer
+ * @param[in] Ulx UL x del subset
+ * @param[in] Uly UL y del subset
+ * @param[in] Lrx LR x del subset
+ * @param[in] Lry LR y del subset
+ * @param[in] Data buffers donde se leeria la imagen
+ * @param[out] Data buffers con los datos leidos por adelantado
+ * @return true si Data tiene los datos del subset
+ */
+bool RasterRenderer::TakeReadAhead(Image *pImage, int Ulx, int Uly, int Lrx, int Lry,
+                                   std::vector<void*> &Data) {
+   if (pImage != pImage_ || readAhead_.empty()) {
+      return false;
+   }
+   int sizex = 0, sizey = 0;
+   pImage->GetSize(sizex, sizey);
+   size_t index = 0;
+   while (index < readAhead_.size()
+         && !readAhead_[index]->Matches(parameters_.bandCombination_, Ulx, Uly, Lrx, Lry,
+                                        sizex, sizey)) {
+      ++index;
+   }
+   if (index == readAhead_.size()) {
+      return false;
+   }
+   bool status = readAhead_[index]->Finish();
+   if (status) {
+      readAhead_[index]->TakeData(Data);
+   }
+   for (size_t i = 0; i <= index; ++i) {
+      delete readAhead_.front();
+      readAhead_.pop_front();
+   }
+   return status;
+}
+
+/** Espera a que terminen las lecturas anticipadas y las descarta */
+void RasterRenderer::CancelReadAhead() {
+   while (!readAhead_.empty()) {
+      delete readAhead_.front();
+      readAhead_.pop_front();
+   }
+}
+
 /** Lee los datos de la imagen */
 bool RasterRenderer::ReadImageData(Image* pImage, Canvas* pCanvas, Mask* pMask,
                                    int Ulx, int Uly, int Lrx, int Lry,
@@ -678,9 +988,6 @@ bool RasterRenderer::ReadImageData(Image* pImage, Canvas* pCanvas, Mask* pMask,
    pCanvas->GetSize(csizex, csizey);
    REPORT_DEBUG("D:Tamano de Canvas %d;%d", csizex, csizey);
    int datasize = pImage->GetDataSize();
-   // \todo: Se podria optimizar la escritura, haciendola en forma directa
-   //      a los buffers del MemoryCanvas usando GetBlock (\todo: ver como
-   //      lo seteo en dirty y si es necesario)
    // reservo memoria para la lectura de la imagen
    int buffersize = SubsetWidth * SubsetHeight * datasize;
 
@@ -689,34 +996,51 @@ bool RasterRenderer::ReadImageData(Image* pImage, Canvas* pCanvas, Mask* pMask,
       buffersize *= -1;
    }
 
+   // genero un vector de las bandas para la escritura en el canvas
+   std::vector<int> bands(parameters_.bandCombination_.size());
+   for (size_t i = 0; i < bands.size(); i++)
+      bands[i] = i;
+   bool padded = csizex > SubsetWidth || csizey > SubsetHeight;
+   bool samesize = csizex == SubsetWidth && csizey == SubsetHeight;
+   // Si no se aplica mascara, se trabaja directamente sobre los buffers del
+   // canvas: si tiene el tamanio del subset se lee la imagen sobre ellos y si
+   // es mas grande se copian las lineas leidas sobre ellos.
+   std::vector<void*> canvasdata;
+   bool inplace = !(pMask && parameters_.generateMask_) && (padded || samesize)
+         && pCanvas->GetBandBuffers(bands, canvasdata);
+
    std::vector<void*> imagedata(parameters_.bandCombination_.size());
    for (size_t i = 0; i < imagedata.size(); i++) {
-      imagedata[i] = new unsigned char[buffersize];
+      imagedata[i] = (inplace && samesize) ? canvasdata[i] : new unsigned char[buffersize];
       REPORT_DEBUG("D:imagedata[%d] = %x",
                    i, static_cast<unsigned char*>(imagedata[i]));
    }
 
-   // Leo los datos de la imagen
-   if (!pImage->Read(parameters_.bandCombination_, imagedata, Ulx, Uly, Lrx,
-                     Lry)) {
-      for (size_t i = 0; i < imagedata.size(); i++)
-         delete[] static_cast<unsigned char*>(imagedata[i]);
-
+   // Leo los datos de la imagen (si se leyeron por adelantado solo los tomo)
+   if (!TakeReadAhead(pImage, Ulx, Uly, Lrx, Lry, imagedata)
+         && !pImage->Read(parameters_.bandCombination_, imagedata, Ulx, Uly, Lrx,
+                          Lry)) {
+      if (!(inplace && samesize)) {
+         for (size_t i = 0; i < imagedata.size(); i++)
+            delete[] static_cast<unsigned char*>(imagedata[i]);
+      }
+      if (inplace)
+         pCanvas->ReleaseBandBuffers(bands);
       return false;
    }
-   std::vector<void*> auxData(pCanvas->GetBandCount());
-   for (int x= 0; x < pCanvas->GetBandCount(); x++) {
-      auxData[x] = new unsigned char[csizex * csizey * datasize];
-   }
-   // genero un vector de las bandas para la escritura en el canvas
-   std::vector<int> bands(parameters_.bandCombination_.size());
-   for (size_t i = 0; i < bands.size(); i++)
-      bands[i] = i;
-   pCanvas->Read(bands, auxData);
    // si el canvas es mas grande que el subset leido
    // debo copiar por linea
    // \todo enmascarar lo que se rellena
-   if (csizex > SubsetWidth || csizey > SubsetHeight) {
+   if (padded) {
+      // buffers del canvas o una copia si no los presta
+      std::vector<void*> auxData(canvasdata);
+      if (!inplace) {
+         auxData.resize(pCanvas->GetBandCount());
+         for (int x = 0; x < pCanvas->GetBandCount(); x++) {
+            auxData[x] = new unsigned char[csizex * csizey * datasize];
+         }
+         pCanvas->Read(bands, auxData);
+      }
       REPORT_DEBUG("D:Rellenando canvas con valores nulos");
       for (size_t b = 0; b < imagedata.size(); b++) {
 #ifdef __CUSTOM_CANVAS_OFFSET_FIX__
@@ -765,8 +1089,16 @@ bool RasterRenderer::ReadImageData(Image* pImage, Canvas* pCanvas, Mask* pMask,
    // si no existe la mascara o pide no generarla, copio directamente los datos
    if (pMask && parameters_.generateMask_)
       pMask->ApplyMask(bands, imagedata, pCanvas);
-   else
+   else if (!inplace)
       pCanvas->Write(bands, imagedata, NULL);
+   // los datos ya estan en el canvas, devuelvo sus buffers como escritos
+   if (inplace) {
+      pCanvas->ReleaseBandBuffers(bands, true);
+#ifdef __DEBUG__
+      delete[] pverifypointers;
+#endif
+      return true;
+   }
    // borro los datos temporales
    size_t size = imagedata.size();
    for (size_t i = 0; i < size; i++) {
@@ -895,26 +1227,7 @@ void RasterRenderer::FillMaskFromRasterData(std::vector<void*> &RasterData,
  */
 bool RasterRenderer::UpdateImage(const World* pWorldWindow) {
    if (!pImage_) {
-      Image::ImageAccessType access = Image::ReadOnly;
-      std::string writer = "null";
-      std::string datatype = parameters_.rawMetadata_.GetOption("Datatype");
-      std::string dataname = datatype.empty() ? "void" : datatype;
-      int bandcount = 0, sizex = 0, sizey = 0;
-      std::string pixels = parameters_.rawMetadata_.GetOption("Pixels");
-      if (!pixels.empty()) {
-         sizex = StringToNumber<int>(pixels);
-      }
-      std::string lines = parameters_.rawMetadata_.GetOption("Lines");
-      if (!lines.empty()) {
-         sizey = StringToNumber<int>(lines);
-      }
-
-      std::string bcountstr = parameters_.rawMetadata_.GetOption("Bandcount");
-      if (!bcountstr.empty()) {
-         bandcount = StringToNumber<int>(bcountstr);
-      }
-      pImage_ = Image::Open(GenerateImageId(parameters_.imageUrl_), access, writer,
-                            bandcount, sizex, sizey, dataname, parameters_.rawMetadata_);
+      pImage_ = OpenImage();
    } else {
       REPORT_DEBUG("D: RasterRenderer ya tiene una imagen abierta");
    }
@@ -922,6 +1235,34 @@ bool RasterRenderer::UpdateImage(const World* pWorldWindow) {
    return ValidateParameters(parameters_);
 }
 
+/**
+ * Abre la imagen indicada por la url de los parametros con las opciones de
+ * raster crudo (si las tiene).
+ * @return imagen abierta o NULL si no pudo abrirla
+ */
+Image *RasterRenderer::OpenImage() const {
+   Image::ImageAccessType access = Image::ReadOnly;
+   std::string writer = "null";
+   std::string datatype = parameters_.rawMetadata_.GetOption("Datatype");
+   std::string dataname = datatype.empty() ? "void" : datatype;
+   int bandcount = 0, sizex = 0, sizey = 0;
+   std::string pixels = parameters_.rawMetadata_.GetOption("Pixels");
+   if (!pixels.empty()) {
+      sizex = StringToNumber<int>(pixels);
+   }
+   std::string lines = parameters_.rawMetadata_.GetOption("Lines");
+   if (!lines.empty()) {
+      sizey = StringToNumber<int>(lines);
+   }
+
+   std::string bcountstr = parameters_.rawMetadata_.GetOption("Bandcount");
+   if (!bcountstr.empty()) {
+      bandcount = StringToNumber<int>(bcountstr);
+   }
+   return Image::Open(GenerateImageId(parameters_.imageUrl_), access, writer, bandcount,
+                      sizex, sizey, dataname, parameters_.rawMetadata_);
+}
+
 /**
  * Tranforma el Url del elemento a string que usa Image para abrir la imagen.
  * Este string depende del driver de Gdal que se use.
@@ -37,6 +37,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "suri/Renderer.h"
 #include "suri/Subset.h"
 #include "suri/Option.h"
+#include "suri/Resampler.h"
 
 // forwards
 class wxXmlNode;
@@ -45,6 +46,8 @@ class wxXmlNode;
 namespace suri {
 class Image;
 class Element;
+class Decimate;
+class RasterReadAhead;
 
 /** Renderer que lee un raster y lo vuelca en un canvas */
 /**
@@ -71,7 +74,8 @@ public:
       // TODO(Gabriel 08/08/13): Se vuelve a poner en true ya que de otra forma no
       // funcionaba el emnascaramiento del modo GIS. El que este en false
       // hace que vuelva a surgir el defecto del TCK #4526
-      Parameters():generateMask_(false), noDataValue_(0.0) {}
+      Parameters():generateMask_(false), noDataValue_(0.0),
+                   zoomOutResampling_(Resampler::NearestNeighbour) {}
       /** enum con metodos de lectura que se usa para leer imagen */
       typedef enum {
          Decimate, Aggregate
@@ -83,6 +87,8 @@ public:
       std::string spatialModel_; /*! info contexto de un RASTER_SPATIAL_MODEL_NODE */
       bool generateMask_;  /*! Generar mascara a partir de datos raster */
       double noDataValue_; /*! Valor a tomar como dato no valido */
+      /*! Remuestreo al decimar (propiedad "menos" del nodo interpolacion) */
+      Resampler::ResamplingType zoomOutResampling_;
       /** mapa para metadatos de raster crudos **/
       Option rawMetadata_;
    };
@@ -103,6 +109,8 @@ public:
 // ----------------------- METODOS DE RENDERIZACION -------------------------
    /** Renderiza el elemento dado un World en un Canvas */
    virtual bool Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pMask);
+   /** Comienza a leer en segundo plano los datos de una ventana */
+   virtual void Prefetch(const World *pWorldWindow);
    /** Obtiene el "bounding box" del elemento renderizado */
    virtual void GetBoundingBox(const World *pWorld, double &Ulx, double &Uly,
                                double &Lrx, double &Lry);
@@ -130,6 +138,30 @@ protected:
    static void GetRasterMetadata(wxXmlNode* pMetadataNode,
                                  Parameters& Param);
    friend class StackingRenderer;
+   friend class RasterReadAhead;
+   /** Subset de imagen que se lee para renderizar una ventana */
+   struct ReadWindow {
+      int ulx_; /*! UL x del subset a leer */
+      int uly_; /*! UL y del subset a leer */
+      int lrx_; /*! LR x del subset a leer */
+      int lry_; /*! LR y del subset a leer */
+      int subsetWidth_; /*! ancho del subset leido */
+      int subsetHeight_; /*! alto del subset leido */
+      int offsetX_; /*! offset en x del subset en el canvas */
+      int offsetY_; /*! offset en y del subset en el canvas */
+      int plusX_; /*! pixeles del canvas a la derecha del subset */
+      int plusY_; /*! lineas del canvas debajo del subset */
+      bool isDecimating_; /*! indica si se lee con decimado */
+      int decimatedX_; /*! ancho de la imagen decimada */
+      int decimatedY_; /*! alto de la imagen decimada */
+      Resampler::ResamplingType resampling_; /*! remuestreo al decimar */
+      bool noDataValueAvailable_; /*! indica si hay valor no valido */
+      double noDataValue_; /*! valor no valido que respeta el remuestreo */
+   };
+   /** Calcula el subset de imagen a leer para una ventana del mundo */
+   void CalculateReadWindow(const World *pWorldWindow, const Subset &WindowSubset,
+                            Image *pImage, Decimate &Decimator,
+                            ReadWindow &Window) const;
    /** Lee los datos de la imagen */
    virtual bool ReadImageData(Image* pImage, Canvas* pCanvas, Mask* pMask,
                                           int Ulx, int Uly, int Lrx, int Lry,
@@ -141,6 +173,8 @@ protected:
                                              Mask *pMask) const;
    /** Abre la parte de la imagen que se quire desplegar */
    virtual bool UpdateImage(const World* pWorldWindow);
+   /** Abre la imagen indicada en los parametros */
+   Image *OpenImage() const;
    /** Valida que los datos en clase Parameters sean congruentes con la imagen */
    bool ValidateParameters(const Parameters &Parameters);
 
@@ -149,6 +183,14 @@ protected:
    Image *pMask_; /*! Mascara de la imagen */
    bool changed_; /*! flag para determinar en Update si cambio algun parametro */
    Parameters parameters_; /*! parametros de renderizacion (visualizacion) */
+private:
+   /** Obtiene los datos leidos por adelantado para un subset de la imagen */
+   bool TakeReadAhead(Image *pImage, int Ulx, int Uly, int Lrx, int Lry,
+                      std::vector<void*> &Data);
+   /** Cancela las lecturas anticipadas pendientes */
+   void CancelReadAhead();
+   Image *pReadAheadImage_; /*! Imagen usada por las lecturas anticipadas */
+   std::deque<RasterReadAhead*> readAhead_; /*! lecturas anticipadas pendientes */
 };
 }
 
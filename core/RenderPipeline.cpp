@@ -37,6 +37,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "suri/xmlnames.h"
 #include "suri/XmlFunctions.h"
 #include "Mask.h"
+#include "PixelRendererChain.h"
 #include "logmacros.h"
 
 /** Busca el renderizador del nombre dado */
@@ -63,13 +64,15 @@ namespace suri {
  * Constructor
  * @return instancia de la clase RenderPipeline
  */
-RenderPipeline::RenderPipeline() {
+RenderPipeline::RenderPipeline() :
+      pPixelChain_(NULL) {
 }
 
 /**
  * Destructor
  */
 RenderPipeline::~RenderPipeline() {
+   delete pPixelChain_;
    PipelineType::iterator it = renderers_.begin();
    for (; it != renderers_.end(); it++) {
       Renderer::Destroy((*it));
@@ -80,7 +83,8 @@ RenderPipeline::~RenderPipeline() {
  * ctor de copia
  * @return instancia de la clase, copia del objeto recibido por parametro.
  */
-RenderPipeline::RenderPipeline(const RenderPipeline&) {
+RenderPipeline::RenderPipeline(const RenderPipeline&) :
+      pPixelChain_(NULL) {
 }
 
 // --------------------- ESTATICOS CREACION/DESTRUCCION ---------------------
@@ -192,6 +196,7 @@ RenderPipeline *RenderPipeline::Create(Element *pElement, Canvas *pOutputCanvas)
          }
       }
 #endif
+      ppipeline->pPixelChain_ = PixelRendererChain::Create(ppipeline->renderers_);
       REPORT_DEBUG("D:Renderizador para el elemento %s creado con exito.",
                    pElement->GetName().c_str());
       return ppipeline;
@@ -214,6 +219,8 @@ void RenderPipeline::Destroy(RenderPipeline* &pPipeline) {
 // ----------------------------- RENDERIZACION ------------------------------
 /**
  *  Llama a el ultimo renderizador y este propaga la renderizacion a los otros.
+ * Si el pipeline termina en renderizadores por pixel los aplica en una unica
+ * pasada (ver PixelRendererChain).
  * @param[in] pWorld Mundo de donde salen los parametros del subset a renderizar
  * @param[in] pMask Mascara inicial de renderizacion
  * @param[out] pCanvas Canvas sobre el que se renderiza
@@ -224,7 +231,9 @@ void RenderPipeline::Destroy(RenderPipeline* &pPipeline) {
  *  @return false si la renderizacion no tuvo exito.
  */
 bool RenderPipeline::Render(const World *pWorld, Canvas* pCanvas, Mask* pMask) {
-   if (renderers_.back()->Render(pWorld, pCanvas, pMask)) {
+   bool rendered = pPixelChain_ ? pPixelChain_->Render(pWorld, pCanvas, pMask) :
+                                  renderers_.back()->Render(pWorld, pCanvas, pMask);
+   if (rendered) {
       // Para que los vectores (en el DC) pasen a la matriz
       REPORT_DEBUG("D:RenderPipeline::Render()");
       pCanvas->Flush(pMask);
@@ -235,6 +244,17 @@ bool RenderPipeline::Render(const World *pWorld, Canvas* pCanvas, Mask* pMask) {
    return false;
 }
 
+/**
+ *  Solo el primer renderizador lee datos, el resto procesa lo que recibe del
+ * anterior.
+ * @param[in] pWorld mundo con la ventana que se renderizara luego.
+ */
+void RenderPipeline::Prefetch(const World *pWorld) {
+   if (!renderers_.empty()) {
+      (*renderers_.begin())->Prefetch(pWorld);
+   }
+}
+
 /**
  * @param[in]	pWorld: puntero a la ventana del mundo.
  * @param[in]	Ulx: uper-left x
@@ -309,6 +329,8 @@ void RenderPipeline::Update(Element *pElement) {
       Renderer::Destroy(*it);
    // asigno el nuevo pipeline
    renderers_ = newrenderers;
+   delete pPixelChain_;
+   pPixelChain_ = PixelRendererChain::Create(renderers_);
    // actualizo
    it = renderers_.begin();
    for (; it != renderers_.end(); it++) {
@@ -39,6 +39,7 @@ class World;
 class Canvas;
 class Mask;
 class Renderer;
+class PixelRendererChain;
 
 /** clase que contiene una cadena de Renderers */
 /**
@@ -66,6 +67,8 @@ public:
 // ----------------------------- RENDERIZACION ------------------------------
    /** Renderiza los elementos del mundo en el canvas */
    virtual bool Render(const World *pWorld, Canvas* pCanvas, Mask* pMask);
+   /** Anticipa la lectura de los datos de una ventana */
+   virtual void Prefetch(const World *pWorld);
    /** Obtiene el "bounding box" del elemento renderizado */
    virtual void GetBoundingBox(const World *pWorld, double &Ulx, double &Uly,
                                double &Lrx, double &Lry) const;
@@ -76,6 +79,7 @@ protected:
 private:
    typedef std::vector<Renderer*> PipelineType; /*! vector con los Renderers */
    PipelineType renderers_; /*! mapa de renderizadores */
+   PixelRendererChain *pPixelChain_; /*! Tramo final de renderizadores por pixel */
 };
 }
 
@@ -225,6 +225,17 @@ void RenderizationController::Finalize() {
    pRenderizationManager_ = NULL;
 }
 
+/**
+ *  Permite que los renderizadores comiencen a leer en segundo plano los
+ * datos de la proxima ventana mientras se renderiza la actual.
+ * @param[in] pNextWorld mundo con la proxima ventana a renderizar
+ */
+void RenderizationController::Prefetch(const World *pNextWorld) {
+   if (pRenderizationManager_) {
+      pRenderizationManager_->Prefetch(pNextWorld);
+   }
+}
+
 /**
  * Retorna el estado del sistema para la ultima renderizacion
  * @return informa si hubo un error en la renderizacion de los
@@ -58,7 +58,7 @@ RenderizationManager::RenderizationManager(LayerList *pList, World *pWorldWindow
       wUlx_(0), wUly_(0), wLrx_(0), wLry_(0), wwUlx_(0), wwUly_(0), wwLrx_(0),
       wwLry_(0), vpWidth_(0), vpHeight_(0), knownItemsCount_(0), shouldRender_(false),
       pCanvas_(NULL), pMask_(NULL), isRendering_(false), pWorldExtentManager_(NULL),
-      renderizationStatus_(true) {
+      renderizationStatus_(true), isolated_(false) {
    // Creo y registro los viewers
    pListViewer_ = new ListView<RenderizationManager>(this,
                                                      &RenderizationManager::ListUpdate);
@@ -138,6 +138,10 @@ RenderPipeline* RenderizationManager::GetRenderPipeline(Element* pElement) {
    RendererListType::const_iterator renderit = rendererList_.find(pElement);
    // el elemento no tiene renderizador asociado
    if (renderit == rendererList_.end()) {
+      // aislado no se crean pipelines (registra viewers en el elemento)
+      if (isolated_) {
+         REPORT_AND_FAIL_VALUE("D:El elemento no tiene pipeline creado", NULL);
+      }
       // Creo el pipeline
       if (!CreatePipeline(pElement)) {
          REPORT_AND_FAIL_VALUE("D:No se pudo crear el renderizador para el elemento",
@@ -221,18 +225,18 @@ void RenderizationManager::Render(bool Force) {
    }
    // protejo el ciclo de renderizacion
    isRendering_ = true;
-   rendering_ = true;
+   SetGlobalRendering(true);
    shouldRender_ = false;
    REPORT_DEBUG("D:Renderizando.");
    if (!pCanvas_) {
       isRendering_ = false;
-      rendering_ = false;
+      SetGlobalRendering(false);
       REPORT_AND_FAIL("D:No se ha asignado un Canvas de salida.");
    }
    LayerList *plist = GetLayerList();
    if (!Model::IsValid(plist)) {
       isRendering_ = false;
-      rendering_ = false;
+      SetGlobalRendering(false);
       return;
    }
 
@@ -253,7 +257,7 @@ void RenderizationManager::Render(bool Force) {
    World *pworld = pWorldViewer_->GetWorld();
    if (!pworld) {
       isRendering_ = false;
-      rendering_ = false;
+      SetGlobalRendering(false);
       REPORT_AND_RETURN("D:Error al obtener el mundo.");
    }
    // Usa WorldExtentManager para calcular extent del mundo
@@ -263,7 +267,7 @@ void RenderizationManager::Render(bool Force) {
 
    if (!pworld->IsInitialized()) {
       isRendering_ = false;
-      rendering_ = false;
+      SetGlobalRendering(false);
       REPORT_AND_RETURN("D:Mundo no inicializado o error en el mundo");
    }
    // aplico el tamano antes del clear por si se necesita dentro del canvas
@@ -295,7 +299,9 @@ void RenderizationManager::Render(bool Force) {
             }
 
             // indica que finalizo la renderizacion del elemento
-            pelement->SetShouldRender(false);
+            if (!isolated_) {
+               pelement->SetShouldRender(false);
+            }
          } else {
             elementsNotRenderized_.push_back(pelement);
             REPORT_DEBUG("D:No se pudo obtener RenderPipeline para elemento: %s.",
@@ -325,7 +331,65 @@ void RenderizationManager::Render(bool Force) {
    delete prenderizationcanvas;
    // habilito el ciclo de renderizacion
    isRendering_ = false;
-   rendering_ = false;
+   SetGlobalRendering(false);
+}
+
+/**
+ *  Crea por adelantado los pipelines de los elementos activos de la lista.
+ * Permite que la creacion (que registra viewers en los elementos) se realice
+ * en el hilo principal antes de renderizar desde otro hilo.
+ * \pre Debe estar asignado el canvas de salida.
+ */
+void RenderizationManager::CreatePipelines() {
+   LayerList *plist = GetLayerList();
+   if (!Model::IsValid(plist)) {
+      return;
+   }
+   std::vector<Element*> elements = plist->GetRenderizationOrderList();
+   std::vector<Element*>::const_iterator it = elements.begin();
+   for (; it != elements.end(); ++it) {
+      Element *pelement = (*it)->HasAssociatedElement() ? (*it)->GetAssociatedElement() :
+                                                          *it;
+      if (pelement->IsActive()) {
+         GetRenderPipeline(pelement);
+      }
+   }
+}
+
+/**
+ *  Pide a los pipelines de los elementos activos que comiencen a leer los
+ * datos de la ventana de pWorld. La renderizacion posterior de esa ventana
+ * utiliza los datos leidos.
+ * @param[in] pWorld mundo con la ventana que se renderizara luego.
+ */
+void RenderizationManager::Prefetch(const World *pWorld) {
+   LayerList *plist = GetLayerList();
+   if (!pWorld || !Model::IsValid(plist)) {
+      return;
+   }
+   std::vector<Element*> elements = plist->GetRenderizationOrderList();
+   std::vector<Element*>::const_iterator it = elements.begin();
+   for (; it != elements.end(); ++it) {
+      Element *pelement = (*it)->HasAssociatedElement() ? (*it)->GetAssociatedElement() :
+                                                          *it;
+      if (pelement->IsActive()) {
+         RenderPipeline *ppipeline = GetRenderPipeline(pelement);
+         if (ppipeline) {
+            ppipeline->Prefetch(pWorld);
+         }
+      }
+   }
+}
+
+/**
+ *  Los administradores aislados (ver SetIsolated) no lo modifican, ya que
+ * pueden renderizar en paralelo desde otros hilos.
+ * @param[in] Rendering nuevo valor del flag global
+ */
+void RenderizationManager::SetGlobalRendering(bool Rendering) {
+   if (!isolated_) {
+      rendering_ = Rendering;
+   }
 }
 
 /*!
@@ -101,8 +101,23 @@ public:
    WorldExtentManager* GetWorldExtentManager() {
       return pWorldExtentManager_;
    }
+   /** Aisla la renderizacion del estado compartido con otros administradores */
+   /**
+    *  Un administrador aislado no modifica el flag global de renderizacion ni
+    * el estado de los elementos, y no crea pipelines al renderizar (deben
+    * crearse antes con CreatePipelines). Permite renderizar desde un hilo de
+    * trabajo con un administrador propio.
+    * @param[in] Isolated indica si el administrador queda aislado
+    */
+   void SetIsolated(bool Isolated) {
+      isolated_ = Isolated;
+   }
    /** Metodo que renderiza */
    virtual void Render(bool Force = false);
+   /** Crea los pipelines de los elementos activos que aun no lo tienen */
+   void CreatePipelines();
+   /** Anticipa la lectura de datos de los elementos para una ventana */
+   void Prefetch(const World *pWorld);
    /** Indica si hay algun proceso de renderizacion activo */
    static bool GetRendering();
    /** retorna el estado de la renderizacion. */
@@ -142,6 +157,8 @@ protected:
    /** Elimina un pipeline asociado a un elemento */
    virtual bool DeletePipeline(Element *pElement);
 private:
+   /** Actualiza el flag global de renderizacion si no esta aislado */
+   void SetGlobalRendering(bool Rendering);
    double wUlx_; /*! mundo, coord uper-left x */
    double wUly_; /*! mundo, coord uper-left y */
    double wLrx_; /*! mundo, coord lower-right x */
@@ -167,6 +184,7 @@ private:
    std::vector<Element *> elementsNotRenderized_; /*! nombres de elementos que */
    /* no pudieron ser */
    /* renderizados */
+   bool isolated_; /*! indica que no modifica estado compartido al renderizar */
    static bool rendering_; /*! flag global para indicar renderizacion */
 };
 }
@@ -26,6 +26,7 @@ For more information about SpaceSUR, visit <https://www.spacesur.com>.
 For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes Estandar
+#include <algorithm>
 #include <map>
 #include <string>
 #include <vector>
@@ -48,6 +49,8 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "suri/TextFileGcpLoader.h"
 #include "suri/GcpList.h"
 #include "suri/Dimension.h"
+#include "suri/ApproximateCoordinatesTransformation.h"
+#include "suri/Configuration.h"
 
 // Includes Wx
 #include "wx/xml/xml.h"
@@ -58,6 +61,8 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #define URI_HDF5_FORMAT_VALUE "hdf5"
 
 #define DELETE_PCT(x) delete x; x = NULL;
+/** Error maximo (en pixeles) al interpolar la transformacion */
+#define DEFAULT_APPROXIMATION_TOLERANCE 0.125
 
 /**
  * Parche hasta que se solucione bug:
@@ -252,21 +257,60 @@ void ReprojectionRenderer::WalkThroughViewport(const World* pWorldWindow,
       pWorldWindow->GetViewport(vpwidth, vpheight);
       int prevx = 0, prevy = 0;
       pPreviousCanvas->GetSize(prevx, prevy);
+      // La transformacion se interpola sobre la ventana con un error menor a
+      // la tolerancia (en pixeles del canvas previous)
+      Subset window, transformwindow;
+      pWorldWindow->GetWindow(window);
+      pTransformWorld->GetWindow(transformwindow);
+      Dimension transformdimension(transformwindow);
+      double pixelsize = std::min(transformdimension.GetWidth() / prevx,
+                                  transformdimension.GetHeight() / prevy);
+      double tolerance = Configuration::GetParameter(
+            "lib_reprojection_approximation_tolerance",
+            DEFAULT_APPROXIMATION_TOLERANCE);
+      ApproximateCoordinatesTransformation approximatetransform(pct, window,
+                                                                tolerance * pixelsize);
       // recorro el viewport
       // copio el dato de cada pixel de la matriz de la imagen en un pixel de la
       // matriz del viewport utilizando las transformaciones de coordenadas
       // esto se encarga de ajustar el offset y hacer zoom y decimado
-      for (int j = 0; j < vpheight; j++) {
+      // Cada fila se transforma con una llamada por etapa.
+      std::vector<double> rowx(vpwidth), rowy(vpwidth);
+      std::vector<int> success(vpwidth);
+      // Con remuestreo distinto de NN los datos se interpolan por fila; la
+      // mascara se sigue copiando del pixel mas cercano.
+      Resampler::InterpolateFunctionType pinterpolate = NULL;
+      if (parameters_.resampling_ != Resampler::NearestNeighbour)
+         pinterpolate = Resampler::GetInterpolateFunction(pCanvas->GetDataType());
+      for (int j = 0; vpwidth > 0 && j < vpheight; j++) {
          for (int i = 0; i < vpwidth; i++) {
-            Coordinates temp(i, j);
-            Coordinates out(0, 0);
-            // de coordenadas de viewport a coordenadas de mundo de llegada
-            pWorldWindow->Transform(temp, out);
-            // de coordenadas de mundo de llegada a coordenadas de mundo de salida (previous)
-            pct->Transform(out);
-            // de sistema de salida a pixel - linea de matriz del canvas previous
-            pTransformWorld->InverseTransform(out, temp);
-            out = temp;
+            rowx[i] = i;
+            rowy[i] = j;
+         }
+         // de coordenadas de viewport a coordenadas de mundo de llegada
+         pWorldWindow->Transform(&rowx[0], &rowy[0], vpwidth);
+         // de coordenadas de mundo de llegada a coordenadas de mundo de salida (previous)
+         approximatetransform.Transform(&rowx[0], &rowy[0], vpwidth, false, &success[0]);
+         // de sistema de salida a pixel - linea de matriz del canvas previous
+         pTransformWorld->InverseTransform(&rowx[0], &rowy[0], vpwidth);
+         if (pinterpolate) {
+            for (int i = 0; i < vpwidth; i++) {
+               if (!success[i])
+                  rowx[i] = -1;
+            }
+            for (int b = 0; b < bandcount; b++) {
+               unsigned char *pdest = static_cast<unsigned char*>(ViewportData.at(b))
+                     + j * vpwidth * pCanvas->GetDataSize();
+               pinterpolate(PreviousData.at(b), prevx, prevy, &rowx[0], &rowy[0], vpwidth,
+                            parameters_.resampling_, pdest,
+                            parameters_.noDataValueAvailable_, parameters_.noDataValue_);
+            }
+         }
+         for (int i = 0; i < vpwidth; i++) {
+            // Los puntos que no se pudieron reproyectar quedan sin dato
+            if (!success[i])
+               continue;
+            Coordinates out(rowx[i], rowy[i]);
             // ----------- Este codigo hace interpolacion NN implicita para ZOOM y DECIMANDO
             // coordenadas truncadas de matriz (interpolacion NN implicita)
             int imgi = SURI_TRUNC(int, out.x_), imgj = SURI_TRUNC(int, out.y_);
@@ -274,7 +318,7 @@ void ReprojectionRenderer::WalkThroughViewport(const World* pWorldWindow,
             // -1 porque utiliza double y pregunta por <=
             if (Subset(Coordinates(0, 0), Coordinates(prevx - 1, prevy - 1)).IsInside(
                   Coordinates(imgi, imgj))) {
-               for (int b = 0; b < bandcount; b++) {
+               for (int b = 0; !pinterpolate && b < bandcount; b++) {
                   // punteros temporales para la copia
                   unsigned char *pdest = static_cast<unsigned char*>(ViewportData.at(b))
                         + (i + j * vpwidth) * pCanvas->GetDataSize();
@@ -621,6 +665,7 @@ void ReprojectionRenderer::Update(Element *pElement) {
 void ReprojectionRenderer::LoadParameters(Element* pElement, Parameters* pParameters) const {
    wxXmlNode* prootnode = pElement->GetNode(wxT(""));
    pElement->GetElementExtent(pParameters->imageExtent_);
+   pElement->GetNoDataValue(pParameters->noDataValueAvailable_, pParameters->noDataValue_);
    if (!prootnode) {
       REPORT_ERROR("D:Nodo NULO.");
       return;
@@ -665,6 +710,10 @@ void ReprojectionRenderer::LoadRenderizationParameters(wxXmlNode* pRenderNode,
             } else if (preprojnode->GetName().CompareTo(REPROJECTION_TYPE_DELTA_NODE) == 0) {
                   pParameters->delta_ = StringToNumber<int>(
                         preprojnode->GetNodeContent().c_str());
+            } else if (preprojnode->GetName().CompareTo(
+                                             REPROJECTION_TYPE_RESAMPLING_NODE) == 0) {
+               Resampler::GetType(preprojnode->GetNodeContent().c_str(),
+                                  pParameters->resampling_);
             } else if (preprojnode->GetName().CompareTo(
                                              REPROJECTION_TYPE_COEFFICIENT_NODE) == 0) {
             } else if (preprojnode->GetName().CompareTo(
@@ -751,6 +800,8 @@ void ReprojectionRenderer::CopyParameters(Parameters* pSourceParameters,
    pDestinationParameters->pGcpList_ = pSourceParameters->pGcpList_;
    pDestinationParameters->generateMask_ = pSourceParameters->generateMask_;
    pDestinationParameters->imageUrl_ = pSourceParameters->imageUrl_;
+   pDestinationParameters->noDataValueAvailable_ =
+         pSourceParameters->noDataValueAvailable_;
    pDestinationParameters->noDataValue_ = pSourceParameters->noDataValue_;
    pDestinationParameters->rasterModel_ = pSourceParameters->rasterModel_;
    pDestinationParameters->readFunction_ = pSourceParameters->readFunction_;
@@ -760,6 +811,7 @@ void ReprojectionRenderer::CopyParameters(Parameters* pSourceParameters,
    pDestinationParameters->transformationOrder_ =
          pSourceParameters->transformationOrder_;
    pDestinationParameters->transformationType_ = pSourceParameters->transformationType_;
+   pDestinationParameters->resampling_ = pSourceParameters->resampling_;
 }
 
 /**
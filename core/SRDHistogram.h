@@ -167,6 +167,13 @@ public:
    void SetBinFrecuency(int** pBins) {
       pBins_ = pBins;
    }
+
+   /** Suma Count puntos al bin Bin de la banda Band */
+   void AddBinFrequency(int Band, int Bin, int Count) {
+      pBins_[Band][Bin] += Count;
+      pAccumFreq_[Band] += Count;
+   }
+
    /** Devuelve la entropia de la imagen a partir del histograma */
    double* GetEntropy() const {
       // Entropia calculada por banda.
@@ -0,0 +1,578 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef SRDSTATISTICSACCUMULATOR_H_
+#define SRDSTATISTICSACCUMULATOR_H_
+
+// Includes Estandard
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <vector>
+
+// Includes Suri
+#include "NoDataValue.h"
+#include "suri/AuxiliaryFunctions.h"
+#include "SRDStatistics.h"
+#include "SRDHistogram.h"
+
+namespace suri {
+namespace raster {
+namespace data {
+
+/**
+ * Clase base del acumulador de estadisticas e histograma en una pasada.
+ *
+ * Procesa los datos en bloques de kBlockSize pixeles: por bloque calcula
+ * cantidad, suma, minimo y maximo (lazos sin dependencias entre pixeles que
+ * el compilador puede vectorizar) y los momentos centrados del bloque, y los
+ * combina con lo acumulado (formula de Chan et al.).
+ *
+ * El histograma se acumula en la misma pasada cuando el resultado es
+ * identico al de HistogramCanvas:
+ *  - si se fijo el rango (minimos y maximos personalizados) se cuentan
+ *    directamente los bins finales.
+ *  - para enteros de 8 y 16 bits se cuenta cada valor y al final se ubica
+ *    cada valor en su bin.
+ *  - para el resto de los tipos se cuenta cada valor distinto mientras no
+ *    superen kMaxDistinctValues por banda.
+ * Si se supera ese limite el rango depende del minimo y maximo, por lo que
+ * el histograma requiere una segunda pasada (NeedsHistogramPass).
+ * Los acumuladores que procesaron partes de los datos se combinan con Merge.
+ * Luego se generan Statistics y Histogram con el resultado.
+ */
+class StatisticsAccumulatorBase : public suri::NoDataValue {
+public:
+   /** Pixeles por bloque */
+   static const int kBlockSize = 1024;
+   /** Valores distintos por banda que se cuentan sin rango fijo */
+   static const size_t kMaxDistinctValues = 65536;
+
+   /**
+    * Dtor.
+    */
+   virtual ~StatisticsAccumulatorBase() {
+   }
+
+   /**
+    * Procesa un bloque de datos para cada banda.
+    */
+   virtual void Process(int DataLength, const std::vector<void*>& Data) = 0;
+
+   /**
+    * Combina con lo acumulado por otro acumulador del mismo tipo y configuracion.
+    */
+   virtual bool Merge(const StatisticsAccumulatorBase& Other) = 0;
+
+   /**
+    * Crea las estadisticas con lo acumulado.
+    */
+   virtual StatisticsBase* CreateStatistics() const = 0;
+
+   /**
+    * Crea el histograma con lo acumulado (NULL si no se acumulo histograma).
+    */
+   virtual HistogramBase* CreateHistogram() const = 0;
+
+   /**
+    * Indica si el histograma habilitado no se puede acumular en esta pasada.
+    */
+   virtual bool NeedsHistogramPass() const = 0;
+
+   /**
+    * Habilita el histograma con la cantidad de bins y, opcionalmente, el rango.
+    */
+   void SetHistogram(int Bins, const std::vector<double>& Min = std::vector<double>(),
+                     const std::vector<double>& Max = std::vector<double>()) {
+      histogramBins_ = Bins;
+      fixedRange_ = static_cast<int>(Min.size()) == bandCount_
+            && static_cast<int>(Max.size()) == bandCount_;
+      histMin_ = fixedRange_ ? Min : std::vector<double>(bandCount_, 0.0);
+      histMax_ = fixedRange_ ? Max : std::vector<double>(bandCount_, 0.0);
+      binCounts_ = std::vector<std::vector<double> >(bandCount_);
+      for (int b = 0; fixedRange_ && b < bandCount_; ++b)
+         binCounts_[b].assign(Bins, 0.0);
+   }
+
+   /**
+    * Indica si se acumula histograma.
+    */
+   bool HasHistogram() const {
+      return histogramBins_ > 0;
+   }
+
+   /**
+    * Devuelve la cantidad de bandas.
+    */
+   int GetBandCount() const {
+      return bandCount_;
+   }
+
+protected:
+   /**
+    * Ctor.
+    */
+   StatisticsAccumulatorBase(int BandCount, bool InterBand) :
+         bandCount_(BandCount), interBand_(InterBand),
+         count_(BandCount, 0.0), min_(BandCount, std::numeric_limits<double>::max()),
+         max_(BandCount, -std::numeric_limits<double>::max()), mean_(BandCount, 0.0),
+         m2_(BandCount, 0.0), histogramBins_(0), fixedRange_(false),
+         binCounts_(BandCount) {
+      if (interBand_)
+         comoment_.assign(BandCount, std::vector<double>(BandCount, 0.0));
+   }
+
+   /**
+    * Combina los momentos de un bloque (o de otro acumulador) con los de la banda.
+    */
+   void AddMoments(int Band, double Count, double Min, double Max, double Mean, double M2) {
+      if (Count == 0)
+         return;
+      double count = count_[Band] + Count;
+      double delta = Mean - mean_[Band];
+      m2_[Band] += M2 + delta * delta * count_[Band] * Count / count;
+      mean_[Band] += delta * Count / count;
+      count_[Band] = count;
+      if (Min < min_[Band])
+         min_[Band] = Min;
+      if (Max > max_[Band])
+         max_[Band] = Max;
+   }
+
+   /**
+    * Combina los momentos, co-momentos y bins de otro acumulador.
+    * @return false si la configuracion no coincide (no se modifica nada)
+    */
+   bool MergeMoments(const StatisticsAccumulatorBase& Other) {
+      if (Other.bandCount_ != bandCount_ || Other.interBand_ != interBand_
+            || Other.histogramBins_ != histogramBins_ || Other.fixedRange_ != fixedRange_
+            || Other.histMin_ != histMin_ || Other.histMax_ != histMax_)
+         return false;
+      // Los co-momentos se combinan antes de actualizar los promedios.
+      for (int b = 0; interBand_ && b < bandCount_; ++b) {
+         for (int c = b; c < bandCount_; ++c) {
+            comoment_[b][c] = MergeComoment(comoment_[b][c], count_[b], mean_[b], mean_[c],
+                                            Other.comoment_[b][c], Other.count_[b],
+                                            Other.mean_[b], Other.mean_[c]);
+            comoment_[c][b] = comoment_[b][c];
+         }
+      }
+      for (int b = 0; b < bandCount_; ++b) {
+         AddMoments(b, Other.count_[b], Other.min_[b], Other.max_[b], Other.mean_[b],
+                    Other.m2_[b]);
+         const std::vector<double>& othercounts = Other.binCounts_[b];
+         if (binCounts_[b].empty())
+            binCounts_[b] = othercounts;
+         else
+            for (size_t i = 0; i < othercounts.size(); ++i)
+               binCounts_[b][i] += othercounts[i];
+      }
+      return true;
+   }
+
+   /**
+    * Combina dos co-momentos centrados (formula de Chan et al.).
+    */
+   static double MergeComoment(double Comoment, double Count, double MeanA, double MeanB,
+                               double OtherComoment, double OtherCount, double OtherMeanA,
+                               double OtherMeanB) {
+      if (OtherCount == 0)
+         return Comoment;
+      double count = Count + OtherCount;
+      return Comoment + OtherComoment
+            + (OtherMeanA - MeanA) * (OtherMeanB - MeanB) * Count * OtherCount / count;
+   }
+
+   /**
+    * Suma Count en el bin del rango fijo que corresponde a Value.
+    */
+   void AddFixed(int Band, double Value, double Count) {
+      if (Value >= histMin_[Band] && Value <= histMax_[Band]) {
+         double scale = (histMax_[Band] - histMin_[Band]) / (histogramBins_ - 1.0);
+         int bin = static_cast<int>(std::floor(
+               (Value - histMin_[Band]) / (scale != 0 ? scale : 1)));
+         if (bin >= 0 && bin < histogramBins_)
+            binCounts_[Band][bin] += Count;
+      }
+   }
+
+   int bandCount_;  // Cantidad de bandas.
+   bool interBand_;  // Estadisticas entre bandas (covarianza).
+   std::vector<double> count_;  // Cantidad de puntos por banda.
+   std::vector<double> min_;  // Valor minimo por banda.
+   std::vector<double> max_;  // Valor maximo por banda.
+   std::vector<double> mean_;  // Promedio por banda.
+   std::vector<double> m2_;  // Suma de cuadrados de desvios por banda.
+   std::vector<std::vector<double> > comoment_;  // Co-momentos centrados.
+   int histogramBins_;  // Bins del histograma (0 si no se acumula).
+   bool fixedRange_;  // Si el rango del histograma es fijo.
+   std::vector<double> histMin_;  // Minimo del histograma con rango fijo.
+   std::vector<double> histMax_;  // Maximo del histograma con rango fijo.
+   std::vector<std::vector<double> > binCounts_;  // Bins (rango fijo) o cuenta por valor.
+};
+
+/**
+ * Acumulador de estadisticas e histograma especializado por tipo de dato.
+ */
+template<typename T>
+class StatisticsAccumulator : public StatisticsAccumulatorBase {
+public:
+   /**
+    * Ctor.
+    */
+   StatisticsAccumulator(int BandCount, bool InterBand) :
+         StatisticsAccumulatorBase(BandCount, InterBand), values_(BandCount),
+         valuesOverflow_(false) {
+   }
+
+   /**
+    * Procesa un bloque de datos para cada banda.
+    */
+   virtual void Process(int DataLength, const std::vector<void*>& Data);
+
+   /**
+    * Combina con lo acumulado por otro acumulador del mismo tipo y configuracion.
+    */
+   virtual bool Merge(const StatisticsAccumulatorBase& Other);
+
+   /**
+    * Crea las estadisticas con lo acumulado.
+    */
+   virtual StatisticsBase* CreateStatistics() const;
+
+   /**
+    * Crea el histograma con lo acumulado (NULL si no se acumulo histograma).
+    */
+   virtual HistogramBase* CreateHistogram() const;
+
+   /**
+    * Indica si el histograma habilitado no se puede acumular en esta pasada.
+    */
+   virtual bool NeedsHistogramPass() const;
+
+private:
+   /**
+    * Indica si el tipo de dato se cuenta por valor en el histograma.
+    */
+   static bool CountsValues() {
+      return std::numeric_limits<T>::is_integer && sizeof(T) <= 2;
+   }
+
+   /**
+    * Marca los pixeles validos de una banda en el bloque.
+    */
+   void GetValidity(int Band, const T* pData, int Length, bool UseBandNdv,
+                    unsigned char* pValid) const;
+
+   /**
+    * Acumula el histograma de una banda para el bloque.
+    */
+   void CountBlock(int Band, const T* pData, int Length, const unsigned char* pValid);
+
+   /**
+    * Descarta los valores distintos contados al superar kMaxDistinctValues.
+    */
+   void DiscardValues();
+
+   std::vector<std::map<T, double> > values_;  // Cuenta por valor distinto.
+   bool valuesOverflow_;  // Si se supero kMaxDistinctValues en alguna banda.
+};
+
+/**
+ * Marca los pixeles validos de una banda en el bloque (mismo criterio que
+ * Statistics<T>::Process).
+ */
+template<typename T>
+void StatisticsAccumulator<T>::GetValidity(int Band, const T* pData, int Length,
+                                           bool UseBandNdv, unsigned char* pValid) const {
+   bool ndvavailable = IsNoDataValueAvailable();
+   double ndv = GetNoDataValue();
+   bool bandndvavailable = UseBandNdv && IsNdvAvailableForBand(Band);
+   double bandndv = bandndvavailable ? GetBandNdv(Band) : 0.0;
+   for (int ix = 0; ix < Length; ++ix) {
+      double value = static_cast<double>(pData[ix]);
+      pValid[ix] = value != INFINITY && value != -INFINITY && !std::isnan(value)
+            && !(ndvavailable && AreEqual(value, ndv))
+            && !(bandndvavailable && AreEqual(value, bandndv));
+   }
+}
+
+/**
+ * Acumula el histograma de una banda para el bloque. Si se necesita una
+ * segunda pasada no cuenta nada.
+ */
+template<typename T>
+void StatisticsAccumulator<T>::CountBlock(int Band, const T* pData, int Length,
+                                          const unsigned char* pValid) {
+   if (fixedRange_) {
+      for (int ix = 0; ix < Length; ++ix)
+         if (pValid[ix])
+            AddFixed(Band, static_cast<double>(pData[ix]), 1.0);
+      return;
+   }
+   if (CountsValues()) {
+      double offset = static_cast<double>(std::numeric_limits<T>::min());
+      std::vector<double>& counts = binCounts_[Band];
+      if (counts.empty())
+         counts.assign(static_cast<size_t>(
+               static_cast<double>(std::numeric_limits<T>::max()) - offset + 1), 0.0);
+      for (int ix = 0; ix < Length; ++ix)
+         counts[static_cast<size_t>(static_cast<double>(pData[ix]) - offset)] += pValid[ix];
+      return;
+   }
+   // Se ordenan los valores del bloque para insertar cada valor distinto una vez.
+   std::vector<T> sorted;
+   sorted.reserve(Length);
+   for (int ix = 0; ix < Length; ++ix)
+      if (pValid[ix])
+         sorted.push_back(pData[ix]);
+   std::sort(sorted.begin(), sorted.end());
+   std::map<T, double>& counts = values_[Band];
+   typename std::map<T, double>::iterator hint = counts.begin();
+   for (size_t ix = 0; ix < sorted.size();) {
+      size_t next = ix + 1;
+      while (next < sorted.size() && sorted[next] == sorted[ix])
+         ++next;
+      hint = counts.insert(hint, std::make_pair(sorted[ix], 0.0));
+      hint->second += static_cast<double>(next - ix);
+      ix = next;
+   }
+   if (counts.size() > kMaxDistinctValues)
+      DiscardValues();
+}
+
+/**
+ * Descarta los valores distintos contados; el histograma queda para una
+ * segunda pasada.
+ */
+template<typename T>
+void StatisticsAccumulator<T>::DiscardValues() {
+   valuesOverflow_ = true;
+   values_ = std::vector<std::map<T, double> >(bandCount_);
+}
+
+/**
+ * Combina con lo acumulado por otro acumulador. El resultado es el mismo que
+ * procesar ambas partes de los datos con un unico acumulador (salvo el
+ * redondeo de los momentos).
+ * @param[in] Other acumulador con el mismo tipo de dato, bandas e histograma
+ * @return false si el acumulador no es compatible (no se modifica nada)
+ */
+template<typename T>
+bool StatisticsAccumulator<T>::Merge(const StatisticsAccumulatorBase& Other) {
+   const StatisticsAccumulator<T>* pother =
+         dynamic_cast<const StatisticsAccumulator<T>*>(&Other);
+   if (pother == NULL || !MergeMoments(Other))
+      return false;
+   if (valuesOverflow_ || pother->valuesOverflow_) {
+      DiscardValues();
+      return true;
+   }
+   for (int b = 0; b < bandCount_; ++b) {
+      typename std::map<T, double>::const_iterator it = pother->values_[b].begin();
+      for (; it != pother->values_[b].end(); ++it)
+         values_[b][it->first] += it->second;
+      if (values_[b].size() > kMaxDistinctValues) {
+         DiscardValues();
+         break;
+      }
+   }
+   return true;
+}
+
+/**
+ * Procesa un bloque de datos para cada banda.
+ */
+template<typename T>
+void StatisticsAccumulator<T>::Process(int DataLength, const std::vector<void*>& Data) {
+   int bandcount = std::min(bandCount_, static_cast<int>(Data.size()));
+   std::vector<std::vector<unsigned char> > valid(
+         bandcount, std::vector<unsigned char>(kBlockSize));
+   std::vector<unsigned char> pixelvalid(kBlockSize), bandvalid(kBlockSize);
+   std::vector<double> blockcount(bandcount), blockmean(bandcount);
+   std::vector<std::vector<double> > centered(bandcount, std::vector<double>(kBlockSize));
+
+   for (int start = 0; start < DataLength; start += kBlockSize) {
+      int length = std::min(DataLength - start, static_cast<int>(kBlockSize));
+      // Entre bandas no se usa el no-data de cada banda (como Statistics<T>).
+      for (int b = 0; b < bandcount; ++b)
+         GetValidity(b, static_cast<const T*>(Data[b]) + start, length, !interBand_,
+                     &valid[b][0]);
+
+      // Entre bandas un pixel se considera si es valido en alguna banda.
+      if (interBand_) {
+         for (int ix = 0; ix < length; ++ix) {
+            unsigned char any = 0;
+            for (int b = 0; b < bandcount; ++b)
+               any |= valid[b][ix];
+            pixelvalid[ix] = any;
+         }
+      }
+
+      std::vector<double> blockmin(bandcount), blockmax(bandcount), blockm2(bandcount);
+      for (int b = 0; b < bandcount; ++b) {
+         const T* pdata = static_cast<const T*>(Data[b]) + start;
+         const unsigned char* puse = interBand_ ? &pixelvalid[0] : &valid[b][0];
+         double count = 0, sum = 0;
+         double minvalue = std::numeric_limits<double>::max();
+         double maxvalue = -std::numeric_limits<double>::max();
+         for (int ix = 0; ix < length; ++ix) {
+            double value = static_cast<double>(pdata[ix]);
+            count += puse[ix];
+            sum += puse[ix] ? value : 0.0;
+            if (puse[ix] && value < minvalue)
+               minvalue = value;
+            if (puse[ix] && value > maxvalue)
+               maxvalue = value;
+         }
+         double mean = count > 0 ? sum / count : 0.0;
+         double m2 = 0;
+         double* pcentered = &centered[b][0];
+         for (int ix = 0; ix < length; ++ix) {
+            pcentered[ix] = puse[ix] ? static_cast<double>(pdata[ix]) - mean : 0.0;
+            m2 += pcentered[ix] * pcentered[ix];
+         }
+         blockcount[b] = count;
+         blockmean[b] = mean;
+         blockmin[b] = minvalue;
+         blockmax[b] = maxvalue;
+         blockm2[b] = m2;
+      }
+
+      // Co-momentos del bloque (antes de actualizar los promedios).
+      if (interBand_) {
+         for (int b = 0; b < bandcount; ++b) {
+            for (int c = b; c < bandcount; ++c) {
+               double comoment = 0;
+               const double* pa = &centered[b][0];
+               const double* pb = &centered[c][0];
+               for (int ix = 0; ix < length; ++ix)
+                  comoment += pa[ix] * pb[ix];
+               comoment_[b][c] = MergeComoment(comoment_[b][c], count_[b], mean_[b],
+                                               mean_[c], comoment, blockcount[b],
+                                               blockmean[b], blockmean[c]);
+               comoment_[c][b] = comoment_[b][c];
+            }
+         }
+      }
+
+      for (int b = 0; b < bandcount; ++b) {
+         AddMoments(b, blockcount[b], blockmin[b], blockmax[b], blockmean[b], blockm2[b]);
+         if (!HasHistogram() || NeedsHistogramPass())
+            continue;
+         // El histograma siempre descarta el no-data de la banda.
+         const T* pdata = static_cast<const T*>(Data[b]) + start;
+         unsigned char* pvalid = &valid[b][0];
+         if (interBand_ && IsNdvAvailableForBand(b)) {
+            GetValidity(b, pdata, length, true, &bandvalid[0]);
+            pvalid = &bandvalid[0];
+         }
+         CountBlock(b, pdata, length, pvalid);
+      }
+   }
+}
+
+/**
+ * Crea las estadisticas con lo acumulado. El acumulador de covarianza de
+ * Statistics guarda la suma de productos, que se reconstruye a partir de
+ * los co-momentos centrados.
+ */
+template<typename T>
+StatisticsBase* StatisticsAccumulator<T>::CreateStatistics() const {
+   Statistics<T>* pstatistics = new Statistics<T>(bandCount_);
+   pstatistics->SetNoDataValue(GetNoDataValue());
+   pstatistics->SetNoDataValueAvailable(IsNoDataValueAvailable());
+   pstatistics->SetAllBandsNdv(GetAllBandsNdv());
+   for (int b = 0; b < bandCount_; ++b) {
+      pstatistics->pMin_[b] = min_[b];
+      pstatistics->pMax_[b] = max_[b];
+      pstatistics->pMean_[b] = mean_[b];
+      pstatistics->pAccumVariance_[b] = m2_[b];
+      pstatistics->pPointCount_[b] = static_cast<long>(count_[b]);
+      for (int c = 0; interBand_ && c < bandCount_; ++c)
+         pstatistics->ppAccum4Covar_[b][c] = comoment_[b][c]
+               + count_[b] * mean_[b] * mean_[c];
+   }
+   return pstatistics;
+}
+
+/**
+ * Sin rango fijo solo se conserva la informacion necesaria para ubicar cada
+ * pixel en su bin mientras no se supere kMaxDistinctValues.
+ */
+template<typename T>
+bool StatisticsAccumulator<T>::NeedsHistogramPass() const {
+   return HasHistogram() && !fixedRange_ && !CountsValues() && valuesOverflow_;
+}
+
+/**
+ * Crea el histograma con lo acumulado. Sin rango fijo usa el minimo y maximo
+ * de las estadisticas (como HistogramCanvas) y ubica cada valor contado en
+ * su bin.
+ * @return histograma o NULL si no se acumulo (ver NeedsHistogramPass)
+ */
+template<typename T>
+HistogramBase* StatisticsAccumulator<T>::CreateHistogram() const {
+   if (!HasHistogram() || NeedsHistogramPass() || bandCount_ < 1)
+      return NULL;
+   std::vector<int> bins(bandCount_, histogramBins_);
+   std::vector<double> mins = fixedRange_ ? histMin_ : min_;
+   std::vector<double> maxs = fixedRange_ ? histMax_ : max_;
+   Histogram<T>* phistogram = new Histogram<T>(bandCount_, &bins[0], &mins[0], &maxs[0]);
+   phistogram->SetNoDataValue(GetNoDataValue());
+   phistogram->SetNoDataValueAvailable(IsNoDataValueAvailable());
+   phistogram->SetAllBandsNdv(GetAllBandsNdv());
+
+   // Los conteos se ubican con el mismo calculo que Histogram<T>::CountPixels
+   StatisticsAccumulator<T> binner(bandCount_, false);
+   binner.SetHistogram(histogramBins_, mins, maxs);
+   for (int b = 0; b < bandCount_; ++b) {
+      if (fixedRange_) {
+         binner.binCounts_[b] = binCounts_[b];
+      } else if (CountsValues()) {
+         double offset = static_cast<double>(std::numeric_limits<T>::min());
+         for (size_t i = 0; i < binCounts_[b].size(); ++i)
+            if (binCounts_[b][i] > 0)
+               binner.AddFixed(b, offset + i, binCounts_[b][i]);
+      } else {
+         typename std::map<T, double>::const_iterator it = values_[b].begin();
+         for (; it != values_[b].end(); ++it)
+            binner.AddFixed(b, static_cast<double>(it->first), it->second);
+      }
+      for (int bin = 0; bin < histogramBins_; ++bin)
+         phistogram->AddBinFrequency(b, bin, static_cast<int>(binner.binCounts_[b][bin]));
+   }
+   return phistogram;
+}
+
+}  // namespace data
+}  // namespace raster
+}  // namespace suri
+
+#endif  // SRDSTATISTICSACCUMULATOR_H_
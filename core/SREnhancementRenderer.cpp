@@ -38,6 +38,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "suri/Canvas.h"
 #include "suri/XmlFunctions.h"
 #include "SREEnhancementUtils.h"
+#include "DenseLut.h"
 
 namespace suri {
 namespace render {
@@ -125,12 +126,46 @@ void TranslateRawData<unsigned char>(int* pLut, void* pInData, void* pOutData,
    }
 }
 
+namespace {
+
+/**
+ *  Evalua el realce de una banda para un valor de entrada con las mismas
+ * funciones que se aplican por pixel, para generar un DenseLut.
+ */
+class EnhancementFunction : public DenseLut::Function {
+public:
+   /** Ctor */
+   EnhancementFunction(FTRANSLATE pTranslate, int* pLut, int NumBins, double Min,
+                       double Max, double NoDataValue, bool NoDataValueAvailable) :
+         pTranslate_(pTranslate), pLut_(pLut), numBins_(NumBins), min_(Min), max_(Max),
+         noDataValue_(NoDataValue), noDataValueAvailable_(NoDataValueAvailable) {
+   }
+   /** Valor realzado (los valores que no se traducen quedan igual) */
+   virtual double Evaluate(double Value) const {
+      double input = Value, output = Value;
+      pTranslate_(pLut_, &input, &output, 1, numBins_, min_, max_, noDataValue_,
+                  noDataValueAvailable_);
+      return output;
+   }
+private:
+   FTRANSLATE pTranslate_;  // Funcion de realce (version double).
+   int* pLut_;  // LUT de la banda.
+   int numBins_;  // Numero de bins.
+   double min_;  // Valor mas chico.
+   double max_;  // Valor mas grande.
+   double noDataValue_;  // Valor no valido.
+   bool noDataValueAvailable_;  // Si hay valor no valido.
+};
+
+}  // namespace
+
 AUTO_REGISTER_RENDERER(suri::render::EnhancementRenderer);
 
 /**
  * Ctor.
  */
-EnhancementRenderer::EnhancementRenderer() {
+EnhancementRenderer::EnhancementRenderer() :
+      pPixelTranslate_(NULL), denseNoDataValue_(0), denseNoDataValueAvailable_(false) {
 
 }
 
@@ -141,7 +176,8 @@ EnhancementRenderer::EnhancementRenderer(int BandCount, int* pNumBins,
                                          double* pLowValue, double* pHighValue,
                                          int** pBins, bool Active, std::string& Name) :
       bandCount_(BandCount), pNumBins_(pNumBins), pLowValue_(pLowValue),
-      pHighValue_(pHighValue), pBins_(pBins), active_(Active), name_(Name) {
+      pHighValue_(pHighValue), pBins_(pBins), active_(Active), name_(Name),
+      pPixelTranslate_(NULL), denseNoDataValue_(0), denseNoDataValueAvailable_(false) {
 
 }
 
@@ -225,13 +261,28 @@ std::string EnhancementRenderer::CreatedNode() const {
  */
 bool EnhancementRenderer::Render(const World *pWorldWindow, Canvas* pCanvas,
                                  Mask* pMask) {
-   bool prevrenderizationstatus = true;
+   bool prevrenderizationstatus = RenderInput(pWorldWindow, pCanvas, pMask);
+   if (!ProcessCanvas(pCanvas)) {
+      return false;
+   }
+   return prevrenderizationstatus;
+}
 
-   // Verifico que datos de entrada sean correctos
-   if (pPreviousRenderer_) {
-      prevrenderizationstatus = pPreviousRenderer_->Render(pWorldWindow, pCanvas,
-                                                           pMask);
+/**
+ * Renderiza el renderizador anterior.
+ */
+bool EnhancementRenderer::RenderInput(const World *pWorldWindow, Canvas *pCanvas,
+                                      Mask *pMask) {
+   if (!pPreviousRenderer_) {
+      return true;
    }
+   return pPreviousRenderer_->Render(pWorldWindow, pCanvas, pMask);
+}
+
+/**
+ * Aplica el realce a todo el canvas.
+ */
+bool EnhancementRenderer::ProcessCanvas(Canvas *pCanvas) {
    if (!pCanvas) {
       REPORT_AND_FAIL_VALUE("D:Canvas no puede ser nulo al aplicar LUT.", false);
    }
@@ -268,11 +319,16 @@ bool EnhancementRenderer::Render(const World *pWorldWindow, Canvas* pCanvas,
       outdata[bandix] = new unsigned char[sizex * sizey * pCanvas->GetDataSize()];
 
    // Aplico LUTs a las bandas
+   bool dense = PrepareDenseLuts(pCanvas->GetDataType());
    std::vector<int> newbands(bandcount);
    for (int bandix = 0; bandix < bandcount; ++bandix) {
-      Translate(pCanvas->GetDataType(), pBins_[bandix], indata[bandix], outdata[bandix],
-                size, pNumBins_[bandix], pLowValue_[bandix], pHighValue_[bandix],
-                GetNoDataValue(), IsNoDataValueAvailable());
+      if (dense) {
+         denseLuts_[bandix].Apply(outdata[bandix], indata[bandix], size);
+      } else {
+         Translate(pCanvas->GetDataType(), pBins_[bandix], indata[bandix],
+                   outdata[bandix], size, pNumBins_[bandix], pLowValue_[bandix],
+                   pHighValue_[bandix], GetNoDataValue(), IsNoDataValueAvailable());
+      }
 
       newbands[bandix] = bandix;
    }
@@ -284,7 +340,44 @@ bool EnhancementRenderer::Render(const World *pWorldWindow, Canvas* pCanvas,
       delete[] static_cast<unsigned char*>(outdata[bandix]);
    }
 
-   return prevrenderizationstatus;
+   return true;
+}
+
+/**
+ * Selecciona la funcion de realce para el tipo de dato de entrada. Como en
+ * ProcessCanvas, se realzan las primeras bandCount_ bandas.
+ */
+bool EnhancementRenderer::PreparePixels(int InputBandCount,
+                                        const std::string &InputDataType,
+                                        int &OutputBandCount,
+                                        std::string &OutputDataType) {
+   int sizex, sizey, bandcount = 0;
+   std::string dt;
+   GetInputParameters(sizex, sizey, bandcount, dt);
+   pPixelTranslate_ = GetTranslateFunction(InputDataType);
+   PrepareDenseLuts(InputDataType);
+   OutputBandCount = bandCount_;
+   OutputDataType = InputDataType;
+   return pPixelTranslate_ != NULL && InputDataType == dt && bandCount_ <= InputBandCount;
+}
+
+/**
+ * Aplica el realce a un tramo de pixeles.
+ */
+void EnhancementRenderer::ApplyPixels(std::vector<void*> &InputData,
+                                      std::vector<void*> &OutputData,
+                                      size_t PixelCount) {
+   bool dense = !denseLuts_.empty();
+   for (int bandix = 0; bandix < bandCount_; ++bandix) {
+      if (dense) {
+         denseLuts_[bandix].Apply(OutputData[bandix], InputData[bandix], PixelCount);
+         continue;
+      }
+      pPixelTranslate_(pBins_[bandix], InputData[bandix], OutputData[bandix],
+                       static_cast<int>(PixelCount), pNumBins_[bandix],
+                       pLowValue_[bandix], pHighValue_[bandix], GetNoDataValue(),
+                       IsNoDataValueAvailable());
+   }
 }
 
 /**
@@ -363,6 +456,7 @@ void EnhancementRenderer::Update(Element *pElement) {
    pBins_ = pbins;
    active_ = active;
    name_ = name;
+   denseLuts_.clear();
 }
 
 /**
@@ -374,6 +468,19 @@ void EnhancementRenderer::Translate(const std::string& DataType, int* pLut,
                                     void* pInData, void* pOutData, int DataSize,
                                     int NumBins, double Min, double Max,
                                     double NoDataValue, bool NoDataValueAvailable) {
+   FTRANSLATE ftranslate = GetTranslateFunction(DataType);
+   if (ftranslate != NULL) {
+      ftranslate(pLut, pInData, pOutData, DataSize, NumBins, Min, Max,
+                 NoDataValue, NoDataValueAvailable);
+   }
+}
+
+/**
+ * Obtiene la funcion de transformacion para el realce y el tipo de dato.
+ * Retorna NULL si el tipo de dato no esta soportado.
+ */
+EnhancementRenderer::TranslateFunction EnhancementRenderer::GetTranslateFunction(
+      const std::string& DataType) const {
    FTRANSLATE ftranslate = NULL;
    if (name_.compare("Linear255Enhancement") != 0) {
       if (DataType.compare(suri::DataInfo<unsigned char>::Name) == 0) {
@@ -409,10 +516,42 @@ void EnhancementRenderer::Translate(const std::string& DataType, int* pLut,
       }
    }
 
-   if (ftranslate != NULL) {
-      ftranslate(pLut, pInData, pOutData, DataSize, NumBins, Min, Max,
-                 NoDataValue, NoDataValueAvailable);
+   return ftranslate;
+}
+
+/**
+ * Genera (si el tipo de dato lo permite) una tabla densa por banda con el
+ * realce. Se reutilizan mientras no cambien el tipo de dato, el valor no
+ * valido o el realce (Update).
+ * Retorna true si hay tablas densas para el tipo de dato.
+ */
+bool EnhancementRenderer::PrepareDenseLuts(const std::string& DataType) {
+   double nodatavalue = GetNoDataValue();
+   bool nodatavalueavailable = IsNoDataValueAvailable();
+   if (!denseLuts_.empty() && denseDataType_ == DataType
+         && denseNoDataValue_ == nodatavalue
+         && denseNoDataValueAvailable_ == nodatavalueavailable) {
+      return true;
+   }
+   denseLuts_.clear();
+   FTRANSLATE ftranslate = GetTranslateFunction(DataInfo<double>::Name);
+   if (!DenseLut::IsSupported(DataType) || !ftranslate || bandCount_ < 1) {
+      return false;
+   }
+   denseLuts_.resize(bandCount_);
+   for (int bandix = 0; bandix < bandCount_; ++bandix) {
+      EnhancementFunction function(ftranslate, pBins_[bandix], pNumBins_[bandix],
+                                   pLowValue_[bandix], pHighValue_[bandix],
+                                   nodatavalue, nodatavalueavailable);
+      if (!denseLuts_[bandix].Build(DataType, function)) {
+         denseLuts_.clear();
+         return false;
+      }
    }
+   denseDataType_ = DataType;
+   denseNoDataValue_ = nodatavalue;
+   denseNoDataValueAvailable_ = nodatavalueavailable;
+   return true;
 }
 
 }  // namespace render
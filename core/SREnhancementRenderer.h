@@ -29,12 +29,14 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #define SRENHANCEMENTRENDERER_H_
 
 #include "suri/Renderer.h"
+#include "PixelRenderer.h"
 #include "NoDataValue.h"
+#include "DenseLut.h"
 
 namespace suri {
 namespace render {
 
-class EnhancementRenderer : public suri::Renderer {
+class EnhancementRenderer : public suri::Renderer, public suri::PixelRenderer {
 public:
    /**
     * Ctor.
@@ -68,6 +70,28 @@ public:
     */
    virtual bool Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pMask);
 
+   /**
+    * Renderiza el renderizador anterior.
+    */
+   virtual bool RenderInput(const World *pWorldWindow, Canvas *pCanvas, Mask *pMask);
+
+   /**
+    * Aplica el realce a todo el canvas.
+    */
+   virtual bool ProcessCanvas(Canvas *pCanvas);
+
+   /**
+    * Selecciona la funcion de realce para el tipo de dato de entrada.
+    */
+   virtual bool PreparePixels(int InputBandCount, const std::string &InputDataType,
+                              int &OutputBandCount, std::string &OutputDataType);
+
+   /**
+    * Aplica el realce a un tramo de pixeles.
+    */
+   virtual void ApplyPixels(std::vector<void*> &InputData,
+                            std::vector<void*> &OutputData, size_t PixelCount);
+
    /**
     * Obtiene el "bounding box" del elemento renderizado.
     */
@@ -92,6 +116,10 @@ public:
    virtual void Update(Element *pElement);
 
 private:
+   typedef void (*TranslateFunction)(int* pLut, void* pInData, void* pOutData,
+                                     int DataSize, int NumBins, double Min, double Max,
+                                     double NoDataValue, bool NoDataValueAvailable);
+
    int bandCount_;  // Cantidad de bandas.
    int* pNumBins_;  // Numero de bins por banda.
    double* pLowValue_;  // Valor mas chico por banda.
@@ -99,6 +127,11 @@ private:
    int** pBins_;  // LUT
    bool active_;  // Si esta activo o no.
    std::string name_;  // Nombre del realce.
+   TranslateFunction pPixelTranslate_;  // Funcion de realce de ApplyPixels.
+   std::vector<DenseLut> denseLuts_;  // Tablas densas por banda (8 y 16 bits).
+   std::string denseDataType_;  // Tipo de dato de las tablas densas.
+   double denseNoDataValue_;  // Valor no valido de las tablas densas.
+   bool denseNoDataValueAvailable_;  // Si las tablas densas usan valor no valido.
 
    /**
     * Traduce los valores de la imagen al valor de intesidad correspondiente.
@@ -106,6 +139,16 @@ private:
    void Translate(const std::string& DataType, int* pLut, void* pInData, void* pOutData,
                   int DataSize, int NumBins, double Min, double Max, double NoDataValue,
                   bool NoDataValueAvailable);
+
+   /**
+    * Obtiene la funcion de transformacion para el realce y el tipo de dato.
+    */
+   TranslateFunction GetTranslateFunction(const std::string& DataType) const;
+
+   /**
+    * Genera las tablas densas del realce para el tipo de dato.
+    */
+   bool PrepareDenseLuts(const std::string& DataType);
 };
 
 }  // namespace render
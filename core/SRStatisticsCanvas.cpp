@@ -25,45 +25,137 @@ accessible to users, such as in the program's "About" box or documentation.
 For more information about SpaceSUR, visit <https://www.spacesur.com>.
 For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
+#include <algorithm>
 #include <vector>
 
 #include "SRStatisticsCanvas.h"
+#include "suri/Configuration.h"
 #include "suri/DataTypes.h"
 
+#include "wx/thread.h"
+
+/** Cantidad minima de pixeles para repartir un bloque entre hilos */
+#define MIN_PIXELS_PER_THREAD 65536
+
 namespace suri {
 namespace render {
 
+/** Hilo que acumula las estadisticas de un rango de pixeles */
+class StatisticsWorker : public wxThread {
+public:
+   /** Ctor */
+   StatisticsWorker(SRD::StatisticsAccumulatorBase* pAccumulator, int DataLength,
+                    const std::vector<void*>& Data) :
+         wxThread(wxTHREAD_JOINABLE), pAccumulator_(pAccumulator),
+         dataLength_(DataLength), data_(Data) {
+   }
+
+   /** Procesa el rango */
+   void Process() {
+      pAccumulator_->Process(dataLength_, data_);
+   }
+
+protected:
+   /** Punto de entrada del hilo */
+   virtual ExitCode Entry() {
+      Process();
+      return 0;
+   }
+
+private:
+   SRD::StatisticsAccumulatorBase* pAccumulator_; /*! acumulador del rango */
+   int dataLength_; /*! cantidad de pixeles del rango */
+   std::vector<void*> data_; /*! inicio del rango en cada banda */
+};
+
 /**
  * Ctor.
+ * La cantidad de hilos se toma de lib_statistics_thread_count o, si no esta
+ * configurado, de la cantidad de CPUs.
  */
 StatisticsCanvas::StatisticsCanvas(bool InterBandStatistics) :
-      pStatistics_(NULL), interBandStatistics_(InterBandStatistics) {
+      pStatistics_(NULL), pHistogram_(NULL), pAccumulator_(NULL),
+      interBandStatistics_(InterBandStatistics), histogramBins_(0),
+      threadCount_(0) {
+   threadCount_ = Configuration::GetParameter("lib_statistics_thread_count",
+                                              static_cast<long>(threadCount_));
+   if (threadCount_ <= 0)
+      threadCount_ = std::max(1, wxThread::GetCPUCount());
 }
 
 /**
  * Dtor.
  */
 StatisticsCanvas::~StatisticsCanvas() {
-
+   delete pAccumulator_;
 }
 
 /**
- * Devuelve las estadisticas.
+ * Devuelve las estadisticas. Se generan con lo acumulado la primera vez que
+ * se piden; el objeto queda a cargo del codigo cliente.
  */
 SRD::StatisticsBase* StatisticsCanvas::GetStatistics() {
+   if (pStatistics_ == NULL && pAccumulator_ != NULL)
+      pStatistics_ = pAccumulator_->CreateStatistics();
    return pStatistics_;
 }
 
 /**
- * Computa los parametros deseados.
+ * Habilita el calculo del histograma junto con las estadisticas.
+ */
+void StatisticsCanvas::EnableHistogram(int Bins, const std::vector<double>& Min,
+                                       const std::vector<double>& Max) {
+   histogramBins_ = Bins;
+   histogramMin_ = Min;
+   histogramMax_ = Max;
+   if (pAccumulator_ != NULL)
+      pAccumulator_->SetHistogram(histogramBins_, histogramMin_, histogramMax_);
+}
+
+/**
+ * Devuelve el histograma. Se genera con lo acumulado la primera vez que se
+ * pide; el objeto queda a cargo del codigo cliente.
+ */
+SRD::HistogramBase* StatisticsCanvas::GetHistogram() {
+   if (pHistogram_ == NULL && pAccumulator_ != NULL)
+      pHistogram_ = pAccumulator_->CreateHistogram();
+   return pHistogram_;
+}
+
+/**
+ * Indica si el histograma se debe calcular en otra pasada (HistogramCanvas)
+ * con el minimo y maximo de las estadisticas.
+ */
+bool StatisticsCanvas::NeedsHistogramPass() const {
+   return pAccumulator_ != NULL && pAccumulator_->NeedsHistogramPass();
+}
+
+/**
+ * Crea un acumulador configurado con el no-data y el histograma del canvas.
+ */
+SRD::StatisticsAccumulatorBase* StatisticsCanvas::CreateAccumulator() const {
+   SRD::StatisticsAccumulatorBase* paccumulator = CreateAccumulatorFromDataType(
+         GetDataType(), GetBandCount(), interBandStatistics_);
+   if (paccumulator == NULL)
+      return NULL;
+   paccumulator->SetNoDataValue(GetNoDataValue());
+   paccumulator->SetNoDataValueAvailable(IsNoDataValueAvailable());
+   paccumulator->SetAllBandsNdv(GetAllBandsNdv());
+   if (histogramBins_ > 0)
+      paccumulator->SetHistogram(histogramBins_, histogramMin_, histogramMax_);
+   return paccumulator;
+}
+
+/**
+ * Computa los parametros deseados. Si el bloque es grande se reparte entre
+ * hilos con un acumulador por rango y luego se combinan (Merge).
  */
 void StatisticsCanvas::Flush(const suri::Mask *pMask) {
-   // Creo el objeto para guardar las estadisticas.
-   if (pStatistics_ == NULL) {
-      pStatistics_ = CreateStatisticsFromDataType(GetDataType(), GetBandCount());
-      pStatistics_->SetNoDataValue(GetNoDataValue());
-      pStatistics_->SetNoDataValueAvailable(IsNoDataValueAvailable());
-      pStatistics_->SetAllBandsNdv(GetAllBandsNdv());
+   // Creo el objeto para acumular las estadisticas.
+   if (pAccumulator_ == NULL) {
+      pAccumulator_ = CreateAccumulator();
+      if (pAccumulator_ == NULL)
+         return;
    }
 
    // Leo datos.
@@ -76,15 +168,44 @@ void StatisticsCanvas::Flush(const suri::Mask *pMask) {
    int width = 0, height = 0;
    GetSize(width, height);
 
-   if (!interBandStatistics_) {
-      // Proceso los datos
-      for (int bandix = 0, bandlen = GetBandCount(); bandix < bandlen; ++bandix) {
-         pStatistics_->Process(bandix, width * height, indata[bandix]);
-      }
-   } else {
-      pStatistics_->Process(width * height, indata);
+   // Proceso los datos
+   int count = width * height;
+   int threads = std::max(1, std::min(threadCount_, count / MIN_PIXELS_PER_THREAD));
+   if (threads == 1) {
+      pAccumulator_->Process(count, indata);
+      return;
    }
 
+   int chunk = (count + threads - 1) / threads;
+   int datasize = SizeOf(GetDataType());
+   std::vector<SRD::StatisticsAccumulatorBase*> partials;
+   std::vector<StatisticsWorker*> workers;
+   for (int i = 0; i < threads; ++i) {
+      int begin = std::min(count, i * chunk);
+      std::vector<void*> data;
+      for (size_t b = 0; b < indata.size(); ++b)
+         data.push_back(static_cast<unsigned char*>(indata[b]) + begin * datasize);
+      SRD::StatisticsAccumulatorBase* ppartial = CreateAccumulator();
+      partials.push_back(ppartial);
+      StatisticsWorker* pworker = new StatisticsWorker(
+            ppartial, std::min(count, begin + chunk) - begin, data);
+      if (i + 1 < threads && pworker->Create() == wxTHREAD_NO_ERROR
+            && pworker->Run() == wxTHREAD_NO_ERROR) {
+         workers.push_back(pworker);
+      } else {
+         pworker->Process();
+         delete pworker;
+      }
+   }
+   for (size_t i = 0; i < workers.size(); ++i) {
+      workers[i]->Wait();
+      delete workers[i];
+   }
+   // Se combinan en el orden de los rangos.
+   for (size_t i = 0; i < partials.size(); ++i) {
+      pAccumulator_->Merge(*partials[i]);
+      delete partials[i];
+   }
 }
 
 /**
@@ -110,5 +231,29 @@ SRD::StatisticsBase* StatisticsCanvas::CreateStatisticsFromDataType(const std::s
    return pret;
 }
 
+/**
+ * Crea el acumulador de estadisticas a partir del tipo de dato provisto.
+ */
+SRD::StatisticsAccumulatorBase* StatisticsCanvas::CreateAccumulatorFromDataType(
+      const std::string& DataType, int BandCount, bool InterBandStatistics) {
+   SRD::StatisticsAccumulatorBase* pret = NULL;
+   if (DataType.compare(suri::DataInfo<unsigned char>::Name) == 0) {
+      pret = new SRD::StatisticsAccumulator<unsigned char>(BandCount, InterBandStatistics);
+   } else if (DataType.compare(suri::DataInfo<unsigned short>::Name) == 0) {
+      pret = new SRD::StatisticsAccumulator<unsigned short>(BandCount, InterBandStatistics);
+   } else if (DataType.compare(suri::DataInfo<short>::Name) == 0) {
+      pret = new SRD::StatisticsAccumulator<short>(BandCount, InterBandStatistics);
+   } else if (DataType.compare(suri::DataInfo<unsigned int>::Name) == 0) {
+      pret = new SRD::StatisticsAccumulator<unsigned int>(BandCount, InterBandStatistics);
+   } else if (DataType.compare(suri::DataInfo<int>::Name) == 0) {
+      pret = new SRD::StatisticsAccumulator<int>(BandCount, InterBandStatistics);
+   } else if (DataType.compare(suri::DataInfo<float>::Name) == 0) {
+      pret = new SRD::StatisticsAccumulator<float>(BandCount, InterBandStatistics);
+   } else if (DataType.compare(suri::DataInfo<double>::Name) == 0) {
+      pret = new SRD::StatisticsAccumulator<double>(BandCount, InterBandStatistics);
+   }
+   return pret;
+}
+
 }  // namespace render
 }  // namespace suri
@@ -28,8 +28,12 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #ifndef SRSTATISTICSCANVAS_H_
 #define SRSTATISTICSCANVAS_H_
 
+#include <vector>
+
 #include "MemoryCanvas.h"
 #include "SRDStatistics.h"
+#include "SRDHistogram.h"
+#include "SRDStatisticsAccumulator.h"
 
 namespace suri {
 namespace render {
@@ -38,6 +42,7 @@ namespace SRD = suri::raster::data;
 
 /**
  * Clase que representa un canvas para la generacion de estadisticas.
+ * Acumula estadisticas y, si se habilita, el histograma en la misma pasada.
  */
 class StatisticsCanvas : public suri::MemoryCanvas {
 public:
@@ -56,6 +61,23 @@ public:
     */
    SRD::StatisticsBase* GetStatistics();
 
+   /**
+    * Habilita el calculo del histograma junto con las estadisticas. Si no se
+    * informa el rango por banda se usa el minimo y maximo de cada banda.
+    */
+   void EnableHistogram(int Bins, const std::vector<double>& Min = std::vector<double>(),
+                        const std::vector<double>& Max = std::vector<double>());
+
+   /**
+    * Devuelve el histograma (NULL si no se habilito o requiere otra pasada).
+    */
+   SRD::HistogramBase* GetHistogram();
+
+   /**
+    * Indica si el histograma se debe calcular en otra pasada (HistogramCanvas).
+    */
+   bool NeedsHistogramPass() const;
+
    /**
     * Computa los parametros deseados.
     */
@@ -66,9 +88,26 @@ public:
     */
    static SRD::StatisticsBase* CreateStatisticsFromDataType(const std::string& DataType, int BandCount);
 
+   /**
+    * Crea el acumulador de estadisticas a partir del tipo de dato provisto.
+    */
+   static SRD::StatisticsAccumulatorBase* CreateAccumulatorFromDataType(
+         const std::string& DataType, int BandCount, bool InterBandStatistics);
+
 private:
+   /**
+    * Crea un acumulador configurado con el no-data y el histograma del canvas.
+    */
+   SRD::StatisticsAccumulatorBase* CreateAccumulator() const;
+
    SRD::StatisticsBase* pStatistics_;
+   SRD::HistogramBase* pHistogram_;
+   SRD::StatisticsAccumulatorBase* pAccumulator_;
    bool interBandStatistics_;
+   int histogramBins_;
+   std::vector<double> histogramMin_;
+   std::vector<double> histogramMax_;
+   int threadCount_;
 };
 
 }  // namespace render
@@ -130,7 +130,10 @@ bool SegmentSnapStrategy::DoSnap(Coordinates &ViewportPosition, OGRPoint* Phanto
 bool SegmentSnapStrategy::FindNearestGeometryIndex(OGRPoint* PhantomPoint) {
    bool finded = false;
    double distance = 0;
-   for (size_t geom = 0; geom < segmentbuffers_.size(); ++geom) {
+   std::vector<int> candidates;
+   GetSegmentCandidates(PhantomPoint, candidates);
+   for (size_t i = 0; i < candidates.size(); ++i) {
+      int geom = candidates[i];
       if (PhantomPoint->Within(segmentbuffers_[geom])) {
          if (index_ == -1)
             distance = PhantomPoint->Distance(segmentgeometries_[geom]);
@@ -0,0 +1,219 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#include "SnapIndex.h"
+
+// Includes estandar
+#include <algorithm>
+#include <cmath>
+
+// Includes Suri
+
+// Includes Wx
+
+// Includes App
+#include "ogr_geometry.h"
+
+// Defines
+/** Limite de los indices de celda (evita desbordes con tolerancias chicas) */
+#define SNAP_INDEX_MAX_CELL_INDEX 1000000000.0
+
+namespace suri {
+
+/**
+ * @param[in] Tolerance distancia maxima (en coordenadas de mundo) a la que
+ * se acopla un punto
+ */
+SnapIndex::SnapIndex(double Tolerance) :
+      tolerance_(std::max(Tolerance, 0.0)),
+      cellSize_(Tolerance > 0 ? 2 * Tolerance : 1.0) {
+}
+
+/** Dtor */
+SnapIndex::~SnapIndex() {
+}
+
+/**
+ * Si el id ya estaba en el indice se reemplazan sus celdas.
+ * @param[in] Id identificador del elemento (se devuelve en Query)
+ * @param[in] pGeometry geometria del elemento
+ */
+void SnapIndex::Insert(int Id, OGRGeometry* pGeometry) {
+   Remove(Id);
+   if (pGeometry == NULL)
+      return;
+   std::set<Cell> cells;
+   if (!GetCells(pGeometry, cells) || cells.size() > SNAP_INDEX_MAX_ITEM_CELLS) {
+      largeItems_.insert(Id);
+      return;
+   }
+   std::vector<Cell>& itemcells = itemCells_[Id];
+   itemcells.assign(cells.begin(), cells.end());
+   for (size_t i = 0; i < itemcells.size(); ++i)
+      cells_[itemcells[i]].push_back(Id);
+}
+
+/**
+ * @param[in] Id identificador del elemento
+ */
+void SnapIndex::Remove(int Id) {
+   largeItems_.erase(Id);
+   std::map<int, std::vector<Cell> >::iterator item = itemCells_.find(Id);
+   if (item == itemCells_.end())
+      return;
+   for (size_t i = 0; i < item->second.size(); ++i) {
+      std::map<Cell, std::vector<int> >::iterator cell = cells_.find(item->second[i]);
+      if (cell == cells_.end())
+         continue;
+      cell->second.erase(std::remove(cell->second.begin(), cell->second.end(), Id),
+                         cell->second.end());
+      if (cell->second.empty())
+         cells_.erase(cell);
+   }
+   itemCells_.erase(item);
+}
+
+/**
+ * Los candidatos se deben verificar con la geometria exacta.
+ * @param[in] X coordenada x del punto en coordenadas de mundo
+ * @param[in] Y coordenada y del punto en coordenadas de mundo
+ * @param[out] Ids elementos candidatos, en orden creciente y sin repetir
+ */
+void SnapIndex::Query(double X, double Y, std::vector<int> &Ids) const {
+   Ids.clear();
+   // Los segmentos se registran con muestras separadas a lo sumo medio
+   // lado de celda, por eso se agranda el radio un cuarto de celda.
+   double radius = tolerance_ + cellSize_ / 4;
+   Cell mincell = GetCell(X - radius, Y - radius);
+   Cell maxcell = GetCell(X + radius, Y + radius);
+   for (int column = mincell.first; column <= maxcell.first; ++column) {
+      for (int row = mincell.second; row <= maxcell.second; ++row) {
+         std::map<Cell, std::vector<int> >::const_iterator cell =
+               cells_.find(Cell(column, row));
+         if (cell != cells_.end())
+            Ids.insert(Ids.end(), cell->second.begin(), cell->second.end());
+      }
+   }
+   Ids.insert(Ids.end(), largeItems_.begin(), largeItems_.end());
+   std::sort(Ids.begin(), Ids.end());
+   Ids.erase(std::unique(Ids.begin(), Ids.end()), Ids.end());
+}
+
+/** Devuelve la tolerancia del indice */
+double SnapIndex::GetTolerance() const {
+   return tolerance_;
+}
+
+/**
+ * @param[in] X coordenada x del punto
+ * @param[in] Y coordenada y del punto
+ * @return celda que contiene al punto
+ */
+SnapIndex::Cell SnapIndex::GetCell(double X, double Y) const {
+   double column = std::floor(X / cellSize_);
+   double row = std::floor(Y / cellSize_);
+   column = std::max(-SNAP_INDEX_MAX_CELL_INDEX, std::min(column, SNAP_INDEX_MAX_CELL_INDEX));
+   row = std::max(-SNAP_INDEX_MAX_CELL_INDEX, std::min(row, SNAP_INDEX_MAX_CELL_INDEX));
+   return Cell(static_cast<int>(column), static_cast<int>(row));
+}
+
+/**
+ * @param[in] pGeometry geometria (punto, linea, poligono o colecciones)
+ * @param[out] Cells celdas que ocupan los vertices y segmentos de la geometria
+ * @return false si la geometria no es soportada u ocupa demasiadas celdas
+ */
+bool SnapIndex::GetCells(OGRGeometry* pGeometry, std::set<Cell> &Cells) const {
+   switch (wkbFlatten(pGeometry->getGeometryType())) {
+      case wkbPoint: {
+         OGRPoint* ppoint = static_cast<OGRPoint*>(pGeometry);
+         Cells.insert(GetCell(ppoint->getX(), ppoint->getY()));
+         return true;
+      }
+      case wkbLineString:
+      case wkbLinearRing: {
+         OGRLineString* pline = static_cast<OGRLineString*>(pGeometry);
+         int count = pline->getNumPoints();
+         if (count == 1)
+            Cells.insert(GetCell(pline->getX(0), pline->getY(0)));
+         for (int i = 1; i < count; ++i)
+            if (!GetSegmentCells(pline->getX(i - 1), pline->getY(i - 1), pline->getX(i),
+                                 pline->getY(i), Cells))
+               return false;
+         return true;
+      }
+      case wkbPolygon: {
+         OGRPolygon* ppolygon = static_cast<OGRPolygon*>(pGeometry);
+         if (ppolygon->getExteriorRing() != NULL
+               && !GetCells(ppolygon->getExteriorRing(), Cells))
+            return false;
+         for (int i = 0; i < ppolygon->getNumInteriorRings(); ++i)
+            if (!GetCells(ppolygon->getInteriorRing(i), Cells))
+               return false;
+         return true;
+      }
+      case wkbMultiPoint:
+      case wkbMultiLineString:
+      case wkbMultiPolygon:
+      case wkbGeometryCollection: {
+         OGRGeometryCollection* pcollection = static_cast<OGRGeometryCollection*>(pGeometry);
+         for (int i = 0; i < pcollection->getNumGeometries(); ++i)
+            if (!GetCells(pcollection->getGeometryRef(i), Cells))
+               return false;
+         return true;
+      }
+      default:
+         return false;
+   }
+}
+
+/**
+ * Registra muestras del segmento separadas a lo sumo medio lado de celda, de
+ * forma que todo punto del segmento quede a menos de un cuarto de celda de
+ * una muestra.
+ * @param[in] X1 coordenada x del primer extremo
+ * @param[in] Y1 coordenada y del primer extremo
+ * @param[in] X2 coordenada x del segundo extremo
+ * @param[in] Y2 coordenada y del segundo extremo
+ * @param[out] Cells celdas que ocupa el segmento
+ * @return false si el segmento ocupa demasiadas celdas
+ */
+bool SnapIndex::GetSegmentCells(double X1, double Y1, double X2, double Y2,
+                                std::set<Cell> &Cells) const {
+   double length = std::sqrt((X2 - X1) * (X2 - X1) + (Y2 - Y1) * (Y2 - Y1));
+   double samples = std::ceil(length / (cellSize_ / 2));
+   if (!(samples <= 2 * SNAP_INDEX_MAX_ITEM_CELLS))
+      return false;
+   int count = static_cast<int>(samples);
+   Cells.insert(GetCell(X1, Y1));
+   for (int i = 1; i <= count; ++i) {
+      double t = static_cast<double>(i) / count;
+      Cells.insert(GetCell(X1 + t * (X2 - X1), Y1 + t * (Y2 - Y1)));
+   }
+   return Cells.size() <= SNAP_INDEX_MAX_ITEM_CELLS;
+}
+
+}  // namespace suri
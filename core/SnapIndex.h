@@ -0,0 +1,102 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef SNAPINDEX_H_
+#define SNAPINDEX_H_
+
+// Includes estandar
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+// Includes Suri
+
+// Includes Wx
+
+// Includes App
+
+// Defines
+/** Cantidad maxima de celdas que puede ocupar un elemento en la grilla */
+#define SNAP_INDEX_MAX_ITEM_CELLS 4096
+
+// forwards
+class OGRGeometry;
+
+namespace suri {
+
+/** Indice de vertices y segmentos para snapping (grilla regular en coordenadas de mundo) */
+/**
+ *  Cada elemento se registra en las celdas por las que pasan sus vertices y
+ * segmentos. El lado de la celda es el doble de la tolerancia, por lo que
+ * Query solo recorre las (a lo sumo) 4 celdas vecinas al punto consultado.
+ *  A diferencia de SpatialIndex admite agregar y eliminar elementos en
+ * cualquier momento, lo que permite actualizarlo a medida que se editan
+ * features.
+ *  Los elementos que ocuparian mas de SNAP_INDEX_MAX_ITEM_CELLS celdas
+ * (segmentos muy largos respecto a la tolerancia) se devuelven en todas las
+ * consultas.
+ */
+class SnapIndex {
+   /** Ctor. de Copia. */
+   SnapIndex(const SnapIndex &SnapIndex);
+
+public:
+   /** Ctor */
+   explicit SnapIndex(double Tolerance);
+   /** Dtor */
+   ~SnapIndex();
+   /** Agrega los vertices y segmentos de una geometria al indice */
+   void Insert(int Id, OGRGeometry* pGeometry);
+   /** Elimina un elemento del indice */
+   void Remove(int Id);
+   /** Busca los elementos que pueden estar a menos de la tolerancia del punto */
+   void Query(double X, double Y, std::vector<int> &Ids) const;
+   /** Devuelve la tolerancia del indice */
+   double GetTolerance() const;
+
+private:
+   /** Celda de la grilla (columna, fila) */
+   typedef std::pair<int, int> Cell;
+   /** Obtiene la celda que contiene un punto */
+   Cell GetCell(double X, double Y) const;
+   /** Agrega a Cells las celdas que ocupa una geometria */
+   bool GetCells(OGRGeometry* pGeometry, std::set<Cell> &Cells) const;
+   /** Agrega a Cells las celdas que ocupa un segmento */
+   bool GetSegmentCells(double X1, double Y1, double X2, double Y2,
+                        std::set<Cell> &Cells) const;
+
+   double tolerance_; /*! Distancia maxima de snapping */
+   double cellSize_; /*! Lado de las celdas de la grilla */
+   std::map<Cell, std::vector<int> > cells_; /*! Elementos de cada celda */
+   std::map<int, std::vector<Cell> > itemCells_; /*! Celdas de cada elemento */
+   std::set<int> largeItems_; /*! Elementos que se devuelven en todas las consultas */
+};
+
+}  // namespace suri
+
+#endif  // SNAPINDEX_H_
@@ -27,9 +27,35 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes Suri
 #include "SnapInterface.h"
+#include "SnapIndex.h"
 
 namespace suri {
 
+namespace {
+
+/**
+ * Obtiene las posiciones candidatas a partir del indice o, si no hay
+ * indice, todas las posiciones con geometria.
+ */
+void GetCandidates(const SnapIndex* pIndex, const std::vector<OGRGeometry*> &Geometries,
+                   OGRPoint* PhantomPoint, std::vector<int> &Candidates) {
+   Candidates.clear();
+   if (pIndex != NULL) {
+      pIndex->Query(PhantomPoint->getX(), PhantomPoint->getY(), Candidates);
+      return;
+   }
+   for (size_t geom = 0; geom < Geometries.size(); ++geom)
+      if (Geometries[geom] != NULL)
+         Candidates.push_back(geom);
+}
+
+}  // namespace
+
+/** Constructor */
+SnapInterface::SnapInterface() :
+      pWorld_(NULL), pVertexIndex_(NULL), pSegmentIndex_(NULL) {
+}
+
 /** Destructor */
 SnapInterface::~SnapInterface() {
 }
@@ -46,7 +72,7 @@ void SnapInterface::SetWorld(World* pWorld) {
  * Configura el vector con las geometrias correspondientes a los segmentos
  * @param[in] SegmentGeometries vector con las geometrias correspondientes a los segmentos
  */
-void SnapInterface::SetSegmentGeometries(std::vector<OGRGeometry*> SegmentGeometries) {
+void SnapInterface::SetSegmentGeometries(const std::vector<OGRGeometry*> &SegmentGeometries) {
    segmentgeometries_.clear();
    segmentgeometries_ = SegmentGeometries;
 }
@@ -55,7 +81,7 @@ void SnapInterface::SetSegmentGeometries(std::vector<OGRGeometry*> SegmentGeomet
  * Configura el vector con las geometrias correspondientes a los vertices
  * @param[in] VertexGeometries vector con las geometrias correspondientes a los vertices
  */
-void SnapInterface::SetVertexGeometries(std::vector<OGRGeometry*> VertexGeometries) {
+void SnapInterface::SetVertexGeometries(const std::vector<OGRGeometry*> &VertexGeometries) {
    vertexgeometries_.clear();
    vertexgeometries_ = VertexGeometries;
 }
@@ -64,7 +90,7 @@ void SnapInterface::SetVertexGeometries(std::vector<OGRGeometry*> VertexGeometri
  * Configura el vector con las geometrias correspondientes a los buffers de los vertices
  * @param[in] VertexBuffers vector con las geoms correspondientes a los buffers de los vertices
  */
-void SnapInterface::SetVertexBufferGeometries(std::vector<OGRGeometry*> VertexBuffers) {
+void SnapInterface::SetVertexBufferGeometries(const std::vector<OGRGeometry*> &VertexBuffers) {
    vertexbuffers_.clear();
    vertexbuffers_ = VertexBuffers;
 }
@@ -73,9 +99,46 @@ void SnapInterface::SetVertexBufferGeometries(std::vector<OGRGeometry*> VertexBu
  * Configura el vector con las geometrias correspondientes a los buffers de los segmentos
  * @param[in] SegmentBuffers vector con las geoms correspondientes a los buffers de los segmentos
  */
-void SnapInterface::SetSegmentBufferGeometries(std::vector<OGRGeometry*> SegmentBuffers) {
+void SnapInterface::SetSegmentBufferGeometries(
+      const std::vector<OGRGeometry*> &SegmentBuffers) {
    segmentbuffers_.clear();
    segmentbuffers_ = SegmentBuffers;
 }
 
+/**
+ * Configura el indice espacial de los vertices
+ * @param[in] pVertexIndex indice con las posiciones de vertexgeometries_
+ */
+void SnapInterface::SetVertexIndex(const SnapIndex* pVertexIndex) {
+   pVertexIndex_ = pVertexIndex;
+}
+
+/**
+ * Configura el indice espacial de los segmentos
+ * @param[in] pSegmentIndex indice con las posiciones de segmentgeometries_
+ */
+void SnapInterface::SetSegmentIndex(const SnapIndex* pSegmentIndex) {
+   pSegmentIndex_ = pSegmentIndex;
+}
+
+/**
+ * Obtiene las posiciones de los vertices cercanos al punto
+ * @param[in] PhantomPoint punto fantasma en coordenadas de mundo
+ * @param[out] Candidates posiciones en vertexbuffers_ y vertexgeometries_ a evaluar
+ */
+void SnapInterface::GetVertexCandidates(OGRPoint* PhantomPoint,
+                                        std::vector<int> &Candidates) const {
+   GetCandidates(pVertexIndex_, vertexbuffers_, PhantomPoint, Candidates);
+}
+
+/**
+ * Obtiene las posiciones de las geometrias cuyos segmentos son cercanos al punto
+ * @param[in] PhantomPoint punto fantasma en coordenadas de mundo
+ * @param[out] Candidates posiciones en segmentbuffers_ y segmentgeometries_ a evaluar
+ */
+void SnapInterface::GetSegmentCandidates(OGRPoint* PhantomPoint,
+                                         std::vector<int> &Candidates) const {
+   GetCandidates(pSegmentIndex_, segmentbuffers_, PhantomPoint, Candidates);
+}
+
 } /** namespace suri */
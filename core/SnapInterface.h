@@ -40,9 +40,12 @@ namespace suri {
 // forwards
 class World;
 class Coordinates;
+class SnapIndex;
 
 class SnapInterface {
 public:
+   /** Constructor */
+   SnapInterface();
    /** Destructor */
    virtual ~SnapInterface();
    /** Modifica las coordenadas de un punto de acuerdo a la estrategia definida */
@@ -52,17 +55,27 @@ public:
    /** Configura el mundo que se utilizara */
    virtual void SetWorld(World* pWorld);
    /** Configura el vector con las geometrias correspondientes a los segmentos */
-   void SetSegmentGeometries(std::vector<OGRGeometry*> SegmentGeometries);
+   virtual void SetSegmentGeometries(const std::vector<OGRGeometry*> &SegmentGeometries);
    /** Configura el vector con las geometrias correspondientes a los vertices */
-   void SetVertexGeometries(std::vector<OGRGeometry*> VertexGeometries);
+   virtual void SetVertexGeometries(const std::vector<OGRGeometry*> &VertexGeometries);
    /** Configura el vector con las geometrias correspondientes a los buffers de los vertices */
-   void SetVertexBufferGeometries(std::vector<OGRGeometry*> VertexBuffers);
+   virtual void SetVertexBufferGeometries(const std::vector<OGRGeometry*> &VertexBuffers);
    /** Configura el vector con las geometrias correspondientes a los buffers de los segmentos */
-   void SetSegmentBufferGeometries(std::vector<OGRGeometry*> SegmentBuffers);
+   virtual void SetSegmentBufferGeometries(const std::vector<OGRGeometry*> &SegmentBuffers);
+   /** Configura el indice espacial de los vertices */
+   virtual void SetVertexIndex(const SnapIndex* pVertexIndex);
+   /** Configura el indice espacial de los segmentos */
+   virtual void SetSegmentIndex(const SnapIndex* pSegmentIndex);
 
 protected:
+   /** Obtiene las posiciones de los vertices cercanos al punto */
+   void GetVertexCandidates(OGRPoint* PhantomPoint, std::vector<int> &Candidates) const;
+   /** Obtiene las posiciones de las geometrias cuyos segmentos son cercanos al punto */
+   void GetSegmentCandidates(OGRPoint* PhantomPoint, std::vector<int> &Candidates) const;
    /** Puntero al mundo */
    World* pWorld_;
+   /** Indices espaciales de vertices y segmentos (NULL recorre todas las geometrias) */
+   const SnapIndex *pVertexIndex_, *pSegmentIndex_;
    /** Vector con geometrias */
    std::vector<OGRGeometry*> segmentbuffers_, vertexbuffers_, segmentgeometries_, vertexgeometries_;
 };
@@ -0,0 +1,178 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#include "SpatialIndex.h"
+
+// Includes estandar
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+// Includes Suri
+
+// Includes Wx
+
+// Includes App
+
+// Defines
+
+namespace suri {
+
+namespace {
+
+/** Indica si dos envolventes se intersectan */
+bool intersects(const OGREnvelope &Envelope1, const OGREnvelope &Envelope2) {
+   return Envelope1.MinX <= Envelope2.MaxX && Envelope1.MaxX >= Envelope2.MinX
+         && Envelope1.MinY <= Envelope2.MaxY && Envelope1.MaxY >= Envelope2.MinY;
+}
+
+/** Compara nodos por el centro en x de la envolvente */
+template<class NodeType>
+bool lessx(const NodeType &Node1, const NodeType &Node2) {
+   return Node1.envelope_.MinX + Node1.envelope_.MaxX
+         < Node2.envelope_.MinX + Node2.envelope_.MaxX;
+}
+
+/** Compara nodos por el centro en y de la envolvente */
+template<class NodeType>
+bool lessy(const NodeType &Node1, const NodeType &Node2) {
+   return Node1.envelope_.MinY + Node1.envelope_.MaxY
+         < Node2.envelope_.MinY + Node2.envelope_.MaxY;
+}
+
+}  // namespace
+
+/** Ctor */
+SpatialIndex::SpatialIndex() {
+}
+
+/** Dtor */
+SpatialIndex::~SpatialIndex() {
+}
+
+/**
+ * @param[in] Id identificador del elemento (se devuelve en Query)
+ * @param[in] Envelope envolvente del elemento
+ */
+void SpatialIndex::Insert(int Id, const OGREnvelope &Envelope) {
+   Node item;
+   item.envelope_ = Envelope;
+   item.begin_ = Id;
+   item.end_ = Id + 1;
+   items_.push_back(item);
+   levels_.clear();
+}
+
+/**
+ * Empaqueta los elementos en hojas y luego cada nivel en el siguiente hasta
+ * llegar a un unico nodo raiz.
+ */
+void SpatialIndex::Build() {
+   levels_.clear();
+   if (items_.empty())
+      return;
+   std::vector<Node> parents;
+   Pack(items_, parents);
+   levels_.push_back(parents);
+   while (levels_.back().size() > 1) {
+      Pack(levels_.back(), parents);
+      levels_.push_back(parents);
+   }
+}
+
+/** Elimina todos los elementos y el arbol */
+void SpatialIndex::Clear() {
+   items_.clear();
+   levels_.clear();
+}
+
+/**
+ * @param[in] Envelope envolvente de la consulta
+ * @param[out] Ids ids (en orden creciente) de los elementos que la intersectan
+ */
+void SpatialIndex::Query(const OGREnvelope &Envelope, std::vector<int> &Ids) const {
+   Ids.clear();
+   if (levels_.empty())
+      return;
+   // Pila de (nivel, nodo) pendientes de recorrer
+   std::vector<std::pair<int, int> > pending;
+   pending.push_back(std::make_pair(static_cast<int>(levels_.size()) - 1, 0));
+   while (!pending.empty()) {
+      int level = pending.back().first;
+      const Node &node = levels_[level][pending.back().second];
+      pending.pop_back();
+      if (!intersects(node.envelope_, Envelope))
+         continue;
+      for (int i = node.begin_; i < node.end_; ++i) {
+         if (level > 0)
+            pending.push_back(std::make_pair(level - 1, i));
+         else if (intersects(items_[i].envelope_, Envelope))
+            Ids.push_back(items_[i].begin_);
+      }
+   }
+   std::sort(Ids.begin(), Ids.end());
+}
+
+/** @return cantidad de elementos del indice */
+size_t SpatialIndex::GetSize() const {
+   return items_.size();
+}
+
+/**
+ * Sort-Tile-Recursive: ordena los nodos por x, los divide en franjas
+ * verticales de S * SPATIAL_INDEX_NODE_CAPACITY nodos (S = raiz de la
+ * cantidad de padres), ordena cada franja por y y agrupa los nodos
+ * consecutivos.
+ * @param[in,out] Children nodos a agrupar (se reordenan)
+ * @param[out] Parents nodos padre, cada uno con un rango de Children
+ */
+void SpatialIndex::Pack(std::vector<Node> &Children, std::vector<Node> &Parents) {
+   int count = static_cast<int>(Children.size());
+   int parentcount = (count + SPATIAL_INDEX_NODE_CAPACITY - 1) / SPATIAL_INDEX_NODE_CAPACITY;
+   int slicecount = static_cast<int>(ceil(sqrt(static_cast<double>(parentcount))));
+   int slicesize = slicecount * SPATIAL_INDEX_NODE_CAPACITY;
+   std::sort(Children.begin(), Children.end(), lessx<Node>);
+   for (int slice = 0; slice < count; slice += slicesize)
+      std::sort(Children.begin() + slice, Children.begin() + std::min(slice + slicesize, count),
+                lessy<Node>);
+   Parents.clear();
+   for (int i = 0; i < count; i += SPATIAL_INDEX_NODE_CAPACITY) {
+      Node parent;
+      parent.begin_ = i;
+      parent.end_ = std::min(i + SPATIAL_INDEX_NODE_CAPACITY, count);
+      parent.envelope_ = Children[i].envelope_;
+      for (int child = i + 1; child < parent.end_; ++child) {
+         parent.envelope_.MinX = std::min(parent.envelope_.MinX, Children[child].envelope_.MinX);
+         parent.envelope_.MinY = std::min(parent.envelope_.MinY, Children[child].envelope_.MinY);
+         parent.envelope_.MaxX = std::max(parent.envelope_.MaxX, Children[child].envelope_.MaxX);
+         parent.envelope_.MaxY = std::max(parent.envelope_.MaxY, Children[child].envelope_.MaxY);
+      }
+      Parents.push_back(parent);
+   }
+}
+
+}  // namespace suri
@@ -0,0 +1,94 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef SPATIALINDEX_H_
+#define SPATIALINDEX_H_
+
+// Includes estandar
+#include <vector>
+
+// Includes Suri
+
+// Includes Wx
+
+// Includes App
+#include "ogr_core.h"
+
+// Defines
+/** Cantidad de hijos por nodo del arbol */
+#define SPATIAL_INDEX_NODE_CAPACITY 16
+
+namespace suri {
+
+/** Indice espacial en memoria (R-tree empaquetado con Sort-Tile-Recursive) */
+/**
+ *  Se cargan todas las envolventes con Insert y luego se arma el arbol con
+ * Build, que ordena las envolventes por franjas (STR) de forma que cada
+ * nodo agrupe SPATIAL_INDEX_NODE_CAPACITY elementos cercanos. El arbol no
+ * admite inserciones posteriores.
+ *  Query devuelve los ids cuyas envolventes intersectan la consulta en orden
+ * creciente, de forma que recorrer los candidatos respete el orden original
+ * de los elementos.
+ */
+class SpatialIndex {
+   /** Ctor. de Copia. */
+   SpatialIndex(const SpatialIndex &SpatialIndex);
+
+public:
+   /** Ctor */
+   SpatialIndex();
+   /** Dtor */
+   ~SpatialIndex();
+   /** Agrega un elemento al indice (antes de Build) */
+   void Insert(int Id, const OGREnvelope &Envelope);
+   /** Arma el arbol con los elementos agregados */
+   void Build();
+   /** Elimina todos los elementos del indice */
+   void Clear();
+   /** Busca los elementos cuya envolvente intersecta Envelope */
+   void Query(const OGREnvelope &Envelope, std::vector<int> &Ids) const;
+   /** Devuelve la cantidad de elementos del indice */
+   size_t GetSize() const;
+
+private:
+   /** Elemento (o nodo) con su envolvente */
+   class Node {
+   public:
+      OGREnvelope envelope_; /*! Envolvente del elemento o de sus hijos */
+      int begin_; /*! Id del elemento o primer hijo en el nivel inferior */
+      int end_; /*! Ultimo hijo (exclusive) en el nivel inferior */
+   };
+   /** Agrupa los nodos ordenados en nodos padre */
+   static void Pack(std::vector<Node> &Children, std::vector<Node> &Parents);
+
+   std::vector<Node> items_; /*! Elementos del indice */
+   std::vector<std::vector<Node> > levels_; /*! Nodos de cada nivel (0 apunta a items_) */
+};
+
+}  // namespace suri
+
+#endif  // SPATIALINDEX_H_
@@ -31,6 +31,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes Suri
 #include "SpectralAngleMapperAlgorithm.h"
+#include "ClassificationEngine.h"
 #include "suri/xmlnames.h"
 #include "suri/DataTypes.h"
 #include "suri/AuxiliaryFunctions.h"
@@ -44,88 +45,111 @@ namespace suri {
 /** Macro para registrar el tipo de algoritmo de clasificacion de forma automatica */
 AUTO_REGISTER_CLASS(ClassificationAlgorithmInterface, SpectralAngleMapperAlgorithm, 0)
 
+/** Nucleo de clasificacion por spectral angle mapper */
 /**
- * El algoritmo de clasificacion spectral angle mapper debe verificar las firmas espectrales
- * definidas en cada clase para cada banda. Cada registro de la firma espectral
- * En caso de que el pixel en todas las bandas este dentro del intervalo definido,
- * se considera que pasa a formar parte de la clase definida.
- * En caso contrario, pasa a ser parte de la clase NOCLASE (AND entre condiciones de banda).
- * @param[out] pDest imagen con ints donde se guardan los ids
- * @param[in] pSource imagen que se quiere clasificar
- * @param[in] Size cantidad de pixeles en la imagen a clasificar
- * @param[in] Classes vector con la informacion de las clases a clasificar
+ * Precalcula la norma al cuadrado de la firma espectral de cada clase. Para
+ * cada clase acumula en todo el tile el producto escalar con la firma y la
+ * norma del pixel, y solo calcula el angulo para los pixeles que todavia no
+ * tienen clase (un pixel se queda con la primera clase que lo acepta).
  */
-template<typename T>
-bool samClassification(
-      int* pDest, std::vector<void*> &pSource, size_t Size,
-      int NDVPixelValue, double Ndv, bool NdvAvailable,
-      const std::vector<SpectralAngleMapperAlgorithm::ClassSpectralInfo> &Classes) {
-   int bandcount = pSource.size();
-   std::vector<T*> psrc;
-
-   if (Classes.empty())
-      return false;
+class SpectralAngleMapperKernel : public ClassificationKernel {
+public:
+   /**
+    * @param[in] BandCount cantidad de bandas a clasificar
+    * @param[in] Classes vector con la informacion de las clases a clasificar
+    */
+   SpectralAngleMapperKernel(
+         int BandCount,
+         const std::vector<SpectralAngleMapperAlgorithm::ClassSpectralInfo> &Classes) :
+         bandCount_(BandCount), classes_(Classes) {
+      std::vector<SpectralAngleMapperAlgorithm::ClassSpectralInfo>::const_iterator cit =
+            classes_.begin();
+      for (; cit != classes_.end(); ++cit) {
+         double lowerreflectance = 0;
+         std::vector<SpectralAngleMapperAlgorithm::BandSpectralInfo>::const_iterator bit =
+               cit->bands_.begin();
+         for (; bit != cit->bands_.end(); ++bit)
+            lowerreflectance += (bit->reflectance_ * bit->reflectance_);
+         lowerReflectances_.push_back(lowerreflectance);
+      }
+   }
 
-   // realizo una conversion de los tipos de datos
-   for (int i = 0; i < bandcount; i++)
-      psrc.push_back(static_cast<T*>(pSource[i]));
+   /** Verifica que las firmas solo usen bandas existentes */
+   bool IsValid() const {
+      std::vector<SpectralAngleMapperAlgorithm::ClassSpectralInfo>::const_iterator cit =
+            classes_.begin();
+      for (; cit != classes_.end(); ++cit) {
+         std::vector<SpectralAngleMapperAlgorithm::BandSpectralInfo>::const_iterator bit =
+               cit->bands_.begin();
+         for (; bit != cit->bands_.end(); ++bit)
+            if (bit->band_ < 0 || bit->band_ >= bandCount_)
+               return false;
+      }
+      return !classes_.empty();
+   }
 
-   // Para cada pixel en la imagen
-   for (size_t pixelposition = 0; pixelposition < Size; pixelposition++) {
-      int classindex = ClassInformation::NoClassIndex;
+   /** Cantidad de bandas a clasificar */
+   virtual int GetBandCount() const {
+      return bandCount_;
+   }
 
-      bool invalidpixel = true;
+   /** Espacio para el producto escalar y la norma del pixel */
+   virtual int GetWorkspaceSize() const {
+      return 2;
+   }
 
-      // Salida para pixel no valido.
-      // (valor no valido en todas las bandas involucradas)
-      // Ver TCK #7325
-      if (NdvAvailable) {
-         for (int i = 0; i < bandcount && invalidpixel; ++i) {
-            if (static_cast<double>(psrc[i][pixelposition]) != CLASSIFICATION_NDV)
-               invalidpixel = false;
+   /**
+    * Asigna a cada pixel la primera clase cuyo angulo espectral no supera el
+    * maximo de la clase.
+    * @param[in] pTile valores del tile (pTile[b * Count + p])
+    * @param[in] Count cantidad de pixeles del tile
+    * @param[in] pWorkspace doubles auxiliares
+    * @param[out] pDest clase asignada a cada pixel
+    */
+   virtual void ClassifyTile(const double* pTile, size_t Count, double* pWorkspace,
+                             int* pDest) const {
+      double* pupper = pWorkspace;
+      double* plowerpixel = pWorkspace + Count;
+      for (size_t p = 0; p < Count; ++p)
+         pDest[p] = ClassInformation::NoClassIndex;
+
+      size_t pending = Count;
+      for (size_t c = 0; c < classes_.size() && pending > 0; ++c) {
+         const SpectralAngleMapperAlgorithm::ClassSpectralInfo& classinfo = classes_[c];
+         double lowerreflectance = lowerReflectances_[c];
+         if (lowerreflectance == 0) continue;
+
+         for (size_t p = 0; p < Count; ++p)
+            pupper[p] = plowerpixel[p] = 0;
+         std::vector<SpectralAngleMapperAlgorithm::BandSpectralInfo>::const_iterator bit =
+               classinfo.bands_.begin();
+         for (; bit != classinfo.bands_.end(); ++bit) {
+            const double* pband = pTile + bit->band_ * Count;
+            double reflectance = bit->reflectance_;
+            for (size_t p = 0; p < Count; ++p) {
+               pupper[p] += (pband[p] * reflectance);
+               plowerpixel[p] += (pband[p] * pband[p]);
+            }
          }
-      } else {
-         invalidpixel = false;
-      }
 
-      // Si el pixel es valido hago el proc normal.
-      if (invalidpixel == false) {
-         std::vector<SpectralAngleMapperAlgorithm::ClassSpectralInfo>::const_iterator cit =
-               Classes.begin();
-
-         for (int c = 0;
-               classindex == ClassInformation::NoClassIndex && cit != Classes.end();
-               ++cit, ++c) {
-            double spectralangle = cit->maxangle_ + 1;
-            double upper = 0;
-            double lowerpixel = 0, lowerreflectance = 0;
-            std::vector<SpectralAngleMapperAlgorithm::BandSpectralInfo>::const_iterator bit =
-                  cit->bands_.begin();
-            for (; bit != (cit->bands_.end()); ++bit) {
-               // obtengo el valor del pixel en la banda
-               double pixeldata =
-                     static_cast<double>(psrc.at(bit->band_)[pixelposition]);
-               upper += (pixeldata * bit->reflectance_);
-               lowerpixel += (pixeldata * pixeldata);
-               lowerreflectance += (bit->reflectance_ * bit->reflectance_);
-            }
-            if (lowerpixel == 0 || lowerreflectance == 0) continue;
-            double lower = sqrt(lowerpixel * lowerreflectance);
-            spectralangle = acos(upper / lower);
-            classindex =
-                  spectralangle <= cit->maxangle_ ? cit->classIndex_ :
-                                                    ClassInformation::NoClassIndex;
+         for (size_t p = 0; p < Count; ++p) {
+            if (pDest[p] != ClassInformation::NoClassIndex || plowerpixel[p] == 0)
+               continue;
+            double lower = sqrt(plowerpixel[p] * lowerreflectance);
+            double spectralangle = acos(pupper[p] / lower);
+            pDest[p] = spectralangle <= classinfo.maxangle_ ? classinfo.classIndex_ :
+                                                              ClassInformation::NoClassIndex;
+            if (pDest[p] != ClassInformation::NoClassIndex)
+               --pending;
          }
-      } else {
-         // Sino le pongo un valor para la parte de la imagen que no
-         // es valida.
-         classindex = NDVPixelValue;
       }
-      pDest[pixelposition] = classindex;
    }
 
-   return true;
-}
+private:
+   int bandCount_; /*! cantidad de bandas */
+   const std::vector<SpectralAngleMapperAlgorithm::ClassSpectralInfo> &classes_; /*! clases */
+   std::vector<double> lowerReflectances_; /*! norma al cuadrado de cada firma */
+};
 
 /**
  * El algoritmo de clasificacion spectral angle mapper debe verificar las firmas espectrales
@@ -218,9 +242,6 @@ SpectralAngleMapperAlgorithm::SpectralAngleMapperAlgorithm() :
 }
 
 /** Inicializa mapa de tipos de datos. */
-INITIALIZE_DATATYPE_MAP(SpectralAngleMapperAlgorithm::ClassifyFunctionType,
-                        samClassification);
-
 INITIALIZE_DATATYPE_MAP(SpectralAngleMapperAlgorithm::FloatClassifyFunctionType, samCalculator);
 
 /** Destructor */
@@ -386,7 +407,8 @@ wxXmlNode* SpectralAngleMapperAlgorithm::CreateBandNode(
 }
 
 /**
- * Utiliza la funcion de sam para asignar una clase a cada pixel.
+ * Utiliza la funcion de sam para asignar una clase a cada pixel. Clasifica
+ * con ClassificationEngine.
  * @param[in] pDest destino de la clasificacion
  * @param[in] pSource fuente de datos para clasificar
  * @param[in] Size cantidad de pixeles
@@ -394,9 +416,12 @@ wxXmlNode* SpectralAngleMapperAlgorithm::CreateBandNode(
  */
 bool SpectralAngleMapperAlgorithm::Classify(int* pDest, std::vector<void*> pSource,
                                             size_t Size, const std::string &DataType) {
-   function_ = samClassificationTypeMap[DataType];
-   return function_(pDest, pSource, Size, GetNDVPixelValue(), GetNoDataValue(),
-                    IsNoDataValueAvailable(), classes_);
+   SpectralAngleMapperKernel kernel(pSource.size(), classes_);
+   if (!kernel.IsValid())
+      return false;
+   ClassificationEngine engine;
+   return engine.Classify(kernel, pDest, pSource, Size, DataType,
+                          IsNoDataValueAvailable(), GetNDVPixelValue());
 }
 
 /**
@@ -58,11 +58,6 @@ public:
       double maxangle_;
       std::vector<BandSpectralInfo> bands_;
    };
-   /** Funcion clasificacion */
-   typedef bool (*ClassifyFunctionType)(
-         int*, std::vector<void*>&, size_t, int, double, bool,
-         const std::vector<SpectralAngleMapperAlgorithm::ClassSpectralInfo> &Classes);   
-
    /**
     * Definicion de puntero a funcion para poder configurar la salida como float para el calculo de
     * del angulo espectral en el pixel de salida
@@ -121,8 +116,6 @@ private:
    std::vector<ClassSpectralInfo> classes_;
    /** indice para no clase **/
    int noClassIndex_;
-   /*! puntero a funcion para la clasificacion */
-   ClassifyFunctionType function_;
 };
 
 } /** namespace suri */
@@ -0,0 +1,372 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#include "StatisticsCache.h"
+
+// Includes estandar
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+// Includes Suri
+#include "suri/Configuration.h"
+#include "suri/FileManagementFunctions.h"
+#include "suri/AuxiliaryFunctions.h"
+#include "SRStatisticsCanvas.h"
+#include "SRHistogramCanvas.h"
+#include "logmacros.h"
+
+// Includes Wx
+#include "wx/wx.h"
+#include "wx/xml/xml.h"
+#include "wx/filename.h"
+
+// Includes App
+
+// Defines
+/** Extension del archivo de cache */
+#define CACHE_FILE_EXTENSION ".stats.xml"
+/** Cantidad maxima de entradas por imagen */
+#define MAX_CACHE_ENTRIES 16
+/** Nodos y propiedades del archivo de cache */
+#define CACHE_ROOT_NODE "cache_estadisticas"
+#define CACHE_SIGNATURE_PROPERTY "firma"
+#define CACHE_ENTRY_NODE "entrada"
+#define CACHE_KEY_PROPERTY "clave"
+#define CACHE_TYPE_PROPERTY "tipo_de_dato"
+#define CACHE_BANDS_PROPERTY "bandas"
+#define CACHE_BAND_NODE "banda"
+#define CACHE_COUNT_PROPERTY "muestras"
+#define CACHE_MIN_PROPERTY "min"
+#define CACHE_MAX_PROPERTY "max"
+#define CACHE_MEAN_PROPERTY "media"
+#define CACHE_VARIANCE_PROPERTY "varianza_acumulada"
+#define CACHE_COVARIANCE_NODE "covarianza_acumulada"
+#define CACHE_HISTOGRAM_NODE "histograma"
+#define CACHE_BINS_PROPERTY "bins"
+
+namespace suri {
+namespace raster {
+namespace data {
+
+namespace {
+
+/** Convierte un double a string sin perder precision */
+wxString ToString(double Value) {
+   char buffer[32] = { 0 };
+   snprintf(buffer, sizeof(buffer), "%.17g", Value);
+   return wxString(buffer, wxConvUTF8);
+}
+
+/** Lee un double de una propiedad del nodo */
+double GetDoubleProperty(const wxXmlNode *pNode, const char *pName) {
+   wxString value = pNode->GetPropVal(wxString(pName, wxConvUTF8), wxT("0"));
+   return strtod(value.mb_str(), NULL);
+}
+
+/** Lee una lista de valores separados por espacios */
+std::vector<double> GetValues(const wxXmlNode *pNode) {
+   std::istringstream stream(std::string(pNode->GetNodeContent().mb_str()));
+   std::vector<double> values;
+   double value = 0;
+   while (stream >> value)
+      values.push_back(value);
+   return values;
+}
+
+/** Agrega un nodo de texto con una lista de valores separados por espacios */
+void AddValues(wxXmlNode *pParent, const char *pName, const std::vector<double> &Values) {
+   wxString content;
+   for (size_t i = 0; i < Values.size(); ++i)
+      content << (i > 0 ? wxT(" ") : wxT("")) << ToString(Values[i]);
+   new wxXmlNode(new wxXmlNode(pParent, wxXML_ELEMENT_NODE, wxString(pName, wxConvUTF8)),
+                 wxXML_TEXT_NODE, wxEmptyString, content);
+}
+
+}  // namespace
+
+/**
+ * @param[in] Url ruta de la imagen
+ */
+StatisticsCache::StatisticsCache(const std::string &Url) : url_(Url) {
+   signature_ = GetSourceSignature();
+}
+
+/** Dtor */
+StatisticsCache::~StatisticsCache() {
+}
+
+/**
+ * @return true si se habilito la cache en la configuracion y la imagen es un
+ * archivo local
+ */
+bool StatisticsCache::IsAvailable() const {
+   return Configuration::GetParameter("lib_statistics_cache", true)
+         && !signature_.empty();
+}
+
+/**
+ * @param[in] Key clave de las estadisticas
+ * @param[out] pStatistics estadisticas leidas (a cargo del codigo cliente)
+ * @param[out] pHistogram histograma leido (a cargo del codigo cliente). Si
+ * no es NULL la entrada debe tener histograma.
+ * @return true si encontro la entrada y la imagen no cambio
+ */
+bool StatisticsCache::Load(const std::string &Key, StatisticsBase* &pStatistics,
+                           HistogramBase** pHistogram) const {
+   if (!IsAvailable() || !wxFileName::FileExists(GetCachePath()))
+      return false;
+
+   wxLogNull nolog;
+   wxXmlDocument doc;
+   if (!doc.Load(GetCachePath()) || !doc.GetRoot()
+         || doc.GetRoot()->GetPropVal(wxT(CACHE_SIGNATURE_PROPERTY), wxEmptyString)
+               != wxString(signature_.c_str(), wxConvUTF8))
+      return false;
+
+   wxString key(Key.c_str(), wxConvUTF8);
+   for (wxXmlNode *pentry = doc.GetRoot()->GetChildren(); pentry != NULL;
+         pentry = pentry->GetNext()) {
+      if (pentry->GetName() != wxT(CACHE_ENTRY_NODE)
+            || pentry->GetPropVal(wxT(CACHE_KEY_PROPERTY), wxEmptyString) != key)
+         continue;
+      StatisticsBase* pstatistics = ReadStatistics(pentry);
+      if (!pstatistics)
+         return false;
+      if (pHistogram) {
+         *pHistogram = ReadHistogram(pentry, pstatistics->GetDataName());
+         if (!*pHistogram) {
+            delete pstatistics;
+            return false;
+         }
+      }
+      pStatistics = pstatistics;
+      REPORT_DEBUG("D: Estadisticas leidas de %s", GetCachePath().c_str());
+      return true;
+   }
+   return false;
+}
+
+/**
+ * Si la firma de la imagen cambio se descartan las entradas anteriores. Se
+ * conservan a lo sumo MAX_CACHE_ENTRIES entradas, descartando las mas viejas.
+ * @param[in] Key clave de las estadisticas
+ * @param[in] pStatistics estadisticas a guardar
+ * @param[in] pHistogram histograma a guardar (opcional)
+ * @return true si pudo escribir el archivo
+ */
+bool StatisticsCache::Save(const std::string &Key, StatisticsBase* pStatistics,
+                           HistogramBase* pHistogram) const {
+   if (!IsAvailable() || !pStatistics)
+      return false;
+
+   wxLogNull nolog;
+   wxString signature(signature_.c_str(), wxConvUTF8);
+   wxXmlDocument doc;
+   if (!wxFileName::FileExists(GetCachePath()) || !doc.Load(GetCachePath())
+         || !doc.GetRoot()
+         || doc.GetRoot()->GetPropVal(wxT(CACHE_SIGNATURE_PROPERTY), wxEmptyString)
+               != signature) {
+      wxXmlNode *proot = new wxXmlNode(NULL, wxXML_ELEMENT_NODE, wxT(CACHE_ROOT_NODE));
+      proot->AddProperty(wxT(CACHE_SIGNATURE_PROPERTY), signature);
+      doc.SetRoot(proot);
+   }
+
+   // Elimino la entrada con la misma clave y las que exceden el maximo
+   wxXmlNode *proot = doc.GetRoot();
+   wxString key(Key.c_str(), wxConvUTF8);
+   std::vector<wxXmlNode*> entries;
+   for (wxXmlNode *pentry = proot->GetChildren(); pentry != NULL;
+         pentry = pentry->GetNext())
+      entries.push_back(pentry);
+   int remaining = static_cast<int>(entries.size());
+   for (size_t i = 0; i < entries.size(); ++i) {
+      if (entries[i]->GetPropVal(wxT(CACHE_KEY_PROPERTY), wxEmptyString) == key
+            || remaining >= MAX_CACHE_ENTRIES) {
+         proot->RemoveChild(entries[i]);
+         delete entries[i];
+         --remaining;
+      }
+   }
+
+   wxXmlNode *pentry = CreateEntryNode(Key, pStatistics, pHistogram);
+   if (!pentry)
+      return false;
+   proot->AddChild(pentry);
+   if (!doc.Save(GetCachePath())) {
+      REPORT_DEBUG("D: No se pudo guardar la cache de estadisticas %s",
+                   GetCachePath().c_str());
+      return false;
+   }
+   return true;
+}
+
+/** @return ruta del archivo de cache */
+std::string StatisticsCache::GetCachePath() const {
+   return url_ + CACHE_FILE_EXTENSION;
+}
+
+/**
+ * @return tamanio y fecha de modificacion de la imagen, vacio si no es un
+ * archivo local
+ */
+std::string StatisticsCache::GetSourceSignature() const {
+   wxFileName filename(wxString(url_.c_str(), wxConvUTF8));
+   if (!filename.FileExists())
+      return std::string();
+   std::ostringstream signature;
+   signature << GetFileSize(url_) << ":"
+             << filename.GetModificationTime().GetTicks();
+   return signature.str();
+}
+
+/**
+ * @param[in] Key clave de la entrada
+ * @param[in] pStatistics estadisticas
+ * @param[in] pHistogram histograma (opcional)
+ * @return nodo con la entrada (a cargo del codigo cliente)
+ */
+wxXmlNode* StatisticsCache::CreateEntryNode(const std::string &Key,
+                                            StatisticsBase* pStatistics,
+                                            HistogramBase* pHistogram) {
+   int bandcount = pStatistics->GetBandCount();
+   if (!pStatistics->pMean_ || !pStatistics->pAccumVariance_)
+      return NULL;
+   wxXmlNode *pentry = new wxXmlNode(NULL, wxXML_ELEMENT_NODE, wxT(CACHE_ENTRY_NODE));
+   pentry->AddProperty(wxT(CACHE_KEY_PROPERTY), wxString(Key.c_str(), wxConvUTF8));
+   pentry->AddProperty(wxT(CACHE_TYPE_PROPERTY),
+                       wxString(pStatistics->GetDataName().c_str(), wxConvUTF8));
+   pentry->AddProperty(wxT(CACHE_BANDS_PROPERTY), ToString(bandcount));
+
+   for (int b = 0; b < bandcount; ++b) {
+      wxXmlNode *pband = new wxXmlNode(pentry, wxXML_ELEMENT_NODE, wxT(CACHE_BAND_NODE));
+      pband->AddProperty(wxT(CACHE_COUNT_PROPERTY), ToString(pStatistics->pPointCount_[b]));
+      pband->AddProperty(wxT(CACHE_MIN_PROPERTY), ToString(pStatistics->pMin_[b]));
+      pband->AddProperty(wxT(CACHE_MAX_PROPERTY), ToString(pStatistics->pMax_[b]));
+      pband->AddProperty(wxT(CACHE_MEAN_PROPERTY), ToString(pStatistics->pMean_[b]));
+      pband->AddProperty(wxT(CACHE_VARIANCE_PROPERTY),
+                         ToString(pStatistics->pAccumVariance_[b]));
+   }
+
+   std::vector<std::vector<double> > accum4covar = pStatistics->GetAccum4Covar();
+   std::vector<double> covariance;
+   for (size_t row = 0; row < accum4covar.size(); ++row)
+      covariance.insert(covariance.end(), accum4covar[row].begin(), accum4covar[row].end());
+   AddValues(pentry, CACHE_COVARIANCE_NODE, covariance);
+
+   for (int b = 0; pHistogram && b < pHistogram->GetBandCount(); ++b) {
+      std::vector<double> bins(pHistogram->GetBins()[b],
+                               pHistogram->GetBins()[b] + pHistogram->GetNumBins()[b]);
+      AddValues(pentry, CACHE_HISTOGRAM_NODE, bins);
+      wxXmlNode *phistogram = pentry->GetChildren();
+      while (phistogram->GetNext() != NULL)
+         phistogram = phistogram->GetNext();
+      phistogram->AddProperty(wxT(CACHE_MIN_PROPERTY), ToString(pHistogram->GetMin()[b]));
+      phistogram->AddProperty(wxT(CACHE_MAX_PROPERTY), ToString(pHistogram->GetMax()[b]));
+   }
+   return pentry;
+}
+
+/**
+ * @param[in] pEntryNode nodo de la entrada
+ * @return estadisticas leidas (a cargo del codigo cliente) o NULL
+ */
+StatisticsBase* StatisticsCache::ReadStatistics(const wxXmlNode *pEntryNode) {
+   std::string datatype(pEntryNode->GetPropVal(wxT(CACHE_TYPE_PROPERTY),
+                                                wxEmptyString).mb_str());
+   int bandcount = static_cast<int>(GetDoubleProperty(pEntryNode, CACHE_BANDS_PROPERTY));
+   StatisticsBase* pstatistics = render::StatisticsCanvas::CreateStatisticsFromDataType(
+         datatype, bandcount);
+   if (!pstatistics)
+      return NULL;
+
+   int band = 0;
+   std::vector<double> covariance;
+   for (wxXmlNode *pchild = pEntryNode->GetChildren(); pchild != NULL;
+         pchild = pchild->GetNext()) {
+      if (pchild->GetName() == wxT(CACHE_BAND_NODE) && band < bandcount) {
+         pstatistics->pPointCount_[band] = static_cast<long>(
+               GetDoubleProperty(pchild, CACHE_COUNT_PROPERTY));
+         pstatistics->pMin_[band] = GetDoubleProperty(pchild, CACHE_MIN_PROPERTY);
+         pstatistics->pMax_[band] = GetDoubleProperty(pchild, CACHE_MAX_PROPERTY);
+         pstatistics->pMean_[band] = GetDoubleProperty(pchild, CACHE_MEAN_PROPERTY);
+         pstatistics->pAccumVariance_[band] = GetDoubleProperty(pchild,
+                                                                CACHE_VARIANCE_PROPERTY);
+         ++band;
+      } else if (pchild->GetName() == wxT(CACHE_COVARIANCE_NODE)) {
+         covariance = GetValues(pchild);
+      }
+   }
+   if (band != bandcount
+         || covariance.size() != static_cast<size_t>(bandcount) * bandcount) {
+      delete pstatistics;
+      return NULL;
+   }
+   std::vector<std::vector<double> > accum4covar(bandcount);
+   for (int row = 0; row < bandcount; ++row)
+      accum4covar[row].assign(covariance.begin() + row * bandcount,
+                              covariance.begin() + (row + 1) * bandcount);
+   pstatistics->SetAccum4Covar(accum4covar);
+   return pstatistics;
+}
+
+/**
+ * @param[in] pEntryNode nodo de la entrada
+ * @param[in] DataType tipo de dato de la imagen
+ * @return histograma leido (a cargo del codigo cliente) o NULL si la entrada
+ * no tiene histograma
+ */
+HistogramBase* StatisticsCache::ReadHistogram(const wxXmlNode *pEntryNode,
+                                              const std::string &DataType) {
+   std::vector<std::vector<double> > frequencies;
+   std::vector<int> bins;
+   std::vector<double> mins, maxs;
+   for (wxXmlNode *pchild = pEntryNode->GetChildren(); pchild != NULL;
+         pchild = pchild->GetNext()) {
+      if (pchild->GetName() != wxT(CACHE_HISTOGRAM_NODE))
+         continue;
+      frequencies.push_back(GetValues(pchild));
+      bins.push_back(static_cast<int>(frequencies.back().size()));
+      mins.push_back(GetDoubleProperty(pchild, CACHE_MIN_PROPERTY));
+      maxs.push_back(GetDoubleProperty(pchild, CACHE_MAX_PROPERTY));
+   }
+   if (frequencies.empty())
+      return NULL;
+
+   HistogramBase* phistogram = render::HistogramCanvas::CreateHistogramFromDataType(
+         DataType, static_cast<int>(frequencies.size()), &bins[0], &mins[0], &maxs[0]);
+   for (size_t b = 0; phistogram && b < frequencies.size(); ++b)
+      for (size_t bin = 0; bin < frequencies[b].size(); ++bin)
+         phistogram->AddBinFrequency(static_cast<int>(b), static_cast<int>(bin),
+                                     static_cast<int>(frequencies[b][bin]));
+   return phistogram;
+}
+
+}  // namespace data
+}  // namespace raster
+}  // namespace suri
@@ -0,0 +1,102 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef STATISTICSCACHE_H_
+#define STATISTICSCACHE_H_
+
+// Includes estandar
+#include <string>
+
+// Includes Suri
+#include "SRDStatistics.h"
+#include "SRDHistogram.h"
+
+// Includes Wx
+
+// Includes App
+
+// Defines
+
+// forwards
+class wxXmlNode;
+
+namespace suri {
+namespace raster {
+namespace data {
+
+/** Cache persistente de estadisticas e histogramas de una imagen */
+/**
+ *  Guarda las estadisticas calculadas en un archivo junto a la imagen
+ * (<imagen>.stats.xml). Cada entrada se identifica con una clave que arma el
+ * codigo cliente (bandas, valor no valido, parametros del calculo) y el
+ * archivo completo se invalida si cambia el tamanio o la fecha de
+ * modificacion de la imagen.
+ *  A diferencia de CreateStatsNode/GetStats se guardan los acumuladores sin
+ * perdida, de forma que las estadisticas leidas sean identicas a las
+ * calculadas.
+ */
+class StatisticsCache {
+   /** Ctor. de Copia. */
+   StatisticsCache(const StatisticsCache &StatisticsCache);
+
+public:
+   /** Ctor */
+   explicit StatisticsCache(const std::string &Url);
+   /** Dtor */
+   ~StatisticsCache();
+   /** Indica si la cache esta habilitada y la imagen es un archivo local */
+   bool IsAvailable() const;
+   /** Busca las estadisticas (e histograma si se pide) de la clave */
+   bool Load(const std::string &Key, StatisticsBase* &pStatistics,
+             HistogramBase** pHistogram = NULL) const;
+   /** Guarda las estadisticas (e histograma si existe) con la clave */
+   bool Save(const std::string &Key, StatisticsBase* pStatistics,
+             HistogramBase* pHistogram = NULL) const;
+   /** Devuelve la ruta del archivo de cache */
+   std::string GetCachePath() const;
+
+private:
+   /** Devuelve la firma (tamanio y fecha de modificacion) de la imagen */
+   std::string GetSourceSignature() const;
+   /** Convierte las estadisticas e histograma en un nodo */
+   static wxXmlNode* CreateEntryNode(const std::string &Key, StatisticsBase* pStatistics,
+                                     HistogramBase* pHistogram);
+   /** Lee las estadisticas de un nodo */
+   static StatisticsBase* ReadStatistics(const wxXmlNode *pEntryNode);
+   /** Lee el histograma de un nodo */
+   static HistogramBase* ReadHistogram(const wxXmlNode *pEntryNode,
+                                       const std::string &DataType);
+
+   std::string url_; /*! Ruta de la imagen */
+   std::string signature_; /*! Firma de la imagen al crear la cache */
+};
+
+}  // namespace data
+}  // namespace raster
+}  // namespace suri
+
+#endif  // STATISTICSCACHE_H_
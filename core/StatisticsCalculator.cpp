@@ -26,23 +26,36 @@ For more information about SpaceSUR, visit <https://www.spacesur.com>.
 For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes Estandar
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
 // Includes Suri
 #include "suri/StatisticsCalculator.h"
+#include "suri/Configuration.h"
 #include "suri/xmlnames.h"
 #include "MovingWindowController.h"
 #include "KMeansAlgorithm.h"
 #include "KMeansCanvas.h"
 #include "suri/RasterElement.h"
 #include "SRStatisticsCanvas.h"
+#include "SRHistogramCanvas.h"
 #include "SRDStatistics.h"
 #include "SRDHistogram.h"
 #include "suri/ViewerWidget.h"
 #include "suri/World.h"
 #include "suri/LayerList.h"
 #include "suri/Dimension.h"
+#include "StatisticsCache.h"
 
 // Includes Wx
 // Defines
+/** Error por defecto del modo aproximado (medio percentil) */
+#define DEFAULT_APPROXIMATE_ERROR 0.005
+/** Probabilidad de superar el error pedido */
+#define APPROXIMATE_ERROR_PROBABILITY 0.05
+
 // forwards
 
 namespace suri {
@@ -52,7 +65,8 @@ namespace raster {
 namespace data {
 
 StatisticsCalculator::StatisticsCalculator(RasterElement* pRaster) :
-      pElement_(pRaster), useViewer_(true){
+      pElement_(pRaster), useViewer_(true), approximate_(false),
+      errorTarget_(DEFAULT_APPROXIMATE_ERROR), sampleCount_(0), fullExtent_(false) {
 }
 
 StatisticsCalculator::~StatisticsCalculator() {
@@ -116,6 +130,31 @@ bool StatisticsCalculator::CalculateHistogram(
    return *pHistogram != NULL;
 }
 
+/** Configura el modo aproximado **/
+void StatisticsCalculator::SetApproximate(bool Approximate, double ErrorTarget) {
+   approximate_ = Approximate;
+   errorTarget_ = ErrorTarget > 0 ? ErrorTarget : Configuration::GetParameter(
+         "lib_statistics_approximate_error", DEFAULT_APPROXIMATE_ERROR);
+}
+
+/** Devuelve la cantidad de pixeles (por banda) leidos en el ultimo calculo **/
+long StatisticsCalculator::GetSampleCount() const {
+   return sampleCount_;
+}
+
+/**
+ * Devuelve la cantidad de muestras necesaria para que la distribucion
+ * acumulada (y por lo tanto percentiles e histograma acumulado) tenga un
+ * error menor a ErrorTarget con probabilidad 1 - APPROXIMATE_ERROR_PROBABILITY
+ * (cota de Dvoretzky-Kiefer-Wolfowitz).
+ */
+long StatisticsCalculator::GetRequiredSampleCount(double ErrorTarget) {
+   if (ErrorTarget <= 0)
+      return std::numeric_limits<long>::max();
+   return static_cast<long>(ceil(log(2.0 / APPROXIMATE_ERROR_PROBABILITY)
+         / (2.0 * ErrorTarget * ErrorTarget)));
+}
+
 /** Metodo auxiliar que realiza el calculo de estadistica e histograma **/
 bool StatisticsCalculator::DoCalculateStatistics(
       suri::raster::data::StatisticsBase** pStatistics,
@@ -129,14 +168,31 @@ bool StatisticsCalculator::DoCalculateStatistics(
    double NoDataValue = 0.0;
    RetrieveNoDataValue(HasNoDataValue, NoDataValue);
 
+   // Las estadisticas y el histograma se acumulan en una unica lectura.
    suri::render::StatisticsCanvas statscanvas(InterBandStats);
    statscanvas.SetNoDataValueAvailable(HasNoDataValue);
    statscanvas.SetNoDataValue(NoDataValue);
-
-   MovingWindowController* pcontroller = new MovingWindowController();
+   if (CalculateHistogram)
+      statscanvas.EnableHistogram(suri::render::HistogramCanvas::kIntensityBins, Min, Max);
 
    World *pworld = new World();
    ConfigureWorld(pworld);
+
+   // Si se calcula sobre toda la imagen se consulta la cache persistente.
+   StatisticsCache cache(pElement_->GetUrl().c_str());
+   bool usecache = fullExtent_ && cache.IsAvailable();
+   std::string cachekey = usecache ? GetCacheKey(pworld, CalculateHistogram,
+                                                 ComputeAllBands, InterBandStats,
+                                                 Min, Max) : std::string();
+   if (usecache
+         && cache.Load(cachekey, *pStatistics, CalculateHistogram ? pHistogram : NULL)) {
+      (*pStatistics)->SetNoDataValueAvailable(HasNoDataValue);
+      (*pStatistics)->SetNoDataValue(NoDataValue);
+      delete pworld;
+      return true;
+   }
+
+   MovingWindowController* pcontroller = new MovingWindowController();
    LayerList *plist = new LayerList();
    ConfigureList(plist, ComputeAllBands);
 
@@ -148,25 +204,14 @@ bool StatisticsCalculator::DoCalculateStatistics(
    if (pcontroller->Render()) {
       *pStatistics = statscanvas.GetStatistics();
       if (CalculateHistogram) {
-         suri::render::HistogramCanvas histcanvas;
-         histcanvas.SetNoDataValueAvailable(HasNoDataValue);
-         histcanvas.SetNoDataValue(NoDataValue);
-         histcanvas.SetStatistics(*pStatistics);
-         if (static_cast<int>(Min.size()) == (*pStatistics)->GetBandCount()) {
-            for (size_t b = 0; b < Min.size(); ++b)
-               histcanvas.SetCustomMin(Min[b], b);
-         }
-         if (static_cast<int>(Max.size()) == (*pStatistics)->GetBandCount()) {
-            for (size_t b = 0; b < Max.size(); ++b)
-               histcanvas.SetCustomMax(Max[b], b);
-         }
-
-         pcontroller->SetOutputCanvas(&histcanvas);
-         if (pcontroller->Render()) {
-            *pHistogram = histcanvas.GetHistogram();
-         }
-
+         *pHistogram = statscanvas.GetHistogram();
+         // Sin rango fijo, si se supero la cantidad de valores distintos que
+         // se cuentan, se requiere otra lectura con el minimo y maximo calculados
+         if (*pHistogram == NULL && *pStatistics && statscanvas.NeedsHistogramPass())
+            this->CalculateHistogram(*pStatistics, pHistogram, ComputeAllBands, Min, Max);
       }
+      if (usecache)
+         cache.Save(cachekey, *pStatistics, CalculateHistogram ? *pHistogram : NULL);
    }
 
    pcontroller->SetRenderizationList(NULL);
@@ -207,6 +252,7 @@ void StatisticsCalculator::ConfigureWorld(World *pWorld) {
     Subset subset(0, 0, 0, 0), viewport(0, 0, 0, 0);
     // Si pude obtener el mundo del viewer activo asigna al subset la interseccion
     // entre el window y el world del mundo activo
+    fullExtent_ = !(pactiveworld && useViewer_);
     if (pactiveworld && useViewer_) {
        Subset window(0, 0, 0, 0), world(0, 0, 0, 0);
        pactiveworld->GetWindow(window);
@@ -234,12 +280,61 @@ void StatisticsCalculator::ConfigureWorld(World *pWorld) {
     // Auxiliar para obtener alto y ancho del viewport
     Dimension auxmatriz(viewport);
 
+    int viewportwidth = SURI_TRUNC(int, auxmatriz.GetWidth() );
+    int viewportheight = SURI_TRUNC(int, auxmatriz.GetHeight() );
+
+    // En modo aproximado se reduce el viewport (manteniendo la relacion de
+    // aspecto) hasta la cantidad de muestras requerida. El render lee entonces
+    // del overview mas chico que cubre ese tamanio.
+    double pixels = static_cast<double>(viewportwidth) * viewportheight;
+    double required = static_cast<double>(GetRequiredSampleCount(errorTarget_));
+    if (approximate_ && pixels > required) {
+       double factor = sqrt(required / pixels);
+       viewportwidth = std::max(1, SURI_TRUNC(int, SURI_CEIL(viewportwidth * factor)));
+       viewportheight = std::max(1, SURI_TRUNC(int, SURI_CEIL(viewportheight * factor)));
+    }
+    sampleCount_ = static_cast<long>(viewportwidth) * viewportheight;
+
     // Asigna el tamanio del raster en P-L al tamanio del viewport
-    pWorld->SetViewport(SURI_TRUNC(int, auxmatriz.GetWidth() ),
-                        SURI_TRUNC(int, auxmatriz.GetHeight() ));
+    pWorld->SetViewport(viewportwidth, viewportheight);
 }
 
 
+/**
+ * Arma la clave de la cache de estadisticas con los parametros que afectan
+ * el resultado: combinacion de bandas, valor no valido, resolucion del mundo
+ * (modo aproximado) y parametros del calculo.
+ */
+std::string StatisticsCalculator::GetCacheKey(World *pWorld, bool CalculateHistogram,
+                                              bool ComputeAllBands, bool InterBandStats,
+                                              const std::vector<double>& Min,
+                                              const std::vector<double>& Max) {
+   std::ostringstream key;
+   key.precision(17);
+   if (ComputeAllBands) {
+      key << "bandas=todas";
+   } else {
+      wxXmlNode* pcombination = pElement_->GetNode(
+            wxString(wxT(RENDERIZATION_NODE)) + wxT(NODE_SEPARATION_TOKEN)
+                  + wxString(BAND_COMBINATION_NODE));
+      key << "bandas=" << (pcombination ? pcombination->GetNodeContent().mb_str() : "");
+   }
+   bool hasnodatavalue = false;
+   double nodatavalue = 0.0;
+   RetrieveNoDataValue(hasnodatavalue, nodatavalue);
+   if (hasnodatavalue)
+      key << ";nodata=" << nodatavalue;
+   int width = 0, height = 0;
+   pWorld->GetViewport(width, height);
+   key << ";viewport=" << width << "x" << height << ";interbanda=" << InterBandStats;
+   if (CalculateHistogram) {
+      key << ";histograma=" << suri::render::HistogramCanvas::kIntensityBins;
+      for (size_t b = 0; b < Min.size() && Min.size() == Max.size(); ++b)
+         key << ";" << Min[b] << ":" << Max[b];
+   }
+   return key.str();
+}
+
 /**
  * Agrega un elemento a la lista.
  * @param[in] pList Lista con el elemento a renderizar
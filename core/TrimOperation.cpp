@@ -30,6 +30,9 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "TrimOperation.h"
 #include "VectorDatasource.h"
 #include "suri/Vector.h"
+#include "suri/Progress.h"
+#include "suri/messages.h"
+#include "SpatialIndex.h"
 // Includes Wx
 // Defines
 // forwards
@@ -48,7 +51,8 @@ TrimOperation::~TrimOperation() {
 }
 
 /** Procesa las fuentes de datos de entrada generando la diferencia de las capas en una nueva
- * fuente de datos
+ * fuente de datos. A cada feature de la primer capa solo se le restan los
+ * features de la segunda cuyas envolventes intersectan la suya.
  * @param[in] Operation tipo de operacion a realizar
  * @param[in] Datasources fuentes de datos sobre las que se quiere operar
  * @param[out] Fuente de datos vectorial con resultado de la operacion o NULL en caso de que
@@ -82,36 +86,54 @@ VectorDatasource* TrimOperation::DoProcessDatasource(
 
    pfirstlayer->ResetReading();
 
+   // Indice espacial de la segunda capa
+   std::vector<OGRFeature*> secondfeatures;
+   SpatialIndex secondindex;
+   LoadFeatures(psecondlayer, secondfeatures, secondindex);
+   int secondlayercount = secondfeatures.size();
+
    int firstlayercount = pfirstlayer->GetFeatureCount();
-   int secondlayercount = psecondlayer->GetFeatureCount();
    OGRFeatureDefn* pdestlayerfeaturedef = pdestlayer->GetLayerDefn();
-   for (int i = 0; i < firstlayercount; ++i) {
+   Progress progress(firstlayercount, _(message_PROCESSING_VECTOR_OPERATION));
+   bool abort = false;
+   std::vector<int> candidates;
+   for (int i = 0; !abort && i < firstlayercount; ++i) {
       OGRFeature *pfeature = pfirstlayer->GetNextFeature();
-      OGRGeometry* pgeom = pfeature->GetGeometryRef()->clone();
-      int j = 0;
-      bool lastfigure = false;
-      for (j = 0; j < secondlayercount; ++j) {
-         OGRFeature *psecondfeature = psecondlayer->GetNextFeature();
-         OGRFeature* pnewfeature = new OGRFeature(pdestlayerfeaturedef);
-         OGRGeometry* psecondgeom = psecondfeature->GetGeometryRef()->clone();
-         if (j == secondlayercount - 1)
-            lastfigure = true;
-         if (pgeom->Intersects(psecondgeom)) {
-            pgeom = pgeom->Difference(psecondgeom);
-         }
-         if (lastfigure) {
-            // Lleno el contenido del feature con los campos de las geometrias de origen
-            // copio los datos de la geometria 1.
-            CopyFieldsFromOrigin(pfeature, pnewfeature, pfirstlayerfeaturedef->GetFieldCount());
-            pnewfeature->SetGeometry(pgeom);
-            pdestlayer->CreateFeature(pnewfeature);
+      if (!pfeature)
+         break;
+      OGRGeometry* poriginal = pfeature->GetGeometryRef();
+      // Sin features en la segunda capa no se genera salida
+      if (poriginal != NULL && secondlayercount > 0) {
+         OGREnvelope envelope;
+         poriginal->getEnvelope(&envelope);
+         candidates.clear();
+         secondindex.Query(envelope, candidates);
+         PreparedGeometry prepared(poriginal);
+         OGRGeometry* pgeom = poriginal->clone();
+         for (size_t j = 0; pgeom != NULL && j < candidates.size(); ++j) {
+            OGRGeometry* psecondgeom = secondfeatures[candidates[j]]->GetGeometryRef();
+            if (prepared.Intersects(psecondgeom)) {
+               OGRGeometry* pdifference = pgeom->Difference(psecondgeom);
+               OGRGeometryFactory::destroyGeometry(pgeom);
+               pgeom = pdifference;
+            }
          }
+         OGRFeature* pnewfeature = new OGRFeature(pdestlayerfeaturedef);
+         // Lleno el contenido del feature con los campos de las geometrias de origen
+         // copio los datos de la geometria 1.
+         CopyFieldsFromOrigin(pfeature, pnewfeature, pfirstlayerfeaturedef->GetFieldCount());
+         pnewfeature->SetGeometryDirectly(pgeom);
+         pdestlayer->CreateFeature(pnewfeature);
          OGRFeature::DestroyFeature(pnewfeature);
       }
-      psecondlayer->ResetReading();
+      OGRFeature::DestroyFeature(pfeature);
+      abort = progress.Update();
    }
+   DestroyFeatures(secondfeatures);
 
    Vector::Close(pdesttarget);
+   if (abort)
+      return NULL;
 
    return VectorDatasource::Create(tmpFilename);
 }
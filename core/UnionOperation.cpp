@@ -29,7 +29,10 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 // Includes Suri
 #include "UnionOperation.h"
 #include "suri/Vector.h"
+#include "suri/Progress.h"
+#include "suri/messages.h"
 #include "VectorDatasource.h"
+#include "SpatialIndex.h"
 // Includes Wx
 // Defines
 // forwards
@@ -49,7 +52,8 @@ UnionOperation::~UnionOperation() {
 }
 
 /** Procesa las fuentes de datos de entrada generando la union de ambas en una nueva
- * fuente de datos
+ * fuente de datos. Cada feature de la primer capa solo se compara con los
+ * features de la segunda cuyas envolventes intersectan la suya.
  * @param[in] Operation tipo de operacion a realizar
  * @param[in] Datasources fuentes de datos sobre las que se quiere operar
  * @param[out] Fuente de datos vectorial con resultado de la operacion o NULL en caso de que
@@ -86,10 +90,14 @@ VectorDatasource* UnionOperation::DoProcessDatasource(VectorOperation::Operation
    OGRFree(pwkt);
 
    pfirstlayer->ResetReading();
-   psecondlayer->ResetReading();
+
+   // Indice espacial de la segunda capa
+   std::vector<OGRFeature*> secondfeatures;
+   SpatialIndex secondindex;
+   LoadFeatures(psecondlayer, secondfeatures, secondindex);
 
    int firstlayercount = pfirstlayer->GetFeatureCount();
-   int secondlayercount = psecondlayer->GetFeatureCount();
+   int secondlayercount = secondfeatures.size();
 
 
    /** mapa con geometrias que tuvieron alguna operacion
@@ -100,16 +108,35 @@ VectorDatasource* UnionOperation::DoProcessDatasource(VectorOperation::Operation
    std::multimap<int, OGRGeometry*> pendinggeoms;
    OGRFeatureDefn* pdestlayerfeaturedef = pdestlayer->GetLayerDefn();
 
-   for (int i = 0; i < firstlayercount; ++i) {
+   Progress progress(firstlayercount, _(message_PROCESSING_VECTOR_OPERATION));
+   bool abort = false;
+   std::vector<int> candidates;
+   for (int i = 0; !abort && i < firstlayercount; ++i) {
       OGRFeature *pfeature = pfirstlayer->GetNextFeature();
-      OGRGeometry* pgeom = pfeature->GetGeometryRef()->clone();
+      if (!pfeature)
+         break;
+      OGRGeometry* poriginal = pfeature->GetGeometryRef();
+      if (poriginal == NULL) {
+         OGRFeature::DestroyFeature(pfeature);
+         abort = progress.Update();
+         continue;
+      }
+      OGRGeometry* pgeom = poriginal->clone();
       std::string geomname = pgeom->getGeometryName();
-      for (int j = 0; j < secondlayercount; ++j) {
-         OGRFeature *psecondfeature = psecondlayer->GetNextFeature();
-         OGRGeometry* pgeom2 = psecondfeature->GetGeometryRef()->clone();
-         // Los unicos casos que tienen que contemplarse en el if son los de los poligonos
-         if ((pgeom->Intersects(pgeom2) || pgeom2->Intersects(pgeom)) &&
-               geomname.compare(POLYGON) == 0 &&
+      OGREnvelope envelope;
+      poriginal->getEnvelope(&envelope);
+      candidates.clear();
+      secondindex.Query(envelope, candidates);
+      PreparedGeometry prepared(poriginal);
+      for (size_t c = 0; c < candidates.size(); ++c) {
+         int j = candidates[c];
+         OGRFeature *psecondfeature = secondfeatures[j];
+         OGRGeometry* pgeom2 = psecondfeature->GetGeometryRef();
+         // Los unicos casos que tienen que contemplarse en el if son los de los poligonos.
+         // Las geometrias de la segunda capa que no se operan se agregan al
+         // finalizar el recorrido.
+         if (pgeom != NULL && geomname.compare(POLYGON) == 0 && prepared.Intersects(pgeom2) &&
+               (pgeom->Intersects(pgeom2) || pgeom2->Intersects(pgeom)) &&
                (!pgeom->Contains(pgeom2) && !pgeom2->Contains(pgeom))) {
             /**
              * Ademas de la resta surgen 2 geometrias:
@@ -118,8 +145,7 @@ VectorDatasource* UnionOperation::DoProcessDatasource(VectorOperation::Operation
              */
 
             // Geometria 1.
-            OGRGeometry* pintersectgeom = pfeature->GetGeometryRef()->clone();
-            pintersectgeom = pintersectgeom->Intersection(pgeom2);
+            OGRGeometry* pintersectgeom = poriginal->Intersection(pgeom2);
             // Se debe generar un nuevo feature con los campos de la capa destino
             OGRFeature* pintersectfeature = new OGRFeature(pdestlayerfeaturedef);
             pintersectfeature->SetGeometryDirectly(pintersectgeom);
@@ -137,18 +163,13 @@ VectorDatasource* UnionOperation::DoProcessDatasource(VectorOperation::Operation
             pdestlayer->CreateFeature(pintersectfeature);
 
             // Geometria 2.
-            pendinggeoms.insert(
-                  std::make_pair(j, pgeom2->Difference(pfeature->GetGeometryRef())));
+            pendinggeoms.insert(std::make_pair(j, pgeom2->Difference(poriginal)));
 
-            pgeom = pgeom->Difference(pgeom2);
+            OGRGeometry* pdifference = pgeom->Difference(pgeom2);
+            OGRGeometryFactory::destroyGeometry(pgeom);
+            pgeom = pdifference;
 
             OGRFeature::DestroyFeature(pintersectfeature);
-         } else {
-            // Se debe generar un nuevo feature con los campos de la capa destino
-            // Insertar geometria en multimap. Si se hace una vez sola entonces
-            // se copia bien la geometria.
-            // Si se inserta varias veces tambien pero se interseca contra si misma
-            pendinggeoms.insert(std::make_pair(j, pgeom2));
          }
       }
       // Se debe generar un nuevo feature con los campos de la capa destino
@@ -159,13 +180,31 @@ VectorDatasource* UnionOperation::DoProcessDatasource(VectorOperation::Operation
       CopyFieldsFromOrigin(pfeature, pnewfeature, pfirstlayerfeaturedef->GetFieldCount());
       pdestlayer->CreateFeature(pnewfeature);
       OGRFeature::DestroyFeature(pnewfeature);
-      psecondlayer->ResetReading();
+      OGRFeature::DestroyFeature(pfeature);
+      abort = progress.Update();
    }
 
+   // Las geometrias de la segunda capa que no se operaron se copian sin cambios
+   for (int j = 0; !abort && firstlayercount > 0 && j < secondlayercount; ++j) {
+      OGRGeometry* pgeom2 = secondfeatures[j]->GetGeometryRef();
+      if (pgeom2 != NULL && pendinggeoms.find(j) == pendinggeoms.end())
+         pendinggeoms.insert(std::make_pair(j, pgeom2->clone()));
+   }
+   DestroyFeatures(secondfeatures);
+
    // Recorro el multimap y interseco por grupo
-   DoGroupIntersection(pendinggeoms, pfirstlayer, psecondlayer, pdestlayer);
+   if (!abort) {
+      psecondlayer->ResetReading();
+      DoGroupIntersection(pendinggeoms, pfirstlayer, psecondlayer, pdestlayer);
+   } else {
+      std::multimap<int, OGRGeometry*>::iterator it = pendinggeoms.begin();
+      for (; it != pendinggeoms.end(); ++it)
+         OGRGeometryFactory::destroyGeometry(it->second);
+   }
 
    Vector::Close(pdesttarget);
+   if (abort)
+      return NULL;
 
    return VectorDatasource::Create(tmpFilename);
 }
@@ -28,6 +28,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 // Includes Estandar
 // Includes Suri
 #include "VectorOperation.h"
+#include "SpatialIndex.h"
 // Includes Wx
 // Defines
 // forwards
@@ -47,6 +48,74 @@ VectorOperation::VectorOperation() : pSucesor_(NULL) {
 VectorOperation::~VectorOperation() {
 }
 
+/**
+ * Prepara la geometria si GDAL tiene soporte de geometrias preparadas.
+ * @param[in] pGeometry geometria (debe existir mientras se use la instancia)
+ */
+VectorOperation::PreparedGeometry::PreparedGeometry(const OGRGeometry* pGeometry) :
+      pGeometry_(pGeometry) {
+#ifdef __OGR_PREPARED_GEOMETRY__
+   pPrepared_ = (pGeometry != NULL && OGRHasPreparedGeometrySupport()) ?
+         OGRCreatePreparedGeometry(pGeometry) : NULL;
+#endif
+}
+
+/** Dtor */
+VectorOperation::PreparedGeometry::~PreparedGeometry() {
+#ifdef __OGR_PREPARED_GEOMETRY__
+   if (pPrepared_ != NULL)
+      OGRDestroyPreparedGeometry(pPrepared_);
+#endif
+}
+
+/**
+ * @param[in] pGeometry geometria a evaluar
+ * @return true si las geometrias se intersectan
+ */
+bool VectorOperation::PreparedGeometry::Intersects(const OGRGeometry* pGeometry) const {
+   if (pGeometry_ == NULL || pGeometry == NULL)
+      return false;
+#ifdef __OGR_PREPARED_GEOMETRY__
+   if (pPrepared_ != NULL)
+      return OGRPreparedGeometryIntersects(pPrepared_, pGeometry);
+#endif
+   return pGeometry_->Intersects(const_cast<OGRGeometry*>(pGeometry));
+}
+
+/**
+ * El id de cada feature en el indice es su posicion en Features (los
+ * features sin geometria no se indexan).
+ * @param[in] pLayer capa a leer
+ * @param[out] Features features de la capa (responsabilidad del invocante,
+ * eliminar con DestroyFeatures)
+ * @param[out] Index indice espacial de las envolventes de los features
+ */
+void VectorOperation::LoadFeatures(OGRLayer* pLayer, std::vector<OGRFeature*> &Features,
+                                   SpatialIndex &Index) {
+   pLayer->ResetReading();
+   OGRFeature* pfeature = pLayer->GetNextFeature();
+   while (pfeature) {
+      OGRGeometry* pgeometry = pfeature->GetGeometryRef();
+      if (pgeometry != NULL) {
+         OGREnvelope envelope;
+         pgeometry->getEnvelope(&envelope);
+         Index.Insert(static_cast<int>(Features.size()), envelope);
+      }
+      Features.push_back(pfeature);
+      pfeature = pLayer->GetNextFeature();
+   }
+   Index.Build();
+}
+
+/**
+ * @param[in] Features features a eliminar
+ */
+void VectorOperation::DestroyFeatures(std::vector<OGRFeature*> &Features) {
+   for (size_t i = 0; i < Features.size(); ++i)
+      OGRFeature::DestroyFeature(Features[i]);
+   Features.clear();
+}
+
 /**
  * Objetivo: Genera un archivo shp en el directorio temporal del sistema
  * @param[in]  HtmlSrc: contenido del archivo a generar.
@@ -30,16 +30,27 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes Estandar
 #include <stddef.h>
+#include <vector>
 #include "suri/DatasourceInterface.h"
 // Includes Suri
 // Includes Wx
 // Defines
 // forwards
 class OGRFeature;
+class OGRLayer;
+// Includes otros
+#include "gdal_version.h"
+#include "ogr_geometry.h"
+
+/** Las geometrias preparadas de GEOS estan disponibles desde GDAL 1.11 */
+#if defined(GDAL_VERSION_NUM) && GDAL_VERSION_NUM >= 1110000
+#define __OGR_PREPARED_GEOMETRY__
+#endif
 
 namespace suri {
 // forwards
 class VectorDatasource;
+class SpatialIndex;
 
 class VectorOperation {
 public:
@@ -75,6 +86,31 @@ public:
    }
 
 protected:
+   /** Geometria preparada para evaluar intersecciones contra muchas geometrias */
+   class PreparedGeometry {
+      /** Ctor. de Copia. */
+      PreparedGeometry(const PreparedGeometry &PreparedGeometry);
+
+   public:
+      /** Ctor */
+      explicit PreparedGeometry(const OGRGeometry* pGeometry);
+      /** Dtor */
+      ~PreparedGeometry();
+      /** Indica si la geometria intersecta a pGeometry */
+      bool Intersects(const OGRGeometry* pGeometry) const;
+
+   private:
+      const OGRGeometry* pGeometry_; /*! Geometria original */
+#ifdef __OGR_PREPARED_GEOMETRY__
+      OGRPreparedGeometry* pPrepared_; /*! Geometria preparada (NULL si no hay soporte) */
+#endif
+   };
+
+   /** Lee todos los features de una capa y arma el indice espacial de sus envolventes */
+   static void LoadFeatures(OGRLayer* pLayer, std::vector<OGRFeature*> &Features,
+                            SpatialIndex &Index);
+   /** Elimina los features leidos con LoadFeatures */
+   static void DestroyFeatures(std::vector<OGRFeature*> &Features);
    /** Genera un archivo shp en el directorio temporal del sistema */
    std::string GetTempFile();
    /** Procesa las fuentes de datos de entrada generando la operacion correspondiente
@@ -32,6 +32,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include <utility>
 #include <map>
 #include <string>
+#include <vector>
 
 // Includes suri
 #include "VectorRenderer.h"
@@ -50,9 +51,13 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "suri/TransformationFactory.h"
 #include "suri/TransformationFactoryBuilder.h"
 #include "suri/ExactCoordinatesTransformation.h"
+#include "suri/ApproximateCoordinatesTransformation.h"
+#include "suri/Configuration.h"
 #include "suri/FileVectorCanvas.h"
 #include <suri/XmlFunctions.h>
 #include "FiltredVectorRenderer.h"
+#include "ProjectedVectorCache.h"
+#include "MemoryVector.h"
 
 // Includes wx
 #include "wx/wx.h"
@@ -66,6 +71,14 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #define _VECTORRENDERER_GEOMETRIES_CACHE_ 100
 /** Cantidad de puntos a tener en cuenta en una transformacion de coordenadas */
 #define _VECTORRENDERER_EXTENT_POINTS_ 100
+/** Error maximo (en pixeles) al interpolar la reproyeccion */
+#define DEFAULT_APPROXIMATION_TOLERANCE 0.125
+/** Cantidad maxima de vertices por capa en la cache de geometrias reproyectadas */
+#define DEFAULT_PROJECTED_CACHE_MAX_VERTICES 20000000
+/** Cantidad maxima de capas (o filtros) con cache de geometrias */
+#define _VECTORRENDERER_PROJECTED_CACHES_ 4
+/** Error maximo (en pixeles) al simplificar las geometrias de la cache */
+#define DEFAULT_LOD_TOLERANCE 0.5
 /** Mascara para anotacion */
 #define ANNOTATION_PREVIEW_MASK_RED 1
 /** Mascara para anotacion */
@@ -81,6 +94,142 @@ AUTO_REGISTER_RENDERER(suri::VectorRenderer);
 
 /** namespace suri */
 namespace suri {
+
+/**
+ * Transforma los vertices de una linea o anillo.
+ * @param[in] pLine linea a transformar
+ * @param[in] pTransform transformacion a aplicar
+ * @param[in] Inverse sentido de la transformacion
+ * @return true si se transformaron todos los vertices
+ */
+bool transformlinestring(OGRLineString* pLine, const CoordinatesTransformation* pTransform,
+                         bool Inverse) {
+   int pointcount = pLine->getNumPoints();
+   if (pointcount == 0)
+      return true;
+   std::vector<double> x(pointcount), y(pointcount), z;
+   bool threedimensional = pLine->getCoordinateDimension() == 3;
+   if (threedimensional)
+      z.resize(pointcount);
+   for (int i = 0; i < pointcount; ++i) {
+      x[i] = pLine->getX(i);
+      y[i] = pLine->getY(i);
+      if (threedimensional)
+         z[i] = pLine->getZ(i);
+   }
+   // Todos los vertices se transforman con una sola llamada y la linea solo
+   // se modifica si se transformaron todos
+   if (pTransform->Transform(&x[0], &y[0], pointcount, Inverse) != pointcount)
+      return false;
+   pLine->setPoints(pointcount, &x[0], &y[0], threedimensional ? &z[0] : NULL);
+   return true;
+}
+
+/**
+ * Transforma los vertices de una geometria (puntos, lineas, poligonos y
+ * colecciones) con una CoordinatesTransformation.
+ * @param[in] pGeometry geometria a transformar
+ * @param[in] pTransform transformacion a aplicar
+ * @param[in] Inverse sentido de la transformacion
+ * @return false si el tipo de geometria no esta soportado o si fallo la
+ * transformacion de algun vertice
+ */
+bool transformgeometry(OGRGeometry* pGeometry, const CoordinatesTransformation* pTransform,
+                       bool Inverse) {
+   switch (wkbFlatten(pGeometry->getGeometryType())) {
+      case wkbPoint: {
+         OGRPoint* ppoint = static_cast<OGRPoint*>(pGeometry);
+         Coordinates point(ppoint->getX(), ppoint->getY());
+         if (pTransform->Transform(point, Inverse) == 0)
+            return false;
+         ppoint->setX(point.x_);
+         ppoint->setY(point.y_);
+         return true;
+      }
+      case wkbLineString:
+      case wkbLinearRing:
+         return transformlinestring(static_cast<OGRLineString*>(pGeometry), pTransform,
+                                    Inverse);
+      case wkbPolygon: {
+         OGRPolygon* ppolygon = static_cast<OGRPolygon*>(pGeometry);
+         if (ppolygon->getExteriorRing() != NULL
+               && !transformlinestring(ppolygon->getExteriorRing(), pTransform, Inverse))
+            return false;
+         for (int i = 0; i < ppolygon->getNumInteriorRings(); ++i)
+            if (!transformlinestring(ppolygon->getInteriorRing(i), pTransform, Inverse))
+               return false;
+         return true;
+      }
+      case wkbMultiPoint:
+      case wkbMultiLineString:
+      case wkbMultiPolygon:
+      case wkbGeometryCollection: {
+         OGRGeometryCollection* pcollection = static_cast<OGRGeometryCollection*>(pGeometry);
+         for (int i = 0; i < pcollection->getNumGeometries(); ++i)
+            if (!transformgeometry(pcollection->getGeometryRef(i), pTransform, Inverse))
+               return false;
+         return true;
+      }
+      default:
+         return false;
+   }
+}
+
+/**
+ * Reproyecta una geometria de la capa al sistema del mundo. Usa la
+ * transformacion aproximada si existe y soporta el tipo de geometria.
+ * @param[in] pGeometry geometria a reproyectar
+ * @param[in] pTransform transformacion exacta mundo -> capa
+ * @param[in] pApproximate transformacion aproximada de pTransform o NULL
+ */
+void reprojectgeometry(OGRGeometry* pGeometry, CoordinatesTransformation* pTransform,
+                       const CoordinatesTransformation* pApproximate) {
+   ExactCoordinatesTransformation* pctcoord =
+         dynamic_cast<ExactCoordinatesTransformation*>(pTransform);
+   if (pctcoord == NULL || pctcoord->IsIdentity() || pctcoord->GetOGRCT(true) == NULL)
+      return;
+   if (pApproximate == NULL || !transformgeometry(pGeometry, pApproximate, true))
+      pGeometry->transform(pctcoord->GetOGRCT(true));
+}
+
+/**
+ * Convierte una etiqueta de multibyte a la codificacion de los xml.
+ * @param[in] Value etiqueta a convertir
+ * @return etiqueta convertida o Value si no se pudo convertir
+ */
+std::string convertannotation(const std::string &Value) {
+   std::string auxtemp = wxString(wxConvUTF8.cMB2WC(Value.c_str()),
+                                  wxCSConv(suri::XmlElement::xmlEncoding_.c_str())).c_str();
+   return auxtemp.empty() ? Value : auxtemp;
+}
+
+/**
+ * Transforma los vertices de una linea o anillo a coordenadas de viewport
+ * con una sola llamada al modelo del mundo.
+ * @param[in] pLine linea en coordenadas de mundo
+ * @param[in] pWorldWindow mundo con el viewport
+ * @param[out] X columnas (redondeadas) de los vertices
+ * @param[out] Y filas (redondeadas) de los vertices
+ */
+void getviewportcoordinates(const OGRLineString* pLine, const World* pWorldWindow,
+                            std::vector<int> &X, std::vector<int> &Y) {
+   int pointcount = pLine->getNumPoints();
+   X.resize(pointcount);
+   Y.resize(pointcount);
+   if (pointcount == 0)
+      return;
+   std::vector<double> x(pointcount), y(pointcount);
+   for (int i = 0; i < pointcount; ++i) {
+      x[i] = pLine->getX(i);
+      y[i] = pLine->getY(i);
+   }
+   pWorldWindow->InverseTransform(&x[0], &y[0], pointcount);
+   for (int i = 0; i < pointcount; ++i) {
+      X[i] = SURI_ROUND(int, x[i]);
+      Y[i] = SURI_ROUND(int, y[i]);
+   }
+}
+
 /**
  * Constructor
  * @return instancia de la clase VectorRenderer
@@ -92,6 +241,7 @@ VectorRenderer::VectorRenderer() : pVector_(NULL) {
  * Destructor
  */
 VectorRenderer::~VectorRenderer() {
+   ClearProjectedCaches();
    Vector::Close(pVector_);
 }
 
@@ -627,17 +777,44 @@ bool VectorRenderer::DoRenderLayer(OGRLayer* pLayer, VectorStyle * pVstyle,
    // Filtrado de atributos
    pLayer->SetAttributeFilter(parameters_.attributeFilter_.c_str());
 
+   // Si la capa esta en la cache no se lee ni se reproyecta
+   ProjectedVectorCache* pcache = GetProjectedCache(pLayer, LayerIndex, pWorldWindow, pct);
+
    // Filtrado espacial
-   if (!ApplySpatialFilter(pLayer, pct, pWorldWindow)) {
+   if (pcache == NULL && !ApplySpatialFilter(pLayer, pct, pWorldWindow)) {
       delete pct;
       return false;
    }
 
+   // Aproxima la reproyeccion de la capa dentro del filtro espacial
+   ApproximateCoordinatesTransformation* papproximate = NULL;
+   double tolerance = Configuration::GetParameter(
+         "lib_reprojection_approximation_tolerance", DEFAULT_APPROXIMATION_TOLERANCE);
+   OGRGeometry* pfilter = pcache == NULL ? pLayer->GetSpatialFilter() : NULL;
+   if (tolerance > 0 && pfilter != NULL && !pct->IsIdentity()) {
+      OGREnvelope envelope;
+      pfilter->getEnvelope(&envelope);
+      Subset window;
+      pWorldWindow->GetWindow(window);
+      Dimension windim(window);
+      int vpwidth = 0, vpheight = 0;
+      pWorldWindow->GetViewport(vpwidth, vpheight);
+      double pixelsize = std::min(windim.GetWidth() / vpwidth,
+                                  windim.GetHeight() / vpheight);
+      papproximate = new ApproximateCoordinatesTransformation(
+            pct, Subset(envelope.MinX, envelope.MaxY, envelope.MaxX, envelope.MinY),
+            tolerance * pixelsize, true);
+   }
+
    // Ciclo principal de renderizado
    pLayer->ResetReading();
    std::vector<OGRFeature *> featurecache; // Cache de los features
-   OGRFeature *pfeature = pLayer->GetNextFeature(); // Apunta al primer feature
+   OGRFeature *pfeature = pcache == NULL ? pLayer->GetNextFeature() : NULL;
    bool renderizationresult = true;
+   if (pcache != NULL)
+      renderizationresult = RenderCachedLayer(pcache, pLayer, pVstyle, LayerIndex,
+                                              pWorldWindow, pCanvas, pMask, expression,
+                                              labelfieldindex);
    while (pfeature) {
       featurecache.push_back(pfeature);
       pfeature = pLayer->GetNextFeature();
@@ -661,12 +838,7 @@ bool VectorRenderer::DoRenderLayer(OGRLayer* pLayer, VectorStyle * pVstyle,
                   if (pgeom != NULL) {
                      // Reproyecta la geometria al sistema del mundo
                      // TODO(Gabriel - TCK #2324): Ver porque se necesita este metodo puntual
-                     ExactCoordinatesTransformation* pctcoord =
-                           dynamic_cast<ExactCoordinatesTransformation*>(pct);
-                     if (pctcoord != NULL && !pctcoord->IsIdentity()
-                           && pctcoord->GetOGRCT(true) != NULL) {
-                        pgeom->transform(pctcoord->GetOGRCT(true));
-                     }
+                     reprojectgeometry(pgeom, pct, papproximate);
                      geomvec.push_back(pgeom);
                   }
                   // Labels
@@ -680,34 +852,17 @@ bool VectorRenderer::DoRenderLayer(OGRLayer* pLayer, VectorStyle * pVstyle,
                if (pgeom != NULL) {
                   // Reproyecta la geometria al sistema del mundo
                   // TODO(Gabriel - TCK #2324): Ver porque se necesita este metodo puntual
-                  ExactCoordinatesTransformation* pctcoord =
-                                             dynamic_cast<ExactCoordinatesTransformation*>(pct);
-                  if (pct != NULL && !pct->IsIdentity()
-                        && pctcoord->GetOGRCT(true) != NULL) {
-                     pgeom->transform(pctcoord->GetOGRCT(true));
-                  }
+                  reprojectgeometry(pgeom, pct, papproximate);
                   geomvec.push_back(pgeom);
                   // Labels
                   if (!expression.empty()) {
                      if (labelfieldindex != -1) {
-                        std::string value = std::string(
-                              featurecache[nfeat]->GetFieldAsString(
-                                    labelfieldindex));
                         // Convierto Multibyte a Byte.
-                        std::string auxtemp =
-                              wxString(wxConvUTF8.cMB2WC(value.c_str()),
-                                    wxCSConv(
-                                          suri::XmlElement::xmlEncoding_.c_str())).c_str();
-
-                        if (!auxtemp.empty()) value = auxtemp;
-                        annotvec.push_back(value);
+                        annotvec.push_back(convertannotation(
+                              featurecache[nfeat]->GetFieldAsString(labelfieldindex)));
                      } else {
                         // Convierto Multibyte a Byte.
-                        std::string auxtemp =
-                              wxString(wxConvUTF8.cMB2WC(expression.c_str()),
-                                    wxCSConv(
-                                          suri::XmlElement::xmlEncoding_.c_str())).c_str();
-                        if (!auxtemp.empty()) expression = auxtemp;
+                        expression = convertannotation(expression);
                         annotvec.push_back(expression);
                      }
                   }
@@ -760,6 +915,7 @@ bool VectorRenderer::DoRenderLayer(OGRLayer* pLayer, VectorStyle * pVstyle,
 #endif
    // Si no limipio el filtro, otras clases que editen la capa lo usaran sin saber
    pLayer->SetSpatialFilter(NULL);
+   delete papproximate;
    delete pct;
    return renderizationresult;
 }   
@@ -889,6 +1045,7 @@ void VectorRenderer::Update(Element *pElement) {
    }
    Vector::Close(ptemp);
    parameters_ = param;
+   ClearProjectedCaches();
 }
 
 // --------------------------- METODOS PROTEGIDOS -------------------------------
@@ -902,6 +1059,156 @@ Vector* VectorRenderer::OpenVector() {
    return Vector::Open(parameters_.vectorUrl_);
 }
 
+/**
+ * La cache solo se usa con archivos locales (se invalida si cambia el
+ * archivo) y no con vectores en memoria o filtrados, que pueden cambiar sin
+ * que se actualice el renderizador. La primera vez lee todos los features de
+ * la capa (sin filtro espacial) y los reproyecta al sistema del mundo.
+ * @param[in] pLayer capa con el filtro de atributos aplicado
+ * @param[in] LayerIndex indice de la capa
+ * @param[in] pWorldWindow mundo en el que se renderiza
+ * @param[in] pCoordsTransform transformacion mundo -> capa
+ * @return cache con la capa completa o NULL si no se puede usar
+ */
+ProjectedVectorCache* VectorRenderer::GetProjectedCache(
+      OGRLayer* pLayer, int LayerIndex, const World *pWorldWindow,
+      CoordinatesTransformation *pCoordsTransform) {
+   int maxvertices = Configuration::GetParameter("lib_vector_render_cache_max_vertices",
+                                                 DEFAULT_PROJECTED_CACHE_MAX_VERTICES);
+   if (maxvertices <= 0 || IS_MEMORY_VECTOR(parameters_.vectorUrl_)
+         || dynamic_cast<FiltredVectorRenderer*>(this) != NULL
+         || dynamic_cast<FiltredVectorRenderer*>(pPreviousRenderer_) != NULL)
+      return NULL;
+
+   std::stringstream key;
+   key << LayerIndex << "|" << parameters_.attributeFilter_ << "|"
+       << pWorldWindow->GetSpatialReference() << "|" << parameters_.layersSR_[LayerIndex];
+   std::map<std::string, ProjectedVectorCache*>::iterator it = projectedCaches_.find(
+         key.str());
+   if (it != projectedCaches_.end()) {
+      // Si no esta cargada es porque la capa supera la cantidad de vertices
+      if (it->second->IsCurrent())
+         return it->second->IsLoaded() ? it->second : NULL;
+      delete it->second;
+      projectedCaches_.erase(it);
+   }
+
+   ProjectedVectorCache* pcache = new ProjectedVectorCache(parameters_.vectorUrl_,
+                                                           maxvertices);
+   if (!pcache->IsCurrent()) {
+      delete pcache;
+      return NULL;
+   }
+   if (projectedCaches_.size() >= _VECTORRENDERER_PROJECTED_CACHES_)
+      ClearProjectedCaches();
+   projectedCaches_[key.str()] = pcache;
+
+   pLayer->SetSpatialFilter(NULL);
+   pLayer->ResetReading();
+   bool loaded = true;
+   OGRFeature *pfeature = NULL;
+   while (loaded && (pfeature = pLayer->GetNextFeature()) != NULL) {
+      OGRGeometry* pgeometry = pfeature->StealGeometry();
+      if (pgeometry != NULL) {
+         // Se reproyecta una sola vez, con la transformacion exacta por lotes
+         reprojectgeometry(pgeometry, pCoordsTransform, pCoordsTransform);
+         loaded = pcache->AddFeature(pfeature->GetFID(), pgeometry);
+      }
+      OGRFeature::DestroyFeature(pfeature);
+   }
+   if (!loaded) {
+      REPORT_DEBUG("D:La capa supera la cantidad de vertices de la cache.");
+      return NULL;
+   }
+   pcache->SetLoaded();
+   return pcache;
+}
+
+/**
+ * Elige el nivel de detalle segun el tamanio de pixel del mundo y renderiza
+ * los features cuya envolvente intersecta la ventana (con el mismo margen
+ * que el filtro espacial). Las etiquetas que dependen de un campo se leen de
+ * la capa para los features visibles.
+ * @param[in] pCache cache con la capa completa
+ * @param[in] pLayer capa (para leer las etiquetas)
+ * @param[in] pVstyle estilo de la capa
+ * @param[in] LayerIndex indice de la capa
+ * @param[in] pWorldWindow mundo en el que se renderiza
+ * @param[in] pCanvas canvas destino
+ * @param[in] pMask mascara
+ * @param[in] Expression expresion de la etiqueta
+ * @param[in] LabelIndex indice del campo de la etiqueta o -1
+ * @return resultado de la renderizacion del ultimo feature
+ */
+bool VectorRenderer::RenderCachedLayer(ProjectedVectorCache* pCache, OGRLayer* pLayer,
+                                       VectorStyle* pVstyle, int LayerIndex,
+                                       const World *pWorldWindow, Canvas* pCanvas,
+                                       Mask* pMask, const std::string& Expression,
+                                       int LabelIndex) {
+   Subset wwindow;
+   pWorldWindow->GetWindow(wwindow);
+   Dimension windim(wwindow);
+   int vpwidth = 0, vpheight = 0;
+   pWorldWindow->GetViewport(vpwidth, vpheight);
+   if (vpwidth <= 0 || vpheight <= 0) {
+      REPORT_DEBUG("D:Viewport invalido.");
+      return false;
+   }
+   double pixelsize = std::min(windim.GetWidth() / vpwidth, windim.GetHeight() / vpheight);
+   int level = pCache->GetLevel(
+         Configuration::GetParameter("lib_vector_render_lod_tolerance",
+                                     DEFAULT_LOD_TOLERANCE) * pixelsize);
+
+   Extent extent(wwindow + std::max(windim.GetHeight(), windim.GetWidth()));
+   OGREnvelope window;
+   window.MinX = extent.min_.x_;
+   window.MinY = extent.min_.y_;
+   window.MaxX = extent.max_.x_;
+   window.MaxY = extent.max_.y_;
+   std::vector<size_t> features;
+   pCache->GetFeatures(window, features);
+
+   // Convierto Multibyte a Byte.
+   std::string expression = Expression.empty() ? Expression : convertannotation(Expression);
+   bool fieldlabel = !Expression.empty() && LabelIndex != -1;
+   bool renderizationresult = true;
+   for (size_t i = 0; i < features.size(); ++i) {
+      std::string annotation = expression;
+      if (fieldlabel) {
+         OGRFeature *pfeature = pLayer->GetFeature(pCache->GetFeatureId(features[i]));
+         if (pfeature != NULL) {
+            annotation = convertannotation(pfeature->GetFieldAsString(LabelIndex));
+            OGRFeature::DestroyFeature(pfeature);
+         }
+      }
+      std::vector<OGRGeometry *> geomvec;
+      std::vector<std::string> annotvec;
+      OGRGeometry* pgeometry = pCache->GetGeometry(features[i], level);
+      OGRGeometryCollection* pmultigeom = dynamic_cast<OGRGeometryCollection *>(pgeometry);
+      if (pmultigeom != NULL) {
+         for (int ngeom = 0; ngeom < pmultigeom->getNumGeometries(); ngeom++) {
+            geomvec.push_back(pmultigeom->getGeometryRef(ngeom));
+            annotvec.push_back(annotation);
+         }
+      } else {
+         geomvec.push_back(pgeometry);
+         if (!Expression.empty())
+            annotvec.push_back(annotation);
+      }
+      renderizationresult = RenderGeometries(LayerIndex, geomvec, annotvec, pVstyle,
+                                             pWorldWindow, pCanvas->GetDC(), pMask);
+   }
+   return renderizationresult;
+}
+
+/** Elimina las caches de geometrias reproyectadas */
+void VectorRenderer::ClearProjectedCaches() {
+   std::map<std::string, ProjectedVectorCache*>::iterator it = projectedCaches_.begin();
+   for (; it != projectedCaches_.end(); ++it)
+      delete it->second;
+   projectedCaches_.clear();
+}
+
 /** Renderiza una capa de poligonos */
 /**
  *  TODO Soporte de poligonos con huecos
@@ -974,9 +1281,10 @@ bool VectorRenderer::RenderPolygons(const std::vector<OGRGeometry *> &Geometries
          int xtemp = 0, ytemp = 0;
          int polygonspointcount = 0;
          int exteriorlinepointcount = 0;
+         std::vector<int> ringx, ringy;
+         getviewportcoordinates(plinearring, pWorldWindow, ringx, ringy);
          for (int i = 0; i < totalringpoints; i++) {
-            int x, y;
-            pWorldWindow->W2VTransform(plinearring->getX(i), plinearring->getY(i), x, y);
+            int x = ringx[i], y = ringy[i];
             if (xtemp != x || ytemp != y || i == 0) {
                pwxpoly[polygonspointcount] = wxPoint(x, y);
                pwxline[exteriorlinepointcount] = wxPoint(x, y);
@@ -993,9 +1301,9 @@ bool VectorRenderer::RenderPolygons(const std::vector<OGRGeometry *> &Geometries
             int innerpointcount = 0;
             int totalinteriorringpoints = interiorrings[i]->getNumPoints();
             wxPoint *pwxinnerline = new wxPoint[totalinteriorringpoints];
+            getviewportcoordinates(interiorrings[i], pWorldWindow, ringx, ringy);
             for (int ix = 0; ix < totalinteriorringpoints; ++ix) {
-               int x, y;
-               pWorldWindow->W2VTransform(interiorrings[i]->getX(ix), interiorrings[i]->getY(ix), x, y);
+               int x = ringx[ix], y = ringy[ix];
                if (xtemp != x || ytemp != y || i == 0) {
                   pwxpoly[polygonspointcount] = wxPoint(x, y);
                   pwxinnerline[innerpointcount] = wxPoint(x, y);
@@ -1090,9 +1398,10 @@ bool VectorRenderer::RenderLines(const std::vector<OGRGeometry *> &GeometriesVec
          wxPoint *pwxline = new wxPoint[totallinepoints];
          int xtemp = 0, ytemp = 0;
          int pointcount = 0;
+         std::vector<int> linex, liney;
+         getviewportcoordinates(pline, pWorldWindow, linex, liney);
          for (int i = 0; i < totallinepoints; i++) {
-            int x, y;
-            pWorldWindow->W2VTransform(pline->getX(i), pline->getY(i), x, y);
+            int x = linex[i], y = liney[i];
             if (xtemp != x || ytemp != y || i == 0) {
                pwxline[pointcount] = wxPoint(x, y);
                xtemp = x;
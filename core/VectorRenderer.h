@@ -51,6 +51,7 @@ namespace suri {
 
 // forwards
 class CoordinatesTransformation;
+class ProjectedVectorCache;
 
 /** Renderer de los vectores (utiliza las clases del OGR/GDAL) */
 /**
@@ -144,6 +145,17 @@ protected:
                                  wxDC * pDC, Mask* &pMask);
    /** Retorna vector a renderizar */
    virtual Vector* OpenVector();
+   /** Devuelve la cache de geometrias reproyectadas de la capa (la carga si no existe) */
+   ProjectedVectorCache* GetProjectedCache(OGRLayer* pLayer, int LayerIndex,
+                                           const World *pWorldWindow,
+                                           CoordinatesTransformation *pCoordsTransform);
+   /** Renderiza los features visibles de la capa desde la cache */
+   bool RenderCachedLayer(ProjectedVectorCache* pCache, OGRLayer* pLayer,
+                          VectorStyle* pVstyle, int LayerIndex,
+                          const World *pWorldWindow, Canvas* pCanvas, Mask* pMask,
+                          const std::string& Expression, int LabelIndex);
+   /** Elimina las caches de geometrias reproyectadas */
+   void ClearProjectedCaches();
    /** Renderiza una capa de poligonos */
    static bool RenderPolygons(
          const std::vector<OGRGeometry *> &GeometriesVector, VectorStyle * pVStyle,
@@ -178,6 +190,8 @@ protected:
    Parameters parameters_; /*! parametros de renderizacion (visualizacion) */
 
    Vector *pVector_; /*! Vector */
+   /*! Geometrias reproyectadas por capa, filtro y sistemas de referencia */
+   std::map<std::string, ProjectedVectorCache*> projectedCaches_;
    /** Carga las capas al mapa pasado por parametro **/
    static void LoadLayersSrs(const wxXmlNode *plnode,
                              std::map<int, std::string> *layers);
@@ -33,11 +33,14 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 namespace suri {
 
 /** Constructor */
-VertexSegmentSnapStrategy::VertexSegmentSnapStrategy() {
+VertexSegmentSnapStrategy::VertexSegmentSnapStrategy() :
+      pVertex_(new VertexSnapStrategy()), pSegment_(new SegmentSnapStrategy()) {
 }
 
 /** Destructor */
 VertexSegmentSnapStrategy::~VertexSegmentSnapStrategy() {
+   delete pVertex_;
+   delete pSegment_;
 }
 
 /**
@@ -46,28 +49,83 @@ VertexSegmentSnapStrategy::~VertexSegmentSnapStrategy() {
  * @param[in] PhantomPoint punto fantasma que quiere agregarse con referencia espacial
  */
 bool VertexSegmentSnapStrategy::DoSnap(Coordinates &ViewportPosition, OGRPoint* PhantomPoint) {
-   VertexSnapStrategy* vertex = new VertexSnapStrategy();
-   ConfigureStrategyEnvironment(vertex);
-   if (!vertex->DoSnap(ViewportPosition, PhantomPoint)) {
-      SegmentSnapStrategy* segment = new SegmentSnapStrategy();
-      ConfigureStrategyEnvironment(segment);
-      segment->DoSnap(ViewportPosition, PhantomPoint);
-      delete segment;
-   }
-   delete vertex;
+   if (!pVertex_->DoSnap(ViewportPosition, PhantomPoint))
+      pSegment_->DoSnap(ViewportPosition, PhantomPoint);
    return true;
 }
 
 /**
- * Configura el entorno de la estrategia a utilizar
- * param[in] pSnap estrategia concreta
+ * Configura el mundo que se utilizara
+ * @param[in] pWorld puntero al mundo
  */
-void VertexSegmentSnapStrategy::ConfigureStrategyEnvironment(SnapInterface* pSnap) {
-   pSnap->SetWorld(pWorld_);
-   pSnap->SetVertexGeometries(vertexgeometries_);
-   pSnap->SetVertexBufferGeometries(vertexbuffers_);
-   pSnap->SetSegmentGeometries(segmentgeometries_);
-   pSnap->SetSegmentBufferGeometries(segmentbuffers_);
+void VertexSegmentSnapStrategy::SetWorld(World* pWorld) {
+   SnapInterface::SetWorld(pWorld);
+   pVertex_->SetWorld(pWorld);
+   pSegment_->SetWorld(pWorld);
+}
+
+/**
+ * Configura el vector con las geometrias correspondientes a los segmentos
+ * @param[in] SegmentGeometries vector con las geometrias correspondientes a los segmentos
+ */
+void VertexSegmentSnapStrategy::SetSegmentGeometries(
+      const std::vector<OGRGeometry*> &SegmentGeometries) {
+   SnapInterface::SetSegmentGeometries(SegmentGeometries);
+   pVertex_->SetSegmentGeometries(SegmentGeometries);
+   pSegment_->SetSegmentGeometries(SegmentGeometries);
+}
+
+/**
+ * Configura el vector con las geometrias correspondientes a los vertices
+ * @param[in] VertexGeometries vector con las geometrias correspondientes a los vertices
+ */
+void VertexSegmentSnapStrategy::SetVertexGeometries(
+      const std::vector<OGRGeometry*> &VertexGeometries) {
+   SnapInterface::SetVertexGeometries(VertexGeometries);
+   pVertex_->SetVertexGeometries(VertexGeometries);
+   pSegment_->SetVertexGeometries(VertexGeometries);
+}
+
+/**
+ * Configura el vector con las geometrias correspondientes a los buffers de los vertices
+ * @param[in] VertexBuffers vector con las geoms correspondientes a los buffers de los vertices
+ */
+void VertexSegmentSnapStrategy::SetVertexBufferGeometries(
+      const std::vector<OGRGeometry*> &VertexBuffers) {
+   SnapInterface::SetVertexBufferGeometries(VertexBuffers);
+   pVertex_->SetVertexBufferGeometries(VertexBuffers);
+   pSegment_->SetVertexBufferGeometries(VertexBuffers);
+}
+
+/**
+ * Configura el vector con las geometrias correspondientes a los buffers de los segmentos
+ * @param[in] SegmentBuffers vector con las geoms correspondientes a los buffers de los segmentos
+ */
+void VertexSegmentSnapStrategy::SetSegmentBufferGeometries(
+      const std::vector<OGRGeometry*> &SegmentBuffers) {
+   SnapInterface::SetSegmentBufferGeometries(SegmentBuffers);
+   pVertex_->SetSegmentBufferGeometries(SegmentBuffers);
+   pSegment_->SetSegmentBufferGeometries(SegmentBuffers);
+}
+
+/**
+ * Configura el indice espacial de los vertices
+ * @param[in] pVertexIndex indice con las posiciones de los vertices
+ */
+void VertexSegmentSnapStrategy::SetVertexIndex(const SnapIndex* pVertexIndex) {
+   SnapInterface::SetVertexIndex(pVertexIndex);
+   pVertex_->SetVertexIndex(pVertexIndex);
+   pSegment_->SetVertexIndex(pVertexIndex);
+}
+
+/**
+ * Configura el indice espacial de los segmentos
+ * @param[in] pSegmentIndex indice con las posiciones de los segmentos
+ */
+void VertexSegmentSnapStrategy::SetSegmentIndex(const SnapIndex* pSegmentIndex) {
+   SnapInterface::SetSegmentIndex(pSegmentIndex);
+   pVertex_->SetSegmentIndex(pSegmentIndex);
+   pSegment_->SetSegmentIndex(pSegmentIndex);
 }
 
 /** Retorna el tipo de estrategia que utiliza el snapping */
@@ -33,6 +33,10 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 namespace suri {
 
+// forwards
+class VertexSnapStrategy;
+class SegmentSnapStrategy;
+
 // Modifica las coordenadas de un punto acoplandolo al punto mas cercano de la geometria/vertice
 class VertexSegmentSnapStrategy : public SnapInterface {
 public:
@@ -44,10 +48,25 @@ public:
    virtual bool DoSnap(Coordinates &ViewportPosition, OGRPoint* PhantomPoint);
    /** Retorna el tipo de estrategia que utiliza el snapping */
    virtual std::string GetStrategyType();
+   /** Configura el mundo que se utilizara */
+   virtual void SetWorld(World* pWorld);
+   /** Configura el vector con las geometrias correspondientes a los segmentos */
+   virtual void SetSegmentGeometries(const std::vector<OGRGeometry*> &SegmentGeometries);
+   /** Configura el vector con las geometrias correspondientes a los vertices */
+   virtual void SetVertexGeometries(const std::vector<OGRGeometry*> &VertexGeometries);
+   /** Configura el vector con las geometrias correspondientes a los buffers de los vertices */
+   virtual void SetVertexBufferGeometries(const std::vector<OGRGeometry*> &VertexBuffers);
+   /** Configura el vector con las geometrias correspondientes a los buffers de los segmentos */
+   virtual void SetSegmentBufferGeometries(const std::vector<OGRGeometry*> &SegmentBuffers);
+   /** Configura el indice espacial de los vertices */
+   virtual void SetVertexIndex(const SnapIndex* pVertexIndex);
+   /** Configura el indice espacial de los segmentos */
+   virtual void SetSegmentIndex(const SnapIndex* pSegmentIndex);
 
 private:
-   /** Configura el entorno de la estrategia a utilizar */
-   void ConfigureStrategyEnvironment(SnapInterface* pSnap);
+   /** Estrategias concretas (se configuran junto con esta estrategia) */
+   VertexSnapStrategy* pVertex_;
+   SegmentSnapStrategy* pSegment_;
 };
 
 } /** namespace suri */
@@ -49,10 +49,13 @@ VertexSnapStrategy::~VertexSnapStrategy() {
  * @param[in] PhantomPoint punto fantasma que quiere agregarse con referencia espacial
  */
 bool VertexSnapStrategy::DoSnap(Coordinates &ViewportPosition, OGRPoint* PhantomPoint) {
-   // Itero las geometrias existentes para ver si hay interseccion
+   // Itero los vertices cercanos para ver si hay interseccion
+   std::vector<int> candidates;
+   GetVertexCandidates(PhantomPoint, candidates);
    int index = -1;
    double min = std::numeric_limits<double>::max();
-   for (size_t geom = 0; geom < vertexbuffers_.size(); ++geom) {
+   for (size_t i = 0; i < candidates.size(); ++i) {
+      int geom = candidates[i];
       if (!PhantomPoint->Within(vertexbuffers_[geom]))
          continue;
       double distance = PhantomPoint->Distance(vertexgeometries_[geom]);
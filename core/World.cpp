@@ -488,6 +488,46 @@ void World::Transform(const Coordinates &Viewport, Coordinates &World) const {
    pRasterModel_->Transform(World);
 }
 
+/** Transforma arreglos de coordenadas de Mundo en coordenadas de Viewport */
+/**
+ * Transforma todos los puntos con una sola llamada al modelo raster.
+ * @param[in,out] pX Coordenadas x de Mundo, a la salida columnas de Viewport
+ * @param[in,out] pY Coordenadas y de Mundo, a la salida filas de Viewport
+ * @param[in] Count Cantidad de coordenadas
+ */
+void World::InverseTransform(double* pX, double* pY, size_t Count) const {
+   if (!pRasterModel_) {
+      for (size_t i = 0; i < Count; ++i) {
+         Coordinates viewport;
+         InverseTransform(Coordinates(pX[i], pY[i]), viewport);
+         pX[i] = viewport.x_;
+         pY[i] = viewport.y_;
+      }
+      return;
+   }
+   pRasterModel_->InverseTransform(pX, pY, Count);
+}
+
+/** Transforma arreglos de coordenadas de Viewport en coordenadas de Mundo */
+/**
+ * Transforma todos los puntos con una sola llamada al modelo raster.
+ * @param[in,out] pX Columnas de Viewport, a la salida coordenadas x de Mundo
+ * @param[in,out] pY Filas de Viewport, a la salida coordenadas y de Mundo
+ * @param[in] Count Cantidad de coordenadas
+ */
+void World::Transform(double* pX, double* pY, size_t Count) const {
+   if (!pRasterModel_) {
+      for (size_t i = 0; i < Count; ++i) {
+         Coordinates world;
+         Transform(Coordinates(pX[i], pY[i]), world);
+         pX[i] = world.x_;
+         pY[i] = world.y_;
+      }
+      return;
+   }
+   pRasterModel_->Transform(pX, pY, Count);
+}
+
 /** retorna true si el mundo esta inicializado, viewport!=0 y tiene wkt_ no nulo */
 /**
  * Indica si el mundo esta inicializado o no.
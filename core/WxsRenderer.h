@@ -84,6 +84,9 @@ public:
    virtual WxsRenderer* Create(Element *pElement, Renderer *pPreviousRenderer) const;
    /** Nombre del renderizador == al nombre del nodo */
    virtual std::string CreatedNode() const;
+   /** No lee por adelantado: la imagen wxs se abre para cada ventana */
+   virtual void Prefetch(const World *pWorldWindow) {
+   }
 
 protected:
    /** Actualiza parametros de clase padre */
@@ -38,6 +38,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "suri/World.h"
 #include "suri/Canvas.h"
 #include "Mask.h"
+#include "CanvasBandBuffers.h"
 #include "suri/Dimension.h"
 #include "suri/Wkt.h"
 #include "suri/CoordinatesTransformation.h"
@@ -81,6 +82,25 @@ void zoom(void* pDest, void* pSrc, size_t Size, double Step, double Offset) {
 /** Inicializa mapa de tipos de datos. */
 INITIALIZE_DATATYPE_MAP(ZoomRenderer::Parameters::InterpolationFunctionType, zoom);
 
+/**
+ * Convierte el tipo de interpolacion del zoom al tipo de remuestreo.
+ * @param[in] Interpolation tipo de interpolacion del zoom
+ * @return tipo de remuestreo equivalente
+ */
+Resampler::ResamplingType resamplingtype(
+      ZoomRenderer::Parameters::InterpolationType Interpolation) {
+   switch (Interpolation) {
+      case ZoomRenderer::Parameters::Bilinear:
+         return Resampler::Bilinear;
+      case ZoomRenderer::Parameters::CubicCombolution:
+         return Resampler::Cubic;
+      case ZoomRenderer::Parameters::Lanczos:
+         return Resampler::Lanczos;
+      default:
+         return Resampler::NearestNeighbour;
+   }
+}
+
 ZoomRenderer::ZoomRenderer() {
 }
 
@@ -108,6 +128,8 @@ ZoomRenderer::Parameters ZoomRenderer::GetParameters(const wxXmlNode *pNode) {
    }
    Parameters params;
    params.interpolation_ = Parameters::None;
+   params.noDataValueAvailable_ = false;
+   params.noDataValue_ = 0;
    wxXmlNode *pnode = pNode->GetChildren();
    while (pnode != NULL) {
       if (pnode->GetName() == RENDERIZATION_NODE) {
@@ -119,10 +141,15 @@ ZoomRenderer::Parameters ZoomRenderer::GetParameters(const wxXmlNode *pNode) {
                                        &interpolation)) {
                   break;
                }
-               // \todo Incluir soporte para otras interpolaciones
-               if (std::string(INTERPOLATION_PROPERTY_VALUE_NEAREST_NEIGHBOUR)
-                     == interpolation.c_str()) {
+               std::string name = interpolation.c_str();
+               if (name == INTERPOLATION_PROPERTY_VALUE_NEAREST_NEIGHBOUR) {
                   params.interpolation_ = Parameters::NearestNeighbour;
+               } else if (name == INTERPOLATION_PROPERTY_VALUE_BILINEAR) {
+                  params.interpolation_ = Parameters::Bilinear;
+               } else if (name == INTERPOLATION_PROPERTY_VALUE_CUBIC_COMBOLUTION) {
+                  params.interpolation_ = Parameters::CubicCombolution;
+               } else if (name == INTERPOLATION_PROPERTY_VALUE_LANCZOS) {
+                  params.interpolation_ = Parameters::Lanczos;
                }
             }
             pcnode = pcnode->GetNext();
@@ -168,15 +195,17 @@ ZoomRenderer *ZoomRenderer::Create(Element *pElement,
       return NULL;
    }
    Parameters params = GetParameters(pnode);
-   if (params.interpolation_ != Parameters::NearestNeighbour) {
+   if (params.interpolation_ == Parameters::None) {
       REPORT_AND_FAIL_VALUE("D:Interpolacion no soportada", NULL);
    }
+   pElement->GetNoDataValue(params.noDataValueAvailable_, params.noDataValue_);
 
    int x, y, b;
    std::string datatype;
    pPreviousRenderer->GetOutputParameters(x, y, b, datatype);
    params.function_ = zoomTypeMap[datatype];
-   if (!params.function_) {
+   params.resampleFunction_ = Resampler::GetResampleFunction(datatype);
+   if (!params.function_ || !params.resampleFunction_) {
       REPORT_AND_FAIL_VALUE("D:Tipo de dato (%s) no manejado", NULL, datatype.c_str());
    }
    ZoomRenderer *pzoom = new ZoomRenderer;
@@ -266,31 +295,27 @@ bool ZoomRenderer::Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pMas
    pWorldWindow->GetViewport(vpwidth, vpheight);
    // el canvas es menor que el viewport, debo hacer zoom
    if ((csizex < vpwidth || csizey < vpheight) && (vpwidth > 0 && vpheight > 0)) {
-      REPORT_DEBUG("D:Aplicando ZOOM con interpolacion NN");
+      REPORT_DEBUG("D:Aplicando ZOOM con interpolacion %s",
+                   Resampler::GetName(resamplingtype(parameters_.interpolation_)).c_str());
       // indice de bandas
       std::vector<int> bands(pCanvas->GetBandCount());
-      // datos originales
-      std::vector<void*> data(pCanvas->GetBandCount());
       // datos zoomeados
       std::vector<void*> zoomdata(pCanvas->GetBandCount());
       // indice de mascara
       std::vector<int> maskbands(1, 0);
-      // mascara original
-      std::vector<void*> maskdata(pCanvas->GetBandCount());
       // mascara zoomeada
       std::vector<void*> zoommaskdata(pCanvas->GetBandCount());
       for (int b = 0; b < pCanvas->GetBandCount(); b++) {
          bands[b] = b;
-         data[b] = new unsigned char[csizex * csizey * pCanvas->GetDataSize()];
          zoomdata[b] = new unsigned char[vpwidth * vpheight * pCanvas->GetDataSize()];
          memset(zoomdata[b], 255, vpwidth * vpheight * pCanvas->GetDataSize());
       }
       if (pMask) {
-         maskdata[0] = new unsigned char[csizex * csizey * pMask->GetDataSize()];
          zoommaskdata[0] = new unsigned char[vpwidth * vpheight * pMask->GetDataSize()];
       }
-      // me traigo los datos
-      pCanvas->Read(bands, data);
+      // datos originales (los buffers del canvas si los presta)
+      CanvasBandBuffers input(pCanvas, bands);
+      std::vector<void*> &data = input.GetData();
       REPORT_DEBUG("D:Tamano del canvas de entrada %d;%d", csizex, csizey);
       REPORT_DEBUG("D:Tamano de viewport %d;%d", vpwidth, vpheight);
       double offsetx = windowsubset.ul_.x_ - SURI_TRUNC(int, windowsubset.ul_.x_),
@@ -326,8 +351,22 @@ bool ZoomRenderer::Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pMas
                1.0/stepx, 1.0/stepy);
       }
 #endif   /* __SECURE_ZOOM_STEP_CALCULATION_FIX__ */
+      // Pesos por columna y fila de salida para las interpolaciones no NN
+      Resampler::ResamplingType resampling = resamplingtype(parameters_.interpolation_);
+      Resampler::WeightTable columns, rows;
+      if (resampling != Resampler::NearestNeighbour) {
+         columns.Initialize(resampling, vpwidth, stepx, offsetx, csizex);
+         rows.Initialize(resampling, vpheight, stepy, offsety, csizey);
+      }
       // recorro las bandas de entrada
       for (int b = 0; b < pCanvas->GetBandCount(); b++) {
+         if (resampling != Resampler::NearestNeighbour) {
+            parameters_.resampleFunction_(data[b], csizex, 0, 0, zoomdata[b], columns,
+                                          rows, 0, vpheight,
+                                          parameters_.noDataValueAvailable_,
+                                          parameters_.noDataValue_);
+            continue;
+         }
          // hago zoom en las filas
          for (int j = 0; j < vpheight; j++) {
             unsigned char *pdata = static_cast<unsigned char*>(data[b])
@@ -340,9 +379,11 @@ bool ZoomRenderer::Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pMas
          }
       }
       // Cambio el las dimensiones del canvas
+      input.Release();
       pCanvas->SetSize(vpwidth, vpheight);
       if ( pMask ) {
-         pMask->Read(maskbands, maskdata);
+         CanvasBandBuffers maskinput(pMask, maskbands);
+         std::vector<void*> &maskdata = maskinput.GetData();
          for (int j = 0; j < vpheight; j++) {
             unsigned char *pmaskdata = static_cast<unsigned char*>(maskdata[0])
                   + SURI_TRUNC(int, j * stepy + offsety) * csizex
@@ -353,6 +394,7 @@ bool ZoomRenderer::Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pMas
             zoomTypeMap[pMask->GetDataType()](ptemp, pmaskdata, vpwidth, stepx, offsetx);
          }
          // escribo los datos al canvas
+         maskinput.Release();
          pMask->SetSize(vpwidth, vpheight);
          pMask->Write(maskbands, zoommaskdata);
          pMask->ApplyMask(bands, zoomdata, pCanvas);
@@ -360,9 +402,7 @@ bool ZoomRenderer::Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pMas
       pCanvas->Write(bands, zoomdata, pMask);
       // libero el temporario
       for (int b = 0; b < pCanvas->GetBandCount(); b++) {
-         delete[] static_cast<unsigned char*>(data[b]);
          delete[] static_cast<unsigned char*>(zoomdata[b]);
-         delete[] static_cast<unsigned char*>(maskdata[b]);
          delete[] static_cast<unsigned char*>(zoommaskdata[b]);
       }
    }
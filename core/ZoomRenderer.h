@@ -30,16 +30,18 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes suri
 #include "suri/Renderer.h"
+#include "suri/Resampler.h"
 
 /** Forwards */
 class wxXmlNode;
 
 /** namespace suri */
 namespace suri {
-/** Renderer que realiza interpolacion NN (Nearest Neighbour) */
+/** Renderer que realiza zoom con interpolacion NN, bilineal, cubica o Lanczos */
 /**
- * Usa interpolacion NN (Nearest Neighbour) para generar pixeles intermedios
- * cuando el nroPixeles en el viewport es mayor que en canvas
+ * Interpola para generar pixeles intermedios cuando el nroPixeles en el
+ * viewport es mayor que en canvas. El tipo de interpolacion se toma de la
+ * propiedad "mas" del nodo interpolacion.
  * \note hereda de renderer para formar parte del pipeline de renderizacion
  */
 class ZoomRenderer : public Renderer {
@@ -57,7 +59,7 @@ public:
    public:
       /** enum con tipos de interpolacion */
       typedef enum {
-         NearestNeighbour, CubicCombolution, None
+         NearestNeighbour, CubicCombolution, None, Bilinear, Lanczos
       } InterpolationType;
       /** interfaz de las funciones de interpolacion */
       typedef void (*InterpolationFunctionType)(void*, void*, size_t, double, double);
@@ -65,6 +67,10 @@ public:
       /* cuando hay mas pixeles de salida que */
       /* de entrada */
       InterpolationFunctionType function_; /*! Funcion que aplica zoom. */
+      /*! Funcion que aplica zoom con interpolacion (no NN) */
+      Resampler::ResampleFunctionType resampleFunction_;
+      bool noDataValueAvailable_; /*! indica si hay valor no valido */
+      double noDataValue_; /*! valor no valido que respeta la interpolacion */
       std::string spatialModel_; /*! Referencia espacial del raster */
       std::string rasterModel_; /*! Relacion entre pixel-linea y la ref */
       /* espacial del raster */
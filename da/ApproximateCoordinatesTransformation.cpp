@@ -0,0 +1,354 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+// Includes Estandar
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+// Includes Suri
+#include "suri/ApproximateCoordinatesTransformation.h"
+
+// Includes Wx
+// Defines
+// forwards
+namespace suri {
+
+/**
+ * Construye la grilla calculando las transformaciones exactas necesarias
+ * para que la interpolacion respete la tolerancia.
+ *
+ * @param[in] pExact Transformacion exacta a aproximar.
+ * @param[in] Domain Dominio (en coordenadas de entrada) que se aproxima.
+ * @param[in] Tolerance Error maximo en unidades de salida. Si es <= 0 todas
+ * las transformaciones son exactas.
+ * @param[in] Inverse Sentido de pExact que se aproxima.
+ */
+ApproximateCoordinatesTransformation::ApproximateCoordinatesTransformation(
+      const CoordinatesTransformation* pExact, const Subset& Domain, double Tolerance,
+      bool Inverse) :
+      pExact_(pExact), domain_(Domain), tolerance_(Tolerance), inverse_(Inverse),
+      valid_(false) {
+   if (!pExact_ || pExact_->IsIdentity() || !(tolerance_ > 0)
+         || domain_.lr_.x_ == domain_.ul_.x_ || domain_.lr_.y_ == domain_.ul_.y_)
+      return;
+
+   // Vertices de la grilla inicial
+   int gridsize = APPROXIMATE_TRANSFORMATION_GRID_SIZE;
+   double cellsize = 1.0 / gridsize;
+   std::vector<Coordinates> lattice((gridsize + 1) * (gridsize + 1));
+   std::vector<bool> transformed(lattice.size());
+   for (int row = 0; row <= gridsize; ++row)
+      for (int col = 0; col <= gridsize; ++col)
+         transformed[row * (gridsize + 1) + col] = ExactTransform(
+               col * cellsize, row * cellsize, lattice[row * (gridsize + 1) + col]);
+
+   cells_.resize(gridsize * gridsize);
+   for (int row = 0; row < gridsize; ++row) {
+      for (int col = 0; col < gridsize; ++col) {
+         Cell &cell = cells_[row * gridsize + col];
+         cell.u_ = col * cellsize;
+         cell.v_ = row * cellsize;
+         cell.size_ = cellsize;
+         cell.firstChild_ = 0;
+         cell.state_ = Interpolated;
+         int vertex[4] = { row * (gridsize + 1) + col, row * (gridsize + 1) + col + 1,
+                           (row + 1) * (gridsize + 1) + col,
+                           (row + 1) * (gridsize + 1) + col + 1 };
+         for (int k = 0; k < 4; ++k) {
+            cell.corners_[k] = lattice[vertex[k]];
+            if (!transformed[vertex[k]])
+               cell.state_ = Exact;
+         }
+      }
+   }
+   for (size_t index = 0; index < static_cast<size_t>(gridsize * gridsize); ++index)
+      if (cells_[index].state_ != Exact)
+         BuildCell(index, 0);
+   valid_ = true;
+}
+
+/**
+ * Destructor
+ */
+ApproximateCoordinatesTransformation::~ApproximateCoordinatesTransformation() {
+}
+
+/**
+ * Transforma la coordenada. Dentro del dominio y en el sentido aproximado
+ * interpola en la celda que la contiene.
+ *
+ * @param[out] CoordinatesP Coordenada transformada.
+ * @param[in] Inverse Indica si se debe hacer la transformacion inversa.
+ * @return Cantidad de coordenadas transformadas.
+ */
+int ApproximateCoordinatesTransformation::Transform(Coordinates &CoordinatesP,
+                                                     bool Inverse) const {
+   const Cell* pcell = NULL;
+   double u = 0, v = 0;
+   if (valid_ && Inverse == inverse_)
+      pcell = FindCell(CoordinatesP.x_, CoordinatesP.y_, u, v);
+   if (pcell == NULL)
+      return pExact_->Transform(CoordinatesP, Inverse);
+
+   Coordinates point = Interpolate(*pcell, u, v);
+   CoordinatesP.x_ = point.x_;
+   CoordinatesP.y_ = point.y_;
+   return 1;
+}
+
+/**
+ * Transforma un vector de coordenadas.
+ *
+ * @param[out] CoordinatesP Vector de coordenadas transformadas.
+ * @param[in] Inverse Indica si se debe hacer la transformacion inversa.
+ * @return Cantidad de coordenadas transformadas.
+ */
+int ApproximateCoordinatesTransformation::Transform(
+      std::vector<Coordinates> &CoordinatesP, bool Inverse) const {
+   int result = 0;
+   for (size_t ix = 0; ix < CoordinatesP.size(); ++ix)
+      if (Transform(CoordinatesP[ix], Inverse) != 0)
+         ++result;
+   return result;
+}
+
+/**
+ * Transforma arreglos de coordenadas. Los puntos que no se pueden
+ * interpolar se transforman juntos con una llamada a la transformacion
+ * exacta.
+ *
+ * @param[in,out] pX Coordenadas x.
+ * @param[in,out] pY Coordenadas y.
+ * @param[in] Count Cantidad de puntos.
+ * @param[in] Inverse Indica si se debe hacer la transformacion inversa.
+ * @param[out] pSuccess (opcional) Indica por punto si se transformo.
+ * @return Cantidad de coordenadas transformadas.
+ */
+int ApproximateCoordinatesTransformation::Transform(double* pX, double* pY, int Count,
+                                                     bool Inverse,
+                                                     int* pSuccess) const {
+   if (!valid_ || Inverse != inverse_)
+      return pExact_->Transform(pX, pY, Count, Inverse, pSuccess);
+
+   int result = 0;
+   std::vector<int> exactpoints;
+   for (int ix = 0; ix < Count; ++ix) {
+      double u = 0, v = 0;
+      const Cell* pcell = FindCell(pX[ix], pY[ix], u, v);
+      if (pcell == NULL) {
+         exactpoints.push_back(ix);
+         continue;
+      }
+      Coordinates point = Interpolate(*pcell, u, v);
+      pX[ix] = point.x_;
+      pY[ix] = point.y_;
+      if (pSuccess)
+         pSuccess[ix] = 1;
+      ++result;
+   }
+   if (exactpoints.empty())
+      return result;
+
+   size_t exactcount = exactpoints.size();
+   std::vector<double> x(exactcount), y(exactcount);
+   std::vector<int> success(exactcount);
+   for (size_t ix = 0; ix < exactcount; ++ix) {
+      x[ix] = pX[exactpoints[ix]];
+      y[ix] = pY[exactpoints[ix]];
+   }
+   result += pExact_->Transform(&x[0], &y[0], exactcount, Inverse, &success[0]);
+   for (size_t ix = 0; ix < exactcount; ++ix) {
+      pX[exactpoints[ix]] = x[ix];
+      pY[exactpoints[ix]] = y[ix];
+      if (pSuccess)
+         pSuccess[exactpoints[ix]] = success[ix];
+   }
+   return result;
+}
+
+/**
+ * Transforma un subset con la transformacion exacta.
+ *
+ * @param[out] SubsetP Subset transformado.
+ * @param[in] CalculationPoints Limite de coordenadas a calcular para el subset.
+ * @param[in] Inverse Indica si se debe hacer la transformacion inversa.
+ * @return Cantidad de coordenadas transformadas.
+ */
+int ApproximateCoordinatesTransformation::Transform(Subset &SubsetP,
+                                                     int CalculationPoints,
+                                                     bool Inverse) const {
+   return pExact_->Transform(SubsetP, CalculationPoints, Inverse);
+}
+
+/**
+ * Indica si es la transformacon identidad.
+ */
+bool ApproximateCoordinatesTransformation::IsIdentity() const {
+   return pExact_->IsIdentity();
+}
+
+/**
+ * Compara si dos transformaciones son iguales.
+ */
+bool ApproximateCoordinatesTransformation::Equals(
+      CoordinatesTransformation* pTransform) const {
+   return pExact_->Equals(pTransform);
+}
+
+/**
+ * Busca la celda interpolable que contiene al punto.
+ *
+ * @param[in] X Coordenada x del punto.
+ * @param[in] Y Coordenada y del punto.
+ * @param[out] U Columna normalizada del punto dentro del dominio.
+ * @param[out] V Fila normalizada del punto dentro del dominio.
+ * @return Celda que contiene al punto o NULL si el punto esta fuera del
+ * dominio o en una celda que se transforma en forma exacta.
+ */
+const ApproximateCoordinatesTransformation::Cell*
+ApproximateCoordinatesTransformation::FindCell(double X, double Y, double &U,
+                                               double &V) const {
+   U = (X - domain_.ul_.x_) / (domain_.lr_.x_ - domain_.ul_.x_);
+   V = (Y - domain_.ul_.y_) / (domain_.lr_.y_ - domain_.ul_.y_);
+   if (!(U >= 0 && U <= 1 && V >= 0 && V <= 1))
+      return NULL;
+
+   int gridsize = APPROXIMATE_TRANSFORMATION_GRID_SIZE;
+   int col = std::min(static_cast<int>(U * gridsize), gridsize - 1);
+   int row = std::min(static_cast<int>(V * gridsize), gridsize - 1);
+   size_t index = row * gridsize + col;
+   while (cells_[index].state_ == Subdivided) {
+      const Cell &cell = cells_[index];
+      double half = cell.size_ / 2;
+      index = cell.firstChild_ + (V >= cell.v_ + half ? 2 : 0)
+            + (U >= cell.u_ + half ? 1 : 0);
+   }
+   return cells_[index].state_ == Exact ? NULL : &cells_[index];
+}
+
+/**
+ * Transforma en forma exacta el punto de coordenadas normalizadas (U, V).
+ *
+ * @param[in] U Columna normalizada dentro del dominio.
+ * @param[in] V Fila normalizada dentro del dominio.
+ * @param[out] Point Punto transformado.
+ * @return true si la transformacion tuvo exito.
+ */
+bool ApproximateCoordinatesTransformation::ExactTransform(double U, double V,
+                                                          Coordinates &Point) const {
+   Point = Coordinates(domain_.ul_.x_ + U * (domain_.lr_.x_ - domain_.ul_.x_),
+                       domain_.ul_.y_ + V * (domain_.lr_.y_ - domain_.ul_.y_));
+   return pExact_->Transform(Point, inverse_) != 0;
+}
+
+/**
+ * Interpola bilinealmente entre los vertices de la celda.
+ *
+ * @param[in] CellP Celda que contiene el punto.
+ * @param[in] U Columna normalizada dentro del dominio.
+ * @param[in] V Fila normalizada dentro del dominio.
+ * @return Punto interpolado.
+ */
+Coordinates ApproximateCoordinatesTransformation::Interpolate(const Cell &CellP,
+                                                              double U, double V) {
+   double fu = (U - CellP.u_) / CellP.size_;
+   double fv = (V - CellP.v_) / CellP.size_;
+   const Coordinates* pc = CellP.corners_;
+   double top = (1 - fu) * pc[0].x_ + fu * pc[1].x_;
+   double bottom = (1 - fu) * pc[2].x_ + fu * pc[3].x_;
+   double x = (1 - fv) * top + fv * bottom;
+   top = (1 - fu) * pc[0].y_ + fu * pc[1].y_;
+   bottom = (1 - fu) * pc[2].y_ + fu * pc[3].y_;
+   return Coordinates(x, (1 - fv) * top + fv * bottom);
+}
+
+/**
+ * Compara la interpolacion con la transformacion exacta en el centro y en
+ * los puntos medios de los lados de la celda. Si el error supera la
+ * tolerancia subdivide la celda en cuatro, reutilizando esos puntos como
+ * vertices de las subceldas.
+ *
+ * @param[in] Index Indice de la celda, con los vertices ya calculados.
+ * @param[in] Depth Cantidad de subdivisiones hasta la celda.
+ */
+void ApproximateCoordinatesTransformation::BuildCell(size_t Index, int Depth) {
+   // Copia porque cells_ crece al subdividir
+   Cell cell = cells_[Index];
+   double half = cell.size_ / 2;
+   // Puntos medios: superior, izquierdo, centro, derecho, inferior
+   double us[5] = { cell.u_ + half, cell.u_, cell.u_ + half, cell.u_ + cell.size_,
+                    cell.u_ + half };
+   double vs[5] = { cell.v_, cell.v_ + half, cell.v_ + half, cell.v_ + half,
+                    cell.v_ + cell.size_ };
+   Coordinates points[5];
+   bool success = true;
+   double error = 0;
+   for (int k = 0; k < 5 && success; ++k) {
+      success = ExactTransform(us[k], vs[k], points[k]);
+      Coordinates interpolated = Interpolate(cell, us[k], vs[k]);
+      error = std::max(error, std::max(std::fabs(points[k].x_ - interpolated.x_),
+                                       std::fabs(points[k].y_ - interpolated.y_)));
+   }
+
+   if (success && error <= tolerance_) {
+      cells_[Index].state_ = Interpolated;
+      return;
+   }
+   if (!success || Depth >= APPROXIMATE_TRANSFORMATION_MAX_DEPTH) {
+      cells_[Index].state_ = Exact;
+      return;
+   }
+
+   // Subdivide en 4 celdas: (fila, columna) -> indice fila * 2 + columna
+   const Coordinates* pc = cell.corners_;
+   Coordinates lattice[3][3] = { { pc[0], points[0], pc[1] },
+                                 { points[1], points[2], points[3] },
+                                 { pc[2], points[4], pc[3] } };
+   size_t firstchild = cells_.size();
+   cells_[Index].state_ = Subdivided;
+   cells_[Index].firstChild_ = firstchild;
+   for (int row = 0; row < 2; ++row) {
+      for (int col = 0; col < 2; ++col) {
+         Cell child;
+         child.u_ = cell.u_ + col * half;
+         child.v_ = cell.v_ + row * half;
+         child.size_ = half;
+         child.corners_[0] = lattice[row][col];
+         child.corners_[1] = lattice[row][col + 1];
+         child.corners_[2] = lattice[row + 1][col];
+         child.corners_[3] = lattice[row + 1][col + 1];
+         child.state_ = Interpolated;
+         child.firstChild_ = 0;
+         cells_.push_back(child);
+      }
+   }
+   for (size_t k = 0; k < 4; ++k)
+      BuildCell(firstchild + k, Depth + 1);
+}
+
+}  // namespace suri
@@ -52,30 +52,27 @@ std::string BilRasterDriver::MuxIdentifier = "BIL";
 BilRasterDriver::BilRasterDriver(const std::string& Mux,
                                  const std::string& FileName,
                                  int Pixels, int Lines) :
-      RawRasterDriver(Mux, "BilRasterDriver", FileName, Pixels, Lines), pData_(NULL) {
+      RawRasterDriver(Mux, "BilRasterDriver", FileName, Pixels, Lines) {
    driverName_ = "BilRasterDriver";
 }
 
 /** dtor **/
 BilRasterDriver::~BilRasterDriver() {
-   if (pData_)
-      delete[] pData_;
 }
 
-/** Tamanio del bloque X e Y. Inicialmente se utilizara como tamanio del bloque
- *  toda la imagen */
+/** Tamanio del bloque X e Y. Se utilizan franjas del ancho de la imagen
+ *  (ver RawRasterDriver::GetStripHeight) */
 bool BilRasterDriver::DoGetBlockSize(int &SizeX, int &SizeY) const {
    if (ToUpper(mux_).compare(MuxIdentifier) != 0)
       return false;
    SizeX = npixels_;
-   SizeY = nlines_;
+   SizeY = GetStripHeight();
    return true;
 }
 
 /** Carga el buffer con la informacion de la banda configurada teniendo
- *  el cuenta el subset solicitado.
- *  En la primera iteracion se cargara toda la imagen en memoria y no se tendra
- *  en cuenta el offset configurado en el driver.
+ *  el cuenta el subset solicitado. Solo se accede a las lineas de la ventana
+ *  a traves de la vista mapeada del archivo.
  *  Precondicion: Ya se almaceno la memoria para pbuffer
  *  El interlineado BIL ordena la bandas por columna.
  *  Explicacion mas detallada
@@ -86,62 +83,36 @@ bool BilRasterDriver::DoRead(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry)
    if (ToUpper(mux_).compare(MuxIdentifier) != 0 || bandReaderIndex_ < 0 ||
          npixels_ <= 0 || nlines_ <= 0)
       return false;
-   /**
-    * En caso de no haber realizado ninguna lectura sobre el archivo
-    * cargo la informacion en memoria
-    * **/
-   int pixelsize = SizeOf(dataType_);
-   if (pData_ == NULL) {
-      pData_ = new char[npixels_ * nlines_];
-      std::ifstream file(filename_.c_str(), std::ios::in | std::ios::binary);
-      if (file.is_open()) {
-         int hoffset = offset_.fileOffset_.headerOffset_;
-         hoffset += file.tellg();
-         file.seekg(hoffset, std::ios_base::beg);
-         char* preadpos = static_cast<char*>(pData_);
-			int rstep = 0;
-         for (int row = 0; row < nlines_; ++row) {
-            /** Me posiciono en la primera columna de la linea actual de la banda **/
-            int step = file.tellg();
-            step += offset_.bandOffset_.headerOffset_;
-            step += (bandReaderIndex_ * pixelsize * npixels_) + rstep;
-            file.seekg(step, std::ios_base::beg);
-            for (int col = 0; col < npixels_; ++col) {
-               // TODO: Tener en cuenta los unsigned
-               char* pbandpixel = new char[pixelsize];
-               // leo de a pixel
-               file.read((char*) pbandpixel, pixelsize);
-               memcpy(preadpos, pbandpixel, pixelsize);
-               /** muevo el puntero al sig. pixel **/
-               preadpos += pixelsize;
-               delete[] pbandpixel;
-            }
-             /** Una vez recorrida las columnas de la fila que corresponden a la
-             *  banda realizo un salto de linea. Esto quiere decir que tengo
-             *  que saltar las columnas de las bandas que restan de la linea
-             **/
-           	rstep = 0;
-            rstep += offset_.bandOffset_.tailOffset_;
-            rstep += (RasterDriver::bandCount_ - bandReaderIndex_ - 1) * npixels_
-                  * pixelsize;
-         }
-         file.close();
-      } else
-         return false;
-   }
+   return ReadWindow(pBuffer, Ulx, Uly, Lrx, Lry, bandReaderIndex_);
+}
 
+/** Carga los buffers con el subset de varias bandas. En BIL las lineas de
+ *  todas las bandas son contiguas por lo que se recorre el archivo una vez **/
+bool BilRasterDriver::DoReadBands(const std::vector<int> &BandIndex,
+                                  std::vector<void*> &Data, int Ulx, int Uly, int Lrx,
+                                  int Lry) {
+   if (ToUpper(mux_).compare(MuxIdentifier) != 0 || npixels_ <= 0 || nlines_ <= 0)
+      return false;
+   return ReadWindows(BandIndex, Data, Ulx, Uly, Lrx, Lry);
+}
 
-   int udim = Lrx >= Ulx ? Lrx - Ulx : Ulx - Lrx;
-   int ldim = Lry >= Uly ? Lry - Uly : Uly - Lry;
-   /** Adelante el puntero de lectura en funcion de las coordenadas del subset **/
-   char* preadpos = pData_;
-   /** Salteo la cantidad de pixeles para ulx **/
-   preadpos += Ulx * pixelsize;
-   /** Salteo la cantidad de lineas para uly **/
-   preadpos += (Uly * npixels_ * pixelsize);
-   char* pwritepos = static_cast<char*>(pBuffer);
-   memcpy(pwritepos, preadpos, udim * ldim * pixelsize);
-   return true;
+/** Offset en bytes del primer pixel de la linea para la banda indicada.
+ *  En BIL cada linea del archivo contiene una fila de cada banda:
+ *  [encabezado linea]([encabezado banda][pixeles][cola banda])*[cola linea] **/
+unsigned long long BilRasterDriver::GetLineOffset(int Line, int Band) const {
+   unsigned long long bandsize = offset_.bandOffset_.headerOffset_
+         + static_cast<unsigned long long>(npixels_) * SizeOf(dataType_)
+         + offset_.bandOffset_.tailOffset_;
+   unsigned long long linesize = offset_.lineOffset_.headerOffset_
+         + bandsize * RasterDriver::bandCount_ + offset_.lineOffset_.tailOffset_;
+   return offset_.fileOffset_.headerOffset_ + linesize * Line
+         + offset_.lineOffset_.headerOffset_ + bandsize * Band
+         + offset_.bandOffset_.headerOffset_;
+}
+
+/** En BIL los pixeles de una fila de la banda son contiguos **/
+size_t BilRasterDriver::GetPixelStride() const {
+   return SizeOf(dataType_);
 }
 
 /** Escribe mas de una banda.
@@ -176,15 +147,11 @@ bool BilRasterDriver::DoWrite(const std::vector<int> &BandIndex, std::vector<voi
    return true;
 }
 
-/** Retorna un buffer interno con los datos **/
+/** Retorna un buffer con los datos del bloque (franja) indicado **/
 void* BilRasterDriver::DoGetBlock(int BlockX, int BlockY) {
-   if (ToUpper(mux_).compare(MuxIdentifier) != 0 || BlockX == 0 || BlockY == 0
-         || BlockX > RasterDriver::sizeX_ || BlockY > RasterDriver::sizeY_ || !pData_)
+   if (ToUpper(mux_).compare(MuxIdentifier) != 0 || bandReaderIndex_ < 0)
       return NULL;
-   int pixelsize = SizeOf(dataType_);
-   char* pblock = new char[pixelsize * BlockX * BlockY];
-   memcpy(pblock, pData_, BlockX * BlockY * pixelsize);
-   return pblock;
+   return ReadBlock(BlockX, BlockY);
 }
 
 }  /** namespace driver **/
@@ -26,8 +26,7 @@ For more information about SpaceSUR, visit <https://www.spacesur.com>.
 For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes Estandar
-#include <string.h>
-#include <fstream>
+#include <string>
 
 // Includes Suri
 #include "BipRasterDriver.h"
@@ -50,73 +49,61 @@ std::string BipRasterDriver::MuxIdentifier = "BIP";
 BipRasterDriver::BipRasterDriver(const std::string& Mux,
                                  const std::string& FileName,
                                  int Pixels, int Lines) :
-      RawRasterDriver(Mux, "BipRasterDriver", FileName, Pixels, Lines), pData_(NULL) {
+      RawRasterDriver(Mux, "BipRasterDriver", FileName, Pixels, Lines) {
    driverName_ = "BipRasterDriver";
 }
 
 /** dtor **/
 BipRasterDriver::~BipRasterDriver() {
-   if (pData_)
-      delete[] pData_;
 }
-/** Tamanio del bloque X e Y. Inicialmente se utilizara como tamanio del bloque
- *  toda la imagen*/
+
+/** Tamanio del bloque X e Y. Se utilizan franjas del ancho de la imagen
+ *  (ver RawRasterDriver::GetStripHeight) */
 bool BipRasterDriver::DoGetBlockSize(int &SizeX, int &SizeY) const {
    if (ToUpper(mux_).compare(MuxIdentifier) != 0)
       return false;
    SizeX = npixels_;
-   SizeY = nlines_;
+   SizeY = GetStripHeight();
    return true;
 }
 
-/** Carga el buffer con el subset **/
+/** Carga el buffer con el subset. Los pixeles de la banda se copian
+ *  salteando las muestras de las demas bandas directamente desde la vista
+ *  mapeada del archivo **/
 bool BipRasterDriver::DoRead(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry) {
-   // Debe configurarse correctamente el interlineado y la banda sobre la cual leer
-   if (ToUpper(mux_).compare(MuxIdentifier) != 0 || bandReaderIndex_ < 0)
+   // verifico si la configuracion permite la lectura del archivo
+   if (ToUpper(mux_).compare(MuxIdentifier) != 0 || bandReaderIndex_ < 0 ||
+         npixels_ <= 0 || nlines_ <= 0)
       return false;
-   int pixelsize = SizeOf(dataType_);
-   if (pData_ == NULL) {
-      pData_ = new char[npixels_ * nlines_];
-      std::ifstream file(filename_.c_str(), std::ios::in | std::ios::binary);
-      if (file.is_open()) {
-         // le sumo el offset del archivo                                                           
-			int step = file.tellg();
-         step += offset_.fileOffset_.headerOffset_;                                                   
-         file.seekg(step, std::ios_base::beg);                                                      
-			char* pbuffpos = static_cast<char*>(pData_);
-         for (int p = 0; p < npixels_*nlines_; ++p) {
-				int bread = pixelsize*RasterDriver::bandCount_;
-				if (p % npixels_ == 0) {
-					// comienzo de linea
-					bread += offset_.lineOffset_.headerOffset_;	
-				} else if (p + 1 % npixels_ == 0) {
-					// fin de linea
-					bread += offset_.lineOffset_.tailOffset_;
-				} 
-            char* pbandpixel = new char[bread];
-            // leo de a pixel
-            file.read((char*)pbandpixel, bread);
-				char* ppixel = pbandpixel+bandReaderIndex_;
-            ppixel += (p % npixels_ == 0) ? offset_.lineOffset_.headerOffset_ : 0;
-				memcpy(pbuffpos, ppixel, pixelsize);
-            pbuffpos += pixelsize;
-				delete[] pbandpixel;
-       }
-         file.close();
-      } else
-         return false;
-   }
-   int udim = Lrx >= Ulx ? Lrx - Ulx : Ulx - Lrx;
-   int ldim = Lry >= Uly ? Lry - Uly : Uly - Lry;
-   /** Adelante el puntero de lectura en funcion de las coordenadas del subset **/
-   char* preadpos = pData_;
-   /** Salteo la cantidad de pixeles para ulx **/
-   preadpos += Ulx * pixelsize;
-   /** Salteo la cantidad de lineas para uly **/
-   preadpos += (Uly * npixels_ * pixelsize);
-   char* pwritepos = static_cast<char*>(pBuffer);
-   memcpy(pwritepos, preadpos, udim * ldim * pixelsize);
-   return true;
+   return ReadWindow(pBuffer, Ulx, Uly, Lrx, Lry, bandReaderIndex_);
+}
+
+/** Carga los buffers con el subset de varias bandas. Cada pixel contiene las
+ *  muestras de todas las bandas por lo que se recorre el archivo una vez y se
+ *  separan las bandas en los buffers de destino **/
+bool BipRasterDriver::DoReadBands(const std::vector<int> &BandIndex,
+                                  std::vector<void*> &Data, int Ulx, int Uly, int Lrx,
+                                  int Lry) {
+   if (ToUpper(mux_).compare(MuxIdentifier) != 0 || npixels_ <= 0 || nlines_ <= 0)
+      return false;
+   return ReadWindows(BandIndex, Data, Ulx, Uly, Lrx, Lry);
+}
+
+/** Offset en bytes del primer pixel de la linea para la banda indicada.
+ *  En BIP cada linea es [encabezado linea][pixeles][cola linea] donde cada
+ *  pixel contiene la muestra de todas las bandas **/
+unsigned long long BipRasterDriver::GetLineOffset(int Line, int Band) const {
+   unsigned long long linesize = offset_.lineOffset_.headerOffset_
+         + static_cast<unsigned long long>(npixels_) * GetPixelStride()
+         + offset_.lineOffset_.tailOffset_;
+   return offset_.fileOffset_.headerOffset_ + linesize * Line
+         + offset_.lineOffset_.headerOffset_
+         + static_cast<unsigned long long>(Band) * SizeOf(dataType_);
+}
+
+/** En BIP entre dos pixeles de una banda se encuentran las muestras del resto **/
+size_t BipRasterDriver::GetPixelStride() const {
+   return static_cast<size_t>(SizeOf(dataType_)) * RasterDriver::bandCount_;
 }
 
 /** Escribe mas de una banda **/
@@ -128,16 +115,13 @@ bool BipRasterDriver::DoWrite(const std::vector<int> &BandIndex, std::vector<voi
    return true;
 }
 
-/** Retorna un buffer interno con los datos **/
+/** Retorna un buffer con los datos del bloque (franja) indicado **/
 void* BipRasterDriver::DoGetBlock(int BlockX, int BlockY) {
-   if (ToUpper(mux_).compare(MuxIdentifier) != 0 || BlockX == 0 || BlockY == 0
-         || BlockX > RasterDriver::sizeX_ || BlockY > RasterDriver::sizeY_ || !pData_)
+   if (ToUpper(mux_).compare(MuxIdentifier) != 0 || bandReaderIndex_ < 0)
       return NULL;
-   int pixelsize = SizeOf(dataType_);
-   char* pblock = new char[pixelsize * BlockX * BlockY];
-   memcpy(pblock, pData_, BlockX * BlockY * pixelsize);
-   return pblock;
+   return ReadBlock(BlockX, BlockY);
 }
+
 }  /** namespace driver **/
 }  /** namespace dataaccess **/
 }  /** namespace raster **/
@@ -59,17 +59,22 @@ public:
    static std::string MuxIdentifier;
 
 private:
-   /** array que tiene el contenido de la banda en memoria **/
-   char* pData_;
    /** Tamanio del bloque X e Y */
    virtual bool DoGetBlockSize(int &SizeX, int &SizeY) const;
    /** Carga el buffer con el subset **/
    virtual bool DoRead(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry);
+   /** Carga los buffers con el subset de varias bandas **/
+   virtual bool DoReadBands(const std::vector<int> &BandIndex, std::vector<void*> &Data,
+                            int Ulx, int Uly, int Lrx, int Lry);
    /** Escribe mas de una banda **/
    virtual bool DoWrite(const std::vector<int> &BandIndex, std::vector<void*> &Data,
                         int Ulx, int Uly, int Lrx, int Lry);
    /** Retorna un buffer interno con los datos **/
    virtual void* DoGetBlock(int BlockX, int BlockY);
+   /** Offset en bytes del primer pixel de la linea para la banda indicada **/
+   virtual unsigned long long GetLineOffset(int Line, int Band) const;
+   /** Distancia en bytes entre dos pixeles consecutivos de una misma banda **/
+   virtual size_t GetPixelStride() const;
 };
 
 }  /** namespace driver **/
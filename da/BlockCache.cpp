@@ -0,0 +1,359 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+// Includes standard
+#include <climits>
+
+// Includes suri
+#include "suri/BlockCache.h"
+#include "suri/Configuration.h"
+
+// Includes wx
+#include "wx/thread.h"
+
+/** Presupuesto por defecto del cache de bloques (MB) */
+#define DEFAULT_BLOCK_CACHE_SIZE_MB 256
+
+/** namespace suri */
+namespace suri {
+
+/** Ctor */
+BlockCache::BlockCache() :
+      budget_(0), used_(0), residentBytes_(0), hits_(0), misses_(0), evictions_(0),
+      writeBacks_(0), pMutex_(new wxMutex), pWriteDone_(new wxCondition(*pMutex_)) {
+   long budgetmb = Configuration::GetParameter("lib_raster_block_cache_size",
+                                               static_cast<long>(DEFAULT_BLOCK_CACHE_SIZE_MB));
+   budget_ = static_cast<size_t>(budgetmb > 0 ? budgetmb : DEFAULT_BLOCK_CACHE_SIZE_MB)
+         * 1024 * 1024;
+}
+
+/** Dtor */
+BlockCache::~BlockCache() {
+   delete pWriteDone_;
+   delete pMutex_;
+}
+
+/**
+ * Retorna la instancia del cache. Se crea la primera vez que se utiliza para
+ * que el presupuesto se lea de la configuracion ya cargada.
+ * @return instancia unica del cache
+ */
+BlockCache& BlockCache::Instance() {
+   static BlockCache *pblockcache = new BlockCache();
+   return *pblockcache;
+}
+
+/**
+ * Busca un bloque. Si lo encuentra lo mueve al frente de la lista LRU y lo
+ * marca en uso (debe llamarse a Release cuando se deja de usar).
+ * @param[in] pClient duenio del bloque
+ * @param[in] BlockX columna del bloque
+ * @param[in] BlockY fila del bloque
+ * @return datos del bloque o NULL si no esta en el cache
+ */
+void* BlockCache::Acquire(Client *pClient, int BlockX, int BlockY) {
+   wxMutexLocker lock(*pMutex_);
+   BlockMapType::iterator it = blocks_.find(BlockKey(pClient, BlockX, BlockY));
+   if (it == blocks_.end()) {
+      ++misses_;
+      return NULL;
+   }
+   ++hits_;
+   if (!it->second->isResident_)
+      lru_.splice(lru_.begin(), lru_, it->second);
+   it->second->pins_++;
+   return it->second->pData_;
+}
+
+/**
+ *  No modifica el orden de uso ni los contadores de aciertos.
+ * @param[in] pClient duenio del bloque
+ * @param[in] BlockX columna del bloque
+ * @param[in] BlockY fila del bloque
+ * @return true si el bloque esta en el cache
+ */
+bool BlockCache::Contains(Client *pClient, int BlockX, int BlockY) const {
+   wxMutexLocker lock(*pMutex_);
+   return blocks_.find(BlockKey(pClient, BlockX, BlockY)) != blocks_.end();
+}
+
+/**
+ * Agrega un bloque marcandolo en uso y elimina los bloques menos usados si
+ * se supera el presupuesto. El cache pasa a ser responsable de liberar los
+ * datos (a traves de Client::FreeBlock).
+ *  Si el bloque ya existe (otro hilo lo agrego mientras se leia) se conserva
+ * el existente, ya que puede estar en uso, y se liberan los datos recibidos.
+ * @param[in] pClient duenio del bloque
+ * @param[in] BlockX columna del bloque
+ * @param[in] BlockY fila del bloque
+ * @param[in] pData datos del bloque
+ * @param[in] Size tamanio en bytes de los datos
+ * @return datos del bloque en el cache (marcado en uso)
+ */
+void* BlockCache::Insert(Client *pClient, int BlockX, int BlockY, void *pData,
+                         size_t Size) {
+   wxMutexLocker lock(*pMutex_);
+   BlockKey key(pClient, BlockX, BlockY);
+   BlockMapType::iterator it = blocks_.find(key);
+   if (it != blocks_.end()) {
+      pClient->FreeBlock(pData);
+      if (!it->second->isResident_)
+         lru_.splice(lru_.begin(), lru_, it->second);
+      it->second->pins_++;
+      return it->second->pData_;
+   }
+   lru_.push_front(BlockEntry(key, pData, Size));
+   blocks_.insert(std::make_pair(key, lru_.begin()));
+   used_ += Size;
+   Evict();
+   return pData;
+}
+
+/**
+ * @param[in] pClient duenio del bloque
+ * @param[in] BlockX columna del bloque
+ * @param[in] BlockY fila del bloque
+ */
+void BlockCache::Release(Client *pClient, int BlockX, int BlockY) {
+   wxMutexLocker lock(*pMutex_);
+   BlockMapType::iterator it = blocks_.find(BlockKey(pClient, BlockX, BlockY));
+   if (it != blocks_.end() && it->second->pins_ > 0)
+      it->second->pins_--;
+}
+
+/**
+ *  Si el duenio no puede escribir el bloque (ej. bandas en memoria) el bloque
+ * pasa a la lista de residentes, fuera del presupuesto, ya que no se puede
+ * eliminar sin perder los datos.
+ * @param[in] pClient duenio del bloque
+ * @param[in] BlockX columna del bloque
+ * @param[in] BlockY fila del bloque
+ */
+void BlockCache::SetDirty(Client *pClient, int BlockX, int BlockY) {
+   wxMutexLocker lock(*pMutex_);
+   BlockMapType::iterator it = blocks_.find(BlockKey(pClient, BlockX, BlockY));
+   if (it == blocks_.end())
+      return;
+   LruListType::iterator entry = it->second;
+   entry->isDirty_ = true;
+   entry->dirtyVersion_++;
+   if (!entry->isResident_ && !pClient->CanWriteBack()) {
+      resident_.splice(resident_.end(), lru_, entry);
+      entry->isResident_ = true;
+      used_ -= entry->size_;
+      residentBytes_ += entry->size_;
+   }
+}
+
+/**
+ * Escribe los bloques modificados del cliente. Los bloques permanecen en el
+ * cache.
+ * @param[in] pClient duenio de los bloques
+ */
+void BlockCache::Flush(Client *pClient) {
+   wxMutexLocker lock(*pMutex_);
+   std::vector<LruListType::iterator> dirty;
+   BlockMapType::iterator it = blocks_.lower_bound(BlockKey(pClient, INT_MIN, INT_MIN));
+   for (; it != blocks_.end() && it->first.pClient_ == pClient; ++it)
+      if (it->second->isDirty_ && !it->second->isResident_ && !it->second->isWriting_)
+         dirty.push_back(it->second);
+   if (!dirty.empty())
+      WriteBlocks(dirty);
+}
+
+/**
+ * Elimina todos los bloques del cliente (incluso los modificados) sin
+ * escribirlos. Se utiliza cuando los datos dejan de ser validos o se
+ * destruye el cliente. Si otro hilo esta escribiendo bloques del cliente
+ * espera a que termine.
+ * @param[in] pClient duenio de los bloques
+ */
+void BlockCache::Discard(Client *pClient) {
+   wxMutexLocker lock(*pMutex_);
+   bool writing = true;
+   while (writing) {
+      writing = false;
+      BlockMapType::iterator it = blocks_.lower_bound(BlockKey(pClient, INT_MIN, INT_MIN));
+      for (; !writing && it != blocks_.end() && it->first.pClient_ == pClient; ++it)
+         writing = it->second->isWriting_;
+      if (writing)
+         pWriteDone_->Wait();
+   }
+   BlockMapType::iterator it = blocks_.lower_bound(BlockKey(pClient, INT_MIN, INT_MIN));
+   while (it != blocks_.end() && it->first.pClient_ == pClient)
+      Erase(it++);
+}
+
+/**
+ * @param[in] Bytes nuevo presupuesto en bytes
+ */
+void BlockCache::SetBudget(size_t Bytes) {
+   wxMutexLocker lock(*pMutex_);
+   budget_ = Bytes;
+   Evict();
+}
+
+/** Retorna el presupuesto de memoria en bytes */
+size_t BlockCache::GetBudget() const {
+   wxMutexLocker lock(*pMutex_);
+   return budget_;
+}
+
+/** Retorna la memoria ocupada por los bloques (incluso residentes) en bytes */
+size_t BlockCache::GetUsedBytes() const {
+   wxMutexLocker lock(*pMutex_);
+   return used_ + residentBytes_;
+}
+
+/** Retorna la memoria ocupada por los bloques residentes en bytes */
+size_t BlockCache::GetResidentBytes() const {
+   wxMutexLocker lock(*pMutex_);
+   return residentBytes_;
+}
+
+/** Cantidad de bloques encontrados en el cache */
+unsigned long BlockCache::GetHitCount() const {
+   wxMutexLocker lock(*pMutex_);
+   return hits_;
+}
+
+/** Cantidad de bloques no encontrados en el cache */
+unsigned long BlockCache::GetMissCount() const {
+   wxMutexLocker lock(*pMutex_);
+   return misses_;
+}
+
+/** Cantidad de bloques eliminados por falta de espacio */
+unsigned long BlockCache::GetEvictionCount() const {
+   wxMutexLocker lock(*pMutex_);
+   return evictions_;
+}
+
+/** Cantidad de bloques modificados escritos al eliminarlos */
+unsigned long BlockCache::GetWriteBackCount() const {
+   wxMutexLocker lock(*pMutex_);
+   return writeBacks_;
+}
+
+/** Reinicia los contadores */
+void BlockCache::ResetCounters() {
+   wxMutexLocker lock(*pMutex_);
+   hits_ = 0;
+   misses_ = 0;
+   evictions_ = 0;
+   writeBacks_ = 0;
+}
+
+/**
+ * Recorre la lista desde el bloque usado hace mas tiempo eliminando bloques
+ * hasta respetar el presupuesto. Los bloques en uso se saltean; los
+ * modificados se escriben (sin el lock) y se eliminan en la siguiente
+ * pasada. Si no se pudo escribir ninguno se conservan.
+ * \pre el mutex debe estar tomado
+ */
+void BlockCache::Evict() {
+   while (used_ > budget_) {
+      std::vector<LruListType::iterator> dirty;
+      size_t pending = 0;
+      LruListType::iterator it = lru_.end();
+      while (used_ - pending > budget_ && it != lru_.begin()) {
+         --it;
+         if (it->pins_ > 0)
+            continue;
+         if (it->isDirty_) {
+            dirty.push_back(it);
+            pending += it->size_;
+            continue;
+         }
+         BlockMapType::iterator block = blocks_.find(it->key_);
+         it++;
+         Erase(block);
+         ++evictions_;
+      }
+      if (dirty.empty() || WriteBlocks(dirty) == 0)
+         return;
+   }
+}
+
+/**
+ *  Marca los bloques en uso y en escritura, libera el lock mientras los
+ * escribe a traves de sus duenios y lo vuelve a tomar. Un bloque queda limpio
+ * solo si no se modifico mientras se escribia.
+ * @param[in] Entries bloques modificados a escribir
+ * @return cantidad de bloques que quedaron limpios
+ * \pre el mutex debe estar tomado
+ */
+size_t BlockCache::WriteBlocks(std::vector<LruListType::iterator> &Entries) {
+   std::vector<unsigned long> versions(Entries.size());
+   for (size_t i = 0; i < Entries.size(); ++i) {
+      Entries[i]->pins_++;
+      Entries[i]->isWriting_ = true;
+      versions[i] = Entries[i]->dirtyVersion_;
+   }
+   pMutex_->Unlock();
+   // La clave y los datos de un bloque en uso no cambian
+   std::vector<bool> written(Entries.size());
+   for (size_t i = 0; i < Entries.size(); ++i)
+      written[i] = Entries[i]->key_.pClient_->WriteBack(Entries[i]->key_.blockX_,
+                                                        Entries[i]->key_.blockY_,
+                                                        Entries[i]->pData_);
+   pMutex_->Lock();
+   size_t cleaned = 0;
+   for (size_t i = 0; i < Entries.size(); ++i) {
+      Entries[i]->pins_--;
+      Entries[i]->isWriting_ = false;
+      if (!written[i])
+         continue;
+      ++writeBacks_;
+      if (Entries[i]->dirtyVersion_ == versions[i]) {
+         Entries[i]->isDirty_ = false;
+         ++cleaned;
+      }
+   }
+   pWriteDone_->Broadcast();
+   return cleaned;
+}
+
+/**
+ * @param[in] It entrada a eliminar
+ * \pre el mutex debe estar tomado y el bloque no debe estar en escritura
+ */
+void BlockCache::Erase(BlockMapType::iterator It) {
+   LruListType::iterator entry = It->second;
+   if (entry->isResident_) {
+      residentBytes_ -= entry->size_;
+      entry->key_.pClient_->FreeBlock(entry->pData_);
+      resident_.erase(entry);
+   } else {
+      used_ -= entry->size_;
+      entry->key_.pClient_->FreeBlock(entry->pData_);
+      lru_.erase(entry);
+   }
+   blocks_.erase(It);
+}
+
+}  // namespace suri
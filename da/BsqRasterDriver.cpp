@@ -26,8 +26,7 @@ For more information about SpaceSUR, visit <https://www.spacesur.com>.
 For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes Estandar
-#include <string.h>
-#include <fstream>
+#include <string>
 
 // Includes Suri
 #include "BsqRasterDriver.h"
@@ -50,81 +49,50 @@ std::string BsqRasterDriver::MuxIdentifier = "BSQ";
 BsqRasterDriver::BsqRasterDriver(const std::string& Mux,
                                  const std::string& FileName,
                                  int Pixels, int Lines) :
-      RawRasterDriver(Mux, "BsqRasterDriver", FileName, Pixels, Lines), pData_(NULL) {
+      RawRasterDriver(Mux, "BsqRasterDriver", FileName, Pixels, Lines) {
    driverName_ = "BsqRasterDriver";
 }
 
 BsqRasterDriver::~BsqRasterDriver() {
-   if (pData_)
-      delete[] pData_;
 }
 
-/** Tamanio del bloque X e Y. Inicialmente se utilizara como tamanio del bloque
- *  toda la imagen */
+/** Tamanio del bloque X e Y. Se utilizan franjas del ancho de la imagen
+ *  (ver RawRasterDriver::GetStripHeight) */
 bool BsqRasterDriver::DoGetBlockSize(int &SizeX, int &SizeY) const {
    if (ToUpper(mux_).compare(MuxIdentifier) != 0)
       return false;
    SizeX = npixels_;
-   SizeY = nlines_;
+   SizeY = GetStripHeight();
    return true;
 }
 
-/** Carga el buffer con el subset **/
+/** Carga el buffer con el subset. Solo se accede a las lineas de la ventana
+ *  solicitada a traves de la vista mapeada del archivo **/
 bool BsqRasterDriver::DoRead(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry) {
    // Debe configurarse correctamente el interlineado y la banda sobre la cual leer
    if (ToUpper(mux_).compare(MuxIdentifier) != 0 || bandReaderIndex_ < 0)
       return false;
-   int pixelsize = SizeOf(dataType_);
-   if (pData_ == NULL) {
-      pData_ = new char[npixels_ * nlines_];
-      std::ifstream file(filename_.c_str(), std::ios::in | std::ios::binary);
-      if (file.is_open()) {
-
-         int step = file.tellg();
-         // le sumo el offset del archivo
-         step += pixelsize * npixels_ * nlines_ * bandReaderIndex_ +
-               offset_.fileOffset_.headerOffset_;
-         file.seekg(step, std::ios_base::beg);
-         char* pbuffpos = static_cast<char*>(pData_);
-			int rstep = 0;
-         for (int p = 0; p < npixels_ * nlines_; ++p) {
-            // comienzo de una linea
-            if (p % npixels_ == 0) {
-               int boffset = file.tellg();
-               // le sumo el offset del archivo
-               boffset += offset_.bandOffset_.headerOffset_ + rstep;
-               file.seekg(boffset, std::ios_base::beg);
-            }
-            char* pbandpixel = new char[pixelsize];
-            // leo de a pixel
-            file.read((char*) pbandpixel, pixelsize);
-            memcpy(pbuffpos, pbandpixel, pixelsize);
-            pbuffpos += pixelsize;
-            delete[] pbandpixel;
-            // final de linea
-            rstep = 0;
-				if (p + 1 % npixels_ == 0) {
-               // le sumo el offset del archivo
-               rstep = offset_.bandOffset_.tailOffset_;
-            }
-         }
-         file.close();
-      } else {
-         return false;
-
-      }
-   }
-   int udim = Lrx >= Ulx ? Lrx - Ulx : Ulx - Lrx;
-   int ldim = Lry >= Uly ? Lry - Uly : Uly - Lry;
-   /** Adelante el puntero de lectura en funcion de las coordenadas del subset **/
-   char* preadpos = pData_;
-   /** Salteo la cantidad de pixeles para ulx **/
-   preadpos += Ulx * pixelsize;
-   /** Salteo la cantidad de lineas para uly **/
-   preadpos += (Uly * npixels_ * pixelsize);
-   char* pwritepos = static_cast<char*>(pBuffer);
-   memcpy(pwritepos, preadpos, udim * ldim * pixelsize);
-   return true;
+   return ReadWindow(pBuffer, Ulx, Uly, Lrx, Lry, bandReaderIndex_);
+}
+
+/** Offset en bytes del primer pixel de la linea para la banda indicada.
+ *  En BSQ cada banda ocupa un bloque contiguo del archivo:
+ *  [encabezado archivo][encabezado banda][lineas][cola banda]...
+ *  donde cada linea es [encabezado linea][pixeles][cola linea] **/
+unsigned long long BsqRasterDriver::GetLineOffset(int Line, int Band) const {
+   unsigned long long linesize = offset_.lineOffset_.headerOffset_
+         + static_cast<unsigned long long>(npixels_) * SizeOf(dataType_)
+         + offset_.lineOffset_.tailOffset_;
+   unsigned long long bandsize = offset_.bandOffset_.headerOffset_
+         + linesize * nlines_ + offset_.bandOffset_.tailOffset_;
+   return offset_.fileOffset_.headerOffset_ + bandsize * Band
+         + offset_.bandOffset_.headerOffset_ + linesize * Line
+         + offset_.lineOffset_.headerOffset_;
+}
+
+/** En BSQ los pixeles de una banda son contiguos **/
+size_t BsqRasterDriver::GetPixelStride() const {
+   return SizeOf(dataType_);
 }
 
 /** Escribe mas de una banda **/
@@ -137,15 +105,11 @@ bool BsqRasterDriver::DoWrite(const std::vector<int> &BandIndex, std::vector<voi
    return true;
 }
 
-/** Retorna un buffer interno con los datos **/
+/** Retorna un buffer con los datos del bloque (franja) indicado **/
 void* BsqRasterDriver::DoGetBlock(int BlockX, int BlockY) {
-   if (ToUpper(mux_).compare(MuxIdentifier) != 0 || BlockX == 0 || BlockY == 0
-         || BlockX > RasterDriver::sizeX_ || BlockY > RasterDriver::sizeY_ || !pData_)
+   if (ToUpper(mux_).compare(MuxIdentifier) != 0 || bandReaderIndex_ < 0)
       return NULL;
-   int pixelsize = SizeOf(dataType_);
-   char* pblock = new char[pixelsize * BlockX * BlockY];
-   memcpy(pblock, pData_, BlockX * BlockY * pixelsize);
-   return pblock;
+   return ReadBlock(BlockX, BlockY);
 }
 
 }  /** namespace driver **/
@@ -59,8 +59,6 @@ public:
    static std::string MuxIdentifier;
 
 private:
-   /** array que tiene el contenido de la banda en memoria **/
-   char* pData_;
    /** Tamanio del bloque X e Y */
    virtual bool DoGetBlockSize(int &SizeX, int &SizeY) const;
    /** Carga el buffer con el subset **/
@@ -70,6 +68,10 @@ private:
                         int Ulx, int Uly, int Lrx, int Lry);
    /** Retorna un buffer interno con los datos **/
    virtual void* DoGetBlock(int BlockX, int BlockY);
+   /** Offset en bytes del primer pixel de la linea para la banda indicada **/
+   virtual unsigned long long GetLineOffset(int Line, int Band) const;
+   /** Distancia en bytes entre dos pixeles consecutivos de una misma banda **/
+   virtual size_t GetPixelStride() const;
 };
 
 }  /** namespace driver **/
@@ -42,7 +42,8 @@ namespace suri {
  *  la proporcion)
  */
 Decimate::Decimate(int SizeX, int SizeY) :
-      sizeX_(SizeX), sizeY_(SizeY) {
+      sizeX_(SizeX), sizeY_(SizeY), resampling_(Resampler::NearestNeighbour),
+      noDataValueAvailable_(false), noDataValue_(0) {
    SetSize(SizeX, SizeY);
 }
 
@@ -112,6 +113,48 @@ void Decimate::SetSizeY(int SizeY) {
    sizeY_ = SizeY;
 }
 
+/**
+ * Establece el remuestreo que usan las fuentes al decimar
+ *  Recorre la lista de fuentes manejadas (supervisadas) y modifica el
+ * remuestreo.
+ *
+ * @param[in] Resampling tipo de remuestreo.
+ */
+void Decimate::SetResampling(Resampler::ResamplingType Resampling) {
+   SourceSetType::iterator it = childSources_.begin();
+   SourceSetType::iterator end = childSources_.end();
+   while (it != end) {
+      DecimateRasterSource *ptemp = dynamic_cast<DecimateRasterSource*>((*it));
+      if (ptemp) {
+         ptemp->SetResampling(Resampling);
+      }
+      it++;
+   }
+   resampling_ = Resampling;
+}
+
+/**
+ * Establece el valor no valido que respetan las fuentes al remuestrear
+ *  Recorre la lista de fuentes manejadas (supervisadas) y modifica el
+ * valor no valido.
+ *
+ * @param[in] Available indica si hay valor no valido.
+ * @param[in] NoDataValue valor no valido.
+ */
+void Decimate::SetNoDataValue(bool Available, double NoDataValue) {
+   SourceSetType::iterator it = childSources_.begin();
+   SourceSetType::iterator end = childSources_.end();
+   while (it != end) {
+      DecimateRasterSource *ptemp = dynamic_cast<DecimateRasterSource*>((*it));
+      if (ptemp) {
+         ptemp->SetNoDataValue(Available, NoDataValue);
+      }
+      it++;
+   }
+   noDataValueAvailable_ = Available;
+   noDataValue_ = NoDataValue;
+}
+
 /**
  * Permite obtener las dimensiones decimadas a partir de las reales.
  * Para obtener las dimensiones decimadas multiplica UL*Tamanio Deimado y
@@ -176,6 +219,9 @@ void Decimate::Resized2Real(double ResizedX, double ResizedY, double &RealX,
  * @return RasterSource generado
  */
 RasterSource *Decimate::Create() {
-   return new DecimateRasterSource(this, sizeX_, sizeY_);
+   DecimateRasterSource *psource = new DecimateRasterSource(this, sizeX_, sizeY_);
+   psource->SetResampling(resampling_);
+   psource->SetNoDataValue(noDataValueAvailable_, noDataValue_);
+   return psource;
 }
 }
@@ -34,6 +34,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes suri
 #include "suri/SourceSupervisor.h"
+#include "suri/Resampler.h"
 
 /** namespace suri */
 namespace suri {
@@ -62,6 +63,10 @@ public:
    virtual void SetSizeX(int SizeX);
    /** Debe setear la dimension Y manteniendo la proporcion */
    virtual void SetSizeY(int SizeY);
+   /** Establece el remuestreo que usan las fuentes al decimar */
+   virtual void SetResampling(Resampler::ResamplingType Resampling);
+   /** Establece el valor no valido que respetan las fuentes al remuestrear */
+   virtual void SetNoDataValue(bool Available, double NoDataValue);
    /** Permite obtener las dimensiones decimadas a partir de las reales */
    virtual void Real2Resized(double RealX, double RealY, double &ResizedX,
                              double &ResizedY) const;
@@ -75,6 +80,9 @@ protected:
 private:
    int sizeX_; /*! Tamanio de columnas decimado */
    int sizeY_; /*! Tamanio de filas decimado */
+   Resampler::ResamplingType resampling_; /*! Remuestreo al decimar */
+   bool noDataValueAvailable_; /*! indica si hay valor no valido */
+   double noDataValue_; /*! valor no valido */
 };
 }
 
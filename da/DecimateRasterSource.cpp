@@ -27,10 +27,17 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 #include "DecimateRasterSource.h"
 
+// Includes standard
+#include <vector>
+
 // Includes suri
 #include "suri/DataTypes.h"
 #include "suri/AuxiliaryFunctions.h"
 
+// Defines
+/** Filas de la fuente que se leen juntas al decimar con remuestreo */
+#define DECIMATE_RESAMPLING_MAX_ROWS 256
+
 /** namespace suri */
 namespace suri {
 /** Template decimador */
@@ -68,7 +75,9 @@ INITIALIZE_DATATYPE_MAP(DecimateRasterSource::DecimateFunc, decimate);
 DecimateRasterSource::DecimateRasterSource(SourceSupervisor *pSupervisor, int NewX,
                                            int NewY) :
       RasterSource(pSupervisor), sizeX_(NewX), sizeY_(NewY), stepX_(1), stepY_(1),
-      pFunction_(NULL), pBuffer_(NULL) {
+      pFunction_(NULL), resampling_(Resampler::NearestNeighbour),
+      pResampleFunction_(NULL), noDataValueAvailable_(false), noDataValue_(0),
+      realX_(0), realY_(0), pBuffer_(NULL) {
 }
 
 /** Destructor */
@@ -107,6 +116,25 @@ void DecimateRasterSource::SetSizeY(int SizeY) {
    SetSize(0, SizeY);
 }
 
+/**
+ * Establece el remuestreo que se usa al decimar.
+ * @param[in] Resampling tipo de remuestreo.
+ */
+void DecimateRasterSource::SetResampling(Resampler::ResamplingType Resampling) {
+   resampling_ = Resampling;
+}
+
+/**
+ * Establece el valor no valido. Los pixeles cuyo nucleo incluye el valor no
+ * valido se deciman con el vecino mas cercano.
+ * @param[in] Available indica si hay valor no valido.
+ * @param[in] NoDataValue valor no valido.
+ */
+void DecimateRasterSource::SetNoDataValue(bool Available, double NoDataValue) {
+   noDataValueAvailable_ = Available;
+   noDataValue_ = NoDataValue;
+}
+
 /**
  * Obtiene el tamanio original de la fuente de datos.
  * @param[out] SizeX tamano en X. Cantidad de columnas.
@@ -176,6 +204,9 @@ bool DecimateRasterSource::Read(void *pBuffer, int Ulx, int Uly, int Lrx, int Lr
    if (!pFunction_) {
       return false;
    }
+   if (resampling_ != Resampler::NearestNeighbour && pResampleFunction_) {
+      return ReadResampled(pBuffer, Ulx, Uly, Lrx, Lry);
+   }
    int realulx = SURI_ROUND(int, Ulx*stepX_), reallrx = SURI_ROUND(int, Lrx*stepX_);
    int realwidth = reallrx - realulx;
    char *ptempbuffer = new char[realwidth * pSource_->GetDataSize()];
@@ -195,6 +226,54 @@ bool DecimateRasterSource::Read(void *pBuffer, int Ulx, int Uly, int Lrx, int Lr
    return validdata;
 }
 
+/**
+ *  Carga el subset decimando con el remuestreo configurado. Cada pixel de
+ * salida combina los pixeles de la fuente que cubre (con el nucleo
+ * ensanchado segun el paso). La fuente se lee por bloques de filas para
+ * acotar la memoria.
+ * @param[out] pBuffer es el buffer donde se copian los datos
+ * @param[in] Ulx Coordenada X superior
+ * @param[in] Uly Coordenada Y superior
+ * @param[in] Lrx Coordenada X inferior
+ * @param[in] Lry Coordenada X inferior
+ * @return false si fallo la lectura de la fuente
+ */
+bool DecimateRasterSource::ReadResampled(void *pBuffer, int Ulx, int Uly, int Lrx,
+                                         int Lry) {
+   int width = Lrx - Ulx, height = Lry - Uly;
+   if (width <= 0 || height <= 0) {
+      return true;
+   }
+   Resampler::WeightTable columns, rows;
+   columns.Initialize(resampling_, width, stepX_, Ulx * stepX_, realX_);
+   rows.Initialize(resampling_, height, stepY_, Uly * stepY_, realY_);
+   int srculx = columns.GetSourceBegin(), srclrx = columns.GetSourceEnd();
+   int srcwidth = srclrx - srculx;
+   int taps = rows.GetTapCount();
+   std::vector<unsigned char> source;
+
+   bool validdata = true;
+   for (int first = 0; first < height && validdata;) {
+      // Agrega filas de salida mientras las filas de fuente entren en el bloque
+      int last = first + 1;
+      while (last < height
+            && rows.GetFirst(last) + taps - rows.GetFirst(first)
+                  <= DECIMATE_RESAMPLING_MAX_ROWS) {
+         last++;
+      }
+      int srculy = rows.GetFirst(first), srclry = rows.GetFirst(last - 1) + taps;
+      source.resize(static_cast<size_t>(srcwidth) * (srclry - srculy)
+            * pSource_->GetDataSize());
+      validdata = pSource_->Read(&source[0], srculx, srculy, srclrx, srclry);
+      if (validdata) {
+         pResampleFunction_(&source[0], srcwidth, srculx, srculy, pBuffer, columns, rows,
+                            first, last, noDataValueAvailable_, noDataValue_);
+      }
+      first = last;
+   }
+   return validdata;
+}
+
 /** Metodo de las fuentes que actualiza los datos */
 /**
  *  Actualiza los pasos en X e Y basado en la dimension deseada.
@@ -206,10 +285,13 @@ bool DecimateRasterSource::Read(void *pBuffer, int Ulx, int Uly, int Lrx, int Lr
  */
 void DecimateRasterSource::Update() {
    pFunction_ = decimateTypeMap[pSource_->GetDataType()];
+   pResampleFunction_ = Resampler::GetResampleFunction(pSource_->GetDataType());
 
    int realx = 0, realy = 0;
    pSource_->CalcRecommendedSize(sizeX_, sizeY_, realx, realy);
    pSource_->SetRecommendedSize(realx, realy);
+   realX_ = realx;
+   realY_ = realy;
 
    // no pueden ser cero los dos al mismo tiempo
    if (sizeX_ == 0 && sizeY_ == 0) {
@@ -30,12 +30,15 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes suri
 #include "suri/RasterDriver.h"
+#include "suri/Resampler.h"
 
 /** namespace suri */
 namespace suri {
-/** Clase fuente que decima con NN la lectura de datos */
+/** Clase fuente que decima la lectura de datos */
 /**
- *  Esta clase sirve para decimar la lectura de datos de una imagen.
+ *  Esta clase sirve para decimar la lectura de datos de una imagen. Por
+ * defecto decima con NN; con otro remuestreo (ver Resampler) filtra las
+ * filas y columnas de la fuente con pesos precalculados.
  *
  *  Se intercala adelante de otra fuente. Se establece un tamanio de imagen
  * deseado y este se ocupa de calcular el paso necesario para lograr dicha
@@ -61,6 +64,10 @@ public:
    virtual void SetSizeX(int SizeX);
    /** Debe setear la dimension Y manteniendo la proporcion */
    virtual void SetSizeY(int SizeY);
+   /** Establece el remuestreo que se usa al decimar */
+   virtual void SetResampling(Resampler::ResamplingType Resampling);
+   /** Establece el valor no valido que se respeta al remuestrear */
+   virtual void SetNoDataValue(bool Available, double NoDataValue);
    /** obtiene el tamanio original */
    virtual void GetRealSize(int &SizeX, int &SizeY);
    /** obtiene el tamanio decimado */
@@ -87,11 +94,19 @@ public:
 
 protected:
 private:
+   /** Carga el buffer con el subset usando el remuestreo */
+   bool ReadResampled(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry);
    int sizeX_; /*! cantidad de columnas en imagen nueva. */
    int sizeY_; /*! cantidad de filas en imagen nueva. */
    double stepX_; /*! paso en X */
    double stepY_; /*! paso en Y */
    DecimateFunc pFunction_; /*! Funcion decimadora */
+   Resampler::ResamplingType resampling_; /*! Remuestreo al decimar */
+   Resampler::ResampleFunctionType pResampleFunction_; /*! Funcion de remuestreo */
+   bool noDataValueAvailable_; /*! indica si hay valor no valido */
+   double noDataValue_; /*! valor no valido */
+   int realX_; /*! columnas de la fuente */
+   int realY_; /*! filas de la fuente */
    unsigned char *pBuffer_; /*! Puntero interno a datos usado por GetBuffer */
 };
 }
@@ -26,6 +26,7 @@ For more information about SpaceSUR, visit <https://www.spacesur.com>.
 For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 #include "suri/ExactCoordinatesTransformation.h"
+#include "suri/TransformationCache.h"
 
 namespace suri {
 
@@ -37,25 +38,33 @@ namespace suri {
  * @param[in] IsIdentity Especifica si la transformacion es la identidad.
  * @param[in] PTransform Transformacion directa a utilizar.
  * @param[in] PITransform Transformacion inversa a utilizar.
+ * @param[in] CacheKey Clave en TransformationCache. Si no es vacia las
+ * transformaciones se devuelven al cache en lugar de destruirse.
  */
 ExactCoordinatesTransformation::ExactCoordinatesTransformation(
       const std::string& WktIn,
       const std::string& WktOut,
       bool IsIdentity,
       OGRCoordinateTransformation* PTransform,
-      OGRCoordinateTransformation* PITransform): isIdentity_(IsIdentity),
+      OGRCoordinateTransformation* PITransform,
+      const std::string& CacheKey): isIdentity_(IsIdentity),
       wktIn_(WktIn), wktOut_(WktOut),
       pTransform_(PTransform),
-      pITransform_(PITransform)  {
+      pITransform_(PITransform), cacheKey_(CacheKey)  {
 }
 
 /**
- * Destructor (destruye los punteros de las transformaciones utilizadas)
+ * Destructor (destruye los punteros de las transformaciones utilizadas o
+ * los devuelve al cache)
  */
 ExactCoordinatesTransformation::~ExactCoordinatesTransformation() {
    if (!IsIdentity()) {
-      OCTDestroyCoordinateTransformation(pTransform_);
-      OCTDestroyCoordinateTransformation(pITransform_);
+      if (!cacheKey_.empty()) {
+         TransformationCache::Instance().Release(cacheKey_, pTransform_, pITransform_);
+      } else {
+         OCTDestroyCoordinateTransformation(pTransform_);
+         OCTDestroyCoordinateTransformation(pITransform_);
+      }
       pTransform_ = NULL;
       pITransform_ = NULL;
    }
@@ -96,14 +105,69 @@ int ExactCoordinatesTransformation::Transform(
    size_t totalcoord = CoordinatesP.size();
    if (IsIdentity())
       return totalcoord;
+   if (totalcoord == 0)
+      return 0;
 
-   int result = 0;
+   std::vector<double> x(totalcoord), y(totalcoord);
    for (size_t ix = 0; ix < totalcoord; ++ix) {
-      if (Transform(CoordinatesP[ix], Inverse) != 0) {
-         ++result;
-      }
+      x[ix] = CoordinatesP[ix].x_;
+      y[ix] = CoordinatesP[ix].y_;
+   }
+   int result = Transform(&x[0], &y[0], totalcoord, Inverse);
+   for (size_t ix = 0; ix < totalcoord; ++ix) {
+      CoordinatesP[ix].x_ = x[ix];
+      CoordinatesP[ix].y_ = y[ix];
+   }
+   return result;
+}
+
+/**
+ * Transforma los arreglos de coordenadas con una sola llamada a OGR. Si
+ * falla algun punto OGR no indica cual, entonces se restauran los valores
+ * y se transforma punto a punto.
+ *
+ * @param[in,out] pX Coordenadas x.
+ * @param[in,out] pY Coordenadas y.
+ * @param[in] Count Cantidad de puntos.
+ * @param[in] Inverse Indica si se debe hacer la transformacion inversa.
+ * @param[out] pSuccess (opcional) Indica por punto si se transformo. Los
+ * puntos que no se transforman conservan su valor.
+ * @return Cantidad de coordenadas transformadas.
+ */
+int ExactCoordinatesTransformation::Transform(double* pX, double* pY, int Count,
+                                              bool Inverse, int* pSuccess) const {
+   OGRCoordinateTransformation* ptransform = Inverse ? pITransform_ : pTransform_;
+   bool identity = IsIdentity();
+   if (Count <= 0 || (!identity && ptransform == NULL)) {
+      for (int ix = 0; pSuccess && ix < Count; ++ix)
+         pSuccess[ix] = 0;
+      return 0;
+   }
+
+   std::vector<double> x, y;
+   if (!identity) {
+      x.assign(pX, pX + Count);
+      y.assign(pY, pY + Count);
+   }
+   if (identity || ptransform->Transform(Count, pX, pY)) {
+      for (int ix = 0; pSuccess && ix < Count; ++ix)
+         pSuccess[ix] = 1;
+      return Count;
    }
 
+   int result = 0;
+   for (int ix = 0; ix < Count; ++ix) {
+      pX[ix] = x[ix];
+      pY[ix] = y[ix];
+      int success = ptransform->Transform(1, &pX[ix], &pY[ix]) ? 1 : 0;
+      if (!success) {
+         pX[ix] = x[ix];
+         pY[ix] = y[ix];
+      }
+      if (pSuccess)
+         pSuccess[ix] = success;
+      result += success;
+   }
    return result;
 }
 
@@ -139,25 +203,34 @@ int ExactCoordinatesTransformation::Transform(Subset &SubsetP,
    double maxx = -std::numeric_limits<double>::max();
    double maxy = -std::numeric_limits<double>::max();
 
-   // Calcula los limites en el SR de salida
+   // Transforma todos los puntos de la grilla en una llamada
+   int pointcount = CalculationPoints * CalculationPoints;
+   std::vector<double> x(pointcount), y(pointcount);
+   std::vector<int> success(pointcount);
    for (int ix = 0; ix < CalculationPoints; ++ix) {
       for (int jx = 0; jx < CalculationPoints; ++jx) {
-         Coordinates point(SubsetP.ul_.x_ + ix * dx, SubsetP.ul_.y_ + jx * dy);
-         if (Transform(point, Inverse) != 0) {
-            if (point.x_ < minx)
-               minx = point.x_;
+         x[ix * CalculationPoints + jx] = SubsetP.ul_.x_ + ix * dx;
+         y[ix * CalculationPoints + jx] = SubsetP.ul_.y_ + jx * dy;
+      }
+   }
+   Transform(&x[0], &y[0], pointcount, Inverse, &success[0]);
 
-            if (point.y_ < miny)
-               miny = point.y_;
+   // Calcula los limites en el SR de salida
+   for (int ix = 0; ix < pointcount; ++ix) {
+      if (success[ix] != 0) {
+         if (x[ix] < minx)
+            minx = x[ix];
+
+         if (y[ix] < miny)
+            miny = y[ix];
 
-            if (point.x_ > maxx)
-               maxx = point.x_;
+         if (x[ix] > maxx)
+            maxx = x[ix];
 
-            if (point.y_ > maxy)
-               maxy = point.y_;
+         if (y[ix] > maxy)
+            maxy = y[ix];
 
-            ++result;
-         }
+         ++result;
       }
    }
 
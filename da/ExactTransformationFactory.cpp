@@ -27,6 +27,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 #include "suri/ExactTransformationFactory.h"
 #include "suri/ExactCoordinatesTransformation.h"
+#include "suri/TransformationCache.h"
 
 namespace suri {
 
@@ -72,6 +73,33 @@ CoordinatesTransformation* ExactTransformationFactory::Create(
       std::string srwktout;
       params.GetValue<std::string>(suri::TransformationFactory::kParamWktOut, srwktout);
 
+      // Si ya se creo la transformacion para estos WKTs se evita validarlos
+      // y parsearlos nuevamente
+      TransformationCache& cache = TransformationCache::Instance();
+      std::string key = TransformationCache::GetKey(Type, srwktin, srwktout);
+      std::string cachedwktout;
+      OGRCoordinateTransformation* ptransform = NULL;
+      OGRCoordinateTransformation* pinversetransform = NULL;
+      switch (cache.Acquire(key, cachedwktout, ptransform, pinversetransform)) {
+         case TransformationCache::Invalid:
+            return NULL;
+         case TransformationCache::Identity:
+            return new ExactCoordinatesTransformation(srwktin, cachedwktout);
+         case TransformationCache::Transformation:
+            if (ptransform == NULL)
+               CreateTransformations(srwktin, cachedwktout, ptransform,
+                                     pinversetransform);
+            if (ptransform == NULL) {
+               cache.Release(key, NULL, NULL);
+               return NULL;
+            }
+            return new ExactCoordinatesTransformation(srwktin, cachedwktout, false,
+                                                      ptransform, pinversetransform,
+                                                      key);
+         default:
+            break;
+      }
+
       if (srwktout.empty()) {
          srwktout = GetWktOut(srwktin);
       }
@@ -79,16 +107,19 @@ CoordinatesTransformation* ExactTransformationFactory::Create(
       // TODO(Gabriel - TCK #2344): Sacar cuando SR Raster tenga un Wkt Valido
       if (SpatialReference::IsPixelLineSpatialRef(srwktin)
             && SpatialReference::IsPixelLineSpatialRef(srwktout)) {
+         cache.Insert(key, TransformationCache::Identity, srwktout);
          return new ExactCoordinatesTransformation(srwktin, srwktout);
       }
 
       // Verifica los WKTs de entrada
       if (!Wkt::IsValid(srwktin) || !Wkt::IsValid(srwktout)) {
+         cache.Insert(key, TransformationCache::Invalid, srwktout);
          return NULL;
       }
 
       // Verifica si los WKTs son los mismos y en caso positivo devuelve la identidad
       if (srwktin.compare(srwktout) == 0) {
+         cache.Insert(key, TransformationCache::Identity, srwktout);
          return new ExactCoordinatesTransformation(srwktin, srwktout);
       }
 
@@ -97,34 +128,29 @@ CoordinatesTransformation* ExactTransformationFactory::Create(
       OGRSpatialReference srout(srwktout.c_str());
       if (srin.Validate() == OGRERR_CORRUPT_DATA
             || srout.Validate() == OGRERR_CORRUPT_DATA) {
+         cache.Insert(key, TransformationCache::Invalid, srwktout);
          return NULL;
       }
 
       // Si OGR informa que los sistemas de referencia son iguales retorna
       // identidad.
       if (srin.IsSame(&srout)) {
+         cache.Insert(key, TransformationCache::Identity, srwktout);
          return new ExactCoordinatesTransformation(srwktin, srwktout);
       }
 
-      // Crea la transformacion directa
-      OGRCoordinateTransformation* ptransform =
-            OGRCreateCoordinateTransformation(&srin, &srout);
+      // Crea las transformaciones directa e inversa. Si falla no se guarda el
+      // resultado ya que puede deberse a un error transitorio.
+      CreateTransformations(srin, srout, ptransform, pinversetransform);
       if (ptransform == NULL)
          return NULL;
 
-      // Crea la transformacion inversa
-      OGRCoordinateTransformation* pinversetransform =
-            OGRCreateCoordinateTransformation(&srout, &srin);
-      if (pinversetransform == NULL) {
-         OCTDestroyCoordinateTransformation(ptransform);
-         return NULL;
-      }
-
       // Crea el objeto ExactCoordinatesTransformation con las correspondientes
-      // transformaciones.
+      // transformaciones. Al destruirse devuelve las transformaciones al cache.
+      cache.Insert(key, TransformationCache::Transformation, srwktout);
       ExactCoordinatesTransformation* pcoordtransform =
             new ExactCoordinatesTransformation(srwktin, srwktout, false, ptransform,
-                                     pinversetransform);
+                                     pinversetransform, key);
 
       return pcoordtransform;
    } else {
@@ -136,6 +162,46 @@ CoordinatesTransformation* ExactTransformationFactory::Create(
    return NULL;
 }
 
+/**
+ * Crea las transformaciones OGR directa e inversa entre dos referencias.
+ *
+ * @param[in] SrIn Referencia de entrada.
+ * @param[in] SrOut Referencia de salida.
+ * @param[out] pTransform Transformacion directa o NULL si fallo.
+ * @param[out] pInverseTransform Transformacion inversa o NULL si fallo.
+ */
+void ExactTransformationFactory::CreateTransformations(
+      OGRSpatialReference& SrIn, OGRSpatialReference& SrOut,
+      OGRCoordinateTransformation*& pTransform,
+      OGRCoordinateTransformation*& pInverseTransform) {
+   pInverseTransform = NULL;
+   pTransform = OGRCreateCoordinateTransformation(&SrIn, &SrOut);
+   if (pTransform == NULL)
+      return;
+   pInverseTransform = OGRCreateCoordinateTransformation(&SrOut, &SrIn);
+   if (pInverseTransform == NULL) {
+      OCTDestroyCoordinateTransformation(pTransform);
+      pTransform = NULL;
+   }
+}
+
+/**
+ * Crea las transformaciones OGR para WKTs ya validados (en el cache).
+ *
+ * @param[in] WktIn WKT de entrada.
+ * @param[in] WktOut WKT de salida.
+ * @param[out] pTransform Transformacion directa o NULL si fallo.
+ * @param[out] pInverseTransform Transformacion inversa o NULL si fallo.
+ */
+void ExactTransformationFactory::CreateTransformations(
+      const std::string& WktIn, const std::string& WktOut,
+      OGRCoordinateTransformation*& pTransform,
+      OGRCoordinateTransformation*& pInverseTransform) {
+   OGRSpatialReference srin(WktIn.c_str());
+   OGRSpatialReference srout(WktOut.c_str());
+   CreateTransformations(srin, srout, pTransform, pInverseTransform);
+}
+
 /**
  * Crea el WKT de salida.
  *
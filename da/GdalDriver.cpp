@@ -210,9 +210,9 @@ void GdalDriver::CalcRecommendedSize(int XSize, int YSize, int& XRecomm, int& YR
                break;
             }
          }
-         if (XRecomm < XSize && YRecomm < YSize) {
-            XRecomm = XSize;
-            YRecomm = YSize;
+         // Si ningun overview cubre lo pedido se usa la resolucion completa.
+         if (XRecomm < XSize || YRecomm < YSize) {
+            GetSize(XRecomm, YRecomm);
          }
       } else {
          GetSize(XRecomm, YRecomm);
@@ -225,6 +225,7 @@ void GdalDriver::CalcRecommendedSize(int XSize, int YSize, int& XRecomm, int& YR
  */
 void GdalDriver::SetRecommendedSize(int XRecomm, int YRecomm) {
    RasterSource::SetRecommendedSize(XRecomm, YRecomm);
+   ovlevel_ = -1;
 
    if (pDataset_ != NULL) {
       GDALRasterBand* prawband = pDataset_->GetRasterBand(band_ + 1);
@@ -32,6 +32,8 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include <map>
 #include <utility>
 #include <cmath>
+#include <cstring>
+#include <vector>
 
 // Includes suri
 #include "GdalImage.h"
@@ -42,9 +44,14 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "suri/RasterSpatialModel.h"
 #include "suri/AuxiliaryFunctions.h"
 #include "suri/Configuration.h"
+#include "suri/Progress.h"
+#include "suri/messages.h"
 #include "gdal_priv.h"
 #include "locale.h"
 
+// Includes Wx
+#include "wx/filename.h"
+
 namespace {
 
 /**
@@ -65,6 +72,26 @@ void PutEnvEx(const std::string& Key, const std::string& Val) {
    putenv(pstr);
 }
 
+/** Cantidad de ciclos del progreso de generacion de overviews */
+#define OVERVIEW_PROGRESS_CYCLES 100
+
+/**
+ * Informa el avance de GDALDataset::BuildOverviews a traves de suri::Progress
+ * @return FALSE si el usuario cancelo la operacion
+ */
+int CPL_STDCALL OverviewProgressProc(double Complete, const char* pMessage,
+                                     void* pProgressArg) {
+   std::pair<suri::Progress*, int>* pprogress =
+         static_cast<std::pair<suri::Progress*, int>*>(pProgressArg);
+   int cycles = static_cast<int>(Complete * OVERVIEW_PROGRESS_CYCLES);
+   for (; pprogress->second < cycles; ++pprogress->second) {
+      if (pprogress->first->Update()) {
+         return FALSE;
+      }
+   }
+   return TRUE;
+}
+
 }  // namespace anonimo
 
 // Defines
@@ -402,6 +429,111 @@ void GdalImage::InitializeRead(const std::string &Filename) {
    }
 }
 
+/**
+ * Para archivos con interlineado por pixel (ej. GeoTiff PIXEL) lee todas las
+ * bandas pedidas con un unico RasterIO del dataset, de modo que cada bloque
+ * se decodifica una sola vez, y luego las separa en los buffers de cada
+ * banda. Para el resto de los interlineados retorna false y la lectura se
+ * realiza banda por banda (aprovechando la cache de bloques).
+ * @param[in] BandIndex vector con bandas que se quieren leer
+ * @param[out] Data vector donde se van a cargar los datos
+ * @param[in] Ulx upper left x del subset
+ * @param[in] Uly upper left y del subset
+ * @param[in] Lrx lower right x del subset
+ * @param[in] Lry lower right y del subset
+ * @return true si pudo leer todas las bandas
+ */
+bool GdalImage::ReadInterleaved(const std::vector<int> &BandIndex,
+                                std::vector<void*> &Data, int Ulx, int Uly, int Lrx,
+                                int Lry) const {
+   if (!pDataset_ || BandIndex.size() != Data.size()) {
+      return false;
+   }
+   const char* pinterleave = pDataset_->GetMetadataItem("INTERLEAVE", "IMAGE_STRUCTURE");
+   if (!pinterleave || !EQUAL(pinterleave, "PIXEL")) {
+      return false;
+   }
+   GDALDataType datatype = pDataset_->GetRasterBand(1)->GetRasterDataType();
+   int datasize = GDALGetDataTypeSize(datatype) / 8;
+   if (datasize != GetDataSize()) {
+      return false;
+   }
+   std::vector<int> bandmap(BandIndex.size());
+   for (size_t i = 0; i < BandIndex.size(); ++i) {
+      bandmap[i] = BandIndex[i] + 1;
+   }
+   int width = Lrx - Ulx, height = Lry - Uly;
+   size_t bandsize = static_cast<size_t>(width) * height * datasize;
+   // buffer con las bandas consecutivas para separarlas luego
+   std::vector<unsigned char> buffer(bandsize * BandIndex.size());
+   CPLErr result = pDataset_->RasterIO(GF_Read, Ulx, Uly, width, height, &buffer[0],
+                                       width, height, datatype,
+                                       static_cast<int>(bandmap.size()), &bandmap[0],
+                                       datasize, datasize * width, bandsize);
+   if (result != CE_None) {
+      return false;
+   }
+   for (size_t i = 0; i < Data.size(); ++i) {
+      memcpy(Data[i], &buffer[i * bandsize], bandsize);
+   }
+   return true;
+}
+
+/**
+ *  Los overviews guardados por GDAL en un archivo .ovr asociado se consideran
+ * desactualizados si el archivo es anterior a la ultima modificacion de la
+ * imagen.
+ * @return true si la imagen tiene overviews y estan actualizados
+ */
+bool GdalImage::HasOverviews() const {
+   if (!pDataset_ || pDataset_->GetRasterCount() < 1
+         || pDataset_->GetRasterBand(1)->GetOverviewCount() < 1) {
+      return false;
+   }
+   std::string filename = GetOption("filename");
+   wxFileName source(wxString(filename.c_str(), wxConvUTF8));
+   wxFileName sidecar(wxString((filename + ".ovr").c_str(), wxConvUTF8));
+   return !source.FileExists() || !sidecar.FileExists()
+         || !sidecar.GetModificationTime().IsEarlierThan(source.GetModificationTime());
+}
+
+/**
+ * Genera los overviews (piramide) del archivo con los factores indicados
+ * promediando los pixeles. Para GeoTiff se intenta abrir el archivo en modo
+ * actualizacion para que los niveles queden dentro del mismo archivo; en
+ * otro caso (o si no se puede escribir) GDAL los guarda en un archivo .ovr
+ * asociado.
+ * \attention La imagen ya abierta no ve los nuevos niveles hasta que se
+ * vuelva a abrir.
+ * @param[in] Factors factores de reduccion de cada nivel (ej. 2, 4, 8)
+ * @return true si pudo generar los overviews
+ */
+bool GdalImage::BuildOverviews(const std::vector<int> &Factors) {
+   std::string filename = GetOption("filename");
+   if (!pDataset_ || Factors.empty() || filename.empty()) {
+      return false;
+   }
+   GDALDatasetH hdataset = NULL;
+   GDALDriver *pdriver = pDataset_->GetDriver();
+   if (pdriver && std::string(pdriver->GetDescription()) == "GTiff") {
+      hdataset = GDALOpen(filename.c_str(), GA_Update);
+   }
+   if (!hdataset) {
+      hdataset = GDALOpen(filename.c_str(), GA_ReadOnly);
+   }
+   if (!hdataset) {
+      return false;
+   }
+   std::vector<int> factors(Factors);
+   Progress progress(OVERVIEW_PROGRESS_CYCLES, _(message_BUILDING_OVERVIEWS));
+   std::pair<Progress*, int> progressarg(&progress, 0);
+   CPLErr result = static_cast<GDALDataset*>(hdataset)->BuildOverviews(
+         "AVERAGE", static_cast<int>(factors.size()), &factors[0], 0, NULL,
+         OverviewProgressProc, &progressarg);
+   GDALClose(hdataset);
+   return result == CE_None;
+}
+
 /**
  * Inicializa para escritura
  * @param[in] Filename nombre de archivo a escribir.
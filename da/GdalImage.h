@@ -33,6 +33,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 // Includes standard
 #include <string>
 #include <map>
+#include <vector>
 
 // Includes suri
 #include "suri/Image.h"
@@ -88,6 +89,11 @@ public:
    /** Establece la transformacion para georreferenciacion */
    virtual void SetGeoTransform(double* pGeoTransform);
 
+   /** Indica si el archivo tiene overviews actualizados */
+   bool HasOverviews() const;
+   /** Genera los overviews del archivo con los factores indicados */
+   bool BuildOverviews(const std::vector<int> &Factors);
+
 protected:
    /** Inicializa para lectura */
    void InitializeRead(const std::string &Filename);
@@ -95,6 +101,10 @@ protected:
    void InitializeWrite(const std::string &Filename);
    /** Inicializacion de la clase */
    virtual void InitializeClass();
+   /** Lee varias bandas pixel-interleaved con un unico RasterIO */
+   virtual bool ReadInterleaved(const std::vector<int> &BandIndex,
+                                std::vector<void*> &Data, int Ulx, int Uly, int Lrx,
+                                int Lry) const;
 
 private:
    /*! Objeto GDAL que representa la imagen */
@@ -431,6 +431,13 @@ bool Image::Read(const std::vector<int> &BandIndex, std::vector<void*> &Data, in
       REPORT_AND_FAIL_VALUE("D:Read, se solicitan mas bandas de los buffers.", false);
    }
 
+   // Si las bandas se leen directamente de los drivers se intenta leerlas
+   // todas juntas para no recorrer N veces el mismo bloque de archivo
+   if (size > 1 && CanReadInterleaved(BandIndex, Ulx, Uly, Lrx, Lry)
+         && ReadInterleaved(BandIndex, Data, Ulx, Uly, Lrx, Lry)) {
+      return true;
+   }
+
    bool success = true;
    Progress progress(size, _(message_READING_BANDS));
    for (size_t i = 0; i < size && success; i++) {
@@ -442,6 +449,35 @@ bool Image::Read(const std::vector<int> &BandIndex, std::vector<void*> &Data, in
    return success;
 }
 
+/**
+ * Verifica que la lectura en conjunto de las bandas devuelva lo mismo que la
+ * lectura banda por banda: la imagen es de solo lectura (no hay bloques
+ * modificados en memoria), el subset esta dentro de la imagen, ninguna
+ * banda tiene fuentes (ej. decimado) entre ella y su driver y ningun bloque
+ * del subset esta en el cache de bloques (si hay alguno conviene usarlo).
+ * @param[in] BandIndex vector con bandas que se quieren leer
+ * @param[in] Ulx upper left x del subset
+ * @param[in] Uly upper left y del subset
+ * @param[in] Lrx lower right x del subset
+ * @param[in] Lry lower right y del subset
+ * @return true si se puede usar ReadInterleaved
+ */
+bool Image::CanReadInterleaved(const std::vector<int> &BandIndex, int Ulx, int Uly,
+                               int Lrx, int Lry) const {
+   if (access_ != ReadOnly || Ulx < 0 || Uly < 0 || Lrx <= Ulx || Lry <= Uly
+         || Lrx > GetSizeX() || Lry > GetSizeY()) {
+      return false;
+   }
+   for (size_t i = 0; i < BandIndex.size(); i++) {
+      if (BandIndex[i] < 0 || BandIndex[i] >= GetBandCount()
+            || !bandVector_[BandIndex[i]]->IsReadingFromDriver()
+            || bandVector_[BandIndex[i]]->HasCachedBlocks(Ulx, Uly, Lrx, Lry)) {
+         return false;
+      }
+   }
+   return true;
+}
+
 /**
  * Escribe mas de una banda
  * @param[in] BandIndex vector con bandas que se quieren escribir
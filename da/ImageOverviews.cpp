@@ -0,0 +1,209 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#include "ImageOverviews.h"
+
+// Includes standard
+#include <fstream>
+#include <sstream>
+
+// Includes suri
+#include "suri/Image.h"
+
+// Includes Wx
+#include "wx/filename.h"
+
+/** Cantidad maxima de niveles que se buscan */
+#define MAX_OVERVIEW_LEVELS 16
+
+/** namespace suri */
+namespace suri {
+
+/**
+ * Busca los niveles existentes (factores 2, 4, 8, ...) y los abre. La
+ * busqueda se detiene en el primer factor que no tiene archivo o cuyo archivo
+ * esta desactualizado.
+ * @param[in] Filename archivo de la imagen original
+ * @param[in] SizeX columnas de la imagen original
+ * @param[in] SizeY filas de la imagen original
+ */
+ImageOverviews::ImageOverviews(const std::string &Filename, int SizeX, int SizeY) :
+      filename_(Filename) {
+   for (int level = 1, factor = 2; level <= MAX_OVERVIEW_LEVELS; ++level, factor *= 2) {
+      Image *pimage = OpenLevel(Filename, factor, SizeX, SizeY);
+      if (!pimage) {
+         break;
+      }
+      OverviewLevel overview;
+      overview.factor_ = factor;
+      overview.pImage_ = pimage;
+      pimage->GetSize(overview.sizeX_, overview.sizeY_);
+      levels_.push_back(overview);
+   }
+}
+
+/** Dtor */
+ImageOverviews::~ImageOverviews() {
+   for (size_t i = 0; i < levels_.size(); ++i) {
+      Image::Close(levels_[i].pImage_);
+   }
+}
+
+/**
+ * @param[in] Filename archivo de la imagen original
+ * @param[in] Factor factor de reduccion del nivel
+ * @return nombre del archivo del nivel (ej. imagen.raw.ovr2.tif)
+ */
+std::string ImageOverviews::GetLevelFilename(const std::string &Filename, int Factor) {
+   std::stringstream ss;
+   ss << Filename << ".ovr" << Factor << ".tif";
+   return ss.str();
+}
+
+/**
+ * @param[in] Filename archivo de la imagen original
+ * @param[in] Factor factor de reduccion del nivel
+ * @param[in] SizeX columnas de la imagen original
+ * @param[in] SizeY filas de la imagen original
+ * @return true si el nivel existe y esta actualizado
+ */
+bool ImageOverviews::IsLevelUpToDate(const std::string &Filename, int Factor,
+                                     int SizeX, int SizeY) {
+   Image *pimage = OpenLevel(Filename, Factor, SizeX, SizeY);
+   if (!pimage) {
+      return false;
+   }
+   Image::Close(pimage);
+   return true;
+}
+
+/**
+ *  El nivel esta desactualizado si su archivo es anterior a la ultima
+ * modificacion de la imagen original o si sus dimensiones no son las de la
+ * imagen reducida en el factor (redondeando hacia arriba, como lo genera
+ * OverviewBuilder).
+ * @param[in] Filename archivo de la imagen original
+ * @param[in] Factor factor de reduccion del nivel
+ * @param[in] SizeX columnas de la imagen original
+ * @param[in] SizeY filas de la imagen original
+ * @return imagen del nivel abierta en modo lectura o NULL si no existe o esta
+ *         desactualizado
+ */
+Image* ImageOverviews::OpenLevel(const std::string &Filename, int Factor, int SizeX,
+                                 int SizeY) {
+   std::string levelfilename = GetLevelFilename(Filename, Factor);
+   if (!std::ifstream(levelfilename.c_str()).good()) {
+      return NULL;
+   }
+   wxFileName source(wxString(Filename.c_str(), wxConvUTF8));
+   wxFileName level(wxString(levelfilename.c_str(), wxConvUTF8));
+   if (source.FileExists()
+         && level.GetModificationTime().IsEarlierThan(source.GetModificationTime())) {
+      REPORT_DEBUG("D:Overview desactualizado: %s", levelfilename.c_str());
+      return NULL;
+   }
+   Image *pimage = Image::Open(levelfilename);
+   if (!pimage) {
+      return NULL;
+   }
+   int sizex = 0, sizey = 0;
+   pimage->GetSize(sizex, sizey);
+   if (sizex != (SizeX + Factor - 1) / Factor || sizey != (SizeY + Factor - 1) / Factor) {
+      REPORT_DEBUG("D:Dimensiones de overview incorrectas: %s", levelfilename.c_str());
+      Image::Close(pimage);
+      return NULL;
+   }
+   return pimage;
+}
+
+/** Cantidad de niveles disponibles */
+int ImageOverviews::GetLevelCount() const {
+   return static_cast<int>(levels_.size());
+}
+
+/** Factor de reduccion del nivel */
+int ImageOverviews::GetLevelFactor(int Level) const {
+   return levels_.at(Level).factor_;
+}
+
+/**
+ * @param[in] Level nivel (0 es el de mayor resolucion)
+ * @param[out] SizeX columnas del nivel
+ * @param[out] SizeY filas del nivel
+ */
+void ImageOverviews::GetLevelSize(int Level, int &SizeX, int &SizeY) const {
+   SizeX = levels_.at(Level).sizeX_;
+   SizeY = levels_.at(Level).sizeY_;
+}
+
+/**
+ * Busca el nivel de menor resolucion cuyas dimensiones son mayores o iguales
+ * a las pedidas (una dimension en cero no se tiene en cuenta).
+ * @param[in] SizeX columnas deseadas
+ * @param[in] SizeY filas deseadas
+ * @return nivel seleccionado o -1 si se debe usar la imagen original
+ */
+int ImageOverviews::SelectLevel(int SizeX, int SizeY) const {
+   if (SizeX <= 0 && SizeY <= 0) {
+      return -1;
+   }
+   for (int level = GetLevelCount() - 1; level >= 0; --level) {
+      if (levels_[level].sizeX_ >= SizeX && levels_[level].sizeY_ >= SizeY) {
+         return level;
+      }
+   }
+   return -1;
+}
+
+/**
+ * @param[in] SizeX columnas del nivel
+ * @param[in] SizeY filas del nivel
+ * @return nivel con esas dimensiones o -1 si no existe
+ */
+int ImageOverviews::FindLevel(int SizeX, int SizeY) const {
+   for (int level = 0; level < GetLevelCount(); ++level) {
+      if (levels_[level].sizeX_ == SizeX && levels_[level].sizeY_ == SizeY) {
+         return level;
+      }
+   }
+   return -1;
+}
+
+/**
+ * @param[in] Level nivel
+ * @param[in] Band indice de banda
+ * @return banda del nivel o NULL si no existe
+ */
+RasterBand* ImageOverviews::GetBand(int Level, int Band) {
+   if (Level < 0 || Level >= GetLevelCount()
+         || Band >= levels_[Level].pImage_->GetBandCount()) {
+      return NULL;
+   }
+   return levels_[Level].pImage_->GetBand(Band);
+}
+
+}  // namespace suri
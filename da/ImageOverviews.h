@@ -0,0 +1,95 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef IMAGEOVERVIEWS_H_
+#define IMAGEOVERVIEWS_H_
+
+// Includes standard
+#include <string>
+#include <vector>
+
+/** namespace suri */
+namespace suri {
+
+class Image;
+class RasterBand;
+
+/** Niveles de resolucion reducida (piramide) almacenados junto a una imagen */
+/**
+ *  Administra los archivos asociados (sidecar) generados por OverviewBuilder
+ * para imagenes cuyo formato no soporta overviews propios (ej. RawImage).
+ * Cada nivel se guarda en un GeoTiff cuyo nombre se obtiene con
+ * GetLevelFilename y tiene un factor de reduccion potencia de dos.
+ *  Los niveles se buscan y abren en modo lectura al construir la instancia.
+ * Un nivel modificado antes que la imagen original o cuyas dimensiones no se
+ * corresponden con las de la imagen esta desactualizado y no se usa.
+ */
+class ImageOverviews {
+   /** Ctor. de Copia. */
+   ImageOverviews(const ImageOverviews &ImageOverviews);
+
+public:
+   /** Ctor */
+   ImageOverviews(const std::string &Filename, int SizeX, int SizeY);
+   /** Dtor */
+   ~ImageOverviews();
+   /** Nombre del archivo que contiene el nivel con el factor indicado */
+   static std::string GetLevelFilename(const std::string &Filename, int Factor);
+   /** Indica si el nivel con el factor indicado existe y esta actualizado */
+   static bool IsLevelUpToDate(const std::string &Filename, int Factor, int SizeX,
+                               int SizeY);
+   /** Cantidad de niveles disponibles */
+   int GetLevelCount() const;
+   /** Factor de reduccion del nivel */
+   int GetLevelFactor(int Level) const;
+   /** Dimensiones del nivel */
+   void GetLevelSize(int Level, int &SizeX, int &SizeY) const;
+   /** Nivel mas chico que cubre las dimensiones pedidas */
+   int SelectLevel(int SizeX, int SizeY) const;
+   /** Nivel con las dimensiones indicadas */
+   int FindLevel(int SizeX, int SizeY) const;
+   /** Banda del nivel */
+   RasterBand* GetBand(int Level, int Band);
+
+private:
+   /** Abre el nivel si existe y esta actualizado */
+   static Image* OpenLevel(const std::string &Filename, int Factor, int SizeX, int SizeY);
+
+   /** Datos de un nivel */
+   struct OverviewLevel {
+      int factor_; /*! factor de reduccion */
+      int sizeX_; /*! columnas del nivel */
+      int sizeY_; /*! filas del nivel */
+      Image *pImage_; /*! imagen del nivel */
+   };
+   std::string filename_; /*! archivo de la imagen original */
+   std::vector<OverviewLevel> levels_; /*! niveles de mayor a menor resolucion */
+};
+
+}  // namespace suri
+
+#endif /* IMAGEOVERVIEWS_H_ */
@@ -0,0 +1,221 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+// Includes Estandar
+#ifdef __WINDOWS__
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Includes Suri
+#include "MemoryMappedFile.h"
+
+// Includes Wx
+// Defines
+// forwards
+
+namespace suri {
+namespace core {
+namespace raster {
+namespace dataaccess {
+namespace driver {
+
+/** ctor **/
+MemoryMappedFile::MemoryMappedFile() :
+#ifdef __WINDOWS__
+      hFile_(INVALID_HANDLE_VALUE), hMapping_(NULL),
+#else
+      fd_(-1),
+#endif
+      pView_(NULL), viewOffset_(0), viewSize_(0), fileSize_(0) {
+}
+
+/** dtor **/
+MemoryMappedFile::~MemoryMappedFile() {
+   Close();
+}
+
+/**
+ * Abre el archivo en modo lectura. No mapea ninguna region hasta que se
+ * solicite mediante GetView.
+ * @param[in] FileName ruta del archivo
+ * @return true si pudo abrir el archivo
+ */
+bool MemoryMappedFile::Open(const std::string& FileName) {
+   Close();
+#ifdef __WINDOWS__
+   hFile_ = CreateFileA(FileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                        NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+   if (hFile_ == INVALID_HANDLE_VALUE)
+      return false;
+   LARGE_INTEGER size;
+   if (!GetFileSizeEx(hFile_, &size) || size.QuadPart == 0) {
+      Close();
+      return false;
+   }
+   fileSize_ = static_cast<OffsetType>(size.QuadPart);
+   hMapping_ = CreateFileMappingA(hFile_, NULL, PAGE_READONLY, 0, 0, NULL);
+   if (hMapping_ == NULL) {
+      Close();
+      return false;
+   }
+#else
+   fd_ = open(FileName.c_str(), O_RDONLY);
+   if (fd_ < 0)
+      return false;
+   struct stat filestat;
+   if (fstat(fd_, &filestat) != 0 || filestat.st_size == 0) {
+      Close();
+      return false;
+   }
+   fileSize_ = static_cast<OffsetType>(filestat.st_size);
+#endif
+   return true;
+}
+
+/** Libera la vista y cierra el archivo **/
+void MemoryMappedFile::Close() {
+   UnmapView();
+#ifdef __WINDOWS__
+   if (hMapping_ != NULL)
+      CloseHandle(hMapping_);
+   if (hFile_ != INVALID_HANDLE_VALUE)
+      CloseHandle(hFile_);
+   hMapping_ = NULL;
+   hFile_ = INVALID_HANDLE_VALUE;
+#else
+   if (fd_ >= 0)
+      close(fd_);
+   fd_ = -1;
+#endif
+   fileSize_ = 0;
+}
+
+/** Indica si el archivo se encuentra abierto **/
+bool MemoryMappedFile::IsOpen() const {
+#ifdef __WINDOWS__
+   return hMapping_ != NULL;
+#else
+   return fd_ >= 0;
+#endif
+}
+
+/** Retorna el tamanio del archivo en bytes **/
+MemoryMappedFile::OffsetType MemoryMappedFile::GetSize() const {
+   return fileSize_;
+}
+
+/**
+ * Retorna un puntero a la region [Offset, Offset + Length) del archivo.
+ * Si la region no se encuentra dentro de la ventana mapeada actual se
+ * desplaza la ventana.
+ * @param[in] Offset desplazamiento en bytes desde el comienzo del archivo
+ * @param[in] Length cantidad de bytes requeridos
+ * @return puntero a los datos, NULL si la region excede el archivo.
+ * \attention el puntero es valido hasta la proxima llamada a GetView o Close
+ */
+const char* MemoryMappedFile::GetView(OffsetType Offset, size_t Length) {
+   if (!IsOpen() || Length == 0 || Offset + Length > fileSize_)
+      return NULL;
+   if (!pView_ || Offset < viewOffset_ || Offset + Length > viewOffset_ + viewSize_) {
+      if (!MapView(Offset, Length))
+         return NULL;
+   }
+   return pView_ + (Offset - viewOffset_);
+}
+
+/**
+ * Mapea una ventana alineada a la granularidad del sistema que contiene a
+ * la region solicitada. La ventana tiene como minimo DefaultViewSize bytes
+ * (salvo que el archivo termine antes).
+ * @param[in] Offset desplazamiento de la region requerida
+ * @param[in] Length tamanio de la region requerida
+ * @return true si pudo mapear la ventana
+ */
+bool MemoryMappedFile::MapView(OffsetType Offset, size_t Length) {
+   UnmapView();
+   OffsetType granularity = GetGranularity();
+   OffsetType start = (Offset / granularity) * granularity;
+   OffsetType size = Offset - start + Length;
+   if (size < DefaultViewSize)
+      size = DefaultViewSize;
+   if (start + size > fileSize_)
+      size = fileSize_ - start;
+#ifdef __WINDOWS__
+   pView_ = static_cast<char*>(MapViewOfFile(hMapping_, FILE_MAP_READ,
+                                             static_cast<DWORD>(start >> 32),
+                                             static_cast<DWORD>(start & 0xFFFFFFFF),
+                                             static_cast<SIZE_T>(size)));
+   if (pView_ == NULL)
+      return false;
+#else
+   void* pview = mmap(NULL, static_cast<size_t>(size), PROT_READ, MAP_SHARED, fd_,
+                      static_cast<off_t>(start));
+   if (pview == MAP_FAILED)
+      return false;
+   pView_ = static_cast<char*>(pview);
+#endif
+   viewOffset_ = start;
+   viewSize_ = static_cast<size_t>(size);
+   return true;
+}
+
+/** Libera la ventana mapeada **/
+void MemoryMappedFile::UnmapView() {
+   if (!pView_)
+      return;
+#ifdef __WINDOWS__
+   UnmapViewOfFile(pView_);
+#else
+   munmap(pView_, viewSize_);
+#endif
+   pView_ = NULL;
+   viewOffset_ = 0;
+   viewSize_ = 0;
+}
+
+/** Granularidad con la que deben alinearse los offsets de mapeo **/
+size_t MemoryMappedFile::GetGranularity() {
+#ifdef __WINDOWS__
+   SYSTEM_INFO info;
+   GetSystemInfo(&info);
+   return info.dwAllocationGranularity;
+#else
+   return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+}  /** namespace driver **/
+}  /** namespace dataaccess **/
+}  /** namespace raster **/
+}  /** namespace core **/
+} /** namespace suri */
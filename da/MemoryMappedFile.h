@@ -0,0 +1,104 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef MEMORYMAPPEDFILE_H_
+#define MEMORYMAPPEDFILE_H_
+
+// Includes Estandar
+#include <string>
+#include <cstddef>
+
+// Includes Suri
+// Includes Wx
+// Defines
+// forwards
+
+namespace suri {
+namespace core {
+namespace raster {
+namespace dataaccess {
+namespace driver {
+
+/**
+ *  Vista de solo lectura de un archivo mapeado en memoria.
+ *  No mapea el archivo completo sino una ventana (alineada a la granularidad
+ *  del sistema) que se desplaza a medida que se solicitan nuevas regiones.
+ *  De esta forma es posible acceder a archivos mas grandes que el espacio
+ *  de direcciones o la memoria fisica disponible.
+ */
+class MemoryMappedFile {
+   /** ctor copia **/
+   MemoryMappedFile(const MemoryMappedFile&);
+   /** operador asignacion **/
+   MemoryMappedFile& operator=(const MemoryMappedFile&);
+
+public:
+   /** Tipo para los desplazamientos dentro del archivo (64 bits) **/
+   typedef unsigned long long OffsetType;
+   /** ctor **/
+   MemoryMappedFile();
+   /** dtor **/
+   ~MemoryMappedFile();
+   /** Abre el archivo en modo lectura **/
+   bool Open(const std::string& FileName);
+   /** Libera la vista y cierra el archivo **/
+   void Close();
+   /** Indica si el archivo se encuentra abierto **/
+   bool IsOpen() const;
+   /** Retorna el tamanio del archivo en bytes **/
+   OffsetType GetSize() const;
+   /** Retorna un puntero a Length bytes a partir de Offset **/
+   const char* GetView(OffsetType Offset, size_t Length);
+
+private:
+   /** Mapea una ventana que contenga la region solicitada **/
+   bool MapView(OffsetType Offset, size_t Length);
+   /** Libera la ventana mapeada **/
+   void UnmapView();
+   /** Granularidad con la que deben alinearse los offsets de mapeo **/
+   static size_t GetGranularity();
+   /** Tamanio por defecto de la ventana mapeada **/
+   static const size_t DefaultViewSize = 64 * 1024 * 1024;
+#ifdef __WINDOWS__
+   void* hFile_; /*! handle del archivo */
+   void* hMapping_; /*! handle del objeto de mapeo */
+#else
+   int fd_; /*! descriptor del archivo */
+#endif
+   char* pView_; /*! comienzo de la ventana mapeada */
+   OffsetType viewOffset_; /*! offset en el archivo de la ventana */
+   size_t viewSize_; /*! tamanio de la ventana */
+   OffsetType fileSize_; /*! tamanio del archivo */
+};
+
+}  /** namespace driver **/
+}  /** namespace dataaccess **/
+}  /** namespace raster **/
+}  /** namespace core **/
+} /** namespace suri */
+
+#endif /* MEMORYMAPPEDFILE_H_ */
@@ -0,0 +1,237 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#include "suri/OverviewBuilder.h"
+
+// Includes standard
+#include <cstdio>
+#include <algorithm>
+
+// Includes suri
+#include "suri/Image.h"
+#include "suri/DataTypes.h"
+#include "suri/Progress.h"
+#include "suri/messages.h"
+#include "ImageOverviews.h"
+#ifdef __GDAL__
+#include "GdalImage.h"
+#endif
+
+/** Dimension minima (en pixeles) del menor nivel sugerido */
+#define MIN_OVERVIEW_SIZE 256
+/** Tamanio aproximado en bytes de cada franja de lectura */
+#define OVERVIEW_STRIP_SIZE (4 * 1024 * 1024)
+/** Formato de los archivos de overview */
+#define OVERVIEW_FORMAT "GTiff"
+
+/** namespace suri */
+namespace suri {
+
+/** Template de promediado de bloques */
+/**
+ *  Reduce una franja de SrcX x SrcLines pixeles promediando bloques de
+ * Ratio x Ratio. Los bloques del borde que exceden la franja se promedian
+ * con los pixeles disponibles.
+ * \pre pDest debe tener DestX * ceil(SrcLines / Ratio) tamanio reservado
+ * @param[out] pDest datos reducidos
+ * @param[in] pSrc datos de la franja fuente
+ * @param[in] SrcX columnas de la fuente
+ * @param[in] SrcLines lineas de la franja fuente
+ * @param[in] DestX columnas del destino
+ * @param[in] Ratio factor de reduccion
+ */
+template<typename T>
+void averageblock(void* pDest, void* pSrc, int SrcX, int SrcLines, int DestX,
+                  int Ratio) {
+   T* pdest = static_cast<T*>(pDest);
+   T* psrc = static_cast<T*>(pSrc);
+   for (int y = 0, desty = 0; y < SrcLines; y += Ratio, ++desty) {
+      int lastline = std::min(y + Ratio, SrcLines);
+      for (int destx = 0; destx < DestX; ++destx) {
+         int x = destx * Ratio;
+         int lastcolumn = std::min(x + Ratio, SrcX);
+         double sum = 0;
+         for (int line = y; line < lastline; ++line)
+            for (int column = x; column < lastcolumn; ++column)
+               sum += psrc[static_cast<size_t>(line) * SrcX + column];
+         sum /= (lastline - y) * (lastcolumn - x);
+         pdest[static_cast<size_t>(desty) * DestX + destx] = static_cast<T>(sum);
+      }
+   }
+}
+
+/** Tipo de las funciones de promediado */
+typedef void (*AverageBlockFunc)(void*, void*, int, int, int, int);
+
+/** Inicializa mapa de tipos de datos. */
+INITIALIZE_DATATYPE_MAP(AverageBlockFunc, averageblock);
+
+/**
+ * @param[in] pImage imagen de la que se generan los niveles
+ */
+OverviewBuilder::OverviewBuilder(Image *pImage) :
+      pImage_(pImage) {
+}
+
+/** Dtor */
+OverviewBuilder::~OverviewBuilder() {
+}
+
+/**
+ * Genera factores 2, 4, 8, ... mientras el nivel resultante tenga al menos
+ * MIN_OVERVIEW_SIZE pixeles en su mayor dimension.
+ * @param[in] SizeX columnas de la imagen
+ * @param[in] SizeY filas de la imagen
+ * @return factores de reduccion sugeridos
+ */
+std::vector<int> OverviewBuilder::GetDefaultFactors(int SizeX, int SizeY) {
+   std::vector<int> factors;
+   int size = std::max(SizeX, SizeY);
+   for (int factor = 2; size / factor >= MIN_OVERVIEW_SIZE; factor *= 2)
+      factors.push_back(factor);
+   return factors;
+}
+
+/**
+ *  Para imagenes GDAL alcanza con que tengan overviews actualizados
+ * (GdalImage::HasOverviews). Para el resto se verifican los archivos
+ * asociados de factores 2, 4, ... hasta el mayor pedido.
+ * @param[in] Factors factores de reduccion
+ * @return true si no hace falta generar los niveles
+ */
+bool OverviewBuilder::IsUpToDate(const std::vector<int> &Factors) const {
+   if (!pImage_ || Factors.empty())
+      return true;
+#ifdef __GDAL__
+   GdalImage *pgdalimage = dynamic_cast<GdalImage*>(pImage_);
+   if (pgdalimage)
+      return pgdalimage->HasOverviews();
+#endif
+   std::string filename = pImage_->GetOption("filename");
+   int sizex = 0, sizey = 0;
+   pImage_->GetSize(sizex, sizey);
+   int maxfactor = *std::max_element(Factors.begin(), Factors.end());
+   for (int factor = 2; factor <= maxfactor; factor *= 2)
+      if (!ImageOverviews::IsLevelUpToDate(filename, factor, sizex, sizey))
+         return false;
+   return true;
+}
+
+/**
+ * Genera los niveles indicados. Los archivos asociados se generan en cascada
+ * (cada nivel a partir del anterior) con factores 2, 4, ... hasta el mayor
+ * factor pedido, ya que ImageOverviews requiere niveles consecutivos.
+ * @param[in] Factors factores de reduccion
+ * @return true si pudo generar todos los niveles
+ */
+bool OverviewBuilder::Build(const std::vector<int> &Factors) {
+   if (!pImage_ || Factors.empty())
+      return false;
+#ifdef __GDAL__
+   GdalImage *pgdalimage = dynamic_cast<GdalImage*>(pImage_);
+   if (pgdalimage)
+      return pgdalimage->BuildOverviews(Factors);
+#endif
+   std::string filename = pImage_->GetOption("filename");
+   if (filename.empty())
+      return false;
+   int maxfactor = *std::max_element(Factors.begin(), Factors.end());
+   Image *psource = pImage_;
+   bool success = true;
+   for (int factor = 2; success && factor <= maxfactor; factor *= 2) {
+      std::string levelfilename = ImageOverviews::GetLevelFilename(filename, factor);
+      success = BuildLevel(psource, 2, levelfilename);
+      if (psource != pImage_)
+         Image::Close(psource);
+      psource = success ? Image::Open(levelfilename) : NULL;
+      success = success && psource;
+   }
+   if (psource != pImage_)
+      Image::Close(psource);
+   return success;
+}
+
+/**
+ * Genera un nivel recorriendo la fuente en franjas de aproximadamente
+ * OVERVIEW_STRIP_SIZE bytes por banda. Si falla o se cancela elimina el
+ * archivo parcial.
+ * @param[in] pSource imagen fuente
+ * @param[in] Ratio factor de reduccion respecto de la fuente
+ * @param[in] Filename archivo de salida
+ * @return true si pudo generar el nivel
+ */
+bool OverviewBuilder::BuildLevel(Image *pSource, int Ratio,
+                                 const std::string &Filename) {
+   std::string datatype = pSource->GetDataType();
+   AverageBlockFunc paverage = averageblockTypeMap[datatype];
+   int srcx = 0, srcy = 0;
+   pSource->GetSize(srcx, srcy);
+   int bandcount = pSource->GetBandCount();
+   int datasize = SizeOf(datatype);
+   if (!paverage || srcx <= 0 || srcy <= 0 || bandcount <= 0 || datasize <= 0)
+      return false;
+   int outx = (srcx + Ratio - 1) / Ratio;
+   int outy = (srcy + Ratio - 1) / Ratio;
+   Image *pout = Image::Open(Filename, Image::WriteOnly, OVERVIEW_FORMAT, bandcount,
+                             outx, outy, datatype);
+   if (!pout)
+      return false;
+   // franja de salida de lineas completas multiplo del factor en la fuente
+   int striplines = std::max(1, OVERVIEW_STRIP_SIZE / (srcx * datasize * Ratio));
+   striplines = std::min(striplines, outy);
+   std::vector<int> bands(bandcount);
+   std::vector<void*> srcdata(bandcount), outdata(bandcount);
+   for (int b = 0; b < bandcount; ++b) {
+      bands[b] = b;
+      srcdata[b] = new char[static_cast<size_t>(srcx) * striplines * Ratio * datasize];
+      outdata[b] = new char[static_cast<size_t>(outx) * striplines * datasize];
+   }
+   Progress progress((outy + striplines - 1) / striplines,
+                     _(message_BUILDING_OVERVIEWS));
+   bool success = true;
+   for (int line = 0; success && line < outy; line += striplines) {
+      int lines = std::min(striplines, outy - line);
+      int srculy = line * Ratio;
+      int srclry = std::min(srculy + lines * Ratio, srcy);
+      success = pSource->Read(bands, srcdata, 0, srculy, srcx, srclry);
+      for (int b = 0; success && b < bandcount; ++b)
+         paverage(outdata[b], srcdata[b], srcx, srclry - srculy, outx, Ratio);
+      if (success)
+         pout->Write(bands, outdata, 0, line, outx, line + lines);
+      success = success && !progress.Update();
+   }
+   for (int b = 0; b < bandcount; ++b) {
+      delete[] static_cast<char*>(srcdata[b]);
+      delete[] static_cast<char*>(outdata[b]);
+   }
+   Image::Close(pout);
+   if (!success)
+      remove(Filename.c_str());
+   return success;
+}
+
+}  // namespace suri
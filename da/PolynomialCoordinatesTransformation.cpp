@@ -137,38 +137,20 @@ int PolynomialCoordinatesTransformation::Transform(std::vector<Coordinates> &Coo
          && pCurrentTransformationInverseArgument_ != NULL) {
       std::vector<Coordinates> origin(CoordinatesVector);
       CoordinatesVector.clear();
-      
-      for (size_t index = 0, len = origin.size(); index < len; ++index) {
-#ifdef __UNUSED_CODE__
-         double temporalcoordinatex = 0.0;
-         double temporalcoordinatey = 0.0;
-         int currentcoefficientindex = 0;
-
-         for (int ix = 0; ix <= polynomialOrder_; ++ix) {
-            for (int jx = 0; jx <= ix; ++jx) {
-               temporalcoordinatex += currentCoefficients_[currentcoefficientindex].x_
-                     * pow(origin[index].x_, ix - jx) * pow(origin[index].y_, jx);
-               temporalcoordinatey += currentCoefficients_[currentcoefficientindex].y_
-                     * pow(origin[index].x_, ix - jx) * pow(origin[index].y_, jx);
-               ++currentcoefficientindex;
-            }
-         }
-         
-         CoordinatesP.push_back(Coordinates(temporalcoordinatex, temporalcoordinatey));
-#endif
-         double x = origin.at(index).x_, y =
-               origin.at(index).y_, z = origin.at(index).z_;
-         int result = 0;
-         int desttosrc = !Inverse ? TRUE : FALSE;
-         if (!Inverse) {
-            GDALGCPTransform(pCurrentTransformationDirectArgument_,
-                             desttosrc, 1, &x, &y, &z, &result);
-         } else {
-            GDALGCPTransform(pCurrentTransformationInverseArgument_,
-                             desttosrc, 1, &x, &y, &z, &result);
-         }
-         if (result != 0) {
-            Coordinates transfcoord(x, y, z);
+      size_t len = origin.size();
+      if (len == 0)
+         return 0;
+
+      std::vector<double> x(len), y(len);
+      std::vector<int> success(len);
+      for (size_t index = 0; index < len; ++index) {
+         x[index] = origin[index].x_;
+         y[index] = origin[index].y_;
+      }
+      Transform(&x[0], &y[0], len, Inverse, &success[0]);
+      for (size_t index = 0; index < len; ++index) {
+         if (success[index] != 0) {
+            Coordinates transfcoord(x[index], y[index], origin[index].z_);
             CoordinatesVector.push_back(transfcoord);
          }
       }
@@ -177,6 +159,46 @@ int PolynomialCoordinatesTransformation::Transform(std::vector<Coordinates> &Coo
    return 0;
 }
 
+/**
+ * Realiza una transformacion polinomica de arreglos de coordenadas con una
+ * sola llamada a GDALGCPTransform.
+ *
+ * @param[in,out] pX Coordenadas x.
+ * @param[in,out] pY Coordenadas y.
+ * @param[in] Count Cantidad de puntos.
+ * @param[in] Inverse Indica si se debe hacer la transformacion inversa.
+ * @param[out] pSuccess (opcional) Indica por punto si se transformo. Los
+ * puntos que no se transforman conservan su valor.
+ * @return Cantidad de coordenadas transformadas.
+ */
+int PolynomialCoordinatesTransformation::Transform(double* pX, double* pY, int Count,
+                                                   bool Inverse, int* pSuccess) const {
+   if (!IsOk() || pCurrentTransformationDirectArgument_ == NULL
+         || pCurrentTransformationInverseArgument_ == NULL || Count <= 0) {
+      for (int index = 0; pSuccess && index < Count; ++index)
+         pSuccess[index] = 0;
+      return 0;
+   }
+
+   std::vector<double> x(pX, pX + Count), y(pY, pY + Count), z(Count, 0.0);
+   std::vector<int> success(Count, 0);
+   int desttosrc = !Inverse ? TRUE : FALSE;
+   GDALGCPTransform(!Inverse ? pCurrentTransformationDirectArgument_ :
+                               pCurrentTransformationInverseArgument_,
+                    desttosrc, Count, &x[0], &y[0], &z[0], &success[0]);
+   int result = 0;
+   for (int index = 0; index < Count; ++index) {
+      if (success[index] != 0) {
+         pX[index] = x[index];
+         pY[index] = y[index];
+         ++result;
+      }
+      if (pSuccess)
+         pSuccess[index] = success[index] != 0 ? 1 : 0;
+   }
+   return result;
+}
+
 /**
  * Realiza una transformacion polinomica de las coordenadas en el formato de
  * origen al formato de salida utilizando como salida un Subset.
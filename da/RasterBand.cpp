@@ -123,6 +123,44 @@ void RasterBand::SetSizeY(const int Size) {
    SetSize(sizeX_, Size);
 }
 
+/**
+ *  Por defecto los buffers de GetBlock no requieren devolucion.
+ * @param[in] BlockX numero de columna del bloque
+ * @param[in] BlockY numero de fila del bloque
+ */
+void RasterBand::ReleaseBlock(int BlockX, int BlockY) {
+}
+
+/**
+ *  Por defecto la banda no presta sus buffers internos.
+ * @param[in] BlockX numero de columna del bloque
+ * @param[in] BlockY numero de fila del bloque
+ * @return NULL
+ */
+void* RasterBand::LockBlock(int BlockX, int BlockY) {
+   return NULL;
+}
+
+/**
+ * @param[in] BlockX numero de columna del bloque
+ * @param[in] BlockY numero de fila del bloque
+ * @param[in] Modified indica si se escribio en el bloque prestado
+ */
+void RasterBand::UnlockBlock(int BlockX, int BlockY, bool Modified) {
+}
+
+/**
+ *  Las bandas sin cache de bloques leen siempre de su fuente.
+ * @param[in] Ulx upper left x del subset
+ * @param[in] Uly upper left y del subset
+ * @param[in] Lrx lower right x del subset
+ * @param[in] Lry lower right y del subset
+ * @return false
+ */
+bool RasterBand::HasCachedBlocks(int Ulx, int Uly, int Lrx, int Lry) {
+   return false;
+}
+
 // ----------------------------- BLOQUE -----------------------------
 /**
  * Tamanio del bloque X e Y
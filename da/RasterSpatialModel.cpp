@@ -39,6 +39,30 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "suri/Wkt.h"
 #include "suri/Dimension.h"
 
+namespace {
+
+/**
+ * Aplica un modelo afin de 6 coeficientes a arreglos de coordenadas.
+ * Las componentes estan separadas y los coeficientes en variables locales
+ * para que el compilador pueda vectorizar el ciclo.
+ * @param[in] pModel Coeficientes del modelo (formato geotransform)
+ * @param[in,out] pX Coordenadas x
+ * @param[in,out] pY Coordenadas y
+ * @param[in] Count Cantidad de coordenadas
+ */
+void TransformAffine(const double* pModel, double* pX, double* pY, size_t Count) {
+   const double a0 = pModel[0], a1 = pModel[1], a2 = pModel[2];
+   const double b0 = pModel[3], b1 = pModel[4], b2 = pModel[5];
+   for (size_t i = 0; i < Count; ++i) {
+      double x = pX[i];
+      double y = pY[i];
+      pX[i] = a0 + x * a1 + y * a2;
+      pY[i] = b0 + x * b1 + y * b2;
+   }
+}
+
+}  // namespace
+
 /** namespace suri */
 namespace suri {
 /** Ctor */
@@ -474,9 +498,27 @@ void RasterSpatialModel::Transform(Subset &SubsetInOut) const {
  * @param[out] InOut Vector con transformadas por el modelo
  */
 void RasterSpatialModel::Transform(std::vector<Coordinates> &InOut) const {
+   assert(transformModel2d_.size()==6);
+   const double* pmodel = &transformModel2d_[0];
    size_t totalcoord = InOut.size();
-   for (size_t i = 0; i < totalcoord; i++)
-      Transform(InOut[i]);
+   for (size_t i = 0; i < totalcoord; i++) {
+      double x = InOut[i].x_;
+      double y = InOut[i].y_;
+      InOut[i].x_ = pmodel[0] + x * pmodel[1] + y * pmodel[2];
+      InOut[i].y_ = pmodel[3] + x * pmodel[4] + y * pmodel[5];
+   }
+}
+
+/**
+ * Transforma arreglos de coordenadas de P-L a X-Y. Los coeficientes se leen
+ * una sola vez para que el ciclo pueda vectorizarse.
+ * @param[in,out] pX Coordenadas x (pixel) a transformar
+ * @param[in,out] pY Coordenadas y (linea) a transformar
+ * @param[in] Count Cantidad de coordenadas
+ */
+void RasterSpatialModel::Transform(double* pX, double* pY, size_t Count) const {
+   assert(transformModel2d_.size()==6);
+   TransformAffine(&transformModel2d_[0], pX, pY, Count);
 }
 
 /** Transforma de X-Y a P-L */
@@ -509,9 +551,27 @@ Subset RasterSpatialModel::InverseTransform(const Subset& SubsetIn) const {
  * @param[out] InOut Vector con transformadas por el modelo inverso
  */
 void RasterSpatialModel::InverseTransform(std::vector<Coordinates> &InOut) const {
+   assert(inverseTransformModel2d_.size()==6);
+   const double* pmodel = &inverseTransformModel2d_[0];
    size_t totalcoord = InOut.size();
-   for (size_t i = 0; i < totalcoord; i++)
-      InverseTransform(InOut[i]);
+   for (size_t i = 0; i < totalcoord; i++) {
+      double x = InOut[i].x_;
+      double y = InOut[i].y_;
+      InOut[i].x_ = pmodel[0] + x * pmodel[1] + y * pmodel[2];
+      InOut[i].y_ = pmodel[3] + x * pmodel[4] + y * pmodel[5];
+   }
+}
+
+/**
+ * Transforma arreglos de coordenadas de X-Y a P-L.
+ * @param[in,out] pX Coordenadas x a transformar
+ * @param[in,out] pY Coordenadas y a transformar
+ * @param[in] Count Cantidad de coordenadas
+ */
+void RasterSpatialModel::InverseTransform(double* pX, double* pY,
+                                          size_t Count) const {
+   assert(inverseTransformModel2d_.size()==6);
+   TransformAffine(&inverseTransformModel2d_[0], pX, pY, Count);
 }
 
 /** */
@@ -29,6 +29,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include <string>
 #include <map>
 #include <utility>
+#include <vector>
 
 // Includes Suri
 #include "suri/DataTypes.h"
@@ -37,6 +38,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "BipRasterDriver.h"
 #include "BsqRasterDriver.h"
 #include "BilRasterDriver.h"
+#include "ImageOverviews.h"
 // Includes Wx
 // Defines
 // forwards
@@ -48,11 +50,12 @@ namespace dataaccess {
 
 std::map<std::string, int> RawImage::DataTypes_;
 /** ctor **/
-RawImage::RawImage() {
+RawImage::RawImage() : pOverviews_(NULL) {
 }
 
 /** dtor **/
 RawImage::~RawImage() {
+   delete pOverviews_;
 }
 
 /** Inicializacion de la clase */
@@ -81,11 +84,14 @@ Image* RawImage::Load(const std::string &Filename, ImageAccessType ImageAccess,
    pWriter_ = GetDriver(GetOption(Mux), Filename, SizeX, SizeY);
    pWriter_->SetBandCount(BandCount);
    pWriter_->SetDataType(DataType);
+   if (ImageAccess == ReadOnly)
+      pOverviews_ = new ImageOverviews(Filename, SizeX, SizeY);
    for (int b = 0; b < BandCount; ++b) {
       driver::RawRasterDriver* pdriver = GetDriver(GetOption(Mux), Filename, SizeX, SizeY);
       pdriver->SetDataType(DataType);
       pdriver->SetBandReaderIndex(b);
       pdriver->SetBandCount(BandCount);
+      pdriver->SetOverviews(pOverviews_);
       RasterBand* pband = RasterBand::Create(DataType, pdriver, this);
       if (pband) {
          bandVector_.push_back(pband);
@@ -95,6 +101,17 @@ Image* RawImage::Load(const std::string &Filename, ImageAccessType ImageAccess,
    return this;
 }
 
+/** Lee varias bandas recorriendo el archivo una sola vez (ver
+ *  RawRasterDriver::ReadBands). Todos los drivers de banda leen el mismo
+ *  archivo por lo que se utiliza el primero. **/
+bool RawImage::ReadInterleaved(const std::vector<int> &BandIndex,
+                               std::vector<void*> &Data, int Ulx, int Uly, int Lrx,
+                               int Lry) const {
+   driver::RawRasterDriver* pdriver = driverVector_.empty() ? NULL :
+         dynamic_cast<driver::RawRasterDriver*>(driverVector_.front());
+   return pdriver && pdriver->ReadBands(BandIndex, Data, Ulx, Uly, Lrx, Lry);
+}
+
 /** Inspecciona el archivo, para saber si es del formato que maneja */
 bool RawImage::Inspect(const std::string &Filename, ImageAccessType ImageAccess,
                        int BandCount, int SizeX, int SizeY,
@@ -0,0 +1,218 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+// Includes Estandar
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+// Includes Suri
+#include "suri/RawRasterDriver.h"
+#include "MemoryMappedFile.h"
+#include "ImageOverviews.h"
+#include "suri/RasterBand.h"
+
+// Includes Wx
+// Defines
+// forwards
+
+namespace suri {
+namespace core {
+namespace raster {
+namespace dataaccess {
+namespace driver {
+
+/** dtor **/
+RawRasterDriver::~RawRasterDriver() {
+   delete pFile_;
+   if (pSucesor_)
+      delete pSucesor_;
+}
+
+/**
+ * Cantidad de lineas de los bloques en los que se lee la banda. Se utilizan
+ * franjas del ancho de la imagen de aproximadamente StripSize bytes para
+ * evitar cargar la banda completa en memoria.
+ * @return cantidad de lineas por bloque
+ */
+int RawRasterDriver::GetStripHeight() const {
+   int linesize = npixels_ * SizeOf(dataType_);
+   if (linesize <= 0 || nlines_ <= 0)
+      return nlines_;
+   return std::max(1, std::min(nlines_, StripSize / linesize));
+}
+
+/**
+ * Copia al buffer la ventana [Ulx, Lrx) x [Uly, Lry) de la banda. Cada linea
+ * se obtiene directamente de la vista mapeada aplicando los offsets de
+ * archivo, banda y linea configurados (ver GetLineOffset); si los pixeles de
+ * la banda no son contiguos (BIP) se copian con el paso GetPixelStride.
+ * Las lineas o columnas que exceden la imagen no se modifican.
+ * @param[out] pBuffer buffer con memoria reservada para la ventana
+ * @param[in] Ulx columna inicial
+ * @param[in] Uly linea inicial
+ * @param[in] Lrx columna final (no incluida)
+ * @param[in] Lry linea final (no incluida)
+ * @param[in] Band indice de la banda a leer
+ * @return true si pudo leer la ventana
+ */
+bool RawRasterDriver::ReadWindow(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry,
+                                 int Band) {
+   std::vector<int> bands(1, Band);
+   std::vector<void*> data(1, pBuffer);
+   return ReadWindows(bands, data, Ulx, Uly, Lrx, Lry);
+}
+
+/**
+ * Copia a los buffers la ventana [Ulx, Lrx) x [Uly, Lry) de las bandas
+ * indicadas. Recorre el archivo linea por linea y para cada una copia las
+ * muestras de todas las bandas, por lo que en BIL y BIP cada region del
+ * archivo se visita una unica vez.
+ * @param[in] BandIndex indices de las bandas a leer
+ * @param[out] Data buffers (uno por banda) con memoria reservada para la ventana
+ * @param[in] Ulx columna inicial
+ * @param[in] Uly linea inicial
+ * @param[in] Lrx columna final (no incluida)
+ * @param[in] Lry linea final (no incluida)
+ * @return true si pudo leer la ventana de todas las bandas
+ */
+bool RawRasterDriver::ReadWindows(const std::vector<int> &BandIndex,
+                                  std::vector<void*> &Data, int Ulx, int Uly, int Lrx,
+                                  int Lry) {
+   int width = Lrx - Ulx;
+   if (BandIndex.empty() || BandIndex.size() != Data.size() || width <= 0 || Lry <= Uly
+         || Ulx < 0 || Uly < 0)
+      return false;
+   for (size_t b = 0; b < BandIndex.size(); ++b)
+      if (!Data[b] || BandIndex[b] < 0)
+         return false;
+   MemoryMappedFile* pfile = GetFile();
+   if (!pfile)
+      return false;
+   size_t pixelsize = SizeOf(dataType_);
+   size_t stride = GetPixelStride();
+   int count = std::min(Lrx, npixels_) - Ulx;
+   int lastline = std::min(Lry, nlines_);
+   for (int line = Uly; count > 0 && line < lastline; ++line) {
+      size_t rowoffset = static_cast<size_t>(line - Uly) * width * pixelsize;
+      for (size_t b = 0; b < BandIndex.size(); ++b) {
+         char* prow = static_cast<char*>(Data[b]) + rowoffset;
+         unsigned long long offset = GetLineOffset(line, BandIndex[b]);
+         offset += static_cast<unsigned long long>(Ulx) * stride;
+         const char* psrc = pfile->GetView(offset, (count - 1) * stride + pixelsize);
+         if (!psrc)
+            return false;
+         if (stride == pixelsize) {
+            memcpy(prow, psrc, count * pixelsize);
+         } else {
+            for (int p = 0; p < count; ++p, prow += pixelsize, psrc += stride)
+               memcpy(prow, psrc, pixelsize);
+         }
+      }
+   }
+   return true;
+}
+
+/**
+ * Retorna un buffer nuevo con el contenido del bloque (franja) indicado.
+ * @param[in] BlockX numero de columna del bloque
+ * @param[in] BlockY numero de fila del bloque
+ * @return buffer con los datos (debe ser eliminado por quien lo solicita)
+ * o NULL en caso de error
+ */
+void* RawRasterDriver::ReadBlock(int BlockX, int BlockY) {
+   int sizex = 0, sizey = 0;
+   if (!DoGetBlockSize(sizex, sizey) || sizex <= 0 || sizey <= 0)
+      return NULL;
+   size_t blocksize = static_cast<size_t>(sizex) * sizey * SizeOf(dataType_);
+   char* pblock = new char[blocksize];
+   memset(pblock, 0, blocksize);
+   if (!ReadWindow(pblock, BlockX * sizex, BlockY * sizey, (BlockX + 1) * sizex,
+                   (BlockY + 1) * sizey, bandReaderIndex_)) {
+      delete[] pblock;
+      return NULL;
+   }
+   return pblock;
+}
+
+/**
+ * Carga el buffer con la ventana del nivel de overview seleccionado. Las
+ * coordenadas estan expresadas en pixeles del nivel.
+ */
+bool RawRasterDriver::ReadOverview(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry) {
+   RasterBand* pband = pOverviews_ ? pOverviews_->GetBand(ovlevel_, bandReaderIndex_) :
+                                     NULL;
+   return pband && pband->Read(pBuffer, Ulx, Uly, Lrx, Lry);
+}
+
+/**
+ * Obtiene el size recomendado teniendo en cuenta la existencia de overviews.
+ * Si ningun nivel cubre el tamanio pedido se recomienda la resolucion completa.
+ */
+void RawRasterDriver::CalcRecommendedSize(int XSize, int YSize, int& XRecomm,
+                                          int& YRecomm) {
+   RasterDriver::GetSize(XRecomm, YRecomm);
+   int level = pOverviews_ ? pOverviews_->SelectLevel(XSize, YSize) : -1;
+   if (level >= 0)
+      pOverviews_->GetLevelSize(level, XRecomm, YRecomm);
+}
+
+/**
+ * Establece el tamanio recomendado. Si coincide con el de algun nivel de
+ * overview las lecturas siguientes se realizan sobre ese nivel.
+ */
+void RawRasterDriver::SetRecommendedSize(int XRecomm, int YRecomm) {
+   RasterSource::SetRecommendedSize(XRecomm, YRecomm);
+   ovlevel_ = -1;
+   if (pOverviews_ && HasRecommendedSize())
+      ovlevel_ = pOverviews_->FindLevel(XRecomm, YRecomm);
+}
+
+/**
+ * Resetea el estado de los datos referidos a las dimensiones recomendadas.
+ */
+void RawRasterDriver::ResetRecommendedStatus() {
+   ovlevel_ = -1;
+}
+
+/** Abre (si es necesario) la vista mapeada del archivo **/
+MemoryMappedFile* RawRasterDriver::GetFile() {
+   if (!pFile_) {
+      pFile_ = new MemoryMappedFile;
+      if (!pFile_->Open(filename_)) {
+         delete pFile_;
+         pFile_ = NULL;
+      }
+   }
+   return pFile_;
+}
+
+}  /** namespace driver **/
+}  /** namespace dataaccess **/
+}  /** namespace raster **/
+}  /** namespace core **/
+} /** namespace suri */
@@ -0,0 +1,462 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+// Includes standard
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+
+// Includes suri
+#include "suri/Resampler.h"
+#include "suri/DataTypes.h"
+#include "suri/AuxiliaryFunctions.h"
+#include "suri/xmlnames.h"
+
+// Defines
+/** Muestras por pixel del nucleo tabulado que se usa al interpolar puntos */
+#define RESAMPLING_KERNEL_RESOLUTION 1024
+/** Radio maximo de los nucleos (Lanczos) */
+#define RESAMPLING_MAX_RADIUS 3
+/** Parametro del nucleo cubico de Keys */
+#define RESAMPLING_CUBIC_PARAMETER -0.5
+
+/** namespace suri */
+namespace suri {
+
+namespace {
+
+/** Nucleos tabulados para la interpolacion punto a punto */
+class KernelTable {
+public:
+   /** Ctor */
+   KernelTable() {
+      for (int type = Resampler::Bilinear; type <= Resampler::Lanczos; ++type) {
+         Resampler::ResamplingType resampling = static_cast<Resampler::ResamplingType>(type);
+         int samples = Resampler::GetRadius(resampling) * RESAMPLING_KERNEL_RESOLUTION + 1;
+         values_[type].resize(samples);
+         for (int ix = 0; ix < samples; ++ix)
+            values_[type][ix] = Resampler::GetWeight(
+                  resampling, static_cast<double>(ix) / RESAMPLING_KERNEL_RESOLUTION);
+      }
+   }
+   /** Peso del nucleo a una distancia */
+   double GetWeight(Resampler::ResamplingType Type, double Distance) const {
+      size_t ix = static_cast<size_t>(std::fabs(Distance) * RESAMPLING_KERNEL_RESOLUTION
+            + 0.5);
+      return ix < values_[Type].size() ? values_[Type][ix] : 0.0;
+   }
+
+private:
+   std::vector<double> values_[Resampler::Lanczos + 1]; /*! nucleo por tipo */
+};
+
+/** Nucleos tabulados (se calculan al cargar la biblioteca) */
+const KernelTable kernelTable;
+
+/**
+ * Convierte el valor remuestreado al tipo de dato. Los enteros se
+ * redondean y saturan al rango del tipo.
+ * @param[in] Value valor remuestreado
+ * @return valor en el tipo de dato
+ */
+template<typename T>
+T resampledvalue(double Value) {
+   if (!std::numeric_limits<T>::is_integer)
+      return static_cast<T>(Value);
+   if (Value <= static_cast<double>(std::numeric_limits<T>::min()))
+      return std::numeric_limits<T>::min();
+   if (Value >= static_cast<double>(std::numeric_limits<T>::max()))
+      return std::numeric_limits<T>::max();
+   return static_cast<T>(std::floor(Value + 0.5));
+}
+
+/**
+ * Indice del peso mayor, que corresponde al pixel mas cercano al centro del
+ * nucleo.
+ * @param[in] pWeights pesos
+ * @param[in] Taps cantidad de pesos
+ * @return indice del peso mayor
+ */
+int nearesttap(const double* pWeights, int Taps) {
+   int nearest = 0;
+   for (int k = 1; k < Taps; ++k)
+      if (pWeights[k] > pWeights[nearest])
+         nearest = k;
+   return nearest;
+}
+
+/** seno cardinal normalizado */
+double sinc(double X) {
+   if (X == 0)
+      return 1;
+   double pix = M_PI * X;
+   return std::sin(pix) / pix;
+}
+
+}  // namespace
+
+/** Template resample */
+/**
+ *  Remuestrea las filas [FirstRow, LastRow) de una grilla regular en dos
+ * pasadas: primero aplica los pesos de columnas a cada fila de la fuente
+ * necesaria y luego combina esas filas con los pesos de filas.
+ *  Si el nucleo de un pixel de salida incluye algun pixel con el valor no
+ * valido (con peso distinto de cero) se usa el pixel mas cercano, para no
+ * inventar valores en los bordes de las areas sin datos.
+ * \pre pSrc debe contener las filas Rows.GetFirst(FirstRow) a
+ * Rows.GetFirst(LastRow - 1) + Rows.GetTapCount() y las columnas
+ * Columns.GetSourceBegin() a Columns.GetSourceEnd() de la fuente.
+ * @param[in] pSrc datos de la fuente
+ * @param[in] SrcWidth ancho (en pixeles) de una fila de pSrc
+ * @param[in] SrcX columna de la fuente del primer pixel de pSrc
+ * @param[in] SrcY fila de la fuente de la primer fila de pSrc
+ * @param[out] pDest datos remuestreados (Columns.GetSize() x Rows.GetSize())
+ * @param[in] Columns pesos de columnas
+ * @param[in] Rows pesos de filas
+ * @param[in] FirstRow primer fila de salida a calcular
+ * @param[in] LastRow fila de salida siguiente a la ultima a calcular
+ * @param[in] NoDataValueAvailable indica si hay valor no valido
+ * @param[in] NoDataValue valor no valido
+ */
+template<typename T>
+void resample(const void* pSrc, int SrcWidth, int SrcX, int SrcY, void* pDest,
+              const Resampler::WeightTable &Columns, const Resampler::WeightTable &Rows,
+              int FirstRow, int LastRow, bool NoDataValueAvailable, double NoDataValue) {
+   if (FirstRow >= LastRow || Columns.GetSize() == 0)
+      return;
+   const T* psrc = static_cast<const T*>(pSrc);
+   T* pdest = static_cast<T*>(pDest);
+   int destwidth = Columns.GetSize();
+   int coltaps = Columns.GetTapCount(), rowtaps = Rows.GetTapCount();
+   int colbegin = Columns.GetSourceBegin(), colend = Columns.GetSourceEnd();
+   int rowbegin = Rows.GetFirst(FirstRow), rowend = Rows.GetFirst(LastRow - 1) + rowtaps;
+   // Valor no valido convertido al tipo de dato
+   double nodatavalue = static_cast<double>(static_cast<T>(NoDataValue));
+   size_t horizontalsize = static_cast<size_t>(rowend - rowbegin) * destwidth;
+
+   // Pasada en X sobre las filas de la fuente. Con valor no valido se guarda
+   // tambien el pixel mas cercano y si el nucleo incluye el valor no valido.
+   std::vector<double> horizontal(horizontalsize);
+   std::vector<double> nearest(NoDataValueAvailable ? horizontalsize : 0);
+   std::vector<unsigned char> nodata(NoDataValueAvailable ? horizontalsize : 0);
+   std::vector<double> row(colend - colbegin);
+   for (int r = rowbegin; r < rowend; ++r) {
+      const T* psrcrow = psrc + static_cast<size_t>(r - SrcY) * SrcWidth
+            + (colbegin - SrcX);
+      for (int c = 0; c < colend - colbegin; ++c)
+         row[c] = psrcrow[c];
+      size_t rowoffset = static_cast<size_t>(r - rowbegin) * destwidth;
+      double* pout = &horizontal[rowoffset];
+      for (int i = 0; i < destwidth; ++i) {
+         const double* pweights = Columns.GetWeights(i);
+         const double* pvalues = &row[Columns.GetFirst(i) - colbegin];
+         double value = 0;
+         for (int k = 0; k < coltaps; ++k)
+            value += pweights[k] * pvalues[k];
+         pout[i] = value;
+      }
+      if (!NoDataValueAvailable)
+         continue;
+      for (int i = 0; i < destwidth; ++i) {
+         const double* pweights = Columns.GetWeights(i);
+         const double* pvalues = &row[Columns.GetFirst(i) - colbegin];
+         bool hasnodata = false;
+         for (int k = 0; k < coltaps && !hasnodata; ++k)
+            hasnodata = pweights[k] != 0 && pvalues[k] == nodatavalue;
+         nodata[rowoffset + i] = hasnodata;
+         nearest[rowoffset + i] = pvalues[nearesttap(pweights, coltaps)];
+      }
+   }
+
+   // Pasada en Y combinando filas completas
+   std::vector<double> accumulator(destwidth);
+   std::vector<unsigned char> usesnodata(destwidth);
+   for (int j = FirstRow; j < LastRow; ++j) {
+      const double* pweights = Rows.GetWeights(j);
+      std::fill(accumulator.begin(), accumulator.end(), 0.0);
+      std::fill(usesnodata.begin(), usesnodata.end(), 0);
+      for (int k = 0; k < rowtaps; ++k) {
+         size_t rowoffset = static_cast<size_t>(Rows.GetFirst(j) + k - rowbegin)
+               * destwidth;
+         const double* pin = &horizontal[rowoffset];
+         double weight = pweights[k];
+         for (int i = 0; i < destwidth; ++i)
+            accumulator[i] += weight * pin[i];
+         if (NoDataValueAvailable && weight != 0) {
+            for (int i = 0; i < destwidth; ++i)
+               usesnodata[i] |= nodata[rowoffset + i];
+         }
+      }
+      T* pdestrow = pdest + static_cast<size_t>(j) * destwidth;
+      for (int i = 0; i < destwidth; ++i)
+         pdestrow[i] = resampledvalue<T>(accumulator[i]);
+      if (!NoDataValueAvailable)
+         continue;
+      // Los pixeles cuyo nucleo incluye el valor no valido toman el mas cercano
+      const double* pnearest = &nearest[static_cast<size_t>(Rows.GetFirst(j)
+            + nearesttap(pweights, rowtaps) - rowbegin) * destwidth];
+      for (int i = 0; i < destwidth; ++i)
+         if (usesnodata[i])
+            pdestrow[i] = resampledvalue<T>(pnearest[i]);
+   }
+}
+
+/** Template interpolate */
+/**
+ *  Interpola los valores de la fuente en posiciones arbitrarias. Las
+ * posiciones fuera de la fuente (con el mismo criterio que el vecino mas
+ * cercano) no se escriben. Si el nucleo incluye algun pixel con el valor no
+ * valido se usa el vecino mas cercano.
+ * @param[in] pSrc datos de la fuente
+ * @param[in] Width ancho de la fuente
+ * @param[in] Height alto de la fuente
+ * @param[in] pX columnas (pixel-linea, el centro del pixel i esta en i+0.5)
+ * @param[in] pY filas
+ * @param[in] Count cantidad de posiciones
+ * @param[in] Type tipo de remuestreo
+ * @param[out] pDest valores interpolados (Count)
+ * @param[in] NoDataValueAvailable indica si hay valor no valido
+ * @param[in] NoDataValue valor no valido
+ */
+template<typename T>
+void interpolate(const void* pSrc, int Width, int Height, const double* pX,
+                 const double* pY, int Count, Resampler::ResamplingType Type,
+                 void* pDest, bool NoDataValueAvailable, double NoDataValue) {
+   const T* psrc = static_cast<const T*>(pSrc);
+   T* pdest = static_cast<T*>(pDest);
+   int radius = Resampler::GetRadius(Type);
+   int taps = 2 * radius;
+   double weightsx[2 * RESAMPLING_MAX_RADIUS], weightsy[2 * RESAMPLING_MAX_RADIUS];
+   int columns[2 * RESAMPLING_MAX_RADIUS], rows[2 * RESAMPLING_MAX_RADIUS];
+   T nodatavalue = static_cast<T>(NoDataValue);
+   for (int i = 0; i < Count; ++i) {
+      // NaN y posiciones fuera de la fuente antes de convertir a entero
+      if (pX[i] != pX[i] || pY[i] != pY[i] || pX[i] <= -1 || pX[i] >= Width
+            || pY[i] <= -1 || pY[i] >= Height)
+         continue;
+      int col = SURI_TRUNC(int, pX[i]), row = SURI_TRUNC(int, pY[i]);
+      if (taps == 0) {
+         pdest[i] = psrc[static_cast<size_t>(row) * Width + col];
+         continue;
+      }
+      double tx = pX[i] - 0.5, ty = pY[i] - 0.5;
+      int firstx = static_cast<int>(std::floor(tx)) - radius + 1;
+      int firsty = static_cast<int>(std::floor(ty)) - radius + 1;
+      double sumx = 0, sumy = 0;
+      for (int k = 0; k < taps; ++k) {
+         weightsx[k] = kernelTable.GetWeight(Type, firstx + k - tx);
+         weightsy[k] = kernelTable.GetWeight(Type, firsty + k - ty);
+         sumx += weightsx[k];
+         sumy += weightsy[k];
+         columns[k] = std::min(std::max(firstx + k, 0), Width - 1);
+         rows[k] = std::min(std::max(firsty + k, 0), Height - 1);
+      }
+      double value = 0;
+      bool hasnodata = false;
+      for (int l = 0; l < taps && !hasnodata; ++l) {
+         const T* psrcrow = psrc + static_cast<size_t>(rows[l]) * Width;
+         double rowvalue = 0;
+         for (int k = 0; k < taps; ++k) {
+            rowvalue += weightsx[k] * psrcrow[columns[k]];
+            hasnodata = hasnodata || (NoDataValueAvailable && weightsx[k] != 0
+                  && weightsy[l] != 0 && psrcrow[columns[k]] == nodatavalue);
+         }
+         value += weightsy[l] * rowvalue;
+      }
+      if (hasnodata)
+         pdest[i] = psrc[static_cast<size_t>(row) * Width + col];
+      else
+         pdest[i] = resampledvalue<T>(value / (sumx * sumy));
+   }
+}
+
+/** Inicializa mapas de tipos de datos. */
+INITIALIZE_DATATYPE_MAP(Resampler::ResampleFunctionType, resample);
+INITIALIZE_DATATYPE_MAP(Resampler::InterpolateFunctionType, interpolate);
+
+/** Ctor */
+Resampler::WeightTable::WeightTable() : taps_(1) {
+}
+
+/**
+ *  Calcula los pesos de cada posicion de salida. La posicion de salida i
+ * cubre en la fuente el intervalo [Offset + i * Step, Offset + (i+1) * Step)
+ * y se remuestrea en su centro. Si el paso es mayor a 1 el nucleo se
+ * ensancha en ese factor. Las ventanas que exceden la fuente se desplazan
+ * hacia adentro y los pesos se normalizan.
+ * @param[in] Type tipo de remuestreo
+ * @param[in] OutputSize cantidad de posiciones de salida
+ * @param[in] Step pixeles de fuente por pixel de salida
+ * @param[in] Offset posicion en la fuente del borde de la primer salida
+ * @param[in] SourceSize cantidad de pixeles de la fuente
+ */
+void Resampler::WeightTable::Initialize(ResamplingType Type, int OutputSize, double Step,
+                                        double Offset, int SourceSize) {
+   first_.assign(std::max(OutputSize, 0), 0);
+   double scale = std::max(1.0, Step);
+   double support = GetRadius(Type) * scale;
+   taps_ = std::max(1, std::min(static_cast<int>(std::ceil(2 * support)), SourceSize));
+   weights_.assign(first_.size() * taps_, 0.0);
+   for (int i = 0; i < OutputSize; ++i) {
+      double center = Offset + (i + 0.5) * Step - 0.5;
+      double* pweights = &weights_[static_cast<size_t>(i) * taps_];
+      if (Type == NearestNeighbour) {
+         first_[i] = std::min(std::max(static_cast<int>(std::floor(center + 0.5)), 0),
+                              std::max(SourceSize - 1, 0));
+         pweights[0] = 1;
+         continue;
+      }
+      int first = static_cast<int>(std::floor(center - support)) + 1;
+      first_[i] = std::min(std::max(first, 0), std::max(SourceSize - taps_, 0));
+      double sum = 0;
+      for (int k = 0; k < taps_; ++k) {
+         pweights[k] = GetWeight(Type, (first_[i] + k - center) / scale);
+         sum += pweights[k];
+      }
+      if (sum != 0) {
+         for (int k = 0; k < taps_; ++k)
+            pweights[k] /= sum;
+      } else {
+         // La ventana quedo fuera del nucleo: se usa el pixel mas cercano
+         int nearest = std::min(std::max(static_cast<int>(std::floor(center + 0.5)),
+                                         first_[i]), first_[i] + taps_ - 1);
+         pweights[nearest - first_[i]] = 1;
+      }
+   }
+}
+
+/** @return primer indice de la fuente que se utiliza */
+int Resampler::WeightTable::GetSourceBegin() const {
+   return first_.empty() ? 0 : first_.front();
+}
+
+/** @return indice siguiente al ultimo de la fuente que se utiliza */
+int Resampler::WeightTable::GetSourceEnd() const {
+   return first_.empty() ? 0 : first_.back() + taps_;
+}
+
+/**
+ * @param[in] Name nombre usado en el xml (NN, BL, CC, LZ)
+ * @param[out] Type tipo de remuestreo
+ * @return false si el nombre no corresponde a un tipo de remuestreo
+ */
+bool Resampler::GetType(const std::string &Name, ResamplingType &Type) {
+   if (Name == INTERPOLATION_PROPERTY_VALUE_NEAREST_NEIGHBOUR)
+      Type = NearestNeighbour;
+   else if (Name == INTERPOLATION_PROPERTY_VALUE_BILINEAR)
+      Type = Bilinear;
+   else if (Name == INTERPOLATION_PROPERTY_VALUE_CUBIC_COMBOLUTION)
+      Type = Cubic;
+   else if (Name == INTERPOLATION_PROPERTY_VALUE_LANCZOS)
+      Type = Lanczos;
+   else
+      return false;
+   return true;
+}
+
+/**
+ * @param[in] Type tipo de remuestreo
+ * @return nombre usado en el xml
+ */
+std::string Resampler::GetName(ResamplingType Type) {
+   switch (Type) {
+      case Bilinear:
+         return INTERPOLATION_PROPERTY_VALUE_BILINEAR;
+      case Cubic:
+         return INTERPOLATION_PROPERTY_VALUE_CUBIC_COMBOLUTION;
+      case Lanczos:
+         return INTERPOLATION_PROPERTY_VALUE_LANCZOS;
+      default:
+         return INTERPOLATION_PROPERTY_VALUE_NEAREST_NEIGHBOUR;
+   }
+}
+
+/**
+ * @param[in] Type tipo de remuestreo
+ * @return radio del nucleo en pixeles de la fuente (0 para vecino mas cercano)
+ */
+int Resampler::GetRadius(ResamplingType Type) {
+   switch (Type) {
+      case Bilinear:
+         return 1;
+      case Cubic:
+         return 2;
+      case Lanczos:
+         return RESAMPLING_MAX_RADIUS;
+      default:
+         return 0;
+   }
+}
+
+/**
+ * @param[in] Type tipo de remuestreo
+ * @param[in] Distance distancia al centro en pixeles de la fuente
+ * @return peso del nucleo
+ */
+double Resampler::GetWeight(ResamplingType Type, double Distance) {
+   double x = std::fabs(Distance);
+   double a = RESAMPLING_CUBIC_PARAMETER;
+   switch (Type) {
+      case Bilinear:
+         return x < 1 ? 1 - x : 0;
+      case Cubic:
+         if (x <= 1)
+            return ((a + 2) * x - (a + 3)) * x * x + 1;
+         if (x < 2)
+            return ((a * x - 5 * a) * x + 8 * a) * x - 4 * a;
+         return 0;
+      case Lanczos:
+         return x < RESAMPLING_MAX_RADIUS ? sinc(x) * sinc(x / RESAMPLING_MAX_RADIUS) : 0;
+      default:
+         return x <= 0.5 ? 1 : 0;
+   }
+}
+
+/**
+ * @param[in] DataType tipo de dato
+ * @return funcion de remuestreo de grilla o NULL si no se soporta el tipo
+ */
+Resampler::ResampleFunctionType Resampler::GetResampleFunction(
+      const std::string &DataType) {
+   std::map<std::string, ResampleFunctionType>::const_iterator it =
+         resampleTypeMap.find(DataType);
+   return it != resampleTypeMap.end() ? it->second : NULL;
+}
+
+/**
+ * @param[in] DataType tipo de dato
+ * @return funcion de interpolacion de posiciones o NULL si no se soporta el tipo
+ */
+Resampler::InterpolateFunctionType Resampler::GetInterpolateFunction(
+      const std::string &DataType) {
+   std::map<std::string, InterpolateFunctionType>::const_iterator it =
+         interpolateTypeMap.find(DataType);
+   return it != interpolateTypeMap.end() ? it->second : NULL;
+}
+
+}  // namespace suri
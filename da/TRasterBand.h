@@ -33,11 +33,15 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include <string>
 #include <math.h>
 #include <iostream>
+#include <set>
+#include <utility>
 
 // Includes suri
 #include "suri/RasterBand.h"
 #include "suri/RasterDriver.h"
 #include "suri/DataTypes.h"
+#include "suri/BlockCache.h"
+#include "suri/Image.h"
 #include "logmacros.h"
 
 /** namespace suri */
@@ -45,9 +49,10 @@ namespace suri {
 /** Template que hereda de RasterBand y especializa el tipo de dato */
 /**
  *  Clase template derivada de RasterBand que especializa en un tipo de dato
+ *  Los bloques se almacenan en el cache compartido BlockCache.
  */
 template<class T>
-class TRasterBand : public RasterBand {
+class TRasterBand : public RasterBand, private BlockCache::Client {
    /** Ctor. de Copia. */
    TRasterBand(const TRasterBand &TRasterBand);
 
@@ -64,12 +69,20 @@ public:
    virtual double operator()(int X, int Y) const;
    /** Entrega un buffer con los datos representados */
    virtual void *GetBlock(int BlockX, int BlockY);
+   /** Indica que el buffer entregado por GetBlock ya no se usa */
+   virtual void ReleaseBlock(int BlockX, int BlockY);
    /** Carga el buffer con los datos */
    virtual bool Read(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry);
    /** Escribe un bloque de banda */
    virtual void Write(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry);
    /** Escribe un bloque de banda */
    virtual void Write(void *pData, int BlockX, int BlockY);
+   /** Presta el buffer interno de un bloque para leerlo/escribirlo in-place */
+   virtual void* LockBlock(int BlockX, int BlockY);
+   /** Devuelve un bloque prestado con LockBlock */
+   virtual void UnlockBlock(int BlockX, int BlockY, bool Modified = false);
+   /** Indica si algun bloque del subset esta en el cache compartido */
+   virtual bool HasCachedBlocks(int Ulx, int Uly, int Lrx, int Lry);
    /** Funcion estatica para la factoria */
    static RasterBand* Create();
    /** Funcion que retorna el ClassId para la factoria */
@@ -93,31 +106,20 @@ protected:
    /** Reserva espacio para un subset y retorna el puntero al mismo. */
    T* AllocateSpace(int SizeX, int SizeY);
 private:
-   /** tipo estructura para los datos de los bloques */
-   /**
-    * todo: documentar
-    */
-   class BlockData {
-   public:
-      /** Ctor. */
-      BlockData() :
-            pData_(NULL), isDirty_(false) {
-      }
-      /** Libera la memoria reservada para los datos */
-      void Free() {
-         delete[] pData_;
-         pData_ = NULL;
-      }
-      T* pData_; /*! puntero a los datos */
-      bool isDirty_; /*! Indica si se le escribio */
-   } BlockDataType;
-   /** Reserva, carga y devuelve un bloque con los datos */
-   BlockData &GetDataBlock(int BlockX, int BlockY);
-   /** Elimina del cache de bloques */
-   void FreeCache(size_t MaxBlocks = 4, bool DirtyToo = false);
-   /** tipo matriz de bloques reservados */
-   typedef std::map<std::pair<int, int>, BlockData> BlockMatrixType;
-   BlockMatrixType blockMatrix_; /*! Bloques de datos */
+   /** Reserva, carga y devuelve un bloque con los datos marcandolo en uso */
+   T* AcquireDataBlock(int BlockX, int BlockY);
+   /** Indica que el bloque dejo de estar en uso */
+   void ReleaseDataBlock(int BlockX, int BlockY);
+   /** Elimina los bloques de la banda del cache */
+   void FreeCache();
+   /** Indica si los bloques modificados se pueden escribir en la imagen */
+   virtual bool CanWriteBack() const;
+   /** Escribe un bloque modificado en la imagen */
+   virtual bool WriteBack(int BlockX, int BlockY, void *pData);
+   /** Libera la memoria de un bloque */
+   virtual void FreeBlock(void *pData);
+   /** Bloques entregados con GetBlock (marcados en uso hasta ReleaseBlock) */
+   std::set<std::pair<int, int> > lentBlocks_;
    T *pData_; /*! puntero con los datos */
    int ulx_; /*! ultimo subset reservado */
    int uly_; /*! ultimo subset reservado */
@@ -135,7 +137,7 @@ TRasterBand<T>::TRasterBand() :
 /** dtor */
 template<class T>
 TRasterBand<T>::~TRasterBand() {
-   FreeCache(0, true);
+   FreeCache();
    delete[] pData_;
 }
 
@@ -155,7 +157,7 @@ void TRasterBand<T>::SetSize(const int SizeX, const int SizeY) {
       return;
    }
    // Elimino todos los datos
-   FreeCache(0, true);
+   FreeCache();
    delete[] pData_;
    // pongo en el mismo estado que el ctor
    pData_ = NULL;
@@ -192,16 +194,34 @@ double TRasterBand<T>::operator()(int X, int Y) const {
 
 /** Regresa el buffer interno con los datos cargados del subset pedido */
 /**
- *  Implementar algun tipo de persistencia del subset de manera que no se tenga
- * que cargar 2 veces el mismo.
- *  Se puede implementar un cache para los subsets pedidos, etc.
+ *  El bloque se mantiene en el cache compartido marcado en uso, por lo que
+ * no se elimina hasta que se llame a ReleaseBlock (varias llamadas a
+ * GetBlock sobre el mismo bloque lo marcan una sola vez).
  * @param[in] BlockX numero de columna del bloque
  * @param[in] BlockY numero de fila del bloque
  * @return puntero al bloque
+ * \attention el puntero es valido hasta llamar a ReleaseBlock, modificar la
+ *             dimension o la fuente de la banda, o destruirla
  */
 template<class T>
 void* TRasterBand<T>::GetBlock(int BlockX, int BlockY) {
-   return GetDataBlock(BlockX, BlockY).pData_;
+   T *pblock = AcquireDataBlock(BlockX, BlockY);
+   if (pblock && !lentBlocks_.insert(std::make_pair(BlockX, BlockY)).second) {
+      // ya estaba prestado, alcanza con la marca anterior
+      ReleaseDataBlock(BlockX, BlockY);
+   }
+   return pblock;
+}
+
+/**
+ * @param[in] BlockX numero de columna del bloque
+ * @param[in] BlockY numero de fila del bloque
+ */
+template<class T>
+void TRasterBand<T>::ReleaseBlock(int BlockX, int BlockY) {
+   if (lentBlocks_.erase(std::make_pair(BlockX, BlockY)) > 0) {
+      ReleaseDataBlock(BlockX, BlockY);
+   }
 }
 
 /** Llena el buffer que le pasan con el subset */
@@ -234,11 +254,13 @@ bool TRasterBand<T>::Read(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry) {
    // retorno el bloque
    if ((Lrx - Ulx) == block_x_size && (Lry - Uly) == block_y_size
          && Ulx % block_x_size == 0 && Uly % block_y_size == 0) {
-      BlockData db = GetDataBlock((int) (Ulx / block_x_size),
-                                  (int) (Uly / block_y_size));
-      if (!db.pData_) return false;
+      int blockx = Ulx / block_x_size;
+      int blocky = Uly / block_y_size;
+      T *pblock = AcquireDataBlock(blockx, blocky);
+      if (!pblock) return false;
 
-      memcpy(pBuffer, db.pData_, block_x_size * block_y_size * dataSize_);
+      memcpy(pBuffer, pblock, block_x_size * block_y_size * dataSize_);
+      ReleaseDataBlock(blockx, blocky);
       return true;
    }
 
@@ -259,7 +281,7 @@ bool TRasterBand<T>::Read(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry) {
                - std::max(i * block_x_size, Ulx);
 
          // obtengo el puntero de lectura
-         T *pblock = GetDataBlock(i, j).pData_;
+         T *pblock = AcquireDataBlock(i, j);
          if (!pblock) {
             return false;
          }
@@ -277,6 +299,7 @@ bool TRasterBand<T>::Read(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry) {
          for (int c = 0; c < rowcount; c++)
             memcpy(pbuff + c * buffer_step, pblock + c * block_x_size,
                    colcount * dataSize_);
+         ReleaseDataBlock(i, j);
       }
    }
    return true;
@@ -315,13 +338,12 @@ void TRasterBand<T>::Write(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry) {
                - std::max(i * block_x_size, Ulx);
 
          // obtengo el puntero de lectura
-         BlockData db = GetDataBlock(i, j);
-         T *pblock = db.pData_;
+         T *pblock = AcquireDataBlock(i, j);
          if (!pblock) {
             return;
          }
          // lo ensucio porque lo voy a escribir
-         db.isDirty_ = true;
+         BlockCache::Instance().SetDirty(this, i, j);
          // Calculo y aplico el offset de lectura
          int block_x_offset = std::max(i * block_x_size, Ulx) - i * block_x_size;
          int block_y_offset = std::max(j * block_y_size, Uly) - j * block_y_size;
@@ -336,6 +358,7 @@ void TRasterBand<T>::Write(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry) {
          for (int c = 0; c < rowcount; c++)
             memcpy(pblock + c * block_x_size, pbuff + c * buffer_step,
                    colcount * dataSize_);
+         ReleaseDataBlock(i, j);
       }
    }
 }
@@ -353,6 +376,34 @@ void TRasterBand<T>::Write(void *pData, int BlockX, int BlockY) {
    Write(pData, BlockX * x, BlockY * y, (BlockX + 1) * x, (BlockY + 1) * y);
 }
 
+/**
+ *  Retorna el buffer interno del bloque marcado en uso (el cache no lo
+ * elimina). El bloque no se marca modificado hasta que se devuelve con
+ * UnlockBlock indicando que se escribio.
+ * @param[in] BlockX numero de columna del bloque
+ * @param[in] BlockY numero de fila del bloque
+ * @return puntero al bloque o NULL si no pudo leerlo
+ * \attention el puntero es valido hasta llamar a UnlockBlock o modificar la
+ *             dimension de la banda
+ */
+template<class T>
+void* TRasterBand<T>::LockBlock(int BlockX, int BlockY) {
+   return AcquireDataBlock(BlockX, BlockY);
+}
+
+/**
+ * @param[in] BlockX numero de columna del bloque
+ * @param[in] BlockY numero de fila del bloque
+ * @param[in] Modified indica si se escribio en el bloque prestado
+ */
+template<class T>
+void TRasterBand<T>::UnlockBlock(int BlockX, int BlockY, bool Modified) {
+   if (Modified) {
+      BlockCache::Instance().SetDirty(this, BlockX, BlockY);
+   }
+   ReleaseDataBlock(BlockX, BlockY);
+}
+
 /** Funcion de creacion (para la factoria) */
 /**
  * return RasterBand del tipo correcto
@@ -371,7 +422,7 @@ RasterBand* TRasterBand<T>::Create() {
 template<class T>
 RasterSource *TRasterBand<T>::PopSource() {
    // Elimino los bloques cacheados
-   FreeCache(0, true);
+   FreeCache();
    return RasterBand::PopSource();
 }
 
@@ -383,7 +434,7 @@ RasterSource *TRasterBand<T>::PopSource() {
 template<class T>
 void TRasterBand<T>::PushSource(RasterSource *pSource) {
    // Elimino los bloques cacheados
-   FreeCache(0, true);
+   FreeCache();
    RasterSource::PushSource(pSource);
 }
 
@@ -409,83 +460,129 @@ T* TRasterBand<T>::AllocateSpace(int SizeX, int SizeY) {
 }
 
 /**
- *  Busca el bloque en el mapa, si esta lo retorna, si no lo encuentra,
- * lo crea, inicializa la memoria, carga los datos correspondientes al bloque,
- * lo agrega al mapa y lo retorna.
+ *  Busca el bloque en el cache compartido, si esta lo retorna, si no lo
+ * encuentra lo crea, inicializa la memoria, carga los datos correspondientes
+ * al bloque, lo agrega al cache y lo retorna.
+ *  El bloque queda marcado en uso hasta que se llame a ReleaseDataBlock.
  * @param[in] BlockX numero de columna del bloque
  * @param[in] BlockY numero de fila del bloque
+ * @return puntero al bloque o NULL si no pudo leerlo
  */
 template<class T>
-typename TRasterBand<T>::BlockData&
-TRasterBand<T>::GetDataBlock(int BlockX, int BlockY) {
-   // busco el bloque
-   typename BlockMatrixType::iterator it = blockMatrix_.find(
-         std::make_pair(BlockX, BlockY));
-   std::pair<typename BlockMatrixType::iterator, bool> result;
+T* TRasterBand<T>::AcquireDataBlock(int BlockX, int BlockY) {
+   BlockCache &cache = BlockCache::Instance();
    // si existe lo retorno (cache HIT)
-   if (it != blockMatrix_.end()) {
-#ifdef __DEBUG__
-      BlockData tempbd = it->second;
-      tempbd.isDirty_ = tempbd.isDirty_;
-#endif
-      return it->second;
-   } else
+   T *pdata = static_cast<T*>(cache.Acquire(this, BlockX, BlockY));
+   if (pdata) {
+      return pdata;
+   }
    // sino, lo creo, leo los datos, lo agrego y lo retorno
-   {
-      BlockData bd;
-      int bsx, bsy;   // Tamanio de bloque
-      GetBlockSize(bsx, bsy);
-      // AVISO DE CODIGO DIABOLICO: no intente establecer pData_ en NULL
-      // salvo dentro del entorno del IF (el mismo ha sido protegido con
-      // bendeciones divinas). De hacerlo una lluvia de SIGSEGVs, ardiente
-      // como el fuego, os hara arder por siempre.
-      bd.pData_ = AllocateSpace(bsx, bsy);
-      if (pSource_
-            && !pSource_->Read(bd.pData_, bsx * BlockX, bsy * BlockY,
-                               bsx * (1 + BlockX), bsy * (1 + BlockY))) {
-         delete[] bd.pData_;
-         bd.pData_ = NULL;
-      }
-      // Trato de limpiar el cache
-      FreeCache();
+   int bsx, bsy;   // Tamanio de bloque
+   GetBlockSize(bsx, bsy);
+   pdata = AllocateSpace(bsx, bsy);
+   if (!pdata) {
+      return NULL;
+   }
+   if (pSource_
+         && !pSource_->Read(pdata, bsx * BlockX, bsy * BlockY, bsx * (1 + BlockX),
+                            bsy * (1 + BlockY))) {
+      delete[] pdata;
+      return NULL;
+   }
+   // si otro hilo agrego el bloque mientras se leia se usa el del cache
+   return static_cast<T*>(cache.Insert(this, BlockX, BlockY, pdata,
+                                       static_cast<size_t>(bsx) * bsy * dataSize_));
+}
 
-      result = blockMatrix_.insert(std::make_pair(std::make_pair(BlockX, BlockY), bd));
+/**
+ * @param[in] BlockX numero de columna del bloque
+ * @param[in] BlockY numero de fila del bloque
+ */
+template<class T>
+void TRasterBand<T>::ReleaseDataBlock(int BlockX, int BlockY) {
+   BlockCache::Instance().Release(this, BlockX, BlockY);
+}
 
-      if (!result.second) {
-         REPORT_AND_FAIL_VALUE("D:Error al insertar bloque de datos.",
-                               result.first->second);
-      }
+/**
+ *  Un bloque en el cache puede tener datos modificados que todavia no se
+ * escribieron en la imagen, por lo que el subset se debe leer a traves del
+ * cache.
+ * @param[in] Ulx upper left x del subset
+ * @param[in] Uly upper left y del subset
+ * @param[in] Lrx lower right x del subset
+ * @param[in] Lry lower right y del subset
+ * @return true si algun bloque del subset esta en el cache
+ */
+template<class T>
+bool TRasterBand<T>::HasCachedBlocks(int Ulx, int Uly, int Lrx, int Lry) {
+   int bsx, bsy;
+   GetBlockSize(bsx, bsy);
+   if (bsx <= 0 || bsy <= 0) {
+      return false;
    }
-   return result.first->second;
+   BlockCache &cache = BlockCache::Instance();
+   for (int j = Uly / bsy; j * bsy < Lry; j++)
+      for (int i = Ulx / bsx; i * bsx < Lrx; i++)
+         if (cache.Contains(this, i, j)) return true;
+   return false;
 }
 
 /** Elimina del cache de bloques */
 /**
- *  Elimina los bloques cacheados no sucios (modificados) hasta dejar un maximo
- * de MaxBlocks.
- * \post Si la cantidad de bloques modificados supera a MaxBlocks y
- *      DirtyToo==false quedaran solo los bloques modificados.
- * \post Si la cantidad de bloques modificados supera a MaxBlocks y
- *      DirtyToo==true quedara un maximo de MaxBlocks bloques.
- * \post Si la cantidad de bloques modificados es inferios a MaxBlocks, quedara
- *      un maximo de MaxBlocks bloques.
- *
- * @param[in] MaxBlocks Cantidad maxima de bloques que quedran en el cache
- * @param[in] DirtyToo Eliminar incluso bloques que hayan sido modificados
+ *  Elimina del cache compartido todos los bloques de la banda, incluso los
+ * modificados (sin escribirlos).
+ */
+template<class T>
+void TRasterBand<T>::FreeCache() {
+   lentBlocks_.clear();
+   BlockCache::Instance().Discard(this);
+}
+
+/**
+ *  Solo es posible si la banda pertenece a una imagen abierta en
+ * lectura/escritura; en otro caso (ej. bandas en memoria) los bloques
+ * modificados permanecen en el cache.
+ * @return true si los bloques modificados se pueden escribir
+ */
+template<class T>
+bool TRasterBand<T>::CanWriteBack() const {
+   Image *pimage = GetImage();
+   return pimage && pimage->GetAccess() == Image::ReadWrite;
+}
+
+/**
+ *  Escribe un bloque modificado antes de que el cache lo elimine.
+ * @param[in] BlockX numero de columna del bloque
+ * @param[in] BlockY numero de fila del bloque
+ * @param[in] pData datos del bloque
+ * @return true si pudo escribir el bloque
  */
 template<class T>
-void TRasterBand<T>::FreeCache(size_t MaxBlocks, bool DirtyToo) {
-   typename BlockMatrixType::iterator it = blockMatrix_.begin();
-   while (blockMatrix_.size() > MaxBlocks && it != blockMatrix_.end()) {
-      BlockData tempdb = it->second;
-      if (!tempdb.isDirty_ || DirtyToo) {
-         tempdb.Free();
-         blockMatrix_.erase(it);
-         it = blockMatrix_.begin();
-      } else {
-         it++;
+bool TRasterBand<T>::WriteBack(int BlockX, int BlockY, void *pData) {
+   if (!CanWriteBack()) {
+      return false;
+   }
+   Image *pimage = GetImage();
+   for (int b = 0; b < pimage->GetBandCount(); ++b) {
+      if (pimage->GetBand(b) == this) {
+         std::vector<int> bands(1, b);
+         std::vector<void*> data(1, pData);
+         int bsx, bsy;
+         GetBlockSize(bsx, bsy);
+         pimage->Write(bands, data, bsx * BlockX, bsy * BlockY, bsx * (1 + BlockX),
+                       bsy * (1 + BlockY));
+         return true;
       }
    }
+   return false;
+}
+
+/**
+ * @param[in] pData datos del bloque a liberar
+ */
+template<class T>
+void TRasterBand<T>::FreeBlock(void *pData) {
+   delete[] static_cast<T*>(pData);
 }
 
 typedef TRasterBand<unsigned char> UCharBandType; /*! 8 bits no-signado */
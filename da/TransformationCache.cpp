@@ -0,0 +1,290 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+// Includes standard
+#include <cctype>
+
+// Includes suri
+#include "suri/TransformationCache.h"
+#include "suri/Configuration.h"
+
+// Includes wx
+#include "wx/thread.h"
+
+/** Cantidad de claves por defecto del cache de transformaciones */
+#define DEFAULT_TRANSFORMATION_CACHE_SIZE 32
+/** Cantidad maxima de pares de transformaciones libres por clave */
+#define TRANSFORMATION_CACHE_MAX_IDLE 8
+
+/** namespace suri */
+namespace suri {
+
+namespace {
+
+/**
+ * Normaliza un WKT eliminando los espacios fuera de las comillas, para que
+ * WKT equivalentes con distinto formato compartan clave.
+ * @param[in] Wkt wkt a normalizar
+ * @param[out] Normalized wkt normalizado (se agrega al final)
+ */
+void NormalizeWkt(const std::string &Wkt, std::string &Normalized) {
+   bool quoted = false;
+   for (size_t ix = 0; ix < Wkt.size(); ++ix) {
+      char character = Wkt[ix];
+      if (character == '"')
+         quoted = !quoted;
+      if (quoted || !isspace(static_cast<unsigned char>(character)))
+         Normalized += character;
+   }
+}
+
+/**
+ * Destruye un par de transformaciones OGR.
+ * @param[in] pTransform transformacion directa
+ * @param[in] pInverseTransform transformacion inversa
+ */
+void DestroyPair(OGRCoordinateTransformation* pTransform,
+                 OGRCoordinateTransformation* pInverseTransform) {
+   if (pTransform)
+      OCTDestroyCoordinateTransformation(pTransform);
+   if (pInverseTransform)
+      OCTDestroyCoordinateTransformation(pInverseTransform);
+}
+
+}  // namespace
+
+/** Ctor */
+TransformationCache::TransformationCache() :
+      capacity_(0), hits_(0), misses_(0), pMutex_(new wxMutex) {
+   long capacity = Configuration::GetParameter("lib_transformation_cache_size",
+                                               static_cast<long>(DEFAULT_TRANSFORMATION_CACHE_SIZE));
+   capacity_ = static_cast<size_t>(capacity > 0 ? capacity : DEFAULT_TRANSFORMATION_CACHE_SIZE);
+}
+
+/** Dtor */
+TransformationCache::~TransformationCache() {
+   Clear();
+   delete pMutex_;
+}
+
+/**
+ * Retorna la instancia del cache. Se crea la primera vez que se utiliza para
+ * que la capacidad se lea de la configuracion ya cargada.
+ * @return instancia unica del cache
+ */
+TransformationCache& TransformationCache::Instance() {
+   static TransformationCache *pcache = new TransformationCache();
+   return *pcache;
+}
+
+/**
+ * Arma la clave de una transformacion con su tipo y los WKT normalizados.
+ * @param[in] Type tipo de transformacion (ver TransformationFactory)
+ * @param[in] WktIn wkt de entrada
+ * @param[in] WktOut wkt de salida (vacio si lo resuelve la factoria)
+ * @return clave de la transformacion
+ */
+std::string TransformationCache::GetKey(const std::string &Type,
+                                        const std::string &WktIn,
+                                        const std::string &WktOut) {
+   std::string key;
+   key.reserve(Type.size() + WktIn.size() + WktOut.size() + 2);
+   key += Type;
+   key += '\n';
+   NormalizeWkt(WktIn, key);
+   key += '\n';
+   NormalizeWkt(WktOut, key);
+   return key;
+}
+
+/**
+ * Busca el resultado de crear la transformacion de una clave. Si es una
+ * transformacion se cuenta una instancia viva (que debe llamar a Release al
+ * destruirse) y se le entregan transformaciones libres si las hay.
+ * @param[in] Key clave de la transformacion
+ * @param[out] WktOut wkt de salida resuelto
+ * @param[out] pTransform transformacion directa libre o NULL
+ * @param[out] pInverseTransform transformacion inversa libre o NULL
+ * @return resultado conocido o Unknown si la clave no esta en el cache
+ */
+TransformationCache::ResultType TransformationCache::Acquire(
+      const std::string &Key, std::string &WktOut,
+      OGRCoordinateTransformation* &pTransform,
+      OGRCoordinateTransformation* &pInverseTransform) {
+   pTransform = NULL;
+   pInverseTransform = NULL;
+   wxMutexLocker lock(*pMutex_);
+   EntryMapType::iterator it = entries_.find(Key);
+   if (it == entries_.end() || it->second.result_ == Unknown) {
+      ++misses_;
+      return Unknown;
+   }
+   ++hits_;
+   Entry &entry = it->second;
+   lru_.splice(lru_.begin(), lru_, entry.lru_);
+   WktOut = entry.wktOut_;
+   if (entry.result_ == Transformation) {
+      entry.inUse_++;
+      if (!entry.idle_.empty()) {
+         pTransform = entry.idle_.back().first;
+         pInverseTransform = entry.idle_.back().second;
+         entry.idle_.pop_back();
+      }
+   }
+   return entry.result_;
+}
+
+/**
+ * Registra el resultado de crear la transformacion de una clave. Si es una
+ * transformacion se cuenta la instancia que se esta creando como viva.
+ * @param[in] Key clave de la transformacion
+ * @param[in] Result resultado de la creacion
+ * @param[in] WktOut wkt de salida resuelto
+ */
+void TransformationCache::Insert(const std::string &Key, ResultType Result,
+                                 const std::string &WktOut) {
+   wxMutexLocker lock(*pMutex_);
+   EntryMapType::iterator it = entries_.find(Key);
+   if (it == entries_.end()) {
+      it = entries_.insert(std::make_pair(Key, Entry())).first;
+      lru_.push_front(Key);
+      it->second.lru_ = lru_.begin();
+   } else {
+      lru_.splice(lru_.begin(), lru_, it->second.lru_);
+   }
+   it->second.result_ = Result;
+   it->second.wktOut_ = WktOut;
+   if (Result == Transformation)
+      it->second.inUse_++;
+   Evict();
+}
+
+/**
+ * Devuelve las transformaciones de una instancia destruida. Se guardan para
+ * las proximas instancias o se destruyen si ya hay suficientes libres o si
+ * la clave no esta en el cache.
+ * @param[in] Key clave de la transformacion
+ * @param[in] pTransform transformacion directa (puede ser NULL)
+ * @param[in] pInverseTransform transformacion inversa (puede ser NULL)
+ */
+void TransformationCache::Release(const std::string &Key,
+                                  OGRCoordinateTransformation* pTransform,
+                                  OGRCoordinateTransformation* pInverseTransform) {
+   wxMutexLocker lock(*pMutex_);
+   EntryMapType::iterator it = entries_.find(Key);
+   if (it == entries_.end()) {
+      DestroyPair(pTransform, pInverseTransform);
+      return;
+   }
+   Entry &entry = it->second;
+   if (entry.inUse_ > 0)
+      entry.inUse_--;
+   if (pTransform && pInverseTransform
+         && entry.idle_.size() < TRANSFORMATION_CACHE_MAX_IDLE)
+      entry.idle_.push_back(std::make_pair(pTransform, pInverseTransform));
+   else
+      DestroyPair(pTransform, pInverseTransform);
+   Evict();
+}
+
+/** Elimina las claves sin instancias vivas */
+void TransformationCache::Clear() {
+   wxMutexLocker lock(*pMutex_);
+   EntryMapType::iterator it = entries_.begin();
+   while (it != entries_.end()) {
+      if (it->second.inUse_ == 0) {
+         DestroyIdle(it->second);
+         lru_.erase(it->second.lru_);
+         entries_.erase(it++);
+      } else {
+         ++it;
+      }
+   }
+}
+
+/**
+ * @param[in] Capacity cantidad maxima de claves (minimo 1)
+ */
+void TransformationCache::SetCapacity(size_t Capacity) {
+   wxMutexLocker lock(*pMutex_);
+   capacity_ = Capacity > 0 ? Capacity : 1;
+   Evict();
+}
+
+/** @return cantidad maxima de claves */
+size_t TransformationCache::GetCapacity() const {
+   wxMutexLocker lock(*pMutex_);
+   return capacity_;
+}
+
+/** @return cantidad de busquedas con resultado conocido */
+unsigned long TransformationCache::GetHitCount() const {
+   wxMutexLocker lock(*pMutex_);
+   return hits_;
+}
+
+/** @return cantidad de busquedas sin resultado conocido */
+unsigned long TransformationCache::GetMissCount() const {
+   wxMutexLocker lock(*pMutex_);
+   return misses_;
+}
+
+/** Reinicia los contadores */
+void TransformationCache::ResetCounters() {
+   wxMutexLocker lock(*pMutex_);
+   hits_ = 0;
+   misses_ = 0;
+}
+
+/**
+ * Elimina las claves usadas hace mas tiempo hasta respetar la capacidad.
+ * Las claves con instancias vivas no se eliminan. Se llama con el mutex
+ * tomado.
+ */
+void TransformationCache::Evict() {
+   std::list<std::string>::iterator it = lru_.end();
+   while (entries_.size() > capacity_ && it != lru_.begin()) {
+      --it;
+      EntryMapType::iterator entry = entries_.find(*it);
+      if (entry->second.inUse_ > 0)
+         continue;
+      DestroyIdle(entry->second);
+      entries_.erase(entry);
+      it = lru_.erase(it);
+   }
+}
+
+/**
+ * @param[in] EntryP entrada cuyas transformaciones libres se destruyen
+ */
+void TransformationCache::DestroyIdle(Entry &EntryP) {
+   for (size_t ix = 0; ix < EntryP.idle_.size(); ++ix)
+      DestroyPair(EntryP.idle_[ix].first, EntryP.idle_[ix].second);
+   EntryP.idle_.clear();
+}
+
+}  // namespace suri
@@ -0,0 +1,120 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef APPROXIMATECOORDINATESTRANSFORMATION_H_
+#define APPROXIMATECOORDINATESTRANSFORMATION_H_
+
+// Includes Estandar
+#include <vector>
+#include <cstddef>
+
+// Includes Suri
+#include "suri/CoordinatesTransformation.h"
+#include "suri/Coordinates.h"
+#include "suri/Subset.h"
+
+/** Cantidad de celdas por lado de la grilla inicial */
+#define APPROXIMATE_TRANSFORMATION_GRID_SIZE 8
+/** Cantidad maxima de subdivisiones de una celda */
+#define APPROXIMATE_TRANSFORMATION_MAX_DEPTH 6
+
+/** namespace suri */
+namespace suri {
+
+/**
+ * Aproxima una transformacion dentro de un dominio interpolando
+ * bilinealmente entre transformaciones exactas calculadas en los vertices
+ * de una grilla.
+ *  La grilla se subdivide (quadtree) donde la interpolacion en el centro y
+ * los puntos medios de los lados de una celda difiere de la transformacion
+ * exacta en mas de la tolerancia. Las celdas que no alcanzan la tolerancia
+ * con la subdivision maxima, o donde falla la transformacion exacta, y los
+ * puntos fuera del dominio se transforman en forma exacta.
+ *  Solo se aproxima el sentido indicado en el constructor; el otro sentido
+ * y la transformacion de subsets se delegan en la transformacion exacta.
+ */
+class ApproximateCoordinatesTransformation : public CoordinatesTransformation {
+public:
+   /** Construye la grilla. No toma posesion de pExact */
+   ApproximateCoordinatesTransformation(const CoordinatesTransformation* pExact,
+                                        const Subset& Domain, double Tolerance,
+                                        bool Inverse = false);
+   /** Destructor */
+   virtual ~ApproximateCoordinatesTransformation();
+
+   /** Transforma una coordenada, interpolando si esta dentro del dominio */
+   virtual int Transform(Coordinates &CoordinatesP, bool Inverse = false) const;
+   /** Transforma un vector de coordenadas */
+   virtual int Transform(std::vector<Coordinates> &CoordinatesP,
+                         bool Inverse = false) const;
+   /** Transforma arreglos de coordenadas */
+   virtual int Transform(double* pX, double* pY, int Count, bool Inverse = false,
+                         int* pSuccess = NULL) const;
+   /** Transforma un subset con la transformacion exacta */
+   virtual int Transform(Subset &SubsetP,
+                         int CalculationPoints = DEFAULT_CALCULATION_POINTS,
+                         bool Inverse = false) const;
+   /** Indica si es la transformacon identidad. */
+   virtual bool IsIdentity() const;
+   /** Compara si dos transformaciones son iguales **/
+   virtual bool Equals(CoordinatesTransformation* pTransform) const;
+
+private:
+   /** Estado de una celda */
+   enum CellState {
+      Interpolated, Subdivided, Exact
+   };
+   /** Celda de la grilla en coordenadas normalizadas del dominio */
+   struct Cell {
+      double u_; /*! columna normalizada del vertice superior izquierdo */
+      double v_; /*! fila normalizada del vertice superior izquierdo */
+      double size_; /*! lado de la celda normalizado */
+      Coordinates corners_[4]; /*! vertices transformados (ul, ur, ll, lr) */
+      CellState state_; /*! estado de la celda */
+      size_t firstChild_; /*! indice de la primer subcelda */
+   };
+
+   /** Busca la celda interpolable que contiene al punto */
+   const Cell* FindCell(double X, double Y, double &U, double &V) const;
+   /** Transforma el punto normalizado (U, V) en forma exacta */
+   bool ExactTransform(double U, double V, Coordinates &Point) const;
+   /** Interpola dentro de la celda el punto normalizado (U, V) */
+   static Coordinates Interpolate(const Cell &CellP, double U, double V);
+   /** Decide si la celda se interpola, se subdivide o se calcula exacta */
+   void BuildCell(size_t Index, int Depth);
+
+   const CoordinatesTransformation* pExact_; /*! transformacion exacta */
+   Subset domain_; /*! dominio aproximado */
+   double tolerance_; /*! error maximo admitido en unidades de salida */
+   bool inverse_; /*! sentido aproximado */
+   bool valid_; /*! indica si la grilla se pudo construir */
+   std::vector<Cell> cells_; /*! celdas (las primeras son la grilla inicial) */
+};
+
+}  // namespace suri
+
+#endif  // APPROXIMATECOORDINATESTRANSFORMATION_H_
@@ -0,0 +1,177 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef BLOCKCACHE_H_
+#define BLOCKCACHE_H_
+
+// Includes standard
+#include <cstddef>
+#include <list>
+#include <map>
+#include <vector>
+
+// forwards wx
+class wxMutex;
+class wxCondition;
+
+/** namespace suri */
+namespace suri {
+
+/** Cache de bloques raster compartido por todas las bandas del proceso */
+/**
+ *  Mantiene los bloques leidos por las bandas (TRasterBand) de todas las
+ * imagenes abiertas dentro de un presupuesto de memoria unico. Cuando se
+ * supera el presupuesto elimina los bloques usados hace mas tiempo (LRU).
+ *  Los bloques modificados se escriben (write-back) a traves de su banda
+ * antes de eliminarlos, sin tomar el lock del cache durante la escritura.
+ * Si la banda no puede escribirlos (ej. bandas en memoria sin fuente) pasan a
+ * una lista de bloques residentes, fuera de la lista LRU y del presupuesto,
+ * donde permanecen hasta que la banda los descarte.
+ *  Los bloques en uso (Acquire sin Release) nunca se eliminan.
+ *  El presupuesto se toma de la configuracion (lib_raster_block_cache_size,
+ * en MB) la primera vez que se utiliza el cache.
+ */
+class BlockCache {
+   /** Ctor. de Copia. */
+   BlockCache(const BlockCache &BlockCache);
+
+public:
+   /** Interfaz que implementan los duenios de los bloques */
+   class Client {
+   public:
+      /** Dtor */
+      virtual ~Client() {
+      }
+      /** Indica si los bloques modificados se pueden escribir en su destino */
+      virtual bool CanWriteBack() const=0;
+      /** Escribe un bloque modificado en su destino. */
+      virtual bool WriteBack(int BlockX, int BlockY, void *pData)=0;
+      /** Libera la memoria de un bloque */
+      virtual void FreeBlock(void *pData)=0;
+   };
+
+   /** Dtor */
+   ~BlockCache();
+   /** Retorna la instancia del cache (singleton) */
+   static BlockCache& Instance();
+   /** Busca un bloque y lo marca en uso */
+   void* Acquire(Client *pClient, int BlockX, int BlockY);
+   /** Indica si un bloque esta en el cache (sin marcarlo en uso) */
+   bool Contains(Client *pClient, int BlockX, int BlockY) const;
+   /** Agrega un bloque al cache marcandolo en uso */
+   void* Insert(Client *pClient, int BlockX, int BlockY, void *pData, size_t Size);
+   /** Indica que el bloque dejo de estar en uso */
+   void Release(Client *pClient, int BlockX, int BlockY);
+   /** Marca un bloque como modificado */
+   void SetDirty(Client *pClient, int BlockX, int BlockY);
+   /** Escribe los bloques modificados de un cliente */
+   void Flush(Client *pClient);
+   /** Elimina los bloques de un cliente sin escribirlos */
+   void Discard(Client *pClient);
+   /** Establece el presupuesto de memoria en bytes */
+   void SetBudget(size_t Bytes);
+   /** Retorna el presupuesto de memoria en bytes */
+   size_t GetBudget() const;
+   /** Retorna la memoria ocupada por los bloques en bytes */
+   size_t GetUsedBytes() const;
+   /** Retorna la memoria ocupada por los bloques residentes en bytes */
+   size_t GetResidentBytes() const;
+   /** Cantidad de bloques encontrados en el cache */
+   unsigned long GetHitCount() const;
+   /** Cantidad de bloques no encontrados en el cache */
+   unsigned long GetMissCount() const;
+   /** Cantidad de bloques eliminados por falta de espacio */
+   unsigned long GetEvictionCount() const;
+   /** Cantidad de bloques modificados escritos al eliminarlos */
+   unsigned long GetWriteBackCount() const;
+   /** Reinicia los contadores */
+   void ResetCounters();
+
+private:
+   /** Ctor */
+   BlockCache();
+   /** Clave de un bloque */
+   struct BlockKey {
+      /** Ctor */
+      BlockKey(Client *pClient, int BlockX, int BlockY) :
+            pClient_(pClient), blockX_(BlockX), blockY_(BlockY) {
+      }
+      /** Orden para el mapa */
+      bool operator<(const BlockKey &Other) const {
+         if (pClient_ != Other.pClient_)
+            return pClient_ < Other.pClient_;
+         if (blockY_ != Other.blockY_)
+            return blockY_ < Other.blockY_;
+         return blockX_ < Other.blockX_;
+      }
+      Client *pClient_; /*! Duenio del bloque */
+      int blockX_; /*! columna del bloque */
+      int blockY_; /*! fila del bloque */
+   };
+   /** Entrada del cache */
+   struct BlockEntry {
+      /** Ctor */
+      BlockEntry(const BlockKey &Key, void *pData, size_t Size) :
+            key_(Key), pData_(pData), size_(Size), isDirty_(false), isResident_(false),
+            isWriting_(false), dirtyVersion_(0), pins_(1) {
+      }
+      BlockKey key_; /*! clave del bloque */
+      void *pData_; /*! datos del bloque */
+      size_t size_; /*! tamanio en bytes */
+      bool isDirty_; /*! indica si se le escribio */
+      bool isResident_; /*! esta en la lista de residentes (no se elimina) */
+      bool isWriting_; /*! se esta escribiendo en su destino */
+      unsigned long dirtyVersion_; /*! cantidad de veces que se marco modificado */
+      int pins_; /*! cantidad de usos en curso */
+   };
+   /** Lista ordenada por uso (el primero es el mas reciente) */
+   typedef std::list<BlockEntry> LruListType;
+   /** Indice de bloques */
+   typedef std::map<BlockKey, LruListType::iterator> BlockMapType;
+   /** Elimina bloques hasta respetar el presupuesto */
+   void Evict();
+   /** Escribe bloques modificados liberando el lock durante la escritura */
+   size_t WriteBlocks(std::vector<LruListType::iterator> &Entries);
+   /** Elimina una entrada del cache liberando sus datos */
+   void Erase(BlockMapType::iterator It);
+   LruListType lru_; /*! bloques ordenados por uso */
+   LruListType resident_; /*! bloques modificados que no se pueden escribir */
+   BlockMapType blocks_; /*! indice de bloques */
+   size_t budget_; /*! presupuesto en bytes */
+   size_t used_; /*! memoria ocupada por los bloques de lru_ en bytes */
+   size_t residentBytes_; /*! memoria ocupada por los bloques de resident_ */
+   unsigned long hits_; /*! bloques encontrados */
+   unsigned long misses_; /*! bloques no encontrados */
+   unsigned long evictions_; /*! bloques eliminados */
+   unsigned long writeBacks_; /*! bloques escritos */
+   wxMutex *pMutex_; /*! protege el acceso concurrente */
+   wxCondition *pWriteDone_; /*! avisa que termino una escritura de bloques */
+};
+
+}  // namespace suri
+
+#endif /* BLOCKCACHE_H_ */
@@ -0,0 +1,74 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef BUILDOVERVIEWSPROCESS_H_
+#define BUILDOVERVIEWSPROCESS_H_
+
+// Includes Estandar
+#include <string>
+#include <vector>
+// Includes Suri
+#include "ProcessInterface.h"
+// Includes Wx
+// Defines
+// forwards
+
+namespace suri {
+
+/**
+ * Proceso que genera los niveles de resolucion reducida (overviews) de una
+ * imagen utilizando OverviewBuilder. El avance se informa (y se puede
+ * cancelar) a traves de la barra de progreso.
+ */
+class BuildOverviewsProcess : public ProcessInterface {
+public:
+   /** Ctor. */
+   BuildOverviewsProcess(const std::string &Filename,
+                         const std::vector<int> &Factors = std::vector<int>());
+   /** Dtor. */
+   virtual ~BuildOverviewsProcess();
+   // ------ Metodos que administran la ejecucion del proceso ------
+   /** Corre el proceso y genera la salida usando los metodos de configuracion */
+   virtual bool RunProcess();
+   /** Cumple con la interfaz */
+   virtual bool ConfigureProcess();
+   /** Cumple con la interfaz */
+   virtual bool ConfigureOutput();
+   /** Configura el proceso a partir de un xml con sus parametros */
+   virtual bool ConfigureProcessFromXmlString(const std::string& XmlStr);
+   /** Obtiene los parametros asociados al proceso en formato XML */
+   std::string GetParametersAsXmlString() const;
+
+private:
+   std::string filename_; /*! imagen de la que se generan los overviews */
+   std::vector<int> factors_; /*! factores de reduccion (vacio: sugeridos) */
+   static const std::string kProcessName;
+};
+
+} /** namespace suri */
+
+#endif /* BUILDOVERVIEWSPROCESS_H_ */
@@ -98,6 +98,23 @@ public:
                       const Mask *pMask = NULL)=0;
    /** Escritura desde otro canvas (in-place) */
    void Write(const Canvas *pSource, const Mask *pMask = NULL);
+   /** Presta los buffers internos de las bandas para leer/escribir in-place */
+   /**
+    *  Permite a los renderizadores trabajar directamente sobre los datos del
+    * canvas, evitando reservar buffers temporales y copiarlos con Read/Write.
+    *  Cada buffer tiene SizeX()*SizeY()*GetDataSize() bytes. Lo escrito en
+    * los buffers queda en el canvas si se devuelven indicando que se
+    * modificaron.
+    * \attention Los buffers deben devolverse con ReleaseBandBuffers antes de
+    *            modificar el tamanio, tipo de dato o cantidad de bandas.
+    * @param[in] BandIndex indice de bandas solicitadas
+    * @param[out] Buffers punteros a los buffers de cada banda
+    * @return false si el canvas no puede prestar sus buffers (se debe usar
+    *         Read/Write)
+    */
+   virtual bool GetBandBuffers(std::vector<int> &BandIndex, std::vector<void*> &Buffers);
+   /** Devuelve los buffers prestados por GetBandBuffers */
+   virtual void ReleaseBandBuffers(std::vector<int> &BandIndex, bool Modified = false);
 // ----------------------------- VECTORIAL -----------------------------
    /** Canvas vectorial */
    virtual wxDC *GetDC();
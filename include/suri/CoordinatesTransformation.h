@@ -30,6 +30,9 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Standards
 #include <vector>
+#include <cstddef>
+
+#include "suri/Coordinates.h"
 
 /**
  * Puntos a tener en cuenta en una transformacion de coordenadas
@@ -39,7 +42,6 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 namespace suri {
 
 // Forward Declarations
-class Coordinates;
 class Subset;
 
 /**
@@ -77,6 +79,34 @@ public:
                          int CalculationPoints = DEFAULT_CALCULATION_POINTS,
                          bool Inverse = false) const = 0;
 
+   /**
+    * Transforma Count puntos dados como arreglos de coordenadas x e y.
+    * Por defecto transforma punto a punto; las clases derivadas lo
+    * reemplazan para transformar todo el arreglo en una sola llamada.
+    * @param[in,out] pX coordenadas x
+    * @param[in,out] pY coordenadas y
+    * @param[in] Count cantidad de puntos
+    * @param[in] Inverse indica si se debe hacer la transformacion inversa
+    * @param[out] pSuccess (opcional) indica por punto si se transformo
+    * @return cantidad de puntos transformados
+    */
+   virtual int Transform(double* pX, double* pY, int Count, bool Inverse = false,
+                         int* pSuccess = NULL) const {
+      int result = 0;
+      for (int ix = 0; ix < Count; ++ix) {
+         Coordinates point(pX[ix], pY[ix]);
+         int success = Transform(point, Inverse) != 0 ? 1 : 0;
+         if (success) {
+            pX[ix] = point.x_;
+            pY[ix] = point.y_;
+         }
+         if (pSuccess)
+            pSuccess[ix] = success;
+         result += success;
+      }
+      return result;
+   }
+
    /**
     * Indica si es la transformacon identidad.
     */
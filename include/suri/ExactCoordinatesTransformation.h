@@ -54,7 +54,8 @@ public:
                                     const std::string& WktOut,
                                     bool IsIdentity = true,
                                     OGRCoordinateTransformation* PTransform = NULL,
-                                    OGRCoordinateTransformation* PITransform = NULL);
+                                    OGRCoordinateTransformation* PITransform = NULL,
+                                    const std::string& CacheKey = std::string());
 
    /**
     * Destructor
@@ -74,6 +75,13 @@ public:
    virtual int Transform(std::vector<Coordinates> &CoordinatesP,
                          bool Inverse = false) const;
 
+   /**
+    * Realiza una transformacion exacta de arreglos de coordenadas con una
+    * sola llamada a OGR.
+    */
+   virtual int Transform(double* pX, double* pY, int Count, bool Inverse = false,
+                         int* pSuccess = NULL) const;
+
    /**
     * Realiza una transformacion exacta de las coordenadas en el formato de
     * origen al formato de salida utilizando como salida un Subset.
@@ -101,6 +109,7 @@ private:
    std::string wktOut_; /** Referencia de salida */
    OGRCoordinateTransformation* pTransform_; /** Puntero a la transformacion directa */
    OGRCoordinateTransformation* pITransform_; /** Puntero a la transformacion inversa */
+   std::string cacheKey_; /** Clave en TransformationCache (vacia si no se recicla) */
 };
 
 }  // namespace suri
@@ -75,6 +75,22 @@ public:
    virtual CoordinatesTransformation* Create(const std::string& Type, const suri::ParameterCollection& ParamsP);
 
 private:
+   /**
+    * Crea las transformaciones OGR directa e inversa entre dos referencias.
+    */
+   static void CreateTransformations(OGRSpatialReference& SrIn,
+                                     OGRSpatialReference& SrOut,
+                                     OGRCoordinateTransformation*& pTransform,
+                                     OGRCoordinateTransformation*& pInverseTransform);
+
+   /**
+    * Crea las transformaciones OGR para WKTs ya validados (en el cache).
+    */
+   static void CreateTransformations(const std::string& WktIn,
+                                     const std::string& WktOut,
+                                     OGRCoordinateTransformation*& pTransform,
+                                     OGRCoordinateTransformation*& pInverseTransform);
+
    /**
     * Crea el WKT de salida.
     */
@@ -99,6 +99,10 @@ public:
    static void Close(Image* &pImage);
    /** Inicializa las clases */
    static bool Init();
+   /** Retorna el tipo de acceso con el que se abrio la imagen */
+   ImageAccessType GetAccess() const {
+      return access_;
+   }
 // ------------------- ESCRITURA A IMAGEN EXTERNA -------------------
    /** Salva la imagen en un formato dado con las opciones dadas */
    virtual bool Save(const std::string &Filename, const std::string &Format,
@@ -187,6 +191,12 @@ protected:
                        const std::string &DataType = "void")=0;
    /** Inicializacion en las clases derivadas, se llama al registrarlas */
    virtual void InitializeClass()=0;
+   /** Lee varias bandas con un unico acceso al archivo */
+   virtual bool ReadInterleaved(const std::vector<int> &BandIndex,
+                                std::vector<void*> &Data, int Ulx, int Uly, int Lrx,
+                                int Lry) const {
+      return false;
+   }
    /** tipo para las propiedades comunes */
    typedef std::map<ImageOptionIdType, std::string> OptionsIdMapType;
    /** tipo para los valores mas comunes */
@@ -199,6 +209,9 @@ protected:
    ImageAccessType access_; /*! Acceso a la imagen */
    int bandCount_; /*! Cantidad de bandas */
 private:
+   /** Indica si el subset de las bandas se puede leer directamente de los drivers */
+   bool CanReadInterleaved(const std::vector<int> &BandIndex, int Ulx, int Uly, int Lrx,
+                           int Lry) const;
 };
 
 }  // namespace suri
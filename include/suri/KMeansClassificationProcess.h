@@ -37,6 +37,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 class wxXmlNode;
 class GDALDataset;
+class GDALRasterBand;
 
 /** namespace suri */
 namespace suri {
@@ -47,6 +48,7 @@ class RasterElement;
 class LayerList;
 class Element;
 class DataViewManager;
+class KMeansEngine;
 
 /**
  * Proceso que realiza una clasificacion no supervisada utilizando kmeans como algoritmo
@@ -95,12 +97,15 @@ protected:
     **/
    void ConfigureMetadata(GDALDataset* pDataset, int XOffset, int XBlockSize, int InitialLine,
                            int YBlockSize, const std::string& SpatialReference, GDALDataset* pDestDataset);
-   /** A traves del algoritmo de kmeans clasifica los pixeles del bloque se pasa por parametro **/
-   void ClassifyBlock(std::vector<float*>& BlockData, int BlockSize, int BandCount,
-               double NoDataValue, bool NoDataValueEnable,
-               const std::vector<std::vector<double> >& InitialMeans,
-               std::vector<std::vector<double> >& StepMeans, std::vector<int>& PixelCount,
-               float* pOutputData);
+   /** Carga en el motor de kmeans los pixeles (o una muestra) de la seleccion **/
+   bool LoadPixels(KMeansEngine& Engine, GDALDataset* pDataset, const std::vector<int>& Bands,
+               int XOffset, int XBlockSize, int InitialLine, int FinalLine,
+               double NoDataValue, bool NoDataValueEnable);
+   /** Clasifica la seleccion con las medias finales y escribe el resultado **/
+   bool ClassifyImage(KMeansEngine& Engine, GDALDataset* pDataset,
+               const std::vector<int>& Bands, int XOffset, int XBlockSize, int InitialLine,
+               int FinalLine, double NoDataValue, bool NoDataValueEnable,
+               GDALRasterBand* pDestBand);
 
    /** Obtiene las estadisticas de la imagen **/
    bool GetStatistics(std::vector<int> BandIndex, RasterElement* pRaster, 
@@ -160,11 +165,6 @@ protected:
     */
    double CalculateChange(const std::vector<std::vector<double> > &InitialMeans,
                           const std::vector<std::vector<double> > &NextMean);
-   /** Actuaiza los centroides de las clases */
-   void UpdateMeans(int Classes, int BandCount,
-                  const std::vector< std::vector<double > >& ClassCentreData, 
-                  const std::vector<int>& Histogram,
-                  std::vector<std::vector<double> >& Means);
    /** Configura el elemento creado con la herramienta */
    virtual bool ConfigureOutput();
    /** 
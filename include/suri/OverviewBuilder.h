@@ -0,0 +1,74 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef OVERVIEWBUILDER_H_
+#define OVERVIEWBUILDER_H_
+
+// Includes standard
+#include <string>
+#include <vector>
+
+/** namespace suri */
+namespace suri {
+
+class Image;
+
+/** Genera los niveles de resolucion reducida (piramide) de una imagen */
+/**
+ *  Para imagenes GDAL delega en GdalImage::BuildOverviews, de modo que los
+ * niveles quedan dentro del archivo (GeoTiff) o en un .ovr asociado. Para el
+ * resto de los formatos (ej. RawImage) genera los archivos asociados que
+ * luego lee ImageOverviews, promediando bloques de 2x2 pixeles a partir del
+ * nivel anterior.
+ *  La generacion informa su avance y puede cancelarse con suri::Progress.
+ */
+class OverviewBuilder {
+   /** Ctor. de Copia. */
+   OverviewBuilder(const OverviewBuilder &OverviewBuilder);
+
+public:
+   /** Ctor */
+   explicit OverviewBuilder(Image *pImage);
+   /** Dtor */
+   ~OverviewBuilder();
+   /** Factores de reduccion sugeridos para una imagen de las dimensiones dadas */
+   static std::vector<int> GetDefaultFactors(int SizeX, int SizeY);
+   /** Indica si los niveles con los factores indicados existen y estan actualizados */
+   bool IsUpToDate(const std::vector<int> &Factors) const;
+   /** Genera los niveles con los factores indicados */
+   bool Build(const std::vector<int> &Factors);
+
+private:
+   /** Genera un nivel reduciendo la fuente en el factor indicado */
+   static bool BuildLevel(Image *pSource, int Ratio, const std::string &Filename);
+
+   Image *pImage_; /*! imagen de la que se generan los niveles */
+};
+
+}  // namespace suri
+
+#endif /* OVERVIEWBUILDER_H_ */
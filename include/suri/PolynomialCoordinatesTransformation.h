@@ -133,6 +133,13 @@ public:
    virtual int Transform(std::vector<Coordinates> &CoordinatesVector,
                          bool Inverse = false) const;
 
+   /**
+    * Realiza una transformacion polinomica de arreglos de coordenadas con una
+    * sola llamada a GDAL.
+    */
+   virtual int Transform(double* pX, double* pY, int Count, bool Inverse = false,
+                         int* pSuccess = NULL) const;
+
    /**
     * Realiza una transformacion polinomica de las coordenadas en el formato de
     * origen al formato de salida utilizando como salida un Subset.
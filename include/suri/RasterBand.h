@@ -78,12 +78,20 @@ public:
    void SetSizeY(const int Size);
    /** Retorna un vector con buffers internos de cada banda del subset pedido */
    virtual void* GetBlock(int BlockX, int BlockY)=0;
+   /** Indica que el buffer entregado por GetBlock ya no se usa */
+   virtual void ReleaseBlock(int BlockX, int BlockY);
    /** Llena los punteros del vector con el subset de las bandas pedidas */
    virtual bool Read(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry)=0;
    /** Escribe un bloque de banda */
    virtual void Write(void *pData, int Ulx, int Uly, int Lrx, int Lry)=0;
    /** Escribe un bloque de banda */
    virtual void Write(void *pData, int BlockX, int BlockY)=0;
+   /** Presta el buffer interno de un bloque para leerlo/escribirlo in-place */
+   virtual void* LockBlock(int BlockX, int BlockY);
+   /** Devuelve un bloque prestado con LockBlock */
+   virtual void UnlockBlock(int BlockX, int BlockY, bool Modified = false);
+   /** Indica si algun bloque del subset esta en memoria */
+   virtual bool HasCachedBlocks(int Ulx, int Uly, int Lrx, int Lry);
 // ----------------------------- BLOQUE -----------------------------
    /** Tamanio del bloque X e Y */
    virtual void GetBlockSize(int &SizeX, int &SizeY) const;
@@ -99,6 +107,10 @@ public:
    RasterDriver *GetDriver() const {
       return pDriver_;
    }
+   /** Indica si la banda lee directamente de su driver (sin otras fuentes) */
+   bool IsReadingFromDriver() const {
+      return pDriver_ && pSource_ == pDriver_;
+   }
 protected:
    int sizeX_; /*! tamanio raster en x */
    int sizeY_; /*! tamanio raster en y */
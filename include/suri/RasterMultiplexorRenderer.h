@@ -65,6 +65,9 @@ public:
 // ----------------------- METODOS DE RENDERIZACION -------------------------                       
 	/** Renderiza el elemento dado un World en un Canvas */
 	virtual bool Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pMask);
+	/** No lee por adelantado: trabaja sobre los datos del canvas */
+	virtual void Prefetch(const World *pWorldWindow) {
+	}
 	/** Obtiene el "bounding box" del elemento renderizado */
 	virtual void GetBoundingBox(const World *pWorld, double &Ulx, double &Uly, double &Lrx, double &Lry);
 	/** Obtiene los parametros de entrada del renderer */
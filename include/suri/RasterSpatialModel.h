@@ -158,6 +158,9 @@ public:
    /** Transforma un subset de (pixel, linea) a (x, y) */
    void Transform(Subset &SubsetInOut) const;
 
+   /** Transforma arreglos de P-L a X-Y */
+   void Transform(double* pX, double* pY, size_t Count) const;
+
    /** Transforma de X-Y a P-L */
    void InverseTransform(Coordinates &InOut) const;
    
@@ -167,6 +170,9 @@ public:
    /** Transforma de X-Y a P-L */
    void InverseTransform(std::vector<Coordinates> &InOut) const;
 
+   /** Transforma arreglos de X-Y a P-L */
+   void InverseTransform(double* pX, double* pY, size_t Count) const;
+
    /** */
    void SetDirty(bool Dirty = true) { isDirty_ = Dirty; }
 
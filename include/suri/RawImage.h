@@ -31,6 +31,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 // Includes Estandar
 #include <string>
 #include <map>
+#include <vector>
 
 // Includes Suri
 #include "suri/Image.h"
@@ -43,6 +44,9 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 // forwards
 
 namespace suri {
+
+class ImageOverviews;
+
 namespace core {
 namespace raster {
 namespace dataaccess {
@@ -79,6 +83,10 @@ public:
 protected:
    /** Inicializacion de la clase */
    virtual void InitializeClass();
+   /** Lee varias bandas recorriendo el archivo una sola vez */
+   virtual bool ReadInterleaved(const std::vector<int> &BandIndex,
+                                std::vector<void*> &Data, int Ulx, int Uly, int Lrx,
+                                int Lry) const;
    /** Configura el driver con el interlineado que se pasa por parametro **/
    driver::RawRasterDriver* GetDriver(const std::string &Mux,
                                       const std::string &Filename, int SizeX,
@@ -86,6 +94,9 @@ protected:
    /** Metodo auxiliar que obtiene el offset configurado en las opciones de la imagen **/
    driver::RawRasterDriver::RawDriverOffset GetRawOffset();
    static std::map<std::string, int> DataTypes_;
+
+private:
+   ImageOverviews* pOverviews_; /*! niveles de resolucion reducida del archivo */
 };
 
 } /** namespace dataacess */
@@ -41,11 +41,16 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 // forwards
 
 namespace suri {
+
+class ImageOverviews;
+
 namespace core {
 namespace raster {
 namespace dataaccess {
 namespace driver {
 
+class MemoryMappedFile;
+
 /**
  * Clase base que representa un driver para un archivo "crudo". Es el encargado
  * de encapsular el acceso I/O
@@ -79,7 +84,8 @@ public:
          RasterWriter(WriterName, Filename),
          mux_(Mux), pSucesor_(NULL),
          pWriterFunc_(NULL), bandReaderIndex_(-1),
-         npixels_(Pixels), nlines_(Lines) {
+         npixels_(Pixels), nlines_(Lines), pOverviews_(NULL), ovlevel_(-1),
+         pFile_(NULL) {
       RasterDriver::sizeX_ = Pixels;
       RasterDriver::sizeY_ = Lines;
       RasterWriter::sizeX_ = Pixels;
@@ -87,10 +93,7 @@ public:
       driverName_ = "RawRasterDriver";
    }
    /** dtor **/
-   virtual ~RawRasterDriver() {
-      if (pSucesor_)
-         delete pSucesor_;
-   }
+   virtual ~RawRasterDriver();
    /**
     *  Retorna un buffer interno con los datos
     *  Template method que intenta capturar la solicitud de GetBlock y luego,
@@ -107,11 +110,23 @@ public:
     *  Template method que intenta capturar la solicitud de lectura y luego,
     *  en caso de falla, delega la solicitud a su sucesor.  */
    virtual bool Read(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry) {
+      if (ovlevel_ >= 0)
+         return ReadOverview(pBuffer, Ulx, Uly, Lrx, Lry);
       bool success = DoRead(pBuffer, Ulx, Uly, Lrx, Lry);
       if (!success && pSucesor_)
          success =  pSucesor_->Read(pBuffer, Ulx, Uly, Lrx, Lry);
        return success;
    }
+   /** Carga los buffers con el subset de varias bandas en una sola pasada
+    *  Template method que intenta capturar la solicitud de lectura y luego,
+    *  en caso de falla, delega la solicitud a su sucesor.  */
+   bool ReadBands(const std::vector<int> &BandIndex, std::vector<void*> &Data, int Ulx,
+                  int Uly, int Lrx, int Lry) {
+      bool success = DoReadBands(BandIndex, Data, Ulx, Uly, Lrx, Lry);
+      if (!success && pSucesor_)
+         success = pSucesor_->ReadBands(BandIndex, Data, Ulx, Uly, Lrx, Lry);
+      return success;
+   }
    /** Escribe mas de una banda
     *  Template method que intenta capturar la solicitud de escritura y luego,
     *  en caso de falla, delega la solicitud a su sucesor.  */
@@ -170,6 +185,19 @@ public:
       }
    }
 
+   /** Indica los niveles de resolucion reducida asociados al archivo (no toma
+    *  posesion de la instancia) */
+   void SetOverviews(ImageOverviews* pOverviews) {
+      pOverviews_ = pOverviews;
+      ovlevel_ = -1;
+   }
+   /** Obtiene el size recomendado teniendo en cuenta la existencia de overviews */
+   virtual void CalcRecommendedSize(int XSize, int YSize, int& XRecomm, int& YRecomm);
+   /** Establece el tamanio recomendado y el nivel de overview a utilizar */
+   virtual void SetRecommendedSize(int XRecomm, int YRecomm);
+   /** Resetea el estado de los datos referidos a las dimensiones recomendadas */
+   virtual void ResetRecommendedStatus();
+
    /** Nombre del tipo de dato. Configura de forma recursiva
     *  a sus sucesores el tipo de dato */
    virtual void SetDataType(const std::string& DataType) {
@@ -190,11 +218,33 @@ protected:
    virtual bool DoGetBlockSize(int &SizeX, int &SizeY) const=0;
    /** Carga el buffer con el subset **/
    virtual bool DoRead(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry)=0;
+   /** Carga los buffers con el subset de varias bandas. Por defecto no lo
+    *  soporta y la imagen lee banda por banda (a traves del cache) **/
+   virtual bool DoReadBands(const std::vector<int> &BandIndex, std::vector<void*> &Data,
+                            int Ulx, int Uly, int Lrx, int Lry) {
+      return false;
+   }
    /** Escribe mas de una banda **/
    virtual bool DoWrite(const std::vector<int> &BandIndex, std::vector<void*> &Data,
                         int Ulx, int Uly, int Lrx, int Lry)=0;
    /** Retorna un buffer interno con los datos **/
    virtual void* DoGetBlock(int BlockX, int BlockY)=0;
+   /** Offset en bytes del primer pixel de la linea para la banda indicada **/
+   virtual unsigned long long GetLineOffset(int Line, int Band) const=0;
+   /** Distancia en bytes entre dos pixeles consecutivos de una misma banda **/
+   virtual size_t GetPixelStride() const=0;
+   /** Cantidad de lineas de los bloques (franjas) en los que se lee la banda **/
+   int GetStripHeight() const;
+   /** Copia al buffer la ventana solicitada de la banda desde el archivo mapeado **/
+   bool ReadWindow(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry, int Band);
+   /** Copia a los buffers la ventana solicitada de varias bandas recorriendo
+    *  el archivo una sola vez **/
+   bool ReadWindows(const std::vector<int> &BandIndex, std::vector<void*> &Data,
+                    int Ulx, int Uly, int Lrx, int Lry);
+   /** Retorna un buffer nuevo con el contenido del bloque indicado **/
+   void* ReadBlock(int BlockX, int BlockY);
+   /** Carga el buffer con el subset del nivel de overview seleccionado **/
+   bool ReadOverview(void *pBuffer, int Ulx, int Uly, int Lrx, int Lry);
    std::string mux_;
    RawRasterDriver* pSucesor_;
    WriterFunc* pWriterFunc_;
@@ -203,6 +253,15 @@ protected:
    RawDriverOffset offset_;
    int npixels_;
    int nlines_;
+   ImageOverviews* pOverviews_; /*! niveles de resolucion reducida */
+   int ovlevel_; /*! nivel de overview en uso (-1 resolucion completa) */
+
+private:
+   /** Abre (si es necesario) la vista mapeada del archivo **/
+   MemoryMappedFile* GetFile();
+   /** Tamanio aproximado en bytes de cada franja de lectura **/
+   static const int StripSize = 4 * 1024 * 1024;
+   MemoryMappedFile* pFile_; /*! vista mapeada del archivo (lazy) */
 };
 
 }  /** namespace driver **/
@@ -102,6 +102,15 @@ public:
 // ----------------------- METODOS DE RENDERIZACION -------------------------
    /** Renderiza el elemento dado un World en un Canvas */
    virtual bool Render(const World *pWorldWindow, Canvas* pCanvas, Mask* pMask)=0;
+   /** Anticipa la lectura de los datos de una ventana que se renderizara luego */
+   /**
+    *  Permite que los renderizadores que leen datos (ej. RasterRenderer)
+    * comiencen a leer en segundo plano los datos de la proxima ventana
+    * mientras se procesa la actual. Por defecto no hace nada.
+    * @param[in] pWorldWindow mundo con la ventana que se renderizara luego.
+    */
+   virtual void Prefetch(const World *pWorldWindow) {
+   }
    /** Obtiene el "bounding box" del elemento renderizado */
    /**
     * \pre el subset debe ser seteado antes de llamar a esta funcion con un
@@ -102,6 +102,8 @@ protected:
    void Finalize();
    /** Retorna el estado del sistema para la ultima renderizacion */
    bool GetRenderizationStatus() const;
+   /** Anticipa la lectura de datos para una ventana que se renderizara luego */
+   void Prefetch(const World *pNextWorld);
    LayerList *pRenderizationList_; /*! Lista de elementos */
    LayerList *pMaskList_; /*! Lista de elementos que renderizados generan */
    /* una mascara */
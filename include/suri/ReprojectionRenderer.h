@@ -37,6 +37,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "Renderer.h"
 #include "suri/Image.h"
 #include "suri/Subset.h"
+#include "suri/Resampler.h"
 
 // Includes Wx
 // Defines
@@ -140,7 +141,9 @@ private:
    /** Parametros de RasterRenderer(Tipo de lectura, url, bandas, etc.) */
    class Parameters {
    public:
-      Parameters(): generateMask_(false), noDataValue_(0), pGcpList_(NULL) {}
+      Parameters(): generateMask_(false), noDataValueAvailable_(false),
+                    noDataValue_(0), pGcpList_(NULL),
+                    resampling_(Resampler::NearestNeighbour) {}
       /** enum con metodos de lectura que se usa para leer imagen */
       typedef enum {
          Decimate, Aggregate
@@ -151,7 +154,8 @@ private:
       std::string rasterModel_; /*! info contexto de un SPATIAL_REFERENCE_NODE */
       std::string spatialReference_; /*! info contexto de un RASTER_SPATIAL_MODEL_NODE */
       bool generateMask_;  /*! Generar mascara a partir de datos raster */
-      long long noDataValue_; /*! Valor a tomar como dato no valido */
+      bool noDataValueAvailable_; /*! Indica si hay valor no valido */
+      double noDataValue_; /*! Valor a tomar como dato no valido */
       std::string srOut_; /*! Sistema de Referencia de llegada */
       std::string transformationType_; /*! tipo de transformacion a realizar*/
       int transformationOrder_; /*! Orden de la transformacion (en caso de ser necesario) */
@@ -159,6 +163,7 @@ private:
       GcpList* pGcpList_; /*! lista de puntos de control */
       Subset imageExtent_; /*! Extent de la imagen **/
       int delta_; /** cada cuantas coordenadas hay que sacar una para calcular los GCPs */
+      Resampler::ResamplingType resampling_; /*! Remuestreo de los datos reproyectados */
    };
    /** Metodo auxiliar que carga los parametros necesarios para la renderizacion
     *  que posee el elemento que se pasa por parametro */
@@ -0,0 +1,122 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef RESAMPLER_H_
+#define RESAMPLER_H_
+
+// Includes standard
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/** namespace suri */
+namespace suri {
+
+/** Remuestreo de datos raster con nucleos separables */
+/**
+ *  Implementa remuestreo por vecino mas cercano, bilineal, cubico (Keys,
+ * a=-0.5) y Lanczos (3 lobulos).
+ *  Para grillas regulares (zoom y decimado) los pesos se precalculan por
+ * columna y por fila de salida (WeightTable) y se aplican en dos pasadas:
+ * primero en X sobre cada fila de la fuente y luego en Y. Los ciclos
+ * internos recorren memoria contigua con cantidad fija de pesos para que
+ * el compilador pueda vectorizarlos.
+ *  Cuando se reduce (paso > 1) el nucleo se ensancha segun el paso para
+ * filtrar las altas frecuencias (antialias).
+ *  Para posiciones arbitrarias (reproyeccion) se interpola punto a punto
+ * con el nucleo tabulado.
+ *  Los pixeles de salida cuyo nucleo incluye el valor no valido toman el
+ * valor del pixel mas cercano.
+ */
+class Resampler {
+public:
+   /** Tipos de remuestreo */
+   typedef enum {
+      NearestNeighbour, Bilinear, Cubic, Lanczos
+   } ResamplingType;
+
+   /** Pesos precalculados de un eje para una grilla regular */
+   class WeightTable {
+   public:
+      /** Ctor */
+      WeightTable();
+      /** Calcula los pesos de cada posicion de salida */
+      void Initialize(ResamplingType Type, int OutputSize, double Step, double Offset,
+                      int SourceSize);
+      /** Cantidad de posiciones de salida */
+      int GetSize() const {
+         return static_cast<int>(first_.size());
+      }
+      /** Cantidad de pesos por posicion de salida */
+      int GetTapCount() const {
+         return taps_;
+      }
+      /** Primer indice de la fuente que usa la posicion de salida */
+      int GetFirst(int Position) const {
+         return first_[Position];
+      }
+      /** Pesos de la posicion de salida */
+      const double* GetWeights(int Position) const {
+         return &weights_[Position * taps_];
+      }
+      /** Primer indice de la fuente que se utiliza */
+      int GetSourceBegin() const;
+      /** Indice siguiente al ultimo de la fuente que se utiliza */
+      int GetSourceEnd() const;
+
+   private:
+      std::vector<int> first_; /*! primer indice de fuente por posicion */
+      std::vector<double> weights_; /*! pesos por posicion (taps_ cada una) */
+      int taps_; /*! cantidad de pesos por posicion */
+   };
+
+   /** Funcion que remuestrea una grilla regular (con el valor no valido) */
+   typedef void (*ResampleFunctionType)(const void*, int, int, int, void*,
+                                        const WeightTable&, const WeightTable&, int, int,
+                                        bool, double);
+   /** Funcion que interpola una fila de posiciones arbitrarias (con el valor no valido) */
+   typedef void (*InterpolateFunctionType)(const void*, int, int, const double*,
+                                           const double*, int, ResamplingType, void*,
+                                           bool, double);
+
+   /** Convierte el nombre usado en el xml al tipo de remuestreo */
+   static bool GetType(const std::string &Name, ResamplingType &Type);
+   /** Nombre usado en el xml para el tipo de remuestreo */
+   static std::string GetName(ResamplingType Type);
+   /** Radio del nucleo en pixeles de la fuente */
+   static int GetRadius(ResamplingType Type);
+   /** Peso del nucleo a una distancia dada */
+   static double GetWeight(ResamplingType Type, double Distance);
+   /** Funcion de remuestreo de grilla para un tipo de dato */
+   static ResampleFunctionType GetResampleFunction(const std::string &DataType);
+   /** Funcion de interpolacion de posiciones para un tipo de dato */
+   static InterpolateFunctionType GetInterpolateFunction(const std::string &DataType);
+};
+
+}  // namespace suri
+
+#endif /* RESAMPLER_H_ */
@@ -31,6 +31,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 // Includes Estandar
 #include <vector>
 #include <string>
+#include <map>
 
 // Includes OGR
 #include "ogr_geometry.h"
@@ -42,6 +43,7 @@ class World;
 class Table;
 class Coordinates;
 class SnapInterface;
+class SnapIndex;
 
 /**
  * Herramienta de snapping vectorial que permite ajustar los objetos en edicion a otros objetos
@@ -69,19 +71,23 @@ public:
    void SnapPoint(Coordinates &ViewportPosition);
    /** Crea los buffers de las geometrias de acuerdo al modo seleccionado */
    bool CreateBufferGeometries();
-   /**
-    * Agrega una geometria en los vectores correspondientes al modo configurado en la herramienta
-    */
-   void AddGeometry();
+   /** Actualiza las geometrias de un feature creado o modificado */
+   void UpdateGeometry(long FeatureId);
+   /** Elimina las geometrias de un feature eliminado */
+   void RemoveGeometry(long FeatureId);
 
 private:
-   /** Crea las geometrias existentes en la capa con OGR y sus buffers correspondientes */
-   void CreateSegmentBuffers();
+   /** Elimina las geometrias, buffers e indices */
+   void ClearGeometries();
    /**
-    * Crea las geometrias existentes en la capa con OGR y los buffers correspondientes
-    * a sus vertices
+    * Crea la geometria de una fila con OGR y sus buffers y la agrega en los
+    * vectores e indices correspondientes al modo configurado en la herramienta
     */
-   void CreateVertexBuffers();
+   void AddFeatureGeometries(long FeatureId, int Row);
+   /** Elimina las geometrias de un feature de los vectores e indices */
+   void RemoveFeatureGeometries(long FeatureId);
+   /** Configura las geometrias e indices en la estrategia */
+   void ConfigureStrategy();
    /** Calcula la distancia correspondiente de acuerdo a la unidad configurada */
    double CalculateBufferDistance();
    /** Retorna la cantidad de puntos por las que esta conformada una geometria */
@@ -101,6 +107,10 @@ private:
    std::string rastermodel_;
    /** Vector con buffers de vertices y segmentos */
    std::vector<OGRGeometry*> segmentbuffers_, vertexbuffers_, segmentgeometries_, vertexgeometries_;
+   /** Posiciones en los vectores de segmentos y vertices de cada feature */
+   std::map<long, std::vector<int> > featuresegments_, featurevertices_;
+   /** Indices espaciales de vertices y segmentos */
+   SnapIndex *pVertexIndex_, *pSegmentIndex_;
    /** Sistema de referencia de la capa */
    OGRSpatialReference srs_;
 };
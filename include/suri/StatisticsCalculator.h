@@ -29,6 +29,9 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #define STATISTICSCALCULATOR_H_
 
 // Includes Estandar
+#include <string>
+#include <vector>
+
 // Includes Suri
 #include "SRDStatistics.h"
 #include "SRDHistogram.h"
@@ -89,6 +92,26 @@ public:
                            const std::vector<double>& Min = std::vector<double>(),
                            const std::vector<double>& Max = std::vector<double>());
 
+   /**
+    * Configura el modo aproximado. En modo aproximado se reduce la resolucion
+    * del mundo a la cantidad de muestras necesaria para el error pedido, por lo
+    * que se lee el overview mas chico que la cubre (o se decima la imagen).
+    * @param[in] Approximate indica si se calcula en modo aproximado
+    * @param[in] ErrorTarget error maximo admitido en la distribucion acumulada
+    * (ej: 0.005 equivale a medio percentil). Si es <= 0 se usa el configurado.
+    */
+   void SetApproximate(bool Approximate, double ErrorTarget = 0.0);
+
+   /**
+    * Devuelve la cantidad de pixeles (por banda) leidos en el ultimo calculo.
+    */
+   long GetSampleCount() const;
+
+   /**
+    * Devuelve la cantidad de muestras necesaria para el error pedido.
+    */
+   static long GetRequiredSampleCount(double ErrorTarget);
+
 private:
    /**
     * Metodo auxiliar que realiza el calculo de estadistica e histograma.
@@ -110,6 +133,13 @@ private:
     */
    void ConfigureWorld(World *pWorld) ;
 
+   /**
+    * Arma la clave de la cache de estadisticas para el calculo pedido.
+    */
+   std::string GetCacheKey(World *pWorld, bool CalculateHistogram, bool ComputeAllBands,
+                           bool InterBandStats, const std::vector<double>& Min,
+                           const std::vector<double>& Max);
+
    /**
     * Agrega un elemento a la lista.
     * @param[in] pList Lista con el elemento a renderizar
@@ -134,6 +164,10 @@ private:
    RasterElement* pElement_;
 
    bool useViewer_;
+   bool approximate_;  // Calculo aproximado sobre una muestra.
+   double errorTarget_;  // Error admitido en modo aproximado.
+   long sampleCount_;  // Pixeles leidos en el ultimo calculo.
+   bool fullExtent_;  // Si el ultimo mundo configurado cubre toda la imagen.
 };
 
 } /** namespace raster **/
@@ -0,0 +1,133 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef TRANSFORMATIONCACHE_H_
+#define TRANSFORMATIONCACHE_H_
+
+// Includes standard
+#include <cstddef>
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Includes gdal
+#include <ogr_spatialref.h>
+
+// forwards wx
+class wxMutex;
+
+/** namespace suri */
+namespace suri {
+
+/** Cache de transformaciones de coordenadas compartido por todo el proceso */
+/**
+ *  Evita que cada renderizacion (o movimiento del mouse) vuelva a validar y
+ * parsear los WKT y a crear las transformaciones OGR.
+ *  Para cada clave (tipo de transformacion y WKT normalizados) recuerda el
+ * resultado de la creacion (invalida, identidad o transformacion) y guarda
+ * las transformaciones OGR de las instancias destruidas para entregarlas a
+ * las siguientes. Cada instancia viva usa sus propias transformaciones OGR
+ * (no son seguras para uso concurrente), el cache solo las recicla.
+ *  Las claves con instancias vivas no se eliminan. La cantidad de claves se
+ * toma de la configuracion (lib_transformation_cache_size) la primera vez
+ * que se utiliza el cache.
+ */
+class TransformationCache {
+   /** Ctor. de Copia. */
+   TransformationCache(const TransformationCache &TransformationCache);
+
+public:
+   /** Resultado de crear la transformacion de una clave */
+   typedef enum {
+      Unknown, Invalid, Identity, Transformation
+   } ResultType;
+
+   /** Dtor */
+   ~TransformationCache();
+   /** Retorna la instancia del cache (singleton) */
+   static TransformationCache& Instance();
+   /** Arma la clave de una transformacion */
+   static std::string GetKey(const std::string &Type, const std::string &WktIn,
+                             const std::string &WktOut);
+   /** Busca el resultado de una clave y entrega transformaciones libres */
+   ResultType Acquire(const std::string &Key, std::string &WktOut,
+                      OGRCoordinateTransformation* &pTransform,
+                      OGRCoordinateTransformation* &pInverseTransform);
+   /** Registra el resultado de crear la transformacion de una clave */
+   void Insert(const std::string &Key, ResultType Result, const std::string &WktOut);
+   /** Devuelve las transformaciones de una instancia destruida */
+   void Release(const std::string &Key, OGRCoordinateTransformation* pTransform,
+                OGRCoordinateTransformation* pInverseTransform);
+   /** Elimina las claves sin instancias vivas */
+   void Clear();
+   /** Establece la cantidad maxima de claves */
+   void SetCapacity(size_t Capacity);
+   /** Retorna la cantidad maxima de claves */
+   size_t GetCapacity() const;
+   /** Cantidad de busquedas con resultado conocido */
+   unsigned long GetHitCount() const;
+   /** Cantidad de busquedas sin resultado conocido */
+   unsigned long GetMissCount() const;
+   /** Reinicia los contadores */
+   void ResetCounters();
+
+private:
+   /** Ctor */
+   TransformationCache();
+   /** Par de transformaciones directa e inversa */
+   typedef std::pair<OGRCoordinateTransformation*, OGRCoordinateTransformation*> PairType;
+   /** Entrada del cache */
+   struct Entry {
+      /** Ctor */
+      Entry() :
+            result_(Unknown), inUse_(0) {
+      }
+      ResultType result_; /*! resultado de la creacion */
+      std::string wktOut_; /*! wkt de salida resuelto */
+      std::vector<PairType> idle_; /*! transformaciones libres */
+      int inUse_; /*! instancias vivas */
+      std::list<std::string>::iterator lru_; /*! posicion en la lista de uso */
+   };
+   /** Indice de entradas */
+   typedef std::map<std::string, Entry> EntryMapType;
+   /** Elimina entradas hasta respetar la capacidad */
+   void Evict();
+   /** Destruye las transformaciones libres de una entrada */
+   static void DestroyIdle(Entry &EntryP);
+   std::list<std::string> lru_; /*! claves ordenadas por uso */
+   EntryMapType entries_; /*! entradas por clave */
+   size_t capacity_; /*! cantidad maxima de claves */
+   unsigned long hits_; /*! busquedas con resultado conocido */
+   unsigned long misses_; /*! busquedas sin resultado conocido */
+   wxMutex *pMutex_; /*! protege el acceso concurrente */
+};
+
+}  // namespace suri
+
+#endif /* TRANSFORMATIONCACHE_H_ */
@@ -118,6 +118,10 @@ public:
    virtual void InverseTransform(const Coordinates &World, Coordinates &Viewport) const;
    /** Transforma las coordenadas de Viewport en coordenadas de Mundo */
    virtual void Transform(const Coordinates &Viewport, Coordinates &World) const;
+   /** Transforma arreglos de coordenadas de Mundo en coordenadas de Viewport */
+   virtual void InverseTransform(double* pX, double* pY, size_t Count) const;
+   /** Transforma arreglos de coordenadas de Viewport en coordenadas de Mundo */
+   virtual void Transform(double* pX, double* pY, size_t Count) const;
 // ------------------- CONSULTA -------------------
    /** retorna true si el mundo esta inicializado, viewport!=0 y tiene wkt_ no nulo */
    virtual bool IsInitialized() const;
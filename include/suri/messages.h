@@ -963,6 +963,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Raster------------------------------------------------------------------------
 #define message_READING_BANDS "Leyendo Bandas"
+#define message_BUILDING_OVERVIEWS "Generando vistas de resolucion reducida"
 #define BAND_NAME_PREFIX_d "Banda #%d"
 #define message_INVALID_NO_DATA_VALUE "Valor de dato no valido incorrecto"
 #define message_ALL_BANDS_INVALID_ERROR "Debe existir alguna banda valida en la imagen"
@@ -1737,6 +1738,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #define message_INVALID_COLUMN_FIELD "El item seleccionado no corresponde a un campo"
 #define message_DUPLICATED_ITEM "El item seleccionado ya existe en la capa destino"
 #define message_DIFFERENT_LAYER_TYPES "No pueden fusionarse capas de diferentes tipos"
+#define message_PROCESSING_VECTOR_OPERATION "Procesando operacion vectorial"
 
 #define message_WRONG_BAND_COUNT "La cantidad de bandas del elemento seleccionado no concuerda " \
    "con la cantidad de registros en las firmas seleccionadas."
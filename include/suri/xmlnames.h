@@ -216,6 +216,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #     define REPROJECTION_TYPE_COEFFICIENT_NODE "coeficientes"
 #     define REPROJECTION_TYPE_GCPLIST_NODE "GCPList"
 #     define REPROJECTION_TYPE_DELTA_NODE "delta"
+#     define REPROJECTION_TYPE_RESAMPLING_NODE "remuestreo"
 #        define   REPROJECTION_TYPE_GCPLIST_URL_NODE "url"
 #        define   REPROJECTION_TYPE_GCPLIST_GCP_NODE "GCP"
 #  define CANVAS_CACHE_NODE "cache"
@@ -288,6 +289,8 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #define ALGORITHM_VALUE_KERNELFILTER "KernelFilter"
 #define ALGORITHM_VALUE_MAYORITYFILTER "MayorityFilter"
 #define ALGORITHM_VALUE_MINORITYFILTER "MinorityFilter"
+#define ALGORITHM_VALUE_MEDIANFILTER "MedianFilter"
+#define ALGORITHM_VALUE_MODEFILTER "ModeFilter"
 #define FILTER_WITDH "ColumnasFiltro"
 #define FILTER_HEIGHT "FilasFiltro"
 
@@ -486,6 +489,8 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #define NAME_PROPERTY_VALUE_UNKNOWN "desconocido"
 #define INTERPOLATION_PROPERTY_VALUE_NEAREST_NEIGHBOUR "NN"
 #define INTERPOLATION_PROPERTY_VALUE_CUBIC_COMBOLUTION "CC"
+#define INTERPOLATION_PROPERTY_VALUE_BILINEAR "BL"
+#define INTERPOLATION_PROPERTY_VALUE_LANCZOS "LZ"
 
 #define COLOR_TABLE_LABELS    "etiquetas"
 #define COLOR_TABLE_BOUNDARY  "limite"
@@ -0,0 +1,195 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#include "BlockEquationEvaluatorTest.h"
+
+// Includes estandar
+#include <cmath>
+#include <limits>
+#include <vector>
+// Includes Suri
+#include "BlockEquationEvaluator.h"
+#include "EquationParser.h"
+#include "suri/AuxiliaryFunctions.h"
+// Includes Wx
+// Includes App
+// Defines
+/** Cantidad de pixeles de la prueba (varios bloques y uno incompleto) */
+#define TEST_PIXEL_COUNT (2 * BLOCK_EQUATION_SIZE + 123)
+/** Valor no valido de las bandas de prueba */
+#define TEST_NO_DATA_VALUE 0
+/** Error relativo admitido (muParser puede reordenar operaciones) */
+#define TEST_RELATIVE_EPSILON 0.000000001
+
+/** namespace suri */
+namespace suri {
+
+/**
+ * Constructor
+ */
+BlockEquationEvaluatorTest::BlockEquationEvaluatorTest() {
+}
+
+/**
+ * Destructor
+ */
+BlockEquationEvaluatorTest::~BlockEquationEvaluatorTest() {
+}
+
+/**
+ * Compara operadores aritmeticos, funciones, constantes y precedencias.
+ */
+void BlockEquationEvaluatorTest::TestArithmetic() {
+   CPPUNIT_ASSERT_MESSAGE("Falla suma y producto",
+                          CompareWithEquationParser("b1 + b2 * b3 - 2.5"));
+   CPPUNIT_ASSERT_MESSAGE("Falla potencia y menos unario",
+                          CompareWithEquationParser("-b1^2 + b2^0.5 * 3e-1"));
+   CPPUNIT_ASSERT_MESSAGE(
+         "Falla funciones",
+         CompareWithEquationParser("sin(b1) + abs(b2 - b3) * rint(b3 / 7)"));
+   CPPUNIT_ASSERT_MESSAGE(
+         "Falla funciones de n argumentos",
+         CompareWithEquationParser("min(b1, b2, b3) + max(b1, 4) - avg(b1, b2, b3)"));
+   CPPUNIT_ASSERT_MESSAGE("Falla constantes",
+                          CompareWithEquationParser("b1 * _pi + _e * (2 + 3)"));
+}
+
+/**
+ * Las bandas tienen ceros: la division da infinito o NaN y el modulo NaN.
+ */
+void BlockEquationEvaluatorTest::TestDivisionByZero() {
+   CPPUNIT_ASSERT_MESSAGE("Falla division por cero", CompareWithEquationParser("b1 / b2"));
+   CPPUNIT_ASSERT_MESSAGE("Falla indice normalizado",
+                          CompareWithEquationParser("(b1 - b2) / (b1 + b2)"));
+   CPPUNIT_ASSERT_MESSAGE("Falla modulo por cero", CompareWithEquationParser("b1 % b2"));
+   CPPUNIT_ASSERT_MESSAGE("Falla logaritmo de cero",
+                          CompareWithEquationParser("log(b2) + sqrt(b1)"));
+}
+
+/**
+ * Ecuaciones que asignan un valor a los pixeles con el valor no valido.
+ * La tercer banda tiene ademas NaN.
+ */
+void BlockEquationEvaluatorTest::TestNoDataValue() {
+   CPPUNIT_ASSERT_MESSAGE("Falla con valor no valido",
+                          CompareWithEquationParser("b2 == 0 ? 0 : b1 / b2"));
+   CPPUNIT_ASSERT_MESSAGE(
+         "Falla con valor no valido en dos bandas",
+         CompareWithEquationParser("b1 != 0 and b2 != 0 ? (b1 - b2) / (b1 + b2) : -1"));
+   CPPUNIT_ASSERT_MESSAGE("Falla con NaN",
+                          CompareWithEquationParser("b3 * 2 + b1"));
+   CPPUNIT_ASSERT_MESSAGE("Falla condicional con NaN",
+                          CompareWithEquationParser("b3 ? b1 : b2"));
+}
+
+/**
+ * Compara comparaciones, operadores logicos y condicionales anidados.
+ */
+void BlockEquationEvaluatorTest::TestLogicalOperators() {
+   CPPUNIT_ASSERT_MESSAGE(
+         "Falla comparaciones",
+         CompareWithEquationParser("(b1 < b2) + (b1 >= b3) * 2 + (b1 == b3) * 4"));
+   CPPUNIT_ASSERT_MESSAGE(
+         "Falla operadores logicos",
+         CompareWithEquationParser("(b1 > 10 && b2 < 50) || (!b3 xor (b1 or b2))"));
+   CPPUNIT_ASSERT_MESSAGE(
+         "Falla condicional anidado",
+         CompareWithEquationParser("b1 > b2 ? (b1 > b3 ? 1 : 2) : (b2 > b3 ? 3 : 4)"));
+}
+
+/**
+ * Las ecuaciones invalidas no compilan.
+ */
+void BlockEquationEvaluatorTest::TestInvalidEquations() {
+   std::vector<std::string> variablenames;
+   variablenames.push_back("b1");
+   variablenames.push_back("b2");
+   BlockEquationEvaluator evaluator;
+   CPPUNIT_ASSERT_MESSAGE("Compila variable inexistente",
+                          !evaluator.Compile("b1 + b3", variablenames));
+   CPPUNIT_ASSERT_MESSAGE("Compila funcion inexistente",
+                          !evaluator.Compile("foo(b1)", variablenames));
+   CPPUNIT_ASSERT_MESSAGE("Compila ecuacion incompleta",
+                          !evaluator.Compile("b1 +", variablenames));
+   CPPUNIT_ASSERT_MESSAGE("Compila parentesis sin cerrar",
+                          !evaluator.Compile("(b1 + b2", variablenames));
+   CPPUNIT_ASSERT_MESSAGE("Compila cantidad de argumentos erronea",
+                          !evaluator.Compile("sin(b1, b2)", variablenames));
+}
+
+/**
+ * Evalua la ecuacion por bloques sobre tres bandas y compara cada pixel con
+ * el resultado de EquationParser. Las bandas tienen el valor no valido en
+ * todas las bandas (pixeles multiplo de 11), en la segunda banda (multiplos de
+ * 7) y NaN en la tercera (multiplos de 97).
+ * @param[in] Equation ecuacion sobre las variables b1, b2 y b3
+ * @return true si ambos resultados coinciden en todos los pixeles
+ */
+bool BlockEquationEvaluatorTest::CompareWithEquationParser(const std::string &Equation) {
+   EquationParser eqparser;
+   if (!eqparser.SetEquation(Equation))
+      return false;
+   std::vector<std::string> variablenames;
+   eqparser.GetVariableNames(variablenames);
+
+   std::vector<std::vector<double> > values(variablenames.size(),
+                                            std::vector<double>(TEST_PIXEL_COUNT));
+   std::vector<const double*> pvalues(variablenames.size());
+   std::vector<double*> pvariables(variablenames.size());
+   for (size_t j = 0; j < variablenames.size(); j++) {
+      eqparser.GetVariableValuePointer(variablenames[j], pvariables[j]);
+      int band = variablenames[j] == "b1" ? 0 : variablenames[j] == "b2" ? 1 : 2;
+      for (int p = 0; p < TEST_PIXEL_COUNT; p++) {
+         double value = (p * (13 + 4 * band) + 5 * band) % 211 - 40 + (p % 4) * 0.25;
+         if (p % 11 == 0 || (p % 7 == 0 && band == 1))
+            value = TEST_NO_DATA_VALUE;
+         if (p % 97 == 0 && band == 2)
+            value = std::numeric_limits<double>::quiet_NaN();
+         values[j][p] = value;
+      }
+      pvalues[j] = &values[j][0];
+   }
+
+   BlockEquationEvaluator evaluator;
+   if (!evaluator.Compile(Equation, variablenames))
+      return false;
+   std::vector<double> result(TEST_PIXEL_COUNT);
+   evaluator.Evaluate(pvalues, TEST_PIXEL_COUNT, &result[0]);
+
+   for (int p = 0; p < TEST_PIXEL_COUNT; p++) {
+      for (size_t j = 0; j < variablenames.size(); j++)
+         *(pvariables[j]) = values[j][p];
+      double expected = eqparser.EvaluateEquation();
+      if (result[p] != expected && !(SURI_ISNAN(expected) && SURI_ISNAN(result[p]))
+            && !FLOAT_COMPARE_WITH_PRECISION(expected, result[p], TEST_RELATIVE_EPSILON,
+                                             0.0))
+         return false;
+   }
+   return true;
+}
+
+}  // namespace suri
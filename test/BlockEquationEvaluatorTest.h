@@ -0,0 +1,82 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef BLOCKEQUATIONEVALUATORTEST_H_
+#define BLOCKEQUATIONEVALUATORTEST_H_
+
+// Includes estandar
+#include <string>
+// Includes Suri
+#include "suri/Tests.h"
+// Includes Wx
+// Includes App
+// Defines
+
+/** namespace suri */
+namespace suri {
+/** Compara la evaluacion por bloques de ecuaciones con EquationParser */
+class BlockEquationEvaluatorTest : public CPPUNIT_NS::TestFixture {
+   /** Inicializa test para la clase BlockEquationEvaluatorTest. Invoca a setUp. */
+   CPPUNIT_TEST_SUITE(BlockEquationEvaluatorTest);
+      /** Evalua resultado de TestArithmetic */
+      CPPUNIT_TEST(TestArithmetic);
+      /** Evalua resultado de TestDivisionByZero */
+      CPPUNIT_TEST(TestDivisionByZero);
+      /** Evalua resultado de TestNoDataValue */
+      CPPUNIT_TEST(TestNoDataValue);
+      /** Evalua resultado de TestLogicalOperators */
+      CPPUNIT_TEST(TestLogicalOperators);
+      /** Evalua resultado de TestInvalidEquations */
+      CPPUNIT_TEST(TestInvalidEquations);
+      /** Finaliza test. Invoca a tearDown. */
+      CPPUNIT_TEST_SUITE_END()
+   ;
+public:
+   /** Ctor. */
+   BlockEquationEvaluatorTest();
+   /** Dtor. */
+   virtual ~BlockEquationEvaluatorTest();
+protected:
+// Tests
+   /** Operadores aritmeticos, funciones y precedencias */
+   void TestArithmetic();
+   /** Division y modulo por cero */
+   void TestDivisionByZero();
+   /** Ecuaciones que excluyen el valor no valido y NaN */
+   void TestNoDataValue();
+   /** Comparaciones, operadores logicos y condicional */
+   void TestLogicalOperators();
+   /** Ecuaciones que no compilan */
+   void TestInvalidEquations();
+
+// Metodos internos
+   /** Compara el resultado por bloques con el de EquationParser pixel a pixel */
+   bool CompareWithEquationParser(const std::string &Equation);
+};
+}
+
+#endif /* BLOCKEQUATIONEVALUATORTEST_H_ */
@@ -28,10 +28,17 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "MaxLikelihoodTest.h"
 
 // Includes estandar
+#include <algorithm>
+#include <cmath>
+#include <limits>
 // Includes Suri
 #include "suri/StatisticsFunctions.h"
+#include "suri/DataTypes.h"
 #include "ClassificationRenderer.h"
 #include "MaxLikelihoodPart.h"
+#include "MaxLikelihoodAlgorithm.h"
+#include "MathFunctions.h"
+#include "SRDStatistics.h"
 #include "suri/Configuration.h"
 // Includes Wx
 #include "wx/sstream.h"
@@ -42,6 +49,90 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 /** namespace suri */
 namespace suri {
+/**
+ * Clasifica todos los pixeles con maxima verosimilitud pixel a pixel, tal
+ * como lo hacia MaxLikelihoodAlgorithm antes de usar ClassificationEngine.
+ * Se usa como referencia para verificar que la clasificacion por tiles de el
+ * mismo resultado.
+ * @param[out] pDest clase asignada a cada pixel
+ * @param[in] Source bandas de entrada
+ * @param[in] Size cantidad de pixeles
+ * @param[in] NoClassPixelValue valor asignado a los pixels no clasificados
+ * @param[in] NDVPixelValue valor asignado a los pixels no validos
+ * @param[in] NdvAvailable indica si se descartan los pixeles no validos
+ * @param[in] Threshold umbral (0 a 100)
+ * @param[in] pClusters estadisticas de las clases
+ */
+template<typename T>
+void PerPixelMaxLikelihood(int* pDest, std::vector<void*> &Source, size_t Size,
+                           int NoClassPixelValue, int NDVPixelValue, bool NdvAvailable,
+                           double Threshold, Clusters* pClusters) {
+   std::vector<T*> psrc;
+   for (size_t i = 0; i < Source.size(); i++)
+      psrc.push_back(static_cast<T*>(Source[i]));
+
+   const std::vector<Clusters::ClusterData>& clusters = pClusters->GetClusterVector();
+   int classcount = clusters.size();
+   double threshold = log(Threshold / 100);
+
+   std::vector<std::vector<std::vector<double> > > lumatrices(classcount);
+   for (int i = 0; i < classcount; i++)
+      CalculateLu(clusters[i].pStatistics_->GetCovarianceMatrix(), lumatrices[i]);
+   int matrixsize = clusters[0].pStatistics_->GetBandCount();
+   std::vector<double> pixelvalues(matrixsize);
+   std::vector<double> partialinverse(matrixsize);
+   std::vector<double> inverse(matrixsize);
+
+   std::vector<double> constants(classcount);
+   for (int classpos = 0; classpos < classcount; classpos++) {
+      double determinant = lumatrices[classpos][0][0];
+      for (int j = 1; j < matrixsize; j++)
+         determinant *= lumatrices[classpos][j][j];
+      constants[classpos] = -log(classcount) - log(determinant) / 2 -
+                                          classcount / 2 * log(2 * 3.14159265);
+   }
+
+   for (size_t pixelposition = 0; pixelposition < Size; pixelposition++) {
+      int pixelclass = NoClassPixelValue;
+      bool invalidpixel = NdvAvailable;
+      for (int i = 0; i < matrixsize && invalidpixel; ++i)
+         if (static_cast<double>(psrc[i][pixelposition]) != CLASSIFICATION_NDV)
+            invalidpixel = false;
+      if (invalidpixel) {
+         pDest[pixelposition] = NDVPixelValue;
+         continue;
+      }
+      double pixelclassprobability = -std::numeric_limits<double>::max();
+      for (int classpos = 0; classpos < classcount; classpos++) {
+         for (int i = 0; i < matrixsize; i++)
+            pixelvalues[i] = static_cast<double>(psrc[i][pixelposition])
+                                   - clusters[classpos].pStatistics_->pMean_[i];
+         for (int i = 0; i < matrixsize; i++) {
+            partialinverse[i] = pixelvalues[i];
+            for (int j = 0; j < i; j++)
+               partialinverse[i] -= partialinverse[j] * lumatrices[classpos][i][j];
+         }
+         for (int i = matrixsize - 1; i >= 0; i--) {
+            inverse[i] = partialinverse[i];
+            for (int j = matrixsize - 1; j > i; j--)
+               inverse[i] -= inverse[j] * lumatrices[classpos][i][j];
+            inverse[i] = inverse[i] / lumatrices[classpos][i][i];
+         }
+         double tempclassprobability = 0;
+         for (int i = 0; i < matrixsize; i++)
+            tempclassprobability += inverse[i] * pixelvalues[i];
+         tempclassprobability = -tempclassprobability / 2;
+         double finalclassprobability = constants[classpos] + tempclassprobability;
+         if (tempclassprobability > threshold
+               && finalclassprobability > pixelclassprobability) {
+            pixelclass = clusters[classpos].classId_;
+            pixelclassprobability = finalclassprobability;
+         }
+      }
+      pDest[pixelposition] = pixelclass;
+   }
+}
+
 /**
  * Constructor
  */
@@ -224,6 +315,39 @@ void MaxLikelihoodTest::TestNodeToClassificationRenderer() {
    delete pnewclassifalgorithm;
 }
 
+/**
+ * Compara la clasificacion de MaxLikelihoodAlgorithm (por tiles) con la
+ * clasificacion pixel a pixel para uchar y double, con y sin valor no valido.
+ */
+void MaxLikelihoodTest::TestClassifyMatchesPerPixel() {
+   CPPUNIT_ASSERT_MESSAGE("Error al clasificar uchar sin valor no valido",
+                          CompareWithPerPixel<unsigned char>(false));
+   CPPUNIT_ASSERT_MESSAGE("Error al clasificar uchar con valor no valido",
+                          CompareWithPerPixel<unsigned char>(true));
+   CPPUNIT_ASSERT_MESSAGE("Error al clasificar double sin valor no valido",
+                          CompareWithPerPixel<double>(false));
+   CPPUNIT_ASSERT_MESSAGE("Error al clasificar double con valor no valido",
+                          CompareWithPerPixel<double>(true));
+}
+
+/**
+ * Sin clases el nucleo no usa bandas, la clasificacion debe fallar sin
+ * escribir la salida.
+ */
+void MaxLikelihoodTest::TestClassifyWithoutClasses() {
+   MaxLikelihoodAlgorithm algorithm;
+   algorithm.SetThreshold(10);
+   std::vector<unsigned char> band(10, 1);
+   std::vector<void*> source(1, &band[0]);
+   std::vector<int> result(band.size(), -1);
+   bool classified = algorithm.Classify(&result[0], source, band.size(),
+                                        DataInfo<unsigned char>::Name);
+   CPPUNIT_ASSERT_MESSAGE("Se clasifico sin clases", !classified);
+   CPPUNIT_ASSERT_MESSAGE("Se modifico la salida sin clases",
+                          std::count(result.begin(), result.end(), -1)
+                                == static_cast<int>(result.size()));
+}
+
 /**
  * Carga una variable de tipo Statistics
  * @param[out] ClassStatistics estadisticas
@@ -260,6 +384,71 @@ void MaxLikelihoodTest::LoadStatistics(Statistics &ClassStatistics) {
    ClassStatistics.covarianceMatrix_.push_back(filetable);
 }
 
+/**
+ * Entrena tres clases con muestras de 3 bandas y clasifica una imagen de dos
+ * tiles completos y uno parcial. El primer tile tiene pixeles con valor no
+ * valido en todas las bandas y en una sola banda, el segundo tiene todos sus
+ * pixeles no validos.
+ * @param[in] NdvAvailable indica si se descartan los pixeles no validos
+ * @return true si la clasificacion por tiles coincide con la de referencia
+ */
+template<typename T>
+bool MaxLikelihoodTest::CompareWithPerPixel(bool NdvAvailable) {
+   const int bandcount = 3;
+   const int classcount = 3;
+   const int samplecount = 200;
+   const size_t size = 2 * 1024 + 37;
+
+   // Muestras de entrenamiento alrededor de un centro por clase
+   std::vector<raster::data::StatisticsBase*> statistics;
+   MaxLikelihoodAlgorithm algorithm;
+   for (int c = 0; c < classcount; c++) {
+      std::vector<std::vector<T> > samples(bandcount, std::vector<T>(samplecount));
+      std::vector<void*> data;
+      for (int b = 0; b < bandcount; b++) {
+         for (int s = 0; s < samplecount; s++)
+            samples[b][s] = static_cast<T>(40 + 60 * c + (s * (7 + 3 * b) + b * 11) % 23
+                                           + (s * s + c) % (5 + b));
+         data.push_back(&samples[b][0]);
+      }
+      raster::data::Statistics<T>* pstatistics =
+            new raster::data::Statistics<T>(bandcount);
+      pstatistics->Process(samplecount, data);
+      statistics.push_back(pstatistics);
+      algorithm.GetClusters()->AddCluster(c + 1, pstatistics);
+   }
+   algorithm.SetThreshold(5);
+   algorithm.SetNoClassPixelValue(0);
+   algorithm.SetNDVPixelValue(255);
+   algorithm.SetNoDataValueAvailable(NdvAvailable);
+
+   // Imagen a clasificar
+   std::vector<std::vector<T> > image(bandcount, std::vector<T>(size));
+   std::vector<void*> source;
+   for (int b = 0; b < bandcount; b++) {
+      for (size_t p = 0; p < size; p++) {
+         if ((p >= 1024 && p < 2048) || p % 50 == 0)
+            image[b][p] = static_cast<T>(CLASSIFICATION_NDV);
+         else if (p % 50 == 1 && b == 0)
+            image[b][p] = static_cast<T>(CLASSIFICATION_NDV);
+         else
+            image[b][p] = static_cast<T>(40 + 60 * (p / 3 % 3)
+                                           + (p * (7 + 3 * b) + b * 11) % 29);
+      }
+      source.push_back(&image[b][0]);
+   }
+
+   std::vector<int> result(size, -1);
+   std::vector<int> expected(size, -2);
+   bool classified = algorithm.Classify(&result[0], source, size, DataInfo<T>::Name);
+   PerPixelMaxLikelihood<T>(&expected[0], source, size, 0, 255, NdvAvailable, 5,
+                            algorithm.GetClusters());
+
+   for (size_t i = 0; i < statistics.size(); i++)
+      delete statistics[i];
+   return classified && result == expected;
+}
+
 /**
  * Compara dos vectores. Compara los tamanios y cada uno de los valores.
  * @param[in] Vector1 vector que se quiere comparar
@@ -49,6 +49,10 @@ class MaxLikelihoodTest : public CPPUNIT_NS::TestFixture {
       CPPUNIT_TEST(TestClassificationRendererToNode);
       /** Evalua resultado de TestNodeToClassificationRenderer */
       CPPUNIT_TEST(TestNodeToClassificationRenderer);
+      /** Evalua resultado de TestClassifyMatchesPerPixel */
+      CPPUNIT_TEST(TestClassifyMatchesPerPixel);
+      /** Evalua resultado de TestClassifyWithoutClasses */
+      CPPUNIT_TEST(TestClassifyWithoutClasses);
       /** Finaliza test. Invoca a tearDown. */
       CPPUNIT_TEST_SUITE_END()
    ;
@@ -65,10 +69,17 @@ protected:
    void TestClassificationRendererToNode();
    /** Analizo si MaxLikelihoodAlgorith::Update funciona correctamente */
    void TestNodeToClassificationRenderer();
+   /** Compara la clasificacion por tiles con la clasificacion pixel a pixel */
+   void TestClassifyMatchesPerPixel();
+   /** Analiza que la clasificacion sin clases falle sin acceder a las bandas */
+   void TestClassifyWithoutClasses();
 
 // Metodos internos
    /** Carga estadisticas default */
    void LoadStatistics(Statistics &ClassStatistics);
+   /** Compara la clasificacion por tiles y pixel a pixel para un tipo de dato */
+   template<typename T>
+   bool CompareWithPerPixel(bool NdvAvailable);
    /** Compara dos vectores(dim y contenido) */
    bool TestVector(std::vector<double> &Vector1, std::vector<double> &Vector2);
    /** Compara dos matrices(dim y contenido) */
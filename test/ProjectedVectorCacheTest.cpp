@@ -0,0 +1,294 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#include "ProjectedVectorCacheTest.h"
+
+// Includes estandar
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <set>
+#include <utility>
+#include <vector>
+// Includes Suri
+#include "ProjectedVectorCache.h"
+// Includes Wx
+// Includes App
+#include "ogr_geometry.h"
+// Defines
+/** Semilla de los vertices al azar */
+#define TEST_RANDOM_SEED 4321
+/** Cantidad maxima de vertices de la cache de prueba */
+#define TEST_MAX_VERTICES 1000000
+/** Extension de la capa de prueba (la tolerancia del nivel 1 es 1) */
+#define TEST_LAYER_SIZE 65536.0
+/** Cantidad de vertices de las lineas de prueba */
+#define TEST_VERTEX_COUNT 1000
+
+/** namespace suri */
+namespace suri {
+
+namespace {
+/**
+ * Devuelve un valor al azar en [-Max, Max).
+ */
+double GetRandom(double Max) {
+   return Max * (2.0 * rand() / (RAND_MAX + 1.0) - 1.0);
+}
+
+/**
+ * Genera un recorrido al azar.
+ * @param[in] Count cantidad de vertices
+ * @param[in] Step desplazamiento maximo entre vertices
+ * @param[out] X coordenadas x
+ * @param[out] Y coordenadas y
+ */
+void LoadRandomWalk(int Count, double Step, std::vector<double> &X, std::vector<double> &Y) {
+   X.assign(1, 0.0);
+   Y.assign(1, 0.0);
+   for (int i = 1; i < Count; ++i) {
+      X.push_back(X.back() + GetRandom(Step));
+      Y.push_back(Y.back() + GetRandom(Step));
+   }
+}
+
+/**
+ * Distancia entre un punto y un segmento.
+ */
+double GetSegmentDistance(double X, double Y, double X1, double Y1, double X2, double Y2) {
+   double sx = X2 - X1, sy = Y2 - Y1;
+   double length2 = sx * sx + sy * sy;
+   double t = length2 > 0 ? ((X - X1) * sx + (Y - Y1) * sy) / length2 : 0;
+   t = t < 0 ? 0 : (t > 1 ? 1 : t);
+   double dx = X1 + t * sx - X, dy = Y1 + t * sy - Y;
+   return sqrt(dx * dx + dy * dy);
+}
+
+/**
+ * Crea una linea con los vertices recibidos.
+ */
+OGRLineString* CreateLine(std::vector<double> &X, std::vector<double> &Y) {
+   OGRLineString* pline = new OGRLineString;
+   pline->setPoints(static_cast<int>(X.size()), &X[0], &Y[0]);
+   return pline;
+}
+}  // namespace
+
+/**
+ * Constructor
+ */
+ProjectedVectorCacheTest::ProjectedVectorCacheTest() {
+}
+
+/**
+ * Destructor
+ */
+ProjectedVectorCacheTest::~ProjectedVectorCacheTest() {
+}
+
+/**
+ * Un anillo (circulo) con una tolerancia mayor que su tamanio conserva al
+ * menos 3 vertices distintos y sigue cerrado.
+ */
+void ProjectedVectorCacheTest::TestSimplifyClosedRing() {
+   std::vector<double> x, y;
+   for (int i = 0; i < TEST_VERTEX_COUNT; ++i) {
+      double angle = 2 * M_PI * i / TEST_VERTEX_COUNT;
+      x.push_back(10 * cos(angle));
+      y.push_back(10 * sin(angle));
+   }
+   x.push_back(x[0]);
+   y.push_back(y[0]);
+   double tolerances[] = { 0.1, 5, 1000 };
+   for (size_t t = 0; t < sizeof(tolerances) / sizeof(tolerances[0]); ++t) {
+      std::vector<int> kept;
+      ProjectedVectorCache::Simplify(&x[0], &y[0], static_cast<int>(x.size()),
+                                     tolerances[t], kept);
+      std::set<std::pair<double, double> > distinct;
+      for (size_t i = 0; i < kept.size(); ++i)
+         distinct.insert(std::make_pair(x[kept[i]], y[kept[i]]));
+      CPPUNIT_ASSERT_MESSAGE("El anillo simplificado se degenero",
+                             distinct.size() >= 3 && kept.front() == 0
+                                   && kept.back() == static_cast<int>(x.size()) - 1);
+      CPPUNIT_ASSERT_MESSAGE("El anillo no respeta la tolerancia",
+                             tolerances[t] > 10 || CheckTolerance(x, y, tolerances[t], kept));
+   }
+}
+
+/**
+ * Los vertices que se apartan de la recta menos que la tolerancia se
+ * descartan y los picos que la superan se conservan.
+ */
+void ProjectedVectorCacheTest::TestSimplifyTolerance() {
+   std::vector<double> x, y;
+   for (int i = 0; i <= 100; ++i) {
+      x.push_back(i);
+      y.push_back((i % 2) ? 0.2 : -0.2);
+   }
+   std::vector<int> kept;
+   ProjectedVectorCache::Simplify(&x[0], &y[0], static_cast<int>(x.size()), 0.5, kept);
+   CPPUNIT_ASSERT_MESSAGE("No se descartaron los vertices dentro de la tolerancia",
+                          kept.size() == 2 && kept[0] == 0 && kept[1] == 100);
+   y[50] = 3;
+   ProjectedVectorCache::Simplify(&x[0], &y[0], static_cast<int>(x.size()), 0.5, kept);
+   CPPUNIT_ASSERT_MESSAGE("Se descarto el pico",
+                          std::find(kept.begin(), kept.end(), 50) != kept.end()
+                                && CheckTolerance(x, y, 0.5, kept));
+   ProjectedVectorCache::Simplify(&x[0], &y[0], static_cast<int>(x.size()), 5, kept);
+   CPPUNIT_ASSERT_MESSAGE("No se descarto el pico dentro de la tolerancia",
+                          kept.size() == 2);
+   ProjectedVectorCache::Simplify(&x[0], &y[0], static_cast<int>(x.size()), 0, kept);
+   CPPUNIT_ASSERT_MESSAGE("Se descartaron vertices sin tolerancia",
+                          kept.size() == x.size());
+
+   srand(TEST_RANDOM_SEED);
+   LoadRandomWalk(TEST_VERTEX_COUNT, 1, x, y);
+   ProjectedVectorCache::Simplify(&x[0], &y[0], static_cast<int>(x.size()), 2, kept);
+   CPPUNIT_ASSERT_MESSAGE("La linea no respeta la tolerancia",
+                          kept.size() < x.size() && CheckTolerance(x, y, 2, kept));
+}
+
+/**
+ * Los indices conservados son crecientes y siempre incluyen los extremos.
+ */
+void ProjectedVectorCacheTest::TestSimplifyKeptIndices() {
+   srand(TEST_RANDOM_SEED);
+   std::vector<double> x, y;
+   std::vector<int> kept;
+   int counts[] = { 0, 1, 2, 3, TEST_VERTEX_COUNT };
+   for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+      LoadRandomWalk(std::max(1, counts[c]), 1, x, y);
+      ProjectedVectorCache::Simplify(&x[0], &y[0], counts[c], 1.5, kept);
+      bool increasing = counts[c] == 0 ? kept.empty()
+            : !kept.empty() && kept.front() == 0 && kept.back() == counts[c] - 1;
+      for (size_t i = 1; increasing && i < kept.size(); ++i)
+         increasing = kept[i - 1] < kept[i];
+      CPPUNIT_ASSERT_MESSAGE("Los indices conservados no son crecientes", increasing);
+   }
+}
+
+/**
+ * Con una capa de TEST_LAYER_SIZE la tolerancia del nivel 1 es 1 y cada
+ * nivel la multiplica por 4. Cada nivel generado tiene a lo sumo los
+ * vertices del anterior.
+ */
+void ProjectedVectorCacheTest::TestGetLevel() {
+   ProjectedVectorCache emptycache("", TEST_MAX_VERTICES);
+   CPPUNIT_ASSERT_MESSAGE("Nivel incorrecto sin features", emptycache.GetLevel(100) == 0);
+
+   srand(TEST_RANDOM_SEED);
+   ProjectedVectorCache cache("", TEST_MAX_VERTICES);
+   std::vector<double> x, y;
+   LoadRandomWalk(TEST_VERTEX_COUNT, 8, x, y);
+   // La linea avanza en x para que la extension sea exactamente TEST_LAYER_SIZE
+   for (int i = 0; i < TEST_VERTEX_COUNT; ++i)
+      x[i] = 8.0 * i;
+   x.push_back(TEST_LAYER_SIZE);
+   y.push_back(0);
+   cache.AddFeature(0, CreateLine(x, y));
+   cache.SetLoaded();
+   CPPUNIT_ASSERT_MESSAGE("Nivel incorrecto para tolerancia 0", cache.GetLevel(0) == 0);
+   CPPUNIT_ASSERT_MESSAGE("Nivel incorrecto para tolerancia 0.5", cache.GetLevel(0.5) == 0);
+   CPPUNIT_ASSERT_MESSAGE("Nivel incorrecto para tolerancia 1", cache.GetLevel(1) == 1);
+   CPPUNIT_ASSERT_MESSAGE("Nivel incorrecto para tolerancia 3.9", cache.GetLevel(3.9) == 1);
+   CPPUNIT_ASSERT_MESSAGE("Nivel incorrecto para tolerancia 4", cache.GetLevel(4) == 2);
+   int maxlevel = cache.GetLevel(1e12);
+   CPPUNIT_ASSERT_MESSAGE("Nivel incorrecto para tolerancia maxima",
+                          maxlevel == PROJECTED_VECTOR_CACHE_LEVELS - 1);
+   int previouscount = TEST_VERTEX_COUNT + 1;
+   for (int level = 0; level <= maxlevel; ++level) {
+      OGRLineString* pline = static_cast<OGRLineString*>(cache.GetGeometry(0, level));
+      CPPUNIT_ASSERT_MESSAGE("No se genero el nivel",
+                             pline != NULL && pline->getNumPoints() <= previouscount
+                                   && pline->getNumPoints() >= 2);
+      previouscount = pline->getNumPoints();
+   }
+   CPPUNIT_ASSERT_MESSAGE("El ultimo nivel no simplifico la linea",
+                          previouscount < TEST_VERTEX_COUNT + 1);
+}
+
+/**
+ * GetFeatures devuelve, en orden, los features cuya envolvente intersecta
+ * la ventana.
+ */
+void ProjectedVectorCacheTest::TestGetFeatures() {
+   srand(TEST_RANDOM_SEED);
+   ProjectedVectorCache cache("", TEST_MAX_VERTICES);
+   std::vector<OGREnvelope> envelopes;
+   for (int i = 0; i < TEST_VERTEX_COUNT; ++i) {
+      std::vector<double> x(2), y(2);
+      x[0] = GetRandom(TEST_LAYER_SIZE);
+      y[0] = GetRandom(TEST_LAYER_SIZE);
+      x[1] = x[0] + GetRandom(TEST_LAYER_SIZE / 50);
+      y[1] = y[0] + GetRandom(TEST_LAYER_SIZE / 50);
+      OGRLineString* pline = CreateLine(x, y);
+      envelopes.push_back(OGREnvelope());
+      pline->getEnvelope(&envelopes.back());
+      cache.AddFeature(i + 10, pline);
+   }
+   cache.SetLoaded();
+   bool result = true;
+   for (int q = 0; result && q < 100; ++q) {
+      OGREnvelope window;
+      window.MinX = GetRandom(TEST_LAYER_SIZE);
+      window.MinY = GetRandom(TEST_LAYER_SIZE);
+      window.MaxX = window.MinX + TEST_LAYER_SIZE / 10;
+      window.MaxY = window.MinY + TEST_LAYER_SIZE / 10;
+      std::vector<size_t> expected, features;
+      for (size_t i = 0; i < envelopes.size(); ++i)
+         if (envelopes[i].Intersects(window))
+            expected.push_back(i);
+      cache.GetFeatures(window, features);
+      result = features == expected
+            && (features.empty() || cache.GetFeatureId(features[0]) == static_cast<long>(expected[0]) + 10);
+   }
+   CPPUNIT_ASSERT_MESSAGE("Error en la busqueda de features", result);
+}
+
+/**
+ * Verifica que cada vertice original este a menos de la tolerancia del
+ * segmento simplificado que lo reemplaza.
+ * @param[in] X coordenadas x originales
+ * @param[in] Y coordenadas y originales
+ * @param[in] Tolerance tolerancia de la simplificacion
+ * @param[in] Kept indices de los vertices conservados
+ * @return true si se respeta la tolerancia
+ */
+bool ProjectedVectorCacheTest::CheckTolerance(const std::vector<double> &X,
+                                              const std::vector<double> &Y,
+                                              double Tolerance, const std::vector<int> &Kept) {
+   for (size_t k = 1; k < Kept.size(); ++k) {
+      for (int i = Kept[k - 1] + 1; i < Kept[k]; ++i) {
+         if (GetSegmentDistance(X[i], Y[i], X[Kept[k - 1]], Y[Kept[k - 1]], X[Kept[k]],
+                                Y[Kept[k]]) > Tolerance)
+            return false;
+      }
+   }
+   return true;
+}
+
+}  // namespace suri
@@ -0,0 +1,83 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef PROJECTEDVECTORCACHETEST_H_
+#define PROJECTEDVECTORCACHETEST_H_
+
+// Includes estandar
+#include <vector>
+// Includes Suri
+#include "suri/Tests.h"
+// Includes Wx
+// Includes App
+// Defines
+
+/** namespace suri */
+namespace suri {
+/** Test de la simplificacion y los niveles de detalle de ProjectedVectorCache */
+class ProjectedVectorCacheTest : public CPPUNIT_NS::TestFixture {
+   /** Inicializa test para la clase ProjectedVectorCacheTest. Invoca a setUp. */
+   CPPUNIT_TEST_SUITE(ProjectedVectorCacheTest);
+      /** Evalua resultado de TestSimplifyClosedRing */
+      CPPUNIT_TEST(TestSimplifyClosedRing);
+      /** Evalua resultado de TestSimplifyTolerance */
+      CPPUNIT_TEST(TestSimplifyTolerance);
+      /** Evalua resultado de TestSimplifyKeptIndices */
+      CPPUNIT_TEST(TestSimplifyKeptIndices);
+      /** Evalua resultado de TestGetLevel */
+      CPPUNIT_TEST(TestGetLevel);
+      /** Evalua resultado de TestGetFeatures */
+      CPPUNIT_TEST(TestGetFeatures);
+      /** Finaliza test. Invoca a tearDown. */
+      CPPUNIT_TEST_SUITE_END()
+   ;
+public:
+   /** Ctor. */
+   ProjectedVectorCacheTest();
+   /** Dtor. */
+   virtual ~ProjectedVectorCacheTest();
+protected:
+// Tests
+   /** Verifica que un anillo simplificado conserve al menos 3 vertices distintos */
+   void TestSimplifyClosedRing();
+   /** Verifica que se descarten los vertices dentro de la tolerancia */
+   void TestSimplifyTolerance();
+   /** Verifica que los indices conservados sean crecientes e incluyan los extremos */
+   void TestSimplifyKeptIndices();
+   /** Verifica el nivel de detalle que corresponde a cada tolerancia */
+   void TestGetLevel();
+   /** Compara GetFeatures con un recorrido de todas las envolventes */
+   void TestGetFeatures();
+
+// Metodos internos
+   /** Verifica que la simplificacion respete la tolerancia */
+   bool CheckTolerance(const std::vector<double> &X, const std::vector<double> &Y,
+                       double Tolerance, const std::vector<int> &Kept);
+};
+}
+
+#endif /* PROJECTEDVECTORCACHETEST_H_ */
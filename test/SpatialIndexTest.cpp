@@ -0,0 +1,171 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#include "SpatialIndexTest.h"
+
+// Includes estandar
+#include <cstdlib>
+#include <vector>
+// Includes Suri
+#include "SpatialIndex.h"
+// Includes Wx
+// Includes App
+// Defines
+/** Semilla de las envolventes al azar */
+#define TEST_RANDOM_SEED 1234
+/** Extension del area donde se generan las envolventes */
+#define TEST_AREA_SIZE 1000.0
+
+/** namespace suri */
+namespace suri {
+
+namespace {
+/**
+ * Devuelve un valor al azar en [0, Max).
+ */
+double GetRandom(double Max) {
+   return Max * rand() / (RAND_MAX + 1.0);
+}
+
+/**
+ * Crea una envolvente al azar dentro del area de prueba.
+ * @param[in] MaxSize tamanio maximo de la envolvente
+ */
+OGREnvelope GetRandomEnvelope(double MaxSize) {
+   OGREnvelope envelope;
+   envelope.MinX = GetRandom(TEST_AREA_SIZE);
+   envelope.MinY = GetRandom(TEST_AREA_SIZE);
+   envelope.MaxX = envelope.MinX + GetRandom(MaxSize);
+   envelope.MaxY = envelope.MinY + GetRandom(MaxSize);
+   return envelope;
+}
+
+/**
+ * Crea una envolvente a partir de sus limites.
+ */
+OGREnvelope GetEnvelope(double MinX, double MinY, double MaxX, double MaxY) {
+   OGREnvelope envelope;
+   envelope.MinX = MinX;
+   envelope.MinY = MinY;
+   envelope.MaxX = MaxX;
+   envelope.MaxY = MaxY;
+   return envelope;
+}
+}  // namespace
+
+/**
+ * Constructor
+ */
+SpatialIndexTest::SpatialIndexTest() {
+}
+
+/**
+ * Destructor
+ */
+SpatialIndexTest::~SpatialIndexTest() {
+}
+
+/**
+ * Un indice sin elementos, antes y despues de Build, no devuelve ids.
+ */
+void SpatialIndexTest::TestEmptyIndex() {
+   SpatialIndex index;
+   std::vector<int> ids(1, 0);
+   index.Query(GetEnvelope(0, 0, TEST_AREA_SIZE, TEST_AREA_SIZE), ids);
+   CPPUNIT_ASSERT_MESSAGE("El indice sin armar devolvio elementos", ids.empty());
+   index.Build();
+   index.Query(GetEnvelope(0, 0, TEST_AREA_SIZE, TEST_AREA_SIZE), ids);
+   CPPUNIT_ASSERT_MESSAGE("El indice vacio devolvio elementos",
+                          ids.empty() && index.GetSize() == 0);
+}
+
+/**
+ * Con un unico elemento se devuelve su id si la consulta lo intersecta
+ * (incluso si solo comparten un borde) y nada en otro caso.
+ */
+void SpatialIndexTest::TestSingleItem() {
+   SpatialIndex index;
+   index.Insert(7, GetEnvelope(10, 10, 20, 20));
+   index.Build();
+   std::vector<int> ids;
+   index.Query(GetEnvelope(15, 15, 30, 30), ids);
+   CPPUNIT_ASSERT_MESSAGE("No se encontro el elemento", ids.size() == 1 && ids[0] == 7);
+   index.Query(GetEnvelope(20, 0, 25, 10), ids);
+   CPPUNIT_ASSERT_MESSAGE("No se encontro el elemento en el borde",
+                          ids.size() == 1 && ids[0] == 7);
+   index.Query(GetEnvelope(21, 10, 30, 20), ids);
+   CPPUNIT_ASSERT_MESSAGE("Se encontro un elemento que no intersecta", ids.empty());
+   index.Clear();
+   index.Build();
+   index.Query(GetEnvelope(15, 15, 30, 30), ids);
+   CPPUNIT_ASSERT_MESSAGE("El indice vacio devolvio elementos", ids.empty());
+}
+
+/**
+ * Compara Query con un recorrido de todas las envolventes para cantidades
+ * que arman uno, dos y varios niveles del arbol.
+ */
+void SpatialIndexTest::TestQuery() {
+   srand(TEST_RANDOM_SEED);
+   CPPUNIT_ASSERT_MESSAGE("Error con una hoja", CompareQuery(SPATIAL_INDEX_NODE_CAPACITY, 200));
+   CPPUNIT_ASSERT_MESSAGE("Error con dos niveles",
+                          CompareQuery(SPATIAL_INDEX_NODE_CAPACITY * 3 + 1, 200));
+   CPPUNIT_ASSERT_MESSAGE("Error con varios niveles", CompareQuery(5000, 500));
+}
+
+/**
+ * Inserta envolventes al azar (con ids no consecutivos) y compara el
+ * resultado de consultas al azar con el recorrido de todas las envolventes.
+ * @param[in] ItemCount cantidad de envolventes del indice
+ * @param[in] QueryCount cantidad de consultas
+ * @return true si todas las consultas coinciden
+ */
+bool SpatialIndexTest::CompareQuery(int ItemCount, int QueryCount) {
+   SpatialIndex index;
+   std::vector<OGREnvelope> envelopes;
+   for (int i = 0; i < ItemCount; ++i) {
+      envelopes.push_back(GetRandomEnvelope(TEST_AREA_SIZE / 20));
+      index.Insert(i * 3, envelopes.back());
+   }
+   index.Build();
+   if (index.GetSize() != envelopes.size())
+      return false;
+   bool result = true;
+   for (int q = 0; result && q < QueryCount; ++q) {
+      OGREnvelope query = GetRandomEnvelope(TEST_AREA_SIZE / 5);
+      std::vector<int> expected;
+      for (int i = 0; i < ItemCount; ++i)
+         if (envelopes[i].Intersects(query))
+            expected.push_back(i * 3);
+      std::vector<int> ids;
+      index.Query(query, ids);
+      result = ids == expected;
+   }
+   return result;
+}
+
+}  // namespace suri
@@ -0,0 +1,73 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef SPATIALINDEXTEST_H_
+#define SPATIALINDEXTEST_H_
+
+// Includes estandar
+// Includes Suri
+#include "suri/Tests.h"
+// Includes Wx
+// Includes App
+// Defines
+
+/** namespace suri */
+namespace suri {
+/** Test del indice espacial empaquetado (SpatialIndex) */
+class SpatialIndexTest : public CPPUNIT_NS::TestFixture {
+   /** Inicializa test para la clase SpatialIndexTest. Invoca a setUp. */
+   CPPUNIT_TEST_SUITE(SpatialIndexTest);
+      /** Evalua resultado de TestEmptyIndex */
+      CPPUNIT_TEST(TestEmptyIndex);
+      /** Evalua resultado de TestSingleItem */
+      CPPUNIT_TEST(TestSingleItem);
+      /** Evalua resultado de TestQuery */
+      CPPUNIT_TEST(TestQuery);
+      /** Finaliza test. Invoca a tearDown. */
+      CPPUNIT_TEST_SUITE_END()
+   ;
+public:
+   /** Ctor. */
+   SpatialIndexTest();
+   /** Dtor. */
+   virtual ~SpatialIndexTest();
+protected:
+// Tests
+   /** Verifica que un indice vacio no devuelva elementos */
+   void TestEmptyIndex();
+   /** Verifica las consultas sobre un indice con un unico elemento */
+   void TestSingleItem();
+   /** Compara Query con un recorrido de todas las envolventes */
+   void TestQuery();
+
+// Metodos internos
+   /** Compara Query con el recorrido para una cantidad de envolventes al azar */
+   bool CompareQuery(int ItemCount, int QueryCount);
+};
+}
+
+#endif /* SPATIALINDEXTEST_H_ */
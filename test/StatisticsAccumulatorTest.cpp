@@ -0,0 +1,363 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#include "StatisticsAccumulatorTest.h"
+
+// Includes estandar
+#include <cmath>
+#include <algorithm>
+#include <vector>
+// Includes Suri
+#include "SRDStatisticsAccumulator.h"
+#include "SRDStatistics.h"
+#include "SRDHistogram.h"
+// Includes Wx
+// Includes App
+// Defines
+/** Cantidad de pixeles de los datos de prueba (mas de un bloque) */
+#define TEST_PIXEL_COUNT 3000
+/** Cantidad de bandas de los datos de prueba */
+#define TEST_BAND_COUNT 3
+/** Cantidad de bins de los histogramas de prueba */
+#define TEST_BIN_COUNT 256
+/** Valor no valido de los datos de prueba */
+#define TEST_NO_DATA_VALUE 0
+/** Valor no valido de la banda 1 en las estadisticas por banda */
+#define TEST_BAND_NO_DATA_VALUE 7
+
+/** namespace suri */
+namespace suri {
+
+namespace {
+/**
+ * Genera bandas con valores no validos en todas las bandas (pixeles multiplo
+ * de 13) y solo en la primera (pixeles multiplo de 17).
+ * @param[out] Bands datos de cada banda
+ * @param[out] Data punteros a los datos de cada banda
+ */
+template<typename T>
+void LoadBands(std::vector<std::vector<T> > &Bands, std::vector<void*> &Data) {
+   Bands.assign(TEST_BAND_COUNT, std::vector<T>(TEST_PIXEL_COUNT));
+   Data.clear();
+   for (int b = 0; b < TEST_BAND_COUNT; ++b) {
+      for (int p = 0; p < TEST_PIXEL_COUNT; ++p) {
+         double value = (p * (37 + 6 * b) + 11 * b) % 251 + (p % 7) / 4.0;
+         if (p % 13 == 0 || (p % 17 == 0 && b == 0))
+            value = TEST_NO_DATA_VALUE;
+         Bands[b][p] = static_cast<T>(value);
+      }
+      Data.push_back(&Bands[b][0]);
+   }
+}
+
+/**
+ * Devuelve los punteros a los datos de las bandas desde el pixel Offset.
+ */
+std::vector<void*> GetChunk(const std::vector<void*> &Data, int Offset, size_t DataSize) {
+   std::vector<void*> chunk;
+   for (size_t b = 0; b < Data.size(); ++b)
+      chunk.push_back(static_cast<char*>(Data[b]) + Offset * DataSize);
+   return chunk;
+}
+
+/**
+ * Compara dos valores con error relativo.
+ */
+bool AreClose(double Value, double Expected) {
+   return std::fabs(Value - Expected) <= 1e-9 * std::max(1.0, std::fabs(Expected));
+}
+}  // namespace
+
+/** Particion de los datos de prueba en llamadas a Process (bloques parciales) */
+static const int kChunks[] = { 700, 1500, 800 };
+
+/**
+ * Constructor
+ */
+StatisticsAccumulatorTest::StatisticsAccumulatorTest() {
+}
+
+/**
+ * Destructor
+ */
+StatisticsAccumulatorTest::~StatisticsAccumulatorTest() {
+}
+
+/**
+ * Compara cantidad, minimo, maximo, media y varianza por banda con los de
+ * Statistics<T>::Process(Band, ...).
+ */
+void StatisticsAccumulatorTest::TestStatistics() {
+   CPPUNIT_ASSERT_MESSAGE("Error en estadisticas uchar",
+                          CompareStatistics<unsigned char>(false));
+   CPPUNIT_ASSERT_MESSAGE("Error en estadisticas short", CompareStatistics<short>(false));
+   CPPUNIT_ASSERT_MESSAGE("Error en estadisticas float", CompareStatistics<float>(false));
+   CPPUNIT_ASSERT_MESSAGE("Error en estadisticas double", CompareStatistics<double>(false));
+}
+
+/**
+ * Compara las estadisticas y la matriz de covarianza con las de
+ * Statistics<T>::Process(DataLength, Data).
+ */
+void StatisticsAccumulatorTest::TestInterBandStatistics() {
+   CPPUNIT_ASSERT_MESSAGE("Error en estadisticas uchar",
+                          CompareStatistics<unsigned char>(true));
+   CPPUNIT_ASSERT_MESSAGE("Error en estadisticas int", CompareStatistics<int>(true));
+   CPPUNIT_ASSERT_MESSAGE("Error en estadisticas double", CompareStatistics<double>(true));
+}
+
+/**
+ * Compara el histograma con el de Histogram<T>::CountPixels usando el
+ * minimo y maximo de las estadisticas (como HistogramCanvas) o un rango fijo.
+ */
+void StatisticsAccumulatorTest::TestHistogram() {
+   CPPUNIT_ASSERT_MESSAGE("Error en histograma uchar",
+                          CompareHistogram<unsigned char>(false));
+   CPPUNIT_ASSERT_MESSAGE("Error en histograma ushort",
+                          CompareHistogram<unsigned short>(false));
+   CPPUNIT_ASSERT_MESSAGE("Error en histograma short", CompareHistogram<short>(false));
+   CPPUNIT_ASSERT_MESSAGE("Error en histograma int", CompareHistogram<int>(false));
+   CPPUNIT_ASSERT_MESSAGE("Error en histograma float", CompareHistogram<float>(false));
+   CPPUNIT_ASSERT_MESSAGE("Error en histograma double", CompareHistogram<double>(false));
+   CPPUNIT_ASSERT_MESSAGE("Error en histograma uchar con rango",
+                          CompareHistogram<unsigned char>(true));
+   CPPUNIT_ASSERT_MESSAGE("Error en histograma int con rango",
+                          CompareHistogram<int>(true));
+   CPPUNIT_ASSERT_MESSAGE("Error en histograma float con rango",
+                          CompareHistogram<float>(true));
+   CPPUNIT_ASSERT_MESSAGE("Error en histograma double con rango",
+                          CompareHistogram<double>(true));
+}
+
+/**
+ * Sin rango fijo los enteros de 32 bits y los flotantes se cuentan por valor
+ * distinto: al superar kMaxDistinctValues el acumulador no crea el histograma
+ * y pide otra pasada, tambien al combinarlo con otro acumulador.
+ */
+void StatisticsAccumulatorTest::TestHistogramNeedsPass() {
+   typedef raster::data::StatisticsAccumulatorBase AccumulatorBase;
+   std::vector<float> values(AccumulatorBase::kMaxDistinctValues + 1);
+   for (size_t p = 0; p < values.size(); ++p)
+      values[p] = static_cast<float>(p) / 2;
+   std::vector<void*> data(1, &values[0]);
+
+   raster::data::StatisticsAccumulator<float> floataccumulator(1, false);
+   floataccumulator.SetHistogram(TEST_BIN_COUNT);
+   raster::data::StatisticsAccumulator<float> otheraccumulator(floataccumulator);
+   CPPUNIT_ASSERT_MESSAGE("float sin datos pide otra pasada",
+                          !floataccumulator.NeedsHistogramPass());
+   floataccumulator.Process(static_cast<int>(values.size()) - 1, data);
+   CPPUNIT_ASSERT_MESSAGE("float en el limite pide otra pasada",
+                          !floataccumulator.NeedsHistogramPass());
+   otheraccumulator.Process(static_cast<int>(values.size()), data);
+   floataccumulator.Merge(otheraccumulator);
+   CPPUNIT_ASSERT_MESSAGE("float combinado no pide otra pasada",
+                          floataccumulator.NeedsHistogramPass()
+                                && floataccumulator.CreateHistogram() == NULL);
+
+   std::vector<int> intvalues(values.size());
+   for (size_t p = 0; p < intvalues.size(); ++p)
+      intvalues[p] = static_cast<int>(p);
+   std::vector<void*> intdata(1, &intvalues[0]);
+   raster::data::StatisticsAccumulator<int> intaccumulator(1, false);
+   intaccumulator.SetHistogram(TEST_BIN_COUNT);
+   intaccumulator.Process(static_cast<int>(intvalues.size()), intdata);
+   CPPUNIT_ASSERT_MESSAGE("int sin rango no pide otra pasada",
+                          intaccumulator.NeedsHistogramPass()
+                                && intaccumulator.CreateHistogram() == NULL);
+
+   raster::data::StatisticsAccumulator<unsigned char> ucharaccumulator(1, false);
+   ucharaccumulator.SetHistogram(TEST_BIN_COUNT);
+   CPPUNIT_ASSERT_MESSAGE("uchar pide otra pasada",
+                          !ucharaccumulator.NeedsHistogramPass());
+}
+
+/**
+ * Procesa cada parte de los datos con otro acumulador y lo combina (Merge):
+ * el resultado debe coincidir con Statistics<T> e Histogram<T>. Un
+ * acumulador de otro tipo o configuracion no se combina.
+ */
+void StatisticsAccumulatorTest::TestMerge() {
+   CPPUNIT_ASSERT_MESSAGE("Error en estadisticas uchar",
+                          CompareStatistics<unsigned char>(false, true));
+   CPPUNIT_ASSERT_MESSAGE("Error en estadisticas float", CompareStatistics<float>(false, true));
+   CPPUNIT_ASSERT_MESSAGE("Error en estadisticas int", CompareStatistics<int>(true, true));
+   CPPUNIT_ASSERT_MESSAGE("Error en estadisticas double",
+                          CompareStatistics<double>(true, true));
+   CPPUNIT_ASSERT_MESSAGE("Error en histograma ushort",
+                          CompareHistogram<unsigned short>(false, true));
+   CPPUNIT_ASSERT_MESSAGE("Error en histograma int", CompareHistogram<int>(false, true));
+   CPPUNIT_ASSERT_MESSAGE("Error en histograma float", CompareHistogram<float>(false, true));
+   CPPUNIT_ASSERT_MESSAGE("Error en histograma double con rango",
+                          CompareHistogram<double>(true, true));
+
+   raster::data::StatisticsAccumulator<float> accumulator(TEST_BAND_COUNT, false);
+   raster::data::StatisticsAccumulator<double> othertype(TEST_BAND_COUNT, false);
+   raster::data::StatisticsAccumulator<float> otherbands(1, false);
+   raster::data::StatisticsAccumulator<float> otherhistogram(TEST_BAND_COUNT, false);
+   otherhistogram.SetHistogram(TEST_BIN_COUNT);
+   CPPUNIT_ASSERT_MESSAGE("Se combino un acumulador incompatible",
+                          !accumulator.Merge(othertype) && !accumulator.Merge(otherbands)
+                                && !accumulator.Merge(otherhistogram));
+}
+
+/**
+ * Procesa los datos de prueba en varias llamadas con el acumulador y con
+ * Statistics<T> y compara los resultados. Cantidad, minimo y maximo deben ser
+ * iguales; media, varianza y covarianza se combinan en otro orden y se
+ * comparan con error relativo.
+ * @param[in] InterBand estadisticas entre bandas
+ * @param[in] Merge procesa cada llamada con otro acumulador y lo combina
+ * @return true si los resultados coinciden
+ */
+template<typename T>
+bool StatisticsAccumulatorTest::CompareStatistics(bool InterBand, bool Merge) {
+   std::vector<std::vector<T> > bands;
+   std::vector<void*> data;
+   LoadBands(bands, data);
+
+   raster::data::StatisticsAccumulator<T> accumulator(TEST_BAND_COUNT, InterBand);
+   raster::data::Statistics<T> expected(TEST_BAND_COUNT);
+   accumulator.SetNoDataValueAvailable(true);
+   accumulator.SetNoDataValue(TEST_NO_DATA_VALUE);
+   expected.SetNoDataValueAvailable(true);
+   expected.SetNoDataValue(TEST_NO_DATA_VALUE);
+   if (!InterBand) {
+      accumulator.SetBandNdv(1, TEST_BAND_NO_DATA_VALUE);
+      expected.SetBandNdv(1, TEST_BAND_NO_DATA_VALUE);
+   }
+   const raster::data::StatisticsAccumulator<T> empty(accumulator);
+   int offset = 0;
+   for (size_t i = 0; i < sizeof(kChunks) / sizeof(kChunks[0]); ++i) {
+      std::vector<void*> chunk = GetChunk(data, offset, sizeof(T));
+      if (Merge) {
+         raster::data::StatisticsAccumulator<T> partial(empty);
+         partial.Process(kChunks[i], chunk);
+         if (!accumulator.Merge(partial))
+            return false;
+      } else {
+         accumulator.Process(kChunks[i], chunk);
+      }
+      if (InterBand) {
+         expected.Process(kChunks[i], chunk);
+      } else {
+         for (int b = 0; b < TEST_BAND_COUNT; ++b)
+            expected.Process(b, kChunks[i], chunk[b]);
+      }
+      offset += kChunks[i];
+   }
+
+   raster::data::StatisticsBase* pstatistics = accumulator.CreateStatistics();
+   bool result = true;
+   for (int b = 0; b < TEST_BAND_COUNT; ++b) {
+      result = result && pstatistics->GetPointCount(b) == expected.GetPointCount(b)
+            && pstatistics->GetMin(b) == expected.GetMin(b)
+            && pstatistics->GetMax(b) == expected.GetMax(b)
+            && AreClose(pstatistics->GetMean(b), expected.GetMean(b))
+            && AreClose(pstatistics->GetVariance(b), expected.GetVariance(b));
+   }
+   if (InterBand) {
+      std::vector<std::vector<double> > covariance = pstatistics->GetCovarianceMatrix();
+      std::vector<std::vector<double> > expectedcovariance = expected.GetCovarianceMatrix();
+      for (int b = 0; b < TEST_BAND_COUNT; ++b)
+         for (int c = 0; c < TEST_BAND_COUNT; ++c)
+            result = result && AreClose(covariance[b][c], expectedcovariance[b][c]);
+   }
+   delete pstatistics;
+   return result;
+}
+
+/**
+ * Procesa los datos de prueba en varias llamadas y compara el histograma del
+ * acumulador con el que calcula Histogram<T>::CountPixels sobre los mismos
+ * datos. Ambos deben ser identicos.
+ * @param[in] FixedRange usa un rango fijo en lugar del minimo y maximo
+ * @param[in] Merge procesa cada llamada con otro acumulador y lo combina
+ * @return true si los histogramas coinciden
+ */
+template<typename T>
+bool StatisticsAccumulatorTest::CompareHistogram(bool FixedRange, bool Merge) {
+   std::vector<std::vector<T> > bands;
+   std::vector<void*> data;
+   LoadBands(bands, data);
+
+   std::vector<double> mins, maxs;
+   if (FixedRange) {
+      mins.assign(TEST_BAND_COUNT, 20.5);
+      maxs.assign(TEST_BAND_COUNT, 200);
+   }
+   raster::data::StatisticsAccumulator<T> accumulator(TEST_BAND_COUNT, false);
+   accumulator.SetNoDataValueAvailable(true);
+   accumulator.SetNoDataValue(TEST_NO_DATA_VALUE);
+   accumulator.SetBandNdv(1, TEST_BAND_NO_DATA_VALUE);
+   accumulator.SetHistogram(TEST_BIN_COUNT, mins, maxs);
+   const raster::data::StatisticsAccumulator<T> empty(accumulator);
+   int offset = 0;
+   for (size_t i = 0; i < sizeof(kChunks) / sizeof(kChunks[0]); ++i) {
+      std::vector<void*> chunk = GetChunk(data, offset, sizeof(T));
+      if (Merge) {
+         raster::data::StatisticsAccumulator<T> partial(empty);
+         partial.Process(kChunks[i], chunk);
+         if (!accumulator.Merge(partial))
+            return false;
+      } else {
+         accumulator.Process(kChunks[i], chunk);
+      }
+      offset += kChunks[i];
+   }
+   if (accumulator.NeedsHistogramPass())
+      return false;
+
+   raster::data::StatisticsBase* pstatistics = accumulator.CreateStatistics();
+   if (!FixedRange) {
+      for (int b = 0; b < TEST_BAND_COUNT; ++b) {
+         mins.push_back(pstatistics->GetMin(b));
+         maxs.push_back(pstatistics->GetMax(b));
+      }
+   }
+   delete pstatistics;
+   std::vector<int> bins(TEST_BAND_COUNT, TEST_BIN_COUNT);
+   raster::data::Histogram<T> expected(TEST_BAND_COUNT, &bins[0], &mins[0], &maxs[0]);
+   expected.SetNoDataValueAvailable(true);
+   expected.SetNoDataValue(TEST_NO_DATA_VALUE);
+   expected.SetBandNdv(1, TEST_BAND_NO_DATA_VALUE);
+   for (int b = 0; b < TEST_BAND_COUNT; ++b)
+      expected.CountPixels(b, TEST_PIXEL_COUNT, data[b]);
+
+   raster::data::HistogramBase* phistogram = accumulator.CreateHistogram();
+   bool result = phistogram != NULL;
+   for (int b = 0; result && b < TEST_BAND_COUNT; ++b) {
+      result = phistogram->GetBandAccumFrequency()[b]
+            == expected.GetBandAccumFrequency()[b];
+      for (int bin = 0; result && bin < TEST_BIN_COUNT; ++bin)
+         result = phistogram->GetBins()[b][bin] == expected.GetBins()[b][bin];
+   }
+   delete phistogram;
+   return result;
+}
+
+}  // namespace suri
@@ -0,0 +1,86 @@
+/* Copyright (c) 2006-2023 SpaceSUR and CONAE
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+This file is part of the SuriLib project and its derived programs. You must retain
+this copyright notice and license text in all copies or substantial
+portions of the software.
+
+If you develop a program based on this software, you must provide a visible
+notice to its users that it contains code from the SuriLib project and provide
+a copy of this license. The notice should be displayed in a way that is easily
+accessible to users, such as in the program's "About" box or documentation.
+
+For more information about SpaceSUR, visit <https://www.spacesur.com>.
+For more information about CONAE, visit <http://www.conae.gov.ar/>. */
+
+#ifndef STATISTICSACCUMULATORTEST_H_
+#define STATISTICSACCUMULATORTEST_H_
+
+// Includes estandar
+#include <vector>
+// Includes Suri
+#include "suri/Tests.h"
+// Includes Wx
+// Includes App
+// Defines
+
+/** namespace suri */
+namespace suri {
+/** Test del acumulador de estadisticas e histograma en una pasada */
+class StatisticsAccumulatorTest : public CPPUNIT_NS::TestFixture {
+   /** Inicializa test para la clase StatisticsAccumulatorTest. Invoca a setUp. */
+   CPPUNIT_TEST_SUITE(StatisticsAccumulatorTest);
+      /** Evalua resultado de TestStatistics */
+      CPPUNIT_TEST(TestStatistics);
+      /** Evalua resultado de TestInterBandStatistics */
+      CPPUNIT_TEST(TestInterBandStatistics);
+      /** Evalua resultado de TestHistogram */
+      CPPUNIT_TEST(TestHistogram);
+      /** Evalua resultado de TestHistogramNeedsPass */
+      CPPUNIT_TEST(TestHistogramNeedsPass);
+      /** Evalua resultado de TestMerge */
+      CPPUNIT_TEST(TestMerge);
+      /** Finaliza test. Invoca a tearDown. */
+      CPPUNIT_TEST_SUITE_END()
+   ;
+public:
+   /** Ctor. */
+   StatisticsAccumulatorTest();
+   /** Dtor. */
+   virtual ~StatisticsAccumulatorTest();
+protected:
+// Tests
+   /** Compara las estadisticas por banda con las de Statistics */
+   void TestStatistics();
+   /** Compara las estadisticas entre bandas con las de Statistics */
+   void TestInterBandStatistics();
+   /** Compara el histograma con el de Histogram (HistogramCanvas) */
+   void TestHistogram();
+   /** Verifica que se pida otra pasada al superar los valores distintos */
+   void TestHistogramNeedsPass();
+   /** Compara el resultado de combinar acumuladores parciales */
+   void TestMerge();
+
+// Metodos internos
+   /** Compara las estadisticas de un tipo de dato */
+   template<typename T>
+   bool CompareStatistics(bool InterBand, bool Merge = false);
+   /** Compara el histograma de un tipo de dato */
+   template<typename T>
+   bool CompareHistogram(bool FixedRange, bool Merge = false);
+};
+}
+
+#endif /* STATISTICSACCUMULATORTEST_H_ */
@@ -48,6 +48,7 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "SREEnhancementUtils.h"
 #include "suri/DataTypes.h"
 #include "suri/StatisticsCalculator.h"
+#include "logmacros.h"
 
 // Includes App
 #include "resources.h"
@@ -261,7 +262,11 @@ void EnhancementSelectionPart::GetRasterStats(
    RasterElement* pcurrentelem = dynamic_cast<RasterElement*>(
          pRasterLayer_ ? pRasterLayer_->GetElement() : pElement_);
    raster::data::StatisticsCalculator statscalculator(pcurrentelem);
+   // Los realces solo requieren un histograma aproximado.
+   statscalculator.SetApproximate(true);
    statscalculator.CalculateStatistics(pStatistics, pHistogram);
+   REPORT_DEBUG("D: Estadisticas de realce calculadas con %ld muestras",
+                statscalculator.GetSampleCount());
 }
 
 /**
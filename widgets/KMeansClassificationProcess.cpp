@@ -26,6 +26,7 @@ For more information about SpaceSUR, visit <https://www.spacesur.com>.
 For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 
 // Includes standart
+#include <algorithm>
 #include <limits>
 #include <vector>
 #include <string>
@@ -49,6 +50,8 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "ClassificationRenderer.h"
 #include "KMeansAlgorithm.h"
 #include "KMeansCanvas.h"
+#include "KMeansEngine.h"
+#include "suri/Configuration.h"
 #include "suri/StatisticsCalculator.h"
 #include "suri/ClassificationProcess.h"
 
@@ -62,6 +65,10 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 /** Offset (en bytes) para calcular el tamanio libre necesario para salvar */
 #define EXTRA_SAVE_SPACE_REQUIRED 1000000
 #define PIXEL_NOVALID_DN 0
+/** Cantidad maxima de pixeles que se cargan en memoria para iterar */
+#define DEFAULT_KMEANS_MAX_SAMPLES 4000000.0
+/** Cantidad de pixeles por bloque en la clasificacion final */
+#define KMEANS_BLOCK_PIXELS 1048576
 /** namespace suri */
 namespace suri {
 
@@ -187,26 +194,6 @@ bool KMeansClassificationProcess::GetStatistics(std::vector<int> BandIndex, Rast
    return pstatistics != NULL;
 }
 
-/** Actuaiza los centroides de las clases */
-void KMeansClassificationProcess::UpdateMeans(int Classes, int BandCount,
-                           const std::vector< std::vector<double > >& ClassCentreData,
-                           const std::vector<int>& PixelCount,
-                           std::vector<std::vector<double> >& Means) {
-   for (int a = 0; a < Classes; a++) {
-      if (PixelCount[a] > 0) {
-         double* pnewclasscentre = new double[BandCount];
-         for (int i = 0; i < BandCount; i++) {
-            pnewclasscentre[i] = ClassCentreData[a][i] / static_cast<double>(PixelCount[a]);
-         }
-         for (int i = 0; i < BandCount; i++) {
-            Means[a][i] = pnewclasscentre[i];
-         }
-         delete[] pnewclasscentre;
-      }
-   }
-}
-
-
 /** Metodo auxiliar que configura los metadatos de la imagen que genera el proceso de clasificacion
  * @param[in] pDataset dataset que representa la imagen a clasificar y de la cual se tomara la metadata
  * @param[in] XOffset pixel inicial 
@@ -254,50 +241,93 @@ void KMeansClassificationProcess::ConfigureMetadata(GDALDataset* pDataset, int X
       pDestDataset->SetMetadata(pDataset->GetMetadata("GEOLOCATION"), "GEOLOCATION");
 }
 
-/** A traves del algoritmo de kmeans clasifica los pixeles del bloque se pasa por parametro
- *  @param[in] BlockData bloque que tiene los pixeles a clasificar
- *  @param[in] BlockSize tamanio del bloque
- *  @param[in] BandCount cantidad e bandas
- *  @param[in] NoDataValue valor no valido
- *  @param[in] NoDataValueEnable bool que indica si se encuentra configurado el valor no valido
- *  @param[in] InitialMeans medias iniciales al momento de procesar el bloque
- *  @param[out] StepMeans resultantes del procesamiento del bloque
- *  @param[out] PixelCount conteo de pixeles clasificados por clase del bloque
- *  @param[out] pOutputData bloque en donde se colocaran los pixeles clasificados
+/**
+ * Lee una sola vez la seleccion espacial y carga los pixeles validos en el
+ * motor. Si la seleccion tiene mas de lib_kmeans_max_samples pixeles se toma
+ * una muestra estratificada (una de cada Step lineas y columnas).
+ * @param[out] Engine motor de kmeans
+ * @param[in] pDataset imagen a clasificar
+ * @param[in] Bands bandas seleccionadas
+ * @param[in] XOffset pixel inicial
+ * @param[in] XBlockSize cantidad de pixeles por linea
+ * @param[in] InitialLine linea inicial
+ * @param[in] FinalLine linea final (no incluida)
+ * @param[in] NoDataValue valor no valido
+ * @param[in] NoDataValueEnable bool que indica si se encuentra configurado el valor no valido
+ * @return true si pudo leer todas las lineas
 **/
-void KMeansClassificationProcess::ClassifyBlock(std::vector<float*>& BlockData, int BlockSize,
-                           int BandCount, double NoDataValue, bool NoDataValueEnable, 
-                           const std::vector<std::vector<double> >& InitialMeans,
-                           std::vector<std::vector<double> >& StepMeans,
-                           std::vector<int>& PixelCount, float* pOutputData) {
-   double pixeldistance = 0.0;
-   for (int p = 0; p < BlockSize; ++p) {
-      bool pixelinvalid = true;
-      int pixelclass = 0;
-      float pixelmindistance = std::numeric_limits<float>::max();
-      double precision = 0.00000001;
-      for (int c = 0; c < classcount_; ++c) {
-         pixeldistance = 0;
-         for (int b = 0; b < BandCount; ++b) {
-            double diff = BlockData[b][p] - InitialMeans[c][b];
-            // el pixel es no valido si en todas sus bandas el valor del mismo es el no valido
-            pixelinvalid = NoDataValueEnable ?
-                           pixelinvalid && fabs(BlockData[b][p] - NoDataValue) < precision :
-                           false;
-            pixeldistance += diff * diff;
-         }
-         if (pixeldistance < pixelmindistance) {
-            pixelclass = c;
-            pixelmindistance = pixeldistance;
-         }
+bool KMeansClassificationProcess::LoadPixels(KMeansEngine& Engine, GDALDataset* pDataset,
+                           const std::vector<int>& Bands, int XOffset, int XBlockSize,
+                           int InitialLine, int FinalLine, double NoDataValue,
+                           bool NoDataValueEnable) {
+   double pixelcount = static_cast<double>(XBlockSize) * (FinalLine - InitialLine);
+   double maxsamples = Configuration::GetParameter("lib_kmeans_max_samples",
+                                                   DEFAULT_KMEANS_MAX_SAMPLES);
+   int step = 1;
+   if (maxsamples > 0 && pixelcount > maxsamples)
+      step = static_cast<int>(ceil(sqrt(pixelcount / maxsamples)));
+   std::vector<float> linedata(Bands.size() * XBlockSize);
+   std::vector<float*> bufferdata(Bands.size());
+   for (size_t b = 0; b < Bands.size(); ++b)
+      bufferdata[b] = &linedata[b * XBlockSize];
+   for (int y = InitialLine; y < FinalLine; y += step) {
+      for (size_t b = 0; b < Bands.size(); ++b) {
+         // se utiliza la seleccion espectral para saber de que banda leer
+         GDALRasterBand* pband = pDataset->GetRasterBand(Bands[b] + 1);
+         if (pband->RasterIO(GF_Read, XOffset, y, XBlockSize, 1, bufferdata[b],
+                             XBlockSize, 1, GDT_Float32, 0, 0) != CE_None)
+            return false;
       }
-      // el valor de la clase comienza a partir del no valido (0)
-      pOutputData[p] = pixelinvalid ? 255 : pixelclass + 1;
-      if (!pixelinvalid)
-         PixelCount[pixelclass]++;
-      for (int b = 0; b < BandCount; ++b)
-         StepMeans[pixelclass][b] += BlockData[b][p];
+      Engine.AddPixels(bufferdata, XBlockSize, NoDataValueEnable, NoDataValue, step);
    }
+   REPORT_DEBUG("D: Kmeans con %d pixeles (muestreo 1 de cada %d lineas y columnas)",
+                static_cast<int>(Engine.GetPixelCount()), step);
+   return true;
+}
+
+/**
+ * Clasifica la seleccion espacial en bloques de lineas con las medias
+ * finales del motor y escribe el resultado.
+ * @param[in] Engine motor de kmeans con las medias finales
+ * @param[in] pDataset imagen a clasificar
+ * @param[in] Bands bandas seleccionadas
+ * @param[in] XOffset pixel inicial
+ * @param[in] XBlockSize cantidad de pixeles por linea
+ * @param[in] InitialLine linea inicial
+ * @param[in] FinalLine linea final (no incluida)
+ * @param[in] NoDataValue valor no valido
+ * @param[in] NoDataValueEnable bool que indica si se encuentra configurado el valor no valido
+ * @param[out] pDestBand banda de la imagen clasificada
+ * @return true si pudo leer y escribir todos los bloques
+**/
+bool KMeansClassificationProcess::ClassifyImage(KMeansEngine& Engine, GDALDataset* pDataset,
+                           const std::vector<int>& Bands, int XOffset, int XBlockSize,
+                           int InitialLine, int FinalLine, double NoDataValue,
+                           bool NoDataValueEnable, GDALRasterBand* pDestBand) {
+   int blocklines = std::max(1, KMEANS_BLOCK_PIXELS / std::max(1, XBlockSize));
+   std::vector<float> blockdata(Bands.size() * XBlockSize * blocklines);
+   std::vector<float> outputdata(XBlockSize * blocklines);
+   std::vector<float*> bufferdata(Bands.size());
+   for (size_t b = 0; b < Bands.size(); ++b)
+      bufferdata[b] = &blockdata[b * XBlockSize * blocklines];
+   bool success = true;
+   for (int y = InitialLine; success && y < FinalLine; y += blocklines) {
+      int lines = std::min(blocklines, FinalLine - y);
+      for (size_t b = 0; success && b < Bands.size(); ++b) {
+         GDALRasterBand* pband = pDataset->GetRasterBand(Bands[b] + 1);
+         success = pband->RasterIO(GF_Read, XOffset, y, XBlockSize, lines, bufferdata[b],
+                                   XBlockSize, lines, GDT_Float32, 0, 0) == CE_None;
+      }
+      if (!success)
+         break;
+      // el valor 255 corresponde a los pixeles no validos
+      Engine.Classify(bufferdata, XBlockSize * lines, NoDataValueEnable, NoDataValue, 255,
+                      &outputdata[0]);
+      success = success && pDestBand->RasterIO(GF_Write, 0, y - InitialLine, XBlockSize,
+                                               lines, &outputdata[0], XBlockSize, lines,
+                                               GDT_Float32, 0, 0) == CE_None;
+   }
+   return success;
 }
 
 /** Corre el proceso y genera la salida usando los metodos de configuracion */
@@ -368,57 +398,56 @@ bool KMeansClassificationProcess::RunProcess() {
    bool ndvavailable = true;
    double nodatavalue;
    inputElements_[0]->GetNoDataValue(ndvavailable, nodatavalue);
+   // Se leen los pixeles una sola vez; las iteraciones trabajan en memoria
+   // spatialselection.lr_.y_ representa el numero de linea final de la seleccion espacial
+   // spatialselection.ul_.y_ representa el numero de linea inicial de la seleccion espacial
+   KMeansEngine engine(bcount);
+   if (!LoadPixels(engine, pdataset, bands, xoffset, xblocksize, initialine, finalline,
+                   nodatavalue, ndvavailable)) {
+      GDALClose(pdestdataset);
+      GDALClose(pdataset);
+      pprogress->Destroy();
+      SHOW_ERROR(message_PROCESS_EXECUTION_ERROR);
+      REPORT_AND_FAIL_VALUE("D:Error al leer la imagen a clasificar", false);
+   }
+   engine.SetMeans(initialmeans);
    for (int iteration = 0; !finish && iteration < iterations_; ++iteration) {
       std::string msg = "iteracion " + NumberToString<int>(iteration);
-      double progress = 10.0 + static_cast<double>(iteration)*80.0/static_cast<double>(iterations_);
+      double progress = 20.0 + static_cast<double>(iteration)*60.0/static_cast<double>(iterations_);
       pprogress->Update(ceil(progress), msg);
-      // load buffer data
-      std::vector<float*> bufferdata(bcount);
-      std::vector<int> pixelcount(classcount_);
-      std::vector< std::vector<double > > classcentredata(classcount_, std::vector<double>(bcount));
-      float* outputdata = NULL;
-      // spatialselection.lr_.y_ representa el numero de linea final de la seleccion espacial
-      // spatialselection.ul_.y_ representa el numero de linea inicial de la seleccion espacial
-      for (int y = initialine, y0 = 0; y < finalline; ++y, y0++) {
-        outputdata = new float[xblocksize];
-        for (int b = 0; b < bcount; ++b) {
-            // se utiliza la seleccion espectral para saber de que banda leer
-            GDALRasterBand* pband = pdataset->GetRasterBand(bands[b]+1);
-            bufferdata[b] = new float[xblocksize];
-            // force to load pixel as float value using rasterio method
-            // spatialselection.ul_.x_: representa el offset en pixeles a leer
-            pband->RasterIO(GF_Read, xoffset, y, xblocksize, 1, bufferdata[b],
-                           xblocksize, 1, GDT_Float32, 0, 0);
-         }
-         // Se clasifica el bloque
-         ClassifyBlock(bufferdata, xblocksize, bcount, nodatavalue, ndvavailable,
-                      initialmeans, classcentredata, pixelcount, outputdata);
-         // Se escribe el resultado en la imagen de salida
-         GDALRasterIO(pdestdataset->GetRasterBand(1), GF_Write, 0, y0, xblocksize, 1,
-                      outputdata, xblocksize, 1, GDT_Float32, 0, 0);
-         // free block mem
-         for (size_t i = 0; i < bufferdata.size(); ++i)
-            delete[] bufferdata[i];
-         delete[] outputdata;
-      }
       // Update the class centroids
-      std::vector< std::vector<double> > currentmeans = initialmeans;
-      UpdateMeans(classcount_, bcount, classcentredata, pixelcount, currentmeans);
+      std::vector< std::vector<double> > currentmeans;
+      if (!engine.Iterate(currentmeans))
+         break;
       // end condition: percent of pixels changed < threshold
       double percentchange = CalculateChange(initialmeans, currentmeans);
       finish = percentchange < threshold_ /100.0;
       initialmeans = currentmeans;
-#ifdef __DEBUG__
-      REPORT_DEBUG("Iteration# %d resume", iteration);
-      for (int c = 0; c < classcount_; ++c)
-         REPORT_DEBUG("Class #%d pixelcount=%d", c, pixelcount[c]);
-#endif
+      const KMeansEngine::IterationInfo& info = engine.GetLastIteration();
+      REPORT_DEBUG("D: Iteracion %d: cambio %f, %d pixeles cambiaron de clase, "
+                   "%d distancias calculadas, %d pixeles descartados por cotas",
+                   info.iteration_, percentchange, static_cast<int>(info.changedPixels_),
+                   static_cast<int>(info.distanceCount_),
+                   static_cast<int>(info.skippedPixels_));
    }
+   REPORT_DEBUG("D: Kmeans %s luego de %d iteraciones",
+                finish ? "convergio" : "no convergio",
+                engine.GetLastIteration().iteration_);
+   pprogress->Update(80, _("Clasificando imagen..."));
+   bool classified = ClassifyImage(engine, pdataset, bands, xoffset, xblocksize,
+                                   initialine, finalline, nodatavalue, ndvavailable,
+                                   pdestdataset->GetRasterBand(1));
    pprogress->Update(90, _("Configurando imagen de salida..."));
 
    GDALFlushCache(pdestdataset);
    GDALClose(pdestdataset);
    GDALClose(pdataset);
+   if (!classified) {
+      pprogress->Destroy();
+      SHOW_ERROR(message_PROCESS_EXECUTION_ERROR);
+      REPORT_AND_FAIL_VALUE("D:Error al clasificar la imagen %s", false,
+                            filename.c_str());
+   }
    bool success = ConfigureOutput();
    pprogress->Update(100);
    return success;
@@ -36,6 +36,8 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "suri/TransformationFactory.h"
 #include "suri/TransformationFactoryBuilder.h"
 #include "suri/XmlFunctions.h"
+#include "suri/Configuration.h"
+#include "suri/Resampler.h"
 
 // Includes Wx
 // Defines
@@ -70,6 +72,12 @@ ReprojectionProcess::ReprojectionProcess(Element *pInputElement,
       askGcpFile_(AskGcpFile), libraryId_(LibraryId) {
    SetProcessName(kProcessName);
    this->showResizePart_ = true;
+   // remuestreo configurado; si no es valido se usa vecino mas cercano
+   Resampler::ResamplingType resampling = Resampler::NearestNeighbour;
+   Resampler::GetType(Configuration::GetParameter("lib_reprojection_resampling",
+                                                  INTERPOLATION_PROPERTY_VALUE_NEAREST_NEIGHBOUR),
+                      resampling);
+   pReprojectionParameters_->resampling_ = Resampler::GetName(resampling);
    RasterElement* praster = dynamic_cast<RasterElement*>(pInputElement);
    if (praster) {
       pReprojectionParameters_->rasterModelIn_ = praster->GetRasterModel();
@@ -132,6 +140,8 @@ bool ReprojectionProcess::ConfigureRaster(RasterElement *pRasterElement) {
                               wxT(suri::IntToString(pReprojectionParameters_->algorithmOrder_)));
    pRasterElement->AddNode(preprojnode, REPROJECTION_TYPE_DELTA_NODE,
                                  wxT(suri::IntToString(DEFAULT_DELTA)));
+   pRasterElement->AddNode(preprojnode, REPROJECTION_TYPE_RESAMPLING_NODE,
+                           wxT(pReprojectionParameters_->resampling_));
    if (!pReprojectionParameters_->gcpListFileName_.empty()) {
       wxXmlNode *pgcpnode = pRasterElement->AddNode(preprojnode,
                                                     REPROJECTION_TYPE_GCPLIST_NODE);
@@ -74,6 +74,8 @@ public:
       RasterSpatialModel* pRasterSpatialModelIn_;
       RasterSpatialModel* pRasterSpatialModelOut_;
       int algorithmOrder_;
+      /** Nombre del metodo de remuestreo (lib_reprojection_resampling) */
+      std::string resampling_;
       std::string gcpListFileName_;
       int width_;
       int height_;
@@ -38,26 +38,22 @@ For more information about CONAE, visit <http://www.conae.gov.ar/>. */
 #include "suri/VectorEditionTask.h"
 #include "suri/AuxiliaryFunctions.h"
 #include "SnapInterface.h"
+#include "SnapIndex.h"
 
 namespace suri {
 
 /** Constructor */
 SnapTool::SnapTool(Table* pTable, World* pWorld, std::string RasterModel) : pSnap_(NULL),
-      unit_(Map), tolerance_(0), pWorld_(pWorld), pTable_(pTable), rastermodel_(RasterModel) {
+      unit_(Map), tolerance_(0), pWorld_(pWorld), pTable_(pTable), rastermodel_(RasterModel),
+      pVertexIndex_(NULL), pSegmentIndex_(NULL) {
    char* csrs = (char*)pWorld_->GetSpatialReference().c_str();
    srs_.importFromWkt(&csrs);
 }
 
 /** Destructor */
 SnapTool::~SnapTool() {
-   for (size_t i = 0; i < segmentbuffers_.size(); ++i)
-      delete segmentbuffers_[i];
-   for (size_t i = 0; i < segmentgeometries_.size(); ++i)
-      delete segmentgeometries_[i];
-   for (size_t i = 0; i < vertexgeometries_.size(); ++i)
-      delete vertexgeometries_[i];
-   for (size_t i = 0; i < vertexbuffers_.size(); ++i)
-      delete vertexbuffers_[i];
+   ClearGeometries();
+   delete pSnap_;
 }
 
 /** Setea el modo de snap */
@@ -107,106 +103,152 @@ double SnapTool::CalculateBufferDistance() {
    }
 }
 
-/** Crea los buffers de las geometrias de acuerdo al modo seleccionado */
+/**
+ * Crea los buffers de las geometrias de acuerdo al modo seleccionado y los
+ * indices espaciales que usa la estrategia para buscar las geometrias cercanas
+ */
 bool SnapTool::CreateBufferGeometries() {
-   segmentbuffers_.clear();
-   segmentgeometries_.clear();
-   vertexgeometries_.clear();
-   vertexbuffers_.clear();
-   std::string type = pSnap_->GetStrategyType();
-   if (type.compare("Segment") == 0 || type.compare("VertexSegment") == 0)
-      CreateSegmentBuffers();
-   if (type.compare("Vertex") == 0 || type.compare("VertexSegment") == 0)
-      CreateVertexBuffers();
-   pSnap_->SetVertexGeometries(vertexgeometries_);
-   pSnap_->SetVertexBufferGeometries(vertexbuffers_);
-   pSnap_->SetSegmentGeometries(segmentgeometries_);
-   pSnap_->SetSegmentBufferGeometries(segmentbuffers_);
+   ClearGeometries();
+   double bufferdistance = CalculateBufferDistance();
+   pVertexIndex_ = new SnapIndex(bufferdistance);
+   pSegmentIndex_ = new SnapIndex(bufferdistance);
+   int rows = pTable_->GetRows();
+   for (int row = 0; row < rows; ++row)
+      AddFeatureGeometries(pTable_->GetRowId(row), row);
+   ConfigureStrategy();
    return true;
 }
 
-/** Crea las geometrias existentes en la capa con OGR y sus buffers correspondientes */
-void SnapTool::CreateSegmentBuffers() {
-   int column = pTable_->GetColumnByName(VectorEditionTask::GEOMETRY_COLUMN_NAME);
-   int rows = pTable_->GetRows();
-   double bufferdistance = CalculateBufferDistance();
-
-   for (int row = 0; row < rows; ++row) {
-      std::string geomwkt = "";
-      pTable_->GetCellValue(column, row, geomwkt);
-      if (geomwkt.empty())
-         continue;
-      char* pszpolywkt = (char*)geomwkt.c_str();
-      OGRGeometry* geometry = NULL;
-      OGRGeometryFactory::createFromWkt(&pszpolywkt, &srs_, &geometry);
-      OGRGeometry* buffergeometry = geometry->Buffer(bufferdistance);
-      segmentgeometries_.push_back(geometry);
-      segmentbuffers_.push_back(buffergeometry);
-   }
+/**
+ * Actualiza las geometrias de un feature creado o modificado
+ * @param[in] FeatureId id del feature
+ */
+void SnapTool::UpdateGeometry(long FeatureId) {
+   if (!pSnap_ || !pVertexIndex_ || !pSegmentIndex_)
+      return;
+   RemoveFeatureGeometries(FeatureId);
+   int row = pTable_->GetRowById(FeatureId);
+   if (row >= 0)
+      AddFeatureGeometries(FeatureId, row);
+   ConfigureStrategy();
 }
 
 /**
- * Crea las geometrias existentes en la capa con OGR y los buffers correspondientes
- * a sus vertices
+ * Elimina las geometrias de un feature eliminado
+ * @param[in] FeatureId id del feature
  */
-void SnapTool::CreateVertexBuffers() {
-   int column = pTable_->GetColumnByName(VectorEditionTask::GEOMETRY_COLUMN_NAME);
-   int rows = pTable_->GetRows();
-   double bufferdistance = CalculateBufferDistance();
+void SnapTool::RemoveGeometry(long FeatureId) {
+   if (!pSnap_ || !pVertexIndex_ || !pSegmentIndex_)
+      return;
+   RemoveFeatureGeometries(FeatureId);
+   ConfigureStrategy();
+}
 
-   for (int row = 0; row < rows; ++row) {
-      std::string geomwkt = "";
-      pTable_->GetCellValue(column, row, geomwkt);
-      if (geomwkt.empty())
-         continue;
-      char* pszpolywkt = (char*)geomwkt.c_str();
-      OGRGeometry* geometry = NULL;
-      OGRGeometryFactory::createFromWkt(&pszpolywkt, &srs_, &geometry);
-      segmentgeometries_.push_back(geometry);
-      int lenix = GetCount(geometry);
-      for (int ix = 0; ix < lenix; ++ix) {
-         OGRPoint* point = GetPoint(ix, geometry);
-         vertexgeometries_.push_back(point);
-         OGRGeometry* buffergeometry = point->Buffer(bufferdistance);
-         vertexbuffers_.push_back(buffergeometry);
-      }
-   }
+/** Elimina las geometrias, buffers e indices */
+void SnapTool::ClearGeometries() {
+   for (size_t i = 0; i < segmentbuffers_.size(); ++i)
+      delete segmentbuffers_[i];
+   for (size_t i = 0; i < segmentgeometries_.size(); ++i)
+      delete segmentgeometries_[i];
+   for (size_t i = 0; i < vertexgeometries_.size(); ++i)
+      delete vertexgeometries_[i];
+   for (size_t i = 0; i < vertexbuffers_.size(); ++i)
+      delete vertexbuffers_[i];
+   segmentbuffers_.clear();
+   segmentgeometries_.clear();
+   vertexgeometries_.clear();
+   vertexbuffers_.clear();
+   featuresegments_.clear();
+   featurevertices_.clear();
+   delete pVertexIndex_;
+   delete pSegmentIndex_;
+   pVertexIndex_ = NULL;
+   pSegmentIndex_ = NULL;
 }
 
-/** Agrega una geometria en los vectores correspondientes al modo configurado en la herramienta */
-void SnapTool::AddGeometry() {
+/**
+ * Crea la geometria de una fila con OGR y sus buffers y la agrega en los
+ * vectores e indices correspondientes al modo configurado en la herramienta
+ * @param[in] FeatureId id del feature
+ * @param[in] Row fila del feature en la tabla
+ */
+void SnapTool::AddFeatureGeometries(long FeatureId, int Row) {
    int column = pTable_->GetColumnByName(VectorEditionTask::GEOMETRY_COLUMN_NAME);
-   int row = pTable_->GetRows() - 1;
-   double bufferdistance = CalculateBufferDistance();
-
    std::string geomwkt = "";
-   pTable_->GetCellValue(column, row, geomwkt);
+   pTable_->GetCellValue(column, Row, geomwkt);
    if (geomwkt.empty())
       return;
    char* pszpolywkt = (char*) geomwkt.c_str();
    OGRGeometry* geometry = NULL;
    OGRGeometryFactory::createFromWkt(&pszpolywkt, &srs_, &geometry);
-   segmentgeometries_.push_back(geometry);
+   if (!geometry)
+      return;
 
+   double bufferdistance = CalculateBufferDistance();
    std::string type = pSnap_->GetStrategyType();
-   if (type.compare("Segment") == 0 || type.compare("VertexSegment") == 0) {
-      OGRGeometry* buffergeometry = geometry->Buffer(bufferdistance);
-      segmentbuffers_.push_back(buffergeometry);
-   }
    if (type.compare("Vertex") == 0 || type.compare("VertexSegment") == 0) {
+      std::vector<int>& vertices = featurevertices_[FeatureId];
       int lenix = GetCount(geometry);
       for (int ix = 0; ix < lenix; ++ix) {
          OGRPoint* point = GetPoint(ix, geometry);
+         int position = vertexgeometries_.size();
+         pVertexIndex_->Insert(position, point);
+         vertices.push_back(position);
          vertexgeometries_.push_back(point);
-         OGRGeometry* buffergeometry = point->Buffer(bufferdistance);
-         vertexbuffers_.push_back(buffergeometry);
+         vertexbuffers_.push_back(point->Buffer(bufferdistance));
+      }
+   }
+   if (type.compare("Segment") == 0 || type.compare("VertexSegment") == 0) {
+      int position = segmentgeometries_.size();
+      pSegmentIndex_->Insert(position, geometry);
+      featuresegments_[FeatureId].push_back(position);
+      segmentgeometries_.push_back(geometry);
+      segmentbuffers_.push_back(geometry->Buffer(bufferdistance));
+   } else {
+      OGRGeometryFactory::destroyGeometry(geometry);
+   }
+}
+
+/**
+ * Elimina las geometrias de un feature de los vectores e indices. Las
+ * posiciones quedan en NULL para no invalidar las del resto de los features.
+ * @param[in] FeatureId id del feature
+ */
+void SnapTool::RemoveFeatureGeometries(long FeatureId) {
+   std::map<long, std::vector<int> >::iterator it = featuresegments_.find(FeatureId);
+   if (it != featuresegments_.end()) {
+      for (size_t i = 0; i < it->second.size(); ++i) {
+         int position = it->second[i];
+         pSegmentIndex_->Remove(position);
+         delete segmentgeometries_[position];
+         delete segmentbuffers_[position];
+         segmentgeometries_[position] = NULL;
+         segmentbuffers_[position] = NULL;
+      }
+      featuresegments_.erase(it);
+   }
+   it = featurevertices_.find(FeatureId);
+   if (it != featurevertices_.end()) {
+      for (size_t i = 0; i < it->second.size(); ++i) {
+         int position = it->second[i];
+         pVertexIndex_->Remove(position);
+         delete vertexgeometries_[position];
+         delete vertexbuffers_[position];
+         vertexgeometries_[position] = NULL;
+         vertexbuffers_[position] = NULL;
       }
+      featurevertices_.erase(it);
    }
+}
 
+/** Configura las geometrias e indices en la estrategia */
+void SnapTool::ConfigureStrategy() {
    pSnap_->SetVertexGeometries(vertexgeometries_);
    pSnap_->SetVertexBufferGeometries(vertexbuffers_);
    pSnap_->SetSegmentGeometries(segmentgeometries_);
    pSnap_->SetSegmentBufferGeometries(segmentbuffers_);
+   pSnap_->SetVertexIndex(pVertexIndex_);
+   pSnap_->SetSegmentIndex(pSegmentIndex_);
 }
 
 /**
@@ -257,7 +299,9 @@ OGRPoint* SnapTool::GetPoint(int Number, OGRGeometry* Geometry) {
          break;
       }
       default: {
-         point = static_cast<OGRPoint*>(Geometry);
+         // Copia para que el vertice no comparta memoria con la geometria
+         delete point;
+         point = static_cast<OGRPoint*>(Geometry->clone());
          break;
       }
    }
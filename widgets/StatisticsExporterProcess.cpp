@@ -130,6 +130,13 @@ bool StatisticsExporterProcess::ConfigureProcess() {
    pStatsCanvas_->SetNoDataValueAvailable(available);
    pStatsCanvas_->SetNoDataValue(nodatavalue);
 
+   // El histograma se acumula en la misma pasada que las estadisticas.
+   Statistics::StatisticsFlag statics = Statistics::None;
+   pAdaptLayer_->GetAttribute<Statistics::StatisticsFlag>(SelectedStadisticsKeyAttr,
+                                                          statics);
+   if (statics & Statistics::Histogram)
+      pStatsCanvas_->EnableHistogram(suri::render::HistogramCanvas::kIntensityBins);
+
    pRenderizationObject_->SetOutputCanvas(pStatsCanvas_);
 
    MovingWindowController* paux = dynamic_cast<MovingWindowController*>(pRenderizationObject_);
@@ -152,16 +159,20 @@ bool StatisticsExporterProcess::ConfigureOutput() {
    pAdaptLayer_->GetAttribute<Statistics::StatisticsFlag>(SelectedStadisticsKeyAttr,
                                                           statics);
    if (pStats_ && (statics & Statistics::Histogram)) {
-      /** calculo de histograma **/
-      suri::render::HistogramCanvas histcanvas;
-      histcanvas.SetNoDataValue(pStatsCanvas_->GetNoDataValue());
-      histcanvas.SetNoDataValueAvailable(pStatsCanvas_->IsNoDataValueAvailable());
-      histcanvas.SetStatistics(pStats_);
-      pRenderizationObject_->SetOutputCanvas(&histcanvas);
-      if (pRenderizationObject_->Render()) {
-         pHistogram_ = histcanvas.GetHistogram();
+      pHistogram_ = pStatsCanvas_->GetHistogram();
+      if (!pHistogram_ && pStatsCanvas_->NeedsHistogramPass()) {
+         /** calculo de histograma **/
+         suri::render::HistogramCanvas histcanvas;
+         histcanvas.SetNoDataValue(pStatsCanvas_->GetNoDataValue());
+         histcanvas.SetNoDataValueAvailable(pStatsCanvas_->IsNoDataValueAvailable());
+         histcanvas.SetStatistics(pStats_);
+         pRenderizationObject_->SetOutputCanvas(&histcanvas);
+         if (pRenderizationObject_->Render()) {
+            pHistogram_ = histcanvas.GetHistogram();
+         }
+         pRenderizationObject_->SetOutputCanvas(pStatsCanvas_);
+         /** fin calculo de histograma **/
       }
-      /** fin calculo de histograma **/
    }
 
    // Configuro opciones con datos de la imagen de entrada
@@ -187,10 +187,11 @@ bool VectorEditionTask::EndFeatureEdition(bool SaveChanges) {
    pGeometryEditor_->End();
    pGeometryCreator_->End();
 
+   long featureid = GetEditedFeatureId();
    bool returnvalue = TableEditionTask::EndFeatureEdition(SaveChanges);
 
    if (pSnapTool_ && returnvalue)
-      pSnapTool_->AddGeometry();
+      pSnapTool_->UpdateGeometry(featureid);
 
    return returnvalue;
 }
@@ -255,6 +256,9 @@ bool VectorEditionTask::DeleteFeature(FeatureIdType FeatureId) {
    // Saco FeatureId de modifiedFeatures_
    RemoveModifiedFeature(FeatureId);
 
+   if (pSnapTool_)
+      pSnapTool_->RemoveGeometry(FeatureId);
+
    return true;
 }
 